@@ -0,0 +1,323 @@
+/** @file
+Host benchmark for the CRC32 library of the bootloader.
+
+The library routines are compared against the original byte-at-a-time
+implementation, both for correctness and for throughput.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+//
+// The C library headers go first, as the GCC ProcessorBind.h of MdePkg makes
+// all following declarations hidden. Base.h then provides its own NULL.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <cpuid.h>
+#undef NULL
+
+#include <Library/Crc32Lib.h>
+#include <Library/BaseLib.h>
+
+#define UTILITY_NAME            "Crc32Bench"
+
+#define BENCH_BUFFER_SIZE       (1024 * 1024)
+#define BENCH_MIN_BYTES         (256 * 1024 * 1024)
+#define BENCH_VERIFY_MAX_SIZE   4096
+
+STATIC BOOLEAN  mHideSimd = FALSE;
+STATIC UINT32   mRefTable[Crc32TypeMax][256];
+
+#ifdef CRC32_BENCH_NO_SIMD
+//
+// Built without an assembler: the CPUID stub below hides the features, so
+// these are never called.
+//
+UINT32
+EFIAPI
+InternalCrc32Pclmul (
+  IN  UINT32        Crc,
+  IN  CONST UINT8  *Buffer,
+  IN  UINTN         Length
+  )
+{
+  abort ();
+}
+
+UINT32
+EFIAPI
+InternalCrc32cSse42 (
+  IN  UINT32        Crc,
+  IN  CONST UINT8  *Buffer,
+  IN  UINTN         Length
+  )
+{
+  abort ();
+}
+#endif
+
+/**
+  Host replacement of the BaseLib CPUID routine used by the library.
+
+  @param  Index         The 32-bit value to load into EAX prior to invoking the CPUID instruction.
+  @param  RegisterEax   A pointer to the 32-bit EAX value returned by the CPUID instruction.
+  @param  RegisterEbx   A pointer to the 32-bit EBX value returned by the CPUID instruction.
+  @param  RegisterEcx   A pointer to the 32-bit ECX value returned by the CPUID instruction.
+  @param  RegisterEdx   A pointer to the 32-bit EDX value returned by the CPUID instruction.
+
+  @return Index.
+**/
+UINT32
+EFIAPI
+AsmCpuid (
+  IN      UINT32                    Index,
+  OUT     UINT32                    *RegisterEax   OPTIONAL,
+  OUT     UINT32                    *RegisterEbx   OPTIONAL,
+  OUT     UINT32                    *RegisterEcx   OPTIONAL,
+  OUT     UINT32                    *RegisterEdx   OPTIONAL
+  )
+{
+  unsigned int  Eax;
+  unsigned int  Ebx;
+  unsigned int  Ecx;
+  unsigned int  Edx;
+
+  __cpuid (Index, Eax, Ebx, Ecx, Edx);
+
+#ifdef CRC32_BENCH_NO_SIMD
+  mHideSimd = TRUE;
+#endif
+  if (mHideSimd) {
+    Ecx = 0;
+  }
+
+  if (RegisterEax != NULL) {
+    *RegisterEax = Eax;
+  }
+  if (RegisterEbx != NULL) {
+    *RegisterEbx = Ebx;
+  }
+  if (RegisterEcx != NULL) {
+    *RegisterEcx = Ecx;
+  }
+  if (RegisterEdx != NULL) {
+    *RegisterEdx = Edx;
+  }
+  return Index;
+}
+
+/**
+  Build the byte table used by the reference implementation.
+
+  @param  Type       Which polynomial should be used, default or Castagnoli
+**/
+STATIC
+VOID
+RefInitTable (
+  IN  CRC32_TYPE  Type
+  )
+{
+  UINT32  Entry;
+  UINT32  Value;
+  UINT32  Bit;
+
+  for (Entry = 0; Entry < 256; Entry++) {
+    Value = Entry;
+    for (Bit = 0; Bit < 8; Bit++) {
+      if ((Value & 1) != 0) {
+        Value = (Value >> 1) ^ ((Type == Crc32TypeCastagnoli) ? 0x82F63B78 : 0xEDB88320);
+      } else {
+        Value = Value >> 1;
+      }
+    }
+    mRefTable[Type][Entry] = Value;
+  }
+}
+
+/**
+  The original byte-at-a-time implementation of CalculateCrc32WithType.
+
+  @param  Data       The buffer contaning the data to be processed
+  @param  DataSize   The size of data to be processed
+  @param  Type       Which CRC table should be used, default or Castagnoli
+
+  @return The CRC32 checksum of Data.
+**/
+STATIC
+UINT32
+RefCrc32 (
+  IN  UINT8       *Data,
+  IN  UINTN       DataSize,
+  IN  CRC32_TYPE  Type
+  )
+{
+  UINT32  Crc;
+  UINTN   Index;
+
+  Crc = 0xFFFFFFFF;
+  for (Index = 0; Index < DataSize; Index++) {
+    Crc = (Crc >> 8) ^ mRefTable[Type][(UINT8)Crc ^ Data[Index]];
+  }
+
+  return (Type == Crc32TypeCastagnoli) ? Crc : (Crc ^ 0xFFFFFFFF);
+}
+
+/**
+  Get a monotonic time stamp in seconds.
+
+  @return The time stamp.
+**/
+STATIC
+double
+GetSeconds (
+  VOID
+  )
+{
+  struct timespec  Ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &Ts);
+  return Ts.tv_sec + Ts.tv_nsec / 1e9;
+}
+
+/**
+  Compare the library against the reference for all sizes up to
+  BENCH_VERIFY_MAX_SIZE and all buffer alignments.
+
+  @param  Buffer     Random test data.
+
+  @return The number of mismatches.
+**/
+STATIC
+UINTN
+Verify (
+  IN  UINT8  *Buffer
+  )
+{
+  CRC32_TYPE  Type;
+  UINTN       Size;
+  UINTN       Offset;
+  UINT32      Crc;
+  UINTN       Errors;
+
+  Errors = 0;
+  for (Type = Crc32TypeDefault; Type < Crc32TypeMax; Type++) {
+    for (Size = 1; Size <= BENCH_VERIFY_MAX_SIZE; Size++) {
+      Offset = Size % 16;
+      if ((CalculateCrc32WithType (Buffer + Offset, Size, Type, &Crc) != EFI_SUCCESS) ||
+          (Crc != RefCrc32 (Buffer + Offset, Size, Type))) {
+        if (Errors++ < 8) {
+          fprintf (stderr, "%s: mismatch for type %d, size %u, offset %u\n",
+            UTILITY_NAME, Type, (unsigned)Size, (unsigned)Offset);
+        }
+      }
+    }
+  }
+
+  return Errors;
+}
+
+/**
+  Measure the throughput of the library and of the reference.
+
+  @param  Buffer     Random test data of BENCH_BUFFER_SIZE bytes.
+  @param  Type       Which polynomial should be used, default or Castagnoli
+  @param  Size       The size of each CRC calculation.
+**/
+STATIC
+VOID
+Benchmark (
+  IN  UINT8       *Buffer,
+  IN  CRC32_TYPE  Type,
+  IN  UINTN       Size
+  )
+{
+  UINTN             Loops;
+  UINTN             Index;
+  UINTN             Offset;
+  UINT32            Crc;
+  volatile UINT32   Sink;
+  double            Start;
+  double            RefTime;
+  double            LibTime;
+
+  Loops = BENCH_MIN_BYTES / Size;
+  Sink  = 0;
+
+  //
+  // The reference is much slower, so time a quarter of the loops
+  //
+  Start = GetSeconds ();
+  for (Index = 0, Offset = 0; Index < Loops / 4; Index++) {
+    Sink ^= RefCrc32 (Buffer + Offset, Size, Type);
+    Offset = (Offset + Size) % (BENCH_BUFFER_SIZE - Size + 1);
+  }
+  RefTime = (GetSeconds () - Start) * 4;
+
+  Start = GetSeconds ();
+  for (Index = 0, Offset = 0; Index < Loops; Index++) {
+    CalculateCrc32WithType (Buffer + Offset, Size, Type, &Crc);
+    Sink ^= Crc;
+    Offset = (Offset + Size) % (BENCH_BUFFER_SIZE - Size + 1);
+  }
+  LibTime = GetSeconds () - Start;
+
+  printf ("%-10s %8u %10.1f %10.1f %7.1fx\n",
+    (Type == Crc32TypeCastagnoli) ? "crc32c" : "crc32",
+    (unsigned)Size,
+    (double)Loops * Size / RefTime / 1e6,
+    (double)Loops * Size / LibTime / 1e6,
+    RefTime / LibTime);
+}
+
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  STATIC CONST UINTN  Sizes[] = { 64, 512, 1024, 4096, 65536, BENCH_BUFFER_SIZE };
+  UINT8               *Buffer;
+  UINTN               Index;
+  CRC32_TYPE          Type;
+
+  if ((argc > 2) || ((argc == 2) && (strcmp (argv[1], "--no-simd") != 0))) {
+    printf ("Usage: %s [--no-simd]\n", UTILITY_NAME);
+    printf ("  --no-simd  only use the portable slice-by-8 routine\n");
+    return 1;
+  }
+  mHideSimd = (argc == 2);
+
+  Buffer = malloc (BENCH_BUFFER_SIZE + 16);
+  if (Buffer == NULL) {
+    fprintf (stderr, "%s: out of memory\n", UTILITY_NAME);
+    return 1;
+  }
+  srand (1);
+  for (Index = 0; Index < BENCH_BUFFER_SIZE + 16; Index++) {
+    Buffer[Index] = (UINT8)rand ();
+  }
+
+  RefInitTable (Crc32TypeDefault);
+  RefInitTable (Crc32TypeCastagnoli);
+
+  if (Verify (Buffer) != 0) {
+    fprintf (stderr, "%s: verification FAILED\n", UTILITY_NAME);
+    free (Buffer);
+    return 1;
+  }
+  printf ("Verification passed (%s)\n\n", mHideSimd ? "portable" : "best available");
+
+  printf ("%-10s %8s %10s %10s %8s\n", "Type", "Size", "Ref MB/s", "Lib MB/s", "Speedup");
+  for (Type = Crc32TypeDefault; Type < Crc32TypeMax; Type++) {
+    for (Index = 0; Index < sizeof (Sizes) / sizeof (Sizes[0]); Index++) {
+      Benchmark (Buffer, Type, Sizes[Index]);
+    }
+  }
+
+  free (Buffer);
+  return 0;
+}
@@ -0,0 +1,448 @@
+/** @file
+Host benchmark for the decompression libraries of the bootloader.
+
+Each input file is compressed with LZ4, LZMA and Zstandard the way the
+container tools do, then decoded with the LZ4, LZMA and Zstandard libraries
+of BootloaderCommonPkg. The compression ratio and the decode throughput are
+reported for each format, and every decoded image is compared to the input.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+//
+// The C library headers go first, as the GCC ProcessorBind.h of MdePkg makes
+// all following declarations hidden. Base.h then provides its own NULL.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#undef NULL
+
+#include <Library/Lz4CompressLib.h>
+#include <Library/LzmaDecompressLib.h>
+#include <Library/ZstdDecompressLib.h>
+#include "DecompressBenchEncode.h"
+
+#define UTILITY_NAME            "DecompressBench"
+
+#define BENCH_MIN_SECONDS       0.5
+#define BENCH_MIN_LOOPS         3
+#define BENCH_DEFAULT_LEVEL     19
+
+typedef
+RETURN_STATUS
+(EFIAPI *BENCH_GET_INFO) (
+  IN  CONST VOID  *Source,
+  IN  UINT32       SourceSize,
+  OUT UINT32      *DestinationSize,
+  OUT UINT32      *ScratchSize
+  );
+
+typedef
+RETURN_STATUS
+(EFIAPI *BENCH_DECOMPRESS) (
+  IN CONST VOID  *Source,
+  IN UINT32       SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  );
+
+//
+// Host replacements of the BaseLib and BaseMemoryLib routines used by the
+// libraries.
+//
+VOID *
+EFIAPI
+CopyMem (
+  OUT VOID       *DestinationBuffer,
+  IN CONST VOID  *SourceBuffer,
+  IN UINTN       Length
+  )
+{
+  return memmove (DestinationBuffer, SourceBuffer, Length);
+}
+
+VOID *
+EFIAPI
+SetMem (
+  OUT VOID  *Buffer,
+  IN UINTN  Length,
+  IN UINT8  Value
+  )
+{
+  return memset (Buffer, Value, Length);
+}
+
+VOID *
+EFIAPI
+ZeroMem (
+  OUT VOID  *Buffer,
+  IN UINTN  Length
+  )
+{
+  return memset (Buffer, 0, Length);
+}
+
+UINT16
+EFIAPI
+ReadUnaligned16 (
+  IN CONST UINT16  *Buffer
+  )
+{
+  UINT16  Value;
+
+  memcpy (&Value, Buffer, sizeof (Value));
+  return Value;
+}
+
+UINT32
+EFIAPI
+ReadUnaligned32 (
+  IN CONST UINT32  *Buffer
+  )
+{
+  UINT32  Value;
+
+  memcpy (&Value, Buffer, sizeof (Value));
+  return Value;
+}
+
+UINT64
+EFIAPI
+ReadUnaligned64 (
+  IN CONST UINT64  *Buffer
+  )
+{
+  UINT64  Value;
+
+  memcpy (&Value, Buffer, sizeof (Value));
+  return Value;
+}
+
+INTN
+EFIAPI
+HighBitSet32 (
+  IN UINT32  Operand
+  )
+{
+  return (Operand == 0) ? -1 : 31 - __builtin_clz (Operand);
+}
+
+UINT64
+EFIAPI
+LShiftU64 (
+  IN UINT64  Operand,
+  IN UINTN   Count
+  )
+{
+  return Operand << Count;
+}
+
+UINT64
+EFIAPI
+RShiftU64 (
+  IN UINT64  Operand,
+  IN UINTN   Count
+  )
+{
+  return Operand >> Count;
+}
+
+BOOLEAN
+EFIAPI
+DebugAssertEnabled (
+  VOID
+  )
+{
+  return TRUE;
+}
+
+VOID
+EFIAPI
+DebugAssert (
+  IN CONST CHAR8  *FileName,
+  IN UINTN        LineNumber,
+  IN CONST CHAR8  *Description
+  )
+{
+  fprintf (stderr, "ASSERT %s(%u): %s\n", FileName, (unsigned)LineNumber, Description);
+  abort ();
+}
+
+/**
+  LZ4 decoder with the prototype of the other decoders.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data.
+  @param  Scratch     A temporary scratch buffer.
+
+  @return The status of Lz4Decompress().
+**/
+STATIC
+RETURN_STATUS
+EFIAPI
+BenchLz4Decompress (
+  IN CONST VOID  *Source,
+  IN UINT32       SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  )
+{
+  return Lz4Decompress (Source, SourceSize, Destination, Scratch);
+}
+
+/**
+  LZMA decoder with the prototype of the other decoders.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data.
+  @param  Scratch     A temporary scratch buffer.
+
+  @return The status of LzmaUefiDecompress().
+**/
+STATIC
+RETURN_STATUS
+EFIAPI
+BenchLzmaDecompress (
+  IN CONST VOID  *Source,
+  IN UINT32       SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  )
+{
+  return LzmaUefiDecompress (Source, SourceSize, Destination, Scratch);
+}
+
+/**
+  Zstandard decoder with the prototype of the other decoders.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data.
+  @param  Scratch     A temporary scratch buffer.
+
+  @return The status of ZstdDecompress().
+**/
+STATIC
+RETURN_STATUS
+EFIAPI
+BenchZstdDecompress (
+  IN CONST VOID  *Source,
+  IN UINT32       SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  )
+{
+  return ZstdDecompress (Source, SourceSize, Destination, Scratch);
+}
+
+/**
+  Get a monotonic time stamp in seconds.
+
+  @return The time stamp.
+**/
+STATIC
+double
+GetSeconds (
+  VOID
+  )
+{
+  struct timespec  Ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &Ts);
+  return Ts.tv_sec + Ts.tv_nsec / 1e9;
+}
+
+/**
+  Read a whole file.
+
+  @param  FileName   The file to read.
+  @param  Size       Receives the size of the file.
+
+  @return The allocated file content, or NULL on failure.
+**/
+STATIC
+UINT8 *
+ReadFile (
+  IN  CONST CHAR8  *FileName,
+  OUT UINT32       *Size
+  )
+{
+  FILE   *Fp;
+  long    Length;
+  UINT8  *Buffer;
+
+  Fp = fopen (FileName, "rb");
+  if (Fp == NULL) {
+    return NULL;
+  }
+
+  Buffer = NULL;
+  if ((fseek (Fp, 0L, SEEK_END) == 0) && ((Length = ftell (Fp)) >= 0) && (Length < 0x7FFFFFFF)) {
+    fseek (Fp, 0L, SEEK_SET);
+    Buffer = malloc (Length + 1);
+    if ((Buffer != NULL) && (fread (Buffer, 1, Length, Fp) != (size_t)Length)) {
+      free (Buffer);
+      Buffer = NULL;
+    }
+    *Size = (UINT32)Length;
+  }
+  fclose (Fp);
+
+  return Buffer;
+}
+
+/**
+  Decode a compressed image repeatedly, check it and print the results.
+
+  @param  Name        The name of the format.
+  @param  GetInfo     The GetInfo routine of the decoder.
+  @param  Decompress  The decoder.
+  @param  Original    The uncompressed image.
+  @param  Size        The size of the uncompressed image.
+  @param  Packed      The compressed image.
+  @param  PackedSize  The size of the compressed image.
+
+  @retval TRUE        The decoded image matches the original.
+  @retval FALSE       The decoder failed or produced a different image.
+**/
+STATIC
+BOOLEAN
+Benchmark (
+  IN  CONST CHAR8       *Name,
+  IN  BENCH_GET_INFO     GetInfo,
+  IN  BENCH_DECOMPRESS   Decompress,
+  IN  CONST UINT8       *Original,
+  IN  UINT32             Size,
+  IN  CONST VOID        *Packed,
+  IN  UINT32             PackedSize
+  )
+{
+  RETURN_STATUS  Status;
+  UINT32         DstSize;
+  UINT32         ScratchSize;
+  UINT8         *Dst;
+  VOID          *Scratch;
+  UINTN          Loops;
+  double         Start;
+  double         Elapsed;
+  BOOLEAN        Match;
+
+  if ((PackedSize == 0) || (GetInfo (Packed, PackedSize, &DstSize, &ScratchSize) != RETURN_SUCCESS) ||
+      (DstSize != Size)) {
+    printf ("  %-6s %10s\n", Name, "bad header");
+    return FALSE;
+  }
+
+  Dst     = malloc (DstSize + 1);
+  Scratch = malloc (ScratchSize + 1);
+  if ((Dst == NULL) || (Scratch == NULL)) {
+    free (Dst);
+    free (Scratch);
+    printf ("  %-6s %10s\n", Name, "no memory");
+    return FALSE;
+  }
+
+  Loops  = 0;
+  Status = RETURN_SUCCESS;
+  Start  = GetSeconds ();
+  do {
+    Status = Decompress (Packed, PackedSize, Dst, Scratch);
+    Loops++;
+    Elapsed = GetSeconds () - Start;
+  } while ((Status == RETURN_SUCCESS) && ((Elapsed < BENCH_MIN_SECONDS) || (Loops < BENCH_MIN_LOOPS)));
+
+  Match = (Status == RETURN_SUCCESS) && (memcmp (Dst, Original, Size) == 0);
+  if (!Match) {
+    printf ("  %-6s %10s (status 0x%x)\n", Name, "MISMATCH", (unsigned)Status);
+  } else {
+    printf ("  %-6s %10u %7.2f%% %10.1f %10u\n", Name, (unsigned)PackedSize,
+      Size ? 100.0 * PackedSize / Size : 0.0,
+      (double)Size * Loops / Elapsed / 1e6, (unsigned)ScratchSize);
+  }
+
+  free (Dst);
+  free (Scratch);
+  return Match;
+}
+
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  int        Index;
+  int        Level;
+  int        Errors;
+  UINT8     *Original;
+  UINT32     Size;
+  VOID      *Packed;
+  UINT32     PackedSize;
+  UINT32     ScratchSize;
+  VOID      *Scratch;
+
+  Level = BENCH_DEFAULT_LEVEL;
+  Index = 1;
+  if ((argc > 2) && (strcmp (argv[1], "-l") == 0)) {
+    Level = atoi (argv[2]);
+    Index = 3;
+  }
+
+  if ((Index >= argc) || (Level < 1)) {
+    printf ("Usage: %s [-l <level>] <payload>...\n", UTILITY_NAME);
+    printf ("  -l Level: Zstandard compression level, %d by default\n", BENCH_DEFAULT_LEVEL);
+    return 1;
+  }
+
+  Errors = 0;
+  for (; Index < argc; Index++) {
+    Original = ReadFile (argv[Index], &Size);
+    if (Original == NULL) {
+      fprintf (stderr, "%s: cannot read '%s'\n", UTILITY_NAME, argv[Index]);
+      Errors++;
+      continue;
+    }
+
+    printf ("%s: %u bytes\n", argv[Index], (unsigned)Size);
+    printf ("  %-6s %10s %8s %10s %10s\n", "Format", "Packed", "Ratio", "MB/s", "Scratch");
+
+    //
+    // LZ4 is compressed by the library itself, as Lz4Compress does
+    //
+    Lz4CompressGetInfo (Original, Size, &PackedSize, &ScratchSize);
+    Packed  = malloc (PackedSize);
+    Scratch = malloc (ScratchSize);
+    if ((Packed == NULL) || (Scratch == NULL) ||
+        (Lz4Compress (Original, Size, Packed, &PackedSize, Scratch) != RETURN_SUCCESS)) {
+      PackedSize = 0;
+    }
+    free (Scratch);
+    if (!Benchmark ("LZ4", Lz4DecompressGetInfo, BenchLz4Decompress, Original, Size, Packed, PackedSize)) {
+      Errors++;
+    }
+    free (Packed);
+
+    PackedSize = (UINT32)BenchEncodeLzma (Original, Size, &Packed);
+    if (!Benchmark ("LZMA", LzmaUefiDecompressGetInfo, BenchLzmaDecompress, Original, Size, Packed, PackedSize)) {
+      Errors++;
+    }
+    free (Packed);
+
+    PackedSize = (UINT32)BenchEncodeZstd (Original, Size, Level, &Packed);
+    if (!Benchmark ("ZSTD", ZstdDecompressGetInfo, BenchZstdDecompress, Original, Size, Packed, PackedSize)) {
+      Errors++;
+    }
+    free (Packed);
+
+    free (Original);
+    printf ("\n");
+  }
+
+  return (Errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+/** @file
+Encoders used by the decompression benchmark.
+
+The streams match the output of the LzmaCompress and ZstdCompress tools with
+their default settings, which is what GenContainer.py stores in containers.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdlib.h>
+
+#include "LzmaEnc.h"
+#include "zstd.h"
+#include "DecompressBenchEncode.h"
+
+#define LZMA_HEADER_SIZE (LZMA_PROPS_SIZE + 8)
+
+static void *SzAlloc(ISzAllocPtr p, size_t size) { (void)p; return malloc(size); }
+static void SzFree(ISzAllocPtr p, void *address) { (void)p; free(address); }
+static const ISzAlloc g_Alloc = { SzAlloc, SzFree };
+
+size_t
+BenchEncodeLzma (
+  const void  *bufi,
+  size_t       inpsz,
+  void       **bufo
+  )
+{
+  CLzmaEncProps  props;
+  unsigned char *out;
+  size_t         outsz;
+  size_t         propsz;
+  int            i;
+
+  //
+  // Same allocation rule as LzmaCompress: 105% of the input plus 64KB
+  //
+  outsz = inpsz / 20 * 21 + (1 << 16);
+  out   = (unsigned char *)malloc (outsz);
+  *bufo = out;
+  if (out == NULL) {
+    return 0;
+  }
+
+  for (i = 0; i < 8; i++) {
+    out[i + LZMA_PROPS_SIZE] = (unsigned char)((unsigned long long)inpsz >> (8 * i));
+  }
+
+  LzmaEncProps_Init (&props);
+  LzmaEncProps_Normalize (&props);
+
+  outsz -= LZMA_HEADER_SIZE;
+  propsz = LZMA_PROPS_SIZE;
+  if (LzmaEncode (out + LZMA_HEADER_SIZE, &outsz, (const Byte *)bufi, inpsz,
+        &props, out, &propsz, 0, NULL, &g_Alloc, &g_Alloc) != SZ_OK) {
+    return 0;
+  }
+
+  return LZMA_HEADER_SIZE + outsz;
+}
+
+size_t
+BenchEncodeZstd (
+  const void  *bufi,
+  size_t       inpsz,
+  int          level,
+  void       **bufo
+  )
+{
+  ZSTD_CCtx  *cctx;
+  size_t      bufsz;
+  size_t      res;
+
+  bufsz = ZSTD_compressBound (inpsz);
+  *bufo = malloc (bufsz);
+  cctx  = ZSTD_createCCtx ();
+  if ((*bufo == NULL) || (cctx == NULL)) {
+    ZSTD_freeCCtx (cctx);
+    return 0;
+  }
+
+  ZSTD_CCtx_setParameter (cctx, ZSTD_c_compressionLevel, level);
+  ZSTD_CCtx_setParameter (cctx, ZSTD_c_contentSizeFlag, 1);
+  ZSTD_CCtx_setParameter (cctx, ZSTD_c_checksumFlag, 0);
+  ZSTD_CCtx_setParameter (cctx, ZSTD_c_dictIDFlag, 0);
+
+  res = ZSTD_compress2 (cctx, *bufo, bufsz, bufi, inpsz);
+  ZSTD_freeCCtx (cctx);
+
+  return ZSTD_isError (res) ? 0 : res;
+}
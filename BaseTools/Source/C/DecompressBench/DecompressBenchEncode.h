@@ -0,0 +1,69 @@
+/** @file
+Encoders used by the decompression benchmark.
+
+They are built against the host compressor SDKs only, so this header does not
+depend on the MdePkg types.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __DECOMPRESS_BENCH_ENCODE_H__
+#define __DECOMPRESS_BENCH_ENCODE_H__
+
+#include <stddef.h>
+
+/*++
+
+Routine Description:
+
+  Compress a buffer in the LZMA format of the LzmaCompress tool: the encoded
+  properties, the 64-bit uncompressed size, then the LZMA stream.
+
+Arguments:
+
+  bufi      - input buffer
+  inpsz     - input size
+  bufo      - receives the allocated output buffer
+
+Returns:
+
+  the output size, or 0 on failure
+
+--*/
+size_t
+BenchEncodeLzma (
+  const void  *bufi,
+  size_t       inpsz,
+  void       **bufo
+  );
+
+/*++
+
+Routine Description:
+
+  Compress a buffer into a single Zstandard frame as the ZstdCompress tool
+  does: content size present, no checksum and no dictionary ID.
+
+Arguments:
+
+  bufi      - input buffer
+  inpsz     - input size
+  level     - compression level
+  bufo      - receives the allocated output buffer
+
+Returns:
+
+  the output size, or 0 on failure
+
+--*/
+size_t
+BenchEncodeZstd (
+  const void  *bufi,
+  size_t       inpsz,
+  int          level,
+  void       **bufo
+  );
+
+#endif
@@ -0,0 +1,499 @@
+/** @file
+Host test for the flash update planner of the firmware update payload.
+
+The planner of FlashUpdatePlan.c runs on top of a file-backed NOR flash.
+Programming only clears bits and erasing sets whole 4KB sectors or 64KB
+blocks back to 0xFF, like on a SPI NOR part. A part with ECC can be modeled
+as well, which ignores programming over data that is not erased. Every
+update is checked against the new image, and the erases and writes it
+caused are checked against the plan.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+//
+// The C library headers go first, as the GCC ProcessorBind.h of MdePkg makes
+// all following declarations hidden. Base.h then provides its own NULL.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#undef NULL
+
+#include <Base.h>
+#include <Uefi/UefiBaseType.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/FirmwareUpdateLib.h>
+#include <Library/ConsoleOutLib.h>
+#include "FirmwareUpdateHelper.h"
+
+#define UTILITY_NAME            "FlashUpdatePlanTest"
+
+#define TEST_FLASH_SIZE         (FLASH_BLOCK_SIZE * 8)
+#define TEST_RANDOM_LOOPS       200
+
+//
+// Value of PcdFlashProgramWithoutEraseEnabled, see TestAutoGen.h
+//
+BOOLEAN               mTestProgramWithoutErase;
+
+STATIC FILE          *mFlash;
+STATIC BOOLEAN        mEccPart;
+STATIC UINTN          mSectorErases;
+STATIC UINTN          mBlockErases;
+STATIC UINTN          mWrites;
+STATIC UINTN          mErrors;
+STATIC UINT8          mImage[TEST_FLASH_SIZE];
+STATIC UINT8          mContent[TEST_FLASH_SIZE];
+
+//
+// Host replacements of the BaseLib, BaseMemoryLib, MemoryAllocationLib and
+// ConsoleOutLib routines used by the planner.
+//
+VOID *
+EFIAPI
+ZeroMem (
+  OUT VOID  *Buffer,
+  IN UINTN  Length
+  )
+{
+  return memset (Buffer, 0, Length);
+}
+
+VOID *
+EFIAPI
+SetMem (
+  OUT VOID  *Buffer,
+  IN UINTN  Length,
+  IN UINT8  Value
+  )
+{
+  return memset (Buffer, Value, Length);
+}
+
+INTN
+EFIAPI
+CompareMem (
+  IN CONST VOID  *DestinationBuffer,
+  IN CONST VOID  *SourceBuffer,
+  IN UINTN       Length
+  )
+{
+  return memcmp (DestinationBuffer, SourceBuffer, Length);
+}
+
+UINT64
+EFIAPI
+DivU64x32 (
+  IN UINT64  Dividend,
+  IN UINT32  Divisor
+  )
+{
+  return Dividend / Divisor;
+}
+
+VOID *
+EFIAPI
+AllocateZeroPool (
+  IN UINTN  AllocationSize
+  )
+{
+  return calloc (1, AllocationSize);
+}
+
+VOID
+EFIAPI
+FreePool (
+  IN VOID   *Buffer
+  )
+{
+  free (Buffer);
+}
+
+VOID *
+EFIAPI
+AllocatePages (
+  IN UINTN  Pages
+  )
+{
+  return malloc (EFI_PAGES_TO_SIZE (Pages));
+}
+
+VOID
+EFIAPI
+FreePages (
+  IN VOID   *Buffer,
+  IN UINTN  Pages
+  )
+{
+  free (Buffer);
+}
+
+UINTN
+EFIAPI
+ConsolePrint (
+  IN  CONST CHAR8          *Format,
+  ...
+  )
+{
+  va_list   Marker;
+  int       Count;
+
+  va_start (Marker, Format);
+  printf ("  ");
+  Count = vprintf (Format, Marker);
+  va_end (Marker);
+  return (Count < 0) ? 0 : (UINTN)Count;
+}
+
+/**
+  Check a boot media range against the flash size.
+
+  @param[in]  Address       The boot media address.
+  @param[in]  ByteCount     The length of the range.
+
+  @retval TRUE              The range is inside the flash.
+  @retval FALSE             The range goes past the end of the flash.
+**/
+STATIC
+BOOLEAN
+IsFlashRange (
+  IN  UINT64        Address,
+  IN  UINT32        ByteCount
+  )
+{
+  return (Address <= TEST_FLASH_SIZE) && (ByteCount <= TEST_FLASH_SIZE - Address);
+}
+
+/**
+  Read the file-backed flash.
+
+  @param[in]  Address       The boot media address to read from.
+  @param[in]  ByteCount     The number of bytes to read.
+  @param[out] Buffer        The destination buffer.
+
+  @retval EFI_SUCCESS             The data was read.
+  @retval EFI_INVALID_PARAMETER   The range goes past the end of the flash.
+  @retval EFI_DEVICE_ERROR        The flash file could not be read.
+**/
+EFI_STATUS
+EFIAPI
+BootMediaRead (
+  IN     UINT64                  Address,
+  IN     UINT32                  ByteCount,
+  OUT    UINT8                   *Buffer
+  )
+{
+  if (!IsFlashRange (Address, ByteCount)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if ((fseek (mFlash, (long)Address, SEEK_SET) != 0) || (fread (Buffer, 1, ByteCount, mFlash) != ByteCount)) {
+    return EFI_DEVICE_ERROR;
+  }
+  return EFI_SUCCESS;
+}
+
+/**
+  Program the file-backed flash.
+
+  Programming only clears bits. A part with ECC leaves data that is not
+  erased unchanged.
+
+  @param[in]  Address       The boot media address to write to.
+  @param[in]  ByteCount     The number of bytes to write.
+  @param[in]  Buffer        The data to write.
+
+  @retval EFI_SUCCESS             The data was programmed.
+  @retval EFI_INVALID_PARAMETER   The range goes past the end of the flash.
+  @retval EFI_DEVICE_ERROR        The flash file could not be accessed.
+**/
+EFI_STATUS
+EFIAPI
+BootMediaWrite (
+  IN     UINT64                  Address,
+  IN     UINT32                  ByteCount,
+  OUT    UINT8                   *Buffer
+  )
+{
+  STATIC UINT8  Current[FLASH_BLOCK_SIZE];
+  EFI_STATUS    Status;
+  UINT32        Index;
+
+  if (ByteCount > sizeof (Current)) {
+    return EFI_BAD_BUFFER_SIZE;
+  }
+  Status = BootMediaRead (Address, ByteCount, Current);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  mWrites++;
+  for (Index = 0; Index < ByteCount; Index++) {
+    if (!mEccPart || (Current[Index] == PAD_BYTE)) {
+      Current[Index] &= Buffer[Index];
+    }
+  }
+  if ((fseek (mFlash, (long)Address, SEEK_SET) != 0) || (fwrite (Current, 1, ByteCount, mFlash) != ByteCount)) {
+    return EFI_DEVICE_ERROR;
+  }
+  return EFI_SUCCESS;
+}
+
+/**
+  Erase a 4KB sector or a 64KB block of the file-backed flash.
+
+  @param[in]  Address       The boot media address to erase.
+  @param[in]  ByteCount     The size to erase, 4KB or 64KB.
+
+  @retval EFI_SUCCESS             The range was erased.
+  @retval EFI_INVALID_PARAMETER   The range is not an aligned sector or block.
+  @retval EFI_DEVICE_ERROR        The flash file could not be written.
+**/
+EFI_STATUS
+EFIAPI
+BootMediaErase (
+  IN     UINT64                  Address,
+  IN     UINT32                  ByteCount
+  )
+{
+  STATIC UINT8  Blank[FLASH_BLOCK_SIZE];
+
+  if (((ByteCount != FLASH_SECTOR_SIZE) && (ByteCount != FLASH_BLOCK_SIZE)) ||
+      ((Address % ByteCount) != 0) || !IsFlashRange (Address, ByteCount)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (ByteCount == FLASH_BLOCK_SIZE) {
+    mBlockErases++;
+  } else {
+    mSectorErases++;
+  }
+  memset (Blank, PAD_BYTE, ByteCount);
+  if ((fseek (mFlash, (long)Address, SEEK_SET) != 0) || (fwrite (Blank, 1, ByteCount, mFlash) != ByteCount)) {
+    return EFI_DEVICE_ERROR;
+  }
+  return EFI_SUCCESS;
+}
+
+/**
+  Record a failed check.
+
+  @param[in]  Condition     The result of the check.
+  @param[in]  Message       The description of the check.
+**/
+STATIC
+VOID
+Check (
+  IN  BOOLEAN        Condition,
+  IN  CONST CHAR8   *Message
+  )
+{
+  if (!Condition) {
+    printf ("  FAILED: %s\n", Message);
+    mErrors++;
+  }
+}
+
+/**
+  Start a test case with the flash holding the current image.
+
+  @param[in]  Name              The name of the test case.
+  @param[in]  ProgramOverData   The value of PcdFlashProgramWithoutEraseEnabled.
+  @param[in]  EccPart           TRUE to model a part with ECC.
+**/
+STATIC
+VOID
+StartTest (
+  IN  CONST CHAR8   *Name,
+  IN  BOOLEAN        ProgramOverData,
+  IN  BOOLEAN        EccPart
+  )
+{
+  printf ("%s\n", Name);
+  mTestProgramWithoutErase = ProgramOverData;
+  mEccPart = EccPart;
+
+  fseek (mFlash, 0, SEEK_SET);
+  fwrite (mContent, 1, sizeof (mContent), mFlash);
+  memcpy (mImage, mContent, sizeof (mImage));
+
+  mSectorErases = 0;
+  mBlockErases  = 0;
+  mWrites       = 0;
+}
+
+/**
+  Plan and apply the update of a range to the new image.
+
+  The range is applied in parts of PartLength bytes, like UpdateBootRegion
+  does. The whole flash is then compared with the new image, so that any
+  change outside of the range is caught as well.
+
+  @param[in]  Address       The start of the range.
+  @param[in]  Length        The length of the range.
+  @param[in]  PartLength    The length of each part, a multiple of 4KB.
+  @param[out] Plan          The update plan that was applied.
+**/
+STATIC
+VOID
+UpdateAndVerify (
+  IN  UINT32              Address,
+  IN  UINT32              Length,
+  IN  UINT32              PartLength,
+  OUT FLASH_UPDATE_PLAN  *Plan
+  )
+{
+  STATIC UINT8  Flash[TEST_FLASH_SIZE];
+  EFI_STATUS    Status;
+  UINT32        Offset;
+
+  memcpy (mImage + Address, mContent + Address, Length);
+  Status = PlanFlashUpdate (Address, mImage + Address, Length, Plan);
+  if (EFI_ERROR (Status)) {
+    printf ("  FAILED: planning 0x%x bytes at 0x%x returned 0x%x\n", (unsigned)Length, (unsigned)Address, (unsigned)Status);
+    mErrors++;
+    return;
+  }
+
+  for (Offset = 0; Offset < Length; Offset += PartLength) {
+    Status = ExecuteFlashUpdate (Plan, Offset, MIN (PartLength, Length - Offset));
+    if (EFI_ERROR (Status)) {
+      printf ("  FAILED: updating 0x%x returned 0x%x\n", (unsigned)(Address + Offset), (unsigned)Status);
+      mErrors++;
+      break;
+    }
+  }
+  FreeFlashUpdatePlan (Plan);
+
+  BootMediaRead (0, TEST_FLASH_SIZE, Flash);
+  Check (memcmp (Flash, mImage, TEST_FLASH_SIZE) == 0, "the flash holds the new image");
+}
+
+/**
+  Change random bytes of the new content.
+
+  @param[in]  Offset        The first byte that may change.
+  @param[in]  Length        The length of the area that may change.
+  @param[in]  Count         The number of bytes to change.
+  @param[in]  ClearOnly     TRUE to only clear bits.
+**/
+STATIC
+VOID
+ChangeContent (
+  IN  UINT32        Offset,
+  IN  UINT32        Length,
+  IN  UINT32        Count,
+  IN  BOOLEAN       ClearOnly
+  )
+{
+  UINT32        Index;
+  UINT8        *Byte;
+
+  for (Index = 0; Index < Count; Index++) {
+    Byte = &mContent[Offset + (UINT32)rand () % Length];
+    if (ClearOnly) {
+      *Byte &= (UINT8)~(1 << (rand () % 8));
+    } else {
+      *Byte = (UINT8)~*Byte;
+    }
+  }
+}
+
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  FLASH_UPDATE_PLAN   Plan;
+  UINT32              Index;
+  UINT32              Address;
+  UINT32              Length;
+  UINT32              Sector;
+
+  mFlash = tmpfile ();
+  if (mFlash == NULL) {
+    printf ("Cannot create the flash file!\n");
+    return 1;
+  }
+
+  srand (1);
+  for (Index = 0; Index < sizeof (mContent); Index++) {
+    mContent[Index] = (UINT8)rand ();
+  }
+  // Leave some blank sectors, which are only verified after a block erase
+  memset (mContent + FLASH_BLOCK_SIZE * 2, PAD_BYTE, FLASH_SECTOR_SIZE * 4);
+
+  StartTest ("Unchanged image", TRUE, FALSE);
+  UpdateAndVerify (0, TEST_FLASH_SIZE, FLASH_BLOCK_SIZE, &Plan);
+  Check (Plan.ChangedCount == 0, "no sector is planned to change");
+  Check ((mSectorErases + mBlockErases + mWrites) == 0, "the flash is only read");
+
+  StartTest ("Program without erase", TRUE, FALSE);
+  ChangeContent (FLASH_SECTOR_SIZE * 3, FLASH_SECTOR_SIZE, 16, TRUE);
+  UpdateAndVerify (0, FLASH_BLOCK_SIZE, FLASH_BLOCK_SIZE, &Plan);
+  Check ((Plan.ChangedCount == 1) && (Plan.ProgramCount == 1), "a sector that only clears bits is programmed");
+  Check ((mSectorErases + mBlockErases) == 0, "nothing is erased");
+  Check (mWrites == 1, "only the changed sector is written");
+
+  StartTest ("Program without erase disabled", FALSE, FALSE);
+  ChangeContent (FLASH_SECTOR_SIZE * 5, FLASH_SECTOR_SIZE, 16, TRUE);
+  UpdateAndVerify (0, FLASH_BLOCK_SIZE, FLASH_BLOCK_SIZE, &Plan);
+  Check ((Plan.ProgramCount == 0) && (Plan.SectorEraseCount == 1), "the sector is planned to be erased");
+  Check ((mSectorErases == 1) && (mBlockErases == 0), "the sector is erased");
+
+  StartTest ("ECC part", TRUE, TRUE);
+  ChangeContent (FLASH_SECTOR_SIZE * 7, FLASH_SECTOR_SIZE, 16, TRUE);
+  UpdateAndVerify (0, FLASH_BLOCK_SIZE, FLASH_BLOCK_SIZE, &Plan);
+  Check (mSectorErases == 1, "a failed program falls back to erase and write");
+
+  StartTest ("Block erase", FALSE, FALSE);
+  for (Sector = 0; Sector < FLASH_SECTORS_PER_BLOCK; Sector++) {
+    ChangeContent (FLASH_BLOCK_SIZE + Sector * FLASH_SECTOR_SIZE, FLASH_SECTOR_SIZE, 1, FALSE);
+  }
+  UpdateAndVerify (0, FLASH_BLOCK_SIZE * 2, FLASH_BLOCK_SIZE, &Plan);
+  Check (Plan.BlockEraseCount == 1, "the sector erases of a block are merged");
+  Check ((mBlockErases == 1) && (mSectorErases == 0), "one 64KB block is erased");
+
+  StartTest ("Blank sectors of an erased block", FALSE, FALSE);
+  for (Sector = 4; Sector < FLASH_SECTORS_PER_BLOCK; Sector++) {
+    ChangeContent (FLASH_BLOCK_SIZE * 2 + Sector * FLASH_SECTOR_SIZE, FLASH_SECTOR_SIZE, 1, FALSE);
+  }
+  UpdateAndVerify (FLASH_BLOCK_SIZE * 2, FLASH_BLOCK_SIZE, FLASH_SECTOR_SIZE * 4, &Plan);
+  Check (mBlockErases == 1, "the block is erased");
+  Check (mWrites == FLASH_SECTORS_PER_BLOCK - 4, "blank sectors are not written");
+
+  StartTest ("Unaligned range", FALSE, FALSE);
+  Address = FLASH_BLOCK_SIZE * 3 + FLASH_SECTOR_SIZE;
+  for (Sector = 0; Sector < FLASH_SECTORS_PER_BLOCK; Sector++) {
+    ChangeContent (Address + Sector * FLASH_SECTOR_SIZE, FLASH_SECTOR_SIZE, 1, FALSE);
+  }
+  UpdateAndVerify (Address, FLASH_BLOCK_SIZE, FLASH_BLOCK_SIZE, &Plan);
+  Check (mBlockErases == 0, "blocks not inside the range are not erased at once");
+  Check (mSectorErases == FLASH_SECTORS_PER_BLOCK, "every changed sector is erased");
+
+  //
+  // Random changes of random ranges, applied in parts of random length. The
+  // ranges are whole sectors, like the flash regions the payload updates.
+  //
+  StartTest ("Random updates", TRUE, FALSE);
+  for (Index = 0; Index < TEST_RANDOM_LOOPS; Index++) {
+    mTestProgramWithoutErase = (rand () % 2) == 0;
+    Address = ((UINT32)rand () % (TEST_FLASH_SIZE / FLASH_SECTOR_SIZE)) * FLASH_SECTOR_SIZE;
+    Length  = FLASH_SECTOR_SIZE * (1 + (UINT32)rand () % ((TEST_FLASH_SIZE - Address) / FLASH_SECTOR_SIZE));
+    ChangeContent (Address, Length, 1 + rand () % 64, (rand () % 2) == 0);
+    UpdateAndVerify (Address, Length, FLASH_SECTOR_SIZE * (1 + rand () % 20), &Plan);
+  }
+  printf ("  %u 64KB and %u 4KB erases, %u writes\n", (unsigned)mBlockErases, (unsigned)mSectorErases, (unsigned)mWrites);
+  PrintFlashUpdatePlan (&Plan);
+
+  fclose (mFlash);
+
+  printf ("\n%s %s\n", UTILITY_NAME, (mErrors == 0) ? "PASSED" : "FAILED");
+  return (mErrors == 0) ? 0 : 1;
+}
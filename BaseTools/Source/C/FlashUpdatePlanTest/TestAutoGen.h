@@ -0,0 +1,22 @@
+/** @file
+Stand-in for the AutoGen.h of a firmware build of FlashUpdatePlan.c.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __TEST_AUTOGEN_H__
+#define __TEST_AUTOGEN_H__
+
+#include <PiPei.h>
+
+//
+// The feature PCD reads a variable of the test, so that both settings are
+// covered by one build
+//
+extern BOOLEAN  mTestProgramWithoutErase;
+
+#define _PCD_GET_MODE_BOOL_PcdFlashProgramWithoutEraseEnabled  mTestProgramWithoutErase
+
+#endif
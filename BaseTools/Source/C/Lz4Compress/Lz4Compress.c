@@ -1,7 +1,7 @@
 /** @file
 LZ4 compress and decompress utility
 
-Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2017 - 2026, Intel Corporation. All rights reserved.<BR>
 This program and the accompanying materials
 are licensed and made available under the terms and conditions of the BSD License
 which accompanies this distribution.  The full text of the license may be found at
@@ -25,18 +25,153 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #define UTILITY_NAME "Lz4Compress"
 
 #define INTEL_COPYRIGHT \
-  "Copyright (c) 2017, Intel Corporation. All rights reserved."
+  "Copyright (c) 2017 - 2026, Intel Corporation. All rights reserved."
 
 void PrintHelp (void)
 {
   printf (   "\n" UTILITY_NAME " - " INTEL_COPYRIGHT "\n"
-             "\nUsage:  Lz4Compress -e|-d  -o <outputFile>  <inputFile>\n"
+             "\nUsage:  Lz4Compress -e|-d  [-b <blockSize>]  -o <outputFile>  <inputFile>\n"
              "  -e: encode file\n"
              "  -d: decode file\n"
+             "  -b BlockSize: use the block-parallel LZ4B format, compressing each\n"
+             "                BlockSize bytes independently. The block size is read\n"
+             "                from the input file when decoding.\n"
              "  -o FileName, --output FileName: specify the output filename\n"
              );
 }
 
+/*++
+
+Routine Description:
+
+  Compress a buffer into the block-parallel LZ4B format: a header with the
+  total size, the block size and the block count, an offset table with one
+  entry per block plus the end offset, and the independently compressed blocks.
+
+Arguments:
+
+  bufi      - input buffer
+  inpsz     - input size
+  blksz     - block size
+  bufo      - receives the allocated output buffer
+
+Returns:
+
+  the output size, or -1 on failure
+
+--*/
+int
+CompressBlocks (
+  const char  *bufi,
+  int          inpsz,
+  int          blksz,
+  char       **bufo
+  )
+{
+  unsigned int  *hdr;
+  int            cnt;
+  int            idx;
+  int            len;
+  int            bufsz;
+  int            res;
+  int            off;
+
+  cnt   = (inpsz + blksz - 1) / blksz;
+  off   = (3 + cnt + 1) * sizeof (unsigned int);
+  bufsz = off + cnt * LZ4_compressBound (blksz);
+  *bufo = (char *)malloc (bufsz);
+  if (*bufo == NULL) {
+    return -1;
+  }
+
+  res    = 0;
+  hdr    = (unsigned int *)*bufo;
+  hdr[0] = inpsz;
+  hdr[1] = blksz;
+  hdr[2] = cnt;
+  for (idx = 0; idx < cnt; idx++) {
+    hdr[3 + idx] = off;
+    len = (inpsz - idx * blksz < blksz) ? (inpsz - idx * blksz) : blksz;
+    res = LZ4_compress_HC (bufi + idx * blksz, *bufo + off, len, bufsz - off, 0);
+    if (res <= 0) {
+      break;
+    }
+    off += res;
+  }
+
+  if ((cnt > 0) && (res <= 0)) {
+    free (*bufo);
+    *bufo = NULL;
+    return -1;
+  }
+  hdr[3 + cnt] = off;
+
+  return off;
+}
+
+/*++
+
+Routine Description:
+
+  Decompress a buffer in the block-parallel LZ4B format.
+
+Arguments:
+
+  bufi      - input buffer
+  inpsz     - input size
+  bufo      - receives the allocated output buffer
+
+Returns:
+
+  the output size, or -1 on failure
+
+--*/
+int
+DecompressBlocks (
+  const char  *bufi,
+  int          inpsz,
+  char       **bufo
+  )
+{
+  const unsigned int  *hdr;
+  unsigned int         cnt;
+  unsigned int         idx;
+  unsigned int         len;
+  int                  res;
+
+  hdr = (const unsigned int *)bufi;
+  if ((inpsz < 3 * (int)sizeof (unsigned int)) || (hdr[1] == 0) || (hdr[0] > 0x7FFFFFFF)) {
+    return -1;
+  }
+  cnt = hdr[2];
+  if ((cnt != (hdr[0] + hdr[1] - 1) / hdr[1]) || ((3 + cnt + 1) * sizeof (unsigned int) > (unsigned int)inpsz)) {
+    return -1;
+  }
+
+  *bufo = (char *)malloc (hdr[0] ? hdr[0] : 1);
+  if (*bufo == NULL) {
+    return -1;
+  }
+  for (idx = 0; idx < cnt; idx++) {
+    if ((hdr[3 + idx] > hdr[4 + idx]) || (hdr[4 + idx] > (unsigned int)inpsz)) {
+      break;
+    }
+    len = (hdr[0] - idx * hdr[1] < hdr[1]) ? (hdr[0] - idx * hdr[1]) : hdr[1];
+    res = LZ4_decompress_safe (bufi + hdr[3 + idx], *bufo + idx * hdr[1], hdr[4 + idx] - hdr[3 + idx], len);
+    if (res != (int)len) {
+      break;
+    }
+  }
+
+  if (idx < cnt) {
+    free (*bufo);
+    *bufo = NULL;
+    return -1;
+  }
+
+  return hdr[0];
+}
+
 
 int
 main (
@@ -69,6 +204,9 @@ Returns:
   int    res;
   int    decompress;
   int    inpsz;
+  int    blksz;
+  long   val;
+  char   *end;
   char   *bufi;
   char   *bufo;
   char   *input;
@@ -81,6 +219,8 @@ Returns:
   output = NULL;
   input  = NULL;
   decompress = -1;
+  blksz  = 0;
+  res    = -1;
 
   if (argc < 5) {
     PrintHelp ();
@@ -93,6 +233,18 @@ Returns:
         decompress = 1;
       } else if (!strcmp(argv[i], "-e")) {
         decompress = 0;
+      } else if (!strcmp(argv[i], "-b")) {
+        if (i+1 >= argc) {
+          printf("Block size is required for '-b' !\n");
+          return -5;
+        }
+        val = strtol (argv[i+1], &end, 0);
+        if ((end == argv[i+1]) || (*end != 0) || (val <= 0) || (val > 0x7FFFFFFF)) {
+          printf("Invalid block size '%s' !\n", argv[i+1]);
+          return -5;
+        }
+        blksz = (int)val;
+        i++;
       } else if (!strcmp(argv[i], "-o")) {
         if (i+1 < argc) {
           output =  argv[i+1];
@@ -134,19 +286,38 @@ Returns:
   inpsz = ftell(fp);
   fseek(fp, 0L, SEEK_SET);
 
-  bufi = (char *)malloc(inpsz);
-  if (bufi) {
-    fread(bufi, inpsz, 1, fp);
+  bufi = NULL;
+  if (inpsz >= 0) {
+    bufi = (char *)malloc(inpsz ? inpsz : 1);
+  }
+  if (bufi == NULL) {
+    printf("Cannot allocate memory for '%s' !\n", input);
+    fclose(fp);
+    return -4;
+  }
+  if ((inpsz > 0) && (fread(bufi, inpsz, 1, fp) != 1)) {
+    printf("Cannot read file '%s' !\n", input);
+    fclose(fp);
+    free(bufi);
+    return -4;
   }
   fclose(fp);
 
-  if (decompress == 1) {
-    sz = *(int *)bufi;
-    if ((sz < 0) || (inpsz < sizeof(int))) {
+  if (blksz != 0) {
+    if (decompress == 1) {
+      res = DecompressBlocks (bufi, inpsz, &bufo);
+    } else {
+      res = CompressBlocks (bufi, inpsz, blksz, &bufo);
+    }
+  } else if (decompress == 1) {
+    if (inpsz < (int)sizeof(int)) {
       res = -1;
     } else {
-      bufo = (char *)malloc(sz);
-      res = LZ4_decompress_safe((const char *)bufi + sizeof(int), (char *)bufo, inpsz - sizeof(int), sz);
+      sz = *(int *)bufi;
+      bufo = (sz > 0) ? (char *)malloc(sz) : NULL;
+      if (bufo) {
+        res = LZ4_decompress_safe((const char *)bufi + sizeof(int), (char *)bufo, inpsz - sizeof(int), sz);
+      }
     }
   } else {
     bufsz = LZ4_compressBound(inpsz);
@@ -162,8 +333,9 @@ Returns:
     fp = fopen (output, "wb");
     if (!fp) {
       printf("Cannot create file '%s' !\n", output);
+      res = -1;
     } else {
-      if (!decompress) {
+      if (!decompress && (blksz == 0)) {
         fwrite(&inpsz, sizeof(int), 1, fp);
       }
       fwrite(bufo, res, 1, fp);
@@ -5,7 +5,7 @@
     LzmaUtil.c -- Test application for LZMA compression
     2019-02-21 : Igor Pavlov : Public domain
 
-  Copyright (c) 2006 - 2019, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -44,6 +44,7 @@ static CONVERTER_TYPE mConType = NoConverter;
 
 UINT64 mDictionarySize = 28;
 UINT64 mCompressionMode = 2;
+UINT64 mNumThreads = 2;
 
 #define UTILITY_NAME "LzmaCompress"
 #define UTILITY_MAJOR_VERSION 0
@@ -65,6 +66,8 @@ void PrintHelp(char *buffer)
              "  --debug [0-9]: set debug level\n"
              "  -a: set compression mode 0 = fast, 1 = normal, default: 1 (normal)\n"
              "  d: sets Dictionary size - [0, 27], default: 24 (16MB)\n"
+             "  --threads N: number of encoder threads, 1 disables the match finder thread,\n"
+             "               the LZMA encoder uses up to 2, default: 2\n"
              "  --version: display the program version and exit\n"
              "  -h, --help: display this help text\n"
              );
@@ -309,6 +312,19 @@ int main2(int numArgs, const char *args[], char *rs)
       } else {
         return PrintError(rs, kInvalidParamValMessage);
       }
+    } else if (strcmp(args[param], "--threads") == 0) {
+      if (numArgs < (param + 2)) {
+        return PrintUserError(rs);
+      }
+      //
+      // The output does not depend on the thread count: the match finder
+      // thread only looks up the same matches ahead of the encoder.
+      //
+      if ((AsciiStringToUint64(args[param + 1], FALSE, &mNumThreads) != EFI_SUCCESS) || (mNumThreads == 0)) {
+        return PrintError(rs, kInvalidParamValMessage);
+      }
+      props.numThreads = (mNumThreads > 1) ? 2 : 1;
+      param++;
     } else if (
                 strcmp(args[param], "-h") == 0 ||
                 strcmp(args[param], "--help") == 0
@@ -0,0 +1,309 @@
+/** @file
+Host benchmark for the multi-threaded LZMA encoder of the LzmaCompress tool.
+
+Each input file, typically a build artifact such as a stage FD, an FSP or a
+payload, is compressed with the match finder running on the encoder thread
+and on a thread of its own. The compression throughput is reported for both,
+the two streams are checked to be identical, and the stream is decoded with
+the LZMA library of BootloaderCommonPkg and compared to the input.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+//
+// The C library headers go first, as the GCC ProcessorBind.h of MdePkg makes
+// all following declarations hidden. Base.h then provides its own NULL.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#undef NULL
+
+#include <Library/LzmaDecompressLib.h>
+#include "LzmaCompressBenchEncode.h"
+
+#define UTILITY_NAME            "LzmaCompressBench"
+
+#define BENCH_MIN_SECONDS       1.0
+#define BENCH_MAX_THREADS       2
+
+//
+// Host replacements of the BaseLib and BaseMemoryLib routines used by the
+// library.
+//
+VOID *
+EFIAPI
+CopyMem (
+  OUT VOID       *DestinationBuffer,
+  IN CONST VOID  *SourceBuffer,
+  IN UINTN       Length
+  )
+{
+  return memmove (DestinationBuffer, SourceBuffer, Length);
+}
+
+UINT64
+EFIAPI
+LShiftU64 (
+  IN UINT64  Operand,
+  IN UINTN   Count
+  )
+{
+  return Operand << Count;
+}
+
+BOOLEAN
+EFIAPI
+DebugAssertEnabled (
+  VOID
+  )
+{
+  return TRUE;
+}
+
+VOID
+EFIAPI
+DebugAssert (
+  IN CONST CHAR8  *FileName,
+  IN UINTN        LineNumber,
+  IN CONST CHAR8  *Description
+  )
+{
+  fprintf (stderr, "ASSERT %s(%u): %s\n", FileName, (unsigned)LineNumber, Description);
+  abort ();
+}
+
+/**
+  Get a monotonic time stamp in seconds.
+
+  @return The time stamp.
+**/
+STATIC
+double
+GetSeconds (
+  VOID
+  )
+{
+  struct timespec  Ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &Ts);
+  return Ts.tv_sec + Ts.tv_nsec / 1e9;
+}
+
+/**
+  Read a whole file.
+
+  @param  FileName   The file to read.
+  @param  Size       Receives the size of the file.
+
+  @return The allocated file content, or NULL on failure.
+**/
+STATIC
+UINT8 *
+ReadFile (
+  IN  CONST CHAR8  *FileName,
+  OUT UINT32       *Size
+  )
+{
+  FILE   *Fp;
+  long    Length;
+  UINT8  *Buffer;
+
+  Fp = fopen (FileName, "rb");
+  if (Fp == NULL) {
+    return NULL;
+  }
+
+  Buffer = NULL;
+  if ((fseek (Fp, 0L, SEEK_END) == 0) && ((Length = ftell (Fp)) >= 0) && (Length < 0x7FFFFFFF)) {
+    fseek (Fp, 0L, SEEK_SET);
+    Buffer = malloc (Length + 1);
+    if ((Buffer != NULL) && (fread (Buffer, 1, Length, Fp) != (size_t)Length)) {
+      free (Buffer);
+      Buffer = NULL;
+    }
+    *Size = (UINT32)Length;
+  }
+  fclose (Fp);
+
+  return Buffer;
+}
+
+/**
+  Compress an image repeatedly and print the results.
+
+  @param  NumThreads  The number of encoder threads.
+  @param  Original    The uncompressed image.
+  @param  Size        The size of the uncompressed image.
+  @param  Packed      Receives the allocated compressed image.
+  @param  Seconds     Receives the time of one compression.
+
+  @return The size of the compressed image, or 0 on failure.
+**/
+STATIC
+UINT32
+Benchmark (
+  IN  INTN          NumThreads,
+  IN  CONST UINT8  *Original,
+  IN  UINT32        Size,
+  OUT VOID        **Packed,
+  OUT double       *Seconds
+  )
+{
+  UINT32   PackedSize;
+  UINTN    Loops;
+  double   Start;
+  double   Elapsed;
+
+  Loops  = 0;
+  *Packed = NULL;
+  Start  = GetSeconds ();
+  do {
+    free (*Packed);
+    PackedSize = (UINT32)BenchEncodeLzma (Original, Size, (int)NumThreads, Packed);
+    Loops++;
+    Elapsed = GetSeconds () - Start;
+  } while ((PackedSize != 0) && (Elapsed < BENCH_MIN_SECONDS));
+
+  *Seconds = Elapsed / Loops;
+  if (PackedSize == 0) {
+    printf ("  %-7d %10s\n", (int)NumThreads, "FAILED");
+  } else {
+    printf ("  %-7d %10u %7.2f%% %10.2f", (int)NumThreads, (unsigned)PackedSize,
+      Size ? 100.0 * PackedSize / Size : 0.0, (double)Size / *Seconds / 1e6);
+  }
+
+  return PackedSize;
+}
+
+/**
+  Decode a compressed image with the firmware library and check it.
+
+  @param  Original    The uncompressed image.
+  @param  Size        The size of the uncompressed image.
+  @param  Packed      The compressed image.
+  @param  PackedSize  The size of the compressed image.
+
+  @retval TRUE        The decoded image matches the original.
+  @retval FALSE       The decoder failed or produced a different image.
+**/
+STATIC
+BOOLEAN
+Verify (
+  IN  CONST UINT8  *Original,
+  IN  UINT32        Size,
+  IN  CONST VOID   *Packed,
+  IN  UINT32        PackedSize
+  )
+{
+  UINT32    DstSize;
+  UINT32    ScratchSize;
+  UINT8    *Dst;
+  VOID     *Scratch;
+  BOOLEAN   Match;
+
+  if ((LzmaUefiDecompressGetInfo (Packed, PackedSize, &DstSize, &ScratchSize) != RETURN_SUCCESS) ||
+      (DstSize != Size)) {
+    return FALSE;
+  }
+
+  Dst     = malloc (DstSize + 1);
+  Scratch = malloc (ScratchSize + 1);
+  Match   = (Dst != NULL) && (Scratch != NULL) &&
+            (LzmaUefiDecompress (Packed, PackedSize, Dst, Scratch) == RETURN_SUCCESS) &&
+            (memcmp (Dst, Original, Size) == 0);
+
+  free (Dst);
+  free (Scratch);
+  return Match;
+}
+
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  int        Index;
+  int        Errors;
+  INTN       NumThreads;
+  UINT8     *Original;
+  UINT32     Size;
+  VOID      *Packed[BENCH_MAX_THREADS];
+  UINT32     PackedSize[BENCH_MAX_THREADS];
+  double     Seconds;
+  double     Total[BENCH_MAX_THREADS];
+  UINT64     TotalSize;
+
+  if (argc < 2) {
+    printf ("Usage: %s <file>...\n", UTILITY_NAME);
+    printf ("  Compress build artifacts, e.g. Build/BootloaderCorePkg/*/FV/*.fd, with 1 and %d threads\n",
+      BENCH_MAX_THREADS);
+    return 1;
+  }
+
+  Errors    = 0;
+  TotalSize = 0;
+  for (NumThreads = 1; NumThreads <= BENCH_MAX_THREADS; NumThreads++) {
+    Total[NumThreads - 1] = 0;
+  }
+
+  for (Index = 1; Index < argc; Index++) {
+    Original = ReadFile (argv[Index], &Size);
+    if (Original == NULL) {
+      fprintf (stderr, "%s: cannot read '%s'\n", UTILITY_NAME, argv[Index]);
+      Errors++;
+      continue;
+    }
+
+    printf ("%s: %u bytes\n", argv[Index], (unsigned)Size);
+    printf ("  %-7s %10s %8s %10s\n", "Threads", "Packed", "Ratio", "MB/s");
+
+    TotalSize += Size;
+    for (NumThreads = 1; NumThreads <= BENCH_MAX_THREADS; NumThreads++) {
+      PackedSize[NumThreads - 1] = Benchmark (NumThreads, Original, Size, &Packed[NumThreads - 1], &Seconds);
+      Total[NumThreads - 1] += Seconds;
+      if (PackedSize[NumThreads - 1] == 0) {
+        Errors++;
+        continue;
+      }
+
+      //
+      // The thread count must not change the stream, and the stream must
+      // decode with the firmware library.
+      //
+      if (NumThreads == 1) {
+        if (!Verify (Original, Size, Packed[0], PackedSize[0])) {
+          printf ("  MISMATCH in firmware decode\n");
+          Errors++;
+          continue;
+        }
+      } else if ((PackedSize[NumThreads - 1] != PackedSize[0]) ||
+                 (memcmp (Packed[NumThreads - 1], Packed[0], PackedSize[0]) != 0)) {
+        printf ("  MISMATCH with 1 thread\n");
+        Errors++;
+        continue;
+      }
+      printf ("\n");
+    }
+
+    for (NumThreads = 1; NumThreads <= BENCH_MAX_THREADS; NumThreads++) {
+      free (Packed[NumThreads - 1]);
+    }
+    free (Original);
+    printf ("\n");
+  }
+
+  if (TotalSize != 0) {
+    printf ("Total: %llu bytes\n", (unsigned long long)TotalSize);
+    for (NumThreads = 1; NumThreads <= BENCH_MAX_THREADS; NumThreads++) {
+      printf ("  %d thread(s): %8.3f s %10.2f MB/s, speedup %.2fx\n", (int)NumThreads, Total[NumThreads - 1],
+        TotalSize / Total[NumThreads - 1] / 1e6, Total[0] / Total[NumThreads - 1]);
+    }
+  }
+
+  return (Errors == 0) ? 0 : 1;
+}
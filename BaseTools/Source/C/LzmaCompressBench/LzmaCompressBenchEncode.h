@@ -0,0 +1,45 @@
+/** @file
+Encoder used by the LZMA compression benchmark.
+
+It is built against the LZMA SDK of the LzmaCompress tool only, so this header
+does not depend on the MdePkg types.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __LZMA_COMPRESS_BENCH_ENCODE_H__
+#define __LZMA_COMPRESS_BENCH_ENCODE_H__
+
+#include <stddef.h>
+
+/*++
+
+Routine Description:
+
+  Compress a buffer in the LZMA format of the LzmaCompress tool: the encoded
+  properties, the 64-bit uncompressed size, then the LZMA stream.
+
+Arguments:
+
+  bufi       - input buffer
+  inpsz      - input size
+  numThreads - number of encoder threads, as the --threads option of
+               LzmaCompress
+  bufo       - receives the allocated output buffer
+
+Returns:
+
+  the output size, or 0 on failure
+
+--*/
+size_t
+BenchEncodeLzma (
+  const void  *bufi,
+  size_t       inpsz,
+  int          numThreads,
+  void       **bufo
+  );
+
+#endif
@@ -0,0 +1,371 @@
+/** @file
+Host test for the block cache of the media access library.
+
+The cache of MediaAccessLib is run on top of a RAM disk. Every read is
+checked against the RAM disk contents, and the number of device reads is
+checked for cache hits, the LRU replacement, the read-ahead window, the
+bypass of large transfers and the write-through updates.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+//
+// The C library headers go first, as the GCC ProcessorBind.h of MdePkg makes
+// all following declarations hidden. Base.h then provides its own NULL.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#undef NULL
+
+#include <Base.h>
+#include <Library/BaseLib.h>
+#include <Library/PcdLib.h>
+#include "MediaAccessLibPrivate.h"
+
+#define UTILITY_NAME            "MediaCacheTest"
+
+#define TEST_BLOCK_SIZE         512
+#define TEST_BLOCK_NUM          1000
+#define TEST_RANDOM_LOOPS       20000
+
+//
+// The cache geometry follows from the PCD values set in the makefile
+//
+#define TEST_CACHE_BLOCKS       FixedPcdGet32 (PcdMediaCacheBlockCount)
+#define TEST_READ_AHEAD         FixedPcdGet32 (PcdMediaCacheReadAheadBlocks)
+
+OS_BOOT_MEDIUM_TYPE   mCurrentMediaType;
+DEVICE_BLOCK_FUNC     mDeviceBlockFuncs[OsBootDeviceMax];
+
+STATIC UINT8          mDisk[TEST_BLOCK_NUM * TEST_BLOCK_SIZE];
+STATIC UINTN          mDeviceReads;
+STATIC UINTN          mDeviceBlocks;
+STATIC UINTN          mErrors;
+
+//
+// Host replacements of the BaseLib, BaseMemoryLib and MemoryAllocationLib
+// routines used by the library.
+//
+VOID *
+EFIAPI
+CopyMem (
+  OUT VOID       *DestinationBuffer,
+  IN CONST VOID  *SourceBuffer,
+  IN UINTN       Length
+  )
+{
+  return memmove (DestinationBuffer, SourceBuffer, Length);
+}
+
+VOID *
+EFIAPI
+SetMem (
+  OUT VOID  *Buffer,
+  IN UINTN  Length,
+  IN UINT8  Value
+  )
+{
+  return memset (Buffer, Value, Length);
+}
+
+UINT32
+EFIAPI
+GetPowerOfTwo32 (
+  IN UINT32  Operand
+  )
+{
+  return (Operand == 0) ? 0 : (UINT32)1 << (31 - __builtin_clz (Operand));
+}
+
+UINT64
+EFIAPI
+RShiftU64 (
+  IN UINT64  Operand,
+  IN UINTN   Count
+  )
+{
+  return Operand >> Count;
+}
+
+VOID *
+EFIAPI
+AllocatePool (
+  IN UINTN  AllocationSize
+  )
+{
+  return malloc (AllocationSize);
+}
+
+VOID *
+EFIAPI
+AllocateZeroPool (
+  IN UINTN  AllocationSize
+  )
+{
+  return calloc (1, AllocationSize);
+}
+
+VOID
+EFIAPI
+FreePool (
+  IN VOID   *Buffer
+  )
+{
+  free (Buffer);
+}
+
+/**
+  Report the geometry of the RAM disk.
+
+  @param[in]  DeviceIndex   The device index, only 0 exists.
+  @param[out] DevBlockInfo  The block information of the device.
+
+  @retval EFI_SUCCESS       The information was returned.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestGetInfo (
+  IN  UINTN                DeviceIndex,
+  OUT DEVICE_BLOCK_INFO   *DevBlockInfo
+  )
+{
+  DevBlockInfo->BlockNum  = TEST_BLOCK_NUM;
+  DevBlockInfo->BlockSize = TEST_BLOCK_SIZE;
+  return EFI_SUCCESS;
+}
+
+/**
+  Read blocks from the RAM disk and count the device accesses.
+
+  @param[in]  DeviceIndex   The device index, only 0 exists.
+  @param[in]  StartLBA      The first block to read.
+  @param[in]  BufferSize    The number of bytes to read.
+  @param[out] Buffer        The destination buffer.
+
+  @retval EFI_SUCCESS             The blocks were read.
+  @retval EFI_INVALID_PARAMETER   The request goes past the end of the disk.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestReadBlocks (
+  IN  UINTN                DeviceIndex,
+  IN  EFI_LBA              StartLBA,
+  IN  UINTN                BufferSize,
+  OUT VOID                *Buffer
+  )
+{
+  if ((BufferSize % TEST_BLOCK_SIZE) != 0) {
+    return EFI_BAD_BUFFER_SIZE;
+  }
+  if ((StartLBA > TEST_BLOCK_NUM) || (BufferSize / TEST_BLOCK_SIZE > TEST_BLOCK_NUM - StartLBA)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  mDeviceReads++;
+  mDeviceBlocks += BufferSize / TEST_BLOCK_SIZE;
+  memcpy (Buffer, mDisk + StartLBA * TEST_BLOCK_SIZE, BufferSize);
+  return EFI_SUCCESS;
+}
+
+/**
+  Record a failed check.
+
+  @param[in]  Condition     The result of the check.
+  @param[in]  Message       The description of the check.
+**/
+STATIC
+VOID
+Check (
+  IN  BOOLEAN        Condition,
+  IN  CONST CHAR8   *Message
+  )
+{
+  if (!Condition) {
+    printf ("  FAILED: %s\n", Message);
+    mErrors++;
+  }
+}
+
+/**
+  Read blocks through the cache and compare them with the RAM disk.
+
+  @param[in]  Lba           The first block to read.
+  @param[in]  Blocks        The number of blocks to read.
+
+  @return The number of device reads the request caused.
+**/
+STATIC
+UINTN
+ReadAndVerify (
+  IN  EFI_LBA        Lba,
+  IN  UINTN          Blocks
+  )
+{
+  static UINT8  Buffer[TEST_BLOCK_NUM * TEST_BLOCK_SIZE];
+  UINTN         Reads;
+  EFI_STATUS    Status;
+
+  Reads  = mDeviceReads;
+  Status = MediaCacheReadBlocks (0, Lba, Blocks * TEST_BLOCK_SIZE, Buffer);
+  if (EFI_ERROR (Status)) {
+    printf ("  FAILED: read of %u blocks at LBA %u returned 0x%x\n", (unsigned)Blocks, (unsigned)Lba, (unsigned)Status);
+    mErrors++;
+  } else if (memcmp (Buffer, mDisk + Lba * TEST_BLOCK_SIZE, Blocks * TEST_BLOCK_SIZE) != 0) {
+    printf ("  FAILED: read of %u blocks at LBA %u returned stale data\n", (unsigned)Blocks, (unsigned)Lba);
+    mErrors++;
+  }
+  return mDeviceReads - Reads;
+}
+
+/**
+  Overwrite blocks of the RAM disk and report the write to the cache.
+
+  @param[in]  Lba           The first block to write.
+  @param[in]  Blocks        The number of blocks to write.
+  @param[in]  Written       TRUE if the write is reported as successful.
+**/
+STATIC
+VOID
+WriteBlocks (
+  IN  EFI_LBA        Lba,
+  IN  UINTN          Blocks,
+  IN  BOOLEAN        Written
+  )
+{
+  UINTN         Index;
+
+  for (Index = 0; Index < Blocks * TEST_BLOCK_SIZE; Index++) {
+    mDisk[Lba * TEST_BLOCK_SIZE + Index] = (UINT8)rand ();
+  }
+  MediaCacheWriteThrough (0, Lba, Blocks * TEST_BLOCK_SIZE, mDisk + Lba * TEST_BLOCK_SIZE, Written);
+}
+
+/**
+  Start a test case with an empty cache.
+
+  @param[in]  Name          The name of the test case.
+**/
+STATIC
+VOID
+StartTest (
+  IN  CONST CHAR8   *Name
+  )
+{
+  printf ("%s\n", Name);
+  MediaFlushCache (TRUE);
+  mDeviceReads  = 0;
+  mDeviceBlocks = 0;
+}
+
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  MEDIA_CACHE_INFO  Info;
+  UINTN             Index;
+  UINTN             Reads;
+  EFI_LBA           Lba;
+  EFI_LBA           Next;
+  UINTN             Blocks;
+
+  srand (1);
+  for (Index = 0; Index < sizeof (mDisk); Index++) {
+    mDisk[Index] = (UINT8)rand ();
+  }
+
+  mCurrentMediaType = OsBootDeviceSata;
+  mDeviceBlockFuncs[OsBootDeviceSata].GetInfo    = TestGetInfo;
+  mDeviceBlockFuncs[OsBootDeviceSata].ReadBlocks = TestReadBlocks;
+
+  StartTest ("Hits");
+  Check (ReadAndVerify (100, 2) == 1, "first read goes to the device");
+  Check (ReadAndVerify (100, 2) == 0, "second read is served from the cache");
+  Check (ReadAndVerify (101, 1) == 0, "part of a cached read is served from the cache");
+  Check (ReadAndVerify (99, 3) == 1, "a partial hit reads only the missing run");
+  Check (mDeviceBlocks == 3, "only the missing blocks are read");
+  MediaGetCacheInfo (&Info);
+  Check ((Info.Hits == 5) && (Info.Misses == 3), "hits and misses are counted");
+
+  //
+  // Fill the cache in reverse order, so that no read looks sequential
+  //
+  StartTest ("LRU replacement");
+  for (Index = TEST_CACHE_BLOCKS; Index > 0; Index--) {
+    ReadAndVerify (500 + Index * 2, 1);
+  }
+  Check (mDeviceReads == TEST_CACHE_BLOCKS, "filling the cache reads every block");
+  Check (ReadAndVerify (500 + TEST_CACHE_BLOCKS * 2, 1) == 0, "the oldest block is still cached");
+  Check (ReadAndVerify (10, 1) == 1, "a new block is read");
+  Check (ReadAndVerify (500 + TEST_CACHE_BLOCKS * 2, 1) == 0, "a block used again is not recycled");
+  Check (ReadAndVerify (500 + 2, 1) == 0, "the most recent fill block is still cached");
+  Check (ReadAndVerify (500 + (TEST_CACHE_BLOCKS - 1) * 2, 1) == 1, "the least recently used block was recycled");
+
+  StartTest ("Sequential read-ahead");
+  for (Lba = 0; Lba < 256; Lba++) {
+    ReadAndVerify (Lba, 1);
+  }
+  Check (mDeviceReads <= 256 / TEST_READ_AHEAD + MEDIA_CACHE_MIN_READ_AHEAD, "sequential reads are merged by the read-ahead");
+  MediaGetCacheInfo (&Info);
+  Check (Info.ReadAheadBlocks == TEST_READ_AHEAD, "the read-ahead window grows to its maximum");
+  Check (Info.PrefetchedBlocks > 0, "prefetched blocks are counted");
+
+  StartTest ("Read-ahead at the end of the media");
+  for (Lba = TEST_BLOCK_NUM - 40; Lba < TEST_BLOCK_NUM; Lba++) {
+    ReadAndVerify (Lba, 1);
+  }
+  Check (mDeviceBlocks == 40, "no block past the end of the media is read");
+
+  StartTest ("Bypass");
+  Blocks = TEST_CACHE_BLOCKS * 2;
+  Check (ReadAndVerify (200, Blocks) == 1, "a large read goes to the device at once");
+  Check (ReadAndVerify (200, 1) == 1, "a large read is not cached");
+  MediaGetCacheInfo (&Info);
+  Check (Info.BypassedBlocks == Blocks, "bypassed blocks are counted");
+
+  StartTest ("Write-through");
+  ReadAndVerify (300, 4);
+  WriteBlocks (301, 2, TRUE);
+  Check (ReadAndVerify (300, 4) == 0, "written blocks are updated in the cache");
+  WriteBlocks (301, 1, FALSE);
+  Check (ReadAndVerify (300, 4) == 1, "blocks of a failed write are dropped");
+  WriteBlocks (700, 1, TRUE);
+  Check (ReadAndVerify (700, 1) == 1, "writes do not allocate cache blocks");
+
+  StartTest ("Flush");
+  ReadAndVerify (400, 2);
+  MediaFlushCache (FALSE);
+  Check (ReadAndVerify (400, 2) == 1, "flushed blocks are read again");
+
+  //
+  // Mix random reads and writes in a small area, so that blocks are hit,
+  // recycled and updated all the time, and check every read
+  //
+  StartTest ("Random reads and writes");
+  Next = 0;
+  for (Index = 0; Index < TEST_RANDOM_LOOPS; Index++) {
+    Lba    = ((rand () % 2) == 0) ? Next : (EFI_LBA)(rand () % (TEST_CACHE_BLOCKS * 4));
+    Blocks = 1 + rand () % TEST_READ_AHEAD;
+    if (Lba + Blocks > TEST_CACHE_BLOCKS * 4) {
+      Lba = 0;
+    }
+    if ((rand () % 8) == 0) {
+      WriteBlocks (Lba, Blocks, (rand () % 4) != 0);
+    } else {
+      ReadAndVerify (Lba, Blocks);
+    }
+    Next = Lba + Blocks;
+  }
+  MediaGetCacheInfo (&Info);
+  Reads = (UINTN)(Info.Hits + Info.Misses);
+  printf ("  %u blocks read, %u%% hits\n", (unsigned)Reads, (unsigned)(Info.Hits * 100 / (Reads ? Reads : 1)));
+
+  printf ("\n%s %s\n", UTILITY_NAME, (mErrors == 0) ? "PASSED" : "FAILED");
+  return (mErrors == 0) ? 0 : 1;
+}
@@ -0,0 +1,20 @@
+/** @file
+Stand-in for the AutoGen.h of a firmware build of DebugLogBufferLib.c and
+BasePrintLib.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __TEST_AUTOGEN_H__
+#define __TEST_AUTOGEN_H__
+
+#include <PiPei.h>
+
+#define _PCD_GET_MODE_BOOL_PcdBinaryTraceLogEnabled         TRUE
+#define _PCD_GET_MODE_32_PcdSerialTxFifoSize                16U
+#define _PCD_GET_MODE_32_PcdMaximumAsciiStringLength        0U
+#define _PCD_GET_MODE_32_PcdMaximumUnicodeStringLength      0U
+
+#endif
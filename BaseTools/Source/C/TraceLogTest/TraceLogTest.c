@@ -0,0 +1,494 @@
+/** @file
+Host test for the binary trace log and its host decoder.
+
+Debug messages are written to a log buffer by DebugLogBufferLib.c, either as
+binary trace records or as text when a record can't hold them, the same way
+as the DEBUG output of the firmware. The format strings live in an image
+mapped at a fixed link base. The second half of the messages uses a copy of
+the image at another base, after an image base record, like a relocated
+stage. DecodeTraceLog.py then renders the log from the image at its link
+base, and the output is checked against the messages formatted by
+BasePrintLib.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+//
+// The C library headers go first, as the GCC ProcessorBind.h of MdePkg makes
+// all following declarations hidden. Base.h then provides its own NULL.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#undef NULL
+
+#include <Base.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/PrintLib.h>
+#include <Library/DebugLogBufferLib.h>
+
+#define UTILITY_NAME            "TraceLogTest"
+
+//
+// The trace records keep 32-bit format string addresses
+//
+#define TEST_LINK_BASE          0x10000000
+#define TEST_RUNTIME_BASE       0x18000000
+#define TEST_IMAGE_SIZE         0x1000
+#define TEST_LOG_SIZE           0x2000
+#define TEST_TEXT_SIZE          0x2000
+
+#define TEST_LOG_FILE           UTILITY_NAME ".log"
+#define TEST_IMAGE_FILE         UTILITY_NAME ".img"
+#define TEST_OUTPUT_FILE        UTILITY_NAME ".txt"
+
+//
+// Format strings of the test messages, copied into the image
+//
+typedef enum {
+  FormatNumbers,
+  FormatTypes,
+  FormatWidths,
+  FormatPrecision,
+  FormatNullString,
+  FormatSigns,
+  FormatTrailing,
+  FormatMax
+} TEST_FORMAT;
+
+STATIC CONST CHAR8  *mFormats[FormatMax] = {
+  "Hello %a, %d items, 0x%08X, %x, %5d|%-5d|%lx\n",
+  "Status %r %r, char %c, uni %s, guid %g, %%, %p\n",
+  "Width *: [%*d] [%-*a] %,d\n",
+  "Precision string %.*a is kept as text\n",
+  "Null string %a is kept as text\n",
+  "Signs %d %x %X %lu %ld %08d %-4x| %+d % d\n",
+  "Trailing %"
+};
+
+STATIC CONST GUID   mGuid = {0x12345678, 0x9abc, 0xdef0, {1, 2, 3, 4, 5, 6, 7, 8}};
+
+STATIC DEBUG_LOG_BUFFER_HEADER  *mLogBuffer;
+STATIC UINT8                    *mImage;
+STATIC UINTN                     mFormatOffset[FormatMax];
+STATIC CHAR8                     mExpected[TEST_TEXT_SIZE];
+STATIC UINTN                     mExpectedLength;
+STATIC UINTN                     mErrors;
+
+//
+// Host replacements of the BaseLib, BaseMemoryLib, SerialPortLib,
+// TimeStampLib and BootloaderCommonLib routines used by the libraries.
+//
+VOID *
+EFIAPI
+CopyMem (
+  OUT VOID       *DestinationBuffer,
+  IN CONST VOID  *SourceBuffer,
+  IN UINTN       Length
+  )
+{
+  return memmove (DestinationBuffer, SourceBuffer, Length);
+}
+
+VOID *
+EFIAPI
+SetMem (
+  OUT VOID  *Buffer,
+  IN UINTN  Length,
+  IN UINT8  Value
+  )
+{
+  return memset (Buffer, Value, Length);
+}
+
+VOID *
+EFIAPI
+SetMem16 (
+  OUT VOID   *Buffer,
+  IN UINTN   Length,
+  IN UINT16  Value
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Length / sizeof (UINT16); Index++) {
+    ((UINT16 *)Buffer)[Index] = Value;
+  }
+  return Buffer;
+}
+
+UINTN
+EFIAPI
+AsciiStrLen (
+  IN CONST CHAR8  *String
+  )
+{
+  return strlen (String);
+}
+
+UINTN
+EFIAPI
+StrLen (
+  IN CONST CHAR16  *String
+  )
+{
+  UINTN  Length;
+
+  for (Length = 0; String[Length] != 0; Length++) {
+  }
+  return Length;
+}
+
+UINT64
+EFIAPI
+DivU64x32Remainder (
+  IN  UINT64  Dividend,
+  IN  UINT32  Divisor,
+  OUT UINT32  *Remainder  OPTIONAL
+  )
+{
+  if (Remainder != NULL) {
+    *Remainder = (UINT32)(Dividend % Divisor);
+  }
+  return Dividend / Divisor;
+}
+
+UINT16
+EFIAPI
+ReadUnaligned16 (
+  IN CONST UINT16  *Buffer
+  )
+{
+  UINT16  Value;
+
+  memcpy (&Value, Buffer, sizeof (Value));
+  return Value;
+}
+
+UINT32
+EFIAPI
+ReadUnaligned32 (
+  IN CONST UINT32  *Buffer
+  )
+{
+  UINT32  Value;
+
+  memcpy (&Value, Buffer, sizeof (Value));
+  return Value;
+}
+
+UINTN
+EFIAPI
+SerialPortWrite (
+  IN UINT8  *Buffer,
+  IN UINTN  NumberOfBytes
+  )
+{
+  return NumberOfBytes;
+}
+
+RETURN_STATUS
+EFIAPI
+SerialPortGetControl (
+  OUT UINT32  *Control
+  )
+{
+  *Control = 0;
+  return RETURN_SUCCESS;
+}
+
+UINT64
+EFIAPI
+ReadTimeStamp (
+  VOID
+  )
+{
+  STATIC UINT64  TimeStamp = 1000000;
+
+  TimeStamp += 2500000;
+  return TimeStamp;
+}
+
+VOID *
+EFIAPI
+GetDebugLogBufferPtr (
+  VOID
+  )
+{
+  return mLogBuffer;
+}
+
+/**
+  Record a failed check.
+
+  @param[in]  Condition     The result of the check.
+  @param[in]  Message       The description of the check.
+**/
+STATIC
+VOID
+Check (
+  IN  BOOLEAN        Condition,
+  IN  CONST CHAR8   *Message
+  )
+{
+  if (!Condition) {
+    printf ("  FAILED: %s\n", Message);
+    mErrors++;
+  }
+}
+
+/**
+  Map a test image at a fixed address below 4GB.
+
+  @param[in]  Base          The address to map the image at.
+
+  @retval     The image, or NULL if the address is not available.
+**/
+STATIC
+UINT8 *
+MapImage (
+  IN  UINTN          Base
+  )
+{
+  VOID    *Image;
+
+  Image = mmap ((VOID *)Base, TEST_IMAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (Image == MAP_FAILED) {
+    return NULL;
+  }
+  if (Image != (VOID *)Base) {
+    munmap (Image, TEST_IMAGE_SIZE);
+    return NULL;
+  }
+  return (UINT8 *)Image;
+}
+
+/**
+  Append text to the expected decoder output, which has no carriage returns.
+
+  @param[in]  Text          The text as written to the log.
+**/
+STATIC
+VOID
+AppendExpected (
+  IN  CONST CHAR8   *Text
+  )
+{
+  for (; (*Text != '\0') && (mExpectedLength < sizeof (mExpected) - 1); Text++) {
+    if (*Text != '\r') {
+      mExpected[mExpectedLength++] = *Text;
+    }
+  }
+}
+
+/**
+  Log a test message the way the DEBUG output of the firmware does, and
+  append the message formatted by BasePrintLib to the expected text.
+
+  @param[in]  Format        The test format string.
+  @param[in]  ...           The arguments of the format string.
+**/
+STATIC
+VOID
+EFIAPI
+LogMessage (
+  IN  TEST_FORMAT    Format,
+  ...
+  )
+{
+  CONST CHAR8     *FormatString;
+  CHAR8            Buffer[0x100];
+  VA_LIST          Marker;
+  RETURN_STATUS    Status;
+
+  FormatString = (CONST CHAR8 *)(mImage + mFormatOffset[Format]);
+
+  VA_START (Marker, Format);
+  Status = DebugLogBufferTrace (FormatString, Marker);
+  VA_END (Marker);
+
+  VA_START (Marker, Format);
+  AsciiVSPrint (Buffer, sizeof (Buffer), FormatString, Marker);
+  VA_END (Marker);
+  if (RETURN_ERROR (Status)) {
+    DebugLogBufferWrite ((UINT8 *)Buffer, AsciiStrLen (Buffer));
+  }
+
+  Check ((Status == RETURN_SUCCESS) == ((Format != FormatPrecision) && (Format != FormatNullString)),
+    "the message is kept as a trace record unless a record can't hold it");
+  AppendExpected (Buffer);
+}
+
+/**
+  Log a text line that does not go through a trace record.
+
+  @param[in]  Text          The text line.
+**/
+STATIC
+VOID
+LogText (
+  IN  CONST CHAR8   *Text
+  )
+{
+  DebugLogBufferWrite ((UINT8 *)Text, AsciiStrLen (Text));
+  AppendExpected (Text);
+}
+
+/**
+  Log all the test messages with the format strings of the current image.
+**/
+STATIC
+VOID
+LogMessages (
+  VOID
+  )
+{
+  LogMessage (FormatNumbers, "world", -42, 0xABCD, 0x1f, 7, 8, 0x123456789ABCULL);
+  LogMessage (FormatTypes, (RETURN_STATUS)RETURN_NOT_FOUND, (RETURN_STATUS)RETURN_SUCCESS, (UINTN)'Z', L"wide",
+    &mGuid, (VOID *)(UINTN)0x1000);
+  LogMessage (FormatWidths, (UINTN)6, 33, (UINTN)4, "ab", 1234567);
+  LogMessage (FormatPrecision, (UINTN)2, "abc");
+  LogMessage (FormatNullString, (CHAR8 *)NULL);
+  LogMessage (FormatSigns, -1, -1, 0x10, 18446744073709551615ULL, -5LL, -7, 0xA, 3, 3);
+  LogMessage (FormatTrailing);
+  LogText ("\n");
+}
+
+/**
+  Write a buffer to a file.
+
+  @param[in]  FileName      The file name.
+  @param[in]  Buffer        The data to write.
+  @param[in]  Length        The length of the data.
+
+  @retval     TRUE          The file was written.
+**/
+STATIC
+BOOLEAN
+WriteFile (
+  IN  CONST CHAR8   *FileName,
+  IN  CONST VOID    *Buffer,
+  IN  UINTN          Length
+  )
+{
+  FILE     *File;
+  BOOLEAN   Written;
+
+  File = fopen (FileName, "wb");
+  if (File == NULL) {
+    return FALSE;
+  }
+  Written = fwrite (Buffer, 1, Length, File) == Length;
+  fclose (File);
+  return Written;
+}
+
+/**
+  Render the log with the decoder and check its output.
+
+  @param[in]  Decoder       Path of DecodeTraceLog.py.
+**/
+STATIC
+VOID
+DecodeAndVerify (
+  IN  CONST CHAR8   *Decoder
+  )
+{
+  CHAR8        Command[0x400];
+  CHAR8        Output[TEST_TEXT_SIZE];
+  CONST CHAR8 *Python;
+  FILE        *File;
+  UINTN        Length;
+  UINTN        Index;
+
+  Check (WriteFile (TEST_LOG_FILE, mLogBuffer, mLogBuffer->TotalLength), "the log is saved");
+
+  Python = getenv ("PYTHON_COMMAND");
+  if (Python == NULL) {
+    Python = "python3";
+  }
+  snprintf (Command, sizeof (Command), "%s %s %s -i %s@0x%x -o %s", Python, Decoder, TEST_LOG_FILE,
+    TEST_IMAGE_FILE, TEST_LINK_BASE, TEST_OUTPUT_FILE);
+  Check (system (Command) == 0, "the decoder runs");
+
+  Length = 0;
+  File = fopen (TEST_OUTPUT_FILE, "rb");
+  if (File != NULL) {
+    Length = fread (Output, 1, sizeof (Output), File);
+    fclose (File);
+  }
+
+  for (Index = 0; (Index < Length) && (Index < mExpectedLength); Index++) {
+    if (Output[Index] != mExpected[Index]) {
+      break;
+    }
+  }
+  if ((Index != Length) || (Index != mExpectedLength)) {
+    printf ("  Decoded log differs at offset %u:\n  expected: %.60s\n  decoded:  %.60s\n", (unsigned)Index,
+      mExpected + Index, (Index < Length) ? Output + Index : "");
+  }
+  Check ((Index == Length) && (Index == mExpectedLength), "the decoded log matches BasePrintLib");
+}
+
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  UINT8       *RuntimeImage;
+  UINTN        Offset;
+  UINTN        Index;
+  UINT32       UsedLength;
+
+  mImage       = MapImage (TEST_LINK_BASE);
+  RuntimeImage = MapImage (TEST_RUNTIME_BASE);
+  mLogBuffer   = calloc (1, TEST_LOG_SIZE);
+  if ((mImage == NULL) || (RuntimeImage == NULL) || (mLogBuffer == NULL)) {
+    printf ("Cannot map the test images!\n");
+    return 1;
+  }
+
+  mLogBuffer->Signature    = DEBUG_LOG_BUFFER_SIGNATURE;
+  mLogBuffer->HeaderLength = sizeof (DEBUG_LOG_BUFFER_HEADER);
+  mLogBuffer->UsedLength   = sizeof (DEBUG_LOG_BUFFER_HEADER);
+  mLogBuffer->TotalLength  = TEST_LOG_SIZE;
+
+  // Leave the start of the image blank, like the headers of a stage
+  Offset = 0x100;
+  for (Index = 0; Index < FormatMax; Index++) {
+    mFormatOffset[Index] = Offset;
+    Offset += AsciiSPrint ((CHAR8 *)mImage + Offset, TEST_IMAGE_SIZE - Offset, "%a", mFormats[Index]) + 1;
+  }
+  Check (WriteFile (TEST_IMAGE_FILE, mImage, TEST_IMAGE_SIZE), "the image is saved");
+
+  printf ("Messages at the link base\n");
+  LogMessages ();
+
+  printf ("Image base record\n");
+  UsedLength = mLogBuffer->UsedLength;
+  Check (DebugLogBufferTraceImageBase (TEST_LINK_BASE, TEST_LINK_BASE) == RETURN_SUCCESS, "no record is needed");
+  Check (mLogBuffer->UsedLength == UsedLength, "an image at its link base is not recorded");
+  Check (DebugLogBufferTraceImageBase (TEST_LINK_BASE, TEST_RUNTIME_BASE) == RETURN_SUCCESS, "the record is written");
+  Check (mLogBuffer->UsedLength == UsedLength + sizeof (DEBUG_LOG_TRACE_RECORD) + sizeof (UINT32), "the record holds the link base");
+
+  //
+  // Run from a copy of the image like a relocated stage, and clear the
+  // original so that only the rebased format strings can be found
+  //
+  printf ("Messages at the runtime base\n");
+  memcpy (RuntimeImage, mImage, TEST_IMAGE_SIZE);
+  memset (mImage, 0, TEST_IMAGE_SIZE);
+  mImage = RuntimeImage;
+  LogMessages ();
+
+  printf ("Decoding\n");
+  DecodeAndVerify ((argc > 1) ? argv[1] : DECODE_TRACE_LOG);
+
+  printf ("\n%s %s\n", UTILITY_NAME, (mErrors == 0) ? "PASSED" : "FAILED");
+  return (mErrors == 0) ? 0 : 1;
+}
@@ -0,0 +1,292 @@
+/** @file
+Zstandard compress and decompress utility
+
+The output is a single Zstandard frame with the content size in its header
+and no checksum, as expected by the ZstdDecompressLib of the bootloader.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Sdk/zstd.h"
+
+#define UTILITY_NAME "ZstdCompress"
+
+#define INTEL_COPYRIGHT \
+  "Copyright (c) 2026, Intel Corporation. All rights reserved."
+
+#define DEFAULT_LEVEL   19
+
+void PrintHelp (void)
+{
+  printf (   "\n" UTILITY_NAME " - " INTEL_COPYRIGHT "\n"
+             "\nUsage:  ZstdCompress -e|-d  [-l <level>]  -o <outputFile>  <inputFile>\n"
+             "  -e: encode file\n"
+             "  -d: decode file\n"
+             "  -l Level: compression level from 1 to %d, %d by default.\n"
+             "            The level does not change the decoder memory needs.\n"
+             "  -o FileName, --output FileName: specify the output filename\n",
+             ZSTD_maxCLevel (), DEFAULT_LEVEL
+             );
+}
+
+/*++
+
+Routine Description:
+
+  Compress a buffer into a single Zstandard frame.
+
+Arguments:
+
+  bufi      - input buffer
+  inpsz     - input size
+  level     - compression level
+  bufo      - receives the allocated output buffer
+
+Returns:
+
+  the output size, or -1 on failure
+
+--*/
+int
+CompressFrame (
+  const char  *bufi,
+  size_t       inpsz,
+  int          level,
+  char       **bufo
+  )
+{
+  ZSTD_CCtx  *cctx;
+  size_t      bufsz;
+  size_t      res;
+
+  bufsz = ZSTD_compressBound (inpsz);
+  *bufo = (char *)malloc (bufsz);
+  cctx  = ZSTD_createCCtx ();
+  if ((*bufo == NULL) || (cctx == NULL)) {
+    ZSTD_freeCCtx (cctx);
+    return -1;
+  }
+
+  //
+  // The decoder needs the content size, and the container is authenticated
+  // so the checksum would only cost flash space
+  //
+  ZSTD_CCtx_setParameter (cctx, ZSTD_c_compressionLevel, level);
+  ZSTD_CCtx_setParameter (cctx, ZSTD_c_contentSizeFlag, 1);
+  ZSTD_CCtx_setParameter (cctx, ZSTD_c_checksumFlag, 0);
+  ZSTD_CCtx_setParameter (cctx, ZSTD_c_dictIDFlag, 0);
+
+  res = ZSTD_compress2 (cctx, *bufo, bufsz, bufi, inpsz);
+  ZSTD_freeCCtx (cctx);
+  if (ZSTD_isError (res)) {
+    printf ("%s\n", ZSTD_getErrorName (res));
+    return -1;
+  }
+
+  return (int)res;
+}
+
+/*++
+
+Routine Description:
+
+  Decompress a single Zstandard frame.
+
+Arguments:
+
+  bufi      - input buffer
+  inpsz     - input size
+  bufo      - receives the allocated output buffer
+
+Returns:
+
+  the output size, or -1 on failure
+
+--*/
+int
+DecompressFrame (
+  const char  *bufi,
+  size_t       inpsz,
+  char       **bufo
+  )
+{
+  unsigned long long  sz;
+  size_t              res;
+
+  sz = ZSTD_getFrameContentSize (bufi, inpsz);
+  if ((sz == ZSTD_CONTENTSIZE_UNKNOWN) || (sz == ZSTD_CONTENTSIZE_ERROR) || (sz > 0x7FFFFFFF)) {
+    return -1;
+  }
+
+  *bufo = (char *)malloc (sz ? (size_t)sz : 1);
+  if (*bufo == NULL) {
+    return -1;
+  }
+
+  res = ZSTD_decompress (*bufo, (size_t)sz, bufi, inpsz);
+  if (ZSTD_isError (res) || (res != sz)) {
+    return -1;
+  }
+
+  return (int)res;
+}
+
+
+int
+main (
+  int    argc,
+  char  *argv[]
+  )
+/*++
+
+Routine Description:
+
+  Compress or Decompress the image using the Zstandard algorithm
+
+Arguments:
+
+  Argc            - standard C main() argument count
+
+  Argv            - standard C main() argument list
+
+Returns:
+
+  0             success
+  non-zero      otherwise
+
+--*/
+{
+  FILE  *fp;
+  int    i;
+  int    res;
+  int    decompress;
+  int    inpsz;
+  int    level;
+  char   *bufi;
+  char   *bufo;
+  char   *input;
+  char   *output;
+
+  bufi   = NULL;
+  bufo   = NULL;
+  output = NULL;
+  input  = NULL;
+  decompress = -1;
+  level  = DEFAULT_LEVEL;
+
+  if (argc < 5) {
+    PrintHelp ();
+    return -1;
+  }
+
+  for (i = 1; i < argc; i++) {
+    if (argv[i][0] == '-') {
+      if (!strcmp(argv[i], "-d")) {
+        decompress = 1;
+      } else if (!strcmp(argv[i], "-e")) {
+        decompress = 0;
+      } else if (!strcmp(argv[i], "-l")) {
+        if (i+1 < argc) {
+          level = atoi (argv[i+1]);
+          i++;
+        }
+      } else if (!strcmp(argv[i], "-o") || !strcmp(argv[i], "--output")) {
+        if (i+1 < argc) {
+          output =  argv[i+1];
+          i++;
+        }
+      } else {
+        printf("Unknown option '%s' !\n", argv[i]);
+        return -1;
+      }
+    } else {
+      if (input == NULL) {
+        input =  argv[i];
+      }
+    }
+  }
+
+  if (input == NULL) {
+    printf("Input file name is required!\n");
+    return -1;
+  }
+
+  if (output == NULL) {
+    printf("Output file name is required!\n");
+    return -2;
+  }
+
+  if (decompress < 0) {
+    printf("Operation is required!\n");
+    return -3;
+  }
+
+  if ((level < 1) || (level > ZSTD_maxCLevel ())) {
+    printf("Invalid compression level!\n");
+    return -5;
+  }
+
+  fp = fopen (input, "rb");
+  if (!fp) {
+    printf("Cannot open file '%s' !\n", input);
+    return -4;
+  }
+
+  fseek(fp, 0L, SEEK_END);
+  inpsz = ftell(fp);
+  fseek(fp, 0L, SEEK_SET);
+
+  bufi = (char *)malloc(inpsz ? inpsz : 1);
+  if (bufi) {
+    if (fread(bufi, 1, inpsz, fp) != (size_t)inpsz) {
+      free (bufi);
+      bufi = NULL;
+    }
+  }
+  fclose(fp);
+
+  if (bufi == NULL) {
+    res = -1;
+  } else if (decompress == 1) {
+    res = DecompressFrame (bufi, inpsz, &bufo);
+  } else {
+    res = CompressFrame (bufi, inpsz, level, &bufo);
+  }
+
+  if (res >= 0) {
+    fp = fopen (output, "wb");
+    if (!fp) {
+      printf("Cannot create file '%s' !\n", output);
+      res = -1;
+    } else {
+      fwrite(bufo, res, 1, fp);
+      fclose(fp);
+    }
+  }
+
+  if (bufi) {
+    free(bufi);
+  }
+
+  if (bufo) {
+    free(bufo);
+  }
+
+  if (res < 0) {
+    printf("Failed!\n");
+    res = -1;
+  } else {
+    printf("OK!\n");
+    res = 0;
+  }
+
+  return res;
+}
@@ -1,7 +1,7 @@
 /** @file
   This file defines the hob structure for the AP task.
 
-  Copyright (c) 2021, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2021 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -65,4 +65,24 @@ typedef struct {
 
 #pragma pack()
 
+///
+/// An independent job run by ScheduleCpuJobs() on an idle AP or on the BSP.
+/// Func is called with Argument and its return value is stored in Result,
+/// which usually carries the EFI_STATUS of the job.
+///
+typedef struct {
+  // Job function and its argument
+  CPU_TASK_FUNC   Func;
+  UINT64          Argument;
+
+  // The return value of the job function
+  UINT64          Result;
+
+  // The index of the CPU that ran the job, 0 for the BSP
+  UINT32          CpuIndex;
+
+  // Set to TRUE once Result is valid
+  volatile UINT32 Done;
+} CPU_JOB;
+
 #endif
@@ -1,6 +1,6 @@
 /** @file
 
-  Copyright (c) 2017 - 2023, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2017 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -14,6 +14,7 @@
 #include <Guid/LoaderPlatformDataGuid.h>
 #include <Guid/DeviceTableHobGuid.h>
 #include <Guid/KeyHashGuid.h>
+#include <Guid/MpCpuTaskInfoHob.h>
 #include <Library/BaseLib.h>
 #include <Library/CryptoLib.h>
 
@@ -643,4 +644,97 @@ MatchHashInStore (
   IN       UINT8           *HashData
   );
 
+/**
+  Run a set of independent jobs in parallel and wait for all of them.
+
+  Each pending job is handed to the next AP found idle in SysCpuTask. When no
+  AP is idle the calling processor runs the next pending job itself, so the
+  call also works, serially, without any AP. It returns once every job has
+  completed. Idle APs are claimed atomically, so a job running on an AP may
+  schedule jobs of its own.
+
+  Jobs run concurrently, so a job function must not allocate memory, print
+  debug messages or call any other non-reentrant service. AP stacks are small,
+  so large local buffers must be avoided as well.
+
+  @param[in]      SysCpuTask  The CPU task table of the APs waiting for tasks,
+                              or NULL to run all jobs on the BSP.
+  @param[in, out] Jobs        The jobs to run. Result, CpuIndex and Done are
+                              updated for every job.
+  @param[in]      JobCount    The number of jobs.
+
+  @retval EFI_INVALID_PARAMETER   Jobs is NULL or a job has no function.
+  @retval EFI_SUCCESS             All jobs have completed. Refer to the Result
+                                  of each job for its own status.
+
+**/
+EFI_STATUS
+EFIAPI
+ScheduleCpuJobs (
+  IN      SYS_CPU_TASK  *SysCpuTask  OPTIONAL,
+  IN OUT  CPU_JOB       *Jobs,
+  IN      UINT32         JobCount
+  );
+
+/**
+  Start a job on an idle AP and return without waiting for it.
+
+  When no AP is idle, or SysCpuTask is NULL, the calling processor runs the job
+  before returning. Either way WaitForCpuJob() returns once the job completed,
+  so the caller can overlap its own work, such as device reads, with the job.
+  The same restrictions as for ScheduleCpuJobs() apply to the job function.
+
+  @param[in]      SysCpuTask  The CPU task table of the APs waiting for tasks,
+                              or NULL to run the job on the calling processor.
+  @param[in, out] Job         The job to start. Result, CpuIndex and Done are
+                              updated when it completes.
+
+  @retval EFI_INVALID_PARAMETER   Job is NULL or has no function.
+  @retval EFI_SUCCESS             The job was started or has completed.
+
+**/
+EFI_STATUS
+EFIAPI
+StartCpuJob (
+  IN      SYS_CPU_TASK  *SysCpuTask  OPTIONAL,
+  IN OUT  CPU_JOB       *Job
+  );
+
+/**
+  Wait for a job started by StartCpuJob() to complete.
+
+  @param[in] Job  The job to wait for.
+
+  @retval  The return value of the job function.
+**/
+UINT64
+EFIAPI
+WaitForCpuJob (
+  IN  CPU_JOB       *Job
+  );
+
+/**
+  Set the CPU task table used by library code that schedules CPU jobs on its
+  own, such as decompression.
+
+  @param[in] SysCpuTask  The CPU task table of the APs waiting for tasks, or
+                         NULL when the APs are not available anymore.
+**/
+VOID
+EFIAPI
+SetDefaultCpuJobTask (
+  IN  SYS_CPU_TASK  *SysCpuTask  OPTIONAL
+  );
+
+/**
+  Get the CPU task table set by SetDefaultCpuJobTask().
+
+  @retval  The CPU task table, or NULL if the APs are not available.
+**/
+SYS_CPU_TASK *
+EFIAPI
+GetDefaultCpuJobTask (
+  VOID
+  );
+
 #endif
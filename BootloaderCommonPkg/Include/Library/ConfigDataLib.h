@@ -1,7 +1,7 @@
 /** @file
   Config data library instance for data access.
 
-  Copyright (c) 2017 - 2020, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2017 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -113,6 +113,33 @@ typedef struct {
 
 } ARRAY_CFG_HDR;
 
+#define CDATA_INDEX_SIGNATURE   SIGNATURE_32 ('C', 'F', 'G', 'I')
+
+//
+// Index entry layout: tag in bits [31:20], DWORD offset of the item in the
+// configuration data blob in bits [19:0]. Entries are sorted, so the items
+// of a tag are found in blob order with a binary search.
+//
+#define CDATA_INDEX_TAG_SHIFT   20
+#define CDATA_INDEX_OFFSET_MASK 0xFFFFF
+
+typedef struct {
+  UINT32  Signature;
+  //
+  // CDATA_BLOB UsedLength and InternalDataOffset the index was built for.
+  // The index is ignored once they do not match the blob anymore.
+  //
+  UINT32  UsedLength;
+  UINT16  InternalDataOffset;
+  UINT16  Reserved;
+  //
+  // Number of lookups served by the index
+  //
+  UINT32  LookupCount;
+  UINT32  Count;
+  UINT32  Entry[0];
+} CDATA_INDEX;
+
 
 /**
   Load the configuration data blob from media into destination buffer.
@@ -241,6 +268,37 @@ BuildConfigData (
   IN  UINT32      Length
   );
 
+/**
+  Build the tag index of the configuration data blob.
+
+  The index is kept in the loader library data, so that it is migrated with
+  the blob and handed over to the payload. All lookup APIs use it until the
+  blob is modified.
+
+  @retval EFI_SUCCESS           The index was built.
+  @retval EFI_NOT_FOUND         There is no configuration data blob.
+  @retval EFI_UNSUPPORTED       The blob is too large for the index.
+  @retval EFI_OUT_OF_RESOURCES  The index could not be allocated.
+
+**/
+EFI_STATUS
+EFIAPI
+BuildConfigDataIndex (
+  VOID
+  );
+
+/**
+  Get the tag index of the configuration data blob.
+
+  @retval   The index, or NULL if none was built for the current blob.
+
+**/
+CDATA_INDEX *
+EFIAPI
+GetConfigDataIndex (
+  VOID
+  );
+
 /**
   Get a full CFGDATA set length.
 
@@ -1,7 +1,7 @@
 /** @file
   Header file for container library implementation.
 
-  Copyright (c) 2019, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2019 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -10,6 +10,7 @@
 
 #include <Library/PcdLib.h>
 #include <Library/CryptoLib.h>
+#include <Guid/MpCpuTaskInfoHob.h>
 
 
 #define CONTAINER_LIST_SIGNATURE SIGNATURE_32('C','T','N', 'L')
@@ -59,6 +60,13 @@ typedef struct {
 
 typedef VOID (*LOAD_COMPONENT_CALLBACK) (UINT32 ProgressId, COMPONENT_CALLBACK_INFO *CbInfo);
 
+typedef struct {
+  UINT32           ComponentName;
+  VOID            *Buffer;
+  UINT32           Length;
+  EFI_STATUS       Status;
+} COMPONENT_LOAD_REQUEST;
+
 typedef struct {
   UINT32           Signature;
   UINT32           HeaderCache;
@@ -125,6 +133,40 @@ LoadComponentWithCallback (
   IN     LOAD_COMPONENT_CALLBACK  LoadComponentCallback
   );
 
+/**
+  Load a list of components from a container or flash map to memory and call
+  callback function at predefined point.
+
+  Copying, hashing and decompression of the components are spread over the
+  BSP and the APs waiting for tasks in SysCpuTask.
+
+  @param[in]     ContainerSig    Container signature or component type.
+  @param[in,out] Request         Components to load. On input Buffer and Length
+                                 optionally give the buffer to load into. On
+                                 output Status holds the result of each
+                                 component, and Buffer and Length the loaded
+                                 component when it succeeded.
+  @param[in]     RequestCount    Number of components to load.
+  @param[in]     LoadComponentCallback  Callback function pointer.
+  @param[in]     SysCpuTask      The CPU task table of the APs waiting for
+                                 tasks, or NULL to load on the BSP only.
+
+  @retval EFI_INVALID_PARAMETER    Request is NULL.
+  @retval EFI_OUT_OF_RESOURCES     Load context allocation failed.
+  @retval EFI_SUCCESS              All components were loaded successfully.
+  @retval Others                   Status of the first component that failed.
+
+**/
+EFI_STATUS
+EFIAPI
+LoadComponentList (
+  IN     UINT32                   ContainerSig,
+  IN OUT COMPONENT_LOAD_REQUEST  *Request,
+  IN     UINT32                   RequestCount,
+  IN     LOAD_COMPONENT_CALLBACK  LoadComponentCallback,
+  IN     SYS_CPU_TASK            *SysCpuTask  OPTIONAL
+  );
+
 /**
   Locate a component region information from a container or flash map.
 
@@ -261,4 +303,86 @@ EFI_STATUS
 UnregisterContainer (
   IN  UINT32   Signature
   );
+
+/**
+  Start calculating the digests of a container while it is read into memory.
+
+  The container is expected to be read sequentially into ContainerBase. Each
+  time more data is available, ContainerDigestUpdate() hashes it. Once all
+  data is read, ContainerDigestFinish() makes the digests available to
+  RegisterContainer() and LoadComponent(), which then do not need to hash the
+  data again.
+
+  @param[in]  ContainerBase  Memory buffer the container is read into.
+  @param[in]  ContainerSize  Size of the container.
+  @param[out] Stream         Pointer to receive the digest stream handle.
+
+  @retval EFI_INVALID_PARAMETER    A parameter is NULL.
+  @retval EFI_UNSUPPORTED          Verified boot is disabled.
+  @retval EFI_OUT_OF_RESOURCES     The digest stream allocation failed.
+  @retval EFI_SUCCESS              The digest stream is ready.
+
+**/
+EFI_STATUS
+EFIAPI
+ContainerDigestStart (
+  IN  VOID      *ContainerBase,
+  IN  UINT32     ContainerSize,
+  OUT VOID     **Stream
+  );
+
+/**
+  Hash the container data that became available since the previous call.
+
+  It neither allocates memory nor prints debug messages, so it can run as a
+  CPU job on an AP while the next part of the container is being read.
+
+  @param[in] Stream      The digest stream handle.
+  @param[in] Available   Number of bytes of the container available so far.
+
+**/
+VOID
+EFIAPI
+ContainerDigestUpdate (
+  IN  VOID      *Stream,
+  IN  UINT32     Available
+  );
+
+/**
+  Complete the digests of a container read into memory.
+
+  When Publish is TRUE the digests of the completely hashed ranges replace the
+  ones of a previous container, and are used to authenticate this container
+  until it is unregistered or discarded. Each digest is used only once. A
+  digest that does not authenticate its range never fails the authentication,
+  the data is hashed again instead.
+
+  @param[in] Stream      The digest stream handle.
+  @param[in] Publish     TRUE to make the digests available, FALSE to discard
+                         them, such as when reading the container failed.
+
+**/
+VOID
+EFIAPI
+ContainerDigestFinish (
+  IN  VOID      *Stream,
+  IN  BOOLEAN    Publish
+  );
+
+/**
+  Discard the digests calculated while a container was read into memory.
+
+  It must be called before the memory of a container read through
+  ContainerDigestStart() is released or reused, so that its digests never
+  authenticate other data.
+
+  @param[in] ContainerBase  Memory buffer the container was read into, or
+                            NULL to discard the digests of any container.
+
+**/
+VOID
+EFIAPI
+ContainerDigestDiscard (
+  IN  VOID      *ContainerBase
+  );
 #endif
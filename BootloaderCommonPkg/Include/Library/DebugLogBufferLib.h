@@ -1,7 +1,7 @@
 /** @file
   Log buffer library
 
-  Copyright (c) 2018, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2018 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -12,6 +12,20 @@
 #define  DEBUG_LOG_BUFFER_SIGNATURE         SIGNATURE_32 ('D', 'L', 'O', 'G')
 
 #define  DEBUG_LOG_BUFFER_ATTRIBUTE_FULL    BIT0
+//
+// Serial output is deferred. The last PendingLength bytes of the log have
+// not been written to the serial port yet.
+//
+#define  DEBUG_LOG_BUFFER_ATTRIBUTE_DEFER   BIT1
+//
+// The log contains binary trace records besides the text.
+//
+#define  DEBUG_LOG_BUFFER_ATTRIBUTE_TRACE   BIT2
+
+//
+// A binary trace record starts with this byte, which the text log never has.
+//
+#define  DEBUG_LOG_TRACE_MARKER             0xFF
 
 typedef struct {
   UINT32  Signature;
@@ -20,9 +34,42 @@ typedef struct {
   UINT8   Reserved[2];
   UINT32  UsedLength;
   UINT32  TotalLength;
+  UINT32  PendingLength;
   UINT8   Buffer[0];
 } DEBUG_LOG_BUFFER_HEADER;
 
+//
+// Types of the binary trace records
+//
+#define  DEBUG_LOG_TRACE_TYPE_MESSAGE       0
+#define  DEBUG_LOG_TRACE_TYPE_IMAGE_BASE    1
+
+//
+// Binary trace record of a debug message. The message is rendered on the host
+// from the format string in the firmware image. Args holds the arguments in the
+// order of the format string:
+//   '*' width or precision      UINT32
+//   %d %u %x %X                 UINT32, or UINT64 with the 'l' or 'L' flag
+//   %p %r                       UINT64
+//   %c                          UINT16
+//   %a %s %S                    UINT8 length followed by the ASCII characters
+//   %g                          GUID
+//
+// An image base record tells the host that a stage image runs at another
+// address than the one it is linked at. Format holds the runtime base and Args
+// the UINT32 link base of the image.
+//
+#pragma pack(1)
+typedef struct {
+  UINT8   Marker;
+  UINT8   Type;         ///< DEBUG_LOG_TRACE_TYPE_*
+  UINT16  Length;       ///< Length of the record including the arguments
+  UINT32  Format;       ///< Address of the format string, or the image runtime base
+  UINT64  TimeStamp;
+  UINT8   Args[0];
+} DEBUG_LOG_TRACE_RECORD;
+#pragma pack()
+
 /**
   Write data from buffer to console buffer.
 
@@ -49,5 +96,83 @@ DebugLogBufferWrite (
   IN UINTN      NumberOfBytes
   );
 
+/**
+  Write a debug message to the log buffer as a binary trace record.
+
+  The message is not formatted. The record keeps the format string address,
+  the timestamp and the arguments, and the message is rendered on the host.
+
+  @param  Format           Format string of the debug message.
+  @param  Marker           Variable argument list of the format string.
+
+  @retval RETURN_SUCCESS       The record was written to the log buffer.
+  @retval RETURN_NOT_READY     There is no log buffer.
+  @retval RETURN_UNSUPPORTED   The message can't be kept in a binary record.
+
+**/
+RETURN_STATUS
+EFIAPI
+DebugLogBufferTrace (
+  IN CONST CHAR8  *Format,
+  IN VA_LIST       Marker
+  );
+
+/**
+  Write the runtime base of a relocated stage image to the log buffer, so that
+  the host can find the format strings of the binary trace records the image
+  writes from there.
+
+  Nothing is written if the binary trace log is disabled, or if the image runs
+  at its link base.
+
+  @param  LinkBase         The base address the image is linked at.
+  @param  RuntimeBase      The base address the image runs at.
+
+  @retval RETURN_SUCCESS       The record was written, or no record is needed.
+  @retval RETURN_NOT_READY     There is no log buffer.
+
+**/
+RETURN_STATUS
+EFIAPI
+DebugLogBufferTraceImageBase (
+  IN UINT32       LinkBase,
+  IN UINT32       RuntimeBase
+  );
+
+/**
+  Start or stop deferring the serial output of the debug log.
+
+  While deferred, the log written by DebugLogBufferWrite () goes to the serial
+  port only through DebugLogBufferDrain (). Stopping writes all the pending log
+  to the serial port first.
+
+  @param  Defer            TRUE to defer the serial output, FALSE to stop.
+
+  @retval TRUE             The serial output was deferred before the call.
+  @retval FALSE            The serial output was not deferred before the call.
+
+**/
+BOOLEAN
+EFIAPI
+DebugLogBufferDefer (
+  IN BOOLEAN    Defer
+  );
+
+/**
+  Write the pending log to the serial port.
+
+  @param  Wait             TRUE to write all the pending log, FALSE to write
+                           only what the UART can take without waiting.
+
+  @retval RETURN_SUCCESS       The pending log was written as requested.
+  @retval RETURN_NOT_STARTED   The serial output is not deferred.
+
+**/
+RETURN_STATUS
+EFIAPI
+DebugLogBufferDrain (
+  IN BOOLEAN    Wait
+  );
+
 #endif
 
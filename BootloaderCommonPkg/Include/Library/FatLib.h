@@ -1,7 +1,7 @@
 /** @file
   Function prototypes for FAT library
 
-Copyright (c) 2017 - 2020, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2017 - 2026, Intel Corporation. All rights reserved.<BR>
 
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -116,6 +116,30 @@ FatFsReadFile (
   OUT UINTN                                      *FileSize
   );
 
+/**
+  Read the next part of a file by opened file handle.
+
+  @param[in]     FsHandle         file system handle.
+  @param[in]     FileHandle       file handle
+  @param[out]    Buffer           Buffer to receive the data.
+  @param[in,out] Size             On input, the number of bytes to read. On
+                                  output, the number of bytes read, which is
+                                  smaller at the end of the file.
+
+  @retval EFI_SUCCESS             The data was read correctly.
+  @retval EFI_INVALID_PARAMETER   Parameter is not valid.
+  @retval EFI_DEVICE_ERROR        A device error occurred.
+
+**/
+EFI_STATUS
+EFIAPI
+FatFsReadFileChunk (
+  IN     EFI_HANDLE                               FsHandle,
+  IN     EFI_HANDLE                               FileHandle,
+  OUT    VOID                                    *Buffer,
+  IN OUT UINTN                                   *Size
+  );
+
 /**
   Close a file by opened file handle
 
@@ -148,4 +172,21 @@ FatFsListDir (
   IN  CHAR16                                     *DirFilePath
   );
 
+/**
+  Get block cache statistics of a FAT file system
+
+  @param[in]     FsHandle         file system handle.
+  @param[out]    CacheInfo        block cache statistics.
+
+  @retval EFI_SUCCESS             the statistics were returned
+  @retval EFI_INVALID_PARAMETER   Parameter is not valid.
+
+**/
+EFI_STATUS
+EFIAPI
+FatFsGetCacheInfo (
+  IN  EFI_HANDLE                                  FsHandle,
+  OUT FS_CACHE_INFO                              *CacheInfo
+  );
+
 #endif // _FAT_LIB_H_
@@ -1,7 +1,7 @@
 /** @file
   File system level API library interface prototypes
 
-Copyright (c) 2017 - 2020, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2017 - 2026, Intel Corporation. All rights reserved.<BR>
 
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -112,6 +112,33 @@ EFI_STATUS
   OUT UINTN                                      *FileSize
   );
 
+/**
+  Read the next part of a file by opened file handle.
+
+  The data is read from the current position of the file, which is moved
+  past the data read.
+
+  @param[in]     FsHandle         file system handle.
+  @param[in]     FileHandle       file handle
+  @param[out]    Buffer           Buffer to receive the data.
+  @param[in,out] Size             On input, the number of bytes to read. On
+                                  output, the number of bytes read, which is
+                                  smaller at the end of the file.
+
+  @retval EFI_SUCCESS             The data was read correctly.
+  @retval EFI_INVALID_PARAMETER   Parameter is not valid.
+  @retval EFI_DEVICE_ERROR        A device error occurred.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *FS_READ_FILE_CHUNK) (
+  IN     EFI_HANDLE                               FsHandle,
+  IN     EFI_HANDLE                               FileHandle,
+  OUT    VOID                                    *Buffer,
+  IN OUT UINTN                                   *Size
+  );
+
 /**
   Close a file by opened file handle
 
@@ -145,6 +172,33 @@ EFI_STATUS
   IN  CHAR16                                     *DirFilePath
   );
 
+typedef struct {
+  UINT32                                  BlockCount;
+  UINT32                                  BlockSize;
+  UINT32                                  ReadAheadBlocks;
+  UINT64                                  Hits;
+  UINT64                                  Misses;
+  UINT64                                  PrefetchedBlocks;
+} FS_CACHE_INFO;
+
+/**
+  Get block cache statistics of a file system
+
+  @param[in]     FsHandle         file system handle.
+  @param[out]    CacheInfo        block cache statistics.
+
+  @retval EFI_SUCCESS             the statistics were returned
+  @retval EFI_UNSUPPORTED         this api is not supported
+  @retval Others                  an error occurs
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *FS_GET_CACHE_INFO) (
+  IN  EFI_HANDLE                                  FsHandle,
+  OUT FS_CACHE_INFO                              *CacheInfo
+  );
+
 /**
   Get SW partition no. of detected file system
 
@@ -275,6 +329,33 @@ ReadFile (
   OUT UINTN                                      *FileSize
   );
 
+/**
+  Read the next part of a file by opened file handle.
+
+  The data is read from the current position of the file, which is moved
+  past the data read. It allows a caller to process the file while it is
+  being read.
+
+  @param[in]     FileHandle       file handle
+  @param[out]    Buffer           Buffer to receive the data.
+  @param[in,out] Size             On input, the number of bytes to read. On
+                                  output, the number of bytes read, which is
+                                  smaller at the end of the file.
+
+  @retval EFI_SUCCESS             The data was read correctly.
+  @retval EFI_INVALID_PARAMETER   Parameter is not valid.
+  @retval EFI_UNSUPPORTED         The file system does not support it.
+  @retval EFI_DEVICE_ERROR        A device error occurred.
+
+**/
+EFI_STATUS
+EFIAPI
+ReadFileChunk (
+  IN     EFI_HANDLE                               FileHandle,
+  OUT    VOID                                    *Buffer,
+  IN OUT UINTN                                   *Size
+  );
+
 /**
   Close a file by opened file handle
 
@@ -307,14 +388,34 @@ ListDir (
   IN  CHAR16                                     *DirFilePath
   );
 
+/**
+  Get block cache statistics of a file system
+
+  @param[in]     FsHandle         file system handle.
+  @param[out]    CacheInfo        block cache statistics.
+
+  @retval EFI_SUCCESS             the statistics were returned
+  @retval EFI_UNSUPPORTED         this api is not supported
+  @retval Others                  an error occurs
+
+**/
+EFI_STATUS
+EFIAPI
+GetFileSystemCacheInfo (
+  IN  EFI_HANDLE                                  FsHandle,
+  OUT FS_CACHE_INFO                              *CacheInfo
+  );
+
 typedef struct {
   FS_INIT_FILE_SYSTEM                 InitFileSystem;
   FS_CLOSE_FILE_SYSTEM                CloseFileSystem;
   FS_OPEN_FILE                        OpenFile;
   FS_GET_FILE_SIZE                    GetFileSize;
   FS_READ_FILE                        ReadFile;
+  FS_READ_FILE_CHUNK                  ReadFileChunk;
   FS_CLOSE_FILE                       CloseFile;
   FS_LIST_DIR                         ListDir;
+  FS_GET_CACHE_INFO                   GetCacheInfo;
 } FILE_SYSTEM_FUNC;
 
 #endif // _FAT_PEIM_H_
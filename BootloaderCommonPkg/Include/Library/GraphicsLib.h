@@ -1,7 +1,7 @@
 /** @file
   Basic graphics rendering support
 
-  Copyright (c) 2017 - 2019, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2017 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -55,6 +55,23 @@ typedef struct {
 extern EFI_NARROW_GLYPH gUsStdNarrowGlyphData[];
 extern UINT32 mNarrowFontSize;
 
+#define GLYPH_ATLAS_NUM  4
+
+//
+// Largest console shadow buffer, bigger consoles draw to the frame buffer directly
+//
+#define SHADOW_BUFFER_MAX_SIZE  SIZE_8MB
+
+//
+// Glyph rows expanded into pixels for one color pair, indexed by the row bitmap
+//
+typedef struct {
+  BOOLEAN                       Valid;
+  UINT32                        Foreground;
+  UINT32                        Background;
+  UINT32                        Pixels[256][GLYPH_WIDTH];
+} GLYPH_ATLAS;
+
 typedef struct {
   EFI_PEI_GRAPHICS_INFO_HOB     *GfxInfoHob;
   CHAR8                         *TextDisplayBuf;
@@ -70,6 +87,13 @@ typedef struct {
   UINTN                         CursorY;
   EFI_GRAPHICS_OUTPUT_BLT_PIXEL ForegroundColor;
   EFI_GRAPHICS_OUTPUT_BLT_PIXEL BackgroundColor;
+  UINT32                        *ShadowBuf;
+  UINTN                         ShadowTop;
+  UINT8                         *DirtyBuf;
+  GLYPH_ATLAS                   *GlyphAtlas;
+  UINTN                         NextAtlas;
+  BOOLEAN                       ShadowInSync;
+  BOOLEAN                       Dirty;
 } FRAME_BUFFER_CONSOLE;
 
 
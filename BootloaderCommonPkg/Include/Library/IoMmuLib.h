@@ -67,6 +67,27 @@ typedef struct {
   EFI_PHYSICAL_ADDRESS              DeviceAddress;
 } MAP_INFO;
 
+/**
+  Check if a bus master can access system memory directly.
+
+  When this returns TRUE, Map() returns the host address itself as the device
+  address, so the data is neither copied through a bounce buffer nor limited by
+  the DMA buffer size.
+
+  @param  HostAddress           The system memory address to check, or NULL to check if
+                                direct DMA is possible at all.
+  @param  NumberOfBytes         The number of bytes to check. Ignored when HostAddress is NULL.
+
+  @retval TRUE                  The range can be used for DMA directly.
+  @retval FALSE                 The range must be bounced through the DMA buffer.
+
+**/
+BOOLEAN
+IoMmuIsDirectDma (
+  IN  VOID                  *HostAddress,
+  IN  UINTN                 NumberOfBytes
+  );
+
 /**
   Provides the controller-specific addresses required to access system memory from a
   DMA bus master.
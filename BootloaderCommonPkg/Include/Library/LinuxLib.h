@@ -204,7 +204,13 @@ IsBzImage (
 /**
   Load linux kernel image to specified address and setup boot parameters.
 
+  A relocatable kernel is booted from where it was loaded if its memory needs
+  are met. Other kernels are copied to LINUX_KERNEL_BASE.
+
   @param[in]  KernelBase     Memory address of an kernel image.
+  @param[in]  KernelBufLen   Size of the buffer holding the kernel image,
+                             which the kernel may use while it decompresses
+                             itself. 0 always copies the kernel.
   @param[in]  InitRdBase     Memory address of an InitRd image.
   @param[in]  InitRdLen      InitRd image size.
   @param[in]  CmdLineBase    Memory address of command line buffer.
@@ -218,6 +224,7 @@ EFI_STATUS
 EFIAPI
 LoadBzImage (
   IN  CONST VOID                  *KernelBase,
+  IN      UINT32                   KernelBufLen,
   IN  CONST VOID                  *InitRdBase,
   IN      UINT32                   InitRdLen,
   IN  CONST VOID                  *CmdLineBase,
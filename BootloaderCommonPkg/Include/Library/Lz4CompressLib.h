@@ -16,6 +16,23 @@
 
 
 #define  LZ4_SIGNATURE    SIGNATURE_32 ('L', 'Z', '4', ' ')
+#define  LZ4B_SIGNATURE   SIGNATURE_32 ('L', 'Z', '4', 'B')
+
+///
+/// Header of the block-parallel LZ4 format (LZ4B).
+///
+/// The original data is split into BlockSize byte blocks, the last one may be
+/// shorter, and each block is compressed independently so that the blocks can
+/// be decompressed in any order. Block N is stored from BlockOffset[N] up to
+/// BlockOffset[N + 1], both relative to the start of this header, so the
+/// offset table has BlockCount + 1 entries.
+///
+typedef struct {
+  UINT32           Size;
+  UINT32           BlockSize;
+  UINT32           BlockCount;
+  UINT32           BlockOffset[0];
+} LZ4B_HEADER;
 
 /**
   Given a LZ4 compressed source buffer, this function retrieves the size of
@@ -87,6 +104,78 @@ Lz4Decompress (
   IN OUT VOID    *Scratch
   );
 
+/**
+  Given a LZ4B compressed source buffer, this function validates the block
+  table and retrieves the size of the uncompressed buffer.
+
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  DestinationSize A pointer to the size, in bytes, of the uncompressed buffer.
+                          This is an optional parameter that may be NULL.
+  @param  ScratchSize     A pointer to the size, in bytes, of the scratch buffer.
+                          This is an optional parameter that may be NULL.
+
+  @retval  RETURN_SUCCESS            The sizes were returned.
+  @retval  RETURN_INVALID_PARAMETER  The block table is corrupted.
+
+**/
+RETURN_STATUS
+EFIAPI
+Lz4BlockDecompressGetInfo (
+  IN  CONST VOID  *Source,
+  IN  UINT32       SourceSize,
+  OUT UINT32      *DestinationSize,
+  OUT UINT32      *ScratchSize
+  );
+
+/**
+  Decompresses a range of blocks of a LZ4B compressed source buffer.
+
+  The blocks are independent, so several ranges of the same buffer can be
+  decompressed concurrently. The block table must have been validated with
+  Lz4BlockDecompressGetInfo() first.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer of the whole decompressed data.
+  @param  FirstBlock  Index of the first block to decompress.
+  @param  BlockCount  Number of blocks to decompress.
+
+  @retval  RETURN_SUCCESS            The blocks were decompressed successfully.
+  @retval  RETURN_INVALID_PARAMETER  The source buffer is corrupted.
+**/
+RETURN_STATUS
+EFIAPI
+Lz4BlockDecompressRange (
+  IN CONST VOID  *Source,
+  IN UINTN        SourceSize,
+  IN OUT VOID    *Destination,
+  IN UINT32       FirstBlock,
+  IN UINT32       BlockCount
+  );
+
+/**
+  Decompresses a LZ4B compressed source buffer, one block after the other.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data
+  @param  Scratch     Not used, may be NULL.
+
+  @retval  RETURN_SUCCESS Decompression completed successfully, and
+                          the uncompressed buffer is returned in Destination.
+  @retval  RETURN_INVALID_PARAMETER
+                          The source buffer specified by Source is corrupted
+                          (not in a valid compressed format).
+**/
+RETURN_STATUS
+EFIAPI
+Lz4BlockDecompress (
+  IN CONST VOID  *Source,
+  IN UINTN        SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  );
 
 /**
   Given a LZ4 source buffer, this function retrieves the required
@@ -11,6 +11,20 @@
 #include <BlockDevice.h>
 #include <Guid/OsBootOptionGuid.h>
 
+//
+// Block cache statistics
+//
+typedef struct {
+  UINT32   BlockCount;
+  UINT32   BlockSize;
+  UINT32   ReadAheadBlocks;
+  UINT32   MaxReadAheadBlocks;
+  UINT64   Hits;
+  UINT64   Misses;
+  UINT64   PrefetchedBlocks;
+  UINT64   BypassedBlocks;
+} MEDIA_CACHE_INFO;
+
 /**
   Get current media interface type.
 
@@ -211,5 +225,33 @@ MediaTuning (
   IN UINTN                     MediaHcPciBase
   );
 
+/**
+  Get the block cache statistics.
+
+  @param[out] CacheInfo     The block cache statistics.
+
+  @retval EFI_SUCCESS             The statistics were returned.
+  @retval EFI_INVALID_PARAMETER   CacheInfo is NULL.
+  @retval EFI_UNSUPPORTED         The block cache is disabled.
+
+**/
+EFI_STATUS
+EFIAPI
+MediaGetCacheInfo (
+  OUT MEDIA_CACHE_INFO              *CacheInfo
+  );
+
+/**
+  Drop all the blocks held in the block cache.
+
+  @param[in]  ResetStatistics   TRUE to also clear the hit/miss statistics.
+
+**/
+VOID
+EFIAPI
+MediaFlushCache (
+  IN  BOOLEAN                        ResetStatistics
+  );
+
 #endif
 
@@ -89,6 +89,29 @@ DoHashVerify (
   IN OUT   UINT8           *Hash
   );
 
+/**
+  Verify a pre-calculated data digest with the built-in one.
+
+  @param[in]  Digest         Calculated data digest.
+  @param[in]  Usage          Hash component usage.
+  @param[in]  HashAlg        Specify hash algorithm.
+  @param[in,out]  HashData   On input,  expected hash value when hash component usage is 0.
+                             On output, calculated hash value when verification succeeds.
+
+  @retval RETURN_SUCCESS             Hash verification succeeded.
+  @retval RETURN_INVALID_PARAMETER   Hash parameter is not valid.
+  @retval RETURN_SECURITY_VIOLATION  Hash verification failed.
+
+**/
+RETURN_STATUS
+EFIAPI
+DoDigestVerify (
+  IN CONST UINT8           *Digest,
+  IN       HASH_COMP_USAGE  Usage,
+  IN       UINT8            HashAlg,
+  IN OUT   UINT8           *HashData
+  );
+
 /**
   Verifies the RSA signature with PKCS1-v1_5 encoding scheme defined in RSA PKCS#1.
   Also(optional), return the hash of the message to the caller.
@@ -122,6 +145,37 @@ DoRsaVerify (
   OUT      UINT8           *OutHash         OPTIONAL
   );
 
+/**
+  Verifies the RSA signature with PKCS1-v1_5 encoding scheme against a
+  pre-calculated message digest.
+
+  @param[in]  Digest          Calculated message digest.
+  @param[in]  HashAlg         Hash algorithm used to calculate Digest.
+  @param[in]  Usage           Hash usage.
+  @param[in]  Signature       Signature header for singanture data.
+  @param[in]  PubKeyHdr       Public key header for key data
+  @param[in]  PubKeyHashAlg   Hash Alg for PubKeyHash.
+  @param[in]  PubKeyHash      Public key hash value when hash component usage is 0.
+
+  @retval RETURN_SUCCESS             RSA verification succeeded.
+  @retval RETURN_INVALID_PARAMETER   Signature or key header is not valid.
+  @retval RETURN_NOT_FOUND           Hash data for hash component usage is not found.
+  @retval RETURN_UNSUPPORTED         Signing scheme or hash alg is not supported.
+  @retval RETURN_SECURITY_VIOLATION  PubKey or Signature verification failed.
+
+**/
+RETURN_STATUS
+EFIAPI
+DoRsaDigestVerify (
+  IN CONST UINT8           *Digest,
+  IN       UINT8            HashAlg,
+  IN       HASH_COMP_USAGE  Usage,
+  IN CONST SIGNATURE_HDR   *SignatureHdr,
+  IN       PUB_KEY_HDR     *PubKeyHdr,
+  IN       UINT8            PubKeyHashAlg,
+  IN       UINT8           *PubKeyHash      OPTIONAL
+  );
+
 /**
   Generate RandomNumbers.
 
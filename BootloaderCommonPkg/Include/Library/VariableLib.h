@@ -1,7 +1,7 @@
 /** @file
   Lite variable service library
 
-  Copyright (c) 2017 -2023, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2017 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -141,4 +141,38 @@ VariableConstructor (
   IN  UINT32    Size
   );
 
+/**
+  Start queuing variable updates in memory.
+
+  SetVariable () calls made afterwards are coalesced in a pending buffer of
+  PcdVariableWriteBackSize bytes, and they are written to the store at once by
+  CommitVariableBatch (). GetVariable () returns the queued data, while
+  GetNextVariableName () only enumerates the variables in the store.
+  The batch must be committed before the current stage hands over control.
+
+  @retval    EFI_SUCCESS            Write-back is enabled.
+  @retval    EFI_NOT_READY          The variable service is not initialized.
+  @retval    EFI_UNSUPPORTED        PcdVariableWriteBackSize is 0.
+  @retval    EFI_OUT_OF_RESOURCES   The pending buffer cannot be allocated.
+**/
+EFI_STATUS
+EFIAPI
+BeginVariableBatch (
+  VOID
+  );
+
+/**
+  Write the queued variable updates to the store and stop queuing.
+
+  @retval    EFI_SUCCESS            The queued updates were written.
+  @retval    EFI_NOT_READY          The variable service is not initialized.
+  @retval    Others                 An update failed, the remaining ones stay queued
+                                    and are returned by GetVariable ().
+**/
+EFI_STATUS
+EFIAPI
+CommitVariableBatch (
+  VOID
+  );
+
 #endif
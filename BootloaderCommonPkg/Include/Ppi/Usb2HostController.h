@@ -5,7 +5,7 @@
   Refer to section 16.1 of the UEFI 2.3 Specification for more information on
   these interfaces.
 
-  Copyright (c) 2010 - 2013, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2010 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -142,6 +142,86 @@ EFI_STATUS
   OUT    UINT32                              *TransferResult
   );
 
+///
+/// One bulk transfer of a PEI_USB2_HOST_CONTROLLER_BULK_TRANSFER_LIST request.
+///
+typedef struct {
+  ///
+  /// The combination of an endpoint number and an endpoint direction.
+  ///
+  UINT8                 EndPointAddress;
+  ///
+  /// The stream of a bulk endpoint with streams, or 0 for an endpoint without streams.
+  ///
+  UINT16                StreamId;
+  ///
+  /// The maximum packet size of the endpoint.
+  ///
+  UINTN                 MaximumPacketLength;
+  ///
+  /// The data buffer of the transfer.
+  ///
+  VOID                  *Data;
+  ///
+  /// On input the size of the data buffer, on output the data size actually transferred.
+  ///
+  UINTN                 DataLength;
+  ///
+  /// TRUE if the completion of the list does not wait for this transfer. An optional
+  /// transfer still pending when all the others completed is cancelled and its
+  /// TransferResult is EFI_USB_ERR_NOTEXECUTE.
+  ///
+  BOOLEAN               Optional;
+  ///
+  /// The detailed result information of the transfer.
+  ///
+  UINT32                TransferResult;
+} PEI_USB2_HC_BULK_REQUEST;
+
+/**
+  Submits a list of bulk transfers to bulk endpoints of a USB device at once.
+
+  All the transfers are queued before any of them is started, so the device can
+  serve them in any order, e.g. to complete several commands queued on separate
+  streams of a USB Attached SCSI device.
+
+  @param[in]     PeiServices           The pointer of EFI_PEI_SERVICES.
+  @param[in]     This                  The pointer of PEI_USB2_HOST_CONTROLLER_PPI.
+  @param[in]     DeviceAddress         Represents the address of the target device
+                                       on the USB.
+  @param[in]     DeviceSpeed           Indicates device speed.
+  @param[in,out] Requests              The bulk transfers to submit.
+  @param[in]     RequestCount          The number of bulk transfers in Requests.
+  @param[in]     TimeOut               Indicates the maximum time, in milliseconds,
+                                       in which the transfers are allowed to complete.
+                                       If Timeout is 0, then the caller must wait for
+                                       the function to be completed until EFI_SUCCESS
+                                       or EFI_DEVICE_ERROR is returned.
+  @param[in]     Translator            A pointer to the transaction translator data.
+
+  @retval EFI_SUCCESS           All the required bulk transfers were completed successfully.
+  @retval EFI_DEVICE_ERROR      A bulk transfer failed due to host controller or device error.
+                                Caller should check TransferResult of every request for
+                                detailed error information.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_OUT_OF_RESOURCES  The bulk transfers could not be submitted due to a lack of resources.
+  @retval EFI_TIMEOUT           A bulk transfer failed due to timeout.
+  @retval EFI_UNSUPPORTED       A stream is requested on an endpoint without streams.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *PEI_USB2_HOST_CONTROLLER_BULK_TRANSFER_LIST) (
+  IN     EFI_PEI_SERVICES                    **PeiServices,
+  IN     PEI_USB2_HOST_CONTROLLER_PPI        *This,
+  IN     UINT8                               DeviceAddress,
+  IN     UINT8                               DeviceSpeed,
+  IN OUT PEI_USB2_HC_BULK_REQUEST            *Requests,
+  IN     UINTN                               RequestCount,
+  IN     UINTN                               TimeOut,
+  IN     EFI_USB2_HC_TRANSACTION_TRANSLATOR  *Translator
+  );
+
 /**
   Retrieves the number of root hub ports.
 
@@ -253,6 +333,7 @@ struct _PEI_USB2_HOST_CONTROLLER_PPI {
   PEI_USB2_HOST_CONTROLLER_GET_ROOTHUB_PORT_STATUS     GetRootHubPortStatus;
   PEI_USB2_HOST_CONTROLLER_SET_ROOTHUB_PORT_FEATURE    SetRootHubPortFeature;
   PEI_USB2_HOST_CONTROLLER_CLEAR_ROOTHUB_PORT_FEATURE  ClearRootHubPortFeature;
+  PEI_USB2_HOST_CONTROLLER_BULK_TRANSFER_LIST          BulkTransferList;
 };
 
 extern EFI_GUID gPeiUsb2HostControllerPpiGuid;
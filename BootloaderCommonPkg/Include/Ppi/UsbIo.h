@@ -6,7 +6,7 @@
   Refer to section 16.2.4 of the UEFI 2.3 Specification for more information on
   these interfaces.
 
-Copyright (c) 2006 - 2013, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -16,6 +16,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define _PEI_USB_IO_PPI_H_
 
 #include <Protocol/Usb2HostController.h>
+#include <Ppi/Usb2HostController.h>
 
 ///
 /// Global ID for the PEI_USB_IO_PPI.
@@ -170,6 +171,55 @@ EFI_STATUS
   IN PEI_USB_IO_PPI    *This
   );
 
+/**
+  Get the active configuration descriptor of a USB device, followed by all
+  its interface, endpoint and class specific descriptors.
+
+  @param[in]  PeiServices         The pointer to the PEI Services Table.
+  @param[in]  This                The pointer to this instance of the PEI_USB_IO_PPI.
+  @param[out] ConfigDescriptor    The configuration descriptor.
+
+  @retval EFI_SUCCESS             The configuration descriptor was returned.
+  @retval EFI_INVALID_PARAMETER   Some parameters are invalid.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *PEI_USB_GET_CONFIG_DESCRIPTOR) (
+  IN  EFI_PEI_SERVICES              **PeiServices,
+  IN  PEI_USB_IO_PPI                *This,
+  OUT EFI_USB_CONFIG_DESCRIPTOR     **ConfigDescriptor
+  );
+
+/**
+  Submits a list of bulk transfers to bulk endpoints of a USB device at once.
+  The endpoints may belong to any alternate setting of the device interfaces.
+
+  @param[in]     PeiServices       The pointer to the PEI Services Table.
+  @param[in]     This              The pointer to this instance of the PEI_USB_IO_PPI.
+  @param[in,out] Requests          The bulk transfers to submit.
+  @param[in]     RequestCount      The number of bulk transfers in Requests.
+  @param[in]     Timeout           The timeout for all the transfers, in milliseconds.
+                                   If Timeout is 0, then the caller must wait for the
+                                   function to be completed until EFI_SUCCESS or
+                                   EFI_DEVICE_ERROR is returned.
+
+  @retval EFI_SUCCESS             All the required bulk transfers were completed successfully.
+  @retval EFI_DEVICE_ERROR        A bulk transfer failed. Check TransferResult of every
+                                  request for detailed error information.
+  @retval EFI_UNSUPPORTED         The host controller does not support a list of bulk transfers.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *PEI_USB_BULK_TRANSFER_LIST) (
+  IN     EFI_PEI_SERVICES          **PeiServices,
+  IN     PEI_USB_IO_PPI            *This,
+  IN OUT PEI_USB2_HC_BULK_REQUEST  *Requests,
+  IN     UINTN                     RequestCount,
+  IN     UINTN                     Timeout
+  );
+
 ///
 /// This PPI contains a set of services to interact with the USB host controller.
 /// These interfaces are modeled on the UEFI 2.3 specification EFI_USB_IO_PROTOCOL.
@@ -182,6 +232,8 @@ struct _PEI_USB_IO_PPI {
   PEI_USB_GET_INTERFACE_DESCRIPTOR  UsbGetInterfaceDescriptor;
   PEI_USB_GET_ENDPOINT_DESCRIPTOR   UsbGetEndpointDescriptor;
   PEI_USB_PORT_RESET                UsbPortReset;
+  PEI_USB_GET_CONFIG_DESCRIPTOR     UsbGetConfigDescriptor;
+  PEI_USB_BULK_TRANSFER_LIST        UsbBulkTransferList;
 };
 
 extern EFI_GUID gPeiUsbIoPpiGuid;
@@ -27,8 +27,8 @@ GetMaxTransferSector (
   UINT32  BlkCnt;
 
   if (AtaDevice->DeviceFeature & DEVICE_LBA_48_SUPPORT) {
-    if (FeaturePcdGet(PcdDmaProtectionEnabled)) {
-      // When DMA protection is enabled, only tranfer less than DMA buffer size
+    if (!IoMmuIsDirectDma (NULL, 0)) {
+      // When DMA is bounced, only tranfer less than DMA buffer size
       // Use half for safe.  Around 1MB will be used for CmdTable.
       BlkCnt = (PcdGet32 (PcdDmaBufferSize) >> 1) / AtaDevice->BlockSize;
       if (BlkCnt == 0) {
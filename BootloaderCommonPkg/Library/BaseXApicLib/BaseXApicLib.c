@@ -3,7 +3,7 @@
 
   This local APIC library instance supports xAPIC mode only.
 
-  Copyright (c) 2010 - 2015, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2010 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -526,7 +526,7 @@ SendInitSipiSipi (
 }
 
 /**
-  Send an INIT-Start-up-Start-up IPI sequence to all processors excluding self.
+  Send a Start-up IPI to all processors excluding self.
 
   This function returns after the IPI has been accepted by the target processors.
 
@@ -538,7 +538,7 @@ SendInitSipiSipi (
 **/
 VOID
 EFIAPI
-SendInitSipiSipiAllExcludingSelf (
+SendStartupIpiAllExcludingSelf (
   IN UINT32          StartupRoutine
   )
 {
@@ -547,16 +547,36 @@ SendInitSipiSipiAllExcludingSelf (
   ASSERT (StartupRoutine < 0x100000);
   ASSERT ((StartupRoutine & 0xfff) == 0);
 
-  SendInitIpiAllExcludingSelf ();
-  MicroSecondDelay (PcdGet32 (PcdCpuInitIpiDelayInMicroSeconds));
   IcrLow.Uint32 = 0;
   IcrLow.Bits.Vector = (StartupRoutine >> 12);
   IcrLow.Bits.DeliveryMode = LOCAL_APIC_DELIVERY_MODE_STARTUP;
   IcrLow.Bits.Level = 1;
   IcrLow.Bits.DestinationShorthand = LOCAL_APIC_DESTINATION_SHORTHAND_ALL_EXCLUDING_SELF;
   SendIpi (IcrLow.Uint32, 0);
+}
+
+/**
+  Send an INIT-Start-up-Start-up IPI sequence to all processors excluding self.
+
+  This function returns after the IPI has been accepted by the target processors.
+
+  if StartupRoutine >= 1M, then ASSERT.
+  if StartupRoutine is not multiple of 4K, then ASSERT.
+
+  @param  StartupRoutine    Points to a start-up routine which is below 1M physical
+                            address and 4K aligned.
+**/
+VOID
+EFIAPI
+SendInitSipiSipiAllExcludingSelf (
+  IN UINT32          StartupRoutine
+  )
+{
+  SendInitIpiAllExcludingSelf ();
+  MicroSecondDelay (PcdGet32 (PcdCpuInitIpiDelayInMicroSeconds));
+  SendStartupIpiAllExcludingSelf (StartupRoutine);
   MicroSecondDelay (200);
-  SendIpi (IcrLow.Uint32, 0);
+  SendStartupIpiAllExcludingSelf (StartupRoutine);
 }
 
 /**
@@ -4,7 +4,7 @@
   This local APIC library instance supports x2APIC capable processors
   which have xAPIC and x2APIC modes.
 
-  Copyright (c) 2010 - 2019, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2010 - 2026, Intel Corporation. All rights reserved.<BR>
   Copyright (c) 2017 - 2020, AMD Inc. All rights reserved.<BR>
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
@@ -624,7 +624,7 @@ SendInitSipiSipi (
 }
 
 /**
-  Send an INIT-Start-up-Start-up IPI sequence to all processors excluding self.
+  Send a Start-up IPI to all processors excluding self.
 
   This function returns after the IPI has been accepted by the target processors.
 
@@ -636,7 +636,7 @@ SendInitSipiSipi (
 **/
 VOID
 EFIAPI
-SendInitSipiSipiAllExcludingSelf (
+SendStartupIpiAllExcludingSelf (
   IN UINT32          StartupRoutine
   )
 {
@@ -645,16 +645,36 @@ SendInitSipiSipiAllExcludingSelf (
   ASSERT (StartupRoutine < 0x100000);
   ASSERT ((StartupRoutine & 0xfff) == 0);
 
-  SendInitIpiAllExcludingSelf ();
-  MicroSecondDelay (PcdGet32(PcdCpuInitIpiDelayInMicroSeconds));
   IcrLow.Uint32 = 0;
   IcrLow.Bits.Vector = (StartupRoutine >> 12);
   IcrLow.Bits.DeliveryMode = LOCAL_APIC_DELIVERY_MODE_STARTUP;
   IcrLow.Bits.Level = 1;
   IcrLow.Bits.DestinationShorthand = LOCAL_APIC_DESTINATION_SHORTHAND_ALL_EXCLUDING_SELF;
   SendIpi (IcrLow.Uint32, 0);
+}
+
+/**
+  Send an INIT-Start-up-Start-up IPI sequence to all processors excluding self.
+
+  This function returns after the IPI has been accepted by the target processors.
+
+  if StartupRoutine >= 1M, then ASSERT.
+  if StartupRoutine is not multiple of 4K, then ASSERT.
+
+  @param  StartupRoutine    Points to a start-up routine which is below 1M physical
+                            address and 4K aligned.
+**/
+VOID
+EFIAPI
+SendInitSipiSipiAllExcludingSelf (
+  IN UINT32          StartupRoutine
+  )
+{
+  SendInitIpiAllExcludingSelf ();
+  MicroSecondDelay (PcdGet32(PcdCpuInitIpiDelayInMicroSeconds));
+  SendStartupIpiAllExcludingSelf (StartupRoutine);
   MicroSecondDelay (200);
-  SendIpi (IcrLow.Uint32, 0);
+  SendStartupIpiAllExcludingSelf (StartupRoutine);
 }
 
 /**
@@ -0,0 +1,262 @@
+/** @file
+  Fork/join scheduling of independent jobs on the BSP and the idle APs.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <Uefi/UefiBaseType.h>
+#include <Library/BaseLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/BootloaderCommonLib.h>
+
+//
+// CPU task table used by library code that runs jobs on its own, such as
+// decompression. It stays NULL when running XIP, so that all jobs run on
+// the calling processor.
+//
+STATIC SYS_CPU_TASK  *mDefaultCpuJobTask = NULL;
+
+/**
+  CPU task that runs a job and flags its completion.
+
+  @param[in] Arg  Pointer to the CPU_JOB to run.
+
+  @retval  The return value of the job function.
+**/
+STATIC
+UINT64
+EFIAPI
+CpuJobTask (
+  IN  UINT64   Arg
+  )
+{
+  CPU_JOB   *Job;
+
+  Job = (CPU_JOB *)(UINTN)Arg;
+  Job->Result = Job->Func (Job->Argument);
+  MemoryFence ();
+  Job->Done = TRUE;
+
+  return Job->Result;
+}
+
+/**
+  Claim an idle AP so that no other processor hands it a task meanwhile.
+
+  The State byte is followed by reserved bytes that are always zero, so it is
+  exchanged as a 16-bit value, which is the smallest interlocked operation.
+
+  @param[in] CpuTask  The task entry of the AP.
+
+  @retval TRUE        The AP was idle and is now claimed.
+  @retval FALSE       The AP is not idle.
+**/
+STATIC
+BOOLEAN
+ClaimIdleCpu (
+  IN  CPU_TASK  *CpuTask
+  )
+{
+  if (((volatile CPU_TASK *)CpuTask)->State != EnumCpuReady) {
+    return FALSE;
+  }
+
+  return InterlockedCompareExchange16 ((UINT16 *)&CpuTask->State,
+           EnumCpuReady, EnumCpuBusy) == EnumCpuReady;
+}
+
+/**
+  Set the CPU task table used by library code that schedules CPU jobs on its
+  own, such as decompression.
+
+  @param[in] SysCpuTask  The CPU task table of the APs waiting for tasks, or
+                         NULL when the APs are not available anymore.
+**/
+VOID
+EFIAPI
+SetDefaultCpuJobTask (
+  IN  SYS_CPU_TASK  *SysCpuTask  OPTIONAL
+  )
+{
+  mDefaultCpuJobTask = SysCpuTask;
+}
+
+/**
+  Get the CPU task table set by SetDefaultCpuJobTask().
+
+  @retval  The CPU task table, or NULL if the APs are not available.
+**/
+SYS_CPU_TASK *
+EFIAPI
+GetDefaultCpuJobTask (
+  VOID
+  )
+{
+  return mDefaultCpuJobTask;
+}
+
+/**
+  Run a set of independent jobs in parallel and wait for all of them.
+
+  Each pending job is handed to the next AP found idle in SysCpuTask. When no
+  AP is idle the calling processor runs the next pending job itself, so the
+  call also works, serially, without any AP. It returns once every job has
+  completed. Idle APs are claimed atomically, so a job running on an AP may
+  schedule jobs of its own.
+
+  Jobs run concurrently, so a job function must not allocate memory, print
+  debug messages or call any other non-reentrant service. AP stacks are small,
+  so large local buffers must be avoided as well.
+
+  @param[in]      SysCpuTask  The CPU task table of the APs waiting for tasks,
+                              or NULL to run all jobs on the BSP.
+  @param[in, out] Jobs        The jobs to run. Result, CpuIndex and Done are
+                              updated for every job.
+  @param[in]      JobCount    The number of jobs.
+
+  @retval EFI_INVALID_PARAMETER   Jobs is NULL or a job has no function.
+  @retval EFI_SUCCESS             All jobs have completed. Refer to the Result
+                                  of each job for its own status.
+
+**/
+EFI_STATUS
+EFIAPI
+ScheduleCpuJobs (
+  IN      SYS_CPU_TASK  *SysCpuTask  OPTIONAL,
+  IN OUT  CPU_JOB       *Jobs,
+  IN      UINT32         JobCount
+  )
+{
+  volatile CPU_TASK  *CpuTask;
+  volatile CPU_JOB   *Job;
+  UINT32              CpuCount;
+  UINT32              Cpu;
+  UINT32              Next;
+  UINT32              Index;
+
+  if ((Jobs == NULL) && (JobCount > 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  for (Index = 0; Index < JobCount; Index++) {
+    if (Jobs[Index].Func == NULL) {
+      return EFI_INVALID_PARAMETER;
+    }
+    Jobs[Index].Result   = 0;
+    Jobs[Index].CpuIndex = 0;
+    Jobs[Index].Done     = FALSE;
+  }
+
+  CpuCount = (SysCpuTask == NULL) ? 1 : SysCpuTask->CpuCount;
+
+  Next = 0;
+  while (Next < JobCount) {
+    //
+    // An AP is back to EnumCpuReady only after its previous task returned.
+    // A claimed AP waits in EnumCpuBusy until its task is started.
+    //
+    for (Cpu = 1; (Cpu < CpuCount) && (Next < JobCount); Cpu++) {
+      if (!ClaimIdleCpu (&SysCpuTask->CpuTask[Cpu])) {
+        continue;
+      }
+      CpuTask = &SysCpuTask->CpuTask[Cpu];
+      Jobs[Next].CpuIndex = Cpu;
+      CpuTask->TaskFunc   = (UINT64)(UINTN)CpuJobTask;
+      CpuTask->Argument   = (UINT64)(UINTN)&Jobs[Next];
+      MemoryFence ();
+      CpuTask->State      = EnumCpuStart;
+      Next++;
+    }
+
+    if (Next < JobCount) {
+      CpuJobTask ((UINT64)(UINTN)&Jobs[Next]);
+      Next++;
+    }
+  }
+
+  for (Index = 0; Index < JobCount; Index++) {
+    Job = &Jobs[Index];
+    while (Job->Done == FALSE) {
+      CpuPause ();
+    }
+  }
+  MemoryFence ();
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Start a job on an idle AP and return without waiting for it.
+
+  When no AP is idle, or SysCpuTask is NULL, the calling processor runs the job
+  before returning. Either way WaitForCpuJob() returns once the job completed,
+  so the caller can overlap its own work, such as device reads, with the job.
+  The same restrictions as for ScheduleCpuJobs() apply to the job function.
+
+  @param[in]      SysCpuTask  The CPU task table of the APs waiting for tasks,
+                              or NULL to run the job on the calling processor.
+  @param[in, out] Job         The job to start. Result, CpuIndex and Done are
+                              updated when it completes.
+
+  @retval EFI_INVALID_PARAMETER   Job is NULL or has no function.
+  @retval EFI_SUCCESS             The job was started or has completed.
+
+**/
+EFI_STATUS
+EFIAPI
+StartCpuJob (
+  IN      SYS_CPU_TASK  *SysCpuTask  OPTIONAL,
+  IN OUT  CPU_JOB       *Job
+  )
+{
+  volatile CPU_TASK  *CpuTask;
+  UINT32              Cpu;
+
+  if ((Job == NULL) || (Job->Func == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Job->Result   = 0;
+  Job->CpuIndex = 0;
+  Job->Done     = FALSE;
+
+  if (SysCpuTask != NULL) {
+    for (Cpu = 1; Cpu < SysCpuTask->CpuCount; Cpu++) {
+      if (ClaimIdleCpu (&SysCpuTask->CpuTask[Cpu])) {
+        CpuTask = &SysCpuTask->CpuTask[Cpu];
+        Job->CpuIndex     = Cpu;
+        CpuTask->TaskFunc = (UINT64)(UINTN)CpuJobTask;
+        CpuTask->Argument = (UINT64)(UINTN)Job;
+        MemoryFence ();
+        CpuTask->State    = EnumCpuStart;
+        return EFI_SUCCESS;
+      }
+    }
+  }
+
+  CpuJobTask ((UINT64)(UINTN)Job);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Wait for a job started by StartCpuJob() to complete.
+
+  @param[in] Job  The job to wait for.
+
+  @retval  The return value of the job function.
+**/
+UINT64
+EFIAPI
+WaitForCpuJob (
+  IN  CPU_JOB       *Job
+  )
+{
+  while (((volatile CPU_JOB *)Job)->Done == FALSE) {
+    CpuPause ();
+  }
+  MemoryFence ();
+
+  return Job->Result;
+}
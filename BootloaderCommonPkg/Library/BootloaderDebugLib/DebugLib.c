@@ -1,6 +1,6 @@
 /** @file
 
-  Copyright (c) 2014 - 2018, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2014 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -46,10 +46,11 @@ DebugPrint (
   ...
   )
 {
-  CHAR8    Buffer[MAX_DEBUG_MESSAGE_LENGTH];
-  VA_LIST  Marker;
-  UINTN    Length;
-  BOOLEAN  OutputToSerial;
+  CHAR8          Buffer[MAX_DEBUG_MESSAGE_LENGTH];
+  VA_LIST        Marker;
+  UINTN          Length;
+  BOOLEAN        OutputToSerial;
+  RETURN_STATUS  Status;
 
 
   //
@@ -64,6 +65,21 @@ DebugPrint (
     return;
   }
 
+  //
+  // Skip formatting when the message only goes to the log buffer, keep it as
+  // a binary trace record to be rendered on the host instead
+  //
+  if (FeaturePcdGet (PcdBinaryTraceLogEnabled) &&
+      ((PcdGet32 (PcdDebugOutputDeviceMask) & DEBUG_OUTPUT_DEVICE_LOG_BUFFER) != 0) &&
+      ((PcdGet32 (PcdDebugOutputDeviceMask) & (DEBUG_OUTPUT_DEVICE_SERIAL_PORT | DEBUG_OUTPUT_DEVICE_DEBUG_PORT | DEBUG_OUTPUT_DEVICE_CONSOLE)) == 0)) {
+    VA_START (Marker, Format);
+    Status = DebugLogBufferTrace (Format, Marker);
+    VA_END (Marker);
+    if (!RETURN_ERROR (Status)) {
+      return;
+    }
+  }
+
   //
   // Convert the DEBUG() message to an ASCII String
   //
@@ -73,6 +89,16 @@ DebugPrint (
 
   Length = AsciiStrLen (Buffer);
 
+  //
+  // The console writes to the serial port directly, so stop deferring the
+  // serial output before the message is queued. Otherwise it would be
+  // written to the serial port again when the queue is drained.
+  //
+  if (((PcdGet32 (PcdDebugOutputDeviceMask) & DEBUG_OUTPUT_DEVICE_CONSOLE) != 0) &&
+      ((PcdGet32 (PcdConsoleOutDeviceMask) & ConsoleOutSerialPort) != 0)) {
+    DebugLogBufferDefer (FALSE);
+  }
+
   //
   // Send the print string to debug output handler
   //
@@ -92,7 +118,11 @@ DebugPrint (
   }
 
   if (OutputToSerial) {
-    SerialPortWrite ((UINT8 *)Buffer, Length);
+    // Deferred serial output has been queued in the log buffer, only drain
+    // what the UART can take without waiting.
+    if (DebugLogBufferDrain (FALSE) == RETURN_NOT_STARTED) {
+      SerialPortWrite ((UINT8 *)Buffer, Length);
+    }
   }
 
   if (PcdGet32 (PcdDebugOutputDeviceMask) & DEBUG_OUTPUT_DEVICE_DEBUG_PORT) {
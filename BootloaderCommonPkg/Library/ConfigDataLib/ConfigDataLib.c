@@ -1,6 +1,6 @@
 /** @file
 
-Copyright (c) 2017 - 2020, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2017 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -9,6 +9,150 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/BootloaderCommonLib.h>
 #include <Library/ConfigDataLib.h>
 #include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+
+/**
+  Get the tag index of the configuration data blob.
+
+  @retval   The index, or NULL if none was built for the current blob.
+
+**/
+CDATA_INDEX *
+EFIAPI
+GetConfigDataIndex (
+  VOID
+  )
+{
+  CDATA_BLOB          *CdataBlob;
+  CDATA_INDEX         *Index;
+  EFI_STATUS           Status;
+
+  CdataBlob = (CDATA_BLOB *) GetConfigDataPtr ();
+  if (CdataBlob == NULL) {
+    return NULL;
+  }
+
+  Status = GetLibraryData (PcdGet8 (PcdConfigDataLibId), (VOID **)&Index);
+  if (EFI_ERROR (Status) || (Index->Signature != CDATA_INDEX_SIGNATURE)) {
+    return NULL;
+  }
+
+  if ((Index->UsedLength != CdataBlob->UsedLength) ||
+      (Index->InternalDataOffset != CdataBlob->ExtraInfo.InternalDataOffset)) {
+    return NULL;
+  }
+
+  return Index;
+}
+
+/**
+  Build the tag index of the configuration data blob.
+
+  The index is kept in the loader library data, so that it is migrated with
+  the blob and handed over to the payload. All lookup APIs use it until the
+  blob is modified.
+
+  @retval EFI_SUCCESS           The index was built.
+  @retval EFI_NOT_FOUND         There is no configuration data blob.
+  @retval EFI_UNSUPPORTED       The blob is too large for the index.
+  @retval EFI_OUT_OF_RESOURCES  The index could not be allocated.
+
+**/
+EFI_STATUS
+EFIAPI
+BuildConfigDataIndex (
+  VOID
+  )
+{
+  CDATA_BLOB          *CdataBlob;
+  CDATA_HEADER        *CdataHdr;
+  CDATA_INDEX         *Index;
+  UINT32               Offset;
+  UINT32               Count;
+  UINT32               Pos;
+  UINT32               Entry;
+  UINT32               IndexSize;
+
+  CdataBlob = (CDATA_BLOB *) GetConfigDataPtr ();
+  if ((CdataBlob == NULL) || (CdataBlob->Signature != CFG_DATA_SIGNATURE)) {
+    return EFI_NOT_FOUND;
+  }
+
+  if ((CdataBlob->UsedLength >> 2) > CDATA_INDEX_OFFSET_MASK) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Count  = 0;
+  Offset = CdataBlob->HeaderLength;
+  while (Offset < CdataBlob->UsedLength) {
+    CdataHdr = (CDATA_HEADER *) ((UINT8 *)CdataBlob + Offset);
+    if (CdataHdr->Length == 0) {
+      return EFI_UNSUPPORTED;
+    }
+    Offset += (CdataHdr->Length << 2);
+    Count++;
+  }
+
+  IndexSize = sizeof (CDATA_INDEX) + Count * sizeof (UINT32);
+  Index     = AllocatePool (IndexSize);
+  if (Index == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Items are visited in blob order and insertion keeps the items of a tag
+  // in that order, which is the priority order of the linear search.
+  //
+  Count  = 0;
+  Offset = CdataBlob->HeaderLength;
+  while (Offset < CdataBlob->UsedLength) {
+    CdataHdr = (CDATA_HEADER *) ((UINT8 *)CdataBlob + Offset);
+    Entry    = ((UINT32)CdataHdr->Tag << CDATA_INDEX_TAG_SHIFT) | (Offset >> 2);
+    for (Pos = Count; (Pos > 0) && (Index->Entry[Pos - 1] > Entry); Pos--) {
+      Index->Entry[Pos] = Index->Entry[Pos - 1];
+    }
+    Index->Entry[Pos] = Entry;
+    Offset += (CdataHdr->Length << 2);
+    Count++;
+  }
+
+  Index->Signature          = CDATA_INDEX_SIGNATURE;
+  Index->UsedLength         = CdataBlob->UsedLength;
+  Index->InternalDataOffset = CdataBlob->ExtraInfo.InternalDataOffset;
+  Index->Reserved           = 0;
+  Index->LookupCount        = 0;
+  Index->Count              = Count;
+
+  return SetLibraryData (PcdGet8 (PcdConfigDataLibId), Index, IndexSize);
+}
+
+/**
+  Check a configuration data header against a platform ID mask.
+
+  @param[in] CdataHdr    Configuration data header.
+  @param[in] PidMask     Platform ID mask.
+
+  @retval    TRUE        One of the header conditions matches the mask.
+  @retval    FALSE       No condition matches the mask.
+
+**/
+STATIC
+BOOLEAN
+IsConfigHdrPidMatch (
+  IN  CDATA_HEADER  *CdataHdr,
+  IN  UINT32         PidMask
+  )
+{
+  UINT8                Idx;
+
+  for (Idx = 0; Idx < CdataHdr->ConditionNum; Idx++) {
+    if ((PidMask & CdataHdr->Condition[Idx].Value) != 0) {
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
 
 /**
   Find configuration data header by its tag and platform ID.
@@ -32,38 +176,66 @@ FindConfigHdrByPidMaskTag (
 {
   CDATA_BLOB          *CdataBlob;
   CDATA_HEADER        *CdataHdr;
-  UINT8                Idx;
+  CDATA_INDEX         *Index;
   REFERENCE_CFG_DATA  *Refer;
   UINT32               Offset;
+  UINT32               Low;
+  UINT32               High;
+  UINT32               Mid;
+  UINT32               Key;
 
   CdataBlob = (CDATA_BLOB *) GetConfigDataPtr ();
   Offset    = IsInternal > 0 ? (CdataBlob->ExtraInfo.InternalDataOffset * 4) : CdataBlob->HeaderLength;
 
-  while (Offset < CdataBlob->UsedLength) {
-    CdataHdr = (CDATA_HEADER *) ((UINT8 *)CdataBlob + Offset);
-    if (CdataHdr->Tag == Tag) {
-      for (Idx = 0; Idx < CdataHdr->ConditionNum; Idx++) {
-        if ((PidMask & CdataHdr->Condition[Idx].Value) != 0) {
-          // Found a match
-          if ((CdataHdr->Flags & CDATA_FLAG_TYPE_MASK) == CDATA_FLAG_TYPE_REFER) {
-            if (Level > 0) {
-              // Prevent multiple level nesting
-              return NULL;
-            } else {
-              Refer = (REFERENCE_CFG_DATA *) ((UINT8 *)CdataHdr + sizeof (CDATA_HEADER) + sizeof (
-                                                CDATA_COND) * CdataHdr->ConditionNum);
-              return FindConfigHdrByPidMaskTag (PID_TO_MASK (Refer->PlatformId), \
-                                                Refer->Tag, (UINT8)Refer->IsInternal, 1);
-            }
-          } else {
-            return (VOID *)CdataHdr;
-          }
-        }
+  CdataHdr  = NULL;
+  Index     = GetConfigDataIndex ();
+  if (Index != NULL) {
+    //
+    // Find the first item of the tag at or after the search start
+    //
+    Index->LookupCount++;
+    Key  = (Tag << CDATA_INDEX_TAG_SHIFT) | (Offset >> 2);
+    Low  = 0;
+    High = Index->Count;
+    while (Low < High) {
+      Mid = (Low + High) / 2;
+      if (Index->Entry[Mid] < Key) {
+        Low = Mid + 1;
+      } else {
+        High = Mid;
       }
     }
-    Offset += (CdataHdr->Length << 2);
+    for (; (Low < Index->Count) && ((Index->Entry[Low] >> CDATA_INDEX_TAG_SHIFT) == Tag); Low++) {
+      CdataHdr = (CDATA_HEADER *) ((UINT8 *)CdataBlob + ((Index->Entry[Low] & CDATA_INDEX_OFFSET_MASK) << 2));
+      if (IsConfigHdrPidMatch (CdataHdr, PidMask)) {
+        break;
+      }
+      CdataHdr = NULL;
+    }
+  } else {
+    while (Offset < CdataBlob->UsedLength) {
+      CdataHdr = (CDATA_HEADER *) ((UINT8 *)CdataBlob + Offset);
+      if ((CdataHdr->Tag == Tag) && IsConfigHdrPidMatch (CdataHdr, PidMask)) {
+        break;
+      }
+      Offset += (CdataHdr->Length << 2);
+      CdataHdr = NULL;
+    }
   }
-  return NULL;
+
+  // Found a match
+  if ((CdataHdr != NULL) && ((CdataHdr->Flags & CDATA_FLAG_TYPE_MASK) == CDATA_FLAG_TYPE_REFER)) {
+    if (Level > 0) {
+      // Prevent multiple level nesting
+      return NULL;
+    }
+    Refer = (REFERENCE_CFG_DATA *) ((UINT8 *)CdataHdr + sizeof (CDATA_HEADER) + sizeof (
+                                      CDATA_COND) * CdataHdr->ConditionNum);
+    return FindConfigHdrByPidMaskTag (PID_TO_MASK (Refer->PlatformId), \
+                                      Refer->Tag, (UINT8)Refer->IsInternal, 1);
+  }
+
+  return CdataHdr;
 }
 
 /**
@@ -205,6 +377,9 @@ AddConfigData (
   }
   LdrCfgBlob->UsedLength += CfgAddSize;
 
+  // The items moved, drop the index until it is built again
+  SetLibraryData (PcdGet8 (PcdConfigDataLibId), NULL, 0);
+
   return EFI_SUCCESS;
 }
 
@@ -1,7 +1,7 @@
 /** @file
   Container library implementation.
 
-  Copyright (c) 2019 - 2023, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2019 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -23,6 +23,58 @@
 
 #define  IS_FLASH_ADDRESS(x)   (((UINT32)(UINTN)(x)) >= 0xF0000000)
 
+typedef struct {
+  COMPONENT_LOAD_REQUEST   *Request;
+  UINT32                    ComponentId;
+  UINT32                    Usage;
+  UINT8                     AuthType;
+  BOOLEAN                   IsInFlash;
+  BOOLEAN                   IsStreamAuth;
+  BOOLEAN                   IsPreHashed;
+  UINT8                    *HashData;
+  UINT8                    *CompData;
+  UINT8                    *CompBuf;
+  UINT32                    SignedDataLen;
+  UINT32                    DecompressedLen;
+  VOID                     *AllocBuf;
+  VOID                     *ScrBuf;
+  VOID                     *ReqCompBase;
+  VOID                     *CompBase;
+  UINT8                     Digest[HASH_DIGEST_MAX];
+} COMPONENT_LOAD_CONTEXT;
+
+//
+// Data range of a container hashed while the container is read into memory.
+// Offset is relative to the container base. Length stays 0 for a component
+// until its compressed header is read.
+//
+typedef struct {
+  UINT32                    Offset;
+  UINT32                    Length;
+  UINT32                    Hashed;
+  UINT8                     AuthType;
+  UINT8                     HashAlg;
+  BOOLEAN                   Failed;
+  BOOLEAN                   Valid;
+  HASH_CTX                  HashCtx;
+  UINT8                     Digest[HASH_DIGEST_MAX];
+} STREAM_DIGEST_RANGE;
+
+typedef struct {
+  UINT8                    *Base;
+  UINT32                    Size;
+  BOOLEAN                   Parsed;
+  UINT32                    Count;
+  STREAM_DIGEST_RANGE       Range[MAX_CONTAINER_SUB_IMAGE];
+} CONTAINER_DIGEST_STREAM;
+
+//
+// Digests of the last container read through ContainerDigestUpdate(). It
+// stays NULL when running XIP. They are only valid as long as the container
+// memory holds the data that was hashed, see ContainerDigestDiscard().
+//
+STATIC CONTAINER_DIGEST_STREAM  *mDigestStream = NULL;
+
 /**
   Get the container pointer by the container signature
 
@@ -198,6 +250,7 @@ UnregisterContainer (
   }
 
   if (Index < ContainerList->Count) {
+    ContainerDigestDiscard ((VOID *)(UINTN)ContainerList->Entry[Index].Base);
     FreePool ((VOID *)(UINTN)ContainerList->Entry[Index].HeaderCache);
     ContainerList->Entry[Index] = ContainerList->Entry[LastIndex];
     ContainerList->Count--;
@@ -323,6 +376,487 @@ AuthenticateComponent (
   return Status;
 }
 
+/**
+  Check if data with the given authentication type can be verified from a
+  digest calculated separately from the authentication.
+
+  RSA-PSS verification needs the whole message, so it is not supported.
+
+  @param[in] AuthType     Authentication type.
+
+  @retval TRUE            The data can be verified from its digest.
+  @retval FALSE           The data needs to be authenticated as a whole.
+
+**/
+STATIC
+BOOLEAN
+IsDigestAuthSupported (
+  IN  UINT8     AuthType
+  )
+{
+  if (!FeaturePcdGet (PcdVerifiedBootEnabled)) {
+    return FALSE;
+  }
+
+  return (AuthType == AUTH_TYPE_SHA2_256) || (AuthType == AUTH_TYPE_SHA2_384) ||
+         (AuthType == AUTH_TYPE_SIG_RSA2048_PKCSI1_SHA256) ||
+         (AuthType == AUTH_TYPE_SIG_RSA3072_PKCSI1_SHA384);
+}
+
+/**
+  Check if a component with the given authentication type can be verified
+  from a digest accumulated while it is being copied into memory.
+
+  RSA-PSS verification needs the whole message, so it always goes through
+  the regular copy-then-authenticate path.
+
+  @param[in] AuthType     Authentication type.
+
+  @retval TRUE            The component can be copied and hashed in one pass.
+  @retval FALSE           The component needs to be authenticated separately.
+
+**/
+STATIC
+BOOLEAN
+IsStreamAuthSupported (
+  IN  UINT8     AuthType
+  )
+{
+  if (FixedPcdGet32 (PcdLoadComponentChunkSize) == 0) {
+    return FALSE;
+  }
+
+  return IsDigestAuthSupported (AuthType);
+}
+
+/**
+  Copy a component from flash into memory and hash it in the same pass.
+
+  The data is copied in PcdLoadComponentChunkSize chunks and each chunk is
+  hashed from the memory copy right after it has been copied, while it is
+  still hot in the cache. The digest therefore covers exactly the bytes that
+  will be decompressed later. A component already in memory is hashed in
+  place when Dst is the same as Src.
+
+  @param[out] Dst         Destination memory buffer.
+  @param[in]  Src         Source component buffer.
+  @param[in]  Length      Length to copy and hash.
+  @param[in]  HashAlg     Hash algorithm.
+  @param[out] Digest      Buffer to receive the digest of the copied data.
+
+  @retval EFI_UNSUPPORTED          Unsupported hash algorithm.
+  @retval EFI_SECURITY_VIOLATION   Hash calculation failed.
+  @retval EFI_SUCCESS              Data was copied and hashed successfully.
+
+**/
+STATIC
+EFI_STATUS
+CopyAndHashComponent (
+  OUT UINT8    *Dst,
+  IN  UINT8    *Src,
+  IN  UINT32    Length,
+  IN  UINT8     HashAlg,
+  OUT UINT8    *Digest
+  )
+{
+  RETURN_STATUS             Status;
+  HASH_CTX                  HashCtx;
+  UINT32                    ChunkSize;
+  UINT32                    Offset;
+  UINT32                    CopyLen;
+
+  if (HashAlg == HASH_TYPE_SHA256) {
+    Status = Sha256Init (&HashCtx, sizeof (HashCtx));
+  } else if (HashAlg == HASH_TYPE_SHA384) {
+    Status = Sha384Init (&HashCtx, sizeof (HashCtx));
+  } else {
+    return EFI_UNSUPPORTED;
+  }
+  if (RETURN_ERROR (Status)) {
+    return EFI_SECURITY_VIOLATION;
+  }
+
+  ChunkSize = FixedPcdGet32 (PcdLoadComponentChunkSize);
+  for (Offset = 0; Offset < Length; Offset += CopyLen) {
+    CopyLen = MIN (ChunkSize, Length - Offset);
+    if (Dst != Src) {
+      CopyMem (Dst + Offset, Src + Offset, CopyLen);
+    }
+    if (HashAlg == HASH_TYPE_SHA256) {
+      Status = Sha256Update (&HashCtx, Dst + Offset, CopyLen);
+    } else {
+      Status = Sha384Update (&HashCtx, Dst + Offset, CopyLen);
+    }
+    if (RETURN_ERROR (Status)) {
+      return EFI_SECURITY_VIOLATION;
+    }
+  }
+
+  if (HashAlg == HASH_TYPE_SHA256) {
+    Status = Sha256Final (&HashCtx, Digest);
+  } else {
+    Status = Sha384Final (&HashCtx, Digest);
+  }
+
+  return RETURN_ERROR (Status) ? EFI_SECURITY_VIOLATION : EFI_SUCCESS;
+}
+
+/**
+  Authenticate a component using a digest calculated by CopyAndHashComponent.
+
+  @param[in] Digest       Digest of the component data in memory.
+  @param[in] AuthType     Authentication type.
+  @param[in] AuthData     Authentication data buffer.
+  @param[in] HashData     Hash data buffer.
+  @param[in] Usage        Hash usage.
+
+  @retval EFI_UNSUPPORTED          Unsupported AuthType.
+  @retval EFI_SECURITY_VIOLATION   Authentication failed.
+  @retval EFI_SUCCESS              Authentication succeeded.
+
+**/
+STATIC
+EFI_STATUS
+AuthenticateComponentDigest (
+  IN  UINT8    *Digest,
+  IN  UINT8     AuthType,
+  IN  UINT8    *AuthData,
+  IN  UINT8    *HashData,
+  IN  UINT32    Usage
+  )
+{
+  EFI_STATUS                Status;
+  UINT8                    *KeyPtr;
+  SIGNATURE_HDR            *SignHdr;
+
+  if (AuthType == AUTH_TYPE_SHA2_256) {
+    Status = DoDigestVerify (Digest, Usage, HASH_TYPE_SHA256, HashData);
+  } else if (AuthType == AUTH_TYPE_SHA2_384) {
+    Status = DoDigestVerify (Digest, Usage, HASH_TYPE_SHA384, HashData);
+  } else if ((AuthType == AUTH_TYPE_SIG_RSA2048_PKCSI1_SHA256) || (AuthType == AUTH_TYPE_SIG_RSA3072_PKCSI1_SHA384)) {
+    SignHdr  = (SIGNATURE_HDR *) AuthData;
+    KeyPtr   = (UINT8 *)SignHdr + sizeof(SIGNATURE_HDR) + SignHdr->SigSize ;
+    Status   = DoRsaDigestVerify (Digest, GetHashAlg(AuthType), Usage, SignHdr,
+                                  (PUB_KEY_HDR *) KeyPtr, GetHashAlg(AuthType), HashData);
+  } else {
+    Status = EFI_UNSUPPORTED;
+  }
+
+  return Status;
+}
+
+/**
+  Find a digest calculated while a container was read into memory.
+
+  @param[in] Data         Start of the hashed data.
+  @param[in] Length       Length of the hashed data.
+  @param[in] HashAlg      Hash algorithm.
+
+  @retval NULL            No digest was calculated for this data.
+  @retval Others          Pointer to the digest.
+
+**/
+STATIC
+UINT8 *
+FindStreamDigest (
+  IN  UINT8    *Data,
+  IN  UINT32    Length,
+  IN  UINT8     HashAlg
+  )
+{
+  CONTAINER_DIGEST_STREAM  *Stream;
+  STREAM_DIGEST_RANGE      *Range;
+  UINT32                    Index;
+
+  Stream = mDigestStream;
+  if (Stream == NULL) {
+    return NULL;
+  }
+
+  for (Index = 0; Index < Stream->Count; Index++) {
+    Range = &Stream->Range[Index];
+    if (Range->Valid && (Stream->Base + Range->Offset == Data) && (Range->Length == Length) && (Range->HashAlg == HashAlg)) {
+      // A digest authenticates its data once, a later request hashes it again
+      Range->Valid = FALSE;
+      return Range->Digest;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Collect the data ranges of a container that are authenticated by a digest.
+
+  The container header is not authenticated yet, so it is only used to find
+  the ranges. A digest is used later only for the exact range that the
+  container authentication asks for.
+
+  @param[in,out] Stream   The digest stream with a complete container header.
+
+**/
+STATIC
+VOID
+ParseStreamContainerHeader (
+  IN OUT CONTAINER_DIGEST_STREAM  *Stream
+  )
+{
+  CONTAINER_HDR            *ContainerHdr;
+  COMPONENT_ENTRY          *CompEntry;
+  STREAM_DIGEST_RANGE      *Range;
+  UINT8                    *HdrEnd;
+  UINT32                    DataOffset;
+  UINT32                    Index;
+
+  ContainerHdr = (CONTAINER_HDR *)Stream->Base;
+  DataOffset   = ContainerHdr->DataOffset;
+  HdrEnd       = Stream->Base + DataOffset;
+  CompEntry    = (COMPONENT_ENTRY *)&ContainerHdr[1];
+  for (Index = 0; Index < ContainerHdr->Count; Index++) {
+    if (((UINT8 *)(CompEntry + 1) > HdrEnd) || ((UINT8 *)(CompEntry + 1) + CompEntry->HashSize > HdrEnd)) {
+      break;
+    }
+
+    if ((ContainerHdr->Flags & CONTAINER_HDR_FLAG_MONO_SIGNING) != 0) {
+      // The last entry authenticates all the data in front of it
+      if ((Index == (UINT32)(ContainerHdr->Count - 1)) && (Index > 0) &&
+          (CompEntry->Offset > 0) && (CompEntry->Offset <= Stream->Size - DataOffset)) {
+        Range = &Stream->Range[0];
+        Range->Offset   = DataOffset;
+        Range->Length   = CompEntry->Offset;
+        Range->AuthType = CompEntry->AuthType;
+        Stream->Count   = 1;
+      }
+    } else if ((Stream->Count < ARRAY_SIZE (Stream->Range)) && (CompEntry->Offset < Stream->Size - DataOffset)) {
+      Range = &Stream->Range[Stream->Count];
+      Range->Offset   = DataOffset + CompEntry->Offset;
+      Range->Length   = 0;
+      Range->AuthType = CompEntry->AuthType;
+      Stream->Count++;
+    }
+
+    CompEntry = (COMPONENT_ENTRY *)((UINT8 *)(CompEntry + 1) + CompEntry->HashSize);
+  }
+
+  for (Index = 0; Index < Stream->Count; Index++) {
+    Range = &Stream->Range[Index];
+    Range->HashAlg = GetHashAlg (Range->AuthType);
+    Range->Failed  = !IsDigestAuthSupported (Range->AuthType);
+    if (!Range->Failed) {
+      if (Range->HashAlg == HASH_TYPE_SHA256) {
+        Range->Failed = RETURN_ERROR (Sha256Init (&Range->HashCtx, sizeof (Range->HashCtx)));
+      } else {
+        Range->Failed = RETURN_ERROR (Sha384Init (&Range->HashCtx, sizeof (Range->HashCtx)));
+      }
+    }
+  }
+
+  Stream->Parsed = TRUE;
+}
+
+/**
+  Start calculating the digests of a container while it is read into memory.
+
+  The container is expected to be read sequentially into ContainerBase. Each
+  time more data is available, ContainerDigestUpdate() hashes it. Once all
+  data is read, ContainerDigestFinish() makes the digests available to
+  RegisterContainer() and LoadComponent(), which then do not need to hash the
+  data again.
+
+  @param[in]  ContainerBase  Memory buffer the container is read into.
+  @param[in]  ContainerSize  Size of the container.
+  @param[out] Stream         Pointer to receive the digest stream handle.
+
+  @retval EFI_INVALID_PARAMETER    A parameter is NULL.
+  @retval EFI_UNSUPPORTED          Verified boot is disabled.
+  @retval EFI_OUT_OF_RESOURCES     The digest stream allocation failed.
+  @retval EFI_SUCCESS              The digest stream is ready.
+
+**/
+EFI_STATUS
+EFIAPI
+ContainerDigestStart (
+  IN  VOID      *ContainerBase,
+  IN  UINT32     ContainerSize,
+  OUT VOID     **Stream
+  )
+{
+  CONTAINER_DIGEST_STREAM  *DigestStream;
+
+  if ((ContainerBase == NULL) || (Stream == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  // The digests of a previous container cannot outlive the start of a new load
+  ContainerDigestDiscard (NULL);
+
+  if (!FeaturePcdGet (PcdVerifiedBootEnabled)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  DigestStream = AllocateZeroPool (sizeof (CONTAINER_DIGEST_STREAM));
+  if (DigestStream == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  DigestStream->Base = (UINT8 *)ContainerBase;
+  DigestStream->Size = ContainerSize;
+  *Stream = DigestStream;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Hash the container data that became available since the previous call.
+
+  It neither allocates memory nor prints debug messages, so it can run as a
+  CPU job on an AP while the next part of the container is being read.
+
+  @param[in] Stream      The digest stream handle.
+  @param[in] Available   Number of bytes of the container available so far.
+
+**/
+VOID
+EFIAPI
+ContainerDigestUpdate (
+  IN  VOID      *Stream,
+  IN  UINT32     Available
+  )
+{
+  CONTAINER_DIGEST_STREAM  *DigestStream;
+  STREAM_DIGEST_RANGE      *Range;
+  LOADER_COMPRESSED_HEADER *CompressHdr;
+  UINT32                    HashEnd;
+  UINT32                    Index;
+  RETURN_STATUS             Status;
+
+  DigestStream = (CONTAINER_DIGEST_STREAM *)Stream;
+  Available    = MIN (Available, DigestStream->Size);
+
+  if (!DigestStream->Parsed) {
+    if ((Available < sizeof (CONTAINER_HDR)) ||
+        (Available < ((CONTAINER_HDR *)DigestStream->Base)->DataOffset)) {
+      return;
+    }
+    ParseStreamContainerHeader (DigestStream);
+  }
+
+  for (Index = 0; Index < DigestStream->Count; Index++) {
+    Range = &DigestStream->Range[Index];
+    if (Range->Failed || (Available <= Range->Offset)) {
+      continue;
+    }
+
+    // The length of a component is known once its compressed header is read
+    if (Range->Length == 0) {
+      if (Available - Range->Offset < sizeof (LOADER_COMPRESSED_HEADER)) {
+        continue;
+      }
+      CompressHdr = (LOADER_COMPRESSED_HEADER *)(DigestStream->Base + Range->Offset);
+      if (!IS_COMPRESSED (CompressHdr) ||
+          (CompressHdr->CompressedSize > DigestStream->Size - Range->Offset - sizeof (LOADER_COMPRESSED_HEADER))) {
+        Range->Failed = TRUE;
+        continue;
+      }
+      Range->Length = sizeof (LOADER_COMPRESSED_HEADER) + CompressHdr->CompressedSize;
+    }
+
+    HashEnd = MIN (Range->Length, Available - Range->Offset);
+    if (HashEnd <= Range->Hashed) {
+      continue;
+    }
+    if (Range->HashAlg == HASH_TYPE_SHA256) {
+      Status = Sha256Update (&Range->HashCtx, DigestStream->Base + Range->Offset + Range->Hashed,
+                             HashEnd - Range->Hashed);
+    } else {
+      Status = Sha384Update (&Range->HashCtx, DigestStream->Base + Range->Offset + Range->Hashed,
+                             HashEnd - Range->Hashed);
+    }
+    Range->Failed = RETURN_ERROR (Status);
+    Range->Hashed = HashEnd;
+  }
+}
+
+/**
+  Complete the digests of a container read into memory.
+
+  When Publish is TRUE the digests of the completely hashed ranges replace the
+  ones of a previous container, and are used to authenticate this container
+  until it is unregistered. A digest that does not authenticate its range
+  never fails the authentication, the data is hashed again instead.
+
+  @param[in] Stream      The digest stream handle.
+  @param[in] Publish     TRUE to make the digests available, FALSE to discard
+                         them, such as when reading the container failed.
+
+**/
+VOID
+EFIAPI
+ContainerDigestFinish (
+  IN  VOID      *Stream,
+  IN  BOOLEAN    Publish
+  )
+{
+  CONTAINER_DIGEST_STREAM  *DigestStream;
+  STREAM_DIGEST_RANGE      *Range;
+  UINT32                    Index;
+  RETURN_STATUS             Status;
+
+  DigestStream = (CONTAINER_DIGEST_STREAM *)Stream;
+  if (DigestStream == NULL) {
+    return;
+  }
+
+  if (!Publish) {
+    FreePool (DigestStream);
+    ContainerDigestDiscard (NULL);
+    return;
+  }
+
+  for (Index = 0; Index < DigestStream->Count; Index++) {
+    Range = &DigestStream->Range[Index];
+    if (Range->Failed || (Range->Length == 0) || (Range->Hashed != Range->Length)) {
+      continue;
+    }
+    if (Range->HashAlg == HASH_TYPE_SHA256) {
+      Status = Sha256Final (&Range->HashCtx, Range->Digest);
+    } else {
+      Status = Sha384Final (&Range->HashCtx, Range->Digest);
+    }
+    Range->Valid = !RETURN_ERROR (Status);
+  }
+
+  ContainerDigestDiscard (NULL);
+  mDigestStream = DigestStream;
+}
+
+/**
+  Discard the digests calculated while a container was read into memory.
+
+  It must be called before the memory of a container read through
+  ContainerDigestStart() is released or reused, so that its digests never
+  authenticate other data.
+
+  @param[in] ContainerBase  Memory buffer the container was read into, or
+                            NULL to discard the digests of any container.
+
+**/
+VOID
+EFIAPI
+ContainerDigestDiscard (
+  IN  VOID      *ContainerBase
+  )
+{
+  if (mDigestStream == NULL) {
+    return;
+  }
+
+  if ((ContainerBase == NULL) || (mDigestStream->Base == (UINT8 *)ContainerBase)) {
+    FreePool (mDigestStream);
+    mDigestStream = NULL;
+  }
+}
+
 /**
   Return Containser Key Type based on its signature
 
@@ -382,6 +916,7 @@ AutheticateContainerInternal (
   LOADER_COMPRESSED_HEADER *CompressHdr;
   EFI_STATUS                Status;
   COMPONENT_CALLBACK_INFO   CbInfo;
+  UINT8                    *Digest;
 
   // Find authentication data offset and authenticate the container header
   Status = EFI_UNSUPPORTED;
@@ -430,8 +965,16 @@ AutheticateContainerInternal (
         AuthData = CompData + ALIGN_UP(SignedDataLen, AUTH_DATA_ALIGN);
         DataBuf  = (UINT8 *)(UINTN)(ContainerEntry->Base + ContainerHdr->DataOffset);
         DataLen  = CompEntry->Offset;
-        Status   = AuthenticateComponent (DataBuf, DataLen, CompEntry->AuthType,
+        Status   = EFI_SECURITY_VIOLATION;
+        Digest   = FindStreamDigest (DataBuf, DataLen, GetHashAlg (CompEntry->AuthType));
+        if ((Digest != NULL) && IsDigestAuthSupported (CompEntry->AuthType)) {
+          Status = AuthenticateComponentDigest (Digest, CompEntry->AuthType,
+                                                AuthData, CompEntry->HashData, 0);
+        }
+        if (EFI_ERROR (Status)) {
+          Status = AuthenticateComponent (DataBuf, DataLen, CompEntry->AuthType,
                                           AuthData, CompEntry->HashData, 0);
+        }
 
         if ((!EFI_ERROR(Status)) && (ContainerCallback != NULL)) {
           // Update component Call back info after authenticaton is done
@@ -689,29 +1232,25 @@ LocateComponent (
 }
 
 /**
-  Load a component from a container or flahs map to memory and call callback
-  function at predefined point.
+  Locate a component, parse its compression header and allocate the
+  temporary buffers needed to load it.
 
   @param[in]     ContainerSig    Container signature or component type.
-  @param[in]     ComponentName   Component name.
-  @param[in,out] Buffer          Pointer to receive component base.
-  @param[in,out] Length          Pointer to receive component size.
-  @param[in,out] LoadComponentCallback  Callback function pointer.
+  @param[in,out] Context         Load context of the component.
+  @param[in]     LoadComponentCallback  Callback function pointer.
 
-  @retval EFI_UNSUPPORTED          Unsupported AuthType.
+  @retval EFI_UNSUPPORTED          Unsupported AuthType or component format.
   @retval EFI_NOT_FOUND            Cannot locate component.
   @retval EFI_BUFFER_TOO_SMALL     Specified buffer size is too small.
-  @retval EFI_SECURITY_VIOLATION   Authentication failed.
-  @retval EFI_SUCCESS              Authentication succeeded.
+  @retval EFI_OUT_OF_RESOURCES     Temporary buffer allocation failed.
+  @retval EFI_SUCCESS              The component is ready to be copied.
 
 **/
+STATIC
 EFI_STATUS
-EFIAPI
-LoadComponentWithCallback (
+PrepareComponentLoad (
   IN     UINT32                   ContainerSig,
-  IN     UINT32                   ComponentName,
-  IN OUT VOID                   **Buffer,
-  IN OUT UINT32                  *Length,
+  IN OUT COMPONENT_LOAD_CONTEXT  *Context,
   IN     LOAD_COMPONENT_CALLBACK  LoadComponentCallback
   )
 {
@@ -720,29 +1259,20 @@ LoadComponentWithCallback (
   CONTAINER_HDR            *ContainerHdr;
   CONTAINER_ENTRY          *ContainerEntry;
   COMPONENT_ENTRY          *CompEntry;
-  UINT8                    *CompData;
-  UINT8                    *CompBuf;
-  UINT8                    *HashData;
-  VOID                     *CompBase;
-  VOID                     *ScrBuf;
-  VOID                     *AllocBuf;
-  VOID                     *ReqCompBase;
-  UINT32                    Usage;
-  UINT8                     AuthType;
-  UINT32                    DecompressedLen;
+  COMPONENT_LOAD_REQUEST   *Request;
+  UINT32                    ComponentName;
   UINT32                    CompLen;
   UINT32                    CompLoc;
   UINT32                    AllocLen;
-  UINT32                    SignedDataLen;
   UINT32                    DstLen;
   UINT32                    ScrLen;
-  BOOLEAN                   IsInFlash;
-  COMPONENT_CALLBACK_INFO   CbInfo;
-  UINT32                    ComponentId;
   UINT64                    ContainerIdBuf;
   UINT64                    ComponentIdBuf;
+  UINT8                    *Digest;
 
-  ComponentId = ContainerSig;
+  Request       = Context->Request;
+  ComponentName = Request->ComponentName;
+  Context->ComponentId = ContainerSig;
   CompLoc = 0;
 
   ComponentIdBuf = ComponentName;
@@ -755,25 +1285,24 @@ LoadComponentWithCallback (
 
   if (ContainerSig < COMP_TYPE_INVALID) {
     // Check if it is component type
-    Usage        =  1 << ContainerSig;
-    ContainerSig = 0;
+    Context->Usage = 1 << ContainerSig;
     Status = GetComponentInfo (ComponentName, &CompLoc, &CompLen);
     if (EFI_ERROR (Status)) {
       return EFI_NOT_FOUND;
     }
-    CompData = (VOID *)(UINTN)CompLoc;
+    Context->CompData = (VOID *)(UINTN)CompLoc;
     if (FeaturePcdGet (PcdVerifiedBootEnabled)) {
       if(FixedPcdGet8(PcdCompSignHashAlg) == HASH_TYPE_SHA256) {
-        AuthType = AUTH_TYPE_SHA2_256;
+        Context->AuthType = AUTH_TYPE_SHA2_256;
       } else if (FixedPcdGet8(PcdCompSignHashAlg) == HASH_TYPE_SHA384) {
-        AuthType = AUTH_TYPE_SHA2_384;
+        Context->AuthType = AUTH_TYPE_SHA2_384;
       } else {
         return EFI_UNSUPPORTED;
       }
     } else {
-      AuthType = AUTH_TYPE_NONE;
+      Context->AuthType = AUTH_TYPE_NONE;
     }
-    HashData = NULL;
+    Context->HashData = NULL;
   } else {
     // Find the component info
     Status = LocateComponentEntry (ContainerSig, ComponentName, &ContainerEntry, &CompEntry);
@@ -791,11 +1320,11 @@ LoadComponentWithCallback (
 
     // Collect component info
     ContainerHdr = (CONTAINER_HDR *)(UINTN)ContainerEntry->HeaderCache;
-    AuthType  = CompEntry->AuthType;
-    HashData  = CompEntry->HashData;
-    Usage     = 0;
-    CompData  = (UINT8 *)(UINTN)(ContainerEntry->Base + ContainerHdr->DataOffset + CompEntry->Offset);
-    CompLen   = CompEntry->Size;
+    Context->AuthType = CompEntry->AuthType;
+    Context->HashData = CompEntry->HashData;
+    Context->Usage    = 0;
+    Context->CompData = (UINT8 *)(UINTN)(ContainerEntry->Base + ContainerHdr->DataOffset + CompEntry->Offset);
+    CompLen           = CompEntry->Size;
   }
 
   if (LoadComponentCallback != NULL) {
@@ -804,19 +1333,19 @@ LoadComponentWithCallback (
 
   // Component must have LOADER_COMPRESSED_HEADER
   Status = EFI_UNSUPPORTED;
-  CompressHdr  = (LOADER_COMPRESSED_HEADER *)CompData;
+  CompressHdr  = (LOADER_COMPRESSED_HEADER *)Context->CompData;
   if (CompressHdr == NULL) {
     return EFI_NOT_FOUND;
   }
 
   if (IS_COMPRESSED (CompressHdr)) {
-    SignedDataLen = sizeof (LOADER_COMPRESSED_HEADER) + CompressHdr->CompressedSize;
+    Context->SignedDataLen = sizeof (LOADER_COMPRESSED_HEADER) + CompressHdr->CompressedSize;
     if (CompressHdr->Size == 0) {
       Status = EFI_SUCCESS;
       DstLen = 0;
       ScrLen = 0;
     } else {
-      if (SignedDataLen <= CompLen) {
+      if (Context->SignedDataLen <= CompLen) {
         Status = DecompressGetInfo (CompressHdr->Signature, CompressHdr->Data,
                                     CompressHdr->CompressedSize, &DstLen, &ScrLen);
       }
@@ -827,94 +1356,367 @@ LoadComponentWithCallback (
   }
 
   // If it is required to use an existing buffer, verify the size
-  ReqCompBase = NULL;
-  DecompressedLen = CompressHdr->Size;
-  if ((Buffer != NULL) && (*Buffer != NULL)) {
-    ReqCompBase = *Buffer;
-    if ((Length != NULL) && (*Length != 0) && (*Length < DecompressedLen)) {
+  Context->ReqCompBase     = Request->Buffer;
+  Context->DecompressedLen = CompressHdr->Size;
+  if (Context->ReqCompBase != NULL) {
+    if ((Request->Length != 0) && (Request->Length < Context->DecompressedLen)) {
       return EFI_BUFFER_TOO_SMALL;
     }
   }
 
   // If it is on flash, the data needs to be copied into memory first
   // before authentication for security concern.
-  IsInFlash = IS_FLASH_ADDRESS (CompData);
+  Context->IsInFlash = IS_FLASH_ADDRESS (Context->CompData);
   AllocLen  = ScrLen + TEMP_BUF_ALIGN * 2;
-  if (IsInFlash) {
-    AllocLen += SignedDataLen;
+  if (Context->IsInFlash) {
+    AllocLen += Context->SignedDataLen;
   }
-  AllocBuf = AllocateTemporaryMemory (AllocLen);
-  if (AllocBuf == NULL) {
+  Context->AllocBuf = AllocateTemporaryMemory (AllocLen);
+  if (Context->AllocBuf == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
-  if (IsInFlash) {
-    // Authenticate component and decompress it if required
-    CompBuf = AllocBuf;
-    ScrBuf  = (UINT8 *)AllocBuf + ALIGN_UP (SignedDataLen, TEMP_BUF_ALIGN);
-    CopyMem (CompBuf, CompData, SignedDataLen);
-    if (LoadComponentCallback != NULL) {
-      LoadComponentCallback (PROGESS_ID_COPY, NULL);
-    }
+  if (Context->IsInFlash) {
+    Context->CompBuf = Context->AllocBuf;
+    Context->ScrBuf  = (UINT8 *)Context->AllocBuf + ALIGN_UP (Context->SignedDataLen, TEMP_BUF_ALIGN);
   } else {
-    CompBuf = CompData;
-    ScrBuf  = AllocBuf;
+    Context->CompBuf = Context->CompData;
+    Context->ScrBuf  = Context->AllocBuf;
+  }
+
+  // The hash can be accumulated over each chunk of the memory copy as it is
+  // copied, so that only the digest check is left for the authentication
+  // phase. Decompression still waits for the result.
+  Context->IsStreamAuth = IsStreamAuthSupported (Context->AuthType);
+
+  // A component in memory might have been hashed already while its container
+  // was read, so that only the digest check is left.
+  if (!Context->IsInFlash && IsDigestAuthSupported (Context->AuthType)) {
+    Digest = FindStreamDigest (Context->CompData, Context->SignedDataLen, GetHashAlg (Context->AuthType));
+    if (Digest != NULL) {
+      CopyMem (Context->Digest, Digest, sizeof (Context->Digest));
+      Context->IsStreamAuth = TRUE;
+      Context->IsPreHashed  = TRUE;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  CPU job to copy a component into memory and hash it when possible.
+
+  @param[in] Arg     Pointer to the COMPONENT_LOAD_CONTEXT of the component.
+
+  @retval  The EFI_STATUS of the copy.
+
+**/
+STATIC
+UINT64
+EFIAPI
+CopyComponentJob (
+  IN  UINT64   Arg
+  )
+{
+  COMPONENT_LOAD_CONTEXT   *Context;
+
+  Context = (COMPONENT_LOAD_CONTEXT *)(UINTN)Arg;
+  if (Context->IsPreHashed) {
+    return EFI_SUCCESS;
+  }
+
+  if (Context->IsStreamAuth) {
+    return CopyAndHashComponent (Context->CompBuf, Context->CompData, Context->SignedDataLen,
+                                 GetHashAlg (Context->AuthType), Context->Digest);
+  }
+
+  if (Context->IsInFlash) {
+    CopyMem (Context->CompBuf, Context->CompData, Context->SignedDataLen);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Authenticate a copied component and allocate its decompression buffer.
+
+  @param[in,out] Context         Load context of the component.
+  @param[in]     CopyStatus      Status returned by CopyComponentJob.
+  @param[in]     LoadComponentCallback  Callback function pointer.
+
+  @retval EFI_SECURITY_VIOLATION   Authentication failed.
+  @retval EFI_BAD_BUFFER_SIZE      The component is empty.
+  @retval EFI_OUT_OF_RESOURCES     Decompression buffer allocation failed.
+  @retval EFI_SUCCESS              The component is ready to be decompressed.
+
+**/
+STATIC
+EFI_STATUS
+AuthenticateLoadedComponent (
+  IN OUT COMPONENT_LOAD_CONTEXT  *Context,
+  IN     EFI_STATUS               CopyStatus,
+  IN     LOAD_COMPONENT_CALLBACK  LoadComponentCallback
+  )
+{
+  EFI_STATUS                Status;
+  UINT8                    *AuthData;
+  COMPONENT_CALLBACK_INFO   CbInfo;
+
+  if (Context->IsInFlash && (LoadComponentCallback != NULL)) {
+    LoadComponentCallback (PROGESS_ID_COPY, NULL);
   }
 
   // Verify the component
-  Status = AuthenticateComponent (CompBuf, SignedDataLen, AuthType,
-             CompData + ALIGN_UP(SignedDataLen, AUTH_DATA_ALIGN),  HashData, Usage);
+  AuthData = Context->CompData + ALIGN_UP (Context->SignedDataLen, AUTH_DATA_ALIGN);
+  if (Context->IsStreamAuth) {
+    Status = CopyStatus;
+    if (!EFI_ERROR (Status)) {
+      Status = AuthenticateComponentDigest (Context->Digest, Context->AuthType,
+                 AuthData, Context->HashData, Context->Usage);
+    }
+    if (EFI_ERROR (Status) && Context->IsPreHashed) {
+      // The digest might be from a previous container at the same address
+      Status = AuthenticateComponent (Context->CompBuf, Context->SignedDataLen, Context->AuthType,
+                 AuthData, Context->HashData, Context->Usage);
+    }
+  } else {
+    Status = AuthenticateComponent (Context->CompBuf, Context->SignedDataLen, Context->AuthType,
+               AuthData, Context->HashData, Context->Usage);
+  }
   if (LoadComponentCallback != NULL) {
     if(Status == EFI_SUCCESS){
       // Update component Call back info after authenticaton is done
       // This info will used by firmware stage to extend to TPM
-      CbInfo.ComponentType    = ComponentId;
-      CbInfo.CompBuf          = CompBuf;
-      CbInfo.CompLen          = SignedDataLen;
-      CbInfo.HashAlg          = GetHashAlg(AuthType);
-      CbInfo.HashData         = HashData;
+      CbInfo.ComponentType    = Context->ComponentId;
+      CbInfo.CompBuf          = Context->CompBuf;
+      CbInfo.CompLen          = Context->SignedDataLen;
+      CbInfo.HashAlg          = GetHashAlg(Context->AuthType);
+      CbInfo.HashData         = Context->HashData;
       LoadComponentCallback (PROGESS_ID_AUTHENTICATE, &CbInfo);
     } else {
       LoadComponentCallback (PROGESS_ID_AUTHENTICATE, NULL);
     }
   }
-  if (!EFI_ERROR (Status)) {
-    CompressHdr = (LOADER_COMPRESSED_HEADER *)CompBuf;
-    if (ReqCompBase == NULL) {
-      CompBase = AllocatePages (EFI_SIZE_TO_PAGES ((UINTN) DecompressedLen));
+  if (EFI_ERROR (Status)) {
+    return EFI_SECURITY_VIOLATION;
+  }
+
+  if (Context->ReqCompBase == NULL) {
+    Context->CompBase = AllocatePages (EFI_SIZE_TO_PAGES ((UINTN) Context->DecompressedLen));
+  } else {
+    Context->CompBase = Context->ReqCompBase;
+  }
+
+  if (Context->CompBase == NULL) {
+    if (Context->DecompressedLen == 0) {
+      return EFI_BAD_BUFFER_SIZE;
     } else {
-      CompBase = ReqCompBase;
+      return EFI_OUT_OF_RESOURCES;
     }
+  }
 
-    if (CompBase != NULL) {
-      Status = Decompress (CompressHdr->Signature, CompressHdr->Data, CompressHdr->CompressedSize,
-                           CompBase, ScrBuf);
-      if (LoadComponentCallback != NULL) {
-        LoadComponentCallback (PROGESS_ID_DECOMPRESS, NULL);
-      }
-      if (EFI_ERROR (Status)) {
-        if (ReqCompBase == NULL) {
-          FreePages (CompBase, EFI_SIZE_TO_PAGES ((UINTN) DecompressedLen));
-        }
+  return EFI_SUCCESS;
+}
+
+/**
+  CPU job to decompress an authenticated component.
+
+  @param[in] Arg     Pointer to the COMPONENT_LOAD_CONTEXT of the component.
+
+  @retval  The EFI_STATUS of the decompression.
+
+**/
+STATIC
+UINT64
+EFIAPI
+DecompressComponentJob (
+  IN  UINT64   Arg
+  )
+{
+  COMPONENT_LOAD_CONTEXT   *Context;
+  LOADER_COMPRESSED_HEADER *CompressHdr;
+
+  Context     = (COMPONENT_LOAD_CONTEXT *)(UINTN)Arg;
+  CompressHdr = (LOADER_COMPRESSED_HEADER *)Context->CompBuf;
+
+  return Decompress (CompressHdr->Signature, CompressHdr->Data, CompressHdr->CompressedSize,
+                     Context->CompBase, Context->ScrBuf);
+}
+
+/**
+  Load a list of components from a container or flash map to memory and call
+  callback function at predefined point.
+
+  The components are located and authenticated on the calling processor, in
+  the order of the list. Copying and hashing, and then decompression, of all
+  components are run as CPU jobs, so that they are spread over the BSP and
+  the APs waiting for tasks in SysCpuTask.
+
+  A failure to load one component does not stop the others from loading.
+
+  @param[in]     ContainerSig    Container signature or component type.
+  @param[in,out] Request         Components to load. On input Buffer and Length
+                                 optionally give the buffer to load into, as
+                                 for LoadComponentWithCallback(). On output
+                                 Status holds the result of each component, and
+                                 Buffer and Length the loaded component when it
+                                 succeeded.
+  @param[in]     RequestCount    Number of components to load.
+  @param[in]     LoadComponentCallback  Callback function pointer.
+  @param[in]     SysCpuTask      The CPU task table of the APs waiting for
+                                 tasks, or NULL to load on the BSP only.
+
+  @retval EFI_INVALID_PARAMETER    Request is NULL.
+  @retval EFI_OUT_OF_RESOURCES     Load context allocation failed.
+  @retval EFI_SUCCESS              All components were loaded successfully.
+  @retval Others                   Status of the first component that failed.
+
+**/
+EFI_STATUS
+EFIAPI
+LoadComponentList (
+  IN     UINT32                   ContainerSig,
+  IN OUT COMPONENT_LOAD_REQUEST  *Request,
+  IN     UINT32                   RequestCount,
+  IN     LOAD_COMPONENT_CALLBACK  LoadComponentCallback,
+  IN     SYS_CPU_TASK            *SysCpuTask  OPTIONAL
+  )
+{
+  EFI_STATUS                Status;
+  COMPONENT_LOAD_CONTEXT   *Context;
+  CPU_JOB                  *Jobs;
+  VOID                     *TempBuf;
+  UINT32                    JobCount;
+  UINT32                    JobIdx;
+  UINT32                    Index;
+
+  if ((Request == NULL) || (RequestCount == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  TempBuf = AllocateTemporaryMemory (RequestCount * (sizeof (COMPONENT_LOAD_CONTEXT) + sizeof (CPU_JOB)));
+  if (TempBuf == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  ZeroMem (TempBuf, RequestCount * (sizeof (COMPONENT_LOAD_CONTEXT) + sizeof (CPU_JOB)));
+  Context = (COMPONENT_LOAD_CONTEXT *)TempBuf;
+  Jobs    = (CPU_JOB *)&Context[RequestCount];
+
+  for (Index = 0; Index < RequestCount; Index++) {
+    Context[Index].Request = &Request[Index];
+    Request[Index].Status  = PrepareComponentLoad (ContainerSig, &Context[Index], LoadComponentCallback);
+  }
+
+  // Copy and hash
+  JobCount = 0;
+  for (Index = 0; Index < RequestCount; Index++) {
+    if (!EFI_ERROR (Request[Index].Status)) {
+      Jobs[JobCount].Func     = CopyComponentJob;
+      Jobs[JobCount].Argument = (UINT64)(UINTN)&Context[Index];
+      JobCount++;
+    }
+  }
+  ScheduleCpuJobs (SysCpuTask, Jobs, JobCount);
+
+  JobIdx = 0;
+  for (Index = 0; Index < RequestCount; Index++) {
+    if (!EFI_ERROR (Request[Index].Status)) {
+      Request[Index].Status = AuthenticateLoadedComponent (&Context[Index],
+                                (EFI_STATUS)Jobs[JobIdx].Result, LoadComponentCallback);
+      JobIdx++;
+    }
+  }
+
+  // Decompress
+  JobCount = 0;
+  for (Index = 0; Index < RequestCount; Index++) {
+    if (!EFI_ERROR (Request[Index].Status)) {
+      Jobs[JobCount].Func     = DecompressComponentJob;
+      Jobs[JobCount].Argument = (UINT64)(UINTN)&Context[Index];
+      JobCount++;
+    }
+  }
+  ScheduleCpuJobs (SysCpuTask, Jobs, JobCount);
+
+  JobIdx = 0;
+  for (Index = 0; Index < RequestCount; Index++) {
+    if (EFI_ERROR (Request[Index].Status)) {
+      continue;
+    }
+    Request[Index].Status = (EFI_STATUS)Jobs[JobIdx].Result;
+    JobIdx++;
+    if (LoadComponentCallback != NULL) {
+      LoadComponentCallback (PROGESS_ID_DECOMPRESS, NULL);
+    }
+    if (EFI_ERROR (Request[Index].Status)) {
+      if (Context[Index].ReqCompBase == NULL) {
+        FreePages (Context[Index].CompBase, EFI_SIZE_TO_PAGES ((UINTN) Context[Index].DecompressedLen));
       }
     } else {
-      if (CompressHdr->Size == 0) {
-        Status = EFI_BAD_BUFFER_SIZE;
-      } else {
-        Status = EFI_OUT_OF_RESOURCES;
-      }
+      Request[Index].Buffer = Context[Index].CompBase;
+      Request[Index].Length = Context[Index].DecompressedLen;
+    }
+  }
+
+  // Free the temporary buffers in the reverse order of allocation
+  for (Index = RequestCount; Index > 0; Index--) {
+    if (Context[Index - 1].AllocBuf != NULL) {
+      FreeTemporaryMemory (Context[Index - 1].AllocBuf);
     }
+  }
+  FreeTemporaryMemory (TempBuf);
 
-  } else {
-    Status = EFI_SECURITY_VIOLATION;
+  Status = EFI_SUCCESS;
+  for (Index = 0; Index < RequestCount; Index++) {
+    if (EFI_ERROR (Request[Index].Status)) {
+      Status = Request[Index].Status;
+      break;
+    }
   }
-  FreeTemporaryMemory (AllocBuf);
 
+  return Status;
+}
+
+/**
+  Load a component from a container or flahs map to memory and call callback
+  function at predefined point.
+
+  @param[in]     ContainerSig    Container signature or component type.
+  @param[in]     ComponentName   Component name.
+  @param[in,out] Buffer          Pointer to receive component base.
+  @param[in,out] Length          Pointer to receive component size.
+  @param[in,out] LoadComponentCallback  Callback function pointer.
+
+  @retval EFI_UNSUPPORTED          Unsupported AuthType.
+  @retval EFI_NOT_FOUND            Cannot locate component.
+  @retval EFI_BUFFER_TOO_SMALL     Specified buffer size is too small.
+  @retval EFI_SECURITY_VIOLATION   Authentication failed.
+  @retval EFI_SUCCESS              Authentication succeeded.
+
+**/
+EFI_STATUS
+EFIAPI
+LoadComponentWithCallback (
+  IN     UINT32                   ContainerSig,
+  IN     UINT32                   ComponentName,
+  IN OUT VOID                   **Buffer,
+  IN OUT UINT32                  *Length,
+  IN     LOAD_COMPONENT_CALLBACK  LoadComponentCallback
+  )
+{
+  EFI_STATUS                Status;
+  COMPONENT_LOAD_REQUEST    Request;
+
+  Request.ComponentName = ComponentName;
+  Request.Buffer        = (Buffer != NULL) ? *Buffer : NULL;
+  Request.Length        = (Length != NULL) ? *Length : 0;
+
+  Status = LoadComponentList (ContainerSig, &Request, 1, LoadComponentCallback, NULL);
   if (!EFI_ERROR (Status)) {
     if (Buffer != NULL) {
-      *Buffer = CompBase;
+      *Buffer = Request.Buffer;
     }
     if (Length != NULL) {
-      *Length = DecompressedLen;
+      *Length = Request.Length;
     }
   }
 
@@ -1,72 +1,156 @@
 /** @file
 CalcuateCrc32 routine.
 
-Copyright (c) 2004 - 2017, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2004 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
 
-#include <Library/Crc32Lib.h>
+#include "Crc32LibInternal.h"
+#include <Register/Intel/Cpuid.h>
 
-UINT32  mCrc32Table[256];
-UINT32  mCrc32CastagnoliTable[256];
+/**
+  Get the CPU features used to select an accelerated CRC32 routine.
+
+  The features are detected on every call, as the library also runs XIP
+  where a global cannot be written.
+
+  @retval  A combination of CRC32_CPU_FEATURE_xxx flags.
+**/
+STATIC
+UINT32
+Crc32GetCpuFeatures (
+  VOID
+  )
+{
+  UINT32                  Features;
+  CPUID_VERSION_INFO_ECX  VersionEcx;
+
+  Features = 0;
+
+#if defined (MDE_CPU_IA32) || defined (MDE_CPU_X64)
+  AsmCpuid (CPUID_VERSION_INFO, NULL, NULL, &VersionEcx.Uint32, NULL);
+
+  //
+  // The PCLMULQDQ routine also extracts the result with the SSE4.1 pextrd
+  //
+  if ((VersionEcx.Bits.PCLMULQDQ != 0) && (VersionEcx.Bits.SSE4_1 != 0)) {
+    Features |= CRC32_CPU_FEATURE_PCLMULQDQ;
+  }
+
+  if (VersionEcx.Bits.SSE4_2 != 0) {
+    Features |= CRC32_CPU_FEATURE_SSE42;
+  }
+#else
+  (VOID)VersionEcx;
+#endif
+
+  return Features;
+}
 
 /**
-  This internal function reverses bits for 32bit data.
-  @param  Value                 The data to be reversed.
-  @return                       Data reversed.
+  Update a reflected CRC32 over a buffer using slice-by-8 table lookups.
+
+  @param[in]  Crc        The running CRC value.
+  @param[in]  Buffer     The data to process.
+  @param[in]  Length     The size of Buffer in bytes.
+  @param[in]  CrcTable   The slice-by-8 tables of the polynomial.
+
+  @retval  The updated CRC value.
 **/
+STATIC
 UINT32
-ReverseBits (
-  UINT32  Value
+Crc32SliceBy8 (
+  IN  UINT32        Crc,
+  IN  CONST UINT8  *Buffer,
+  IN  UINTN         Length,
+  IN  CONST UINT32  CrcTable[8][256]
   )
 {
-  UINTN   Index;
-  UINT32  NewValue;
-
-  NewValue = 0;
-  for (Index = 0; Index < 32; Index++) {
-    if ((Value & (1 << Index)) != 0) {
-      NewValue = NewValue | (1 << (31 - Index));
-    }
+  UINT32  Low;
+  UINT32  High;
+
+  //
+  // Process single bytes until the buffer is 8-byte aligned
+  //
+  while ((Length > 0) && (((UINTN)Buffer & 7) != 0)) {
+    Crc = (Crc >> 8) ^ CrcTable[0][(UINT8)Crc ^ *Buffer];
+    Buffer++;
+    Length--;
   }
 
-  return NewValue;
+  //
+  // The two 32-bit loads rely on the little-endian byte order of IA32/X64
+  //
+  while (Length >= 8) {
+    Low  = *(CONST UINT32 *)Buffer ^ Crc;
+    High = *(CONST UINT32 *)(Buffer + 4);
+    Crc  = CrcTable[7][Low & 0xFF] ^
+           CrcTable[6][(Low >> 8) & 0xFF] ^
+           CrcTable[5][(Low >> 16) & 0xFF] ^
+           CrcTable[4][Low >> 24] ^
+           CrcTable[3][High & 0xFF] ^
+           CrcTable[2][(High >> 8) & 0xFF] ^
+           CrcTable[1][(High >> 16) & 0xFF] ^
+           CrcTable[0][High >> 24];
+    Buffer += 8;
+    Length -= 8;
+  }
+
+  while (Length > 0) {
+    Crc = (Crc >> 8) ^ CrcTable[0][(UINT8)Crc ^ *Buffer];
+    Buffer++;
+    Length--;
+  }
+
+  return Crc;
 }
 
 /**
-  Initialize CRC32 table.
-  @param Type       Tpye of the polynomial to be used
-  @param CrcTable   Pointer to the CRC table.
+  Update a reflected CRC32 over a buffer, using the fastest routine supported
+  by the CPU.
+
+  @param[in]  Crc        The running CRC value.
+  @param[in]  Buffer     The data to process.
+  @param[in]  Length     The size of Buffer in bytes.
+  @param[in]  Type       Which polynomial should be used, default or Castagnoli
+
+  @retval  The updated CRC value.
 **/
-VOID
-RuntimeDriverInitializeCrc32Table (
-  IN     CRC32_TYPE  Type,
-  IN OUT UINT32      *CrcTable
+STATIC
+UINT32
+Crc32Update (
+  IN  UINT32        Crc,
+  IN  CONST UINT8  *Buffer,
+  IN  UINTN         Length,
+  IN  CRC32_TYPE    Type
   )
 {
-  UINTN   TableEntry;
-  UINTN   Index;
-  UINT32  Value;
-  UINT32  Polynomial;
+#if defined (MDE_CPU_IA32) || defined (MDE_CPU_X64)
+  UINTN   HeadSize;
+  UINTN   FoldSize;
+  UINT32  Features;
+
+  Features = 0;
+  if (Length >= CRC32_SIMD_MIN_SIZE) {
+    Features = Crc32GetCpuFeatures ();
+  }
 
-  if (Type == Crc32TypeCastagnoli) {
-    Polynomial = 0x1EDC6F41;
-  } else {
-    Polynomial = 0x04C11DB7;
+  if ((Type == Crc32TypeCastagnoli) && ((Features & CRC32_CPU_FEATURE_SSE42) != 0)) {
+    return InternalCrc32cSse42 (Crc, Buffer, Length);
   }
 
-  for (TableEntry = 0; TableEntry < 256; TableEntry++) {
-    Value = ReverseBits ((UINT32) TableEntry);
-    for (Index = 0; Index < 8; Index++) {
-      if ((Value & 0x80000000) != 0) {
-        Value = (Value << 1) ^ Polynomial;
-      } else {
-        Value = Value << 1;
-      }
-    }
-    CrcTable[TableEntry] = ReverseBits (Value);
+  if ((Type != Crc32TypeCastagnoli) && ((Features & CRC32_CPU_FEATURE_PCLMULQDQ) != 0)) {
+    HeadSize = (CRC32_PCLMUL_ALIGNMENT - ((UINTN)Buffer & (CRC32_PCLMUL_ALIGNMENT - 1))) & (CRC32_PCLMUL_ALIGNMENT - 1);
+    FoldSize = (Length - HeadSize) & ~(UINTN)(CRC32_PCLMUL_ALIGNMENT - 1);
+
+    Crc = Crc32SliceBy8 (Crc, Buffer, HeadSize, mCrc32Table);
+    Crc = InternalCrc32Pclmul (Crc, Buffer + HeadSize, FoldSize);
+    return Crc32SliceBy8 (Crc, Buffer + HeadSize + FoldSize, Length - HeadSize - FoldSize, mCrc32Table);
   }
+#endif
+
+  return Crc32SliceBy8 (Crc, Buffer, Length, (Type == Crc32TypeCastagnoli) ? mCrc32CastagnoliTable : mCrc32Table);
 }
 
 /**
@@ -92,30 +176,12 @@ CalculateCrc32WithType (
 
 {
   UINT32  Crc;
-  UINTN   Index;
-  UINT32  *CrcTable;
-  UINT8   *Ptr;
-
-  if (Type == Crc32TypeCastagnoli) {
-    if (mCrc32CastagnoliTable[1] == 0) {
-      RuntimeDriverInitializeCrc32Table (Type, mCrc32CastagnoliTable);
-    }
-    CrcTable = mCrc32CastagnoliTable;
-  } else {
-    if (mCrc32Table[1] == 0) {
-      RuntimeDriverInitializeCrc32Table (Type, mCrc32Table);
-    }
-    CrcTable = mCrc32Table;
-  }
 
   if ((DataSize == 0) || (Data == NULL) || (CrcOut == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
 
-  Crc = 0xFFFFFFFF;
-  for (Index = 0, Ptr = Data; Index < DataSize; Index++, Ptr++) {
-    Crc = (Crc >> 8) ^ CrcTable[ (UINT8) Crc ^ *Ptr];
-  }
+  Crc = Crc32Update (0xFFFFFFFF, Data, DataSize, Type);
 
   if (Type == Crc32TypeCastagnoli) {
     *CrcOut = Crc;
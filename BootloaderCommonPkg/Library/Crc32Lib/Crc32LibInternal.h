@@ -0,0 +1,80 @@
+/** @file
+  Internal definitions of the CRC32 library.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _CRC32_LIB_INTERNAL_H_
+#define _CRC32_LIB_INTERNAL_H_
+
+#include <Library/Crc32Lib.h>
+#include <Library/BaseLib.h>
+
+//
+// CPU features used to select the CRC32 routine
+//
+#define CRC32_CPU_FEATURE_PCLMULQDQ     BIT0
+#define CRC32_CPU_FEATURE_SSE42         BIT1
+
+//
+// The carry-less multiplication routine folds four 16-byte lanes at a time.
+// Shorter buffers, and the unaligned head and the tail of longer ones, are
+// handled by the slice-by-8 routine.
+//
+#define CRC32_PCLMUL_ALIGNMENT          16
+#define CRC32_PCLMUL_MIN_SIZE           64
+
+//
+// The CPU features are detected on every call, which costs more than the
+// slice-by-8 routine takes for a short buffer. Below this size the feature
+// check is skipped.
+//
+#define CRC32_SIMD_MIN_SIZE             1024
+
+extern CONST UINT32  mCrc32Table[8][256];
+extern CONST UINT32  mCrc32CastagnoliTable[8][256];
+
+/**
+  Update a reflected CRC32 over a buffer using carry-less multiplication.
+
+  The polynomial is fixed to 0x04C11DB7. The caller must check that the CPU
+  supports PCLMULQDQ and SSE4.1.
+
+  @param[in]  Crc        The running CRC value.
+  @param[in]  Buffer     The data to process, aligned on CRC32_PCLMUL_ALIGNMENT.
+  @param[in]  Length     The size of Buffer in bytes. It must be a multiple of
+                         16 and no less than CRC32_PCLMUL_MIN_SIZE.
+
+  @retval  The updated CRC value.
+**/
+UINT32
+EFIAPI
+InternalCrc32Pclmul (
+  IN  UINT32        Crc,
+  IN  CONST UINT8  *Buffer,
+  IN  UINTN         Length
+  );
+
+/**
+  Update a reflected CRC32 over a buffer using the SSE4.2 crc32 instruction.
+
+  The polynomial is fixed to 0x1EDC6F41 (Castagnoli). The caller must check
+  that the CPU supports SSE4.2.
+
+  @param[in]  Crc        The running CRC value.
+  @param[in]  Buffer     The data to process.
+  @param[in]  Length     The size of Buffer in bytes.
+
+  @retval  The updated CRC value.
+**/
+UINT32
+EFIAPI
+InternalCrc32cSse42 (
+  IN  UINT32        Crc,
+  IN  CONST UINT8  *Buffer,
+  IN  UINTN         Length
+  );
+
+#endif
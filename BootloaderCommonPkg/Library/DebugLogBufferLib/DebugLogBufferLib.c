@@ -1,17 +1,99 @@
 /** @file
   Provide Log Buffer Library functions.
 
-Copyright (c) 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2018 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
 
 #include <PiPei.h>
+#include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
+#include <Library/PcdLib.h>
+#include <Library/SerialPortLib.h>
+#include <Library/TimeStampLib.h>
 #include <Library/BootloaderCommonLib.h>
 #include <Library/DebugLogBufferLib.h>
 #include <Guid/LoaderPlatformDataGuid.h>
 
+//
+// Largest binary trace record, the same as the largest text debug message
+//
+#define DEBUG_LOG_TRACE_MAX_LENGTH  0x100
+
+/**
+  Get the debug log buffer of the current stage.
+
+  @retval  The debug log buffer header, or NULL if there is no valid one.
+
+**/
+STATIC
+DEBUG_LOG_BUFFER_HEADER *
+GetLogBuffer (
+  VOID
+  )
+{
+  DEBUG_LOG_BUFFER_HEADER  *LogBufHdr;
+
+  LogBufHdr = (DEBUG_LOG_BUFFER_HEADER *) GetDebugLogBufferPtr ();
+  if ((LogBufHdr == NULL) || (LogBufHdr->Signature != DEBUG_LOG_BUFFER_SIGNATURE)) {
+    return NULL;
+  }
+
+  return LogBufHdr;
+}
+
+/**
+  Get the buffer offset of the oldest log byte not written to the serial port.
+
+  @param  LogBufHdr        The debug log buffer header.
+
+  @retval  The offset of the first pending byte in the log buffer.
+
+**/
+STATIC
+UINTN
+GetPendingOffset (
+  IN DEBUG_LOG_BUFFER_HEADER  *LogBufHdr
+  )
+{
+  UINTN  Offset;
+
+  Offset = LogBufHdr->UsedLength - LogBufHdr->HeaderLength;
+  if (Offset < LogBufHdr->PendingLength) {
+    Offset += LogBufHdr->TotalLength - LogBufHdr->HeaderLength;
+  }
+
+  return Offset - LogBufHdr->PendingLength;
+}
+
+/**
+  Write the oldest pending bytes of the log to the serial port.
+
+  @param  LogBufHdr        The debug log buffer header.
+  @param  Length           The number of pending bytes to write.
+
+**/
+STATIC
+VOID
+DrainPendingLog (
+  IN DEBUG_LOG_BUFFER_HEADER  *LogBufHdr,
+  IN UINTN                     Length
+  )
+{
+  UINTN  Offset;
+  UINTN  Chunk;
+
+  Length = MIN (Length, LogBufHdr->PendingLength);
+  while (Length > 0) {
+    Offset = GetPendingOffset (LogBufHdr);
+    Chunk  = MIN (Length, LogBufHdr->TotalLength - LogBufHdr->HeaderLength - Offset);
+    SerialPortWrite (&LogBufHdr->Buffer[Offset], Chunk);
+    LogBufHdr->PendingLength -= (UINT32)Chunk;
+    Length -= Chunk;
+  }
+}
+
 /**
   Write data from buffer to console buffer.
 
@@ -40,25 +122,34 @@ DebugLogBufferWrite (
 {
   DEBUG_LOG_BUFFER_HEADER  *LogBufHdr;
   UINTN                     RemainingBytes;
+  UINTN                     Capacity;
 
   // This function will be called by DEBUG or ASSERT macro.
   // So please DON'T use DEBUG/ASSERT macro inside this function,
   // to avoid recursion.
-  LogBufHdr = (DEBUG_LOG_BUFFER_HEADER *) GetDebugLogBufferPtr ();
+  LogBufHdr = GetLogBuffer ();
   if (LogBufHdr == NULL) {
     return 0;
   }
 
-  if (LogBufHdr->Signature != DEBUG_LOG_BUFFER_SIGNATURE) {
-    return 0;
-  }
-
   //
   // Something wrong in Debug Log Buffer.
   // Reset buffer index and continue to record logs.
   //
   if (LogBufHdr->UsedLength > LogBufHdr->TotalLength) {
-    LogBufHdr->UsedLength = LogBufHdr->HeaderLength;
+    LogBufHdr->UsedLength    = LogBufHdr->HeaderLength;
+    LogBufHdr->PendingLength = 0;
+  }
+
+  //
+  // Deferred serial output must not be overwritten before it is drained
+  //
+  if ((LogBufHdr->Attribute & DEBUG_LOG_BUFFER_ATTRIBUTE_DEFER) != 0) {
+    Capacity = LogBufHdr->TotalLength - LogBufHdr->HeaderLength;
+    if (LogBufHdr->PendingLength + NumberOfBytes > Capacity) {
+      DrainPendingLog (LogBufHdr, LogBufHdr->PendingLength + NumberOfBytes - Capacity);
+    }
+    LogBufHdr->PendingLength += (UINT32)MIN (NumberOfBytes, Capacity);
   }
 
   RemainingBytes = 0;
@@ -83,3 +174,367 @@ DebugLogBufferWrite (
 
   return (NumberOfBytes + RemainingBytes);
 }
+
+/**
+  Append an argument to a binary trace record.
+
+  @param  Arg              Pointer to the end of the record, moved past the argument.
+  @param  End              The end of the record buffer.
+  @param  Data             The argument data.
+  @param  Size             The size of the argument data.
+
+  @retval TRUE             The argument was appended.
+  @retval FALSE            The record buffer is too small.
+
+**/
+STATIC
+BOOLEAN
+AppendTraceArg (
+  IN OUT UINT8       **Arg,
+  IN     UINT8        *End,
+  IN     CONST VOID   *Data,
+  IN     UINTN         Size
+  )
+{
+  if ((UINTN)(End - *Arg) < Size) {
+    return FALSE;
+  }
+
+  CopyMem (*Arg, Data, Size);
+  *Arg += Size;
+  return TRUE;
+}
+
+/**
+  Append a string argument to a binary trace record as a length byte followed
+  by the ASCII characters.
+
+  @param  Arg              Pointer to the end of the record, moved past the argument.
+  @param  End              The end of the record buffer.
+  @param  String           The ASCII or Unicode string.
+  @param  Unicode          TRUE if String is a Unicode string.
+
+  @retval TRUE             The argument was appended.
+  @retval FALSE            The string is NULL or the record buffer is too small.
+
+**/
+STATIC
+BOOLEAN
+AppendTraceString (
+  IN OUT UINT8       **Arg,
+  IN     UINT8        *End,
+  IN     CONST VOID   *String,
+  IN     BOOLEAN       Unicode
+  )
+{
+  UINT8   *Length;
+  UINT16   Char;
+  UINTN    Index;
+
+  if ((String == NULL) || (*Arg >= End)) {
+    return FALSE;
+  }
+
+  Length = (*Arg)++;
+  for (Index = 0; ; Index++) {
+    Char = Unicode ? ((CONST CHAR16 *)String)[Index] : ((CONST CHAR8 *)String)[Index];
+    if (Char == 0) {
+      break;
+    }
+    if ((*Arg >= End) || (Index == MAX_UINT8)) {
+      return FALSE;
+    }
+    *(*Arg)++ = (UINT8)Char;
+  }
+  *Length = (UINT8)Index;
+
+  return TRUE;
+}
+
+/**
+  Write a debug message to the log buffer as a binary trace record.
+
+  The message is not formatted. The record keeps the format string address,
+  the timestamp and the arguments, and the message is rendered on the host.
+
+  @param  Format           Format string of the debug message.
+  @param  Marker           Variable argument list of the format string.
+
+  @retval RETURN_SUCCESS       The record was written to the log buffer.
+  @retval RETURN_NOT_READY     There is no log buffer.
+  @retval RETURN_UNSUPPORTED   The message can't be kept in a binary record.
+
+**/
+RETURN_STATUS
+EFIAPI
+DebugLogBufferTrace (
+  IN CONST CHAR8  *Format,
+  IN VA_LIST       Marker
+  )
+{
+  DEBUG_LOG_BUFFER_HEADER  *LogBufHdr;
+  DEBUG_LOG_TRACE_RECORD   *Record;
+  UINT64                    RecordBuffer[DEBUG_LOG_TRACE_MAX_LENGTH / sizeof (UINT64)];
+  CONST CHAR8              *Ptr;
+  UINT8                    *Arg;
+  UINT8                    *End;
+  BOOLEAN                   Long;
+  BOOLEAN                   Precision;
+  BOOLEAN                   Done;
+  BOOLEAN                   Fit;
+  UINT16                    Char;
+  UINT32                    Value32;
+  UINT64                    Value64;
+  GUID                     *Guid;
+
+  LogBufHdr = GetLogBuffer ();
+  if (LogBufHdr == NULL) {
+    return RETURN_NOT_READY;
+  }
+
+  // The format string address is kept in 32 bits
+  if ((UINT64)(UINTN)Format > MAX_UINT32) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  Record            = (DEBUG_LOG_TRACE_RECORD *)RecordBuffer;
+  Record->TimeStamp = ReadTimeStamp ();
+  Arg               = Record->Args;
+  End               = (UINT8 *)RecordBuffer + sizeof (RecordBuffer);
+
+  //
+  // Walk the format string the same way as PrintLib and keep the arguments
+  //
+  Fit = TRUE;
+  for (Ptr = Format; Fit && (*Ptr != '\0'); Ptr++) {
+    if (*Ptr != '%') {
+      continue;
+    }
+
+    Long      = FALSE;
+    Precision = FALSE;
+    for (Done = FALSE; !Done && Fit; ) {
+      Ptr++;
+      switch (*Ptr) {
+      case '.':
+        Precision = TRUE;
+        break;
+      case 'l':
+      case 'L':
+        Long = TRUE;
+        break;
+      case '*':
+        Value32 = (UINT32)VA_ARG (Marker, UINTN);
+        Fit = AppendTraceArg (&Arg, End, &Value32, sizeof (Value32));
+        break;
+      case '-':
+      case '+':
+      case ' ':
+      case ',':
+      case '0':
+      case '1':
+      case '2':
+      case '3':
+      case '4':
+      case '5':
+      case '6':
+      case '7':
+      case '8':
+      case '9':
+        break;
+      default:
+        Done = TRUE;
+        break;
+      }
+    }
+
+    switch (*Ptr) {
+    case 'X':
+    case 'x':
+    case 'u':
+    case 'd':
+      if (Long) {
+        Value64 = (UINT64)VA_ARG (Marker, INT64);
+        Fit = AppendTraceArg (&Arg, End, &Value64, sizeof (Value64));
+      } else {
+        Value32 = (UINT32)VA_ARG (Marker, int);
+        Fit = AppendTraceArg (&Arg, End, &Value32, sizeof (Value32));
+      }
+      break;
+    case 'p':
+      Value64 = (UINTN)VA_ARG (Marker, VOID *);
+      Fit = AppendTraceArg (&Arg, End, &Value64, sizeof (Value64));
+      break;
+    case 'r':
+      Value64 = VA_ARG (Marker, RETURN_STATUS);
+      Fit = AppendTraceArg (&Arg, End, &Value64, sizeof (Value64));
+      break;
+    case 'c':
+      Char = (UINT16)VA_ARG (Marker, UINTN);
+      Fit = AppendTraceArg (&Arg, End, &Char, sizeof (Char));
+      break;
+    case 'a':
+    case 's':
+    case 'S':
+      // A string with precision may not be NULL terminated
+      Fit = !Precision && AppendTraceString (&Arg, End, VA_ARG (Marker, VOID *), *Ptr != 'a');
+      break;
+    case 'g':
+      Guid = VA_ARG (Marker, GUID *);
+      Fit = (Guid != NULL) && AppendTraceArg (&Arg, End, Guid, sizeof (GUID));
+      break;
+    case 't':
+      Fit = FALSE;
+      break;
+    case '\0':
+      // Let the outer loop see the end of the format string
+      Ptr--;
+      break;
+    default:
+      break;
+    }
+  }
+
+  if (!Fit) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  Record->Marker = DEBUG_LOG_TRACE_MARKER;
+  Record->Type   = DEBUG_LOG_TRACE_TYPE_MESSAGE;
+  Record->Length = (UINT16)(Arg - (UINT8 *)RecordBuffer);
+  Record->Format = (UINT32)(UINTN)Format;
+  LogBufHdr->Attribute |= DEBUG_LOG_BUFFER_ATTRIBUTE_TRACE;
+  DebugLogBufferWrite ((UINT8 *)Record, Record->Length);
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Write the runtime base of a relocated stage image to the log buffer, so that
+  the host can find the format strings of the binary trace records the image
+  writes from there.
+
+  Nothing is written if the binary trace log is disabled, or if the image runs
+  at its link base.
+
+  @param  LinkBase         The base address the image is linked at.
+  @param  RuntimeBase      The base address the image runs at.
+
+  @retval RETURN_SUCCESS       The record was written, or no record is needed.
+  @retval RETURN_NOT_READY     There is no log buffer.
+
+**/
+RETURN_STATUS
+EFIAPI
+DebugLogBufferTraceImageBase (
+  IN UINT32       LinkBase,
+  IN UINT32       RuntimeBase
+  )
+{
+  DEBUG_LOG_BUFFER_HEADER  *LogBufHdr;
+  DEBUG_LOG_TRACE_RECORD   *Record;
+  UINT64                    RecordBuffer[(sizeof (DEBUG_LOG_TRACE_RECORD) + sizeof (UINT32) + sizeof (UINT64) - 1) / sizeof (UINT64)];
+
+  if (!FeaturePcdGet (PcdBinaryTraceLogEnabled) || (LinkBase == RuntimeBase)) {
+    return RETURN_SUCCESS;
+  }
+
+  LogBufHdr = GetLogBuffer ();
+  if (LogBufHdr == NULL) {
+    return RETURN_NOT_READY;
+  }
+
+  Record            = (DEBUG_LOG_TRACE_RECORD *)RecordBuffer;
+  Record->Marker    = DEBUG_LOG_TRACE_MARKER;
+  Record->Type      = DEBUG_LOG_TRACE_TYPE_IMAGE_BASE;
+  Record->Length    = (UINT16)(sizeof (DEBUG_LOG_TRACE_RECORD) + sizeof (UINT32));
+  Record->Format    = RuntimeBase;
+  Record->TimeStamp = ReadTimeStamp ();
+  CopyMem (Record->Args, &LinkBase, sizeof (UINT32));
+  LogBufHdr->Attribute |= DEBUG_LOG_BUFFER_ATTRIBUTE_TRACE;
+  DebugLogBufferWrite ((UINT8 *)Record, Record->Length);
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Start or stop deferring the serial output of the debug log.
+
+  While deferred, the log written by DebugLogBufferWrite () goes to the serial
+  port only through DebugLogBufferDrain (). Stopping writes all the pending log
+  to the serial port first.
+
+  @param  Defer            TRUE to defer the serial output, FALSE to stop.
+
+  @retval TRUE             The serial output was deferred before the call.
+  @retval FALSE            The serial output was not deferred before the call.
+
+**/
+BOOLEAN
+EFIAPI
+DebugLogBufferDefer (
+  IN BOOLEAN    Defer
+  )
+{
+  DEBUG_LOG_BUFFER_HEADER  *LogBufHdr;
+  BOOLEAN                   Deferred;
+
+  LogBufHdr = GetLogBuffer ();
+  if (LogBufHdr == NULL) {
+    return FALSE;
+  }
+
+  Deferred = (LogBufHdr->Attribute & DEBUG_LOG_BUFFER_ATTRIBUTE_DEFER) != 0;
+  if (Defer) {
+    if (!Deferred) {
+      LogBufHdr->PendingLength = 0;
+      LogBufHdr->Attribute    |= DEBUG_LOG_BUFFER_ATTRIBUTE_DEFER;
+    }
+  } else if (Deferred) {
+    DrainPendingLog (LogBufHdr, LogBufHdr->PendingLength);
+    LogBufHdr->Attribute &= (UINT8)~DEBUG_LOG_BUFFER_ATTRIBUTE_DEFER;
+  }
+
+  return Deferred;
+}
+
+/**
+  Write the pending log to the serial port.
+
+  @param  Wait             TRUE to write all the pending log, FALSE to write
+                           only what the UART can take without waiting.
+
+  @retval RETURN_SUCCESS       The pending log was written as requested.
+  @retval RETURN_NOT_STARTED   The serial output is not deferred.
+
+**/
+RETURN_STATUS
+EFIAPI
+DebugLogBufferDrain (
+  IN BOOLEAN    Wait
+  )
+{
+  DEBUG_LOG_BUFFER_HEADER  *LogBufHdr;
+  UINT32                    Control;
+  UINTN                     Length;
+
+  LogBufHdr = GetLogBuffer ();
+  if ((LogBufHdr == NULL) || ((LogBufHdr->Attribute & DEBUG_LOG_BUFFER_ATTRIBUTE_DEFER) == 0)) {
+    return RETURN_NOT_STARTED;
+  }
+
+  if (Wait) {
+    DrainPendingLog (LogBufHdr, LogBufHdr->PendingLength);
+  } else if (LogBufHdr->PendingLength > 0) {
+    //
+    // Fill the TX FIFO once it is empty, from one contiguous part of the ring
+    //
+    if (!RETURN_ERROR (SerialPortGetControl (&Control)) && ((Control & EFI_SERIAL_OUTPUT_BUFFER_EMPTY) != 0)) {
+      Length = MIN (LogBufHdr->PendingLength, PcdGet32 (PcdSerialTxFifoSize));
+      Length = MIN (Length, LogBufHdr->TotalLength - LogBufHdr->HeaderLength - GetPendingOffset (LogBufHdr));
+      DrainPendingLog (LogBufHdr, Length);
+    }
+  }
+
+  return RETURN_SUCCESS;
+}
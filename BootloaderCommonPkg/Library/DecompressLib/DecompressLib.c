@@ -8,7 +8,104 @@
 
 #include <Library/LzmaDecompressLib.h>
 #include <Library/Lz4CompressLib.h>
+#include <Library/ZstdDecompressLib.h>
 #include <Library/DecompressLib.h>
+#include <Library/BootloaderCommonLib.h>
+
+typedef struct {
+  CONST VOID   *Source;
+  UINTN         SourceSize;
+  VOID         *Destination;
+  UINT32        Block;
+} LZ4B_BLOCK_JOB;
+
+/**
+  CPU job to decompress one block of a LZ4B compressed buffer.
+
+  @param[in] Arg     Pointer to the LZ4B_BLOCK_JOB of the block.
+
+  @retval  The RETURN_STATUS of the block decompression.
+
+**/
+STATIC
+UINT64
+EFIAPI
+Lz4BlockJob (
+  IN  UINT64   Arg
+  )
+{
+  LZ4B_BLOCK_JOB   *BlockJob;
+
+  BlockJob = (LZ4B_BLOCK_JOB *)(UINTN)Arg;
+  return Lz4BlockDecompressRange (BlockJob->Source, BlockJob->SourceSize,
+                                  BlockJob->Destination, BlockJob->Block, 1);
+}
+
+/**
+  Decompresses a LZ4B compressed buffer, spreading the blocks over the APs
+  waiting for tasks if any.
+
+  The job table is built in the scratch buffer, whose size is reported by
+  DecompressGetInfo(). The blocks are decompressed serially when the APs are
+  not available or no scratch buffer is given.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data
+  @param  Scratch     A temporary scratch buffer for the job table, or NULL.
+
+  @retval  RETURN_SUCCESS Decompression completed successfully.
+  @retval  RETURN_INVALID_PARAMETER
+                          The source buffer is corrupted.
+**/
+STATIC
+RETURN_STATUS
+Lz4BlockDecompressParallel (
+  IN CONST VOID  *Source,
+  IN UINTN        SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  )
+{
+  RETURN_STATUS     Status;
+  SYS_CPU_TASK     *SysCpuTask;
+  CPU_JOB          *Jobs;
+  LZ4B_BLOCK_JOB   *BlockJobs;
+  UINT32            BlockCount;
+  UINT32            Index;
+
+  SysCpuTask = GetDefaultCpuJobTask ();
+  if ((SysCpuTask == NULL) || (SysCpuTask->CpuCount < 2) || (Scratch == NULL)) {
+    return Lz4BlockDecompress (Source, SourceSize, Destination, Scratch);
+  }
+
+  Status = Lz4BlockDecompressGetInfo (Source, (UINT32)SourceSize, NULL, NULL);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  BlockCount = ((CONST LZ4B_HEADER *)Source)->BlockCount;
+  Jobs       = (CPU_JOB *)Scratch;
+  BlockJobs  = (LZ4B_BLOCK_JOB *)&Jobs[BlockCount];
+  for (Index = 0; Index < BlockCount; Index++) {
+    BlockJobs[Index].Source      = Source;
+    BlockJobs[Index].SourceSize  = SourceSize;
+    BlockJobs[Index].Destination = Destination;
+    BlockJobs[Index].Block       = Index;
+    Jobs[Index].Func             = Lz4BlockJob;
+    Jobs[Index].Argument         = (UINT64)(UINTN)&BlockJobs[Index];
+  }
+
+  ScheduleCpuJobs (SysCpuTask, Jobs, BlockCount);
+
+  for (Index = 0; Index < BlockCount; Index++) {
+    if (RETURN_ERROR ((RETURN_STATUS)Jobs[Index].Result)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+  }
+
+  return RETURN_SUCCESS;
+}
 
 /**
   Given a compressed source buffer, this function retrieves the size of
@@ -54,6 +151,12 @@ DecompressGetInfo (
 
   if (Signature == LZ4_SIGNATURE) {
     Status = Lz4DecompressGetInfo (Source, SourceSize, DestinationSize, ScratchSize);
+  } else if (Signature == LZ4B_SIGNATURE) {
+    Status = Lz4BlockDecompressGetInfo (Source, SourceSize, DestinationSize, ScratchSize);
+    if (!RETURN_ERROR (Status) && (ScratchSize != NULL)) {
+      // Room for the job table used to spread the blocks over the APs
+      *ScratchSize = ((CONST LZ4B_HEADER *)Source)->BlockCount * (sizeof (CPU_JOB) + sizeof (LZ4B_BLOCK_JOB));
+    }
   } else if (Signature == LZDM_SIGNATURE) {
     if (DestinationSize != NULL) {
       *DestinationSize = SourceSize;
@@ -65,6 +168,8 @@ DecompressGetInfo (
   } else if (!FeaturePcdGet (PcdMinDecompression)) {
     if (Signature == LZMA_SIGNATURE) {
       Status = LzmaUefiDecompressGetInfo (Source, SourceSize, DestinationSize, ScratchSize);
+    } else if (Signature == ZSTD_SIGNATURE) {
+      Status = ZstdDecompressGetInfo (Source, SourceSize, DestinationSize, ScratchSize);
     }
   }
 
@@ -109,12 +214,16 @@ Decompress (
   Status = RETURN_UNSUPPORTED;
   if (Signature == LZ4_SIGNATURE) {
     Status = Lz4Decompress (Source, SourceSize, Destination, Scratch);
+  } else if (Signature == LZ4B_SIGNATURE) {
+    Status = Lz4BlockDecompressParallel (Source, SourceSize, Destination, Scratch);
   } else if (Signature == LZDM_SIGNATURE) {
     CopyMem (Destination, Source, SourceSize);
     Status = RETURN_SUCCESS;
   } else if (!FeaturePcdGet (PcdMinDecompression)) {
     if (Signature == LZMA_SIGNATURE) {
       Status = LzmaUefiDecompress (Source, SourceSize, Destination, Scratch);
+    } else if (Signature == ZSTD_SIGNATURE) {
+      Status = ZstdDecompress (Source, SourceSize, Destination, Scratch);
     }
   }
 
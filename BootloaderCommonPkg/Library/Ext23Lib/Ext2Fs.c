@@ -103,6 +103,8 @@
   @param[in]  File            pointer to an Open file.
   @param[in]  FileBlock       Block to find the file.
   @param[out] DiskBlockPtr    Pointer to the disk which contains block.
+  @param[out] RunLength       Number of blocks starting at FileBlock known to be
+                              contiguous on disk. Optional.
 
   @retval 0 if success
   @retval other if error.
@@ -112,7 +114,8 @@ RETURN_STATUS
 BlockMap (
   IN  OPEN_FILE     *File,
   IN  INDPTR         FileBlock,
-  OUT INDPTR        *DiskBlockPtr
+  OUT INDPTR        *DiskBlockPtr,
+  OUT UINT32        *RunLength     OPTIONAL
   );
 
 /**
@@ -255,6 +258,8 @@ ReadInode (
   @param[in]  File            pointer to an Open file.
   @param[in]  FileBlock       Block to find the file.
   @param[out] DiskBlockPtr    Pointer to the disk which contains block.
+  @param[out] RunLength       Number of blocks starting at FileBlock known to be
+                              contiguous on disk. Optional.
 
   @retval 0 if success
   @retval other if error.
@@ -264,7 +269,8 @@ RETURN_STATUS
 BlockMap (
   IN  OPEN_FILE     *File,
   IN  INDPTR         FileBlock,
-  OUT INDPTR        *DiskBlockPtr
+  OUT INDPTR        *DiskBlockPtr,
+  OUT UINT32        *RunLength     OPTIONAL
   )
 {
   FILE     *Fp;
@@ -285,6 +291,10 @@ BlockMap (
   FileSystem = Fp->SuperBlockPtr;
   Buf = (VOID *)Fp->Buffer;
 
+  if (RunLength != NULL) {
+    *RunLength = 1;
+  }
+
   if ((Fp->DiskInode.Ext2DInodeStatusFlags & EXT4_EXTENTS) != 0) {
     Etable = (EXT4_EXTENT_TABLE*) &(Fp->DiskInode.Ext2DInodeBlocks);
     if (Etable->Eheader.EhMagic != EXT4_EXTENT_HEADER_MAGIC) {
@@ -357,6 +367,9 @@ BlockMap (
       //
       ASSERT (Extent->EstartHi == 0);
       *DiskBlockPtr = Extent->EstartLo + (FileBlock - Extent->Eblk); // (LShiftU64((UINT64)Extent->EiLeafHi, 32) | Extent->EstartLo) + (FileBlock - Extent->Eblk);
+      if (RunLength != NULL) {
+        *RunLength = Extent->Eblk + Extent->Elen - (UINT32) FileBlock;
+      }
     } else {
       *DiskBlockPtr = 0;
     }
@@ -474,7 +487,7 @@ BufReadFile (
   BlockSize = FileSystem->Ext2FsBlockSize;    // no fragment
 
   if (FileBlock != Fp->BufferBlockNum) {
-    Rc = BlockMap (File, FileBlock, &DiskBlock);
+    Rc = BlockMap (File, FileBlock, &DiskBlock, NULL);
     if (Rc != 0) {
       return Rc;
     }
@@ -515,6 +528,66 @@ BufReadFile (
   return 0;
 }
 
+/**
+  Find the run of file blocks starting at FileBlock that are contiguous on disk.
+
+  Extent based inodes report the run from the extent itself. For block mapped
+  inodes the following blocks are looked up one by one, which mostly hits the
+  indirect block cache.
+
+  @param[in]  File            pointer to an Open file.
+  @param[in]  FileBlock       First block of the run.
+  @param[in]  MaxBlocks       Maximum number of blocks in the run.
+  @param[out] DiskBlockPtr    Disk block of FileBlock, 0 for a hole.
+  @param[out] BlockCount      Number of blocks in the run.
+
+  @retval 0 if success
+  @retval other if error.
+**/
+STATIC
+RETURN_STATUS
+BlockMapRun (
+  IN  OPEN_FILE     *File,
+  IN  INDPTR         FileBlock,
+  IN  UINT32         MaxBlocks,
+  OUT INDPTR        *DiskBlockPtr,
+  OUT UINT32        *BlockCount
+  )
+{
+  RETURN_STATUS     Status;
+  INDPTR            DiskBlock;
+  UINT32            RunLength;
+  UINT32            Count;
+
+  Status = BlockMap (File, FileBlock, DiskBlockPtr, &RunLength);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Holes are zero filled one block at a time
+  //
+  if (*DiskBlockPtr == 0) {
+    *BlockCount = 1;
+    return RETURN_SUCCESS;
+  }
+
+  Count = MIN (RunLength, MaxBlocks);
+  while (Count < MaxBlocks) {
+    Status = BlockMap (File, FileBlock + Count, &DiskBlock, &RunLength);
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+    if (DiskBlock != *DiskBlockPtr + (INDPTR)Count) {
+      break;
+    }
+    Count += MIN (RunLength, MaxBlocks - Count);
+  }
+
+  *BlockCount = Count;
+  return RETURN_SUCCESS;
+}
+
 /**
   Search a directory for a Name and return its inode number.
 
@@ -981,7 +1054,7 @@ Ext2fsOpen (
         INDPTR    DiskBlock;
 
         Buf = Fp->Buffer;
-        Status = BlockMap (File, (INDPTR)0, &DiskBlock);
+        Status = BlockMap (File, (INDPTR)0, &DiskBlock, NULL);
         if (RETURN_ERROR (Status)) {
           goto out;
         }
@@ -1129,13 +1202,20 @@ Ext2fsRead (
   )
 {
   FILE *Fp;
+  M_EXT2FS *FileSystem;
   UINT32 Csize;
   CHAR8 *Buf;
   UINT32 BufSize;
   CHAR8 *Address;
+  UINT32 BlockSize;
+  UINT32 Remain;
+  UINT32 BlockCount;
+  INDPTR DiskBlock;
   RETURN_STATUS Status;
 
   Fp = (FILE *)File->FileSystemSpecificData;
+  FileSystem = Fp->SuperBlockPtr;
+  BlockSize = FileSystem->Ext2FsBlockSize;
   Status = RETURN_SUCCESS;
   Address = Start;
 
@@ -1147,17 +1227,52 @@ Ext2fsRead (
       break;
     }
 
-    Status = BufReadFile (File, &Buf, &BufSize);
-    if (RETURN_ERROR (Status)) {
-      break;
-    }
+    Remain = MIN (Size, (UINT32)(Fp->DiskInode.Ext2DInodeSize - Fp->SeekPtr));
+    if ((BLOCKOFFSET (FileSystem, Fp->SeekPtr) == 0) && (Remain >= BlockSize)) {
+      //
+      // Read whole blocks that are contiguous on disk straight into
+      // the caller's buffer.
+      //
+      Status = BlockMapRun (File, LBLKNO (FileSystem, Fp->SeekPtr), Remain / BlockSize, &DiskBlock, &BlockCount);
+      //
+      // BlockMap may have used the buffer for the extent tree or indirect blocks
+      //
+      Fp->BufferBlockNum = -1;
+      if (RETURN_ERROR (Status)) {
+        break;
+      }
 
-    Csize = Size;
-    if (Csize > BufSize) {
-      Csize = BufSize;
-    }
+      Csize = BlockCount * BlockSize;
+      if (DiskBlock == 0) {
+        ZeroMem (Address, Csize);
+      } else {
+        Status = DEV_STRATEGY (File->DevPtr) (File->FileDevData, F_READ,
+                                              FSBTODB (FileSystem, DiskBlock),
+                                              Csize, Address, &BufSize);
+        if (RETURN_ERROR (Status)) {
+          break;
+        }
+        if (BufSize != Csize) {
+          Status = EFI_DEVICE_ERROR;
+          break;
+        }
+      }
+    } else {
+      //
+      // Unaligned head or tail goes through the block buffer
+      //
+      Status = BufReadFile (File, &Buf, &BufSize);
+      if (RETURN_ERROR (Status)) {
+        break;
+      }
+
+      Csize = Size;
+      if (Csize > BufSize) {
+        Csize = BufSize;
+      }
 
-    CopyMem (Address, Buf, Csize);
+      CopyMem (Address, Buf, Csize);
+    }
 
     Fp->SeekPtr += Csize;
     Address += Csize;
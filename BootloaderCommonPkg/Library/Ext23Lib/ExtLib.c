@@ -1,7 +1,7 @@
 /** @file
   ExtLib APIs
 
-Copyright (c) 2006 - 2021, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -258,6 +258,54 @@ ExtFsReadFile (
   return EFI_SUCCESS;
 }
 
+/**
+  Read the next part of a file by opened file handle.
+
+  @param[in]     FsHandle         file system handle.
+  @param[in]     FileHandle       file handle
+  @param[out]    Buffer           Buffer to receive the data.
+  @param[in,out] Size             On input, the number of bytes to read. On
+                                  output, the number of bytes read, which is
+                                  smaller at the end of the file.
+
+  @retval EFI_SUCCESS             The data was read correctly.
+  @retval EFI_INVALID_PARAMETER   Parameter is not valid.
+  @retval EFI_DEVICE_ERROR        A device error occurred.
+
+**/
+EFI_STATUS
+EFIAPI
+ExtFsReadFileChunk (
+  IN     EFI_HANDLE                               FsHandle,
+  IN     EFI_HANDLE                               FileHandle,
+  OUT    VOID                                    *Buffer,
+  IN OUT UINTN                                   *Size
+  )
+{
+  OPEN_FILE              *OpenFile;
+  UINT32                  Residual;
+  EFI_STATUS              Status;
+
+  OpenFile = (OPEN_FILE *)FileHandle;
+  if ((OpenFile == NULL) || (Buffer == NULL) || (Size == NULL) || (*Size > MAX_UINT32)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Ext2fsRead() continues from the current position of the file, and leaves
+  // the part past the end of the file in Residual.
+  //
+  Residual = 0;
+  Status = Ext2fsRead (OpenFile, Buffer, (UINT32)*Size, &Residual);
+  if (EFI_ERROR (Status)) {
+    *Size = 0;
+    return EFI_DEVICE_ERROR;
+  }
+
+  *Size -= Residual;
+  return EFI_SUCCESS;
+}
+
 /**
   Close a file by opened file handle
 
@@ -1,7 +1,7 @@
 /** @file
   FatLib APIs
 
-Copyright (c) 2006 - 2020, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -278,8 +278,12 @@ FatInitFileSystem (
     PrivateData->BlockDeviceCount++;
   }
 
-  Status = FatGetVolumeData (PrivateData);
+  Status = FatInitCache (PrivateData, PartBlockDev->BlockInfo.BlockSize);
+  if (!EFI_ERROR (Status)) {
+    Status = FatGetVolumeData (PrivateData);
+  }
   if (EFI_ERROR (Status)) {
+    FatFreeCache (PrivateData);
     FreePool (PrivateData);
   } else {
     DEBUG ((DEBUG_INFO, "Detected FAT on HwDev %d Part %d\n",  PartBlockDev->HarewareDevice, SwPart));
@@ -312,6 +316,7 @@ FatCloseFileSystem (
   }
 
   if (PrivateData != NULL && PrivateData->Signature == FS_FAT_SIGNATURE) {
+    FatFreeCache (PrivateData);
     FreePool (PrivateData);
   }
 }
@@ -452,6 +457,16 @@ FatFsReadFile (
     return EFI_INVALID_PARAMETER;
   }
 
+  //
+  // Collapse the cluster chain into contiguous runs so that the file can be
+  // read with as few media reads as possible. Fall back to walking the
+  // cluster chain if the map cannot be built.
+  //
+  Status = FatBuildExtentMap (PrivateData, File);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_VERBOSE, "  FatFsReadFile: no extent map for %s (%r)\n", File->FileName, Status));
+  }
+
   FileBuffer = FileBufferPtr;
   Status = FatReadFile (
              PrivateData,
@@ -471,6 +486,65 @@ FatFsReadFile (
   return Status;
 }
 
+/**
+  Read the next part of a file by opened file handle.
+
+  @param[in]     FsHandle         file system handle.
+  @param[in]     FileHandle       file handle
+  @param[out]    Buffer           Buffer to receive the data.
+  @param[in,out] Size             On input, the number of bytes to read. On
+                                  output, the number of bytes read, which is
+                                  smaller at the end of the file.
+
+  @retval EFI_SUCCESS             The data was read correctly.
+  @retval EFI_INVALID_PARAMETER   Parameter is not valid.
+  @retval EFI_DEVICE_ERROR        A device error occurred.
+
+**/
+EFI_STATUS
+EFIAPI
+FatFsReadFileChunk (
+  IN     EFI_HANDLE                               FsHandle,
+  IN     EFI_HANDLE                               FileHandle,
+  OUT    VOID                                    *Buffer,
+  IN OUT UINTN                                   *Size
+  )
+{
+  EFI_STATUS              Status;
+  PEI_FAT_FILE           *File;
+  PEI_FAT_PRIVATE_DATA   *PrivateData;
+  UINTN                   Amount;
+
+  File        = (PEI_FAT_FILE *)FileHandle;
+  PrivateData = (PEI_FAT_PRIVATE_DATA *)FsHandle;
+  if ((File == NULL) || (Buffer == NULL) || (Size == NULL) ||
+      (PrivateData == NULL) || (PrivateData->Signature != FS_FAT_SIGNATURE)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((File->Attributes & FAT_ATTR_DIRECTORY) != 0) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Amount = MIN (*Size, (UINTN)(File->FileSize - File->CurrentPos));
+  *Size  = 0;
+  if (Amount == 0) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // The extent map is built on the first read and kept with the file
+  //
+  FatBuildExtentMap (PrivateData, File);
+
+  Status = FatReadFile (PrivateData, File, Amount, Buffer);
+  if (!EFI_ERROR (Status)) {
+    *Size = Amount;
+  }
+
+  return Status;
+}
+
 /**
   Close a file by opened file handle
 
@@ -494,6 +568,7 @@ FatFsCloseFile (
   }
 
   DEBUG ((DEBUG_VERBOSE, "  FatFsCloseFile: %s closed\n", File->FileName));
+  FatFreeExtentMap (File);
   FreePool (File);
 }
 
@@ -551,3 +626,40 @@ DEBUG_CODE_END ();
 
   return Status;
 }
+
+/**
+  Get block cache statistics of a FAT file system
+
+  @param[in]     FsHandle         file system handle.
+  @param[out]    CacheInfo        block cache statistics.
+
+  @retval EFI_SUCCESS             the statistics were returned
+  @retval EFI_INVALID_PARAMETER   Parameter is not valid.
+
+**/
+EFI_STATUS
+EFIAPI
+FatFsGetCacheInfo (
+  IN  EFI_HANDLE                                  FsHandle,
+  OUT FS_CACHE_INFO                              *CacheInfo
+  )
+{
+  PEI_FAT_PRIVATE_DATA     *PrivateData;
+  PEI_FAT_CACHE            *Cache;
+
+  PrivateData = (PEI_FAT_PRIVATE_DATA *)FsHandle;
+  if ((PrivateData == NULL) || (CacheInfo == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  ASSERT (PrivateData->Signature == FS_FAT_SIGNATURE);
+
+  Cache = &PrivateData->Cache;
+  CacheInfo->BlockCount       = Cache->BlockCount;
+  CacheInfo->BlockSize        = Cache->BlockSize;
+  CacheInfo->ReadAheadBlocks  = Cache->ReadAheadBlocks;
+  CacheInfo->Hits             = Cache->Hits;
+  CacheInfo->Misses           = Cache->Misses;
+  CacheInfo->PrefetchedBlocks = Cache->PrefetchedBlocks;
+
+  return EFI_SUCCESS;
+}
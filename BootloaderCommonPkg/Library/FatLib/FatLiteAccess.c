@@ -220,7 +220,7 @@ FatGetNextCluster (
   if (Volume->FatType == Fat32) {
     FatEntryPos = Volume->FatPos + MultU64x32 (4, Cluster);
 
-    Status      = FatReadDisk (PrivateData, Volume->BlockDeviceNo, FatEntryPos, 4, NextCluster);
+    Status      = FatReadFatRegion (PrivateData, Volume, FatEntryPos, 4, NextCluster);
     *NextCluster &= 0x0fffffff;
 
     //
@@ -233,7 +233,7 @@ FatGetNextCluster (
   } else if (Volume->FatType == Fat16) {
     FatEntryPos = Volume->FatPos + MultU64x32 (2, Cluster);
 
-    Status      = FatReadDisk (PrivateData, Volume->BlockDeviceNo, FatEntryPos, 2, NextCluster);
+    Status      = FatReadFatRegion (PrivateData, Volume, FatEntryPos, 2, NextCluster);
 
     //
     // Pad high bits for our FAT_CLUSTER_... macro definitions to work
@@ -245,7 +245,7 @@ FatGetNextCluster (
   } else {
     FatEntryPos = Volume->FatPos + DivU64x32Remainder (MultU64x32 (3, Cluster), 2, &Dummy);
 
-    Status      = FatReadDisk (PrivateData, Volume->BlockDeviceNo, FatEntryPos, 2, NextCluster);
+    Status      = FatReadFatRegion (PrivateData, Volume, FatEntryPos, 2, NextCluster);
 
     if ((Cluster & 0x01) != 0) {
       *NextCluster = (*NextCluster) >> 4;
@@ -359,6 +359,235 @@ FatSetFilePos (
 }
 
 
+/**
+  Build the extent map of a file.
+
+  The cluster chain is walked once and collapsed into runs of physically
+  contiguous clusters, so that later reads do not need any FAT lookups.
+
+  @param  PrivateData            the global memory map
+  @param  File                   the file
+
+  @retval EFI_SUCCESS            The extent map is built.
+  @retval EFI_UNSUPPORTED        The file is a directory.
+  @retval EFI_VOLUME_CORRUPTED   The cluster chain is shorter than the file.
+  @retval EFI_OUT_OF_RESOURCES   Insufficient memory for the extent map.
+  @retval EFI_DEVICE_ERROR       Something error while accessing media.
+
+**/
+EFI_STATUS
+FatBuildExtentMap (
+  IN  PEI_FAT_PRIVATE_DATA  *PrivateData,
+  IN  PEI_FAT_FILE          *File
+  )
+{
+  EFI_STATUS      Status;
+  PEI_FAT_VOLUME  *Volume;
+  PEI_FAT_EXTENT  *Extent;
+  PEI_FAT_EXTENT  *NewExtent;
+  PEI_FAT_EXTENT  *Last;
+  UINT32          Capacity;
+  UINT32          Count;
+  UINT32          Cluster;
+  UINT32          Pos;
+
+  if (File->IsFixedRootDir || ((File->Attributes & FAT_ATTR_DIRECTORY) != 0)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (File->Extent != NULL) {
+    return EFI_SUCCESS;
+  }
+
+  Volume   = File->Volume;
+  Extent   = NULL;
+  Last     = NULL;
+  Capacity = 0;
+  Count    = 0;
+  Cluster  = File->StartingCluster;
+  Status   = EFI_SUCCESS;
+
+  for (Pos = 0; Pos < File->FileSize; Pos += Volume->ClusterSize) {
+    if (FAT_CLUSTER_FUNCTIONAL (Cluster) || (Cluster > Volume->MaxCluster + 1)) {
+      Status = EFI_VOLUME_CORRUPTED;
+      break;
+    }
+
+    if ((Last != NULL) && (Cluster == Last->Cluster + Last->Length / Volume->ClusterSize)) {
+      Last->Length += Volume->ClusterSize;
+    } else {
+      if (Count == Capacity) {
+        Capacity = (Capacity == 0) ? 8 : Capacity * 2;
+        NewExtent = ReallocatePool (Count * sizeof (PEI_FAT_EXTENT), Capacity * sizeof (PEI_FAT_EXTENT), Extent);
+        if (NewExtent == NULL) {
+          Status = EFI_OUT_OF_RESOURCES;
+          break;
+        }
+        Extent = NewExtent;
+      }
+      Last           = &Extent[Count++];
+      Last->FilePos  = Pos;
+      Last->Cluster  = Cluster;
+      Last->Length   = Volume->ClusterSize;
+      Last->Position = Volume->FirstClusterPos + MultU64x32 (Volume->ClusterSize, Cluster - 2);
+    }
+
+    if (Pos + Volume->ClusterSize < File->FileSize) {
+      Status = FatGetNextCluster (PrivateData, Volume, Cluster, &Cluster);
+      if (EFI_ERROR (Status)) {
+        Status = EFI_DEVICE_ERROR;
+        break;
+      }
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    if (Extent != NULL) {
+      FreePool (Extent);
+    }
+    return Status;
+  }
+
+  File->Extent      = Extent;
+  File->ExtentCount = Count;
+  DEBUG ((DEBUG_VERBOSE, "  FAT extent map: %d runs for %d bytes\n", Count, File->FileSize));
+
+  return EFI_SUCCESS;
+}
+
+
+/**
+  Free the extent map of a file.
+
+  @param  File                   the file
+
+**/
+VOID
+FatFreeExtentMap (
+  IN  PEI_FAT_FILE          *File
+  )
+{
+  if (File->Extent != NULL) {
+    FreePool (File->Extent);
+  }
+  File->Extent      = NULL;
+  File->ExtentCount = 0;
+}
+
+
+/**
+  Find the extent holding a file position.
+
+  @param  File                   the file with an extent map
+  @param  Pos                    the file position
+
+  @return the extent index, or ExtentCount if Pos is beyond the map.
+
+**/
+STATIC
+UINT32
+FatFindExtent (
+  IN  PEI_FAT_FILE          *File,
+  IN  UINT32                Pos
+  )
+{
+  UINT32          Low;
+  UINT32          High;
+  UINT32          Mid;
+
+  Low  = 0;
+  High = File->ExtentCount;
+  while (Low < High) {
+    Mid = (Low + High) / 2;
+    if (Pos < File->Extent[Mid].FilePos) {
+      High = Mid;
+    } else if (Pos - File->Extent[Mid].FilePos >= File->Extent[Mid].Length) {
+      Low = Mid + 1;
+    } else {
+      return Mid;
+    }
+  }
+
+  return File->ExtentCount;
+}
+
+
+/**
+  Reads file data through the file's extent map. Each extent is read with
+  a single disk read straight into the caller's buffer.
+
+  @param  PrivateData            Global memory map for accessing global variables
+  @param  File                   The file.
+  @param  Size                   The amount of data to read.
+  @param  Buffer                 The buffer storing the data.
+
+  @retval EFI_SUCCESS            The data is read.
+  @retval EFI_INVALID_PARAMETER  The extent map does not cover the data.
+  @retval EFI_DEVICE_ERROR       Something error while accessing media.
+
+**/
+STATIC
+EFI_STATUS
+FatReadFileExtents (
+  IN  PEI_FAT_PRIVATE_DATA  *PrivateData,
+  IN  PEI_FAT_FILE          *File,
+  IN  UINTN                 Size,
+  OUT VOID                  *Buffer
+  )
+{
+  EFI_STATUS      Status;
+  PEI_FAT_EXTENT  *Extent;
+  CHAR8           *BufferPtr;
+  UINT32          Index;
+  UINT32          Offset;
+  UINTN           Amount;
+
+  BufferPtr = Buffer;
+  Index     = FatFindExtent (File, File->CurrentPos);
+
+  while (Size != 0) {
+    if (Index >= File->ExtentCount) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Extent = &File->Extent[Index];
+    Offset = File->CurrentPos - Extent->FilePos;
+    Amount = Extent->Length - Offset;
+    Amount = Size > Amount ? Amount : Size;
+    Status = FatReadDisk (
+               PrivateData,
+               File->Volume->BlockDeviceNo,
+               Extent->Position + Offset,
+               Amount,
+               BufferPtr
+               );
+    if (EFI_ERROR (Status)) {
+      return EFI_DEVICE_ERROR;
+    }
+
+    File->CurrentPos += (UINT32) Amount;
+    BufferPtr += Amount;
+    Size -= Amount;
+    Index++;
+  }
+
+  //
+  // Keep the cluster based position in sync for FatSetFilePos()
+  //
+  Index = FatFindExtent (File, File->CurrentPos);
+  if (Index < File->ExtentCount) {
+    Extent = &File->Extent[Index];
+    File->CurrentCluster     = Extent->Cluster + (File->CurrentPos - Extent->FilePos) / File->Volume->ClusterSize;
+    File->StraightReadAmount = Extent->FilePos + Extent->Length - File->CurrentPos;
+  } else {
+    File->CurrentCluster     = (UINT32) FAT_CLUSTER_LAST;
+    File->StraightReadAmount = 0;
+  }
+
+  return EFI_SUCCESS;
+}
+
+
 /**
   Reads file data. Updates the file's CurrentPos.
 
@@ -411,6 +640,10 @@ FatReadFile (
     if ((File->Attributes & FAT_ATTR_DIRECTORY) == 0) {
       Size = Size < (File->FileSize - File->CurrentPos) ? Size : (File->FileSize - File->CurrentPos);
     }
+
+    if (File->Extent != NULL) {
+      return FatReadFileExtents (PrivateData, File, Size, Buffer);
+    }
     //
     // This is a normal cluster based file
     //
@@ -81,6 +81,48 @@ FatGetVolumeData (
   return Status;
 }
 
+/**
+  Check if a block device can be read from the physical media directly.
+
+  A logical block device whose partition is block aligned on a physical
+  device does not need to go through the parent device (and its cache).
+
+  @param  PrivateData       Global memory map for accessing global variables
+  @param  BlockDeviceNo     The index for the block device number.
+  @param  StartLba          The physical LBA of the block device's first block.
+
+  @retval TRUE              The device can be read from the media directly.
+  @retval FALSE             The device must be read through its parent.
+
+**/
+STATIC
+BOOLEAN
+FatGetPhysicalLba (
+  IN  PEI_FAT_PRIVATE_DATA   *PrivateData,
+  IN  UINTN                  BlockDeviceNo,
+  OUT UINT64                 *StartLba
+  )
+{
+  PEI_FAT_BLOCK_DEVICE  *BlockDev;
+  PEI_FAT_BLOCK_DEVICE  *ParentDev;
+  UINT32                Remainder;
+
+  BlockDev = &PrivateData->BlockDevice[BlockDeviceNo];
+  if (!BlockDev->Logical) {
+    *StartLba = BlockDev->StartingPos;
+    return TRUE;
+  }
+
+  ParentDev = &PrivateData->BlockDevice[BlockDev->ParentDevNo];
+  if (ParentDev->Logical || (ParentDev->BlockSize != BlockDev->BlockSize)) {
+    return FALSE;
+  }
+
+  *StartLba = DivU64x32Remainder (BlockDev->StartingPos, BlockDev->BlockSize, &Remainder);
+  return (BOOLEAN) (Remainder == 0);
+}
+
+
 /**
   Reads a block of data from the block device by calling
   underlying Block I/O service.
@@ -108,6 +150,7 @@ FatReadBlock (
 {
   EFI_STATUS            Status;
   PEI_FAT_BLOCK_DEVICE  *BlockDev;
+  UINT64                StartLba;
 
   if (BlockDeviceNo > PEI_FAT_MAX_BLOCK_DEVICE - 1) {
     return EFI_DEVICE_ERROR;
@@ -120,8 +163,8 @@ FatReadBlock (
     return EFI_DEVICE_ERROR;
   }
 
-  if (!BlockDev->Logical) {
-    Status = MediaReadBlocks (BlockDev->PhysicalDevNo, (UINT32) (Lba + BlockDev->StartingPos), BufferSize, Buffer);
+  if (FatGetPhysicalLba (PrivateData, BlockDeviceNo, &StartLba)) {
+    Status = MediaReadBlocks (BlockDev->PhysicalDevNo, (UINT32) (StartLba + Lba), BufferSize, Buffer);
   } else {
     Status = FatReadDisk (
                PrivateData,
@@ -136,13 +179,282 @@ FatReadBlock (
 }
 
 
+/**
+  Initialize the block cache for a FAT instance.
+
+  The number of cached blocks and the FAT region read-ahead window are
+  configured through PcdFatCacheBlockCount and PcdFatCacheReadAheadBlocks.
+
+  @param  PrivateData       the global memory map.
+  @param  BlockSize         the block size of the underlying device.
+
+  @retval EFI_SUCCESS            The cache was initialized.
+  @retval EFI_INVALID_PARAMETER  The block size is not supported.
+  @retval EFI_OUT_OF_RESOURCES   Insufficient memory for the cache.
+
+**/
+EFI_STATUS
+FatInitCache (
+  IN  PEI_FAT_PRIVATE_DATA  *PrivateData,
+  IN  UINT32                BlockSize
+  )
+{
+  PEI_FAT_CACHE         *Cache;
+  UINT8                 *Data;
+  UINT32                Buckets;
+  UINT32                Index;
+
+  if ((BlockSize == 0) || (BlockSize > PEI_FAT_MAX_BLOCK_SIZE)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Cache = &PrivateData->Cache;
+  ZeroMem (Cache, sizeof (PEI_FAT_CACHE));
+
+  Cache->BlockSize  = BlockSize;
+  Cache->BlockCount = MAX (FixedPcdGet32 (PcdFatCacheBlockCount), 4);
+  Cache->ReadAheadBlocks = MIN (FixedPcdGet32 (PcdFatCacheReadAheadBlocks), Cache->BlockCount / 2);
+
+  Buckets = GetPowerOfTwo32 (Cache->BlockCount);
+  if (Buckets < Cache->BlockCount) {
+    Buckets <<= 1;
+  }
+  Cache->HashMask = Buckets - 1;
+
+  Cache->HashHead = (UINT32 *) AllocatePool (Buckets * sizeof (UINT32));
+  Cache->Entry    = (PEI_FAT_CACHE_BUFFER *) AllocateZeroPool (Cache->BlockCount * sizeof (PEI_FAT_CACHE_BUFFER));
+  Data            = (UINT8 *) AllocatePool (Cache->BlockCount * BlockSize);
+  if (Cache->ReadAheadBlocks > 1) {
+    Cache->ReadAheadBuffer = (UINT8 *) AllocatePool (Cache->ReadAheadBlocks * BlockSize);
+  }
+
+  if ((Cache->HashHead == NULL) || (Cache->Entry == NULL) || (Data == NULL) ||
+      ((Cache->ReadAheadBlocks > 1) && (Cache->ReadAheadBuffer == NULL))) {
+    if (Data != NULL) {
+      FreePool (Data);
+    }
+    FatFreeCache (PrivateData);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  SetMem (Cache->HashHead, Buckets * sizeof (UINT32), 0xFF);
+  for (Index = 0; Index < Cache->BlockCount; Index++) {
+    Cache->Entry[Index].Buffer   = Data + Index * BlockSize;
+    Cache->Entry[Index].HashNext = PEI_FAT_CACHE_INDEX_NULL;
+    Cache->Entry[Index].LruPrev  = (Index == 0) ? PEI_FAT_CACHE_INDEX_NULL : Index - 1;
+    Cache->Entry[Index].LruNext  = (Index == Cache->BlockCount - 1) ? PEI_FAT_CACHE_INDEX_NULL : Index + 1;
+  }
+  Cache->LruHead = 0;
+  Cache->LruTail = Cache->BlockCount - 1;
+
+  return EFI_SUCCESS;
+}
+
+
+/**
+  Free the block cache of a FAT instance.
+
+  @param  PrivateData       the global memory map.
+
+**/
+VOID
+FatFreeCache (
+  IN  PEI_FAT_PRIVATE_DATA  *PrivateData
+  )
+{
+  PEI_FAT_CACHE         *Cache;
+
+  Cache = &PrivateData->Cache;
+  if (Cache->Entry != NULL) {
+    if (Cache->Entry[0].Buffer != NULL) {
+      FreePool (Cache->Entry[0].Buffer);
+    }
+    FreePool (Cache->Entry);
+  }
+  if (Cache->HashHead != NULL) {
+    FreePool (Cache->HashHead);
+  }
+  if (Cache->ReadAheadBuffer != NULL) {
+    FreePool (Cache->ReadAheadBuffer);
+  }
+  ZeroMem (Cache, sizeof (PEI_FAT_CACHE));
+}
+
+
+/**
+  Get the hash bucket for a cached block.
+
+  @param  Cache             the block cache.
+  @param  BlockDeviceNo     the Block device.
+  @param  Lba               the Logical Block Address
+
+  @return the hash bucket index.
+
+**/
+STATIC
+UINT32
+FatCacheHash (
+  IN  PEI_FAT_CACHE         *Cache,
+  IN  UINTN                 BlockDeviceNo,
+  IN  UINT64                Lba
+  )
+{
+  UINT32                Hash;
+
+  Hash = (UINT32) Lba ^ (UINT32) RShiftU64 (Lba, 32) ^ ((UINT32) BlockDeviceNo * 0x9E3779B1);
+  Hash ^= Hash >> 16;
+  return Hash & Cache->HashMask;
+}
+
+
+/**
+  Move a cache entry to the most recently used end of the LRU list.
+
+  @param  Cache             the block cache.
+  @param  Index             the cache entry index.
+
+**/
+STATIC
+VOID
+FatCacheTouch (
+  IN  PEI_FAT_CACHE         *Cache,
+  IN  UINT32                Index
+  )
+{
+  PEI_FAT_CACHE_BUFFER  *CacheBuffer;
+
+  if (Cache->LruHead == Index) {
+    return;
+  }
+
+  //
+  // Unlink it, it is not the head so it has a previous entry
+  //
+  CacheBuffer = &Cache->Entry[Index];
+  Cache->Entry[CacheBuffer->LruPrev].LruNext = CacheBuffer->LruNext;
+  if (CacheBuffer->LruNext != PEI_FAT_CACHE_INDEX_NULL) {
+    Cache->Entry[CacheBuffer->LruNext].LruPrev = CacheBuffer->LruPrev;
+  } else {
+    Cache->LruTail = CacheBuffer->LruPrev;
+  }
+
+  //
+  // And put it in front of the list
+  //
+  CacheBuffer->LruPrev = PEI_FAT_CACHE_INDEX_NULL;
+  CacheBuffer->LruNext = Cache->LruHead;
+  Cache->Entry[Cache->LruHead].LruPrev = Index;
+  Cache->LruHead = Index;
+}
+
+
+/**
+  Look up a block in the cache.
+
+  @param  Cache             the block cache.
+  @param  BlockDeviceNo     the Block device.
+  @param  Lba               the Logical Block Address
+
+  @return the cache entry holding the block, or NULL if it is not cached.
+
+**/
+STATIC
+PEI_FAT_CACHE_BUFFER *
+FatCacheLookup (
+  IN  PEI_FAT_CACHE         *Cache,
+  IN  UINTN                 BlockDeviceNo,
+  IN  UINT64                Lba
+  )
+{
+  UINT32                Index;
+  PEI_FAT_CACHE_BUFFER  *CacheBuffer;
+
+  Index = Cache->HashHead[FatCacheHash (Cache, BlockDeviceNo, Lba)];
+  while (Index != PEI_FAT_CACHE_INDEX_NULL) {
+    CacheBuffer = &Cache->Entry[Index];
+    if (CacheBuffer->Valid && CacheBuffer->BlockDeviceNo == BlockDeviceNo && CacheBuffer->Lba == Lba) {
+      return CacheBuffer;
+    }
+    Index = CacheBuffer->HashNext;
+  }
+
+  return NULL;
+}
+
+
+/**
+  Insert a block into the cache, recycling the least recently used entry.
+
+  @param  Cache             the block cache.
+  @param  BlockDeviceNo     the Block device.
+  @param  Lba               the Logical Block Address
+  @param  Data              the block data.
+
+  @return the cache entry now holding the block.
+
+**/
+STATIC
+PEI_FAT_CACHE_BUFFER *
+FatCacheInsert (
+  IN  PEI_FAT_CACHE         *Cache,
+  IN  UINTN                 BlockDeviceNo,
+  IN  UINT64                Lba,
+  IN  UINT8                 *Data
+  )
+{
+  UINT32                Victim;
+  UINT32                *Link;
+  UINT32                Bucket;
+  PEI_FAT_CACHE_BUFFER  *CacheBuffer;
+
+  //
+  // Recycle the least recently used entry. Entries that were never used
+  // are behind all used ones, so they are picked first.
+  //
+  Victim = Cache->LruTail;
+
+  //
+  // Unlink it from its old hash chain
+  //
+  CacheBuffer = &Cache->Entry[Victim];
+  if (CacheBuffer->Valid) {
+    Link = &Cache->HashHead[FatCacheHash (Cache, CacheBuffer->BlockDeviceNo, CacheBuffer->Lba)];
+    while (*Link != PEI_FAT_CACHE_INDEX_NULL) {
+      if (*Link == Victim) {
+        *Link = CacheBuffer->HashNext;
+        break;
+      }
+      Link = &Cache->Entry[*Link].HashNext;
+    }
+  }
+
+  CopyMem (CacheBuffer->Buffer, Data, Cache->BlockSize);
+  CacheBuffer->BlockDeviceNo  = BlockDeviceNo;
+  CacheBuffer->Lba            = Lba;
+  CacheBuffer->Size           = Cache->BlockSize;
+  CacheBuffer->Valid          = TRUE;
+  FatCacheTouch (Cache, Victim);
+
+  Bucket = FatCacheHash (Cache, BlockDeviceNo, Lba);
+  CacheBuffer->HashNext       = Cache->HashHead[Bucket];
+  Cache->HashHead[Bucket]     = Victim;
+
+  return CacheBuffer;
+}
+
+
 /**
   Find a cache block designated to specific Block device and Lba.
   If not found, invalidate an oldest one and use it. (LRU cache)
 
+  On a miss, up to ReadAheadEnd - Lba blocks (bounded by the configured
+  read-ahead window) are fetched with a single media read and cached.
+
   @param  PrivateData       the global memory map.
   @param  BlockDeviceNo     the Block device.
   @param  Lba               the Logical Block Address
+  @param  ReadAheadEnd      the first LBA that should not be prefetched.
+                            0 disables the read-ahead.
   @param  CachePtr          Ptr to the starting address of the memory holding the
                             data;
 
@@ -150,104 +462,137 @@ FatReadBlock (
   @retval EFI_DEVICE_ERROR  Something error while accessing media.
 
 **/
+STATIC
 EFI_STATUS
 FatGetCacheBlock (
   IN  PEI_FAT_PRIVATE_DATA  *PrivateData,
   IN  UINTN                 BlockDeviceNo,
   IN  UINT64                Lba,
+  IN  UINT64                ReadAheadEnd,
   OUT CHAR8                 **CachePtr
   )
 {
   EFI_STATUS            Status;
+  PEI_FAT_CACHE         *Cache;
   PEI_FAT_CACHE_BUFFER  *CacheBuffer;
-  INTN                  Index;
-  STATIC UINT8          Seed;
-
-  Status      = EFI_SUCCESS;
-  CacheBuffer = NULL;
+  PEI_FAT_BLOCK_DEVICE  *BlockDev;
+  UINT8                 *ReadBuffer;
+  UINT64                StartLba;
+  UINT32                Count;
+  UINT32                Index;
 
   //
-  // go through existing cache buffers
+  // Current device ID should be less than maximum device ID.
   //
-  for (Index = 0; Index < PEI_FAT_CACHE_SIZE; Index++) {
-    CacheBuffer = & (PrivateData->CacheBuffer[Index]);
-    if (CacheBuffer->Valid && CacheBuffer->BlockDeviceNo == BlockDeviceNo && CacheBuffer->Lba == Lba) {
-      break;
-    }
+  if (BlockDeviceNo >= PEI_FAT_MAX_BLOCK_DEVICE) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  Cache    = &PrivateData->Cache;
+  BlockDev = &PrivateData->BlockDevice[BlockDeviceNo];
+  if ((Cache->Entry == NULL) || (BlockDev->BlockSize != Cache->BlockSize)) {
+    return EFI_DEVICE_ERROR;
   }
 
-  if (Index < PEI_FAT_CACHE_SIZE) {
+  CacheBuffer = FatCacheLookup (Cache, BlockDeviceNo, Lba);
+  if (CacheBuffer != NULL) {
+    Cache->Hits++;
+    FatCacheTouch (Cache, (UINT32) (CacheBuffer - Cache->Entry));
     *CachePtr = (CHAR8 *) CacheBuffer->Buffer;
     return EFI_SUCCESS;
   }
+
+  Cache->Misses++;
+
   //
-  // We have to find an invalid cache buffer
+  // Work out how many blocks to fetch in one go
   //
-  for (Index = 0; Index < PEI_FAT_CACHE_SIZE; Index++) {
-    if (!PrivateData->CacheBuffer[Index].Valid) {
-      break;
+  Count = 1;
+  if ((Cache->ReadAheadBlocks > 1) && (ReadAheadEnd > Lba)) {
+    Count = (UINT32) MIN (ReadAheadEnd - Lba, Cache->ReadAheadBlocks);
+    if (Lba + Count - 1 > BlockDev->LastBlock) {
+      Count = (UINT32) (BlockDev->LastBlock - Lba + 1);
+    }
+    //
+    // Stop the window at the first block that is already cached
+    //
+    for (Index = 1; Index < Count; Index++) {
+      if (FatCacheLookup (Cache, BlockDeviceNo, Lba + Index) != NULL) {
+        Count = Index;
+        break;
+      }
     }
-  }
-  //
-  // Use the cache buffer
-  //
-  if (Index == PEI_FAT_CACHE_SIZE) {
-    Index = (Seed++) % PEI_FAT_CACHE_SIZE;
   }
 
   //
-  // Current device ID should be less than maximum device ID.
+  // Read in the data. The blocks are read into a scratch buffer first and
+  // only copied into cache entries afterwards. A device that is read
+  // through its parent re-enters the cache, so it gets its own buffer.
   //
-  if (BlockDeviceNo >= PEI_FAT_MAX_BLOCK_DEVICE) {
-    return EFI_DEVICE_ERROR;
+  if (!FatGetPhysicalLba (PrivateData, BlockDeviceNo, &StartLba)) {
+    Count      = 1;
+    ReadBuffer = (UINT8 *) AllocatePool (Cache->BlockSize);
+    if (ReadBuffer == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+  } else if (Count > 1) {
+    ReadBuffer = Cache->ReadAheadBuffer;
+  } else {
+    ReadBuffer = (UINT8 *) PrivateData->BlockData;
   }
 
-  CacheBuffer                 = & (PrivateData->CacheBuffer[Index]);
-
-  CacheBuffer->BlockDeviceNo  = BlockDeviceNo;
-  CacheBuffer->Lba            = Lba;
-  CacheBuffer->Size           = PrivateData->BlockDevice[BlockDeviceNo].BlockSize;
-
-  //
-  // Read in the data
-  //
   Status = FatReadBlock (
              PrivateData,
              BlockDeviceNo,
              Lba,
-             CacheBuffer->Size,
-             CacheBuffer->Buffer
+             Count * Cache->BlockSize,
+             ReadBuffer
              );
   if (EFI_ERROR (Status)) {
-    return EFI_DEVICE_ERROR;
+    Status = EFI_DEVICE_ERROR;
+  } else {
+    //
+    // Insert the prefetched blocks first so the requested one is the most recent
+    //
+    for (Index = 1; Index < Count; Index++) {
+      FatCacheInsert (Cache, BlockDeviceNo, Lba + Index, ReadBuffer + Index * Cache->BlockSize);
+    }
+    Cache->PrefetchedBlocks += Count - 1;
+
+    CacheBuffer = FatCacheInsert (Cache, BlockDeviceNo, Lba, ReadBuffer);
+    *CachePtr   = (CHAR8 *) CacheBuffer->Buffer;
   }
 
-  CacheBuffer->Valid  = TRUE;
-  *CachePtr           = (CHAR8 *) CacheBuffer->Buffer;
+  if ((ReadBuffer != Cache->ReadAheadBuffer) && (ReadBuffer != (UINT8 *) PrivateData->BlockData)) {
+    FreePool (ReadBuffer);
+  }
 
   return Status;
 }
 
 
 /**
-  Disk reading.
+  Disk reading through the block cache.
 
   @param  PrivateData       the global memory map;
   @param  BlockDeviceNo     the block device to read;
   @param  StartingAddress   the starting address.
   @param  Size              the amount of data to read.
+  @param  ReadAheadEnd      the first LBA that should not be prefetched.
   @param  Buffer            the buffer holding the data
 
   @retval EFI_SUCCESS       The function completed successfully.
   @retval EFI_DEVICE_ERROR  Something error.
 
 **/
+STATIC
 EFI_STATUS
-FatReadDisk (
+FatReadDiskInternal (
   IN  PEI_FAT_PRIVATE_DATA  *PrivateData,
   IN  UINTN                 BlockDeviceNo,
   IN  UINT64                StartingAddress,
   IN  UINTN                 Size,
+  IN  UINT64                ReadAheadEnd,
   OUT VOID                  *Buffer
   )
 {
@@ -268,7 +613,7 @@ FatReadDisk (
   // Read underrun
   //
   Lba     = DivU64x32Remainder (StartingAddress, BlockSize, &Offset);
-  Status  = FatGetCacheBlock (PrivateData, BlockDeviceNo, Lba, &CachePtr);
+  Status  = FatGetCacheBlock (PrivateData, BlockDeviceNo, Lba, ReadAheadEnd, &CachePtr);
   if (EFI_ERROR (Status)) {
     return EFI_DEVICE_ERROR;
   }
@@ -291,9 +636,11 @@ FatReadDisk (
   OverRunLba = Lba + DivU64x32Remainder (Size, BlockSize, &Offset);
 
   Size -= Offset;
-  Status = FatReadBlock (PrivateData, BlockDeviceNo, Lba, Size, BufferPtr);
-  if (EFI_ERROR (Status)) {
-    return EFI_DEVICE_ERROR;
+  if (Size > 0) {
+    Status = FatReadBlock (PrivateData, BlockDeviceNo, Lba, Size, BufferPtr);
+    if (EFI_ERROR (Status)) {
+      return EFI_DEVICE_ERROR;
+    }
   }
 
   BufferPtr += Size;
@@ -302,7 +649,7 @@ FatReadDisk (
   // Read overrun
   //
   if (Offset != 0) {
-    Status = FatGetCacheBlock (PrivateData, BlockDeviceNo, OverRunLba, &CachePtr);
+    Status = FatGetCacheBlock (PrivateData, BlockDeviceNo, OverRunLba, ReadAheadEnd, &CachePtr);
     if (EFI_ERROR (Status)) {
       return EFI_DEVICE_ERROR;
     }
@@ -314,6 +661,71 @@ FatReadDisk (
 }
 
 
+/**
+  Disk reading.
+
+  @param  PrivateData       the global memory map;
+  @param  BlockDeviceNo     the block device to read;
+  @param  StartingAddress   the starting address.
+  @param  Size              the amount of data to read.
+  @param  Buffer            the buffer holding the data
+
+  @retval EFI_SUCCESS       The function completed successfully.
+  @retval EFI_DEVICE_ERROR  Something error.
+
+**/
+EFI_STATUS
+FatReadDisk (
+  IN  PEI_FAT_PRIVATE_DATA  *PrivateData,
+  IN  UINTN                 BlockDeviceNo,
+  IN  UINT64                StartingAddress,
+  IN  UINTN                 Size,
+  OUT VOID                  *Buffer
+  )
+{
+  return FatReadDiskInternal (PrivateData, BlockDeviceNo, StartingAddress, Size, 0, Buffer);
+}
+
+
+/**
+  Read data from the FAT region of a volume.
+
+  FAT entries are read a few bytes at a time while walking cluster chains,
+  so a cache miss in the FAT region prefetches a whole window of blocks.
+
+  @param  PrivateData       the global memory map;
+  @param  Volume            the volume;
+  @param  StartingAddress   the starting address within the FAT region.
+  @param  Size              the amount of data to read.
+  @param  Buffer            the buffer holding the data
+
+  @retval EFI_SUCCESS       The function completed successfully.
+  @retval EFI_DEVICE_ERROR  Something error.
+
+**/
+EFI_STATUS
+FatReadFatRegion (
+  IN  PEI_FAT_PRIVATE_DATA  *PrivateData,
+  IN  PEI_FAT_VOLUME        *Volume,
+  IN  UINT64                StartingAddress,
+  IN  UINTN                 Size,
+  OUT VOID                  *Buffer
+  )
+{
+  UINT32      BlockSize;
+  UINT32      Remainder;
+  UINT64      FatEndLba;
+
+  //
+  // The FAT copies end where the root directory region starts
+  //
+  BlockSize = PrivateData->BlockDevice[Volume->BlockDeviceNo].BlockSize;
+  FatEndLba = DivU64x32Remainder (Volume->RootDirPos + BlockSize - 1, BlockSize, &Remainder);
+
+  return FatReadDiskInternal (PrivateData, Volume->BlockDeviceNo, StartingAddress, Size, FatEndLba, Buffer);
+}
+
+
 /**
   This version is different from the version in Unicode collation
   protocol in that this version strips off trailing blanks.
@@ -26,7 +26,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 // Definitions
 //
-#define PEI_FAT_CACHE_SIZE                            4
+#define PEI_FAT_CACHE_INDEX_NULL                       0xFFFFFFFF
 #define PEI_FAT_MAX_BLOCK_SIZE                        8192
 #define FAT_MAX_FILE_NAME_LENGTH                      128
 #define PEI_FAT_MAX_BLOCK_DEVICE                      64
@@ -78,6 +78,16 @@ typedef struct {
   UINT32        RootDirCluster;
 } PEI_FAT_VOLUME;
 
+//
+// A run of physically contiguous clusters of a file
+//
+typedef struct {
+  UINT32          FilePos;
+  UINT32          Cluster;
+  UINT32          Length;
+  UINT64          Position;
+} PEI_FAT_EXTENT;
+
 //
 // File instance
 //
@@ -92,6 +102,8 @@ typedef struct {
   UINT32          CurrentCluster;
   UINT8           Attributes;
   UINT32          FileSize;
+  UINT32          ExtentCount;
+  PEI_FAT_EXTENT  *Extent;
 } PEI_FAT_FILE;
 
 //
@@ -101,11 +113,34 @@ typedef struct {
   BOOLEAN Valid;
   UINTN   BlockDeviceNo;
   UINT64  Lba;
-  UINT32  Lru;
-  UINT64  Buffer[PEI_FAT_MAX_BLOCK_SIZE / 8];
+  UINT32  LruPrev;
+  UINT32  LruNext;
+  UINT32  HashNext;
+  UINT8   *Buffer;
   UINTN   Size;
 } PEI_FAT_CACHE_BUFFER;
 
+//
+// Block cache shared by all block devices of a FAT instance.
+// Entries are looked up through a hash table keyed by (BlockDeviceNo, Lba).
+// All entries are kept on a list from the most (LruHead) to the least
+// (LruTail) recently used one, and the tail is recycled on a miss.
+//
+typedef struct {
+  UINT32                BlockCount;
+  UINT32                BlockSize;
+  UINT32                ReadAheadBlocks;
+  UINT32                HashMask;
+  UINT32                LruHead;
+  UINT32                LruTail;
+  UINT32                *HashHead;
+  PEI_FAT_CACHE_BUFFER  *Entry;
+  UINT8                 *ReadAheadBuffer;
+  UINT64                Hits;
+  UINT64                Misses;
+  UINT64                PrefetchedBlocks;
+} PEI_FAT_CACHE;
+
 //
 // Private Data.
 // This structure abstracts the whole memory usage in FAT PEIM.
@@ -176,7 +211,7 @@ typedef struct {
   UINTN                               VolumeCount;
   PEI_FAT_VOLUME                      Volume[PEI_FAT_MAX_VOLUME];
   PEI_FAT_FILE                        File;
-  PEI_FAT_CACHE_BUFFER                CacheBuffer[PEI_FAT_CACHE_SIZE];
+  PEI_FAT_CACHE                       Cache;
 } PEI_FAT_PRIVATE_DATA;
 
 
@@ -332,6 +367,65 @@ FatReadDisk (
   );
 
 
+/**
+  Read data from the FAT region of a volume.
+
+  FAT entries are read a few bytes at a time while walking cluster chains,
+  so a cache miss in the FAT region prefetches a whole window of blocks.
+
+  @param  PrivateData       the global memory map;
+  @param  Volume            the volume;
+  @param  StartingAddress   the starting address within the FAT region.
+  @param  Size              the amount of data to read.
+  @param  Buffer            the buffer holding the data
+
+  @retval EFI_SUCCESS       The function completed successfully.
+  @retval EFI_DEVICE_ERROR  Something error.
+
+**/
+EFI_STATUS
+FatReadFatRegion (
+  IN  PEI_FAT_PRIVATE_DATA  *PrivateData,
+  IN  PEI_FAT_VOLUME        *Volume,
+  IN  UINT64                StartingAddress,
+  IN  UINTN                 Size,
+  OUT VOID                  *Buffer
+  );
+
+
+/**
+  Initialize the block cache for a FAT instance.
+
+  The number of cached blocks and the FAT region read-ahead window are
+  configured through PcdFatCacheBlockCount and PcdFatCacheReadAheadBlocks.
+
+  @param  PrivateData       the global memory map.
+  @param  BlockSize         the block size of the underlying device.
+
+  @retval EFI_SUCCESS            The cache was initialized.
+  @retval EFI_INVALID_PARAMETER  The block size is not supported.
+  @retval EFI_OUT_OF_RESOURCES   Insufficient memory for the cache.
+
+**/
+EFI_STATUS
+FatInitCache (
+  IN  PEI_FAT_PRIVATE_DATA  *PrivateData,
+  IN  UINT32                BlockSize
+  );
+
+
+/**
+  Free the block cache of a FAT instance.
+
+  @param  PrivateData       the global memory map.
+
+**/
+VOID
+FatFreeCache (
+  IN  PEI_FAT_PRIVATE_DATA  *PrivateData
+  );
+
+
 /**
   Set a file's CurrentPos and CurrentCluster, then compute StraightReadAmount.
 
@@ -353,6 +447,41 @@ FatSetFilePos (
   );
 
 
+/**
+  Build the extent map of a file.
+
+  The cluster chain is walked once and collapsed into runs of physically
+  contiguous clusters, so that later reads do not need any FAT lookups.
+
+  @param  PrivateData            the global memory map
+  @param  File                   the file
+
+  @retval EFI_SUCCESS            The extent map is built.
+  @retval EFI_UNSUPPORTED        The file is a directory.
+  @retval EFI_VOLUME_CORRUPTED   The cluster chain is shorter than the file.
+  @retval EFI_OUT_OF_RESOURCES   Insufficient memory for the extent map.
+  @retval EFI_DEVICE_ERROR       Something error while accessing media.
+
+**/
+EFI_STATUS
+FatBuildExtentMap (
+  IN  PEI_FAT_PRIVATE_DATA  *PrivateData,
+  IN  PEI_FAT_FILE          *File
+  );
+
+
+/**
+  Free the extent map of a file.
+
+  @param  File                   the file
+
+**/
+VOID
+FatFreeExtentMap (
+  IN  PEI_FAT_FILE          *File
+  );
+
+
 /**
   Reads file data. Updates the file's CurrentPos.
 
@@ -1,7 +1,7 @@
 /** @file
   File system level API library interface
 
-Copyright (c) 2017 - 2020, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2017 - 2026, Intel Corporation. All rights reserved.<BR>
 
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -53,8 +53,10 @@ RegisterFileSystems (
       mFileSystemFuncs[FsType].OpenFile         = FatFsOpenFile;
       mFileSystemFuncs[FsType].GetFileSize      = FatFsGetFileSize;
       mFileSystemFuncs[FsType].ReadFile         = FatFsReadFile;
+      mFileSystemFuncs[FsType].ReadFileChunk    = FatFsReadFileChunk;
       mFileSystemFuncs[FsType].CloseFile        = FatFsCloseFile;
       mFileSystemFuncs[FsType].ListDir          = FatFsListDir;
+      mFileSystemFuncs[FsType].GetCacheInfo     = FatFsGetCacheInfo;
     }
 
     FsType = EnumFileSystemTypeExt2;
@@ -64,6 +66,7 @@ RegisterFileSystems (
       mFileSystemFuncs[FsType].OpenFile         = ExtFsOpenFile;
       mFileSystemFuncs[FsType].GetFileSize      = ExtFsGetFileSize;
       mFileSystemFuncs[FsType].ReadFile         = ExtFsReadFile;
+      mFileSystemFuncs[FsType].ReadFileChunk    = ExtFsReadFileChunk;
       mFileSystemFuncs[FsType].CloseFile        = ExtFsCloseFile;
       mFileSystemFuncs[FsType].ListDir          = ExtFsListDir;
     }
@@ -417,6 +420,59 @@ ReadFile (
   return mFileSystemFuncs[FsType].ReadFile (FileSystemControlBlock->FsHandle, FileControlBlock->FileHandle, FileBuffer, FileSize);
 }
 
+/**
+  Read the next part of a file by opened file handle.
+
+  The data is read from the current position of the file, which is moved
+  past the data read. It allows a caller to process the file while it is
+  being read.
+
+  @param[in]     FileHandle       file handle
+  @param[out]    Buffer           Buffer to receive the data.
+  @param[in,out] Size             On input, the number of bytes to read. On
+                                  output, the number of bytes read, which is
+                                  smaller at the end of the file.
+
+  @retval EFI_SUCCESS             The data was read correctly.
+  @retval EFI_INVALID_PARAMETER   Parameter is not valid.
+  @retval EFI_UNSUPPORTED         The file system does not support it.
+  @retval EFI_DEVICE_ERROR        A device error occurred.
+
+**/
+EFI_STATUS
+EFIAPI
+ReadFileChunk (
+  IN     EFI_HANDLE                               FileHandle,
+  OUT    VOID                                    *Buffer,
+  IN OUT UINTN                                   *Size
+  )
+{
+  OS_FILE_SYSTEM_TYPE         FsType;
+  FILE_SYSTEM_CONTROL_BLOCK  *FileSystemControlBlock;
+  FILE_CONTROL_BLOCK         *FileControlBlock;
+
+  if ((FileHandle == NULL) || (Buffer == NULL) || (Size == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  FileControlBlock = (FILE_CONTROL_BLOCK *)FileHandle;
+  ASSERT (FileControlBlock->Signature == FILE_CB_SIGNATURE);
+
+  FileSystemControlBlock = (FILE_SYSTEM_CONTROL_BLOCK *)FileControlBlock->FileSystemControlBlock;
+  ASSERT (FileSystemControlBlock->Signature == FILE_SYSTEM_CB_SIGNATURE);
+
+  FsType = GetFileSystemType (FileSystemControlBlock);
+  if (FsType >= EnumFileSystemTypeAuto) {
+    return EFI_NOT_READY;
+  }
+
+  if (mFileSystemFuncs[FsType].ReadFileChunk == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return mFileSystemFuncs[FsType].ReadFileChunk (FileSystemControlBlock->FsHandle, FileControlBlock->FileHandle, Buffer, Size);
+}
+
 /**
   Close a file by opened file handle
 
@@ -503,3 +559,41 @@ DEBUG_CODE_END ();
 
   return EFI_UNSUPPORTED;
 }
+
+/**
+  Get block cache statistics of a file system
+
+  @param[in]     FsHandle         file system handle.
+  @param[out]    CacheInfo        block cache statistics.
+
+  @retval EFI_SUCCESS             the statistics were returned
+  @retval EFI_UNSUPPORTED         this api is not supported
+  @retval Others                  an error occurs
+
+**/
+EFI_STATUS
+EFIAPI
+GetFileSystemCacheInfo (
+  IN  EFI_HANDLE                                  FsHandle,
+  OUT FS_CACHE_INFO                              *CacheInfo
+  )
+{
+  OS_FILE_SYSTEM_TYPE         FsType;
+  FILE_SYSTEM_CONTROL_BLOCK  *FileSystemControlBlock;
+
+  FileSystemControlBlock = (FILE_SYSTEM_CONTROL_BLOCK *)FsHandle;
+  if ((FileSystemControlBlock == NULL) || (CacheInfo == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  FsType = GetFileSystemType (FsHandle);
+  if (FsType >= EnumFileSystemTypeAuto) {
+    return EFI_NOT_READY;
+  }
+
+  if (mFileSystemFuncs[FsType].GetCacheInfo != NULL) {
+    return mFileSystemFuncs[FsType].GetCacheInfo (FileSystemControlBlock->FsHandle, CacheInfo);
+  }
+
+  return EFI_UNSUPPORTED;
+}
@@ -1,7 +1,7 @@
 /** @file
   Basic graphics rendering support
 
-  Copyright (c) 2017 - 2019, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2017 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -36,6 +36,36 @@ CONST EFI_GRAPHICS_OUTPUT_BLT_PIXEL mColors[16] = {
 
 STATIC FRAME_BUFFER_CONSOLE mFbConsole;
 
+/**
+  Get the glyph table index of an ASCII character.
+
+  @param[in] Glyph               ASCII character
+
+  @retval    Index of the character in the glyph table
+
+**/
+STATIC
+UINTN
+GetGlyphIndex (
+  IN CHAR8                         Glyph
+  )
+{
+  UINTN                            Code;
+  UINTN                            Base;
+
+  Code = (UINTN)(Glyph & 0xFF);
+  Base = 0xAF;
+  if ((Code >= Base) && (Code <= 0xF2)) {
+    Code = (0x80 - 0x20) + (Code - Base);
+  } else if ((Code >= 0x20) && (Code <= 0x7F)) {
+    Code = Code - 0x20;
+  } else {
+    Code = 0;
+  }
+
+  return Code;
+}
+
 /**
   Copy image into frame buffer.
 
@@ -116,8 +146,6 @@ BltGlyphToFrameBuffer (
   UINTN                            Width, Height;
   UINTN                            Row;
   UINTN                            Col;
-  UINTN                            Code;
-  UINTN                            Base;
   EFI_GRAPHICS_OUTPUT_BLT_PIXEL    GopBlt[GLYPH_WIDTH * GLYPH_HEIGHT];
 
   if (GfxInfoHob == NULL) {
@@ -128,18 +156,7 @@ BltGlyphToFrameBuffer (
   Height = GLYPH_HEIGHT;
 
   // Glyph table maps to ASCII characters, index the table with the character
-  Code = (UINTN)(Glyph & 0xFF);
-  Base = 0xAF;
-  if ((Code >= Base) && (Code <= 0xF2)) {
-    Code = (0x80 - 0x20) + (Code - Base);
-  } else if ((Code >= 0x20) && (Code <= 0x7F)) {
-    Code = Code - 0x20;
-  } else {
-    Code = 0;
-  }
-
-  // Glyph table maps to ASCII characters, index the table with the character
-  GlyphBitmap = gUsStdNarrowGlyphData[Code].GlyphCol1;
+  GlyphBitmap = gUsStdNarrowGlyphData[GetGlyphIndex (Glyph)].GlyphCol1;
 
   for (Row = 0; Row < Height; Row++) {
     for (Col = 0; Col < Width; Col++) {
@@ -150,6 +167,206 @@ BltGlyphToFrameBuffer (
   return BltToFrameBuffer (GfxInfoHob, GopBlt, Width, Height, OffX, OffY);
 }
 
+/**
+  Get the glyph atlas of a color pair, building it if needed.
+
+  @param[in] Console             Frame buffer console
+  @param[in] ForegroundColor     Foreground color
+  @param[in] BackgroundColor     Background color
+
+  @retval    Glyph row pixels of the color pair
+
+**/
+STATIC
+UINT32 *
+GetGlyphAtlas (
+  IN FRAME_BUFFER_CONSOLE          *Console,
+  IN EFI_GRAPHICS_OUTPUT_BLT_PIXEL ForegroundColor,
+  IN EFI_GRAPHICS_OUTPUT_BLT_PIXEL BackgroundColor
+  )
+{
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION  Fg;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION  Bg;
+  GLYPH_ATLAS                         *Atlas;
+  UINTN                                Idx;
+  UINTN                                Bits;
+  UINTN                                Col;
+
+  Fg.Pixel = ForegroundColor;
+  Bg.Pixel = BackgroundColor;
+  for (Idx = 0; Idx < GLYPH_ATLAS_NUM; Idx++) {
+    Atlas = &Console->GlyphAtlas[Idx];
+    if (Atlas->Valid && (Atlas->Foreground == Fg.Raw) && (Atlas->Background == Bg.Raw)) {
+      return &Atlas->Pixels[0][0];
+    }
+  }
+
+  // Replace the oldest color pair
+  Atlas = &Console->GlyphAtlas[Console->NextAtlas];
+  Console->NextAtlas = (Console->NextAtlas + 1) % GLYPH_ATLAS_NUM;
+  for (Bits = 0; Bits < 256; Bits++) {
+    for (Col = 0; Col < GLYPH_WIDTH; Col++) {
+      Atlas->Pixels[Bits][Col] = ((Bits & (1 << (GLYPH_WIDTH - Col - 1))) != 0) ? Fg.Raw : Bg.Raw;
+    }
+  }
+  Atlas->Foreground = Fg.Raw;
+  Atlas->Background = Bg.Raw;
+  Atlas->Valid      = TRUE;
+
+  return &Atlas->Pixels[0][0];
+}
+
+/**
+  Get the shadow buffer pixels of a console row.
+
+  The text rows of the shadow buffer form a ring that starts at ShadowTop.
+
+  @param[in] Console             Frame buffer console
+  @param[in] CellY               Console row
+
+  @retval    Pointer to the first pixel of the row
+
+**/
+STATIC
+UINT32 *
+GetShadowRow (
+  IN FRAME_BUFFER_CONSOLE          *Console,
+  IN UINTN                         CellY
+  )
+{
+  UINTN                            Row;
+
+  Row = (Console->ShadowTop + CellY) % Console->Rows;
+  return &Console->ShadowBuf[Row * GLYPH_HEIGHT * Console->Cols * GLYPH_WIDTH];
+}
+
+/**
+  Draw a glyph into a console cell.
+
+  With a shadow frame buffer, the glyph is drawn into the shadow buffer and
+  the cell is marked dirty, to be copied to the frame buffer on the next flush.
+
+  @param[in] Console             Frame buffer console
+  @param[in] Glyph               ASCII character to write
+  @param[in] ForegroundColor     Foreground color to use
+  @param[in] BackgroundColor     Background color to use
+  @param[in] CellX               Console column
+  @param[in] CellY               Console row
+
+  @retval EFI_SUCCESS            Success
+  @retval EFI_INVALID_PARAMETER  Could not draw entire glyph in frame buffer
+
+**/
+STATIC
+EFI_STATUS
+DrawConsoleGlyph (
+  IN FRAME_BUFFER_CONSOLE          *Console,
+  IN CHAR8                         Glyph,
+  IN EFI_GRAPHICS_OUTPUT_BLT_PIXEL ForegroundColor,
+  IN EFI_GRAPHICS_OUTPUT_BLT_PIXEL BackgroundColor,
+  IN UINTN                         CellX,
+  IN UINTN                         CellY
+  )
+{
+  UINT8                            *GlyphBitmap;
+  UINT32                           *Atlas;
+  UINT32                           *RowPixels;
+  UINT32                           *Dst;
+  UINTN                            Stride;
+  UINTN                            Row;
+  UINTN                            Col;
+
+  if (Console->ShadowBuf == NULL) {
+    return BltGlyphToFrameBuffer (Console->GfxInfoHob, Glyph, ForegroundColor, BackgroundColor,
+                                  Console->OffX + CellX * GLYPH_WIDTH,
+                                  Console->OffY + CellY * GLYPH_HEIGHT);
+  }
+
+  if ((CellX >= Console->Cols) || (CellY >= Console->Rows)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Atlas       = GetGlyphAtlas (Console, ForegroundColor, BackgroundColor);
+  GlyphBitmap = gUsStdNarrowGlyphData[GetGlyphIndex (Glyph)].GlyphCol1;
+  Stride      = Console->Cols * GLYPH_WIDTH;
+  Dst         = GetShadowRow (Console, CellY) + CellX * GLYPH_WIDTH;
+  for (Row = 0; Row < GLYPH_HEIGHT; Row++) {
+    RowPixels = &Atlas[GlyphBitmap[Row] * GLYPH_WIDTH];
+    for (Col = 0; Col < GLYPH_WIDTH; Col++) {
+      Dst[Col] = RowPixels[Col];
+    }
+    Dst += Stride;
+  }
+
+  Console->DirtyBuf[CellY * Console->Cols + CellX] = 1;
+  Console->Dirty = TRUE;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Copy the dirty cells of the shadow buffer to the frame buffer.
+
+  Consecutive dirty cells of a row are copied together, so that the copy to the
+  frame buffer uses long runs of wide stores.
+
+  @param[in] Console             Frame buffer console
+
+**/
+STATIC
+VOID
+FlushFrameBufferConsole (
+  IN FRAME_BUFFER_CONSOLE          *Console
+  )
+{
+  EFI_PEI_GRAPHICS_INFO_HOB        *GfxInfoHob;
+  UINT32                           *FrameBufferPtr;
+  UINT32                           *Src;
+  UINT32                           *Dst;
+  UINT8                            *DirtyRow;
+  UINTN                            Stride;
+  UINTN                            FbStride;
+  UINTN                            CellX;
+  UINTN                            CellY;
+  UINTN                            Start;
+  UINTN                            Row;
+
+  if ((Console->ShadowBuf == NULL) || !Console->Dirty) {
+    return;
+  }
+
+  GfxInfoHob     = Console->GfxInfoHob;
+  FrameBufferPtr = (UINT32 *) (UINTN) (GfxInfoHob->FrameBufferBase);
+  FbStride       = GfxInfoHob->GraphicsMode.HorizontalResolution;
+  Stride         = Console->Cols * GLYPH_WIDTH;
+  for (CellY = 0; CellY < Console->Rows; CellY++) {
+    DirtyRow = &Console->DirtyBuf[CellY * Console->Cols];
+    CellX    = 0;
+    while (CellX < Console->Cols) {
+      if (DirtyRow[CellX] == 0) {
+        CellX++;
+        continue;
+      }
+
+      Start = CellX;
+      while ((CellX < Console->Cols) && (DirtyRow[CellX] != 0)) {
+        DirtyRow[CellX] = 0;
+        CellX++;
+      }
+
+      Src = GetShadowRow (Console, CellY) + Start * GLYPH_WIDTH;
+      Dst = &FrameBufferPtr[(Console->OffY + CellY * GLYPH_HEIGHT) * FbStride + Console->OffX + Start * GLYPH_WIDTH];
+      for (Row = 0; Row < GLYPH_HEIGHT; Row++) {
+        CopyMem (Dst, Src, (CellX - Start) * GLYPH_WIDTH * sizeof (UINT32));
+        Src += Stride;
+        Dst += FbStride;
+      }
+    }
+  }
+
+  Console->Dirty = FALSE;
+}
+
 /**
   Initialize the frame buffer console.
 
@@ -176,6 +393,7 @@ InitFrameBufferConsole (
 {
   FRAME_BUFFER_CONSOLE  *Console;
   BOOLEAN                ClearScreen;
+  UINTN                  ShadowSize;
 
   Console = &mFbConsole;
   if (Console->GfxInfoHob != NULL) {
@@ -214,6 +432,37 @@ InitFrameBufferConsole (
   Console->TextDrawBuf = AllocateZeroPool (Console->Rows * Console->Cols * 2);
   ASSERT (Console->TextDrawBuf != NULL);
 
+  // Draw into a shadow buffer in memory and copy only dirty cells to the frame buffer.
+  // Keep drawing to the frame buffer directly for large consoles or if there is not
+  // enough memory.
+  Console->ShadowBuf  = NULL;
+  Console->DirtyBuf   = NULL;
+  Console->GlyphAtlas = NULL;
+  ShadowSize = Console->Rows * GLYPH_HEIGHT * Console->Cols * GLYPH_WIDTH * sizeof (UINT32);
+  if (ShadowSize <= SHADOW_BUFFER_MAX_SIZE) {
+    Console->ShadowBuf  = AllocatePool (ShadowSize);
+    Console->DirtyBuf   = AllocateZeroPool (Console->Rows * Console->Cols);
+    Console->GlyphAtlas = AllocateZeroPool (GLYPH_ATLAS_NUM * sizeof (GLYPH_ATLAS));
+    if ((Console->ShadowBuf == NULL) || (Console->DirtyBuf == NULL) || (Console->GlyphAtlas == NULL)) {
+      if (Console->ShadowBuf != NULL) {
+        FreePool (Console->ShadowBuf);
+        Console->ShadowBuf = NULL;
+      }
+      if (Console->DirtyBuf != NULL) {
+        FreePool (Console->DirtyBuf);
+        Console->DirtyBuf = NULL;
+      }
+      if (Console->GlyphAtlas != NULL) {
+        FreePool (Console->GlyphAtlas);
+        Console->GlyphAtlas = NULL;
+      }
+    }
+  }
+  Console->ShadowTop    = 0;
+  Console->NextAtlas    = 0;
+  Console->ShadowInSync = FALSE;
+  Console->Dirty        = FALSE;
+
   if (ClearScreen) {
     // Clear screen using standard ANSI Escape Sequences 'ESC[2J'
     FrameBufferWrite (ANSI_ESCAPE_SEQ_CLEAR_SCREEN, 4);
@@ -223,30 +472,25 @@ InitFrameBufferConsole (
 }
 
 /**
-  Scroll the console area of the screen up.
+  Scroll the console text up without flushing the shadow buffer.
 
+  @param[in] Console      Frame buffer console
   @param[in] ScrollAmount Amount (in rows) to scroll
 
-  @retval EFI_SUCCESS
-
 **/
-EFI_STATUS
-EFIAPI
-FrameBufferConsoleScroll (
-  IN UINTN               ScrollAmount
+STATIC
+VOID
+ScrollConsole (
+  IN FRAME_BUFFER_CONSOLE  *Console,
+  IN UINTN                 ScrollAmount
   )
 {
-  FRAME_BUFFER_CONSOLE   *Console;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION  Bg;
   UINTN                  BufX;
   UINTN                  BufY;
   UINTN                  BufPos;
-  UINTN                  ScreenX;
-  UINTN                  ScreenY;
-
-  Console = &mFbConsole;
-  if (Console->Height == 0) {
-    return EFI_UNSUPPORTED;
-  }
+  UINTN                  RowPixels;
+  UINTN                  Row;
 
   if (ScrollAmount > Console->Rows) {
     ScrollAmount = Console->Rows;
@@ -263,6 +507,30 @@ FrameBufferConsoleScroll (
   ZeroMem (&Console->TextSwapBuf[Console->Cols * (Console->Rows - ScrollAmount)],
            Console->Cols * ScrollAmount);
 
+  if ((Console->ShadowBuf != NULL) && Console->ShadowInSync) {
+    //
+    // The shadow buffer holds exactly the text buffer. Its text rows form a
+    // ring, so scrolling only moves the top row and blanks the new lines.
+    // Blank cells are drawn as spaces.
+    //
+    RowPixels = GLYPH_HEIGHT * Console->Cols * GLYPH_WIDTH;
+    Console->ShadowTop = (Console->ShadowTop + ScrollAmount) % Console->Rows;
+    Bg.Pixel = Console->BackgroundColor;
+    for (Row = Console->Rows - ScrollAmount; Row < Console->Rows; Row++) {
+      SetMem32 (GetShadowRow (Console, Row), RowPixels * sizeof (UINT32), Bg.Raw);
+    }
+
+    // Only the cells whose character changed differ from the frame buffer
+    for (BufPos = 0; BufPos < Console->Rows * Console->Cols; BufPos++) {
+      if (Console->TextSwapBuf[BufPos] != Console->TextDisplayBuf[BufPos]) {
+        Console->TextDisplayBuf[BufPos] = Console->TextSwapBuf[BufPos];
+        Console->DirtyBuf[BufPos] = 1;
+        Console->Dirty = TRUE;
+      }
+    }
+    return;
+  }
+
   // Write text buffer to screen
   //
   // Note: At this point, TextDisplayBuf contains what is currently being
@@ -270,21 +538,42 @@ FrameBufferConsoleScroll (
   // every character of the buffer and update the framebuffer with any
   // differences.
   BufPos = 0;
-  ScreenY = Console->OffY;
   for (BufY = 0; BufY < Console->Rows; BufY++) {
-    ScreenX = Console->OffX;
     for (BufX = 0; BufX < Console->Cols; BufX++) {
       if (Console->TextSwapBuf[BufPos] != Console->TextDisplayBuf[BufPos]) {
         Console->TextDisplayBuf[BufPos] = Console->TextSwapBuf[BufPos];
-        BltGlyphToFrameBuffer (Console->GfxInfoHob, Console->TextSwapBuf[BufPos],
-                               Console->ForegroundColor, Console->BackgroundColor,
-                               ScreenX, ScreenY);
+        DrawConsoleGlyph (Console, Console->TextSwapBuf[BufPos],
+                          Console->ForegroundColor, Console->BackgroundColor,
+                          BufX, BufY);
       }
       BufPos++;
-      ScreenX += GLYPH_WIDTH;
     }
-    ScreenY += GLYPH_HEIGHT;
   }
+}
+
+/**
+  Scroll the console area of the screen up.
+
+  @param[in] ScrollAmount Amount (in rows) to scroll
+
+  @retval EFI_SUCCESS
+
+**/
+EFI_STATUS
+EFIAPI
+FrameBufferConsoleScroll (
+  IN UINTN               ScrollAmount
+  )
+{
+  FRAME_BUFFER_CONSOLE   *Console;
+
+  Console = &mFbConsole;
+  if (Console->Height == 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  ScrollConsole (Console, ScrollAmount);
+  FlushFrameBufferConsole (Console);
 
   return EFI_SUCCESS;
 }
@@ -338,6 +627,14 @@ FrameBufferWrite (
     GfxInfoHob = Console->GfxInfoHob;
     Length = (GfxInfoHob->GraphicsMode.HorizontalResolution * GfxInfoHob->GraphicsMode.PixelsPerScanLine) * 4;
     SetMem64 ((UINT32 *) (UINTN)(GfxInfoHob->FrameBufferBase), Length, 0);
+    if (Console->ShadowBuf != NULL) {
+      // The console area now only shows the text buffer
+      ZeroMem (Console->ShadowBuf, Console->Rows * GLYPH_HEIGHT * Console->Cols * GLYPH_WIDTH * sizeof (UINT32));
+      ZeroMem (Console->DirtyBuf, Console->Rows * Console->Cols);
+      Console->ShadowTop    = 0;
+      Console->ShadowInSync = TRUE;
+      Console->Dirty        = FALSE;
+    }
     Console->CursorX = 0;
     Console->CursorY = 0;
     return NumberOfBytes;
@@ -352,7 +649,7 @@ FrameBufferWrite (
 
     // Create new line when cursor overflows rows
     if (Console->CursorY >= Console->Rows) {
-      FrameBufferConsoleScroll (1);
+      ScrollConsole (Console, 1);
       Console->CursorY = Console->Rows - 1;
       Console->CursorX = 0;
     }
@@ -379,10 +676,9 @@ FrameBufferWrite (
       Console->CursorX = 0;
     } else {
       Console->TextDisplayBuf[Console->CursorY * Console->Cols + Console->CursorX] = Buffer[Pos];
-      Status = BltGlyphToFrameBuffer (Console->GfxInfoHob, Buffer[Pos],
-                                      Console->ForegroundColor, Console->BackgroundColor,
-                                      Console->OffX + Console->CursorX * GLYPH_WIDTH,
-                                      Console->OffY + Console->CursorY * GLYPH_HEIGHT);
+      Status = DrawConsoleGlyph (Console, Buffer[Pos],
+                                 Console->ForegroundColor, Console->BackgroundColor,
+                                 Console->CursorX, Console->CursorY);
       if (Status != EFI_SUCCESS) {
         break;
       }
@@ -390,6 +686,8 @@ FrameBufferWrite (
     }
   }
 
+  FlushFrameBufferConsole (Console);
+
   return Pos;
 }
 
@@ -453,17 +751,21 @@ DrawFrameBuffer (
       Ptr   = (UINT16 *)(Console->TextDrawBuf + Pos);
       if (*Ptr != Value) {
         *Ptr = Value;
-        BltGlyphToFrameBuffer (
-          Console->GfxInfoHob, Buffer[Pos],
+        DrawConsoleGlyph (
+          Console, Buffer[Pos],
           mColors[(Value >>  8) & 0x0F],
           mColors[(Value >> 12) & 0x0F],
-          Console->OffX + (PosX + OffX) * GLYPH_WIDTH,
-          Console->OffY + (PosY + OffY) * GLYPH_HEIGHT);
+          PosX + OffX,
+          PosY + OffY);
+        // The shadow buffer no longer matches the console text buffer
+        Console->ShadowInSync = FALSE;
       }
       Pos += 2;
     }
   }
 
+  FlushFrameBufferConsole (Console);
+
   return EFI_SUCCESS;
 }
 
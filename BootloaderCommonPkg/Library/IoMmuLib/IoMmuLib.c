@@ -280,6 +280,39 @@ BlIoMmuFreeBuffer (
   return EFI_SUCCESS;
 }
 
+/**
+  Check if a bus master can access system memory directly.
+
+  When DMA protection is enabled, all memory outside of the DMA buffer is
+  covered by the protected memory ranges, so every transfer has to be bounced.
+  Otherwise memory is identity mapped for the bus master.
+
+  @param  HostAddress           The system memory address to check, or NULL to check if
+                                direct DMA is possible at all.
+  @param  NumberOfBytes         The number of bytes to check. Ignored when HostAddress is NULL.
+
+  @retval TRUE                  The range can be used for DMA directly.
+  @retval FALSE                 The range must be bounced through the DMA buffer.
+
+**/
+BOOLEAN
+IoMmuIsDirectDma (
+  IN  VOID                  *HostAddress,
+  IN  UINTN                 NumberOfBytes
+  )
+{
+  if (FeaturePcdGet (PcdDmaProtectionEnabled)) {
+    return FALSE;
+  }
+
+  if ((HostAddress != NULL) && (NumberOfBytes > 0) &&
+      ((UINTN)HostAddress > MAX_ADDRESS - (NumberOfBytes - 1))) {
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
 /**
   Provides the controller-specific addresses required to access system memory from a
   DMA bus master.
@@ -311,7 +344,7 @@ IoMmuMap (
   EFI_STATUS  Status;
   UINT64      Attribute;
 
-  if (FeaturePcdGet (PcdDmaProtectionEnabled)) {
+  if (!IoMmuIsDirectDma (HostAddress, *NumberOfBytes)) {
     Status = BlIoMmuMap (
                        mIoMmu,
                        Operation,
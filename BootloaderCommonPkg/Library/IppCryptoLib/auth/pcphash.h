@@ -214,6 +214,9 @@ void EFIAPI UpdateSHA256Ni(void* pHash, const Ipp8u* mblk, int mlen, const void*
 void UpdateSHA512(void* pHash, const Ipp8u* mblk, int mlen, const void* pParam);
 void EFIAPI UpdateSHA512W7 (void* uniHash, const Ipp8u* mblk, int mlen, const void* uniPraram);
 void EFIAPI UpdateSHA512G9 (void* uniHash, const Ipp8u* mblk, int mlen, const void* uniPraram);
+#if defined(_SLIMBOOT_OPT)
+UINT32 IppGetCpuFeatures (VOID);
+#endif
 void UpdateMD5   (void* pHash, const Ipp8u* mblk, int mlen, const void* pParam);
 void UpdateSM3   (void* pHash, const Ipp8u* mblk, int mlen, const void* pParam);
 
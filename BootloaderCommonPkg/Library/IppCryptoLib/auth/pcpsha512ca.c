@@ -565,9 +565,16 @@ void UpdateSHA512Normal(void* uniHash, const Ipp8u* mblk, int mlen, const void*
 void UpdateSHA512(void* uniHash, const Ipp8u* mblk, int mlen, const void* uniPraram)
 {
 #if defined(_SLIMBOOT_OPT)
+   /* only the kernels selected by PcdCryptoShaOptMask are linked in,
+      pick the fastest one the CPU supports */
    #if (FixedPcdGet32 (PcdCryptoShaOptMask) & IPP_CRYPTO_SHA384_G9)
+   if (IppGetCpuFeatures() & IPP_CPU_FEATURE_AVX) {
       UpdateSHA512G9 (uniHash, mblk, mlen, uniPraram);
-   #elif (FixedPcdGet32 (PcdCryptoShaOptMask) & IPP_CRYPTO_SHA384_W7)
+      return;
+   }
+   #endif
+   #if (FixedPcdGet32 (PcdCryptoShaOptMask) & IPP_CRYPTO_SHA384_W7)
+      /* only needs the baseline SSE instructions */
       UpdateSHA512W7 (uniHash, mblk, mlen, uniPraram);
    #else
       UpdateSHA512Compact (uniHash, mblk, mlen, uniPraram);
@@ -38,4 +38,11 @@
 #define IPP_CRYPTO_SHA384_W7    0x0004
 #define IPP_CRYPTO_SHA384_G9    0x0008
 
+//
+// CPU features checked before dispatching to an optimized SHA kernel
+//
+#define IPP_CPU_FEATURE_SSSE3   0x0001
+#define IPP_CPU_FEATURE_SHA_NI  0x0002
+#define IPP_CPU_FEATURE_AVX     0x0004
+
 #endif /* _CP_VARIANT_ABL_H */
@@ -0,0 +1,66 @@
+/** @file
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+
+#include "owndefs.h"
+#include "owncp.h"
+#include "pcphash.h"
+
+#include <Register/Intel/Cpuid.h>
+
+/**
+  Get the CPU features used to select an optimized SHA kernel.
+
+  SHA-NI and SSSE3 kernels only need the CPUID feature flags. The AVX kernel
+  also needs the OS (the bootloader here) to have enabled the YMM state
+  through XSETBV.
+
+  The features are detected on every call. A stage may run XIP, where a
+  global cannot be written, and the few CPUID instructions cost little next
+  to the hashing of a buffer.
+
+  @retval  A combination of IPP_CPU_FEATURE_xxx flags.
+**/
+UINT32
+IppGetCpuFeatures (
+  VOID
+  )
+{
+  UINT32                                       Features;
+  CPUID_VERSION_INFO_ECX                       VersionEcx;
+  CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS_EBX  ExtendedEbx;
+  UINT32                                       MaxLeaf;
+
+  Features = 0;
+  AsmCpuid (CPUID_SIGNATURE, &MaxLeaf, NULL, NULL, NULL);
+  AsmCpuid (CPUID_VERSION_INFO, NULL, NULL, &VersionEcx.Uint32, NULL);
+
+  if (VersionEcx.Bits.SSSE3 != 0) {
+    Features |= IPP_CPU_FEATURE_SSSE3;
+  }
+
+  if ((VersionEcx.Bits.AVX != 0) && (VersionEcx.Bits.OSXSAVE != 0) &&
+      ((AsmXGetBv (0) & (BIT1 | BIT2)) == (BIT1 | BIT2))) {
+    Features |= IPP_CPU_FEATURE_AVX;
+  }
+
+  if (MaxLeaf >= CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS) {
+    AsmCpuidEx (
+      CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS,
+      CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS_SUB_LEAF_INFO,
+      NULL,
+      &ExtendedEbx.Uint32,
+      NULL,
+      NULL
+      );
+    if ((ExtendedEbx.Bits.SHA != 0) && (VersionEcx.Bits.SSSE3 != 0) && (VersionEcx.Bits.SSE4_1 != 0)) {
+      Features |= IPP_CPU_FEATURE_SHA_NI;
+    }
+  }
+
+  return Features;
+}
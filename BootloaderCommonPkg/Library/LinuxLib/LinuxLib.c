@@ -182,10 +182,79 @@ IsBzImage (
   return TRUE;
 }
 
+/**
+  Check if a relocatable kernel can run from the memory it was loaded to.
+
+  A relocatable kernel decompresses itself at its load address rounded up to
+  the kernel alignment, or at pref_address when that address is lower. In the
+  first case the init_size bytes from there must belong to the kernel buffer.
+  The second case uses the same memory as a kernel copied to LINUX_KERNEL_BASE.
+
+  @param[in, out] Hdr           Setup header in the boot parameters. The
+                                kernel alignment is updated if it is lowered.
+  @param[in]      KernelStart   Address of the protected-mode kernel.
+  @param[in]      KernelBufEnd  End of the kernel buffer.
+
+  @retval TRUE                  The kernel can run from KernelStart.
+  @retval FALSE                 The kernel must be copied.
+**/
+STATIC
+BOOLEAN
+CanBootInPlace (
+  IN OUT  SETUP_HEADER             *Hdr,
+  IN      UINT64                    KernelStart,
+  IN      UINT64                    KernelBufEnd
+  )
+{
+  UINT64                      Alignment;
+  UINT64                      RunAddr;
+
+  // pref_address, init_size and min_alignment exist since protocol 2.10
+  if ((Hdr->Version < 0x020A) || (Hdr->RelocatableKernel == 0)) {
+    return FALSE;
+  }
+
+  Alignment = Hdr->KernelAlignment;
+  if ((Alignment == 0) || ((Alignment & (Alignment - 1)) != 0)) {
+    return FALSE;
+  }
+
+  RunAddr = ALIGN_VALUE (KernelStart, Alignment);
+  if (RunAddr < Hdr->PrefAddress) {
+    return TRUE;
+  }
+
+  if (RunAddr + Hdr->InitSize <= KernelBufEnd) {
+    return TRUE;
+  }
+
+  //
+  // The kernel accepts a load address aligned to min_alignment only, provided
+  // the boot loader updates kernel_alignment accordingly.
+  //
+  if ((Hdr->MinAlignment == 0) || (Hdr->MinAlignment >= 32)) {
+    return FALSE;
+  }
+  Alignment = LShiftU64 (1, Hdr->MinAlignment);
+  RunAddr   = ALIGN_VALUE (KernelStart, Alignment);
+  if ((RunAddr >= Hdr->PrefAddress) && (RunAddr + Hdr->InitSize <= KernelBufEnd)) {
+    Hdr->KernelAlignment = (UINT32)Alignment;
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
 /**
   Load linux kernel image to specified address and setup boot parameters.
 
+  A relocatable kernel is booted from where it was loaded if its memory needs
+  are met, see CanBootInPlace(). Other kernels are copied to LINUX_KERNEL_BASE.
+
   @param[in]  KernelBase     Memory address of an kernel image.
+  @param[in]  KernelBufLen   Size of the buffer holding the kernel image,
+                             which the kernel may use while it decompresses
+                             itself. 0 always copies the kernel.
   @param[in]  InitRdBase     Memory address of an InitRd image.
   @param[in]  InitRdLen      InitRd image size.
   @param[in]  CmdLineBase    Memory address of command line buffer.
@@ -199,6 +268,7 @@ EFI_STATUS
 EFIAPI
 LoadBzImage (
   IN  CONST VOID                  *KernelBase,
+  IN      UINT32                   KernelBufLen,
   IN  CONST VOID                  *InitRdBase,
   IN      UINT32                   InitRdLen,
   IN  CONST VOID                  *CmdLineBase,
@@ -232,9 +302,16 @@ LoadBzImage (
     BootParamSize = 5 * 512;
   }
 
-  KernelBuf  = (VOID *) (UINTN)LINUX_KERNEL_BASE;
+  KernelBuf  = (UINT8 *)ImageBase + BootParamSize;
   KernelSize = Bp->Hdr.SysSize * 16;
-  CopyMem (KernelBuf, (UINT8 *)ImageBase + BootParamSize, KernelSize);
+  if ((KernelBufLen >= BootParamSize + KernelSize) &&
+      CanBootInPlace (&Bp->Hdr, (UINTN)KernelBuf, (UINTN)ImageBase + KernelBufLen)) {
+    DEBUG ((DEBUG_INFO, "Boot relocatable kernel in place at 0x%p\n", KernelBuf));
+  } else {
+    KernelBuf = (VOID *) (UINTN)LINUX_KERNEL_BASE;
+    CopyMem (KernelBuf, (UINT8 *)ImageBase + BootParamSize, KernelSize);
+  }
+  Bp->Hdr.Code32Start = (UINT32)(UINTN)KernelBuf;
 
   //
   // Update boot params
@@ -1,7 +1,7 @@
 /** @file
 Lite variable service library
 
-Copyright (c) 2006 - 2023, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 Portions copyright (c) 2008 - 2009, Apple Inc. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -321,6 +321,341 @@ InitializeVariableStore (
   return EFI_SUCCESS;
 }
 
+/**
+  Calculate the index hash of a variable.
+
+  @param[in]  VariableName    Variable name.
+  @param[in]  VariableGuid    Variable GUID.
+
+  @retval     The 32-bit FNV-1a hash of the GUID and the name.
+
+**/
+STATIC
+UINT32
+GetVariableHash (
+  IN CONST CHAR16       *VariableName,
+  IN CONST EFI_GUID     *VariableGuid
+  )
+{
+  CONST UINT8  *Ptr;
+  UINT32        Hash;
+  UINTN         Idx;
+
+  Hash = 0x811C9DC5;
+  Ptr  = (CONST UINT8 *)VariableGuid;
+  for (Idx = 0; Idx < sizeof (EFI_GUID); Idx++) {
+    Hash = (Hash ^ Ptr[Idx]) * 0x01000193;
+  }
+  for (Idx = 0; VariableName[Idx] != 0; Idx++) {
+    Hash = (Hash ^ (UINT8)VariableName[Idx]) * 0x01000193;
+    Hash = (Hash ^ (UINT8)(VariableName[Idx] >> 8)) * 0x01000193;
+  }
+
+  return Hash;
+}
+
+/**
+  Check if a variable header holds the given variable.
+
+  @param[in]  VarHdrPtr       Variable header.
+  @param[in]  VariableName    Variable name.
+  @param[in]  VariableGuid    Variable GUID.
+
+  @retval     TRUE            The name and the GUID match.
+  @retval     FALSE           The name or the GUID does not match.
+
+**/
+STATIC
+BOOLEAN
+IsVariableMatch (
+  IN VARIABLE_HEADER    *VarHdrPtr,
+  IN CONST CHAR16       *VariableName,
+  IN CONST EFI_GUID     *VariableGuid
+  )
+{
+  return (BOOLEAN)((StrCmp ((CHAR16 *)&VarHdrPtr[1], VariableName) == 0) &&
+                   CompareGuid (VariableGuid, &VarHdrPtr->VariableGuid));
+}
+
+/**
+  Add a variable to the variable index.
+
+  While the index is built, the first copy not in migration wins, the same
+  way as a linear scan of the store. A second copy found while building marks
+  the store for repair. When a variable is updated, the new copy always
+  replaces the indexed one.
+
+  @param[in]  VarInstance     Variable instance.
+  @param[in]  VarStoreHdrPtr  Active variable store header.
+  @param[in]  VarHdrPtr       Variable header to add.
+  @param[in]  Update          TRUE if VarHdrPtr is a new copy of the variable.
+
+**/
+STATIC
+VOID
+AddVariableIndex (
+  IN VARIABLE_INSTANCE      *VarInstance,
+  IN VARIABLE_STORE_HEADER  *VarStoreHdrPtr,
+  IN VARIABLE_HEADER        *VarHdrPtr,
+  IN BOOLEAN                 Update
+  )
+{
+  VARIABLE_INDEX_ENTRY  *Entry;
+  VARIABLE_HEADER       *OldHdrPtr;
+  UINT32                 Hash;
+  UINT32                 Idx;
+  UINT32                 Probe;
+
+  Hash = GetVariableHash ((CHAR16 *)&VarHdrPtr[1], &VarHdrPtr->VariableGuid);
+  Idx  = Hash & (VARIABLE_INDEX_ENTRY_NUM - 1);
+  for (Probe = 0; Probe < VARIABLE_INDEX_ENTRY_NUM; Probe++) {
+    Entry = &VarInstance->Index[Idx];
+    if (Entry->Offset == 0) {
+      Entry->Hash   = (UINT16)(Hash >> 16);
+      Entry->Offset = (UINT32)((UINT8 *)VarHdrPtr - (UINT8 *)VarStoreHdrPtr);
+      return;
+    }
+
+    if (Entry->Hash == (UINT16)(Hash >> 16)) {
+      OldHdrPtr = (VARIABLE_HEADER *)((UINT8 *)VarStoreHdrPtr + Entry->Offset);
+      if (IsVariableMatch (OldHdrPtr, (CHAR16 *)&VarHdrPtr[1], &VarHdrPtr->VariableGuid)) {
+        if (!Update) {
+          VarInstance->IndexFlags |= VAR_INDEX_REPAIR;
+        }
+        if (Update || IS_IN_MIGRATION (OldHdrPtr->State)) {
+          Entry->Offset = (UINT32)((UINT8 *)VarHdrPtr - (UINT8 *)VarStoreHdrPtr);
+        }
+        return;
+      }
+    }
+    Idx = (Idx + 1) & (VARIABLE_INDEX_ENTRY_NUM - 1);
+  }
+
+  //
+  // No free slot, variables missing from the index are found by scanning
+  //
+  VarInstance->IndexFlags |= VAR_INDEX_OVERFLOW;
+}
+
+/**
+  Build the variable index for the active variable store.
+
+  The store is flagged for repair when the scan finds entries that a full
+  write cleans up: a failed header write, invalid data or a second copy.
+
+  @param[in]  VarInstance     Variable instance.
+  @param[in]  VarStoreHdrPtr  Active variable store header.
+
+  @retval     EFI_SUCCESS           The index was built.
+  @retval     EFI_VOLUME_CORRUPTED  Variable store is corrupted.
+
+**/
+STATIC
+EFI_STATUS
+BuildVariableIndex (
+  IN VARIABLE_INSTANCE      *VarInstance,
+  IN VARIABLE_STORE_HEADER  *VarStoreHdrPtr
+  )
+{
+  VARIABLE_HEADER        *VarHdrPtr;
+  UINT8                  *VarEndPtr;
+  UINT8                  *CurPtr;
+  UINTN                   Idx;
+  UINT8                   State;
+
+  VarInstance->IndexFlags = 0;
+  ZeroMem (VarInstance->Index, sizeof (VarInstance->Index));
+
+  VarHdrPtr = (VARIABLE_HEADER *)&VarStoreHdrPtr[1];
+  VarEndPtr = (UINT8 *)VarStoreHdrPtr + VarStoreHdrPtr->Size;
+  while ((UINT8 *)VarHdrPtr < VarEndPtr) {
+    State = VarHdrPtr->State;
+    if (!IS_HEADER_VALID (State)) {
+      //
+      // Anything but erased flash here is a failed header write
+      //
+      CurPtr = (UINT8 *)VarHdrPtr;
+      for (Idx = 0; (Idx < sizeof (VARIABLE_HEADER)) && (CurPtr + Idx < VarEndPtr); Idx++) {
+        if (CurPtr[Idx] != 0xFF) {
+          VarInstance->IndexFlags |= VAR_INDEX_REPAIR;
+          break;
+        }
+      }
+      break;
+    }
+
+    if (VarHdrPtr->StartId != VARIABLE_DATA) {
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    if (!IS_DATA_VALID (State) && !IS_DELETED (State)) {
+      VarInstance->IndexFlags |= VAR_INDEX_REPAIR;
+    }
+
+    if (IS_DATA_VALID (State) && !IS_DELETED (State)) {
+      AddVariableIndex (VarInstance, VarStoreHdrPtr, VarHdrPtr, FALSE);
+    }
+
+    VarHdrPtr = (VARIABLE_HEADER *) ((UINT8 *)&VarHdrPtr[1] + VarHdrPtr->DataSize);
+  }
+
+  VarInstance->IndexStore  = (UINT32)(UINTN)VarStoreHdrPtr;
+  VarInstance->IndexFlags |= VAR_INDEX_VALID;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  This internal function finds the active copy of a variable in the variable store.
+
+  The variable index is used when available, and it is rebuilt when the active
+  store changed. The store is scanned if the index cannot give the answer.
+
+  @param[in]  VarStoreHdrPtr  Active variable store header.
+  @param[in]  VariableName    Name of variable to be found.
+  @param[in]  VariableGuid    Variable GUID.
+  @param[out] VariableHeader  Variable header pointer if the variable is found.
+
+  @retval EFI_SUCCESS               Find the specified variable.
+  @retval EFI_NOT_FOUND             Not found.
+  @retval EFI_VOLUME_CORRUPTED      Variable store is corrupted.
+
+**/
+STATIC
+EFI_STATUS
+FindVariable (
+  IN  VARIABLE_STORE_HEADER  *VarStoreHdrPtr,
+  IN  CHAR16                 *VariableName,
+  IN  EFI_GUID               *VariableGuid,
+  OUT VARIABLE_HEADER       **VariableHeader
+  )
+{
+  VARIABLE_INSTANCE      *VarInstance;
+  VARIABLE_INDEX_ENTRY   *Entry;
+  VARIABLE_HEADER        *VarHdrPtr;
+  VARIABLE_HEADER        *FindVarHdrPtr;
+  UINT8                  *VarEndPtr;
+  UINT8                   State;
+  UINT32                  Hash;
+  UINT32                  Idx;
+  UINT32                  Probe;
+
+  VarInstance = GetVariableInstance ();
+  if (VarInstance != NULL) {
+    if (((VarInstance->IndexFlags & VAR_INDEX_VALID) == 0) ||
+        (VarInstance->IndexStore != (UINT32)(UINTN)VarStoreHdrPtr)) {
+      BuildVariableIndex (VarInstance, VarStoreHdrPtr);
+    }
+  }
+
+  if ((VarInstance != NULL) && ((VarInstance->IndexFlags & VAR_INDEX_VALID) != 0)) {
+    Hash = GetVariableHash (VariableName, VariableGuid);
+    Idx  = Hash & (VARIABLE_INDEX_ENTRY_NUM - 1);
+    for (Probe = 0; Probe < VARIABLE_INDEX_ENTRY_NUM; Probe++) {
+      Entry = &VarInstance->Index[Idx];
+      if (Entry->Offset == 0) {
+        break;
+      }
+      if (Entry->Hash == (UINT16)(Hash >> 16)) {
+        VarHdrPtr = (VARIABLE_HEADER *)((UINT8 *)VarStoreHdrPtr + Entry->Offset);
+        if (IsVariableMatch (VarHdrPtr, VariableName, VariableGuid)) {
+          State = VarHdrPtr->State;
+          if ((VarHdrPtr->StartId == VARIABLE_DATA) && IS_HEADER_VALID (State) &&
+              IS_DATA_VALID (State) && !IS_DELETED (State)) {
+            *VariableHeader = VarHdrPtr;
+            return EFI_SUCCESS;
+          }
+          //
+          // The store was changed behind the index, rebuild it next time
+          //
+          VarInstance->IndexFlags = 0;
+          break;
+        }
+      }
+      Idx = (Idx + 1) & (VARIABLE_INDEX_ENTRY_NUM - 1);
+    }
+
+    if ((VarInstance->IndexFlags & (VAR_INDEX_VALID | VAR_INDEX_OVERFLOW)) == VAR_INDEX_VALID) {
+      return EFI_NOT_FOUND;
+    }
+  }
+
+  VarHdrPtr = (VARIABLE_HEADER *)&VarStoreHdrPtr[1];
+  VarEndPtr = (UINT8 *)VarStoreHdrPtr + VarStoreHdrPtr->Size;
+
+  FindVarHdrPtr = NULL;
+  while ((UINT8 *)VarHdrPtr < VarEndPtr) {
+    State = VarHdrPtr->State;
+    if (!IS_HEADER_VALID (State)) {
+      break;
+    }
+
+    if (VarHdrPtr->StartId != VARIABLE_DATA) {
+      VarHdrPtr = NULL;
+      break;
+    }
+
+    if (IS_DATA_VALID (State) && !IS_DELETED (State)) {
+      if (IsVariableMatch (VarHdrPtr, VariableName, VariableGuid)) {
+        FindVarHdrPtr = VarHdrPtr;
+        if (!IS_IN_MIGRATION (State)) {
+          break;
+        }
+      }
+    }
+
+    VarHdrPtr = (VARIABLE_HEADER *) ((UINT8 *)&VarHdrPtr[1] + VarHdrPtr->DataSize);
+  }
+
+  if (VarHdrPtr == NULL) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  if (FindVarHdrPtr == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  *VariableHeader = FindVarHdrPtr;
+  return EFI_SUCCESS;
+}
+
+/**
+  Find a queued update of a variable.
+
+  @param[in]  VarInstance     Variable instance.
+  @param[in]  VariableName    Variable name.
+  @param[in]  VariableGuid    Variable GUID.
+
+  @retval     The pending record of the variable, or NULL if it has no pending update.
+
+**/
+STATIC
+VARIABLE_HEADER *
+FindPendingVariable (
+  IN VARIABLE_INSTANCE  *VarInstance,
+  IN CHAR16             *VariableName,
+  IN EFI_GUID           *VariableGuid
+  )
+{
+  VARIABLE_HEADER  *RecPtr;
+  UINT8            *EndPtr;
+
+  if (VarInstance->PendingBase == 0) {
+    return NULL;
+  }
+
+  RecPtr = (VARIABLE_HEADER *)(UINTN)VarInstance->PendingBase;
+  EndPtr = (UINT8 *)RecPtr + VarInstance->PendingSize;
+  while ((UINT8 *)RecPtr < EndPtr) {
+    if (IsVariableMatch (RecPtr, VariableName, VariableGuid)) {
+      return RecPtr;
+    }
+    RecPtr = (VARIABLE_HEADER *) ((UINT8 *)&RecPtr[1] + RecPtr->DataSize);
+  }
+
+  return NULL;
+}
+
 /**
 
   This internal function finds variable in storage blocks.
@@ -357,15 +692,14 @@ InternalGetVariable (
 {
 
   UINT32                  VarStoreLen;
+  VARIABLE_INSTANCE      *VarInstance;
   VARIABLE_STORE_HEADER  *VarStoreHdrPtr;
-  VARIABLE_HEADER        *VarHdrPtr;
   VARIABLE_HEADER        *FindVarHdrPtr;
-  UINT8                  *VarEndPtr;
-  UINT8                   State;
   UINT32                  VariableNameLen;
   UINT32                  VariableDataLen;
   UINTN                   DataSizeIn;
   EFI_GUID                *VarGuid;
+  EFI_STATUS              Status;
 
   if ((DataSize == NULL) || (VariableName == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -382,40 +716,24 @@ InternalGetVariable (
   }
 
   VariableNameLen = (UINT32)StrSize (VariableName);
-  VarHdrPtr = (VARIABLE_HEADER *)&VarStoreHdrPtr[1];
-  VarEndPtr = (UINT8 *)VarStoreHdrPtr + VarStoreHdrPtr->Size;
 
+  //
+  // Updates not committed yet take precedence over the store
+  //
   FindVarHdrPtr = NULL;
-  while ((UINT8 *)VarHdrPtr < VarEndPtr) {
-    State = VarHdrPtr->State;
-    if (!IS_HEADER_VALID (State)) {
-      break;
-    }
-
-    if (VarHdrPtr->StartId != VARIABLE_DATA) {
-      VarHdrPtr = NULL;
-      break;
-    }
-
-    if (IS_DATA_VALID (State) && !IS_DELETED (State)) {
-      if ((StrCmp ((VOID *)&VarHdrPtr[1], VariableName) == 0) &&
-           CompareGuid (VarGuid, &VarHdrPtr->VariableGuid)) {
-        FindVarHdrPtr = VarHdrPtr;
-        if (!IS_IN_MIGRATION (State)) {
-          break;
-        }
-      }
+  VarInstance   = GetVariableInstance ();
+  if ((VarInstance != NULL) && (VarInstance->PendingSize > 0)) {
+    FindVarHdrPtr = FindPendingVariable (VarInstance, VariableName, VarGuid);
+    if ((FindVarHdrPtr != NULL) && IS_DELETED (FindVarHdrPtr->State)) {
+      return EFI_NOT_FOUND;
     }
-
-    VarHdrPtr = (VARIABLE_HEADER *) ((UINT8 *)&VarHdrPtr[1] + VarHdrPtr->DataSize);
-  }
-
-  if (VarHdrPtr == NULL) {
-    return EFI_VOLUME_CORRUPTED;
   }
 
   if (FindVarHdrPtr == NULL) {
-    return EFI_NOT_FOUND;
+    Status = FindVariable (VarStoreHdrPtr, VariableName, VarGuid, &FindVarHdrPtr);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
   }
 
   DataSizeIn = *DataSize;
@@ -601,6 +919,7 @@ Reclaim (
 {
   UINT32                  FullVarStoreLen;
   UINT32                  VarStoreLen;
+  VARIABLE_INSTANCE      *VarInstance;
   VARIABLE_STORE_HEADER   VarStoreHdr;
   VARIABLE_STORE_HEADER  *VarStoreHdrPtr1;
   VARIABLE_STORE_HEADER  *VarStoreHdrPtr2;
@@ -610,7 +929,6 @@ Reclaim (
   VARIABLE_HEADER        *VarHdrPtr;
   VARIABLE_HEADER         VarHdr;
   UINT8                  *CurPtr;
-  UINTN                   DataLen;
   UINTN                   NameSize;
   UINT8                   ActiveState;
   UINT8                   InactiveState;
@@ -649,7 +967,7 @@ Reclaim (
     NameSize = sizeof (VarName);
     Status   = GetNextVariableName (&NameSize, VarName, &VarGuid);
     if (!EFI_ERROR (Status)) {
-      Status = InternalGetVariable (VarName, &VarGuid, NULL, &DataLen, NULL, &VarHdrPtr);
+      Status = FindVariable (ActiveVarStoreHdrPtr, VarName, &VarGuid, &VarHdrPtr);
       if (!EFI_ERROR (Status)) {
         CopyMem (&VarHdr, VarHdrPtr, sizeof (VarHdr));
         VarHdr.State |= VAR_IN_MIGRATION;
@@ -706,40 +1024,48 @@ Reclaim (
     return Status;
   }
 
+  //
+  // The index refers to the old active store
+  //
+  VarInstance = GetVariableInstance ();
+  if (VarInstance != NULL) {
+    VarInstance->IndexFlags = 0;
+  }
+
   return EFI_SUCCESS;
 }
 
 /**
 
-  This code sets variable in storage blocks.
+  This internal function writes a variable to the variable store.
 
-  @param VariableName                     Name of Variable to be found.
-  @param VariableGuid                     Zero GUID would be used if it is NULL.
-  @param Attributes                       Attribute value of the variable found
-  @param DataSize                         Size of Data found. If size is less than the
-                                          data, this value contains the required size.
+  The new copy is written and committed before the previous copy is deleted,
+  so that either of them is found after a power failure.
+
+  @param VariableName                     Name of Variable to be written.
+  @param VarGuid                          Variable GUID.
+  @param DataSize                         Size of Data, 0 to delete the variable.
   @param Data                             Data pointer.
 
   @return EFI_INVALID_PARAMETER           Invalid parameter.
   @return EFI_SUCCESS                     Set successfully.
   @return EFI_OUT_OF_RESOURCES            Resource not enough to set variable.
   @return EFI_NOT_FOUND                   Not found.
-  @return EFI_WRITE_PROTECTED             Variable is read-only.
   @return EFI_DEVICE_ERROR                Variable storage is corrupted.
 
 **/
+STATIC
 EFI_STATUS
-EFIAPI
-SetVariable (
+WriteVariable (
   IN CHAR16                 *VariableName,
-  IN EFI_GUID               *VariableGuid OPTIONAL,
-  IN UINT32                 Attributes OPTIONAL,
+  IN EFI_GUID               *VarGuid,
   IN UINTN                  DataSize,
   IN VOID                   *Data
   )
 {
   VARIABLE_HEADER         VarHdr;
   UINT32                  VarStoreLen;
+  VARIABLE_INSTANCE      *VarInstance;
   VARIABLE_STORE_HEADER  *VarStoreHdrPtr;
   VARIABLE_HEADER        *VarHdrPtr;
   VARIABLE_HEADER        *NextVarHdrPtr;
@@ -757,30 +1083,32 @@ SetVariable (
   BOOLEAN                 SkipVarWrite;
   BOOLEAN                 CheckVarDataValid;
   BOOLEAN                 NeedReclaim;
-  EFI_GUID                *VarGuid;
-
-  if ((VariableName == NULL) || (VariableName[0] == 0)) {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  if ((Data == NULL) && (DataSize > 0)) {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  VarGuid = VariableGuid;
-  if (VarGuid == NULL) {
-    VarGuid = &gZeroGuid;
-  }
 
   VarStoreHdrPtr = GetActiveVaraibelStoreBase (&VarStoreLen);
   if (!IsVariableStoreValid (VarStoreHdrPtr)) {
     return EFI_VOLUME_CORRUPTED;
   }
 
+  VariableNameLen = (UINT32)StrSize (VariableName);
+  if (DataSize > 0) {
+    //
+    // Nothing to write if the store holds the same data already. A store
+    // flagged for repair takes the full scan below so that it gets cleaned up.
+    //
+    Status      = FindVariable (VarStoreHdrPtr, VariableName, VarGuid, &VarHdrPtr);
+    VarInstance = GetVariableInstance ();
+    if (!EFI_ERROR (Status) && (VarInstance != NULL) &&
+        ((VarInstance->IndexFlags & (VAR_INDEX_VALID | VAR_INDEX_REPAIR)) == VAR_INDEX_VALID) &&
+        (VarInstance->IndexStore == (UINT32)(UINTN)VarStoreHdrPtr) &&
+        (VarHdrPtr->DataSize == VariableNameLen + DataSize) &&
+        (CompareMem ((UINT8 *)&VarHdrPtr[1] + VariableNameLen, Data, DataSize) == 0)) {
+      return EFI_SUCCESS;
+    }
+  }
+
   VarHdrPtr = (VARIABLE_HEADER *)&VarStoreHdrPtr[1];
   VarEndPtr = (UINT8 *)VarStoreHdrPtr + VarStoreHdrPtr->Size;
 
-  VariableNameLen = (UINT32)StrSize (VariableName);
   if (DataSize == 0) {
     //
     // Need to delete a variable
@@ -891,7 +1219,7 @@ SetVariable (
 
         FindVarHdrPtr = VarHdrPtr;
         FindVarState  = State;
-        if (DataSize > 0) {
+        if ((DataSize > 0) && (VarHdrPtr->DataSize == VariableNameLen + DataSize)) {
           if (CompareMem ((UINT8 *)&VarHdrPtr[1] + VariableNameLen, Data, DataSize) == 0) {
             SkipVarWrite = TRUE;
           }
@@ -910,6 +1238,13 @@ SetVariable (
   }
 
   if (SkipVarWrite) {
+    //
+    // The scan above did the repair, check the store again on the next lookup
+    //
+    VarInstance = GetVariableInstance ();
+    if ((VarInstance != NULL) && ((VarInstance->IndexFlags & VAR_INDEX_REPAIR) != 0)) {
+      VarInstance->IndexFlags = 0;
+    }
     return EFI_SUCCESS;
   }
 
@@ -922,7 +1257,7 @@ SetVariable (
       if (EFI_ERROR (Status)) {
         return EFI_DEVICE_ERROR;
       }
-      return SetVariable (VariableName, VariableGuid, Attributes, DataSize, Data);
+      return WriteVariable (VariableName, VarGuid, DataSize, Data);
     }
     return EFI_OUT_OF_RESOURCES;
   }
@@ -1003,9 +1338,337 @@ SetVariable (
     }
   }
 
+  //
+  // Keep the index in sync, a deleted variable leaves a hole so rebuild it instead.
+  // Rebuild it too after a repair so that the repair state is checked again.
+  //
+  VarInstance = GetVariableInstance ();
+  if ((VarInstance != NULL) && ((VarInstance->IndexFlags & VAR_INDEX_VALID) != 0) &&
+      (VarInstance->IndexStore == (UINT32)(UINTN)VarStoreHdrPtr)) {
+    if ((DataSize > 0) && ((VarInstance->IndexFlags & VAR_INDEX_REPAIR) == 0)) {
+      AddVariableIndex (VarInstance, VarStoreHdrPtr, VarHdrPtr, TRUE);
+    } else {
+      VarInstance->IndexFlags = 0;
+    }
+  }
+
   return EFI_SUCCESS;
 }
 
+/**
+  Queue a variable update in the pending buffer.
+
+  A queued update replaces the previous pending update of the same variable.
+
+  @param[in]  VarInstance     Variable instance.
+  @param[in]  VariableName    Variable name.
+  @param[in]  VarGuid         Variable GUID.
+  @param[in]  DataSize        Size of Data, 0 to delete the variable.
+  @param[in]  Data            Data pointer.
+
+  @retval     EFI_SUCCESS           The update was queued, or it does not change the variable.
+  @retval     EFI_NOT_FOUND         The variable to delete does not exist.
+  @retval     EFI_BUFFER_TOO_SMALL  The pending buffer has no room for the update.
+  @retval     Others                The variable store could not be read.
+
+**/
+STATIC
+EFI_STATUS
+QueueVariable (
+  IN VARIABLE_INSTANCE      *VarInstance,
+  IN CHAR16                 *VariableName,
+  IN EFI_GUID               *VarGuid,
+  IN UINTN                  DataSize,
+  IN VOID                   *Data
+  )
+{
+  VARIABLE_STORE_HEADER  *VarStoreHdrPtr;
+  VARIABLE_HEADER        *RecPtr;
+  VARIABLE_HEADER        *VarHdrPtr;
+  UINT8                  *PendingPtr;
+  UINT32                  VariableNameLen;
+  UINT32                  RecLen;
+  UINT32                  OldRecLen;
+  BOOLEAN                 IsPending;
+  EFI_STATUS              Status;
+
+  VarStoreHdrPtr = GetActiveVaraibelStoreBase (NULL);
+  if (!IsVariableStoreValid (VarStoreHdrPtr)) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  VariableNameLen = (UINT32)StrSize (VariableName);
+  RecLen          = sizeof (VARIABLE_HEADER) + VariableNameLen + (UINT32)DataSize;
+  PendingPtr      = (UINT8 *)(UINTN)VarInstance->PendingBase;
+
+  OldRecLen = 0;
+  IsPending = FALSE;
+  RecPtr    = FindPendingVariable (VarInstance, VariableName, VarGuid);
+  if (RecPtr != NULL) {
+    if ((DataSize == 0) && IS_DELETED (RecPtr->State)) {
+      return EFI_NOT_FOUND;
+    }
+    OldRecLen = sizeof (VARIABLE_HEADER) + RecPtr->DataSize;
+    IsPending = !IS_DELETED (RecPtr->State);
+  }
+  if (VarInstance->PendingSize - OldRecLen + RecLen > PcdGet32 (PcdVariableWriteBackSize)) {
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  Status = FindVariable (VarStoreHdrPtr, VariableName, VarGuid, &VarHdrPtr);
+  if (EFI_ERROR (Status) && (Status != EFI_NOT_FOUND)) {
+    return Status;
+  }
+
+  //
+  // The new update replaces the queued one
+  //
+  if (RecPtr != NULL) {
+    VarInstance->PendingSize -= OldRecLen;
+    CopyMem (RecPtr, (UINT8 *)RecPtr + OldRecLen, PendingPtr + VarInstance->PendingSize - (UINT8 *)RecPtr);
+  }
+
+  if (DataSize == 0) {
+    if (Status == EFI_NOT_FOUND) {
+      return IsPending ? EFI_SUCCESS : EFI_NOT_FOUND;
+    }
+  } else if (!EFI_ERROR (Status) && (VarHdrPtr->DataSize == VariableNameLen + DataSize) &&
+             (CompareMem ((UINT8 *)&VarHdrPtr[1] + VariableNameLen, Data, DataSize) == 0)) {
+    //
+    // Back to the value in the store
+    //
+    return EFI_SUCCESS;
+  }
+
+  RecPtr = (VARIABLE_HEADER *)(PendingPtr + VarInstance->PendingSize);
+  SetMem (RecPtr, sizeof (VARIABLE_HEADER), 0);
+  RecPtr->StartId  = VARIABLE_DATA;
+  RecPtr->State    = (DataSize > 0) ? 0xFF : (UINT8)~VAR_DELETED;
+  RecPtr->DataSize = (UINT16)(RecLen - sizeof (VARIABLE_HEADER));
+  CopyGuid (&RecPtr->VariableGuid, VarGuid);
+  CopyMem (&RecPtr[1], VariableName, VariableNameLen);
+  if (DataSize > 0) {
+    CopyMem ((UINT8 *)&RecPtr[1] + VariableNameLen, Data, DataSize);
+  }
+  VarInstance->PendingSize += RecLen;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Write the queued variable updates to the variable store.
+
+  The updates are written in the order they were queued, each one with the
+  same power failure protection as a direct write.
+
+  @param[in]  VarInstance     Variable instance.
+
+  @retval     EFI_SUCCESS     All updates were written.
+  @retval     Others          An update failed, it stays queued with the following ones.
+
+**/
+STATIC
+EFI_STATUS
+FlushPendingVariables (
+  IN VARIABLE_INSTANCE      *VarInstance
+  )
+{
+  VARIABLE_HEADER  *RecPtr;
+  UINT8            *PendingPtr;
+  CHAR16           *VariableName;
+  UINT32            VariableNameLen;
+  UINT32            Offset;
+  EFI_STATUS        Status;
+
+  if (VarInstance->PendingSize == 0) {
+    return EFI_SUCCESS;
+  }
+
+  DEBUG ((DEBUG_INFO, "Commit variable updates: 0x%X bytes\n", VarInstance->PendingSize));
+
+  Status     = EFI_SUCCESS;
+  PendingPtr = (UINT8 *)(UINTN)VarInstance->PendingBase;
+  Offset     = 0;
+  while (Offset < VarInstance->PendingSize) {
+    RecPtr          = (VARIABLE_HEADER *)(PendingPtr + Offset);
+    VariableName    = (CHAR16 *)&RecPtr[1];
+    VariableNameLen = (UINT32)StrSize (VariableName);
+    if (IS_DELETED (RecPtr->State)) {
+      Status = WriteVariable (VariableName, &RecPtr->VariableGuid, 0, NULL);
+      if (Status == EFI_NOT_FOUND) {
+        Status = EFI_SUCCESS;
+      }
+    } else {
+      Status = WriteVariable (VariableName, &RecPtr->VariableGuid, RecPtr->DataSize - VariableNameLen,
+                              (UINT8 *)VariableName + VariableNameLen);
+    }
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "Commit variable '%s' failed - %r\n", VariableName, Status));
+      break;
+    }
+    Offset += sizeof (VARIABLE_HEADER) + RecPtr->DataSize;
+  }
+
+  VarInstance->PendingSize -= Offset;
+  CopyMem (PendingPtr, PendingPtr + Offset, VarInstance->PendingSize);
+
+  return Status;
+}
+
+/**
+
+  This code sets variable in storage blocks.
+
+  While write-back is enabled by BeginVariableBatch (), the update is queued
+  in memory and written to the store by CommitVariableBatch ().
+
+  @param VariableName                     Name of Variable to be found.
+  @param VariableGuid                     Zero GUID would be used if it is NULL.
+  @param Attributes                       Attribute value of the variable found
+  @param DataSize                         Size of Data found. If size is less than the
+                                          data, this value contains the required size.
+  @param Data                             Data pointer.
+
+  @return EFI_INVALID_PARAMETER           Invalid parameter.
+  @return EFI_SUCCESS                     Set successfully.
+  @return EFI_OUT_OF_RESOURCES            Resource not enough to set variable.
+  @return EFI_NOT_FOUND                   Not found.
+  @return EFI_WRITE_PROTECTED             Variable is read-only.
+  @return EFI_DEVICE_ERROR                Variable storage is corrupted.
+
+**/
+EFI_STATUS
+EFIAPI
+SetVariable (
+  IN CHAR16                 *VariableName,
+  IN EFI_GUID               *VariableGuid OPTIONAL,
+  IN UINT32                 Attributes OPTIONAL,
+  IN UINTN                  DataSize,
+  IN VOID                   *Data
+  )
+{
+  VARIABLE_INSTANCE      *VarInstance;
+  EFI_GUID               *VarGuid;
+  EFI_STATUS              Status;
+
+  if ((VariableName == NULL) || (VariableName[0] == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((Data == NULL) && (DataSize > 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (sizeof (VARIABLE_HEADER) + StrSize (VariableName) + DataSize > 0xFFFF) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  VarGuid = VariableGuid;
+  if (VarGuid == NULL) {
+    VarGuid = &gZeroGuid;
+  }
+
+  VarInstance = GetVariableInstance ();
+  if ((VarInstance != NULL) && (VarInstance->WriteBack != 0)) {
+    Status = QueueVariable (VarInstance, VariableName, VarGuid, DataSize, Data);
+    if (Status == EFI_BUFFER_TOO_SMALL) {
+      //
+      // Make room by committing the queued updates
+      //
+      Status = FlushPendingVariables (VarInstance);
+      if (!EFI_ERROR (Status)) {
+        Status = QueueVariable (VarInstance, VariableName, VarGuid, DataSize, Data);
+      }
+    }
+    if (Status != EFI_BUFFER_TOO_SMALL) {
+      return Status;
+    }
+  }
+
+  return WriteVariable (VariableName, VarGuid, DataSize, Data);
+}
+
+/**
+  Start queuing variable updates in memory.
+
+  SetVariable () calls made afterwards are coalesced in a pending buffer of
+  PcdVariableWriteBackSize bytes, and they are written to the store at once by
+  CommitVariableBatch (). GetVariable () returns the queued data, while
+  GetNextVariableName () only enumerates the variables in the store.
+  The batch must be committed before the current stage hands over control.
+
+  @retval    EFI_SUCCESS            Write-back is enabled.
+  @retval    EFI_NOT_READY          The variable service is not initialized.
+  @retval    EFI_UNSUPPORTED        PcdVariableWriteBackSize is 0.
+  @retval    EFI_OUT_OF_RESOURCES   The pending buffer cannot be allocated.
+**/
+EFI_STATUS
+EFIAPI
+BeginVariableBatch (
+  VOID
+  )
+{
+  VARIABLE_INSTANCE  *VarInstance;
+  VOID               *Buffer;
+
+  VarInstance = GetVariableInstance ();
+  if ((VarInstance == NULL) || (VarInstance->Signature != VARIABLE_INSTANCE_SIGNATURE)) {
+    return EFI_NOT_READY;
+  }
+
+  if (PcdGet32 (PcdVariableWriteBackSize) == 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (VarInstance->PendingBase == 0) {
+    Buffer = AllocatePool (PcdGet32 (PcdVariableWriteBackSize));
+    if (Buffer == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    VarInstance->PendingBase = (UINT32)(UINTN)Buffer;
+    VarInstance->PendingSize = 0;
+  }
+
+  VarInstance->WriteBack = 1;
+  return EFI_SUCCESS;
+}
+
+/**
+  Write the queued variable updates to the store and stop queuing.
+
+  @retval    EFI_SUCCESS            The queued updates were written.
+  @retval    EFI_NOT_READY          The variable service is not initialized.
+  @retval    Others                 An update failed, the remaining ones stay queued
+                                    and are returned by GetVariable ().
+**/
+EFI_STATUS
+EFIAPI
+CommitVariableBatch (
+  VOID
+  )
+{
+  VARIABLE_INSTANCE  *VarInstance;
+  EFI_STATUS          Status;
+
+  VarInstance = GetVariableInstance ();
+  if ((VarInstance == NULL) || (VarInstance->Signature != VARIABLE_INSTANCE_SIGNATURE)) {
+    return EFI_NOT_READY;
+  }
+
+  VarInstance->WriteBack = 0;
+  if (VarInstance->PendingBase == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Status = FlushPendingVariables (VarInstance);
+  if (VarInstance->PendingSize == 0) {
+    FreePool ((VOID *)(UINTN)VarInstance->PendingBase);
+    VarInstance->PendingBase = 0;
+  }
+
+  return Status;
+}
+
 /**
 
   This code returns information about the variables.
@@ -1111,6 +1774,11 @@ VariableConstructor (
     return Status;
   }
 
+  Status = BuildVariableIndex (VarInstance, GetActiveVaraibelStoreBase (NULL));
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "Variable index build failed %r!\n", Status));
+  }
+
   Status = RegisterService ((VOID *)&mVariableService);
   return Status;
 }
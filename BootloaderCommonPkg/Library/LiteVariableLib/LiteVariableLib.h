@@ -1,7 +1,7 @@
 /** @file
 Lite variable service library header file
 
-Copyright (c) 2006 - 2016, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 Portions copyright (c) 2008 - 2009, Apple Inc. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -26,10 +26,49 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 ///
 #define VARIABLE_INSTANCE_SIGNATURE  SIGNATURE_32 ('V', 'A', 'R', 'I')
 
+///
+/// Number of slots in the variable index, must be a power of 2.
+///
+#define VARIABLE_INDEX_ENTRY_NUM     32
+
+///
+/// Variable index state flags.
+///
+#define VAR_INDEX_VALID              BIT0
+#define VAR_INDEX_OVERFLOW           BIT1
+#define VAR_INDEX_REPAIR             BIT2
+
+///
+/// Variable index slot. The variable header offset is relative to the active
+/// store header so that the index stays valid when the instance is relocated.
+/// An offset of 0 marks an empty slot.
+///
+typedef struct {
+  UINT16                Hash;
+  UINT16                Reserved;
+  UINT32                Offset;
+} VARIABLE_INDEX_ENTRY;
+
 typedef struct {
   UINT32                Signature;
   UINT32                StoreSize;
   UINT32                StoreBase;
+  ///
+  /// Active store header the index was built for.
+  ///
+  UINT32                IndexStore;
+  UINT8                 IndexFlags;
+  ///
+  /// TRUE while variable updates are queued in the pending buffer.
+  ///
+  UINT8                 WriteBack;
+  UINT16                Reserved;
+  ///
+  /// Pending updates, stored as VARIABLE_HEADER + name + data records.
+  ///
+  UINT32                PendingBase;
+  UINT32                PendingSize;
+  VARIABLE_INDEX_ENTRY  Index[VARIABLE_INDEX_ENTRY_NUM];
 } VARIABLE_INSTANCE;
 
 #endif
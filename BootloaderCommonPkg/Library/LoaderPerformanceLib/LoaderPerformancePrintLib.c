@@ -101,6 +101,8 @@ DefPerfIdToStr (
     return "Display splash";
   case 0x3060:
     return "MP wake up";
+  case 0x3070:
+    return "MP AP check-in";
   case 0x3080:
     return "MP init run";
   case 0x3090:
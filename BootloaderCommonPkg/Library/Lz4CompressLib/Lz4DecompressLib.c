@@ -35,6 +35,7 @@
 */
 
 #include "Lz4.h"
+#include <Library/Lz4CompressLib.h>
 
 /**
   Given a LZ4 compressed source buffer, this function retrieves the size of
@@ -130,3 +131,159 @@ Lz4Decompress (
     return RETURN_INVALID_PARAMETER;
   }
 }
+
+/**
+  Given a LZ4B compressed source buffer, this function validates the block
+  table and retrieves the size of the uncompressed buffer.
+
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  DestinationSize A pointer to the size, in bytes, of the uncompressed buffer.
+                          This is an optional parameter that may be NULL.
+  @param  ScratchSize     A pointer to the size, in bytes, of the scratch buffer.
+                          This is an optional parameter that may be NULL.
+
+  @retval  RETURN_SUCCESS            The sizes were returned.
+  @retval  RETURN_INVALID_PARAMETER  The block table is corrupted.
+
+**/
+RETURN_STATUS
+EFIAPI
+Lz4BlockDecompressGetInfo (
+  IN  CONST VOID  *Source,
+  IN  UINT32       SourceSize,
+  OUT UINT32      *DestinationSize,
+  OUT UINT32      *ScratchSize
+  )
+{
+  CONST LZ4B_HEADER  *Header;
+  UINT32              BlockCount;
+  UINT32              TableEnd;
+  UINT32              Index;
+
+  Header = (CONST LZ4B_HEADER *)Source;
+  if ((SourceSize < sizeof (LZ4B_HEADER)) || (Header->BlockSize == 0) || (Header->BlockSize > MAX_INT32)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  BlockCount = Header->Size / Header->BlockSize;
+  if ((Header->Size % Header->BlockSize) != 0) {
+    BlockCount++;
+  }
+  if ((Header->BlockCount != BlockCount) ||
+      (BlockCount >= (SourceSize - sizeof (LZ4B_HEADER)) / sizeof (UINT32))) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  //
+  // The blocks follow the offset table in order
+  //
+  TableEnd = sizeof (LZ4B_HEADER) + (BlockCount + 1) * sizeof (UINT32);
+  if (Header->BlockOffset[0] < TableEnd) {
+    return RETURN_INVALID_PARAMETER;
+  }
+  for (Index = 0; Index < BlockCount; Index++) {
+    if (Header->BlockOffset[Index] > Header->BlockOffset[Index + 1]) {
+      return RETURN_INVALID_PARAMETER;
+    }
+  }
+  if (Header->BlockOffset[BlockCount] > SourceSize) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (DestinationSize != NULL) {
+    *DestinationSize = Header->Size;
+  }
+
+  if (ScratchSize != NULL) {
+    *ScratchSize = 0;
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decompresses a range of blocks of a LZ4B compressed source buffer.
+
+  The blocks are independent, so several ranges of the same buffer can be
+  decompressed concurrently. The block table must have been validated with
+  Lz4BlockDecompressGetInfo() first.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer of the whole decompressed data.
+  @param  FirstBlock  Index of the first block to decompress.
+  @param  BlockCount  Number of blocks to decompress.
+
+  @retval  RETURN_SUCCESS            The blocks were decompressed successfully.
+  @retval  RETURN_INVALID_PARAMETER  The source buffer is corrupted.
+**/
+RETURN_STATUS
+EFIAPI
+Lz4BlockDecompressRange (
+  IN CONST VOID  *Source,
+  IN UINTN        SourceSize,
+  IN OUT VOID    *Destination,
+  IN UINT32       FirstBlock,
+  IN UINT32       BlockCount
+  )
+{
+  CONST LZ4B_HEADER  *Header;
+  UINT32              Index;
+  UINT32              Offset;
+  UINT32              DstOffset;
+  UINT32              DstSize;
+  INT32               Size;
+
+  Header = (CONST LZ4B_HEADER *)Source;
+  if ((FirstBlock > Header->BlockCount) || (BlockCount > Header->BlockCount - FirstBlock)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  for (Index = FirstBlock; Index < FirstBlock + BlockCount; Index++) {
+    Offset    = Header->BlockOffset[Index];
+    DstOffset = Index * Header->BlockSize;
+    DstSize   = MIN (Header->BlockSize, Header->Size - DstOffset);
+    Size = LZ4_decompress_safe ((CONST CHAR8 *)Source + Offset, (CHAR8 *)Destination + DstOffset,
+                                (INT32)(Header->BlockOffset[Index + 1] - Offset), (INT32)DstSize);
+    if ((UINT32)Size != DstSize) {
+      return RETURN_INVALID_PARAMETER;
+    }
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decompresses a LZ4B compressed source buffer, one block after the other.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data
+  @param  Scratch     Not used, may be NULL.
+
+  @retval  RETURN_SUCCESS Decompression completed successfully, and
+                          the uncompressed buffer is returned in Destination.
+  @retval  RETURN_INVALID_PARAMETER
+                          The source buffer specified by Source is corrupted
+                          (not in a valid compressed format).
+**/
+RETURN_STATUS
+EFIAPI
+Lz4BlockDecompress (
+  IN CONST VOID  *Source,
+  IN UINTN        SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  )
+{
+  RETURN_STATUS       Status;
+
+  Status = Lz4BlockDecompressGetInfo (Source, (UINT32)SourceSize, NULL, NULL);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  return Lz4BlockDecompressRange (Source, SourceSize, Destination, 0,
+                                  ((CONST LZ4B_HEADER *)Source)->BlockCount);
+}
@@ -18,6 +18,7 @@
 #include <Library/PciNvmCtrlLib.h>
 #include <Library/MemoryDeviceBlockIoLib.h>
 #include <Library/MmcTuningLib.h>
+#include "MediaAccessLibPrivate.h"
 
 OS_BOOT_MEDIUM_TYPE   mCurrentMediaType = OsBootDeviceMax;
 DEVICE_BLOCK_FUNC     mDeviceBlockFuncs[OsBootDeviceMax];
@@ -188,6 +189,10 @@ MediaReadBlocks (
     return EFI_UNSUPPORTED;
   }
 
+  if (FixedPcdGet32 (PcdMediaCacheBlockCount) > 0) {
+    return MediaCacheReadBlocks (DeviceIndex, StartLBA, BufferSize, Buffer);
+  }
+
   return mDeviceBlockFuncs[mCurrentMediaType].ReadBlocks (DeviceIndex, StartLBA, BufferSize, Buffer);
 }
 
@@ -219,6 +224,8 @@ MediaWriteBlocks (
   IN VOID                         *Buffer
   )
 {
+  EFI_STATUS  Status;
+
   if (mCurrentMediaType >= OsBootDeviceMax) {
     return EFI_NOT_READY;
   }
@@ -227,7 +234,10 @@ MediaWriteBlocks (
     return EFI_UNSUPPORTED;
   }
 
-  return mDeviceBlockFuncs[mCurrentMediaType].WriteBlocks (DeviceIndex, StartLBA, BufferSize, Buffer);
+  Status = mDeviceBlockFuncs[mCurrentMediaType].WriteBlocks (DeviceIndex, StartLBA, BufferSize, Buffer);
+  MediaCacheWriteThrough (DeviceIndex, StartLBA, BufferSize, Buffer, !EFI_ERROR (Status));
+
+  return Status;
 }
 
 /**
@@ -256,6 +266,8 @@ MediaGetMediaInfo (
   OUT DEVICE_BLOCK_INFO              *DevBlockInfo
   )
 {
+  EFI_STATUS  Status;
+
   if (mCurrentMediaType >= OsBootDeviceMax) {
     return EFI_NOT_READY;
   }
@@ -264,7 +276,12 @@ MediaGetMediaInfo (
     return EFI_UNSUPPORTED;
   }
 
-  return mDeviceBlockFuncs[mCurrentMediaType].GetInfo (DeviceIndex, DevBlockInfo);
+  Status = mDeviceBlockFuncs[mCurrentMediaType].GetInfo (DeviceIndex, DevBlockInfo);
+  if (!EFI_ERROR (Status)) {
+    MediaCacheUpdateInfo (DeviceIndex, DevBlockInfo);
+  }
+
+  return Status;
 }
 
 /**
@@ -300,6 +317,11 @@ MediaInitialize (
     return EFI_UNSUPPORTED;
   }
 
+  //
+  // Device enumeration may change what a device index refers to
+  //
+  MediaFlushCache (FALSE);
+
   return mDeviceBlockFuncs[mCurrentMediaType].DevInit (MediaHcPciBase, DevInitPhase);
 }
 
@@ -334,6 +356,8 @@ MediaWriteBlocksExt (
   IN  BOOLEAN                       IsReliableWrite
   )
 {
+  EFI_STATUS  Status;
+
   if (mCurrentMediaType >= OsBootDeviceMax) {
     return EFI_NOT_READY;
   }
@@ -342,7 +366,10 @@ MediaWriteBlocksExt (
     return EFI_UNSUPPORTED;
   }
 
-  return mDeviceBlockFuncs[mCurrentMediaType].WriteBlocksExt (DeviceIndex, StartLBA, BufferSize, Buffer, IsReliableWrite);
+  Status = mDeviceBlockFuncs[mCurrentMediaType].WriteBlocksExt (DeviceIndex, StartLBA, BufferSize, Buffer, IsReliableWrite);
+  MediaCacheWriteThrough (DeviceIndex, StartLBA, BufferSize, Buffer, !EFI_ERROR (Status));
+
+  return Status;
 }
 
 
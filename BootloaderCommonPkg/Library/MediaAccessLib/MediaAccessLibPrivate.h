@@ -0,0 +1,140 @@
+/** @file
+  Internal definitions of the media access library.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _MEDIA_ACCESS_LIB_PRIVATE_H_
+#define _MEDIA_ACCESS_LIB_PRIVATE_H_
+
+#include <Library/MediaAccessLib.h>
+
+#define MEDIA_CACHE_INDEX_NULL             0xFFFFFFFF
+#define MEDIA_CACHE_MAX_BLOCK_SIZE        4096
+
+//
+// Read-ahead window used when a sequential stream is first detected.
+// The window doubles on every further sequential read.
+//
+#define MEDIA_CACHE_MIN_READ_AHEAD        4
+
+//
+// One cached block
+//
+typedef struct {
+  BOOLEAN                Valid;
+  OS_BOOT_MEDIUM_TYPE    MediaType;
+  UINTN                  DeviceIndex;
+  EFI_LBA                Lba;
+  UINT32                 LruPrev;
+  UINT32                 LruNext;
+  UINT32                 HashNext;
+  UINT8                 *Buffer;
+} MEDIA_CACHE_ENTRY;
+
+//
+// Block cache shared by all devices behind MediaReadBlocks().
+// Entries are looked up through a hash table keyed by (MediaType, DeviceIndex, Lba).
+// All entries are kept on a list from the most (LruHead) to the least (LruTail)
+// recently used one; dropped entries go to the tail, and the tail is recycled
+// on a miss. All cached blocks
+// share the same size; the cache is flushed when a device with a different
+// block size is read.
+//
+typedef struct {
+  UINT32                 BlockCount;
+  UINT32                 BlockSize;
+  UINT32                 MaxReadAheadBlocks;
+  UINT32                 StagingBlocks;
+  UINT32                 HashMask;
+  UINT32                 LruHead;
+  UINT32                 LruTail;
+  UINT32                *HashHead;
+  MEDIA_CACHE_ENTRY     *Entry;
+  UINT8                 *Staging;
+
+  //
+  // Media information of the last device that was read
+  //
+  OS_BOOT_MEDIUM_TYPE    MediaType;
+  UINTN                  DeviceIndex;
+  DEVICE_BLOCK_INFO      BlockInfo;
+
+  //
+  // Sequential stream detection
+  //
+  EFI_LBA                NextLba;
+  UINT32                 ReadAheadBlocks;
+
+  UINT64                 Hits;
+  UINT64                 Misses;
+  UINT64                 PrefetchedBlocks;
+  UINT64                 BypassedBlocks;
+} MEDIA_CACHE;
+
+extern OS_BOOT_MEDIUM_TYPE   mCurrentMediaType;
+extern DEVICE_BLOCK_FUNC     mDeviceBlockFuncs[OsBootDeviceMax];
+
+/**
+  Read blocks from the current media through the block cache.
+
+  @param[in]  DeviceIndex   Specifies the block device to which the function wants
+                            to talk.
+  @param[in]  StartLBA      The starting logical block address (LBA) to read from
+                            on the device
+  @param[in]  BufferSize    The size of the Buffer in bytes.
+  @param[out] Buffer        A pointer to the destination buffer for the data.
+
+  @retval EFI_SUCCESS       The data was read correctly from the device.
+  @retval Others            The device reported an error.
+
+**/
+EFI_STATUS
+MediaCacheReadBlocks (
+  IN  UINTN                          DeviceIndex,
+  IN  EFI_LBA                        StartLBA,
+  IN  UINTN                          BufferSize,
+  OUT VOID                          *Buffer
+  );
+
+/**
+  Update the block cache after blocks have been written to the current media.
+
+  Cached copies of the written blocks are refreshed from Buffer when the write
+  succeeded, or dropped when it failed.
+
+  @param[in]  DeviceIndex   Specifies the block device that was written.
+  @param[in]  StartLBA      The first block that was written.
+  @param[in]  BufferSize    The number of bytes that were written.
+  @param[in]  Buffer        The data that was written.
+  @param[in]  Written       TRUE if the write succeeded.
+
+**/
+VOID
+MediaCacheWriteThrough (
+  IN  UINTN                          DeviceIndex,
+  IN  EFI_LBA                        StartLBA,
+  IN  UINTN                          BufferSize,
+  IN  VOID                          *Buffer,
+  IN  BOOLEAN                        Written
+  );
+
+/**
+  Refresh the cached media information of a device.
+
+  The cache is flushed when the media information changed, e.g. because the
+  media was replaced.
+
+  @param[in]  DeviceIndex   Specifies the block device.
+  @param[in]  DevBlockInfo  The current block information of the device.
+
+**/
+VOID
+MediaCacheUpdateInfo (
+  IN  UINTN                          DeviceIndex,
+  IN  DEVICE_BLOCK_INFO             *DevBlockInfo
+  );
+
+#endif
@@ -0,0 +1,668 @@
+/** @file
+  The file provides a write-through block cache with read-ahead for the
+  media block I/O interfaces.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/DebugLib.h>
+#include <Library/PcdLib.h>
+#include "MediaAccessLibPrivate.h"
+
+STATIC MEDIA_CACHE   mMediaCache;
+
+/**
+  Free the block cache buffers.
+
+  The statistics are preserved.
+
+**/
+STATIC
+VOID
+MediaCacheFree (
+  VOID
+  )
+{
+  MEDIA_CACHE          *Cache;
+
+  Cache = &mMediaCache;
+  if (Cache->Entry != NULL) {
+    if (Cache->Entry[0].Buffer != NULL) {
+      FreePool (Cache->Entry[0].Buffer);
+    }
+    FreePool (Cache->Entry);
+    Cache->Entry = NULL;
+  }
+  if (Cache->HashHead != NULL) {
+    FreePool (Cache->HashHead);
+    Cache->HashHead = NULL;
+  }
+  if (Cache->Staging != NULL) {
+    FreePool (Cache->Staging);
+    Cache->Staging = NULL;
+  }
+  Cache->BlockSize = 0;
+}
+
+/**
+  Initialize the block cache for a block size.
+
+  The number of cached blocks and the maximum read-ahead window are
+  configured through PcdMediaCacheBlockCount and PcdMediaCacheReadAheadBlocks.
+
+  @param[in]  BlockSize     The block size of the device to cache.
+
+  @retval EFI_SUCCESS            The cache was initialized.
+  @retval EFI_UNSUPPORTED        The cache is disabled or the block size is not supported.
+  @retval EFI_OUT_OF_RESOURCES   Insufficient memory for the cache.
+
+**/
+STATIC
+EFI_STATUS
+MediaCacheInit (
+  IN  UINT32               BlockSize
+  )
+{
+  MEDIA_CACHE          *Cache;
+  UINT8                *Data;
+  UINT32                Buckets;
+  UINT32                Index;
+
+  if ((FixedPcdGet32 (PcdMediaCacheBlockCount) == 0) ||
+      (BlockSize == 0) || (BlockSize > MEDIA_CACHE_MAX_BLOCK_SIZE)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  MediaCacheFree ();
+
+  Cache = &mMediaCache;
+  Cache->BlockCount         = MAX (FixedPcdGet32 (PcdMediaCacheBlockCount), 4);
+  Cache->MaxReadAheadBlocks = MIN (FixedPcdGet32 (PcdMediaCacheReadAheadBlocks), Cache->BlockCount / 2);
+  Cache->ReadAheadBlocks    = 0;
+
+  //
+  // Requests up to the larger of the read-ahead window and a quarter of the
+  // cache go through the cache. Misses are fetched together with the
+  // read-ahead blocks into the staging buffer.
+  //
+  Cache->StagingBlocks = MAX (Cache->MaxReadAheadBlocks, Cache->BlockCount / 4) + Cache->MaxReadAheadBlocks;
+
+  Buckets = GetPowerOfTwo32 (Cache->BlockCount);
+  if (Buckets < Cache->BlockCount) {
+    Buckets <<= 1;
+  }
+  Cache->HashMask = Buckets - 1;
+
+  Cache->HashHead = (UINT32 *) AllocatePool (Buckets * sizeof (UINT32));
+  Cache->Entry    = (MEDIA_CACHE_ENTRY *) AllocateZeroPool (Cache->BlockCount * sizeof (MEDIA_CACHE_ENTRY));
+  Cache->Staging  = (UINT8 *) AllocatePool (Cache->StagingBlocks * BlockSize);
+  Data            = (UINT8 *) AllocatePool (Cache->BlockCount * BlockSize);
+  if ((Cache->HashHead == NULL) || (Cache->Entry == NULL) || (Cache->Staging == NULL) || (Data == NULL)) {
+    if (Data != NULL) {
+      FreePool (Data);
+    }
+    MediaCacheFree ();
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  SetMem (Cache->HashHead, Buckets * sizeof (UINT32), 0xFF);
+  for (Index = 0; Index < Cache->BlockCount; Index++) {
+    Cache->Entry[Index].Buffer   = Data + Index * BlockSize;
+    Cache->Entry[Index].HashNext = MEDIA_CACHE_INDEX_NULL;
+    Cache->Entry[Index].LruPrev  = (Index == 0) ? MEDIA_CACHE_INDEX_NULL : Index - 1;
+    Cache->Entry[Index].LruNext  = (Index == Cache->BlockCount - 1) ? MEDIA_CACHE_INDEX_NULL : Index + 1;
+  }
+  Cache->LruHead   = 0;
+  Cache->LruTail   = Cache->BlockCount - 1;
+  Cache->BlockSize = BlockSize;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the hash bucket for a cached block.
+
+  @param[in]  Cache         The block cache.
+  @param[in]  MediaType     The media type of the device.
+  @param[in]  DeviceIndex   The device index.
+  @param[in]  Lba           The logical block address.
+
+  @return The hash bucket index.
+
+**/
+STATIC
+UINT32
+MediaCacheHash (
+  IN  MEDIA_CACHE          *Cache,
+  IN  OS_BOOT_MEDIUM_TYPE   MediaType,
+  IN  UINTN                 DeviceIndex,
+  IN  EFI_LBA               Lba
+  )
+{
+  UINT32                Hash;
+
+  Hash  = (UINT32) Lba ^ (UINT32) RShiftU64 (Lba, 32);
+  Hash ^= ((UINT32) DeviceIndex << 8 | (UINT32) MediaType) * 0x9E3779B1;
+  Hash ^= Hash >> 16;
+  return Hash & Cache->HashMask;
+}
+
+/**
+  Move a cache entry to one end of the LRU list.
+
+  @param[in]  Cache         The block cache.
+  @param[in]  Entry         The cache entry to move.
+  @param[in]  Recent        TRUE to make it the most recently used entry,
+                            FALSE to make it the first one to recycle.
+
+**/
+STATIC
+VOID
+MediaCacheLruMove (
+  IN  MEDIA_CACHE          *Cache,
+  IN  MEDIA_CACHE_ENTRY    *Entry,
+  IN  BOOLEAN               Recent
+  )
+{
+  UINT32                Index;
+
+  Index = (UINT32) (Entry - Cache->Entry);
+  if ((Recent && (Cache->LruHead == Index)) || (!Recent && (Cache->LruTail == Index))) {
+    return;
+  }
+
+  //
+  // Unlink it
+  //
+  if (Entry->LruPrev != MEDIA_CACHE_INDEX_NULL) {
+    Cache->Entry[Entry->LruPrev].LruNext = Entry->LruNext;
+  } else {
+    Cache->LruHead = Entry->LruNext;
+  }
+  if (Entry->LruNext != MEDIA_CACHE_INDEX_NULL) {
+    Cache->Entry[Entry->LruNext].LruPrev = Entry->LruPrev;
+  } else {
+    Cache->LruTail = Entry->LruPrev;
+  }
+
+  //
+  // And put it at the requested end, the list holds at least another entry
+  //
+  if (Recent) {
+    Entry->LruPrev = MEDIA_CACHE_INDEX_NULL;
+    Entry->LruNext = Cache->LruHead;
+    Cache->Entry[Cache->LruHead].LruPrev = Index;
+    Cache->LruHead = Index;
+  } else {
+    Entry->LruNext = MEDIA_CACHE_INDEX_NULL;
+    Entry->LruPrev = Cache->LruTail;
+    Cache->Entry[Cache->LruTail].LruNext = Index;
+    Cache->LruTail = Index;
+  }
+}
+
+/**
+  Look up a block in the cache.
+
+  @param[in]  Cache         The block cache.
+  @param[in]  MediaType     The media type of the device.
+  @param[in]  DeviceIndex   The device index.
+  @param[in]  Lba           The logical block address.
+
+  @return The cache entry holding the block, or NULL if it is not cached.
+
+**/
+STATIC
+MEDIA_CACHE_ENTRY *
+MediaCacheLookup (
+  IN  MEDIA_CACHE          *Cache,
+  IN  OS_BOOT_MEDIUM_TYPE   MediaType,
+  IN  UINTN                 DeviceIndex,
+  IN  EFI_LBA               Lba
+  )
+{
+  UINT32                Index;
+  MEDIA_CACHE_ENTRY    *Entry;
+
+  Index = Cache->HashHead[MediaCacheHash (Cache, MediaType, DeviceIndex, Lba)];
+  while (Index != MEDIA_CACHE_INDEX_NULL) {
+    Entry = &Cache->Entry[Index];
+    if (Entry->Valid && (Entry->Lba == Lba) && (Entry->DeviceIndex == DeviceIndex) && (Entry->MediaType == MediaType)) {
+      return Entry;
+    }
+    Index = Entry->HashNext;
+  }
+
+  return NULL;
+}
+
+/**
+  Remove a cache entry from its hash chain and mark it invalid.
+
+  @param[in]  Cache         The block cache.
+  @param[in]  Entry         The cache entry to drop.
+
+**/
+STATIC
+VOID
+MediaCacheDrop (
+  IN  MEDIA_CACHE          *Cache,
+  IN  MEDIA_CACHE_ENTRY    *Entry
+  )
+{
+  UINT32                Index;
+  UINT32               *Link;
+
+  if (!Entry->Valid) {
+    return;
+  }
+
+  Index = (UINT32) (Entry - Cache->Entry);
+  Link  = &Cache->HashHead[MediaCacheHash (Cache, Entry->MediaType, Entry->DeviceIndex, Entry->Lba)];
+  while (*Link != MEDIA_CACHE_INDEX_NULL) {
+    if (*Link == Index) {
+      *Link = Entry->HashNext;
+      break;
+    }
+    Link = &Cache->Entry[*Link].HashNext;
+  }
+  Entry->HashNext = MEDIA_CACHE_INDEX_NULL;
+  Entry->Valid    = FALSE;
+  MediaCacheLruMove (Cache, Entry, FALSE);
+}
+
+/**
+  Store a block in the cache, recycling the least recently used entry if the
+  block is not cached yet.
+
+  @param[in]  Cache         The block cache.
+  @param[in]  MediaType     The media type of the device.
+  @param[in]  DeviceIndex   The device index.
+  @param[in]  Lba           The logical block address.
+  @param[in]  Data          The block data.
+
+**/
+STATIC
+VOID
+MediaCacheInsert (
+  IN  MEDIA_CACHE          *Cache,
+  IN  OS_BOOT_MEDIUM_TYPE   MediaType,
+  IN  UINTN                 DeviceIndex,
+  IN  EFI_LBA               Lba,
+  IN  CONST UINT8          *Data
+  )
+{
+  UINT32                Victim;
+  UINT32                Bucket;
+  MEDIA_CACHE_ENTRY    *Entry;
+
+  Entry = MediaCacheLookup (Cache, MediaType, DeviceIndex, Lba);
+  if (Entry == NULL) {
+    //
+    // Recycle the least recently used entry. Invalid entries are kept
+    // behind all valid ones, so they are picked first.
+    //
+    Victim = Cache->LruTail;
+    Entry  = &Cache->Entry[Victim];
+    MediaCacheDrop (Cache, Entry);
+
+    Entry->MediaType   = MediaType;
+    Entry->DeviceIndex = DeviceIndex;
+    Entry->Lba         = Lba;
+    Entry->Valid       = TRUE;
+
+    Bucket = MediaCacheHash (Cache, MediaType, DeviceIndex, Lba);
+    Entry->HashNext         = Cache->HashHead[Bucket];
+    Cache->HashHead[Bucket] = Victim;
+  }
+
+  CopyMem (Entry->Buffer, Data, Cache->BlockSize);
+  MediaCacheLruMove (Cache, Entry, TRUE);
+}
+
+/**
+  Make sure the cache is set up for a device.
+
+  The media information of the device is queried when it differs from the last
+  device that was read, and the cache is re-initialized if its block size does
+  not match.
+
+  @param[in]  DeviceIndex   Specifies the block device.
+
+  @retval EFI_SUCCESS       The cache can be used for the device.
+  @retval Others            The cache cannot be used for the device.
+
+**/
+STATIC
+EFI_STATUS
+MediaCachePrepare (
+  IN  UINTN                 DeviceIndex
+  )
+{
+  EFI_STATUS            Status;
+  MEDIA_CACHE          *Cache;
+  DEVICE_BLOCK_INFO     BlockInfo;
+
+  Cache = &mMediaCache;
+  if ((Cache->BlockSize == 0) || (Cache->MediaType != mCurrentMediaType) || (Cache->DeviceIndex != DeviceIndex)) {
+    if (mDeviceBlockFuncs[mCurrentMediaType].GetInfo == NULL) {
+      return EFI_UNSUPPORTED;
+    }
+    Status = mDeviceBlockFuncs[mCurrentMediaType].GetInfo (DeviceIndex, &BlockInfo);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if (BlockInfo.BlockSize != Cache->BlockSize) {
+      Status = MediaCacheInit (BlockInfo.BlockSize);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    }
+
+    Cache->MediaType       = mCurrentMediaType;
+    Cache->DeviceIndex     = DeviceIndex;
+    Cache->BlockInfo       = BlockInfo;
+    Cache->NextLba         = MAX_UINT64;
+    Cache->ReadAheadBlocks = 0;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Read blocks from the current media through the block cache.
+
+  Requests larger than the cacheable size bypass the cache. For smaller ones,
+  cached blocks are copied out and every run of missing blocks is fetched with
+  a single device read. When the request continues the previous one, the read
+  is extended by an adaptive read-ahead window that doubles on each sequential
+  request, up to PcdMediaCacheReadAheadBlocks.
+
+  @param[in]  DeviceIndex   Specifies the block device to which the function wants
+                            to talk.
+  @param[in]  StartLBA      The starting logical block address (LBA) to read from
+                            on the device
+  @param[in]  BufferSize    The size of the Buffer in bytes.
+  @param[out] Buffer        A pointer to the destination buffer for the data.
+
+  @retval EFI_SUCCESS       The data was read correctly from the device.
+  @retval Others            The device reported an error.
+
+**/
+EFI_STATUS
+MediaCacheReadBlocks (
+  IN  UINTN                          DeviceIndex,
+  IN  EFI_LBA                        StartLBA,
+  IN  UINTN                          BufferSize,
+  OUT VOID                          *Buffer
+  )
+{
+  EFI_STATUS            Status;
+  MEDIA_CACHE          *Cache;
+  MEDIA_CACHE_ENTRY    *Entry;
+  DEVICE_READ_BLOCKS    ReadBlocks;
+  UINT8                *Dest;
+  UINTN                 Blocks;
+  UINTN                 Index;
+  UINTN                 Run;
+  UINTN                 Fetch;
+  UINTN                 Loop;
+  UINT64                Remaining;
+  BOOLEAN               Sequential;
+
+  Cache      = &mMediaCache;
+  ReadBlocks = mDeviceBlockFuncs[mCurrentMediaType].ReadBlocks;
+
+  Status = MediaCachePrepare (DeviceIndex);
+  if (EFI_ERROR (Status) || (BufferSize == 0) || ((BufferSize % Cache->BlockSize) != 0)) {
+    return ReadBlocks (DeviceIndex, StartLBA, BufferSize, Buffer);
+  }
+
+  Blocks     = BufferSize / Cache->BlockSize;
+  Sequential = (StartLBA == Cache->NextLba);
+  Cache->NextLba = StartLBA + Blocks;
+
+  //
+  // Adapt the read-ahead window to the access pattern
+  //
+  if (!Sequential || (Cache->MaxReadAheadBlocks == 0)) {
+    Cache->ReadAheadBlocks = 0;
+  } else if (Cache->ReadAheadBlocks == 0) {
+    Cache->ReadAheadBlocks = MIN (MEDIA_CACHE_MIN_READ_AHEAD, Cache->MaxReadAheadBlocks);
+  } else {
+    Cache->ReadAheadBlocks = MIN (Cache->ReadAheadBlocks * 2, Cache->MaxReadAheadBlocks);
+  }
+
+  //
+  // Large transfers go straight to the device so that they do not flush the cache
+  //
+  if (Blocks > Cache->StagingBlocks - Cache->MaxReadAheadBlocks) {
+    Cache->BypassedBlocks += Blocks;
+    return ReadBlocks (DeviceIndex, StartLBA, BufferSize, Buffer);
+  }
+
+  Dest  = (UINT8 *) Buffer;
+  Index = 0;
+  while (Index < Blocks) {
+    Entry = MediaCacheLookup (Cache, mCurrentMediaType, DeviceIndex, StartLBA + Index);
+    if (Entry != NULL) {
+      CopyMem (Dest + Index * Cache->BlockSize, Entry->Buffer, Cache->BlockSize);
+      MediaCacheLruMove (Cache, Entry, TRUE);
+      Cache->Hits++;
+      Index++;
+      continue;
+    }
+
+    //
+    // Fetch the run of missing blocks with a single read, plus the read-ahead
+    // window if the run reaches the end of the request.
+    //
+    for (Run = 1; Index + Run < Blocks; Run++) {
+      if (MediaCacheLookup (Cache, mCurrentMediaType, DeviceIndex, StartLBA + Index + Run) != NULL) {
+        break;
+      }
+    }
+    Fetch = Run;
+    if (Index + Run == Blocks) {
+      Fetch += Cache->ReadAheadBlocks;
+      if (Cache->BlockInfo.BlockNum > StartLBA + Index) {
+        Remaining = Cache->BlockInfo.BlockNum - (StartLBA + Index);
+        if (Fetch > Remaining) {
+          Fetch = (UINTN) MAX (Remaining, Run);
+        }
+      }
+    }
+
+    Status = ReadBlocks (DeviceIndex, StartLBA + Index, Fetch * Cache->BlockSize, Cache->Staging);
+    if (EFI_ERROR (Status) && (Fetch > Run)) {
+      //
+      // The read-ahead may fail at the end of the media, retry without it
+      //
+      Fetch  = Run;
+      Status = ReadBlocks (DeviceIndex, StartLBA + Index, Fetch * Cache->BlockSize, Cache->Staging);
+    }
+    if (EFI_ERROR (Status)) {
+      Cache->NextLba         = MAX_UINT64;
+      Cache->ReadAheadBlocks = 0;
+      return Status;
+    }
+
+    for (Loop = 0; Loop < Fetch; Loop++) {
+      MediaCacheInsert (Cache, mCurrentMediaType, DeviceIndex, StartLBA + Index + Loop, Cache->Staging + Loop * Cache->BlockSize);
+    }
+    CopyMem (Dest + Index * Cache->BlockSize, Cache->Staging, Run * Cache->BlockSize);
+
+    Cache->Misses           += Run;
+    Cache->PrefetchedBlocks += Fetch - Run;
+    Index                   += Run;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Update the block cache after blocks have been written to the current media.
+
+  Cached copies of the written blocks are refreshed from Buffer when the write
+  succeeded, or dropped when it failed.
+
+  @param[in]  DeviceIndex   Specifies the block device that was written.
+  @param[in]  StartLBA      The first block that was written.
+  @param[in]  BufferSize    The number of bytes that were written.
+  @param[in]  Buffer        The data that was written.
+  @param[in]  Written       TRUE if the write succeeded.
+
+**/
+VOID
+MediaCacheWriteThrough (
+  IN  UINTN                          DeviceIndex,
+  IN  EFI_LBA                        StartLBA,
+  IN  UINTN                          BufferSize,
+  IN  VOID                          *Buffer,
+  IN  BOOLEAN                        Written
+  )
+{
+  MEDIA_CACHE          *Cache;
+  MEDIA_CACHE_ENTRY    *Entry;
+  UINTN                 Index;
+  UINTN                 Blocks;
+
+  //
+  // All the cached blocks share one block size, so a device with blocks
+  // in the cache always has Cache->BlockSize sized blocks.
+  //
+  Cache = &mMediaCache;
+  if (Cache->BlockSize == 0) {
+    return;
+  }
+
+  if ((BufferSize % Cache->BlockSize) != 0) {
+    MediaFlushCache (FALSE);
+    return;
+  }
+
+  Blocks = BufferSize / Cache->BlockSize;
+  for (Index = 0; Index < Blocks; Index++) {
+    Entry = MediaCacheLookup (Cache, mCurrentMediaType, DeviceIndex, StartLBA + Index);
+    if (Entry != NULL) {
+      if (Written) {
+        CopyMem (Entry->Buffer, (UINT8 *) Buffer + Index * Cache->BlockSize, Cache->BlockSize);
+      } else {
+        MediaCacheDrop (Cache, Entry);
+      }
+    }
+  }
+}
+
+/**
+  Refresh the cached media information of a device.
+
+  The cache is flushed when the media information changed, e.g. because the
+  media was replaced.
+
+  @param[in]  DeviceIndex   Specifies the block device.
+  @param[in]  DevBlockInfo  The current block information of the device.
+
+**/
+VOID
+MediaCacheUpdateInfo (
+  IN  UINTN                          DeviceIndex,
+  IN  DEVICE_BLOCK_INFO             *DevBlockInfo
+  )
+{
+  MEDIA_CACHE          *Cache;
+
+  Cache = &mMediaCache;
+  if ((Cache->BlockSize == 0) || (Cache->MediaType != mCurrentMediaType) || (Cache->DeviceIndex != DeviceIndex)) {
+    return;
+  }
+
+  if ((Cache->BlockInfo.BlockSize != DevBlockInfo->BlockSize) ||
+      (Cache->BlockInfo.BlockNum  != DevBlockInfo->BlockNum)) {
+    MediaFlushCache (FALSE);
+  }
+}
+
+/**
+  Get the block cache statistics.
+
+  @param[out] CacheInfo     The block cache statistics.
+
+  @retval EFI_SUCCESS             The statistics were returned.
+  @retval EFI_INVALID_PARAMETER   CacheInfo is NULL.
+  @retval EFI_UNSUPPORTED         The block cache is disabled.
+
+**/
+EFI_STATUS
+EFIAPI
+MediaGetCacheInfo (
+  OUT MEDIA_CACHE_INFO              *CacheInfo
+  )
+{
+  MEDIA_CACHE          *Cache;
+
+  if (CacheInfo == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (FixedPcdGet32 (PcdMediaCacheBlockCount) == 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Cache = &mMediaCache;
+  CacheInfo->BlockCount         = Cache->BlockCount;
+  CacheInfo->BlockSize          = Cache->BlockSize;
+  CacheInfo->ReadAheadBlocks    = Cache->ReadAheadBlocks;
+  CacheInfo->MaxReadAheadBlocks = Cache->MaxReadAheadBlocks;
+  CacheInfo->Hits               = Cache->Hits;
+  CacheInfo->Misses             = Cache->Misses;
+  CacheInfo->PrefetchedBlocks   = Cache->PrefetchedBlocks;
+  CacheInfo->BypassedBlocks     = Cache->BypassedBlocks;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Drop all the blocks held in the block cache.
+
+  @param[in]  ResetStatistics   TRUE to also clear the hit/miss statistics.
+
+**/
+VOID
+EFIAPI
+MediaFlushCache (
+  IN  BOOLEAN                        ResetStatistics
+  )
+{
+  MEDIA_CACHE          *Cache;
+  UINT32                Index;
+
+  Cache = &mMediaCache;
+  if (Cache->BlockSize != 0) {
+    SetMem (Cache->HashHead, (Cache->HashMask + 1) * sizeof (UINT32), 0xFF);
+    for (Index = 0; Index < Cache->BlockCount; Index++) {
+      Cache->Entry[Index].Valid    = FALSE;
+      Cache->Entry[Index].HashNext = MEDIA_CACHE_INDEX_NULL;
+    }
+  }
+
+  //
+  // Query the media information again on the next read
+  //
+  Cache->MediaType       = OsBootDeviceMax;
+  Cache->NextLba         = MAX_UINT64;
+  Cache->ReadAheadBlocks = 0;
+
+  if (ResetStatistics) {
+    Cache->Hits             = 0;
+    Cache->Misses           = 0;
+    Cache->PrefetchedBlocks = 0;
+    Cache->BypassedBlocks   = 0;
+  }
+}
@@ -1740,8 +1740,8 @@ MmcReadWrite (
   Remaining = BlockNum;
 
   MaxBlock = PcdGet16 (PcdEmmcMaxRwBlockNumber);
-  if (FeaturePcdGet(PcdDmaProtectionEnabled)) {
-    // When DMA protection is enabled, only tranfer less than DMA buffer size
+  if (!IoMmuIsDirectDma (Buffer, BufferSize)) {
+    // When DMA is bounced, only tranfer less than DMA buffer size
     // Use half for safe.  Around 1MB will be used for CmdTable.
     MaxBlock = (PcdGet32 (PcdDmaBufferSize) >> 1) / CardData->BlockLen;
     if (MaxBlock == 0) {
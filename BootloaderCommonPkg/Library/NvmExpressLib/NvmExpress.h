@@ -28,6 +28,7 @@
 #include <Library/TimerLib.h>
 #include <Library/PciExpressLib.h>
 #include <Library/IoMmuLib.h>
+#include <Library/PcdLib.h>
 
 typedef struct _NVME_CONTROLLER_PRIVATE_DATA NVME_CONTROLLER_PRIVATE_DATA;
 typedef struct _NVME_DEVICE_PRIVATE_DATA     NVME_DEVICE_PRIVATE_DATA;
@@ -64,6 +65,19 @@ typedef struct _NVME_BLKIO2_SUBTASK          NVME_BLKIO2_SUBTASK;
 
 #define NVME_MAX_QUEUES                           3     // Number of queues supported by the driver
 
+//
+// Maximum number of read commands kept in flight on the asynchronous I/O queue
+// when DMA protection is enabled. Each of them needs its own bounce buffer.
+//
+#define NVME_ASYNC_DMA_PROTECTED_DEPTH            2
+
+//
+// There is no event service in the bootloader. Commands are sent to the
+// asynchronous I/O queue with this event, and their completions are reaped
+// by polling NvmeAsyncPassThruReap().
+//
+#define NVME_ASYNC_POLL_EVENT                     ((EFI_EVENT)(UINTN)-1)
+
 #define NVME_CONTROLLER_ID                        0
 
 //
@@ -357,6 +371,42 @@ NvmExpressGetNextNamespace (
   IN OUT UINT32                                      *NamespaceId
   );
 
+/**
+  Reap the completed commands on the asynchronous I/O queue.
+
+  Every completion found is matched with its pending request. The request's
+  data mappings and PRP lists are released and the completion entry is
+  copied to the caller's command packet.
+
+  @param[in]     Private          The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in,out] Outstanding      On input, the number of commands the caller is waiting for.
+                                  On output, decremented by the number of commands reaped.
+
+  @retval EFI_SUCCESS             All reaped commands completed successfully.
+  @retval EFI_DEVICE_ERROR        At least one reaped command failed.
+
+**/
+EFI_STATUS
+NvmeAsyncPassThruReap (
+  IN     NVME_CONTROLLER_PRIVATE_DATA     *Private,
+  IN OUT UINTN                            *Outstanding
+  );
+
+/**
+  Cancel all pending requests on the asynchronous I/O queue.
+
+  Each pending command is aborted and its completion is waited for before
+  its DMA buffers are released. If any command does not complete, the
+  controller is reset first.
+
+  @param[in]     Private          The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+**/
+VOID
+NvmeAsyncPassThruCancel (
+  IN     NVME_CONTROLLER_PRIVATE_DATA     *Private
+  );
+
 /**
   Dump the execution status from a given completion queue entry.
 
@@ -2,7 +2,7 @@
   NvmExpressDxe driver is used to manage non-volatile memory subsystem which follows
   NVM Express specification.
 
-  Copyright (c) 2013 - 2020, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2013 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -14,6 +14,7 @@
 
   @param[in]  Private       The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
   @param[in]  BlockSize     The media block size.
+  @param[in]  QueueDepth    The number of commands kept in flight together.
 
   @retval Max transfer block.
 
@@ -22,7 +23,8 @@ STATIC
 UINT32
 GetMaxTransferBlockNumber (
   IN  NVME_CONTROLLER_PRIVATE_DATA   *Private,
-  IN  UINT32                          BlockSize
+  IN  UINT32                          BlockSize,
+  IN  UINTN                           QueueDepth
 )
 {
   UINT32  MaxTransferBlocks;
@@ -34,14 +36,76 @@ GetMaxTransferBlockNumber (
     MaxTransferBlocks = 1024;
   }
 
-  MaxDmaTransferBlocks = (PcdGet32 (PcdDmaBufferSize) >> 1) / BlockSize;
-  if (MaxDmaTransferBlocks < MaxTransferBlocks) {
-    MaxTransferBlocks = MaxDmaTransferBlocks;
+  if (!IoMmuIsDirectDma (NULL, 0)) {
+    //
+    // Transfers are bounced through the DMA buffer, so only use half of it
+    // for all the commands in flight. The other half keeps the mapping
+    // information and the PRP lists.
+    //
+    MaxDmaTransferBlocks = (UINT32)(((PcdGet32 (PcdDmaBufferSize) >> 1) / QueueDepth) / BlockSize);
+    if (MaxDmaTransferBlocks == 0) {
+      MaxDmaTransferBlocks = 1;
+    }
+    if (MaxDmaTransferBlocks < MaxTransferBlocks) {
+      MaxTransferBlocks = MaxDmaTransferBlocks;
+    }
   }
   return MaxTransferBlocks;
 }
 
 
+//
+// Command packet storage for one read on the asynchronous I/O queue
+//
+typedef struct {
+  EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET CommandPacket;
+  EFI_NVM_EXPRESS_COMMAND                  Command;
+  EFI_NVM_EXPRESS_COMPLETION               Completion;
+} NVME_ASYNC_READ_SLOT;
+
+/**
+  Build a read command packet.
+
+  @param  Device                 The pointer to the NVME_DEVICE_PRIVATE_DATA data structure.
+  @param  Slot                   The command packet storage to fill.
+  @param  Buffer                 The buffer used to store the data read from the device.
+  @param  Lba                    The start block number.
+  @param  Blocks                 Total block number to be read.
+
+**/
+STATIC
+VOID
+NvmeBuildReadPacket (
+  IN  NVME_DEVICE_PRIVATE_DATA          *Device,
+  OUT NVME_ASYNC_READ_SLOT              *Slot,
+  IN  UINT64                            Buffer,
+  IN  UINT64                            Lba,
+  IN  UINT32                            Blocks
+  )
+{
+  EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET *CommandPacket;
+
+  ZeroMem (Slot, sizeof (NVME_ASYNC_READ_SLOT));
+  CommandPacket = &Slot->CommandPacket;
+
+  CommandPacket->NvmeCmd        = &Slot->Command;
+  CommandPacket->NvmeCompletion = &Slot->Completion;
+
+  CommandPacket->NvmeCmd->Cdw0.Opcode = NVME_IO_READ_OPC;
+  CommandPacket->NvmeCmd->Nsid        = Device->NamespaceId;
+  CommandPacket->TransferBuffer       = (VOID *) (UINTN)Buffer;
+
+  CommandPacket->TransferLength = Blocks * Device->Media.BlockSize;
+  CommandPacket->CommandTimeout = NVME_GENERIC_TIMEOUT;
+  CommandPacket->QueueType      = NVME_IO_QUEUE;
+
+  CommandPacket->NvmeCmd->Cdw10 = (UINT32)Lba;
+  CommandPacket->NvmeCmd->Cdw11 = (UINT32)RShiftU64 (Lba, 32);
+  CommandPacket->NvmeCmd->Cdw12 = (Blocks - 1) & 0xFFFF;
+
+  CommandPacket->NvmeCmd->Flags = CDW10_VALID | CDW11_VALID | CDW12_VALID;
+}
+
 /**
   Read some sectors from the device.
 
@@ -63,44 +127,131 @@ ReadSectors (
   )
 {
   NVME_CONTROLLER_PRIVATE_DATA             *Private;
-  UINT32                                   Bytes;
-  EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET CommandPacket;
-  EFI_NVM_EXPRESS_COMMAND                  Command;
-  EFI_NVM_EXPRESS_COMPLETION               Completion;
+  NVME_ASYNC_READ_SLOT                     Slot;
   EFI_STATUS                               Status;
-  UINT32                                   BlockSize;
 
-  Private    = Device->Controller;
-  BlockSize  = Device->Media.BlockSize;
-  Bytes      = Blocks * BlockSize;
+  Private = Device->Controller;
+  NvmeBuildReadPacket (Device, &Slot, Buffer, Lba, Blocks);
 
-  ZeroMem (&CommandPacket, sizeof (EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET));
-  ZeroMem (&Command, sizeof (EFI_NVM_EXPRESS_COMMAND));
-  ZeroMem (&Completion, sizeof (EFI_NVM_EXPRESS_COMPLETION));
+  Status = Private->Passthru.PassThru (
+             &Private->Passthru,
+             Device->NamespaceId,
+             &Slot.CommandPacket,
+             NULL
+             );
 
-  CommandPacket.NvmeCmd        = &Command;
-  CommandPacket.NvmeCompletion = &Completion;
+  return Status;
+}
 
-  CommandPacket.NvmeCmd->Cdw0.Opcode = NVME_IO_READ_OPC;
-  CommandPacket.NvmeCmd->Nsid        = Device->NamespaceId;
-  CommandPacket.TransferBuffer       = (VOID *) (UINTN)Buffer;
+/**
+  Read some sectors from the device with multiple commands in flight.
 
-  CommandPacket.TransferLength = Bytes;
-  CommandPacket.CommandTimeout = NVME_GENERIC_TIMEOUT;
-  CommandPacket.QueueType      = NVME_IO_QUEUE;
+  The read is split into commands of the largest size the queue depth allows.
+  They are submitted together on the asynchronous I/O queue with PRPs pointing
+  at the destination buffer, and their completions are reaped in batches. When
+  transfers are bounced for DMA protection, the commands in flight share half
+  of the DMA buffer.
 
-  CommandPacket.NvmeCmd->Cdw10 = (UINT32)Lba;
-  CommandPacket.NvmeCmd->Cdw11 = (UINT32)RShiftU64 (Lba, 32);
-  CommandPacket.NvmeCmd->Cdw12 = (Blocks - 1) & 0xFFFF;
+  @param  Device                 The pointer to the NVME_DEVICE_PRIVATE_DATA data structure.
+  @param  Buffer                 The buffer used to store the data read from the device.
+  @param  Lba                    The start block number.
+  @param  Blocks                 Total block number to be read.
 
-  CommandPacket.NvmeCmd->Flags = CDW10_VALID | CDW11_VALID | CDW12_VALID;
+  @retval EFI_SUCCESS            Datum are read from the device.
+  @retval EFI_OUT_OF_RESOURCES   Not enough memory for the command packets.
+  @retval EFI_TIMEOUT            The commands did not complete in time.
+  @retval Others                 Fail to read all the datum.
 
-  Status = Private->Passthru.PassThru (
-             &Private->Passthru,
-             Device->NamespaceId,
-             &CommandPacket,
-             NULL
-             );
+**/
+STATIC
+EFI_STATUS
+NvmeReadAsync (
+  IN     NVME_DEVICE_PRIVATE_DATA       *Device,
+  OUT    VOID                           *Buffer,
+  IN     UINT64                         Lba,
+  IN     UINTN                          Blocks
+  )
+{
+  EFI_STATUS                       Status;
+  EFI_STATUS                       ReapStatus;
+  NVME_CONTROLLER_PRIVATE_DATA     *Private;
+  NVME_ASYNC_READ_SLOT             *Slots;
+  UINTN                            QueueDepth;
+  UINTN                            Index;
+  UINTN                            Outstanding;
+  UINT32                           ChunkBlocks;
+  UINT32                           MaxTransferBlocks;
+  UINT32                           BlockSize;
+  UINT64                           TimeCount;
+
+  Private   = Device->Controller;
+  BlockSize = Device->Media.BlockSize;
+
+  //
+  // One submission queue entry always stays empty to tell a full queue from an empty one.
+  //
+  QueueDepth = MIN (NVME_ASYNC_CSQ_SIZE, Private->Cap.Mqes);
+  if (!IoMmuIsDirectDma (Buffer, Blocks * BlockSize)) {
+    QueueDepth = MIN (QueueDepth, NVME_ASYNC_DMA_PROTECTED_DEPTH);
+  }
+  MaxTransferBlocks = GetMaxTransferBlockNumber (Private, BlockSize, QueueDepth);
+  QueueDepth = MIN (QueueDepth, (Blocks + MaxTransferBlocks - 1) / MaxTransferBlocks);
+
+  Slots = AllocatePool (QueueDepth * sizeof (NVME_ASYNC_READ_SLOT));
+  if (Slots == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = EFI_SUCCESS;
+  while ((Blocks > 0) && !EFI_ERROR (Status)) {
+    //
+    // Submit a batch of commands
+    //
+    Outstanding = 0;
+    for (Index = 0; (Index < QueueDepth) && (Blocks > 0); Index++) {
+      ChunkBlocks = (Blocks > MaxTransferBlocks) ? MaxTransferBlocks : (UINT32)Blocks;
+      NvmeBuildReadPacket (Device, &Slots[Index], (UINT64) (UINTN)Buffer, Lba, ChunkBlocks);
+      Status = Private->Passthru.PassThru (
+                 &Private->Passthru,
+                 Device->NamespaceId,
+                 &Slots[Index].CommandPacket,
+                 NVME_ASYNC_POLL_EVENT
+                 );
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+
+      Outstanding++;
+      Blocks -= ChunkBlocks;
+      Buffer  = (VOID *) (UINTN) ((UINT64) (UINTN)Buffer + ChunkBlocks * BlockSize);
+      Lba    += ChunkBlocks;
+    }
+
+    //
+    // Reap the completions of the batch
+    //
+    TimeCount = RShiftU64 (NVME_GENERIC_TIMEOUT, 7);
+    while (Outstanding > 0) {
+      ReapStatus = NvmeAsyncPassThruReap (Private, &Outstanding);
+      if (EFI_ERROR (ReapStatus)) {
+        Status = ReapStatus;
+      }
+      if (Outstanding == 0) {
+        break;
+      }
+      if (TimeCount-- == 0) {
+        Status = EFI_TIMEOUT;
+        break;
+      }
+      NanoSecondDelay (100);
+    }
+
+    if (Outstanding > 0) {
+      NvmeAsyncPassThruCancel (Private);
+    }
+  }
+
+  FreePool (Slots);
 
   return Status;
 }
@@ -219,7 +370,20 @@ NvmeRead (
   BlockSize     = Device->Media.BlockSize;
   OrginalBlocks = Blocks;
 
-  MaxTransferBlocks = GetMaxTransferBlockNumber (Private, BlockSize);
+  MaxTransferBlocks = GetMaxTransferBlockNumber (Private, BlockSize, 1);
+  if (Blocks > MaxTransferBlocks) {
+    //
+    // Keep multiple commands in flight for large reads
+    //
+    Status = NvmeReadAsync (Device, Buffer, Lba, Blocks);
+    if (Status != EFI_OUT_OF_RESOURCES) {
+      DEBUG ((DEBUG_VERBOSE, "%a: Lba = 0x%08Lx, Blocks = 0x%08Lx, BlockSize = 0x%x, Status = %r\n",
+              __FUNCTION__, Lba, (UINT64)Blocks, BlockSize, Status));
+      return Status;
+    }
+    Status = EFI_SUCCESS;
+  }
+
   while (Blocks > 0) {
     if (Blocks > MaxTransferBlocks) {
       Status = ReadSectors (Device, (UINT64) (UINTN)Buffer, Lba, MaxTransferBlocks);
@@ -289,7 +453,7 @@ NvmeWrite (
   BlockSize     = Device->Media.BlockSize;
   OrginalBlocks = Blocks;
 
-  MaxTransferBlocks = GetMaxTransferBlockNumber (Private, BlockSize);
+  MaxTransferBlocks = GetMaxTransferBlockNumber (Private, BlockSize, 1);
   while (Blocks > 0) {
     if (Blocks > MaxTransferBlocks) {
       Status = WriteSectors (Device, (UINT64) (UINTN)Buffer, Lba, MaxTransferBlocks);
@@ -681,6 +681,239 @@ EXIT:
   return Status;
 }
 
+/**
+  Release the resources of a request on the asynchronous I/O queue.
+
+  @param[in]     AsyncRequest     The request to release.
+
+**/
+STATIC
+VOID
+NvmeFreeAsyncRequest (
+  IN     NVME_PASS_THRU_ASYNC_REQ         *AsyncRequest
+  )
+{
+  if (AsyncRequest->MapData != NULL) {
+    IoMmuUnmap (AsyncRequest->MapData);
+  }
+
+  if (AsyncRequest->MapMeta != NULL) {
+    IoMmuUnmap (AsyncRequest->MapMeta);
+  }
+
+  if (AsyncRequest->PrpListHost != NULL) {
+    IoMmuFreeBuffer (AsyncRequest->PrpListNo, AsyncRequest->PrpListHost, AsyncRequest->MapPrpList);
+  }
+
+  RemoveEntryList (&AsyncRequest->Link);
+  FreePool (AsyncRequest);
+}
+
+/**
+  Reap the completed commands on the asynchronous I/O queue.
+
+  Every completion found is matched with its pending request. The request's
+  data mappings and PRP lists are released and the completion entry is
+  copied to the caller's command packet.
+
+  @param[in]     Private          The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in,out] Outstanding      On input, the number of commands the caller is waiting for.
+                                  On output, decremented by the number of commands reaped.
+
+  @retval EFI_SUCCESS             All reaped commands completed successfully.
+  @retval EFI_DEVICE_ERROR        At least one reaped command failed.
+
+**/
+EFI_STATUS
+NvmeAsyncPassThruReap (
+  IN     NVME_CONTROLLER_PRIVATE_DATA     *Private,
+  IN OUT UINTN                            *Outstanding
+  )
+{
+  EFI_STATUS                     Status;
+  NVME_CQ                        *Cq;
+  LIST_ENTRY                     *Link;
+  NVME_PASS_THRU_ASYNC_REQ       *AsyncRequest;
+  UINT16                         QueueId;
+  UINT16                         QueueSize;
+  UINT32                         Data;
+  BOOLEAN                        Reaped;
+
+  Status    = EFI_SUCCESS;
+  QueueId   = 2;
+  QueueSize = MIN (NVME_ASYNC_CCQ_SIZE, Private->Cap.Mqes) + 1;
+  Reaped    = FALSE;
+
+  while (TRUE) {
+    Cq = Private->CqBuffer[QueueId] + Private->CqHdbl[QueueId].Cqh;
+    if (Cq->Pt == Private->Pt[QueueId]) {
+      break;
+    }
+
+    AsyncRequest = NULL;
+    for (Link = GetFirstNode (&Private->AsyncPassThruQueue);
+         !IsNull (&Private->AsyncPassThruQueue, Link);
+         Link = GetNextNode (&Private->AsyncPassThruQueue, Link)) {
+      if (NVME_PASS_THRU_ASYNC_REQ_FROM_THIS (Link)->CommandId == Cq->Cid) {
+        AsyncRequest = NVME_PASS_THRU_ASYNC_REQ_FROM_THIS (Link);
+        break;
+      }
+    }
+
+    if (AsyncRequest != NULL) {
+      if ((Cq->Sct != 0) || (Cq->Sc != 0)) {
+        Status = EFI_DEVICE_ERROR;
+        DEBUG_CODE_BEGIN();
+        NvmeDumpStatus (Cq);
+        DEBUG_CODE_END();
+      }
+      CopyMem (AsyncRequest->Packet->NvmeCompletion, Cq, sizeof (EFI_NVM_EXPRESS_COMPLETION));
+      NvmeFreeAsyncRequest (AsyncRequest);
+      if (*Outstanding > 0) {
+        (*Outstanding)--;
+      }
+    }
+
+    Private->AsyncSqHead = Cq->Sqhd;
+    Private->CqHdbl[QueueId].Cqh = (Private->CqHdbl[QueueId].Cqh + 1) % QueueSize;
+    if (Private->CqHdbl[QueueId].Cqh == 0) {
+      Private->Pt[QueueId] ^= 1;
+    }
+    Reaped = TRUE;
+  }
+
+  //
+  // Release all reaped completion queue entries with a single doorbell write.
+  //
+  if (Reaped) {
+    Data = ReadUnaligned32 ((UINT32 *)&Private->CqHdbl[QueueId]);
+    NvmHcRwMmio (Private->NvmeHCBase, NVME_CQHDBL_OFFSET (QueueId, Private->Cap.Dstrd), FALSE, sizeof (Data),
+                 &Data);
+  }
+
+  return Status;
+}
+
+/**
+  Ask the controller to abort a command on the asynchronous I/O queue.
+
+  @param[in]     Private          The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in]     CommandId        The command identifier of the command to abort.
+
+  @retval EFI_SUCCESS             The abort command completed.
+  @retval Others                  The abort command failed.
+
+**/
+STATIC
+EFI_STATUS
+NvmeAsyncPassThruAbort (
+  IN     NVME_CONTROLLER_PRIVATE_DATA     *Private,
+  IN     UINT16                           CommandId
+  )
+{
+  EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET CommandPacket;
+  EFI_NVM_EXPRESS_COMMAND                  Command;
+  EFI_NVM_EXPRESS_COMPLETION               Completion;
+
+  ZeroMem (&CommandPacket, sizeof (EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET));
+  ZeroMem (&Command, sizeof (EFI_NVM_EXPRESS_COMMAND));
+  ZeroMem (&Completion, sizeof (EFI_NVM_EXPRESS_COMPLETION));
+
+  Command.Cdw0.Opcode = NVME_ADMIN_ABORT_CMD;
+  //
+  // Cdw10 holds the submission queue identifier and the command identifier.
+  //
+  Command.Cdw10       = 2 | ((UINT32)CommandId << 16);
+  Command.Flags       = CDW10_VALID;
+
+  CommandPacket.NvmeCmd        = &Command;
+  CommandPacket.NvmeCompletion = &Completion;
+  CommandPacket.CommandTimeout = NVME_GENERIC_TIMEOUT;
+  CommandPacket.QueueType      = NVME_ADMIN_QUEUE;
+
+  return Private->Passthru.PassThru (
+                             &Private->Passthru,
+                             NVME_CONTROLLER_ID,
+                             &CommandPacket,
+                             NULL
+                             );
+}
+
+/**
+  Cancel all pending requests on the asynchronous I/O queue.
+
+  The controller may still transfer data for a pending request, so its DMA
+  buffers cannot be released before the command is done. Each pending
+  command is aborted first and its completion is waited for. If any command
+  does not complete, the controller is reset, which stops all of its DMA
+  and recreates the I/O queues.
+
+  @param[in]     Private          The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+**/
+VOID
+NvmeAsyncPassThruCancel (
+  IN     NVME_CONTROLLER_PRIVATE_DATA     *Private
+  )
+{
+  EFI_STATUS                     Status;
+  LIST_ENTRY                     *Link;
+  NVME_PASS_THRU_ASYNC_REQ       *AsyncRequest;
+  UINTN                          Outstanding;
+  UINT64                         TimeCount;
+
+  //
+  // Abort every pending command. An abort may complete without aborting
+  // the command, its completion is waited for below either way.
+  //
+  Outstanding = 0;
+  for (Link = GetFirstNode (&Private->AsyncPassThruQueue);
+       !IsNull (&Private->AsyncPassThruQueue, Link);
+       Link = GetNextNode (&Private->AsyncPassThruQueue, Link)) {
+    AsyncRequest = NVME_PASS_THRU_ASYNC_REQ_FROM_THIS (Link);
+    Status = NvmeAsyncPassThruAbort (Private, AsyncRequest->CommandId);
+    DEBUG ((DEBUG_INFO, "NVMe abort command 0x%x: %r\n", AsyncRequest->CommandId, Status));
+    Outstanding++;
+  }
+
+  //
+  // Reaping a completion releases the buffers of its request
+  //
+  TimeCount = RShiftU64 (NVME_GENERIC_TIMEOUT, 7);
+  while (Outstanding > 0) {
+    NvmeAsyncPassThruReap (Private, &Outstanding);
+    if ((Outstanding == 0) || (TimeCount-- == 0)) {
+      break;
+    }
+    NanoSecondDelay (100);
+  }
+
+  if (IsListEmpty (&Private->AsyncPassThruQueue)) {
+    return;
+  }
+
+  //
+  // Disabling the controller stops the remaining transfers
+  //
+  Status = NvmeControllerInit (Private);
+  if (EFI_ERROR (Status)) {
+    //
+    // The controller may still write to the buffers, so keep them allocated
+    //
+    DEBUG ((DEBUG_ERROR, "NVMe controller reset failed: %r\n", Status));
+    while (!IsListEmpty (&Private->AsyncPassThruQueue)) {
+      Link = GetFirstNode (&Private->AsyncPassThruQueue);
+      RemoveEntryList (Link);
+      FreePool (NVME_PASS_THRU_ASYNC_REQ_FROM_THIS (Link));
+    }
+    return;
+  }
+
+  while (!IsListEmpty (&Private->AsyncPassThruQueue)) {
+    NvmeFreeAsyncRequest (NVME_PASS_THRU_ASYNC_REQ_FROM_THIS (GetFirstNode (&Private->AsyncPassThruQueue)));
+  }
+}
+
 /**
   Used to retrieve the next namespace ID for this NVM Express controller.
 
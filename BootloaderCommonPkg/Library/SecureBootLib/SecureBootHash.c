@@ -160,7 +160,6 @@ DoHashVerify (
   )
 {
   RETURN_STATUS        Status;
-  RETURN_STATUS        Status2;
   UINT8                Digest[HASH_DIGEST_MAX];
   UINT8                DigestSize;
 
@@ -185,6 +184,67 @@ DoHashVerify (
     return RETURN_UNSUPPORTED;
   }
 
+  Status = DoDigestVerify (Digest, Usage, HashAlg, HashData);
+  if (EFI_ERROR(Status)) {
+    DEBUG_CODE_BEGIN();
+
+    DEBUG ((DEBUG_INFO, "First %d Bytes Input Data\n", DigestSize));
+    DumpHex (2, 0, DigestSize, (VOID *)Data);
+
+    DEBUG ((DEBUG_INFO, "Last %d Bytes Input Data\n", DigestSize));
+    DumpHex (2, 0, DigestSize, (VOID *) (Data + Length - DigestSize));
+
+    DEBUG_CODE_END();
+  }
+
+  return Status;
+}
+
+/**
+  Verify a pre-calculated data digest with the built-in one.
+
+  This is used when the data hash has been accumulated incrementally by
+  the caller, e.g. while the data was being copied into memory.
+
+  @param[in]  Digest         Calculated data digest.
+  @param[in]  Usage          Hash component usage.
+  @param[in]  HashAlg        Specify hash algorithm.
+  @param[in,out]  HashData   On input,  expected hash value when hash component usage is 0.
+                             On output, calculated hash value when verification succeeds.
+
+  @retval RETURN_SUCCESS             Hash verification succeeded.
+  @retval RETURN_INVALID_PARAMETER   Hash parameter is not valid.
+  @retval RETURN_SECURITY_VIOLATION  Hash verification failed.
+
+**/
+RETURN_STATUS
+EFIAPI
+DoDigestVerify (
+  IN CONST UINT8           *Digest,
+  IN       HASH_COMP_USAGE  Usage,
+  IN       UINT8            HashAlg,
+  IN OUT   UINT8           *HashData
+  )
+{
+  RETURN_STATUS        Status;
+  RETURN_STATUS        Status2;
+  UINT8                DigestSize;
+
+  if ((Digest == NULL) ||
+      ((HashAlg != HASH_TYPE_SHA256) && (HashAlg != HASH_TYPE_SHA384))) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if ((Usage == 0) && (HashData == NULL)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (HashAlg == HASH_TYPE_SHA256) {
+    DigestSize = SHA256_DIGEST_SIZE;
+  } else {
+    DigestSize = SHA384_DIGEST_SIZE;
+  }
+
   Status = RETURN_SECURITY_VIOLATION;
   if (Usage == 0) {
     // Compare hash with the buffer passed in
@@ -193,7 +253,7 @@ DoHashVerify (
     }
   } else {
     // Compare hash with the the one stored in hash store
-    Status2 = MatchHashInStore (Usage, HashAlg, Digest);
+    Status2 = MatchHashInStore (Usage, HashAlg, (UINT8 *)Digest);
     if (!EFI_ERROR(Status2)) {
       if (HashData != NULL) {
         CopyMem (HashData, Digest, DigestSize);
@@ -206,17 +266,13 @@ DoHashVerify (
   if (EFI_ERROR(Status)) {
     DEBUG_CODE_BEGIN();
 
-    DEBUG ((DEBUG_INFO, "First %d Bytes Input Data\n", DigestSize));
-    DumpHex (2, 0, DigestSize, (VOID *)Data);
-
-    DEBUG ((DEBUG_INFO, "Last %d Bytes Input Data\n", DigestSize));
-    DumpHex (2, 0, DigestSize, (VOID *) (Data + Length - DigestSize));
-
     DEBUG ((DEBUG_INFO, "Image Digest\n"));
     DumpHex (2, 0, DigestSize, (VOID *)Digest);
 
-    DEBUG ((DEBUG_INFO, "HashStore Digest\n"));
-    DumpHex (2, 0, DigestSize, (VOID *)HashData);
+    if (HashData != NULL) {
+      DEBUG ((DEBUG_INFO, "HashStore Digest\n"));
+      DumpHex (2, 0, DigestSize, (VOID *)HashData);
+    }
 
     DEBUG_CODE_END();
   }
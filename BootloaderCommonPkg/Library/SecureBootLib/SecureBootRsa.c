@@ -130,3 +130,63 @@ DoRsaVerify (
 
   return Status;
 }
+
+/**
+  Verifies the RSA signature with PKCS1-v1_5 encoding scheme against a
+  pre-calculated message digest.
+
+  This is used when the message hash has been accumulated incrementally by
+  the caller. RSA-PSS requires the whole message and is not supported here.
+
+  @param[in]  Digest          Calculated message digest.
+  @param[in]  HashAlg         Hash algorithm used to calculate Digest.
+  @param[in]  Usage           Hash usage.
+  @param[in]  Signature       Signature header for singanture data.
+  @param[in]  PubKeyHdr       Public key header for key data
+  @param[in]  PubKeyHashAlg   Hash Alg for PubKeyHash.
+  @param[in]  PubKeyHash      Public key hash value when hash component usage is 0.
+
+  @retval RETURN_SUCCESS             RSA verification succeeded.
+  @retval RETURN_INVALID_PARAMETER   Signature or key header is not valid.
+  @retval RETURN_NOT_FOUND           Hash data for hash component usage is not found.
+  @retval RETURN_UNSUPPORTED         Signing scheme or hash alg is not supported.
+  @retval RETURN_SECURITY_VIOLATION  PubKey or Signature verification failed.
+
+**/
+RETURN_STATUS
+EFIAPI
+DoRsaDigestVerify (
+  IN CONST UINT8           *Digest,
+  IN       UINT8            HashAlg,
+  IN       HASH_COMP_USAGE  Usage,
+  IN CONST SIGNATURE_HDR   *SignatureHdr,
+  IN       PUB_KEY_HDR     *PubKeyHdr,
+  IN       UINT8            PubKeyHashAlg,
+  IN       UINT8           *PubKeyHash      OPTIONAL
+  )
+{
+  RETURN_STATUS    Status;
+  PUB_KEY_HDR     *PublicKey;
+
+  PublicKey = PubKeyHdr;
+  if ((Digest == NULL) || (PublicKey->Identifier != PUBKEY_IDENTIFIER) ||
+      (SignatureHdr->Identifier != SIGNATURE_IDENTIFIER)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if ((SignatureHdr->SigType != SIGNING_TYPE_RSA_PKCS_1_5) || (SignatureHdr->HashAlg != HashAlg)) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  // Verify public key first
+  Status = DoHashVerify (PublicKey->KeyData, PublicKey->KeySize, Usage, PubKeyHashAlg, PubKeyHash);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = RsaVerify_Pkcs_1_5 (PublicKey, SignatureHdr, Digest);
+
+  DEBUG ((DEBUG_INFO, "RSA verification for usage (0x%08X): %r\n", Usage, Status));
+
+  return Status;
+}
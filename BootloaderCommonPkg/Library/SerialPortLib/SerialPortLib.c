@@ -1,6 +1,6 @@
 /** @file
 
-  Copyright (c) 2017 - 2019, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2017 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -8,7 +8,9 @@
 #include <Base.h>
 #include <Library/BaseLib.h>
 #include <Library/IoLib.h>
+#include <Library/PcdLib.h>
 #include <Library/PlatformHookLib.h>
+#include <Library/SerialPortLib.h>
 
 //---------------------------------------------
 // UART Register Offsets
@@ -33,6 +35,7 @@
 //---------------------------------------------
 #define LSR_TXRDY               0x20
 #define LSR_RXDA                0x01
+#define EIR_FIFO_ENABLED        0xC0
 #define DLAB                    0x01
 #define UART_MAGIC              0x55
 
@@ -183,22 +186,36 @@ SerialPortWrite (
   )
 {
   UINTN  Result;
+  UINTN  FifoSize;
+  UINTN  Count;
   UINT8  Data;
 
   if (NULL == Buffer) {
     return 0;
   }
 
+  //
+  // An empty TX FIFO takes a burst of bytes at once
+  //
+  FifoSize = 1;
+  if ((SerialPortReadRegister (EIR_OFFSET) & EIR_FIFO_ENABLED) == EIR_FIFO_ENABLED) {
+    FifoSize = MAX (PcdGet32 (PcdSerialTxFifoSize), 1);
+  }
+
   Result = NumberOfBytes;
 
-  while (NumberOfBytes--) {
+  while (NumberOfBytes > 0) {
     //
     // Wait for the serail port to be ready.
     //
     do {
       Data = SerialPortReadRegister (LSR_OFFSET);
     } while ((Data & LSR_TXRDY) == 0);
-    SerialPortWriteRegister (0, *Buffer++);
+
+    for (Count = MIN (NumberOfBytes, FifoSize); Count > 0; Count--) {
+      SerialPortWriteRegister (0, *Buffer++);
+    }
+    NumberOfBytes -= MIN (NumberOfBytes, FifoSize);
   }
 
   return Result;
@@ -270,3 +287,33 @@ SerialPortPoll (
   return FALSE;
 }
 
+/**
+  Retrieve the status of the control bits on a serial device.
+
+  Only EFI_SERIAL_INPUT_BUFFER_EMPTY and EFI_SERIAL_OUTPUT_BUFFER_EMPTY are
+  reported.
+
+  @param Control                A pointer to return the current control signals from the serial device.
+
+  @retval RETURN_SUCCESS        The control bits were read from the serial device.
+
+**/
+RETURN_STATUS
+EFIAPI
+SerialPortGetControl (
+  OUT UINT32 *Control
+  )
+{
+  UINT8  Lsr;
+
+  Lsr      = SerialPortReadRegister (LSR_OFFSET);
+  *Control = 0;
+  if ((Lsr & LSR_RXDA) == 0) {
+    *Control |= EFI_SERIAL_INPUT_BUFFER_EMPTY;
+  }
+  if ((Lsr & LSR_TXRDY) != 0) {
+    *Control |= EFI_SERIAL_OUTPUT_BUFFER_EMPTY;
+  }
+
+  return RETURN_SUCCESS;
+}
@@ -0,0 +1,95 @@
+/** @file
+  Shell command `blkcache` to display or reset the media block cache.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/ShellLib.h>
+#include <Library/MediaAccessLib.h>
+
+/**
+  Display or reset the media block cache.
+
+  @param[in]  Shell        shell instance
+  @param[in]  Argc         number of command line arguments
+  @param[in]  Argv         command line arguments
+
+  @retval EFI_SUCCESS
+
+**/
+EFI_STATUS
+EFIAPI
+ShellCommandBlkCacheFunc (
+  IN SHELL  *Shell,
+  IN UINTN   Argc,
+  IN CHAR16 *Argv[]
+  );
+
+CONST SHELL_COMMAND ShellCommandBlkCache = {
+  L"blkcache",
+  L"Display or reset media block cache statistics",
+  &ShellCommandBlkCacheFunc
+};
+
+/**
+  Display or reset the media block cache.
+
+  @param[in]  Shell        shell instance
+  @param[in]  Argc         number of command line arguments
+  @param[in]  Argv         command line arguments
+
+  @retval EFI_SUCCESS
+
+**/
+EFI_STATUS
+EFIAPI
+ShellCommandBlkCacheFunc (
+  IN SHELL  *Shell,
+  IN UINTN   Argc,
+  IN CHAR16 *Argv[]
+  )
+{
+  EFI_STATUS            Status;
+  MEDIA_CACHE_INFO      CacheInfo;
+  UINT64                Lookups;
+
+  if (Argc > 2) {
+    goto usage;
+  }
+
+  if (Argc == 2) {
+    if (StrCmp (Argv[1], L"flush") == 0) {
+      MediaFlushCache (FALSE);
+    } else if (StrCmp (Argv[1], L"reset") == 0) {
+      MediaFlushCache (TRUE);
+    } else {
+      goto usage;
+    }
+    return EFI_SUCCESS;
+  }
+
+  Status = MediaGetCacheInfo (&CacheInfo);
+  if (EFI_ERROR (Status)) {
+    ShellPrint (L"Media block cache is disabled\n");
+    return EFI_SUCCESS;
+  }
+
+  ShellPrint (L"Block Cache: %d x %d bytes, read-ahead %d (max %d) blocks\n",
+    CacheInfo.BlockCount, CacheInfo.BlockSize, CacheInfo.ReadAheadBlocks, CacheInfo.MaxReadAheadBlocks);
+
+  Lookups = CacheInfo.Hits + CacheInfo.Misses;
+  ShellPrint (L"  Hits: %ld  Misses: %ld  Hit rate: %ld%%\n",
+    CacheInfo.Hits, CacheInfo.Misses, (Lookups == 0) ? 0 : DivU64x64Remainder (MultU64x32 (CacheInfo.Hits, 100), Lookups, NULL));
+  ShellPrint (L"  Prefetched: %ld  Bypassed: %ld blocks\n",
+    CacheInfo.PrefetchedBlocks, CacheInfo.BypassedBlocks);
+
+  return EFI_SUCCESS;
+
+usage:
+  ShellPrint (L"Usage: %s [flush|reset]\n", Argv[0]);
+  ShellPrint (L"  flush  - drop all cached blocks\n");
+  ShellPrint (L"  reset  - drop all cached blocks and clear the statistics\n");
+  return EFI_ABORTED;
+}
@@ -1,7 +1,7 @@
 /** @file
   Shell command `Cdata` to display configuration data.
 
-  Copyright (c) 2018, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2018 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -61,6 +61,27 @@ PrintBlobheader (
   ShellPrint (L"    TotalLength :%x\n", CdataBlob->TotalLength);
 }
 
+/**
+  Print the configuration data index statistics.
+
+**/
+VOID
+PrintIndexInfo (
+  VOID
+  )
+{
+  CDATA_INDEX         *Index;
+
+  Index = GetConfigDataIndex ();
+  if (Index == NULL) {
+    ShellPrint (L"No config data index, lookups scan the database\n");
+    return;
+  }
+  ShellPrint (L"Config data index:\n");
+  ShellPrint (L"    Entries     :%d\n", Index->Count);
+  ShellPrint (L"    Lookups     :%d\n", Index->LookupCount);
+}
+
 /**
   Print configuration data only for specified tag.
 
@@ -186,6 +207,7 @@ ShellCommandCdataFunc (
   BOOLEAN             CfgHeaderPrint;
   BOOLEAN             DataBaseDump;
   BOOLEAN             UsagePrint;
+  BOOLEAN             IndexPrint;
   UINT32              Tag;
 
 
@@ -199,6 +221,7 @@ ShellCommandCdataFunc (
   BlobPrint      = FALSE;
   CfgHeaderPrint = FALSE;
   DataBaseDump   = FALSE;
+  IndexPrint     = FALSE;
   Tag            = 0;
 
   // Check flags
@@ -218,6 +241,10 @@ ShellCommandCdataFunc (
       DataBaseDump = TRUE;
       UsagePrint = FALSE;
     }
+    if (StrCmp (Argv[Index], L"-i") == 0) {
+      IndexPrint = TRUE;
+      UsagePrint = FALSE;
+    }
     if (StrCmp (Argv[Index], L"-t") == 0) {
       Index++;
       Tag = (UINT32)StrHexToUintn (Argv[Index]);
@@ -241,14 +268,19 @@ ShellCommandCdataFunc (
     PrintTag (CdataBlob, Tag);
   }
 
+  if (IndexPrint) {
+    PrintIndexInfo ();
+  }
+
   if (UsagePrint) {
-    ShellPrint (L"Usage: %s [-h] [-b] [-c] [-d] [-t tag]\n", Argv[0]);
+    ShellPrint (L"Usage: %s [-h] [-b] [-c] [-d] [-i] [-t tag]\n", Argv[0]);
     ShellPrint (L"\n"
                 L"Flags:\n"
                 L"  -h     help\n"
                 L"  -b     Print config database header\n"
                 L"  -c     Print all the configuratin header\n"
                 L"  -d     Dump config database\n"
+                L"  -i     Print config database index statistics\n"
                 L"  -t tag Print configuration data with specified tag\n");
   }
   return EFI_SUCCESS;
@@ -1,7 +1,7 @@
 /** @file
   Shell command `dmesg` to print the contents of the log buffer.
 
-  Copyright (c) 2018, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2018 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -68,6 +68,8 @@ ShellCommandDmesgFunc (
   BOOLEAN                  Paged = FALSE;
   UINTN                    Length;
   UINTN                    BufIndex;
+  UINTN                    RecordLength;
+  UINTN                    TraceCount;
 
   for (Index = 1; Index < Argc; Index++) {
     if (StrCmp (Argv[Index], L"-h") == 0) {
@@ -96,7 +98,22 @@ ShellCommandDmesgFunc (
     Length   = LogBufHdr->UsedLength - LogBufHdr->HeaderLength;
   }
 
+  TraceCount = 0;
   for (Index = 0; Index < Length; Index++, BufIndex++) {
+    // Binary trace records can only be rendered on the host, skip them
+    if (((LogBufHdr->Attribute & DEBUG_LOG_BUFFER_ATTRIBUTE_TRACE) != 0) &&
+        (LogBufHdr->Buffer[BufIndex % Length] == DEBUG_LOG_TRACE_MARKER)) {
+      RecordLength = LogBufHdr->Buffer[(BufIndex + 2) % Length] | (LogBufHdr->Buffer[(BufIndex + 3) % Length] << 8);
+      if (RecordLength >= sizeof (DEBUG_LOG_TRACE_RECORD)) {
+        if (LogBufHdr->Buffer[(BufIndex + 1) % Length] == DEBUG_LOG_TRACE_TYPE_MESSAGE) {
+          TraceCount++;
+        }
+        Index    += RecordLength - 1;
+        BufIndex += RecordLength - 1;
+        continue;
+      }
+    }
+
     ConsoleWrite ((UINT8 *)&LogBufHdr->Buffer[BufIndex % Length], 1);
 
     // Page out the log contents if requested
@@ -109,6 +126,10 @@ ShellCommandDmesgFunc (
     }
   }
 
+  if (TraceCount > 0) {
+    ShellPrint (L"\n%d binary trace records not shown, decode the log buffer with DecodeTraceLog.py\n", TraceCount);
+  }
+
   return EFI_SUCCESS;
 
 usage:
@@ -334,6 +334,7 @@ CmdFsInfo (
   UINT32                HwPartNo;
   UINT32                SwPartNo;
   OS_FILE_SYSTEM_TYPE   FsType;
+  FS_CACHE_INFO         CacheInfo;
 
   ShellPrint (L"Current DeviceType: %a\n", (mDeviceType != OsBootDeviceMax) ?
     GetBootDeviceNameString (mDeviceType) : "Not Initialized");
@@ -360,6 +361,14 @@ CmdFsInfo (
   ShellPrint (L"Current FileSystem: %a\n", (FsType != EnumFileSystemMax) ?
     GetFsTypeString (FsType) : "Not Detected");
 
+  Status = GetFileSystemCacheInfo (mFsHandle, &CacheInfo);
+  if (!EFI_ERROR (Status)) {
+    ShellPrint (L"Block Cache: %d x %d bytes, read-ahead %d blocks\n",
+      CacheInfo.BlockCount, CacheInfo.BlockSize, CacheInfo.ReadAheadBlocks);
+    ShellPrint (L"  Hits: %ld  Misses: %ld  Prefetched: %ld\n",
+      CacheInfo.Hits, CacheInfo.Misses, CacheInfo.PrefetchedBlocks);
+  }
+
   return EFI_SUCCESS;
 }
 
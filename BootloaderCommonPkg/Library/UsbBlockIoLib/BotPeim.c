@@ -1,7 +1,7 @@
 /** @file
 BOT Transportation implementation.
 
-Copyright (c) 2006, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -181,7 +181,6 @@ BotDataPhase (
   UINT8           EndpointAddr;
   UINTN           Remain;
   UINTN           Increment;
-  UINT32          MaxPacketLen;
   UINT8           *BufferPtr;
   UINTN           TransferredSize;
 
@@ -192,22 +191,20 @@ BotDataPhase (
   TransferredSize = 0;
 
   //
-  // retrieve the the max packet length of the given endpoint
+  // retrieve the the endpoint address of the given direction
   //
   if (Direction == EfiUsbDataIn) {
-    MaxPacketLen  = (PeiBotDev->BulkInEndpoint)->MaxPacketSize;
     EndpointAddr  = (PeiBotDev->BulkInEndpoint)->EndpointAddress;
   } else {
-    MaxPacketLen  = (PeiBotDev->BulkOutEndpoint)->MaxPacketSize;
     EndpointAddr  = (PeiBotDev->BulkOutEndpoint)->EndpointAddress;
   }
 
   while (Remain > 0) {
     //
-    // Using 15 packets to avoid Bitstuff error
+    // The host controller splits a bulk transfer into TRBs by itself
     //
-    if (Remain > 16 * MaxPacketLen) {
-      Increment = 16 * MaxPacketLen;
+    if (Remain > USB_BOT_MAX_TRANSFER_SIZE) {
+      Increment = USB_BOT_MAX_TRANSFER_SIZE;
     } else {
       Increment = Remain;
     }
@@ -301,7 +298,7 @@ BotStatusPhase (
 }
 
 /**
-  Send ATAPI command using BOT protocol.
+  Send ATAPI command using BOT or UAS protocol.
 
   @param  PeiServices            The pointer of EFI_PEI_SERVICES.
   @param  PeiBotDev              The instance to PEI_BOT_DEVICE.
@@ -329,10 +326,25 @@ PeiAtapiCommand (
   IN  UINT16                      TimeOutInMilliSeconds
   )
 {
-  EFI_STATUS  Status;
-  EFI_STATUS  BotDataStatus;
-  UINT8       TransferStatus;
-  UINT32      BufferSize;
+  EFI_STATUS        Status;
+  EFI_STATUS        BotDataStatus;
+  UINT8             TransferStatus;
+  UINT32            BufferSize;
+  USB_MASS_COMMAND  UasCommand;
+
+  if (PeiBotDev->IsUas) {
+    if (CommandSize > sizeof (UasCommand.Cdb)) {
+      return EFI_INVALID_PARAMETER;
+    }
+    ZeroMem (&UasCommand, sizeof (UasCommand));
+    CopyMem (UasCommand.Cdb, Command, CommandSize);
+    UasCommand.CdbLength    = CommandSize;
+    UasCommand.DataBuffer   = DataBuffer;
+    UasCommand.BufferLength = BufferLength;
+    UasCommand.Direction    = Direction;
+    Status = UasCommandList (PeiServices, PeiBotDev, &UasCommand, 1, TimeOutInMilliSeconds);
+    return EFI_ERROR (Status) ? EFI_DEVICE_ERROR : EFI_SUCCESS;
+  }
 
   BotDataStatus = EFI_SUCCESS;
   //
@@ -392,3 +404,57 @@ PeiAtapiCommand (
 
   return BotDataStatus;
 }
+
+/**
+  Send a list of ATAPI commands to the device. The UAS transport queues up to
+  QueueDepth commands on the device at once, BOT sends them one by one.
+
+  @param  PeiServices            The pointer of EFI_PEI_SERVICES.
+  @param  PeiBotDev              The instance to PEI_BOT_DEVICE.
+  @param  Commands               The commands to be sent to the device.
+  @param  CommandCount           The number of commands.
+  @param  TimeOutInMilliSeconds  Indicates the maximum time, in millisecond, which
+                                 all the commands are allowed to complete.
+
+  @retval EFI_SUCCESS            All the commands completed successfully.
+  @retval EFI_DEVICE_ERROR       A command failed.
+
+**/
+EFI_STATUS
+PeiAtapiCommandList (
+  IN  EFI_PEI_SERVICES            **PeiServices,
+  IN  PEI_BOT_DEVICE              *PeiBotDev,
+  IN  USB_MASS_COMMAND            *Commands,
+  IN  UINTN                       CommandCount,
+  IN  UINTN                       TimeOutInMilliSeconds
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+  UINTN       Count;
+
+  Status = EFI_SUCCESS;
+  for (Index = 0; Index < CommandCount; Index += Count) {
+    if (PeiBotDev->IsUas) {
+      Count  = MIN (CommandCount - Index, PeiBotDev->QueueDepth);
+      Status = UasCommandList (PeiServices, PeiBotDev, &Commands[Index], Count, TimeOutInMilliSeconds);
+    } else {
+      Count  = 1;
+      Status = PeiAtapiCommand (
+                 PeiServices,
+                 PeiBotDev,
+                 Commands[Index].Cdb,
+                 Commands[Index].CdbLength,
+                 Commands[Index].DataBuffer,
+                 Commands[Index].BufferLength,
+                 Commands[Index].Direction,
+                 (UINT16) MIN (TimeOutInMilliSeconds, MAX_UINT16)
+                 );
+    }
+    if (EFI_ERROR (Status)) {
+      return EFI_DEVICE_ERROR;
+    }
+  }
+
+  return Status;
+}
@@ -1,7 +1,7 @@
 /** @file
 BOT Transportation implementation.
 
-Copyright (c) 2006 - 2017, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -21,6 +21,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/BaseMemoryLib.h>
 
 #include <IndustryStandard/Atapi.h>
+#include <IndustryStandard/Scsi.h>
 
 #include <Library/MemoryAllocationLib.h>
 
@@ -149,9 +150,10 @@ PeiUsbReadFormattedCapacity (
   );
 
 /**
-  Execute Read(10) ATAPI command on a specific SCSI target.
+  Read blocks from a specific SCSI target.
 
-  Executes the ATAPI Read(10) command on the ATAPI target specified by PeiBotDevice.
+  Issues Read(10) commands, or Read(16) commands for blocks beyond the 32-bit
+  LBA range, each covering up to PcdUsbMaxTransferSize bytes.
 
   @param PeiServices       The pointer of EFI_PEI_SERVICES.
   @param PeiBotDevice      The pointer to PEI_BOT_DEVICE instance.
@@ -164,7 +166,7 @@ PeiUsbReadFormattedCapacity (
 
 **/
 EFI_STATUS
-PeiUsbRead10 (
+PeiUsbRead (
   IN  EFI_PEI_SERVICES  **PeiServices,
   IN  PEI_BOT_DEVICE    *PeiBotDevice,
   IN  VOID              *Buffer,
@@ -1,7 +1,7 @@
 /** @file
 Pei USB ATATPI command implementations.
 
-Copyright (c) 1999 - 2022, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 1999 - 2026, Intel Corporation. All rights reserved.<BR>
 
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -216,6 +216,68 @@ PeiUsbRequestSense (
   return EFI_SUCCESS;
 }
 
+/**
+  Sends out SCSI Read Capacity(16) Command to the specified device.
+  This command is used when the capacity does not fit in the data of the
+  Read Capacity command.
+
+  @param PeiServices    The pointer of EFI_PEI_SERVICES.
+  @param PeiBotDevice   The pointer to PEI_BOT_DEVICE instance.
+
+  @retval EFI_SUCCESS           Command executed successfully.
+  @retval EFI_DEVICE_ERROR      Some device errors happen.
+
+**/
+STATIC
+EFI_STATUS
+PeiUsbReadCapacity16 (
+  IN  EFI_PEI_SERVICES  **PeiServices,
+  IN  PEI_BOT_DEVICE    *PeiBotDevice
+  )
+{
+  EFI_STATUS                     Status;
+  UINT8                          Cdb[16];
+  EFI_SCSI_DISK_CAPACITY_DATA16  Data;
+  UINT32                         BlockSize;
+
+  ZeroMem (&Data, sizeof (EFI_SCSI_DISK_CAPACITY_DATA16));
+  ZeroMem (Cdb, sizeof (Cdb));
+
+  //
+  // Service action 0x10 of SERVICE ACTION IN(16), the allocation length is
+  // in bytes 10 ~ 13 with the MSB first.
+  //
+  Cdb[0]  = EFI_SCSI_OP_READ_CAPACITY16;
+  Cdb[1]  = 0x10;
+  Cdb[13] = (UINT8) sizeof (EFI_SCSI_DISK_CAPACITY_DATA16);
+
+  Status = PeiAtapiCommand (
+             PeiServices,
+             PeiBotDevice,
+             Cdb,
+             (UINT8) sizeof (Cdb),
+             (VOID *) &Data,
+             sizeof (EFI_SCSI_DISK_CAPACITY_DATA16),
+             EfiUsbDataIn,
+             PcdGet16 (PcdUsbCmdTimeout)
+             );
+
+  if (EFI_ERROR (Status)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  BlockSize = ((UINT32) Data.BlockSize3 << 24) | (Data.BlockSize2 << 16) | (Data.BlockSize1 << 8) | Data.BlockSize0;
+  if (BlockSize != 0) {
+    PeiBotDevice->Media.BlockSize = BlockSize;
+  }
+
+  PeiBotDevice->Media.LastBlock    = LShiftU64 (((UINT32) Data.LastLba7 << 24) | (Data.LastLba6 << 16) | (Data.LastLba5 << 8) | Data.LastLba4, 32) |
+                                     (((UINT32) Data.LastLba3 << 24) | (Data.LastLba2 << 16) | (Data.LastLba1 << 8) | Data.LastLba0);
+  PeiBotDevice->Media.MediaPresent = TRUE;
+
+  return EFI_SUCCESS;
+}
+
 /**
   Sends out ATAPI Read Capacity Packet Command to the specified device.
   This command will return the information regarding the capacity of the
@@ -238,6 +300,7 @@ PeiUsbReadCapacity (
   ATAPI_PACKET_COMMAND        Packet;
   ATAPI_READ_CAPACITY_DATA    Data;
   UINT32                      LastBlock;
+  UINT32                      BlockSize;
 
   ZeroMem (&Data, sizeof (ATAPI_READ_CAPACITY_DATA));
   ZeroMem (&Packet, sizeof (ATAPI_PACKET_COMMAND));
@@ -265,6 +328,12 @@ PeiUsbReadCapacity (
 
   if (LastBlock == 0xFFFFFFFF) {
     DEBUG ((DEBUG_VERBOSE, "The usb device LBA count is larger than 0xFFFFFFFF!\n"));
+    return PeiUsbReadCapacity16 (PeiServices, PeiBotDevice);
+  }
+
+  BlockSize = ((UINT32) Data.BlockSize3 << 24) | (Data.BlockSize2 << 16) | (Data.BlockSize1 << 8) | Data.BlockSize0;
+  if (BlockSize != 0) {
+    PeiBotDevice->Media.BlockSize = BlockSize;
   }
 
   PeiBotDevice->Media.LastBlock    = LastBlock;
@@ -345,9 +414,13 @@ PeiUsbReadFormattedCapacity (
 }
 
 /**
-  Execute Read(10) ATAPI command on a specific SCSI target.
+  Read blocks from a specific SCSI target.
 
-  Executes the ATAPI Read(10) command on the ATAPI target specified by PeiBotDevice.
+  Issues Read(10) commands, or Read(16) commands for blocks beyond the 32-bit
+  LBA range, each covering up to PcdUsbMaxTransferSize bytes. A transport
+  with a queue gets as many commands at once as it can keep in flight. When
+  transfers are bounced for DMA protection, the commands in flight share half
+  of the DMA buffer.
 
   @param PeiServices       The pointer of EFI_PEI_SERVICES.
   @param PeiBotDevice      The pointer to PEI_BOT_DEVICE instance.
@@ -360,7 +433,7 @@ PeiUsbReadFormattedCapacity (
 
 **/
 EFI_STATUS
-PeiUsbRead10 (
+PeiUsbRead (
   IN  EFI_PEI_SERVICES  **PeiServices,
   IN  PEI_BOT_DEVICE    *PeiBotDevice,
   IN  VOID              *Buffer,
@@ -368,88 +441,103 @@ PeiUsbRead10 (
   IN  UINTN             NumberOfBlocks
   )
 {
-  ATAPI_PACKET_COMMAND  Packet;
+  USB_MASS_COMMAND      Commands[UAS_MAX_QUEUE_DEPTH];
+  USB_MASS_COMMAND      *Command;
   ATAPI_READ10_CMD      *Read10Packet;
-  UINT16                MaxBlock;
-  UINT32                BlocksRemaining;
-  UINT16                SectorCount;
-  UINT32                Lba32;
+  UINT32                MaxBlock;
+  UINT32                MaxBytes;
+  UINTN                 BlocksRemaining;
+  UINTN                 QueueDepth;
+  UINTN                 Count;
+  UINT32                SectorCount;
   UINT32                BlockSize;
   UINT32                ByteCount;
   VOID                  *PtrBuffer;
   EFI_STATUS            Status;
-  UINT16                TimeOut;
+  UINTN                 TimeOut;
 
-  //
-  // prepare command packet for the Inquiry Packet Command.
-  //
-  ZeroMem (&Packet, sizeof (ATAPI_PACKET_COMMAND));
-  Read10Packet    = &Packet.Read10;
-  Lba32           = (UINT32) Lba;
   PtrBuffer       = Buffer;
 
   BlockSize       = (UINT32) PeiBotDevice->Media.BlockSize;
+  QueueDepth      = MAX (MIN (PeiBotDevice->QueueDepth, UAS_MAX_QUEUE_DEPTH), 1);
 
-  MaxBlock        = (UINT16) (65535 / BlockSize);
-  BlocksRemaining = (UINT32) NumberOfBlocks;
+  //
+  // Each command moves as much data as the bulk transfer can take, but no
+  // more blocks than the 16-bit transfer length of Read(10).
+  //
+  MaxBytes        = MIN (PcdGet32 (PcdUsbMaxTransferSize), USB_BOT_MAX_TRANSFER_SIZE);
+  if (!IoMmuIsDirectDma (NULL, 0)) {
+    //
+    // Transfers are bounced through the DMA buffer, so only use half of it
+    // for all the commands in flight.
+    //
+    MaxBytes      = MIN (MaxBytes, (PcdGet32 (PcdDmaBufferSize) >> 1) / (UINT32) QueueDepth);
+  }
+  MaxBlock        = MaxBytes / BlockSize;
+  MaxBlock        = MAX (MIN (MaxBlock, MAX_UINT16), 1);
+  BlocksRemaining = NumberOfBlocks;
 
   Status          = EFI_SUCCESS;
   while (BlocksRemaining > 0) {
 
-    if (BlocksRemaining <= MaxBlock) {
-
-      SectorCount = (UINT16)BlocksRemaining;
-
-    } else {
+    ZeroMem (Commands, sizeof (Commands));
+    TimeOut = 0;
+    for (Count = 0; (Count < QueueDepth) && (BlocksRemaining > 0); Count++) {
+      SectorCount = (UINT32) MIN (BlocksRemaining, MaxBlock);
+      ByteCount   = SectorCount * BlockSize;
+      TimeOut    += MIN (SectorCount * 2000, MAX_UINT16);
+
+      Command               = &Commands[Count];
+      Command->DataBuffer   = PtrBuffer;
+      Command->BufferLength = ByteCount;
+      Command->Direction    = EfiUsbDataIn;
+
+      if (Lba + SectorCount - 1 > MAX_UINT32) {
+        //
+        // Read(16) takes a 64-bit LBA in bytes 2 ~ 9 and a 32-bit transfer
+        // length in bytes 10 ~ 13, both with the MSB first.
+        //
+        Command->Cdb[0]    = EFI_SCSI_OP_READ16;
+        Command->CdbLength = 16;
+        WriteUnaligned64 ((UINT64 *) &Command->Cdb[2], SwapBytes64 (Lba));
+        WriteUnaligned32 ((UINT32 *) &Command->Cdb[10], SwapBytes32 (SectorCount));
+      } else {
+        //
+        // fill the Packet data structure
+        //
+        Read10Packet         = (ATAPI_READ10_CMD *) Command->Cdb;
+        Read10Packet->opcode = ATA_CMD_READ_10;
+        Command->CdbLength   = (UINT8) sizeof (ATAPI_PACKET_COMMAND);
+
+        //
+        // Lba0 ~ Lba3 specify the start logical block address of the data transfer.
+        // Lba0 is MSB, Lba3 is LSB
+        //
+        Read10Packet->Lba3  = (UINT8) (Lba & 0xff);
+        Read10Packet->Lba2  = (UINT8) (Lba >> 8);
+        Read10Packet->Lba1  = (UINT8) (Lba >> 16);
+        Read10Packet->Lba0  = (UINT8) (Lba >> 24);
+
+        //
+        // TranLen0 ~ TranLen1 specify the transfer length in block unit.
+        // TranLen0 is MSB, TranLen is LSB
+        //
+        Read10Packet->TranLen1  = (UINT8) (SectorCount & 0xff);
+        Read10Packet->TranLen0  = (UINT8) (SectorCount >> 8);
+      }
 
-      SectorCount = MaxBlock;
+      Lba            += SectorCount;
+      PtrBuffer       = (UINT8 *) PtrBuffer + ByteCount;
+      BlocksRemaining = BlocksRemaining - SectorCount;
     }
-    //
-    // fill the Packet data structure
-    //
-    Read10Packet->opcode = ATA_CMD_READ_10;
-
-    //
-    // Lba0 ~ Lba3 specify the start logical block address of the data transfer.
-    // Lba0 is MSB, Lba3 is LSB
-    //
-    Read10Packet->Lba3  = (UINT8) (Lba32 & 0xff);
-    Read10Packet->Lba2  = (UINT8) (Lba32 >> 8);
-    Read10Packet->Lba1  = (UINT8) (Lba32 >> 16);
-    Read10Packet->Lba0  = (UINT8) (Lba32 >> 24);
-
-    //
-    // TranLen0 ~ TranLen1 specify the transfer length in block unit.
-    // TranLen0 is MSB, TranLen is LSB
-    //
-    Read10Packet->TranLen1  = (UINT8) (SectorCount & 0xff);
-    Read10Packet->TranLen0  = (UINT8) (SectorCount >> 8);
-
-    ByteCount               = SectorCount * BlockSize;
-
-    TimeOut                 = (UINT16) (SectorCount * 2000);
 
     //
-    // send command packet
+    // send command packets
     //
-    Status = PeiAtapiCommand (
-               PeiServices,
-               PeiBotDevice,
-               &Packet,
-               (UINT8) sizeof (ATAPI_PACKET_COMMAND),
-               (VOID *) PtrBuffer,
-               ByteCount,
-               EfiUsbDataIn,
-               TimeOut
-               );
-
+    Status = PeiAtapiCommandList (PeiServices, PeiBotDevice, Commands, Count, TimeOut);
     if (Status != EFI_SUCCESS) {
       return Status;
     }
-
-    Lba32 += SectorCount;
-    PtrBuffer       = (UINT8 *) PtrBuffer + SectorCount * BlockSize;
-    BlocksRemaining = BlocksRemaining - SectorCount;
   }
 
   return Status;
@@ -0,0 +1,615 @@
+/** @file
+USB Attached SCSI (UAS) transport implementation.
+
+A UAS device takes command IUs on its command pipe and returns a Sense IU
+for every command on its status pipe. A SuperSpeed device moves the data and
+the status of each command on the stream of the command tag, so the host
+queues everything for a list of commands at once. A high speed device asks
+for the data phase of a command with a READ READY or WRITE READY IU on the
+status pipe instead. Only LUN 0 is supported.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "UsbBotPeim.h"
+#include "BotPeim.h"
+#include "PeiUsbLib.h"
+
+/**
+  Find the UAS pipes of the mass storage interface in the configuration
+  descriptor. The UAS setting is usually an alternate setting next to the
+  BOT one.
+
+  @param  ConfigDesc             The configuration descriptor of the device.
+  @param  InterfaceNumber        The mass storage interface.
+  @param  Uas                    The UAS device to fill the pipes in.
+  @param  MaxStreams             The streams supported by the status and data
+                                 pipes, as a power of 2. 0 if the device has
+                                 no streams.
+
+  @retval EFI_SUCCESS            The UAS pipes were found.
+  @retval EFI_NOT_FOUND          The interface has no UAS setting.
+
+**/
+STATIC
+EFI_STATUS
+UasFindPipes (
+  IN  EFI_USB_CONFIG_DESCRIPTOR   *ConfigDesc,
+  IN  UINT8                       InterfaceNumber,
+  OUT UAS_DEVICE                  *Uas,
+  OUT UINT8                       *MaxStreams
+  )
+{
+  UINT8                          *Desc;
+  UINT8                          *End;
+  EFI_USB_INTERFACE_DESCRIPTOR   *InterfaceDesc;
+  EFI_USB_ENDPOINT_DESCRIPTOR    *EndpointDesc;
+  EFI_USB_ENDPOINT_DESCRIPTOR    *Pipes[UAS_PIPE_ID_DATA_OUT + 1];
+  UINT8                          PipeStreams[UAS_PIPE_ID_DATA_OUT + 1];
+  UINT8                          Streams;
+  BOOLEAN                        InUasSetting;
+  BOOLEAN                        HasCompanion;
+  UINT8                          PipeId;
+
+  Desc          = (UINT8 *) ConfigDesc;
+  End           = Desc + ConfigDesc->TotalLength;
+  InUasSetting  = FALSE;
+  HasCompanion  = FALSE;
+  EndpointDesc  = NULL;
+  Streams       = 0;
+  ZeroMem (Pipes, sizeof (Pipes));
+  ZeroMem (PipeStreams, sizeof (PipeStreams));
+
+  while (Desc < End) {
+    if ((Desc[0] < 2) || (Desc + Desc[0] > End)) {
+      break;
+    }
+
+    switch (Desc[1]) {
+    case USB_DESC_TYPE_INTERFACE:
+      if (InUasSetting && (Pipes[UAS_PIPE_ID_COMMAND] != NULL) && (Pipes[UAS_PIPE_ID_STATUS] != NULL) &&
+          (Pipes[UAS_PIPE_ID_DATA_IN] != NULL) && (Pipes[UAS_PIPE_ID_DATA_OUT] != NULL)) {
+        End = Desc;
+        continue;
+      }
+      InterfaceDesc = (EFI_USB_INTERFACE_DESCRIPTOR *) Desc;
+      InUasSetting  = (InterfaceDesc->InterfaceNumber   == InterfaceNumber) &&
+                      (InterfaceDesc->InterfaceClass    == USB_MASS_STORE_CLASS) &&
+                      (InterfaceDesc->InterfaceSubClass == USB_MASS_STORE_SCSI) &&
+                      (InterfaceDesc->InterfaceProtocol == USB_MASS_STORE_UAS);
+      if (InUasSetting) {
+        Uas->AlternateSetting = InterfaceDesc->AlternateSetting;
+      }
+      ZeroMem (Pipes, sizeof (Pipes));
+      ZeroMem (PipeStreams, sizeof (PipeStreams));
+      HasCompanion = FALSE;
+      EndpointDesc = NULL;
+      break;
+
+    case USB_DESC_TYPE_ENDPOINT:
+      EndpointDesc = (EFI_USB_ENDPOINT_DESCRIPTOR *) Desc;
+      if ((EndpointDesc->Attributes & USB_ENDPOINT_TYPE_MASK) != USB_ENDPOINT_BULK) {
+        EndpointDesc = NULL;
+      }
+      Streams = 0;
+      break;
+
+    case UAS_DESC_TYPE_SS_COMPANION:
+      //
+      // Attributes of the companion descriptor is at offset 3
+      //
+      HasCompanion = TRUE;
+      Streams      = Desc[3] & UAS_SS_MAX_STREAMS_MASK;
+      break;
+
+    case UAS_DESC_TYPE_PIPE_USAGE:
+      PipeId = Desc[2];
+      if (InUasSetting && (EndpointDesc != NULL) && (PipeId >= UAS_PIPE_ID_COMMAND) && (PipeId <= UAS_PIPE_ID_DATA_OUT)) {
+        Pipes[PipeId]       = EndpointDesc;
+        PipeStreams[PipeId] = Streams;
+      }
+      break;
+
+    default:
+      break;
+    }
+
+    Desc += Desc[0];
+  }
+
+  if (!InUasSetting || (Pipes[UAS_PIPE_ID_COMMAND] == NULL) || (Pipes[UAS_PIPE_ID_STATUS] == NULL) ||
+      (Pipes[UAS_PIPE_ID_DATA_IN] == NULL) || (Pipes[UAS_PIPE_ID_DATA_OUT] == NULL)) {
+    return EFI_NOT_FOUND;
+  }
+
+  Uas->CommandPipe = Pipes[UAS_PIPE_ID_COMMAND];
+  Uas->StatusPipe  = Pipes[UAS_PIPE_ID_STATUS];
+  Uas->DataInPipe  = Pipes[UAS_PIPE_ID_DATA_IN];
+  Uas->DataOutPipe = Pipes[UAS_PIPE_ID_DATA_OUT];
+
+  //
+  // Only a SuperSpeed device has companion descriptors, and it must use streams
+  //
+  Uas->UseStreams = HasCompanion;
+  *MaxStreams     = MIN (PipeStreams[UAS_PIPE_ID_STATUS],
+                      MIN (PipeStreams[UAS_PIPE_ID_DATA_IN], PipeStreams[UAS_PIPE_ID_DATA_OUT]));
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Select an alternate setting of the mass storage interface.
+
+  @param  PeiServices            The pointer of EFI_PEI_SERVICES.
+  @param  PeiBotDev              The instance to PEI_BOT_DEVICE.
+  @param  AlternateSetting       The alternate setting to select.
+
+  @retval EFI_SUCCESS            The alternate setting is selected.
+  @retval Others                 The request failed.
+
+**/
+STATIC
+EFI_STATUS
+UasSetInterface (
+  IN  EFI_PEI_SERVICES            **PeiServices,
+  IN  PEI_BOT_DEVICE              *PeiBotDev,
+  IN  UINT8                       AlternateSetting
+  )
+{
+  EFI_USB_DEVICE_REQUEST  DevReq;
+  PEI_USB_IO_PPI          *UsbIoPpi;
+
+  UsbIoPpi = PeiBotDev->UsbIoPpi;
+  ZeroMem (&DevReq, sizeof (EFI_USB_DEVICE_REQUEST));
+
+  DevReq.RequestType  = USB_DEV_SET_INTERFACE_REQ_TYPE;
+  DevReq.Request      = USB_DEV_SET_INTERFACE;
+  DevReq.Value        = AlternateSetting;
+  DevReq.Index        = PeiBotDev->BotInterface->InterfaceNumber;
+
+  return UsbIoPpi->UsbControlTransfer (
+           PeiServices,
+           UsbIoPpi,
+           &DevReq,
+           EfiUsbNoData,
+           PcdGet32 (PcdUsbTransferTimeoutValue),
+           NULL,
+           0
+           );
+}
+
+/**
+  Clear the halt state of all the UAS pipes after a transport failure.
+
+  @param  PeiServices            The pointer of EFI_PEI_SERVICES.
+  @param  PeiBotDev              The instance to PEI_BOT_DEVICE.
+
+**/
+STATIC
+VOID
+UasRecoveryReset (
+  IN  EFI_PEI_SERVICES            **PeiServices,
+  IN  PEI_BOT_DEVICE              *PeiBotDev
+  )
+{
+  EFI_USB_ENDPOINT_DESCRIPTOR  *Pipes[4];
+  EFI_USB_DEVICE_REQUEST       DevReq;
+  PEI_USB_IO_PPI               *UsbIoPpi;
+  UINTN                        Index;
+
+  UsbIoPpi = PeiBotDev->UsbIoPpi;
+  Pipes[0] = PeiBotDev->Uas.CommandPipe;
+  Pipes[1] = PeiBotDev->Uas.StatusPipe;
+  Pipes[2] = PeiBotDev->Uas.DataInPipe;
+  Pipes[3] = PeiBotDev->Uas.DataOutPipe;
+
+  for (Index = 0; Index < ARRAY_SIZE (Pipes); Index++) {
+    ZeroMem (&DevReq, sizeof (EFI_USB_DEVICE_REQUEST));
+    DevReq.RequestType  = USB_DEV_CLEAR_FEATURE_REQ_TYPE_E;
+    DevReq.Request      = USB_DEV_CLEAR_FEATURE;
+    DevReq.Value        = EfiUsbEndpointHalt;
+    DevReq.Index        = Pipes[Index]->EndpointAddress;
+
+    UsbIoPpi->UsbControlTransfer (
+                PeiServices,
+                UsbIoPpi,
+                &DevReq,
+                EfiUsbNoData,
+                PcdGet32 (PcdUsbTransferTimeoutValue),
+                NULL,
+                0
+                );
+  }
+}
+
+/**
+  Fill in a bulk transfer request on a UAS pipe.
+
+  @param  Request                The request to fill in.
+  @param  Pipe                   The endpoint of the pipe.
+  @param  StreamId               The stream of the transfer, 0 without streams.
+  @param  Data                   The data buffer.
+  @param  DataLength             The size of the data buffer.
+
+**/
+STATIC
+VOID
+UasFillRequest (
+  OUT PEI_USB2_HC_BULK_REQUEST    *Request,
+  IN  EFI_USB_ENDPOINT_DESCRIPTOR *Pipe,
+  IN  UINT16                      StreamId,
+  IN  VOID                        *Data,
+  IN  UINTN                       DataLength
+  )
+{
+  ZeroMem (Request, sizeof (PEI_USB2_HC_BULK_REQUEST));
+  Request->EndPointAddress     = Pipe->EndpointAddress;
+  Request->StreamId            = StreamId;
+  Request->MaximumPacketLength = Pipe->MaxPacketSize;
+  Request->Data                = Data;
+  Request->DataLength          = DataLength;
+}
+
+/**
+  Run a list of commands on the streams of a SuperSpeed device. The status
+  and data transfers of all the commands are queued on their streams before
+  the command IUs are sent, so the device completes them in any order.
+
+  @param  PeiServices            The pointer of EFI_PEI_SERVICES.
+  @param  PeiBotDev              The instance to PEI_BOT_DEVICE.
+  @param  Commands               The commands with their IUs built.
+  @param  CommandCount           The number of commands.
+  @param  TimeOutInMilliSeconds  The time allowed for all the commands.
+
+  @retval EFI_SUCCESS            Every command returned its Sense IU.
+  @retval Others                 The transport failed.
+
+**/
+STATIC
+EFI_STATUS
+UasRunOnStreams (
+  IN  EFI_PEI_SERVICES            **PeiServices,
+  IN  PEI_BOT_DEVICE              *PeiBotDev,
+  IN  USB_MASS_COMMAND            *Commands,
+  IN  UINTN                       CommandCount,
+  IN  UINTN                       TimeOutInMilliSeconds
+  )
+{
+  PEI_USB2_HC_BULK_REQUEST  Requests[UAS_MAX_QUEUE_DEPTH * 3];
+  UINTN                     DataRequest[UAS_MAX_QUEUE_DEPTH];
+  UAS_DEVICE                *Uas;
+  UAS_SENSE_IU              *SenseIu;
+  UINTN                     Count;
+  UINTN                     Index;
+  UINT16                    Tag;
+  EFI_STATUS                Status;
+
+  Uas   = &PeiBotDev->Uas;
+  Count = 0;
+  for (Index = 0; Index < CommandCount; Index++) {
+    Tag = (UINT16) (Index + 1);
+    UasFillRequest (&Requests[Count++], Uas->StatusPipe, Tag, &Uas->SenseIu[Index], sizeof (UAS_SENSE_IU));
+
+    DataRequest[Index] = MAX_UINTN;
+    if ((Commands[Index].Direction != EfiUsbNoData) && (Commands[Index].BufferLength != 0)) {
+      DataRequest[Index] = Count;
+      UasFillRequest (
+        &Requests[Count],
+        (Commands[Index].Direction == EfiUsbDataIn) ? Uas->DataInPipe : Uas->DataOutPipe,
+        Tag,
+        Commands[Index].DataBuffer,
+        Commands[Index].BufferLength
+        );
+      //
+      // A failed command may complete with its Sense IU and no data
+      //
+      Requests[Count++].Optional = TRUE;
+    }
+  }
+
+  for (Index = 0; Index < CommandCount; Index++) {
+    UasFillRequest (&Requests[Count++], Uas->CommandPipe, 0, &Uas->CommandIu[Index], sizeof (UAS_COMMAND_IU));
+  }
+
+  Status = PeiBotDev->UsbIoPpi->UsbBulkTransferList (
+                                  PeiServices,
+                                  PeiBotDev->UsbIoPpi,
+                                  Requests,
+                                  Count,
+                                  TimeOutInMilliSeconds
+                                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  for (Index = 0; Index < CommandCount; Index++) {
+    SenseIu = &Uas->SenseIu[Index];
+    if ((SenseIu->IuId != UAS_IU_ID_SENSE) || (SwapBytes16 (SenseIu->Tag) != Index + 1)) {
+      return EFI_DEVICE_ERROR;
+    }
+    if ((SenseIu->Status == UAS_SCSI_STATUS_GOOD) && (DataRequest[Index] != MAX_UINTN) &&
+        (Requests[DataRequest[Index]].TransferResult != EFI_USB_NOERROR)) {
+      return EFI_DEVICE_ERROR;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Run a list of commands on a device without streams. The command IUs are
+  sent at once, then the status pipe tells which command moves its data or
+  completes next.
+
+  @param  PeiServices            The pointer of EFI_PEI_SERVICES.
+  @param  PeiBotDev              The instance to PEI_BOT_DEVICE.
+  @param  Commands               The commands with their IUs built.
+  @param  CommandCount           The number of commands.
+  @param  TimeOutInMilliSeconds  The time allowed for each transfer.
+
+  @retval EFI_SUCCESS            Every command returned its Sense IU.
+  @retval Others                 The transport failed.
+
+**/
+STATIC
+EFI_STATUS
+UasRunOnPipes (
+  IN  EFI_PEI_SERVICES            **PeiServices,
+  IN  PEI_BOT_DEVICE              *PeiBotDev,
+  IN  USB_MASS_COMMAND            *Commands,
+  IN  UINTN                       CommandCount,
+  IN  UINTN                       TimeOutInMilliSeconds
+  )
+{
+  PEI_USB2_HC_BULK_REQUEST  Requests[UAS_MAX_QUEUE_DEPTH];
+  BOOLEAN                   Completed[UAS_MAX_QUEUE_DEPTH];
+  UAS_SENSE_IU              StatusIu;
+  UAS_DEVICE                *Uas;
+  PEI_USB_IO_PPI            *UsbIoPpi;
+  UINTN                     Pending;
+  UINTN                     Index;
+  UINT16                    Tag;
+  EFI_STATUS                Status;
+
+  Uas      = &PeiBotDev->Uas;
+  UsbIoPpi = PeiBotDev->UsbIoPpi;
+  for (Index = 0; Index < CommandCount; Index++) {
+    UasFillRequest (&Requests[Index], Uas->CommandPipe, 0, &Uas->CommandIu[Index], sizeof (UAS_COMMAND_IU));
+    Completed[Index] = FALSE;
+  }
+
+  Status = UsbIoPpi->UsbBulkTransferList (PeiServices, UsbIoPpi, Requests, CommandCount, TimeOutInMilliSeconds);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Pending = CommandCount;
+  while (Pending > 0) {
+    UasFillRequest (&Requests[0], Uas->StatusPipe, 0, &StatusIu, sizeof (UAS_SENSE_IU));
+    Status = UsbIoPpi->UsbBulkTransferList (PeiServices, UsbIoPpi, Requests, 1, TimeOutInMilliSeconds);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Tag = SwapBytes16 (StatusIu.Tag);
+    if ((Tag == 0) || (Tag > CommandCount) || Completed[Tag - 1]) {
+      return EFI_DEVICE_ERROR;
+    }
+    Index = Tag - 1;
+
+    switch (StatusIu.IuId) {
+    case UAS_IU_ID_READ_READY:
+    case UAS_IU_ID_WRITE_READY:
+      if (Commands[Index].Direction != ((StatusIu.IuId == UAS_IU_ID_READ_READY) ? EfiUsbDataIn : EfiUsbDataOut)) {
+        return EFI_DEVICE_ERROR;
+      }
+      UasFillRequest (
+        &Requests[0],
+        (Commands[Index].Direction == EfiUsbDataIn) ? Uas->DataInPipe : Uas->DataOutPipe,
+        0,
+        Commands[Index].DataBuffer,
+        Commands[Index].BufferLength
+        );
+      Status = UsbIoPpi->UsbBulkTransferList (PeiServices, UsbIoPpi, Requests, 1, TimeOutInMilliSeconds);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+      break;
+
+    case UAS_IU_ID_SENSE:
+      CopyMem (&Uas->SenseIu[Index], &StatusIu, sizeof (UAS_SENSE_IU));
+      Completed[Index] = TRUE;
+      Pending--;
+      break;
+
+    default:
+      return EFI_DEVICE_ERROR;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Run a list of commands on a UAS device. Command i uses tag i + 1.
+
+  @param  PeiServices            The pointer of EFI_PEI_SERVICES.
+  @param  PeiBotDev              The instance to PEI_BOT_DEVICE.
+  @param  Commands               The commands to be sent to the device.
+  @param  CommandCount           The number of commands, up to UAS_MAX_QUEUE_DEPTH.
+  @param  TimeOutInMilliSeconds  Indicates the maximum time, in millisecond, which
+                                 all the commands are allowed to complete.
+
+  @retval EFI_SUCCESS            All the commands completed with GOOD status.
+  @retval EFI_DEVICE_ERROR       A command completed with another status.
+  @retval EFI_NO_RESPONSE        The UAS transport failed.
+
+**/
+EFI_STATUS
+UasCommandList (
+  IN  EFI_PEI_SERVICES            **PeiServices,
+  IN  PEI_BOT_DEVICE              *PeiBotDev,
+  IN  USB_MASS_COMMAND            *Commands,
+  IN  UINTN                       CommandCount,
+  IN  UINTN                       TimeOutInMilliSeconds
+  )
+{
+  UAS_DEVICE      *Uas;
+  UAS_COMMAND_IU  *CommandIu;
+  UAS_SENSE_IU    *SenseIu;
+  UINTN           Index;
+  UINT32          Length;
+  EFI_STATUS      Status;
+
+  if ((CommandCount == 0) || (CommandCount > UAS_MAX_QUEUE_DEPTH)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Uas = &PeiBotDev->Uas;
+
+  //
+  // The device returns the sense data of a failed command in its Sense IU,
+  // and REQUEST SENSE gets it from there.
+  //
+  if ((CommandCount == 1) && (Commands[0].Cdb[0] == ATA_CMD_REQUEST_SENSE) &&
+      (Commands[0].Direction == EfiUsbDataIn) && (Uas->SenseLength != 0)) {
+    Length = MIN (Commands[0].BufferLength, Uas->SenseLength);
+    ZeroMem (Commands[0].DataBuffer, Commands[0].BufferLength);
+    CopyMem (Commands[0].DataBuffer, Uas->SenseData, Length);
+    Uas->SenseLength = 0;
+    return EFI_SUCCESS;
+  }
+  Uas->SenseLength = 0;
+
+  for (Index = 0; Index < CommandCount; Index++) {
+    if (Commands[Index].CdbLength > UAS_MAX_CDB_LENGTH) {
+      return EFI_INVALID_PARAMETER;
+    }
+    CommandIu = &Uas->CommandIu[Index];
+    ZeroMem (CommandIu, sizeof (UAS_COMMAND_IU));
+    CommandIu->IuId = UAS_IU_ID_COMMAND;
+    CommandIu->Tag  = SwapBytes16 ((UINT16) (Index + 1));
+    CopyMem (CommandIu->Cdb, Commands[Index].Cdb, Commands[Index].CdbLength);
+    ZeroMem (&Uas->SenseIu[Index], sizeof (UAS_SENSE_IU));
+  }
+
+  if (Uas->UseStreams) {
+    Status = UasRunOnStreams (PeiServices, PeiBotDev, Commands, CommandCount, TimeOutInMilliSeconds);
+  } else {
+    Status = UasRunOnPipes (PeiServices, PeiBotDev, Commands, CommandCount, TimeOutInMilliSeconds);
+  }
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_VERBOSE, "UAS transport failed - %r\n", Status));
+    UasRecoveryReset (PeiServices, PeiBotDev);
+    return EFI_NO_RESPONSE;
+  }
+
+  Status = EFI_SUCCESS;
+  for (Index = 0; Index < CommandCount; Index++) {
+    SenseIu = &Uas->SenseIu[Index];
+    if (SenseIu->Status == UAS_SCSI_STATUS_GOOD) {
+      continue;
+    }
+    if (SenseIu->Status == UAS_SCSI_STATUS_CHECK) {
+      Uas->SenseLength = MIN (SwapBytes16 (SenseIu->SenseLength), UAS_MAX_SENSE_LENGTH);
+      CopyMem (Uas->SenseData, SenseIu->SenseData, Uas->SenseLength);
+    }
+    Status = EFI_DEVICE_ERROR;
+  }
+
+  return Status;
+}
+
+/**
+  Look for a UAS setting of the mass storage interface, and switch the device
+  to the UAS transport if it works.
+
+  @param  PeiServices            The pointer of EFI_PEI_SERVICES.
+  @param  PeiBotDev              The instance to PEI_BOT_DEVICE.
+
+  @retval EFI_SUCCESS            The device uses the UAS transport.
+  @retval EFI_NOT_FOUND          The interface has no usable UAS setting.
+  @retval EFI_DEVICE_ERROR       The device did not respond to UAS commands.
+
+**/
+EFI_STATUS
+UasInitDevice (
+  IN  EFI_PEI_SERVICES            **PeiServices,
+  IN  PEI_BOT_DEVICE              *PeiBotDev
+  )
+{
+  PEI_USB_IO_PPI             *UsbIoPpi;
+  EFI_USB_CONFIG_DESCRIPTOR  *ConfigDesc;
+  UAS_DEVICE                 *Uas;
+  USB_MASS_COMMAND           Commands[UAS_MAX_QUEUE_DEPTH];
+  UINT8                      MaxStreams;
+  UINTN                      QueueDepth;
+  UINTN                      Index;
+  EFI_STATUS                 Status;
+
+  UsbIoPpi = PeiBotDev->UsbIoPpi;
+  Uas      = &PeiBotDev->Uas;
+  if ((UsbIoPpi->UsbGetConfigDescriptor == NULL) || (UsbIoPpi->UsbBulkTransferList == NULL)) {
+    return EFI_NOT_FOUND;
+  }
+
+  Status = UsbIoPpi->UsbGetConfigDescriptor (PeiServices, UsbIoPpi, &ConfigDesc);
+  if (EFI_ERROR (Status)) {
+    return EFI_NOT_FOUND;
+  }
+
+  Status = UasFindPipes (ConfigDesc, PeiBotDev->BotInterface->InterfaceNumber, Uas, &MaxStreams);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  QueueDepth = UAS_MAX_QUEUE_DEPTH;
+  if (Uas->UseStreams) {
+    if (MaxStreams == 0) {
+      return EFI_NOT_FOUND;
+    }
+    QueueDepth = MIN (QueueDepth, (UINTN) 1 << MaxStreams);
+  }
+
+  if (Uas->AlternateSetting != PeiBotDev->BotInterface->AlternateSetting) {
+    Status = UasSetInterface (PeiServices, PeiBotDev, Uas->AlternateSetting);
+    if (EFI_ERROR (Status)) {
+      return EFI_DEVICE_ERROR;
+    }
+  }
+
+  //
+  // Probe the transport with TEST UNIT READY on every tag. The host controller
+  // may support fewer streams than the device, so retry with fewer tags. A
+  // command failing with CHECK CONDITION still proves the transport works.
+  //
+  ZeroMem (Commands, sizeof (Commands));
+  for (Index = 0; Index < UAS_MAX_QUEUE_DEPTH; Index++) {
+    Commands[Index].Cdb[0]    = ATA_CMD_TEST_UNIT_READY;
+    Commands[Index].CdbLength = 6;
+    Commands[Index].Direction = EfiUsbNoData;
+  }
+
+  for (; QueueDepth > 0; QueueDepth /= 2) {
+    Status = UasCommandList (PeiServices, PeiBotDev, Commands, QueueDepth, PcdGet16 (PcdUsbCmdTimeout));
+    if (Status != EFI_NO_RESPONSE) {
+      break;
+    }
+  }
+
+  if (QueueDepth == 0) {
+    if (Uas->AlternateSetting != PeiBotDev->BotInterface->AlternateSetting) {
+      UasSetInterface (PeiServices, PeiBotDev, PeiBotDev->BotInterface->AlternateSetting);
+    }
+    return EFI_DEVICE_ERROR;
+  }
+
+  PeiBotDev->IsUas      = TRUE;
+  PeiBotDev->QueueDepth = QueueDepth;
+  DEBUG ((DEBUG_INFO, "USB mass storage uses UAS, queue depth %d%a\n", QueueDepth, Uas->UseStreams ? " on streams" : ""));
+
+  return EFI_SUCCESS;
+}
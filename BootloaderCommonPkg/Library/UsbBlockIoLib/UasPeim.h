@@ -0,0 +1,113 @@
+/** @file
+USB Attached SCSI (UAS) transport definition.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _PEI_UAS_PEIM_H_
+#define _PEI_UAS_PEIM_H_
+
+#include <IndustryStandard/Usb.h>
+
+//
+// Mass storage interface of a UAS device, see UAS spec section 5.3.3
+//
+#define USB_MASS_STORE_CLASS        0x08
+#define USB_MASS_STORE_SCSI         0x06
+#define USB_MASS_STORE_BOT          0x50
+#define USB_MASS_STORE_UAS          0x62
+
+//
+// Pipe Usage descriptor following each UAS endpoint descriptor
+//
+#define UAS_DESC_TYPE_PIPE_USAGE    0x24
+#define UAS_PIPE_ID_COMMAND         1
+#define UAS_PIPE_ID_STATUS          2
+#define UAS_PIPE_ID_DATA_IN         3
+#define UAS_PIPE_ID_DATA_OUT        4
+
+//
+// SuperSpeed Endpoint Companion descriptor, the number of streams of a bulk
+// endpoint is 2 ^ (Attributes & UAS_SS_MAX_STREAMS_MASK)
+//
+#define UAS_DESC_TYPE_SS_COMPANION  0x30
+#define UAS_SS_MAX_STREAMS_MASK     0x1F
+
+//
+// Information Unit IDs, see UAS spec section 6.2
+//
+#define UAS_IU_ID_COMMAND           0x01
+#define UAS_IU_ID_SENSE             0x03
+#define UAS_IU_ID_RESPONSE          0x04
+#define UAS_IU_ID_READ_READY        0x06
+#define UAS_IU_ID_WRITE_READY       0x07
+
+//
+// Commands queued on the device at the same time. The command tags are
+// 1 ~ UAS_MAX_QUEUE_DEPTH, and on a device with streams every command moves
+// its data and status on the stream of its tag.
+//
+#define UAS_MAX_QUEUE_DEPTH         4
+
+//
+// SCSI status of a Sense IU
+//
+#define UAS_SCSI_STATUS_GOOD        0x00
+#define UAS_SCSI_STATUS_CHECK       0x02
+
+#define UAS_MAX_CDB_LENGTH          16
+#define UAS_MAX_SENSE_LENGTH        252
+
+#pragma pack(1)
+typedef struct {
+  UINT8   IuId;
+  UINT8   Reserved1;
+  UINT16  Tag;              ///< Big endian
+  UINT8   TaskAttribute;
+  UINT8   Reserved2;
+  UINT8   AddCdbLength;     ///< Bits 7:2, in dwords
+  UINT8   Reserved3;
+  UINT8   Lun[8];
+  UINT8   Cdb[UAS_MAX_CDB_LENGTH];
+} UAS_COMMAND_IU;
+
+//
+// Sense IU. READ READY, WRITE READY and RESPONSE IUs arrive on the status
+// pipe as well, and share the IU ID and tag fields with it.
+//
+typedef struct {
+  UINT8   IuId;
+  UINT8   Reserved1;
+  UINT16  Tag;              ///< Big endian
+  UINT16  StatusQualifier;
+  UINT8   Status;
+  UINT8   Reserved2[7];
+  UINT16  SenseLength;      ///< Big endian
+  UINT8   SenseData[UAS_MAX_SENSE_LENGTH];
+} UAS_SENSE_IU;
+#pragma pack()
+
+//
+// UAS part of a USB mass storage device
+//
+typedef struct {
+  EFI_USB_ENDPOINT_DESCRIPTOR     *CommandPipe;
+  EFI_USB_ENDPOINT_DESCRIPTOR     *StatusPipe;
+  EFI_USB_ENDPOINT_DESCRIPTOR     *DataInPipe;
+  EFI_USB_ENDPOINT_DESCRIPTOR     *DataOutPipe;
+  UINT8                           AlternateSetting;
+  BOOLEAN                         UseStreams;
+  //
+  // Sense data of the last command that completed with CHECK CONDITION,
+  // returned to the next REQUEST SENSE command
+  //
+  UINT16                          SenseLength;
+  UINT8                           SenseData[UAS_MAX_SENSE_LENGTH];
+  UAS_COMMAND_IU                  CommandIu[UAS_MAX_QUEUE_DEPTH];
+  UAS_SENSE_IU                    SenseIu[UAS_MAX_QUEUE_DEPTH];
+} UAS_DEVICE;
+
+#endif
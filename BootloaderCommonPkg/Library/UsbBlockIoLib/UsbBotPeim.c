@@ -1,6 +1,6 @@
 /** @file
 
-Copyright (c) 2006 - 2020, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -113,9 +113,10 @@ InitUsbBot (
     return Status;
   }
   //
-  // Check if it is the BOT device we support
+  // Check if it is the BOT or UAS device we support
   //
-  if ((InterfaceDesc->InterfaceClass != 0x08) || (InterfaceDesc->InterfaceProtocol != 0x50)) {
+  if ((InterfaceDesc->InterfaceClass != USB_MASS_STORE_CLASS) ||
+      ((InterfaceDesc->InterfaceProtocol != USB_MASS_STORE_BOT) && (InterfaceDesc->InterfaceProtocol != USB_MASS_STORE_UAS))) {
 
     return EFI_NOT_FOUND;
   }
@@ -131,11 +132,13 @@ InitUsbBot (
   }
 
   PeiBotDevice                  = (PEI_BOT_DEVICE *) ((UINTN) AllocateAddress);
+  ZeroMem (PeiBotDevice, sizeof (PEI_BOT_DEVICE));
 
   PeiBotDevice->Signature       = PEI_BOT_DEVICE_SIGNATURE;
   PeiBotDevice->UsbIoPpi        = UsbIoPpi;
   PeiBotDevice->AllocateAddress = (UINTN) AllocateAddress;
   PeiBotDevice->BotInterface    = InterfaceDesc;
+  PeiBotDevice->QueueDepth      = 1;
 
   //
   // Default value
@@ -144,24 +147,34 @@ InitUsbBot (
   PeiBotDevice->Media.BlockSize   = 0x200;
 
   //
-  // Check its Bulk-in/Bulk-out endpoint
+  // Prefer the UAS transport, which queues several commands on the device
   //
-  for (Index = 0; Index < 2; Index++) {
-    Status = UsbIoPpi->UsbGetEndpointDescriptor (
-               PeiServices,
-               UsbIoPpi,
-               Index,
-               &EndpointDesc
-               );
-
-    if (EFI_ERROR (Status)) {
-      return Status;
+  Status = UasInitDevice (PeiServices, PeiBotDevice);
+  if (EFI_ERROR (Status)) {
+    if (InterfaceDesc->InterfaceProtocol != USB_MASS_STORE_BOT) {
+      return EFI_NOT_FOUND;
     }
 
-    if ((EndpointDesc->EndpointAddress & 0x80) != 0) {
-      PeiBotDevice->BulkInEndpoint = EndpointDesc;
-    } else {
-      PeiBotDevice->BulkOutEndpoint = EndpointDesc;
+    //
+    // Check its Bulk-in/Bulk-out endpoint
+    //
+    for (Index = 0; Index < 2; Index++) {
+      Status = UsbIoPpi->UsbGetEndpointDescriptor (
+                 PeiServices,
+                 UsbIoPpi,
+                 Index,
+                 &EndpointDesc
+                 );
+
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      if ((EndpointDesc->EndpointAddress & 0x80) != 0) {
+        PeiBotDevice->BulkInEndpoint = EndpointDesc;
+      } else {
+        PeiBotDevice->BulkOutEndpoint = EndpointDesc;
+      }
     }
   }
 
@@ -384,102 +397,73 @@ BotReadBlocks (
   NumberOfBlocks = BufferSize / (PeiBotDev->Media.BlockSize);
 
   if (Status == EFI_SUCCESS) {
-
-    Status = PeiUsbTestUnitReady (
-               PeiServices,
-               PeiBotDev
-               );
-    if (Status == EFI_SUCCESS) {
-      Status = PeiUsbRead10 (
-                 PeiServices,
-                 PeiBotDev,
-                 Buffer,
-                 StartLBA,
-                 1
-                 );
-    }
-  } else {
     //
-    // To generate sense data for DetectMedia use.
+    // Test Unit Ready is only needed to recover from an error, so that the
+    // whole request goes to the device as large read commands right away.
     //
-    PeiUsbTestUnitReady (
-      PeiServices,
-      PeiBotDev
-      );
-  }
-
-  if (EFI_ERROR (Status)) {
-    //
-    // if any error encountered, detect what happened to the media and
-    // update the media info accordingly.
-    //
-    Status = PeiBotDetectMedia (
-               PeiServices,
-               PeiBotDev
-               );
-    if (Status != EFI_SUCCESS) {
-      return EFI_DEVICE_ERROR;
-    }
-
-    NumberOfBlocks = BufferSize / PeiBotDev->Media.BlockSize;
-
-    if (! (PeiBotDev->Media.MediaPresent)) {
-      return EFI_NO_MEDIA;
-    }
-
-    if (BufferSize % (PeiBotDev->Media.BlockSize) != 0) {
-      return EFI_BAD_BUFFER_SIZE;
-    }
-
-    if (StartLBA > PeiBotDev->Media.LastBlock) {
-      return EFI_INVALID_PARAMETER;
-    }
-
-    if ((StartLBA + NumberOfBlocks - 1) > PeiBotDev->Media.LastBlock) {
-      return EFI_INVALID_PARAMETER;
-    }
-
-    Status = PeiUsbRead10 (
+    Status = PeiUsbRead (
                PeiServices,
                PeiBotDev,
                Buffer,
                StartLBA,
                NumberOfBlocks
                );
+    if (Status == EFI_SUCCESS) {
+      return EFI_SUCCESS;
+    }
+  }
 
-    switch (Status) {
+  //
+  // if any error encountered, detect what happened to the media and
+  // update the media info accordingly. Test Unit Ready generates the
+  // sense data for DetectMedia use.
+  //
+  PeiUsbTestUnitReady (
+    PeiServices,
+    PeiBotDev
+    );
 
-    case EFI_SUCCESS:
-      return EFI_SUCCESS;
+  Status = PeiBotDetectMedia (
+             PeiServices,
+             PeiBotDev
+             );
+  if (Status != EFI_SUCCESS) {
+    return EFI_DEVICE_ERROR;
+  }
 
-    default:
-      return EFI_DEVICE_ERROR;
-    }
-  } else {
-    StartLBA += 1;
-    NumberOfBlocks -= 1;
-    Buffer = (UINT8 *) Buffer + PeiBotDev->Media.BlockSize;
+  NumberOfBlocks = BufferSize / PeiBotDev->Media.BlockSize;
 
-    if (NumberOfBlocks == 0) {
-      return EFI_SUCCESS;
-    }
+  if (! (PeiBotDev->Media.MediaPresent)) {
+    return EFI_NO_MEDIA;
+  }
 
-    Status = PeiUsbRead10 (
-               PeiServices,
-               PeiBotDev,
-               Buffer,
-               StartLBA,
-               NumberOfBlocks
-               );
-    switch (Status) {
+  if (BufferSize % (PeiBotDev->Media.BlockSize) != 0) {
+    return EFI_BAD_BUFFER_SIZE;
+  }
 
-    case EFI_SUCCESS:
-      return EFI_SUCCESS;
+  if (StartLBA > PeiBotDev->Media.LastBlock) {
+    return EFI_INVALID_PARAMETER;
+  }
 
-    default:
-      return EFI_DEVICE_ERROR;
+  if ((StartLBA + NumberOfBlocks - 1) > PeiBotDev->Media.LastBlock) {
+    return EFI_INVALID_PARAMETER;
+  }
 
-    }
+  Status = PeiUsbRead (
+             PeiServices,
+             PeiBotDev,
+             Buffer,
+             StartLBA,
+             NumberOfBlocks
+             );
+
+  switch (Status) {
+
+  case EFI_SUCCESS:
+    return EFI_SUCCESS;
+
+  default:
+    return EFI_DEVICE_ERROR;
   }
 }
 
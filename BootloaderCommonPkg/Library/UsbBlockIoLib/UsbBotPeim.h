@@ -1,7 +1,7 @@
 /** @file
 Usb BOT Peim definition.
 
-Copyright (c) 2006 - 2015, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -16,13 +16,22 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Ppi/UsbHostController.h>
 #include <Ppi/BlockIo.h>
 #include <Library/DebugLib.h>
+#include <Library/IoMmuLib.h>
 #include <Library/UsbBlockIoLib.h>
 
 #include <IndustryStandard/Usb.h>
 #include <IndustryStandard/Atapi.h>
 
+#include "UasPeim.h"
+
 #define PEI_FAT_MAX_USB_IO_PPI  127
 
+//
+// Largest data transfer of a single BOT command. XhciLib queues a bulk
+// transfer as TRBs of at most 64 KB on a 256 entry transfer ring.
+//
+#define USB_BOT_MAX_TRANSFER_SIZE  SIZE_8MB
+
 /**
   Gets the count of block I/O devices that one specific block driver detects.
 
@@ -191,13 +200,31 @@ typedef struct {
   UINTN                           AllocateAddress;
   UINTN                           DeviceType;
   ATAPI_REQUEST_SENSE_DATA        *SensePtr;
+  //
+  // Commands are sent through the UAS transport instead of BOT when IsUas is
+  // set. QueueDepth is the number of commands the transport runs at once.
+  //
+  BOOLEAN                         IsUas;
+  UINTN                           QueueDepth;
+  UAS_DEVICE                      Uas;
 } PEI_BOT_DEVICE;
 
+//
+// A command of a command list
+//
+typedef struct {
+  UINT8                           Cdb[UAS_MAX_CDB_LENGTH];
+  UINT8                           CdbLength;
+  VOID                            *DataBuffer;
+  UINT32                          BufferLength;
+  EFI_USB_DATA_DIRECTION          Direction;
+} USB_MASS_COMMAND;
+
 #define PEI_BOT_DEVICE_FROM_THIS(a) CR (a, PEI_BOT_DEVICE, BlkIoPpi, PEI_BOT_DEVICE_SIGNATURE)
 #define PEI_BOT_DEVICE2_FROM_THIS(a) CR (a, PEI_BOT_DEVICE, BlkIo2Ppi, PEI_BOT_DEVICE_SIGNATURE)
 
 /**
-  Send ATAPI command using BOT protocol.
+  Send ATAPI command using BOT or UAS protocol.
 
   @param  PeiServices            The pointer of EFI_PEI_SERVICES.
   @param  PeiBotDev              The instance to PEI_BOT_DEVICE.
@@ -225,6 +252,72 @@ PeiAtapiCommand (
   IN  UINT16                      TimeOutInMilliSeconds
   );
 
+/**
+  Send a list of ATAPI commands to the device. The UAS transport queues up to
+  QueueDepth commands on the device at once, BOT sends them one by one.
+
+  @param  PeiServices            The pointer of EFI_PEI_SERVICES.
+  @param  PeiBotDev              The instance to PEI_BOT_DEVICE.
+  @param  Commands               The commands to be sent to the device.
+  @param  CommandCount           The number of commands.
+  @param  TimeOutInMilliSeconds  Indicates the maximum time, in millisecond, which
+                                 all the commands are allowed to complete.
+
+  @retval EFI_SUCCESS            All the commands completed successfully.
+  @retval EFI_DEVICE_ERROR       A command failed.
+
+**/
+EFI_STATUS
+PeiAtapiCommandList (
+  IN  EFI_PEI_SERVICES            **PeiServices,
+  IN  PEI_BOT_DEVICE              *PeiBotDev,
+  IN  USB_MASS_COMMAND            *Commands,
+  IN  UINTN                       CommandCount,
+  IN  UINTN                       TimeOutInMilliSeconds
+  );
+
+/**
+  Look for a UAS setting of the mass storage interface, and switch the device
+  to the UAS transport if it works.
+
+  @param  PeiServices            The pointer of EFI_PEI_SERVICES.
+  @param  PeiBotDev              The instance to PEI_BOT_DEVICE.
+
+  @retval EFI_SUCCESS            The device uses the UAS transport.
+  @retval EFI_NOT_FOUND          The interface has no usable UAS setting.
+  @retval EFI_DEVICE_ERROR       The device did not respond to UAS commands.
+
+**/
+EFI_STATUS
+UasInitDevice (
+  IN  EFI_PEI_SERVICES            **PeiServices,
+  IN  PEI_BOT_DEVICE              *PeiBotDev
+  );
+
+/**
+  Run a list of commands on a UAS device. Command i uses tag i + 1.
+
+  @param  PeiServices            The pointer of EFI_PEI_SERVICES.
+  @param  PeiBotDev              The instance to PEI_BOT_DEVICE.
+  @param  Commands               The commands to be sent to the device.
+  @param  CommandCount           The number of commands, up to UAS_MAX_QUEUE_DEPTH.
+  @param  TimeOutInMilliSeconds  Indicates the maximum time, in millisecond, which
+                                 all the commands are allowed to complete.
+
+  @retval EFI_SUCCESS            All the commands completed with GOOD status.
+  @retval EFI_DEVICE_ERROR       A command completed with another status.
+  @retval EFI_NO_RESPONSE        The UAS transport failed.
+
+**/
+EFI_STATUS
+UasCommandList (
+  IN  EFI_PEI_SERVICES            **PeiServices,
+  IN  PEI_BOT_DEVICE              *PeiBotDev,
+  IN  USB_MASS_COMMAND            *Commands,
+  IN  UINTN                       CommandCount,
+  IN  UINTN                       TimeOutInMilliSeconds
+  );
+
 /**
   Initialize the usb bot device and installation of callback function.
 
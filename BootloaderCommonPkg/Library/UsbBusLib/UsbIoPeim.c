@@ -1,7 +1,7 @@
 /** @file
   The module is used to implement Usb Io PPI interfaces.
 
-  Copyright (c) 2006 - 2014, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -371,3 +371,80 @@ PeiUsbPortReset (
 
   return Status;
 }
+
+/**
+  Get the active usb configuration descriptor, followed by all its interface,
+  endpoint and class specific descriptors.
+
+  @param  PeiServices          General-purpose services that are available to every PEIM.
+  @param  This                 Indicates the PEI_USB_IO_PPI instance.
+  @param  ConfigDescriptor     Request configuration descriptor.
+
+  @retval EFI_SUCCESS          Usb configuration descriptor is obtained successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+PeiUsbGetConfigDescriptor (
+  IN  EFI_PEI_SERVICES               **PeiServices,
+  IN  PEI_USB_IO_PPI                 *This,
+  OUT EFI_USB_CONFIG_DESCRIPTOR      **ConfigDescriptor
+  )
+{
+  PEI_USB_DEVICE  *PeiUsbDev;
+  PeiUsbDev          = PEI_USB_DEVICE_FROM_THIS (This);
+  *ConfigDescriptor  = PeiUsbDev->ConfigDesc;
+  return EFI_SUCCESS;
+}
+
+/**
+  Submits a list of bulk transfers to bulk endpoints of the usb device at once.
+
+  Unlike PeiUsbBulkTransfer, the endpoints are not looked up in the current interface,
+  so endpoints of an alternate interface setting can be used.
+
+  @param  PeiServices            The pointer of EFI_PEI_SERVICES.
+  @param  This                   The pointer of PEI_USB_IO_PPI.
+  @param  Requests               The bulk transfers to submit.
+  @param  RequestCount           The number of bulk transfers in Requests.
+  @param  Timeout                Indicates the maximum time, in millisecond, which the
+                                 transfers are allowed to complete.
+
+  @retval EFI_SUCCESS            All the required bulk transfers were completed successfully.
+  @retval EFI_UNSUPPORTED        The host controller does not support a list of bulk transfers.
+  @retval Others                 A bulk transfer failed.
+
+**/
+EFI_STATUS
+EFIAPI
+PeiUsbBulkTransferList (
+  IN     EFI_PEI_SERVICES          **PeiServices,
+  IN     PEI_USB_IO_PPI            *This,
+  IN OUT PEI_USB2_HC_BULK_REQUEST  *Requests,
+  IN     UINTN                     RequestCount,
+  IN     UINTN                     Timeout
+  )
+{
+  EFI_STATUS                  Status;
+  PEI_USB_DEVICE              *PeiUsbDev;
+
+  PeiUsbDev = PEI_USB_DEVICE_FROM_THIS (This);
+
+  if ((PeiUsbDev->Usb2HcPpi == NULL) || (PeiUsbDev->Usb2HcPpi->BulkTransferList == NULL)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = PeiUsbDev->Usb2HcPpi->BulkTransferList (
+             PeiServices,
+             PeiUsbDev->Usb2HcPpi,
+             PeiUsbDev->DeviceAddress,
+             PeiUsbDev->DeviceSpeed,
+             Requests,
+             RequestCount,
+             Timeout,
+             & (PeiUsbDev->Translator)
+             );
+
+  DEBUG ((DEBUG_VERBOSE, "PeiUsbBulkTransferList: %r\n", Status));
+  return Status;
+}
@@ -1,7 +1,7 @@
 /** @file
 The module to produce Usb Bus PPI.
 
-Copyright (c) 2006 - 2017, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -21,7 +21,9 @@ PEI_USB_IO_PPI         mUsbIoPpi = {
   PeiUsbBulkTransfer,
   PeiUsbGetInterfaceDescriptor,
   PeiUsbGetEndpointDescriptor,
-  PeiUsbPortReset
+  PeiUsbPortReset,
+  PeiUsbGetConfigDescriptor,
+  PeiUsbBulkTransferList
 };
 
 EFI_PEI_PPI_DESCRIPTOR mUsbIoPpiList = {
@@ -1,7 +1,7 @@
 /** @file
   Usb Peim definition.
 
-  Copyright (c) 2006 - 2017, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -234,6 +234,50 @@ PeiUsbPortReset (
   IN PEI_USB_IO_PPI      *This
   );
 
+/**
+  Get the active usb configuration descriptor, followed by all its interface,
+  endpoint and class specific descriptors.
+
+  @param  PeiServices          General-purpose services that are available to every PEIM.
+  @param  This                 Indicates the PEI_USB_IO_PPI instance.
+  @param  ConfigDescriptor     Request configuration descriptor.
+
+  @retval EFI_SUCCESS          Usb configuration descriptor is obtained successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+PeiUsbGetConfigDescriptor (
+  IN  EFI_PEI_SERVICES               **PeiServices,
+  IN  PEI_USB_IO_PPI                 *This,
+  OUT EFI_USB_CONFIG_DESCRIPTOR      **ConfigDescriptor
+  );
+
+/**
+  Submits a list of bulk transfers to bulk endpoints of the usb device at once.
+
+  @param  PeiServices            The pointer of EFI_PEI_SERVICES.
+  @param  This                   The pointer of PEI_USB_IO_PPI.
+  @param  Requests               The bulk transfers to submit.
+  @param  RequestCount           The number of bulk transfers in Requests.
+  @param  Timeout                Indicates the maximum time, in millisecond, which the
+                                 transfers are allowed to complete.
+
+  @retval EFI_SUCCESS            All the required bulk transfers were completed successfully.
+  @retval EFI_UNSUPPORTED        The host controller does not support a list of bulk transfers.
+  @retval Others                 A bulk transfer failed.
+
+**/
+EFI_STATUS
+EFIAPI
+PeiUsbBulkTransferList (
+  IN     EFI_PEI_SERVICES          **PeiServices,
+  IN     PEI_USB_IO_PPI            *This,
+  IN OUT PEI_USB2_HC_BULK_REQUEST  *Requests,
+  IN     UINTN                     RequestCount,
+  IN     UINTN                     Timeout
+  );
+
 /**
   Send reset signal over the given root hub port.
 
@@ -2,7 +2,7 @@
 PEIM to produce gPeiUsb2HostControllerPpiGuid based on gPeiUsbControllerPpiGuid
 which is used to enable recovery function from USB Drivers.
 
-Copyright (c) 2014 - 2023, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2014 - 2026, Intel Corporation. All rights reserved.<BR>
 
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -605,6 +605,7 @@ XhcPeiControlTransfer (
           Xhc,
           DeviceAddress,
           Endpoint,
+          0,
           DeviceSpeed,
           MaximumPacketLength,
           XHC_CTRL_TRANSFER,
@@ -746,6 +747,25 @@ XhcPeiControlTransfer (
         } else {
           Status = XhcPeiSetConfigCmd64 (Xhc, SlotId, DeviceSpeed, Xhc->UsbDevContext[SlotId].ConfDesc[Index]);
         }
+        if (!EFI_ERROR (Status)) {
+          Xhc->UsbDevContext[SlotId].ActiveConfiguration = (UINT8) Request->Value;
+          ZeroMem (Xhc->UsbDevContext[SlotId].ActiveAlternateSetting, sizeof (Xhc->UsbDevContext[SlotId].ActiveAlternateSetting));
+        }
+        break;
+      }
+    }
+  } else if ((Request->Request     == USB_REQ_SET_INTERFACE) &&
+             (Request->RequestType == USB_REQUEST_TYPE (EfiUsbNoData, USB_REQ_TYPE_STANDARD, USB_TARGET_INTERFACE))) {
+    //
+    // Hook Set_Interface request from UsbBus as we need configure the endpoints of the alternate setting.
+    //
+    for (Index = 0; Index < Xhc->UsbDevContext[SlotId].DevDesc.NumConfigurations; Index++) {
+      if (Xhc->UsbDevContext[SlotId].ConfDesc[Index]->ConfigurationValue == Xhc->UsbDevContext[SlotId].ActiveConfiguration) {
+        if (Xhc->HcCParams.Data.Csz == 0) {
+          Status = XhcPeiSetInterface (Xhc, SlotId, DeviceSpeed, Xhc->UsbDevContext[SlotId].ConfDesc[Index], Request);
+        } else {
+          Status = XhcPeiSetInterface64 (Xhc, SlotId, DeviceSpeed, Xhc->UsbDevContext[SlotId].ConfDesc[Index], Request);
+        }
         break;
       }
     }
@@ -947,6 +967,7 @@ XhcPeiBulkTransfer (
           Xhc,
           DeviceAddress,
           EndPointAddress,
+          0,
           DeviceSpeed,
           MaximumPacketLength,
           IsInterruptTransfer ? XHC_INT_TRANSFER_SYNC : XHC_BULK_TRANSFER,
@@ -1002,6 +1023,181 @@ ON_EXIT:
   return Status;
 }
 
+/**
+  Submits a list of bulk transfers to bulk endpoints of a USB device at once.
+
+  @param  PeiServices           The pointer of EFI_PEI_SERVICES.
+  @param  This                  The pointer of PEI_USB2_HOST_CONTROLLER_PPI.
+  @param  DeviceAddress         Target device address.
+  @param  DeviceSpeed           Device speed.
+  @param  Requests              The bulk transfers to submit.
+  @param  RequestCount          The number of bulk transfers in Requests.
+  @param  TimeOut               Indicates the maximum time, in millisecond, which the
+                                transfers are allowed to complete.
+                                If Timeout is 0, then the caller must wait for the function
+                                to be completed until EFI_SUCCESS or EFI_DEVICE_ERROR is returned.
+  @param  Translator            A pointr to the transaction translator data.
+
+  @retval EFI_SUCCESS           All the required transfers were completed successfully.
+  @retval EFI_OUT_OF_RESOURCES  The transfers failed due to lack of resource.
+  @retval EFI_INVALID_PARAMETER Parameters are invalid.
+  @retval EFI_TIMEOUT           A transfer failed due to timeout.
+  @retval EFI_DEVICE_ERROR      A transfer failed due to host controller error.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcPeiBulkTransferList (
+  IN EFI_PEI_SERVICES                       **PeiServices,
+  IN PEI_USB2_HOST_CONTROLLER_PPI           *This,
+  IN UINT8                                  DeviceAddress,
+  IN UINT8                                  DeviceSpeed,
+  IN OUT PEI_USB2_HC_BULK_REQUEST           *Requests,
+  IN UINTN                                  RequestCount,
+  IN UINTN                                  TimeOut,
+  IN EFI_USB2_HC_TRANSACTION_TRANSLATOR     *Translator
+  )
+{
+  PEI_XHC_DEV                   *Xhc;
+  URB                           **UrbList;
+  URB                           *Urb;
+  UINTN                         UrbCount;
+  UINT8                         SlotId;
+  UINTN                         Index;
+  UINTN                         Index2;
+  UINTN                         MaximumPacketLength;
+  EFI_STATUS                    Status;
+  EFI_STATUS                    RecoveryStatus;
+
+  //
+  // Validate the parameters
+  //
+  if ((Requests == NULL) || (RequestCount == 0) || (DeviceSpeed == EFI_USB_SPEED_LOW)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  for (Index = 0; Index < RequestCount; Index++) {
+    MaximumPacketLength = Requests[Index].MaximumPacketLength;
+    if ((Requests[Index].Data == NULL) || (Requests[Index].DataLength == 0)) {
+      return EFI_INVALID_PARAMETER;
+    }
+    if (((DeviceSpeed == EFI_USB_SPEED_FULL) && (MaximumPacketLength > 64)) ||
+        ((DeviceSpeed == EFI_USB_SPEED_HIGH) && (MaximumPacketLength > 512)) ||
+        ((DeviceSpeed == EFI_USB_SPEED_SUPER) && (MaximumPacketLength > 1024))) {
+      return EFI_INVALID_PARAMETER;
+    }
+    Requests[Index].TransferResult = EFI_USB_ERR_NOTEXECUTE;
+  }
+
+  Xhc = PEI_RECOVERY_USB_XHC_DEV_FROM_THIS (This);
+
+  if (XhcPeiIsHalt (Xhc) || XhcPeiIsSysError (Xhc)) {
+    DEBUG ((DEBUG_ERROR, "XhcPeiBulkTransferList: HC is halted or has system error\n"));
+    return EFI_DEVICE_ERROR;
+  }
+
+  //
+  // Check if the device is still enabled before every transaction.
+  //
+  SlotId = XhcPeiBusDevAddrToSlotId (Xhc, DeviceAddress);
+  if (SlotId == 0) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  UrbList = AllocateZeroPool (sizeof (URB *) * RequestCount);
+  if (UrbList == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Queue all the transfers on their transfer rings before starting any of them.
+  //
+  Status = EFI_SUCCESS;
+  for (UrbCount = 0; UrbCount < RequestCount; UrbCount++) {
+    Urb = XhcPeiCreateUrb (
+            Xhc,
+            DeviceAddress,
+            Requests[UrbCount].EndPointAddress,
+            Requests[UrbCount].StreamId,
+            DeviceSpeed,
+            Requests[UrbCount].MaximumPacketLength,
+            XHC_BULK_TRANSFER,
+            NULL,
+            Requests[UrbCount].Data,
+            Requests[UrbCount].DataLength,
+            NULL,
+            NULL
+            );
+    if (Urb == NULL) {
+      DEBUG ((DEBUG_ERROR, "XhcPeiBulkTransferList: failed to create URB %d\n", UrbCount));
+      Status = EFI_OUT_OF_RESOURCES;
+      break;
+    }
+    Urb->Optional      = Requests[UrbCount].Optional;
+    UrbList[UrbCount]  = Urb;
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = XhcPeiExecTransferList (Xhc, UrbList, UrbCount, TimeOut);
+  }
+
+  //
+  // Recover the halted endpoints first, as a halted endpoint can not be stopped.
+  //
+  for (Index = 0; Index < UrbCount; Index++) {
+    Urb = UrbList[Index];
+    if ((Urb->Result & (EFI_USB_ERR_STALL | EFI_USB_ERR_BABBLE)) != 0) {
+      RecoveryStatus = XhcPeiRecoverHaltedEndpoint (Xhc, Urb);
+      if (EFI_ERROR (RecoveryStatus)) {
+        DEBUG ((DEBUG_ERROR, "XhcPeiBulkTransferList: XhcPeiRecoverHaltedEndpoint failed\n"));
+      }
+    }
+  }
+
+  //
+  // Then abort the unfinished transfers by dequeueing of their TDs. Moving the
+  // dequeue pointer of a transfer ring drops all the TDs queued on it, so each
+  // ring is handled only once.
+  //
+  for (Index = 0; Index < UrbCount; Index++) {
+    Urb = UrbList[Index];
+    if (Urb->Finished) {
+      continue;
+    }
+    for (Index2 = 0; Index2 < UrbCount; Index2++) {
+      if ((Index2 != Index) && (UrbList[Index2]->Ring == Urb->Ring)) {
+        if (((Index2 < Index) && !UrbList[Index2]->Finished) ||
+            ((UrbList[Index2]->Result & (EFI_USB_ERR_STALL | EFI_USB_ERR_BABBLE)) != 0)) {
+          break;
+        }
+      }
+    }
+    if (Index2 == UrbCount) {
+      RecoveryStatus = XhcPeiDequeueTrbFromEndpoint (Xhc, Urb);
+      if (EFI_ERROR (RecoveryStatus)) {
+        DEBUG ((DEBUG_ERROR, "XhcPeiBulkTransferList: XhcPeiDequeueTrbFromEndpoint failed\n"));
+      }
+    }
+  }
+
+  for (Index = 0; Index < RequestCount; Index++) {
+    if (Index < UrbCount) {
+      Requests[Index].TransferResult = UrbList[Index]->Result;
+      Requests[Index].DataLength     = UrbList[Index]->Completed;
+      XhcPeiFreeUrb (Xhc, UrbList[Index]);
+    } else {
+      Requests[Index].DataLength     = 0;
+    }
+  }
+  FreePool (UrbList);
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "XhcPeiBulkTransferList: error - %r\n", Status));
+  }
+
+  return Status;
+}
+
 /**
   Retrieves the number of root hub ports.
 
@@ -1431,6 +1627,10 @@ XhcPeiFreeDevContext (
           FreePool (UsbDevContext->EndpointTransferRing[Index2]);
           UsbDevContext->EndpointTransferRing[Index2] = NULL;
         }
+        if (UsbDevContext->StreamTransferRing[Index2] != NULL) {
+          FreePool (UsbDevContext->StreamTransferRing[Index2]);
+          UsbDevContext->StreamTransferRing[Index2] = NULL;
+        }
       }
     }
   }
@@ -1557,6 +1757,7 @@ UsbInitCtrl (
   XhcDev->Usb2HostControllerPpi.GetRootHubPortStatus      = XhcPeiGetRootHubPortStatus;
   XhcDev->Usb2HostControllerPpi.SetRootHubPortFeature     = XhcPeiSetRootHubPortFeature;
   XhcDev->Usb2HostControllerPpi.ClearRootHubPortFeature   = XhcPeiClearRootHubPortFeature;
+  XhcDev->Usb2HostControllerPpi.BulkTransferList          = XhcPeiBulkTransferList;
 
   if (UsbHostHandle != NULL) {
     *UsbHostHandle = (VOID *)&XhcDev->Usb2HostControllerPpi;
@@ -1,7 +1,7 @@
 /** @file
 Private Header file for Usb Host Controller PEIM
 
-Copyright (c) 2014 - 2021, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2014 - 2026, Intel Corporation. All rights reserved.<BR>
 
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -38,6 +38,17 @@ typedef struct _USB_DEV_CONTEXT USB_DEV_CONTEXT;
 #define ERST_NUMBER                 0x01
 #define EVENT_RING_TRB_NUMBER       0x200
 
+//
+// Number of entries of the Primary Stream Context Array of a bulk endpoint
+// with streams. Stream ID 0 is reserved, so this allows up to 7 streams.
+//
+#define XHC_STREAM_ARRAY_SIZE       8
+
+//
+// Maximum number of interfaces whose alternate setting is tracked per device.
+//
+#define XHC_MAX_INTERFACE           16
+
 #define XHC_1_MICROSECOND           1
 #define XHC_1_MILLISECOND           (1000 * XHC_1_MICROSECOND)
 #define XHC_1_SECOND                (1000 * XHC_1_MILLISECOND)
@@ -74,6 +85,25 @@ typedef struct _USB_DEV_CONTEXT USB_DEV_CONTEXT;
 
 #define USB_DESC_TYPE_HUB              0x29
 #define USB_DESC_TYPE_HUB_SUPER_SPEED  0x2a
+#define USB_DESC_TYPE_SS_ENDPOINT_COMPANION  0x30
+
+//
+// MaxStreams field of the bmAttributes of a bulk endpoint companion descriptor
+//
+#define USB_SS_ENDPOINT_MAX_STREAMS_MASK     0x1F
+
+#pragma pack(1)
+//
+// SuperSpeed Endpoint Companion Descriptor, USB 3.0 spec section 9.6.7
+//
+typedef struct {
+  UINT8           Length;
+  UINT8           DescriptorType;
+  UINT8           MaxBurst;
+  UINT8           Attributes;
+  UINT16          BytesPerInterval;
+} USB_SS_ENDPOINT_COMPANION_DESCRIPTOR;
+#pragma pack()
 
 //
 // The RequestType in EFI_USB_DEVICE_REQUEST is composed of
@@ -126,6 +156,18 @@ struct _USB_DEV_CONTEXT {
   //
   VOID                              *EndpointTransferRing[31];
   //
+  // The Primary Stream Context Array of every bulk endpoint with streams.
+  //
+  VOID                              *StreamContextArray[31];
+  //
+  // The transfer rings of every bulk endpoint with streams, indexed by stream id.
+  //
+  VOID                              *StreamTransferRing[31];
+  //
+  // The number of usable streams of every bulk endpoint, 0 if streams are not used.
+  //
+  UINT16                            StreamNumber[31];
+  //
   // The device descriptor which is stored to support XHCI's Evaluate_Context cmd.
   //
   EFI_USB_DEVICE_DESCRIPTOR         DevDesc;
@@ -137,6 +179,14 @@ struct _USB_DEV_CONTEXT {
   // These information is used to support XHCI's Config_Endpoint cmd.
   //
   EFI_USB_CONFIG_DESCRIPTOR         **ConfDesc;
+  //
+  // The configuration value set through Set_Config standard usb request.
+  //
+  UINT8                             ActiveConfiguration;
+  //
+  // The alternate setting of every interface of the active configuration.
+  //
+  UINT8                             ActiveAlternateSetting[XHC_MAX_INTERFACE];
 };
 
 #define USB_XHC_DEV_SIGNATURE       SIGNATURE_32 ('x', 'h', 'c', 'i')
@@ -2,7 +2,7 @@
 PEIM to produce gPeiUsb2HostControllerPpiGuid based on gPeiUsbControllerPpiGuid
 which is used to enable recovery function from USB Drivers.
 
-Copyright (c) 2014 - 2022, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2014 - 2026, Intel Corporation. All rights reserved.<BR>
 
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -114,6 +114,7 @@ ON_EXIT:
   @param  Xhc       The XHCI device
   @param  BusAddr   The logical device address assigned by UsbBus driver
   @param  EpAddr    Endpoint addrress
+  @param  StreamId  The stream id of a bulk endpoint with streams, 0 if none
   @param  DevSpeed  The device speed
   @param  MaxPacket The max packet length of the endpoint
   @param  Type      The transaction type
@@ -131,6 +132,7 @@ XhcPeiCreateUrb (
   IN PEI_XHC_DEV                        *Xhc,
   IN UINT8                              BusAddr,
   IN UINT8                              EpAddr,
+  IN UINT16                             StreamId,
   IN UINT8                              DevSpeed,
   IN UINTN                              MaxPacket,
   IN UINTN                              Type,
@@ -160,6 +162,7 @@ XhcPeiCreateUrb (
   Ep->MaxPacket = MaxPacket;
   Ep->Type      = Type;
 
+  Urb->StreamId = StreamId;
   Urb->Request  = Request;
   Urb->Data     = Data;
   Urb->DataLen  = DataLen;
@@ -239,7 +242,20 @@ XhcPeiCreateTransferTrb (
   Urb->Result    = EFI_USB_NOERROR;
 
   Dci       = XhcPeiEndpointToDci (Urb->Ep.EpAddr, (UINT8)(Urb->Ep.Direction));
-  EPRing    = (TRANSFER_RING *) (UINTN) Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1];
+  if (Urb->StreamId != 0) {
+    //
+    // Each stream of a bulk endpoint has its own transfer ring
+    //
+    if (Urb->StreamId > Xhc->UsbDevContext[SlotId].StreamNumber[Dci-1]) {
+      return EFI_INVALID_PARAMETER;
+    }
+    EPRing  = (TRANSFER_RING *) Xhc->UsbDevContext[SlotId].StreamTransferRing[Dci-1] + Urb->StreamId;
+  } else {
+    EPRing  = (TRANSFER_RING *) (UINTN) Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1];
+  }
+  if (EPRing == NULL) {
+    return EFI_UNSUPPORTED;
+  }
   Urb->Ring = EPRing;
   OutputContext = Xhc->UsbDevContext[SlotId].OutputContext;
   if (Xhc->HcCParams.Data.Csz == 0) {
@@ -248,6 +264,15 @@ XhcPeiCreateTransferTrb (
     EPType  = (UINT8) ((DEVICE_CONTEXT_64 *)OutputContext)->EP[Dci-1].EPType;
   }
 
+  //
+  // A bulk transfer takes one TRB per 64 KB of data plus one for a buffer
+  // not aligned on 64 KB, all of which must fit in the transfer ring.
+  //
+  if ((Urb->Ep.Type == XHC_BULK_TRANSFER) && ((Urb->DataLen >> 16) + 2 >= EPRing->TrbNumber)) {
+    DEBUG ((DEBUG_ERROR, "XhcPeiCreateTransferTrb: bulk transfer of 0x%x bytes is too large\n", Urb->DataLen));
+    return EFI_INVALID_PARAMETER;
+  }
+
   //
   // No need to remap.
   //
@@ -365,15 +390,17 @@ XhcPeiCreateTransferTrb (
 
     case ED_BULK_OUT:
     case ED_BULK_IN:
+      //
+      // The data buffer of a TRB must not cross a 64 KB boundary
+      //
       TotalLen = 0;
       Len      = 0;
       TrbNum   = 0;
       TrbStart = (TRB *) (UINTN) EPRing->RingEnqueue;
       while (TotalLen < Urb->DataLen) {
-        if ((TotalLen + 0x10000) >= Urb->DataLen) {
+        Len = 0x10000 - (((UINTN) Urb->DataPhy + TotalLen) & 0xFFFF);
+        if (Len > Urb->DataLen - TotalLen) {
           Len = Urb->DataLen - TotalLen;
-        } else {
-          Len = 0x10000;
         }
         TrbStart = (TRB *)(UINTN)EPRing->RingEnqueue;
         TrbStart->TrbNormal.TRBPtrLo  = XHC_LOW_32BIT((UINT8 *) Urb->DataPhy + TotalLen);
@@ -495,7 +522,7 @@ XhcPeiRecoverHaltedEndpoint (
   //
   // 3) Ring the doorbell to transit from stop to active
   //
-  XhcPeiRingDoorBell (Xhc, SlotId, Dci);
+  XhcPeiRingStreamDoorBell (Xhc, SlotId, Dci, Urb->StreamId);
 
 Done:
   return Status;
@@ -554,7 +581,7 @@ XhcPeiDequeueTrbFromEndpoint (
   //
   // 3) Ring the doorbell to transit from stop to active
   //
-  XhcPeiRingDoorBell (Xhc, SlotId, Dci);
+  XhcPeiRingStreamDoorBell (Xhc, SlotId, Dci, Urb->StreamId);
 
 Done:
   return Status;
@@ -579,39 +606,47 @@ XhcPeiIsTransferRingTrb (
   TRB_TEMPLATE  *CheckedTrb;
   UINTN         Index;
 
-  CheckedTrb = Urb->Ring->RingSeg0;
-
-  ASSERT (Urb->Ring->TrbNumber == CMD_RING_TRB_NUMBER || Urb->Ring->TrbNumber == TR_RING_TRB_NUMBER);
-
-  for (Index = 0; Index < Urb->Ring->TrbNumber; Index++) {
+  //
+  // Only the TRBs of the URB itself are checked, so that the events of several
+  // URBs queued on the same transfer ring can be told apart.
+  //
+  CheckedTrb = Urb->TrbStart;
+  for (Index = 0; Index < Urb->TrbNum; Index++) {
     if (Trb == CheckedTrb) {
       return TRUE;
     }
     CheckedTrb++;
+    //
+    // The TRBs of the URB wrap around to the ring head at the link TRB
+    //
+    if (CheckedTrb->Type == TRB_TYPE_LINK) {
+      CheckedTrb = Urb->Ring->RingSeg0;
+    }
   }
 
   return FALSE;
 }
 
 /**
-  Check the URB's execution result and update the URB's
-  result accordingly.
+  Check the execution result of a list of URBs and update the URBs'
+  results accordingly.
 
   @param  Xhc               The XHCI device.
-  @param  Urb               The URB to check result.
-
-  @return Whether the result of URB transfer is finialized.
+  @param  UrbList           The URBs to check result.
+  @param  UrbCount          The number of URBs in the list.
 
 **/
-BOOLEAN
-XhcPeiCheckUrbResult (
+VOID
+XhcPeiCheckUrbListResult (
   IN PEI_XHC_DEV            *Xhc,
-  IN URB                    *Urb
+  IN URB                    **UrbList,
+  IN UINTN                  UrbCount
   )
 {
   EVT_TRB_TRANSFER          *EvtTrb;
   TRB_TEMPLATE              *TRBPtr;
   UINTN                     Index;
+  UINTN                     UrbIndex;
   UINT8                     TRBType;
   EFI_STATUS                Status;
   URB                       *CheckedUrb;
@@ -620,18 +655,27 @@ XhcPeiCheckUrbResult (
   UINT32                    Low;
   EFI_PHYSICAL_ADDRESS      PhyAddr;
 
-  ASSERT ((Xhc != NULL) && (Urb != NULL));
+  ASSERT ((Xhc != NULL) && (UrbList != NULL));
 
   Status = EFI_SUCCESS;
 
-  if (Urb->Finished) {
+  for (UrbIndex = 0; UrbIndex < UrbCount; UrbIndex++) {
+    if (!UrbList[UrbIndex]->Finished) {
+      break;
+    }
+  }
+  if (UrbIndex == UrbCount) {
     goto EXIT;
   }
 
   EvtTrb = NULL;
 
   if (XhcPeiIsHalt (Xhc) || XhcPeiIsSysError (Xhc)) {
-    Urb->Result |= EFI_USB_ERR_SYSTEM;
+    for (UrbIndex = 0; UrbIndex < UrbCount; UrbIndex++) {
+      if (!UrbList[UrbIndex]->Finished) {
+        UrbList[UrbIndex]->Result |= EFI_USB_ERR_SYSTEM;
+      }
+    }
     goto EXIT;
   }
 
@@ -667,9 +711,14 @@ XhcPeiCheckUrbResult (
     // This way is used to avoid that those completed async transfer events don't get
     // handled in time and are flushed by newer coming events.
     //
-    if (XhcPeiIsTransferRingTrb (TRBPtr, Urb)) {
-      CheckedUrb = Urb;
-    } else {
+    CheckedUrb = NULL;
+    for (UrbIndex = 0; UrbIndex < UrbCount; UrbIndex++) {
+      if (!UrbList[UrbIndex]->Finished && XhcPeiIsTransferRingTrb (TRBPtr, UrbList[UrbIndex])) {
+        CheckedUrb = UrbList[UrbIndex];
+        break;
+      }
+    }
+    if (CheckedUrb == NULL) {
       continue;
     }
 
@@ -678,25 +727,25 @@ XhcPeiCheckUrbResult (
         CheckedUrb->Result  |= EFI_USB_ERR_STALL;
         CheckedUrb->Finished = TRUE;
         DEBUG ((DEBUG_ERROR, "XhcPeiCheckUrbResult: STALL_ERROR! Completecode = %x\n", EvtTrb->Completecode));
-        goto EXIT;
+        continue;
 
       case TRB_COMPLETION_BABBLE_ERROR:
         CheckedUrb->Result  |= EFI_USB_ERR_BABBLE;
         CheckedUrb->Finished = TRUE;
         DEBUG ((DEBUG_ERROR, "XhcPeiCheckUrbResult: BABBLE_ERROR! Completecode = %x\n", EvtTrb->Completecode));
-        goto EXIT;
+        continue;
 
       case TRB_COMPLETION_DATA_BUFFER_ERROR:
         CheckedUrb->Result  |= EFI_USB_ERR_BUFFER;
         CheckedUrb->Finished = TRUE;
         DEBUG ((DEBUG_ERROR, "XhcPeiCheckUrbResult: ERR_BUFFER! Completecode = %x\n", EvtTrb->Completecode));
-        goto EXIT;
+        continue;
 
       case TRB_COMPLETION_USB_TRANSACTION_ERROR:
         CheckedUrb->Result  |= EFI_USB_ERR_TIMEOUT;
         CheckedUrb->Finished = TRUE;
         DEBUG ((DEBUG_ERROR, "XhcPeiCheckUrbResult: TRANSACTION_ERROR! Completecode = %x\n", EvtTrb->Completecode));
-        goto EXIT;
+        continue;
 
       case TRB_COMPLETION_SHORT_PACKET:
       case TRB_COMPLETION_SUCCESS:
@@ -717,7 +766,7 @@ XhcPeiCheckUrbResult (
         DEBUG ((DEBUG_ERROR, "XhcPeiCheckUrbResult: Transfer Default Error Occur! Completecode = 0x%x!\n", EvtTrb->Completecode));
         CheckedUrb->Result  |= EFI_USB_ERR_TIMEOUT;
         CheckedUrb->Finished = TRUE;
-        goto EXIT;
+        continue;
     }
 
     //
@@ -759,6 +808,25 @@ EXIT:
     XhcPeiWriteRuntimeReg (Xhc, XHC_ERDP_OFFSET, XHC_LOW_32BIT (PhyAddr) | BIT3);
     XhcPeiWriteRuntimeReg (Xhc, XHC_ERDP_OFFSET + 4, XHC_HIGH_32BIT (PhyAddr));
   }
+}
+
+/**
+  Check the URB's execution result and update the URB's
+  result accordingly.
+
+  @param  Xhc               The XHCI device.
+  @param  Urb               The URB to check result.
+
+  @return Whether the result of URB transfer is finialized.
+
+**/
+BOOLEAN
+XhcPeiCheckUrbResult (
+  IN PEI_XHC_DEV            *Xhc,
+  IN URB                    *Urb
+  )
+{
+  XhcPeiCheckUrbListResult (Xhc, &Urb, 1);
 
   return Urb->Finished;
 }
@@ -830,6 +898,99 @@ XhcPeiExecTransfer (
   return Status;
 }
 
+/**
+  Execute a list of transfers by polling the URBs. This is a synchronous operation.
+
+  The URBs are already queued on their transfer rings, so the door bells of all
+  of them are rung first and the device works on them in parallel. The waiting
+  ends when all the URBs that are not optional are finished, or when any URB fails.
+
+  @param  Xhc               The XHCI device.
+  @param  UrbList           The URBs to execute.
+  @param  UrbCount          The number of URBs in the list.
+  @param  Timeout           The time to wait before abort, in millisecond.
+
+  @return EFI_DEVICE_ERROR  A transfer failed due to transfer error.
+  @return EFI_TIMEOUT       A transfer failed due to time out.
+  @return EFI_SUCCESS       All the required transfers finished OK.
+
+**/
+EFI_STATUS
+XhcPeiExecTransferList (
+  IN PEI_XHC_DEV            *Xhc,
+  IN URB                    **UrbList,
+  IN UINTN                  UrbCount,
+  IN UINTN                  Timeout
+  )
+{
+  EFI_STATUS    Status;
+  UINT8         SlotId;
+  UINT8         Dci;
+  UINTN         Index;
+  URB           *Urb;
+  BOOLEAN       Finished;
+  UINT64        EndTimeStamp;
+
+  for (Index = 0; Index < UrbCount; Index++) {
+    Urb    = UrbList[Index];
+    SlotId = XhcPeiBusDevAddrToSlotId (Xhc, Urb->Ep.BusAddr);
+    if (SlotId == 0) {
+      return EFI_DEVICE_ERROR;
+    }
+    Dci = XhcPeiEndpointToDci (Urb->Ep.EpAddr, (UINT8)(Urb->Ep.Direction));
+    XhcPeiRingStreamDoorBell (Xhc, SlotId, Dci, Urb->StreamId);
+  }
+
+  if (Timeout == 0) {
+    EndTimeStamp = MAX_UINT64;
+  } else {
+    EndTimeStamp = ReadTimeStamp() + MicroSecondToTimeStampTick (Timeout * XHC_1_MILLISECOND);
+  }
+
+  Finished = FALSE;
+  while (ReadTimeStamp() < EndTimeStamp) {
+    XhcPeiCheckUrbListResult (Xhc, UrbList, UrbCount);
+    Finished = TRUE;
+    for (Index = 0; Index < UrbCount; Index++) {
+      Urb = UrbList[Index];
+      if (Urb->Finished && (Urb->Result != EFI_USB_NOERROR)) {
+        Finished = TRUE;
+        break;
+      }
+      if (!Urb->Finished && !Urb->Optional) {
+        Finished = FALSE;
+      }
+    }
+    if (Finished) {
+      break;
+    }
+    MicroSecondDelay (XHC_1_MICROSECOND);
+  }
+
+  //
+  // The URBs left unfinished are either optional ones or ones cancelled by
+  // the failure of another URB, unless the waiting timed out.
+  //
+  Status = EFI_SUCCESS;
+  for (Index = 0; Index < UrbCount; Index++) {
+    Urb = UrbList[Index];
+    if (!Urb->Finished) {
+      if (!Finished && !Urb->Optional) {
+        Urb->Result = EFI_USB_ERR_TIMEOUT;
+        if (Status == EFI_SUCCESS) {
+          Status = EFI_TIMEOUT;
+        }
+      } else {
+        Urb->Result = EFI_USB_ERR_NOTEXECUTE;
+      }
+    } else if (Urb->Result != EFI_USB_NOERROR) {
+      Status = EFI_DEVICE_ERROR;
+    }
+  }
+
+  return Status;
+}
+
 /**
   Monitor the port status change. Enable/Disable device slot if there is a device attached/detached.
 
@@ -1031,6 +1192,33 @@ XhcPeiRingDoorBell (
   }
 }
 
+/**
+  Ring the door bell of a stream of an endpoint to notify XHCI there is a transaction to be executed.
+
+  @param  Xhc           The XHCI device.
+  @param  SlotId        The slot id of the target device.
+  @param  Dci           The device context index of the target endpoint.
+  @param  StreamId      The stream id of the target endpoint, 0 if the endpoint has no streams.
+
+**/
+VOID
+XhcPeiRingStreamDoorBell (
+  IN PEI_XHC_DEV        *Xhc,
+  IN UINT8              SlotId,
+  IN UINT8              Dci,
+  IN UINT16             StreamId
+  )
+{
+  if ((SlotId == 0) || (StreamId == 0)) {
+    XhcPeiRingDoorBell (Xhc, SlotId, Dci);
+  } else {
+    //
+    // 5.6 Doorbell Registers, the DB Stream ID field is in bits 31:16
+    //
+    XhcPeiWriteDoorBellReg (Xhc, SlotId * sizeof (UINT32), Dci | ((UINT32) StreamId << 16));
+  }
+}
+
 /**
   Assign and initialize the device slot for a new device.
 
@@ -1473,7 +1661,6 @@ XhcPeiDisableSlotCmd (
   TRB_TEMPLATE          *EvtTrb;
   CMD_TRB_DISABLE_SLOT  CmdTrbDisSlot;
   UINT8                 Index;
-  VOID                  *RingSeg;
 
   //
   // Disable the device slots occupied by these devices on its downstream ports.
@@ -1522,14 +1709,7 @@ XhcPeiDisableSlotCmd (
   // Free the slot related data structure
   //
   for (Index = 0; Index < 31; Index++) {
-    if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index] != NULL) {
-      RingSeg = ((TRANSFER_RING *) (UINTN) Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index])->RingSeg0;
-      if (RingSeg != NULL) {
-        UsbHcFreeMem (Xhc->MemPool, RingSeg, sizeof (TRB_TEMPLATE) * TR_RING_TRB_NUMBER);
-      }
-      FreePool (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index]);
-      Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index] = NULL;
-    }
+    XhcPeiFreeEndpointRings (Xhc, SlotId, (UINT8) (Index + 1));
   }
 
   for (Index = 0; Index < Xhc->UsbDevContext[SlotId].DevDesc.NumConfigurations; Index++) {
@@ -1577,7 +1757,6 @@ XhcPeiDisableSlotCmd64 (
   TRB_TEMPLATE          *EvtTrb;
   CMD_TRB_DISABLE_SLOT  CmdTrbDisSlot;
   UINT8                 Index;
-  VOID                  *RingSeg;
 
   //
   // Disable the device slots occupied by these devices on its downstream ports.
@@ -1626,14 +1805,7 @@ XhcPeiDisableSlotCmd64 (
   // Free the slot related data structure
   //
   for (Index = 0; Index < 31; Index++) {
-    if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index] != NULL) {
-      RingSeg = ((TRANSFER_RING *) (UINTN) Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index])->RingSeg0;
-      if (RingSeg != NULL) {
-        UsbHcFreeMem (Xhc->MemPool, RingSeg, sizeof (TRB_TEMPLATE) * TR_RING_TRB_NUMBER);
-      }
-      FreePool (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index]);
-      Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index] = NULL;
-    }
+    XhcPeiFreeEndpointRings (Xhc, SlotId, (UINT8) (Index + 1));
   }
 
   for (Index = 0; Index < Xhc->UsbDevContext[SlotId].DevDesc.NumConfigurations; Index++) {
@@ -1662,265 +1834,403 @@ XhcPeiDisableSlotCmd64 (
 }
 
 /**
-  Configure all the device endpoints through XHCI's Configure_Endpoint cmd.
+  Find the SuperSpeed Endpoint Companion descriptor that follows an endpoint descriptor.
 
-  @param  Xhc           The XHCI device.
-  @param  SlotId        The slot id to be configured.
-  @param  DeviceSpeed   The device's speed.
   @param  ConfigDesc    The pointer to the usb device configuration descriptor.
+  @param  EpDesc        The pointer to the usb device endpoint descriptor.
 
-  @retval EFI_SUCCESS   Successfully configure all the device endpoints.
+  @return The endpoint companion descriptor, or NULL if there is none.
 
 **/
-EFI_STATUS
-XhcPeiSetConfigCmd (
-  IN PEI_XHC_DEV                *Xhc,
-  IN UINT8                      SlotId,
-  IN UINT8                      DeviceSpeed,
-  IN USB_CONFIG_DESCRIPTOR      *ConfigDesc
+USB_SS_ENDPOINT_COMPANION_DESCRIPTOR *
+XhcPeiGetEndpointCompanion (
+  IN USB_CONFIG_DESCRIPTOR      *ConfigDesc,
+  IN USB_ENDPOINT_DESCRIPTOR    *EpDesc
   )
 {
-  EFI_STATUS                    Status;
-  USB_INTERFACE_DESCRIPTOR      *IfDesc;
-  USB_ENDPOINT_DESCRIPTOR       *EpDesc;
-  UINT8                         Index;
-  UINTN                         NumEp;
-  UINTN                         EpIndex;
-  UINT8                         EpAddr;
-  EFI_USB_DATA_DIRECTION        Direction;
-  UINT8                         Dci;
-  UINT8                         MaxDci;
-  EFI_PHYSICAL_ADDRESS          PhyAddr;
-  UINT8                         Interval;
+  UINT8                         *Desc;
+  UINT8                         *DescEnd;
 
-  TRANSFER_RING                 *EndpointTransferRing;
-  CMD_TRB_CONFIG_ENDPOINT       CmdTrbCfgEP;
-  INPUT_CONTEXT                 *InputContext;
-  DEVICE_CONTEXT                *OutputContext;
-  EVT_TRB_COMMAND_COMPLETION    *EvtTrb;
   //
-  // 4.6.6 Configure Endpoint
+  // Every descriptor starts with its length and type
   //
-  InputContext  = Xhc->UsbDevContext[SlotId].InputContext;
-  OutputContext = Xhc->UsbDevContext[SlotId].OutputContext;
-  ZeroMem (InputContext, sizeof (INPUT_CONTEXT));
-  CopyMem (&InputContext->Slot, &OutputContext->Slot, sizeof (SLOT_CONTEXT));
-
-  ASSERT (ConfigDesc != NULL);
-
-  MaxDci = 0;
-
-  IfDesc = (USB_INTERFACE_DESCRIPTOR *) (ConfigDesc + 1);
-  for (Index = 0; Index < ConfigDesc->NumInterfaces; Index++) {
-    while ((IfDesc->DescriptorType != USB_DESC_TYPE_INTERFACE) || (IfDesc->AlternateSetting != 0)) {
-      IfDesc = (USB_INTERFACE_DESCRIPTOR *) ((UINTN) IfDesc + IfDesc->Length);
+  Desc    = (UINT8 *) EpDesc + EpDesc->Length;
+  DescEnd = (UINT8 *) ConfigDesc + ConfigDesc->TotalLength;
+  while ((Desc + 2 <= DescEnd) && (Desc[0] != 0)) {
+    if (Desc[1] == USB_DESC_TYPE_SS_ENDPOINT_COMPANION) {
+      if (Desc + sizeof (USB_SS_ENDPOINT_COMPANION_DESCRIPTOR) > DescEnd) {
+        break;
+      }
+      return (USB_SS_ENDPOINT_COMPANION_DESCRIPTOR *) Desc;
     }
+    if ((Desc[1] == USB_DESC_TYPE_ENDPOINT) || (Desc[1] == USB_DESC_TYPE_INTERFACE)) {
+      break;
+    }
+    Desc += Desc[0];
+  }
 
-    NumEp = IfDesc->NumEndpoints;
-
-    EpDesc = (USB_ENDPOINT_DESCRIPTOR *) (IfDesc + 1);
-    for (EpIndex = 0; EpIndex < NumEp; EpIndex++) {
-      while (EpDesc->DescriptorType != USB_DESC_TYPE_ENDPOINT) {
-        EpDesc = (USB_ENDPOINT_DESCRIPTOR *) ((UINTN) EpDesc + EpDesc->Length);
-      }
+  return NULL;
+}
 
-      EpAddr    = (UINT8) (EpDesc->EndpointAddress & 0x0F);
-      Direction = (UINT8) ((EpDesc->EndpointAddress & 0x80) ? EfiUsbDataIn : EfiUsbDataOut);
+/**
+  Free the transfer rings of an endpoint, including the stream rings and the
+  stream context array of a bulk endpoint with streams.
 
-      Dci = XhcPeiEndpointToDci (EpAddr, Direction);
-      if (Dci > MaxDci) {
-        MaxDci = Dci;
-      }
+  @param  Xhc           The XHCI device.
+  @param  SlotId        The slot id of the device.
+  @param  Dci           The device context index of the endpoint.
 
-      InputContext->InputControlContext.Dword2 |= (BIT0 << Dci);
-      InputContext->EP[Dci-1].MaxPacketSize     = EpDesc->MaxPacketSize;
+**/
+VOID
+XhcPeiFreeEndpointRings (
+  IN PEI_XHC_DEV                *Xhc,
+  IN UINT8                      SlotId,
+  IN UINT8                      Dci
+  )
+{
+  USB_DEV_CONTEXT               *DevContext;
+  TRANSFER_RING                 *Ring;
+  UINTN                         StreamId;
 
-      if (DeviceSpeed == EFI_USB_SPEED_SUPER) {
-        //
-        // 6.2.3.4, shall be set to the value defined in the bMaxBurst field of the SuperSpeed Endpoint Companion Descriptor.
-        //
-        InputContext->EP[Dci-1].MaxBurstSize = 0x0;
-      } else {
-        InputContext->EP[Dci-1].MaxBurstSize = 0x0;
-      }
+  DevContext = &Xhc->UsbDevContext[SlotId];
 
-      switch (EpDesc->Attributes & USB_ENDPOINT_TYPE_MASK) {
-        case USB_ENDPOINT_BULK:
-          if (Direction == EfiUsbDataIn) {
-            InputContext->EP[Dci-1].CErr   = 3;
-            InputContext->EP[Dci-1].EPType = ED_BULK_IN;
-          } else {
-            InputContext->EP[Dci-1].CErr   = 3;
-            InputContext->EP[Dci-1].EPType = ED_BULK_OUT;
-          }
-
-          InputContext->EP[Dci-1].AverageTRBLength = 0x1000;
-          if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] == NULL) {
-            EndpointTransferRing = AllocateZeroPool (sizeof (TRANSFER_RING));
-            Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] = (VOID *) EndpointTransferRing;
-            XhcPeiCreateTransferRing (Xhc, TR_RING_TRB_NUMBER, (TRANSFER_RING *) Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1]);
-          }
-
-          break;
-        case USB_ENDPOINT_ISO:
-          if (Direction == EfiUsbDataIn) {
-            InputContext->EP[Dci-1].CErr   = 0;
-            InputContext->EP[Dci-1].EPType = ED_ISOCH_IN;
-          } else {
-            InputContext->EP[Dci-1].CErr   = 0;
-            InputContext->EP[Dci-1].EPType = ED_ISOCH_OUT;
-          }
-          //
-          // Get the bInterval from descriptor and init the the interval field of endpoint context.
-          // Refer to XHCI 1.1 spec section 6.2.3.6.
-          //
-          if (DeviceSpeed == EFI_USB_SPEED_FULL) {
-            Interval = EpDesc->Interval;
-            ASSERT (Interval >= 1 && Interval <= 16);
-            InputContext->EP[Dci-1].Interval = Interval + 2;
-          } else if ((DeviceSpeed == EFI_USB_SPEED_HIGH) || (DeviceSpeed == EFI_USB_SPEED_SUPER)) {
-            Interval = EpDesc->Interval;
-            ASSERT (Interval >= 1 && Interval <= 16);
-            InputContext->EP[Dci-1].Interval = Interval - 1;
-          }
+  Ring = (TRANSFER_RING *) DevContext->EndpointTransferRing[Dci-1];
+  if (Ring != NULL) {
+    if (Ring->RingSeg0 != NULL) {
+      UsbHcFreeMem (Xhc->MemPool, Ring->RingSeg0, sizeof (TRB_TEMPLATE) * Ring->TrbNumber);
+    }
+    FreePool (Ring);
+    DevContext->EndpointTransferRing[Dci-1] = NULL;
+  }
 
-          //
-          // Do not support isochronous transfer now.
-          //
-          DEBUG ((DEBUG_INFO, "XhcPeiSetConfigCmd: Unsupport ISO EP found, Transfer ring is not allocated.\n"));
-          EpDesc = (USB_ENDPOINT_DESCRIPTOR *)((UINTN)EpDesc + EpDesc->Length);
-          continue;
-        case USB_ENDPOINT_INTERRUPT:
-          if (Direction == EfiUsbDataIn) {
-            InputContext->EP[Dci-1].CErr   = 3;
-            InputContext->EP[Dci-1].EPType = ED_INTERRUPT_IN;
-          } else {
-            InputContext->EP[Dci-1].CErr   = 3;
-            InputContext->EP[Dci-1].EPType = ED_INTERRUPT_OUT;
-          }
-          InputContext->EP[Dci-1].AverageTRBLength = 0x1000;
-          InputContext->EP[Dci-1].MaxESITPayload   = EpDesc->MaxPacketSize;
-          //
-          // Get the bInterval from descriptor and init the interval field of endpoint context
-          //
-          if ((DeviceSpeed == EFI_USB_SPEED_FULL) || (DeviceSpeed == EFI_USB_SPEED_LOW)) {
-            Interval = EpDesc->Interval;
-            //
-            // Calculate through the bInterval field of Endpoint descriptor.
-            //
-            ASSERT (Interval != 0);
-            InputContext->EP[Dci-1].Interval = (UINT32) HighBitSet32 ((UINT32) Interval) + 3;
-          } else if ((DeviceSpeed == EFI_USB_SPEED_HIGH) || (DeviceSpeed == EFI_USB_SPEED_SUPER)) {
-            Interval = EpDesc->Interval;
-            ASSERT (Interval >= 1 && Interval <= 16);
-            //
-            // Refer to XHCI 1.0 spec section 6.2.3.6, table 61
-            //
-            InputContext->EP[Dci-1].Interval = Interval - 1;
-          }
-
-          if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] == NULL) {
-            EndpointTransferRing = AllocateZeroPool (sizeof (TRANSFER_RING));
-            Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] = (VOID *) EndpointTransferRing;
-            XhcPeiCreateTransferRing (Xhc, TR_RING_TRB_NUMBER, (TRANSFER_RING *) Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1]);
-          }
-          break;
-
-        case USB_ENDPOINT_CONTROL:
-          //
-          // Do not support control transfer now.
-          //
-          DEBUG ((DEBUG_INFO, "XhcPeiSetConfigCmd: Unsupport Control EP found, Transfer ring is not allocated.\n"));
-        default:
-          DEBUG ((DEBUG_INFO, "XhcPeiSetConfigCmd: Unknown EP found, Transfer ring is not allocated.\n"));
-          EpDesc = (USB_ENDPOINT_DESCRIPTOR *)((UINTN)EpDesc + EpDesc->Length);
-          continue;
+  Ring = (TRANSFER_RING *) DevContext->StreamTransferRing[Dci-1];
+  if (Ring != NULL) {
+    for (StreamId = 1; StreamId <= DevContext->StreamNumber[Dci-1]; StreamId++) {
+      if (Ring[StreamId].RingSeg0 != NULL) {
+        UsbHcFreeMem (Xhc->MemPool, Ring[StreamId].RingSeg0, sizeof (TRB_TEMPLATE) * Ring[StreamId].TrbNumber);
       }
-
-      PhyAddr = UsbHcGetPciAddrForHostAddr (
-                  Xhc->MemPool,
-                  ((TRANSFER_RING *) (UINTN) Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1])->RingSeg0,
-                  sizeof (TRB_TEMPLATE) * TR_RING_TRB_NUMBER
-                  );
-      PhyAddr &= ~((EFI_PHYSICAL_ADDRESS)0x0F);
-      PhyAddr |= (EFI_PHYSICAL_ADDRESS)((TRANSFER_RING *) (UINTN) Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1])->RingPCS;
-      InputContext->EP[Dci-1].PtrLo = XHC_LOW_32BIT (PhyAddr);
-      InputContext->EP[Dci-1].PtrHi = XHC_HIGH_32BIT (PhyAddr);
-
-      EpDesc = (USB_ENDPOINT_DESCRIPTOR *) ((UINTN) EpDesc + EpDesc->Length);
     }
-    IfDesc = (USB_INTERFACE_DESCRIPTOR *) ((UINTN) IfDesc + IfDesc->Length);
+    FreePool (Ring);
+    DevContext->StreamTransferRing[Dci-1] = NULL;
   }
 
-  InputContext->InputControlContext.Dword2 |= BIT0;
-  InputContext->Slot.ContextEntries         = MaxDci;
-  //
-  // configure endpoint
-  //
-  ZeroMem (&CmdTrbCfgEP, sizeof (CmdTrbCfgEP));
-  PhyAddr = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, InputContext, sizeof (INPUT_CONTEXT));
-  CmdTrbCfgEP.PtrLo    = XHC_LOW_32BIT (PhyAddr);
-  CmdTrbCfgEP.PtrHi    = XHC_HIGH_32BIT (PhyAddr);
-  CmdTrbCfgEP.CycleBit = 1;
-  CmdTrbCfgEP.Type     = TRB_TYPE_CON_ENDPOINT;
-  CmdTrbCfgEP.SlotId   = Xhc->UsbDevContext[SlotId].SlotId;
-  DEBUG ((DEBUG_INFO, "XhcSetConfigCmd: Configure Endpoint\n"));
-  Status = XhcPeiCmdTransfer (
-             Xhc,
-             (TRB_TEMPLATE *) (UINTN) &CmdTrbCfgEP,
-             XHC_GENERIC_TIMEOUT,
-             (TRB_TEMPLATE **) (UINTN) &EvtTrb
-             );
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "XhcSetConfigCmd: Config Endpoint Failed, Status = %r\n", Status));
+  if (DevContext->StreamContextArray[Dci-1] != NULL) {
+    UsbHcFreeMem (Xhc->MemPool, DevContext->StreamContextArray[Dci-1], sizeof (STREAM_CONTEXT) * XHC_STREAM_ARRAY_SIZE);
+    DevContext->StreamContextArray[Dci-1] = NULL;
   }
-  return Status;
+
+  DevContext->StreamNumber[Dci-1] = 0;
 }
 
 /**
-  Configure all the device endpoints through XHCI's Configure_Endpoint cmd.
+  Create the Primary Stream Context Array and the stream transfer rings of a
+  SuperSpeed bulk endpoint, refer to XHCI 1.1 spec section 4.12.
 
   @param  Xhc           The XHCI device.
-  @param  SlotId        The slot id to be configured.
-  @param  DeviceSpeed   The device's speed.
-  @param  ConfigDesc    The pointer to the usb device configuration descriptor.
+  @param  SlotId        The slot id of the device.
+  @param  Dci           The device context index of the endpoint.
+  @param  MaxStreams    The MaxStreams field of the endpoint companion descriptor.
 
-  @retval EFI_SUCCESS   Successfully configure all the device endpoints.
+  @return The MaxPStreams value of the endpoint context, or 0 if the endpoint
+          does not use streams.
 
 **/
-EFI_STATUS
-XhcPeiSetConfigCmd64 (
+UINT8
+XhcPeiCreateStreamRings (
   IN PEI_XHC_DEV                *Xhc,
   IN UINT8                      SlotId,
-  IN UINT8                      DeviceSpeed,
-  IN USB_CONFIG_DESCRIPTOR      *ConfigDesc
+  IN UINT8                      Dci,
+  IN UINT8                      MaxStreams
+  )
+{
+  USB_DEV_CONTEXT               *DevContext;
+  STREAM_CONTEXT                *StreamContext;
+  TRANSFER_RING                 *Ring;
+  UINT8                         MaxPStreams;
+  UINTN                         StreamNumber;
+  UINTN                         StreamId;
+  EFI_PHYSICAL_ADDRESS          PhyAddr;
+
+  DevContext = &Xhc->UsbDevContext[SlotId];
+  XhcPeiFreeEndpointRings (Xhc, SlotId, Dci);
+
+  if ((MaxStreams == 0) || (Xhc->HcCParams.Data.MaxPsaSize == 0)) {
+    return 0;
+  }
+
+  //
+  // The Primary Stream Context Array has 2^(MaxPStreams+1) entries and stream 0 is
+  // reserved, so at most XHC_STREAM_ARRAY_SIZE - 1 streams are used.
+  //
+  MaxPStreams  = (UINT8) MIN (HighBitSet32 (XHC_STREAM_ARRAY_SIZE) - 1, Xhc->HcCParams.Data.MaxPsaSize);
+  StreamNumber = MIN ((1U << (MaxPStreams + 1)) - 1, 1U << MaxStreams);
+
+  StreamContext = UsbHcAllocateMem (Xhc->MemPool, sizeof (STREAM_CONTEXT) * XHC_STREAM_ARRAY_SIZE);
+  Ring          = AllocateZeroPool (sizeof (TRANSFER_RING) * (StreamNumber + 1));
+  if ((StreamContext == NULL) || (Ring == NULL)) {
+    if (StreamContext != NULL) {
+      UsbHcFreeMem (Xhc->MemPool, StreamContext, sizeof (STREAM_CONTEXT) * XHC_STREAM_ARRAY_SIZE);
+    }
+    if (Ring != NULL) {
+      FreePool (Ring);
+    }
+    return 0;
+  }
+  ZeroMem (StreamContext, sizeof (STREAM_CONTEXT) * XHC_STREAM_ARRAY_SIZE);
+
+  DevContext->StreamContextArray[Dci-1] = StreamContext;
+  DevContext->StreamTransferRing[Dci-1] = Ring;
+  DevContext->StreamNumber[Dci-1]       = (UINT16) StreamNumber;
+
+  for (StreamId = 1; StreamId <= StreamNumber; StreamId++) {
+    XhcPeiCreateTransferRing (Xhc, TR_RING_TRB_NUMBER, &Ring[StreamId]);
+    PhyAddr = UsbHcGetPciAddrForHostAddr (
+                Xhc->MemPool,
+                Ring[StreamId].RingSeg0,
+                sizeof (TRB_TEMPLATE) * TR_RING_TRB_NUMBER
+                );
+    StreamContext[StreamId].PtrLo = XHC_LOW_32BIT (PhyAddr) | (SCT_PRIMARY_TRB_RING << 1) | Ring[StreamId].RingPCS;
+    StreamContext[StreamId].PtrHi = XHC_HIGH_32BIT (PhyAddr);
+  }
+
+  DEBUG ((DEBUG_INFO, "XhcPeiCreateStreamRings: Slot = %x, Dci = %x, %d streams\n", SlotId, Dci, StreamNumber));
+  return MaxPStreams;
+}
+
+/**
+  Initialize the endpoint contexts of an interface setting in the input context.
+
+  @param  Xhc           The XHCI device.
+  @param  SlotId        The slot id to be configured.
+  @param  DeviceSpeed   The device's speed.
+  @param  InputContext  The pointer to the input context.
+  @param  ConfigDesc    The pointer to the usb device configuration descriptor.
+  @param  IfDesc        The pointer to the usb device interface descriptor.
+
+  @return The maximum device context index of the endpoints of the interface.
+
+**/
+UINT8
+XhcPeiInitializeEndpointContext (
+  IN PEI_XHC_DEV                *Xhc,
+  IN UINT8                      SlotId,
+  IN UINT8                      DeviceSpeed,
+  IN INPUT_CONTEXT              *InputContext,
+  IN USB_CONFIG_DESCRIPTOR      *ConfigDesc,
+  IN USB_INTERFACE_DESCRIPTOR   *IfDesc
+  )
+{
+  USB_ENDPOINT_DESCRIPTOR               *EpDesc;
+  USB_SS_ENDPOINT_COMPANION_DESCRIPTOR  *EpCompDesc;
+  UINTN                                 NumEp;
+  UINTN                                 EpIndex;
+  UINT8                                 EpAddr;
+  EFI_USB_DATA_DIRECTION                Direction;
+  UINT8                                 Dci;
+  UINT8                                 MaxDci;
+  EFI_PHYSICAL_ADDRESS                  PhyAddr;
+  UINT8                                 Interval;
+  TRANSFER_RING                         *EndpointTransferRing;
+
+  MaxDci = 0;
+  NumEp  = IfDesc->NumEndpoints;
+
+  EpDesc = (USB_ENDPOINT_DESCRIPTOR *) (IfDesc + 1);
+  for (EpIndex = 0; EpIndex < NumEp; EpIndex++) {
+    while (EpDesc->DescriptorType != USB_DESC_TYPE_ENDPOINT) {
+      EpDesc = (USB_ENDPOINT_DESCRIPTOR *) ((UINTN) EpDesc + EpDesc->Length);
+    }
+
+    EpAddr    = (UINT8) (EpDesc->EndpointAddress & 0x0F);
+    Direction = (UINT8) ((EpDesc->EndpointAddress & 0x80) ? EfiUsbDataIn : EfiUsbDataOut);
+
+    Dci = XhcPeiEndpointToDci (EpAddr, Direction);
+    ASSERT (Dci < 32);
+    if (Dci > MaxDci) {
+      MaxDci = Dci;
+    }
+
+    InputContext->InputControlContext.Dword2 |= (BIT0 << Dci);
+    InputContext->EP[Dci-1].MaxPacketSize     = EpDesc->MaxPacketSize;
+
+    EpCompDesc = NULL;
+    if (DeviceSpeed == EFI_USB_SPEED_SUPER) {
+      EpCompDesc = XhcPeiGetEndpointCompanion (ConfigDesc, EpDesc);
+    }
+    InputContext->EP[Dci-1].MaxBurstSize = 0x0;
+
+    switch (EpDesc->Attributes & USB_ENDPOINT_TYPE_MASK) {
+      case USB_ENDPOINT_BULK:
+        if (Direction == EfiUsbDataIn) {
+          InputContext->EP[Dci-1].CErr   = 3;
+          InputContext->EP[Dci-1].EPType = ED_BULK_IN;
+        } else {
+          InputContext->EP[Dci-1].CErr   = 3;
+          InputContext->EP[Dci-1].EPType = ED_BULK_OUT;
+        }
+
+        InputContext->EP[Dci-1].AverageTRBLength = 0x1000;
+        if (EpCompDesc != NULL) {
+          //
+          // 6.2.3.4, shall be set to the value defined in the bMaxBurst field of the SuperSpeed Endpoint Companion Descriptor.
+          //
+          InputContext->EP[Dci-1].MaxBurstSize = EpCompDesc->MaxBurst;
+          InputContext->EP[Dci-1].MaxPStreams  = XhcPeiCreateStreamRings (
+                                                   Xhc,
+                                                   SlotId,
+                                                   Dci,
+                                                   EpCompDesc->Attributes & USB_SS_ENDPOINT_MAX_STREAMS_MASK
+                                                   );
+        }
+
+        if ((InputContext->EP[Dci-1].MaxPStreams == 0) &&
+            (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] == NULL)) {
+          EndpointTransferRing = AllocateZeroPool (sizeof (TRANSFER_RING));
+          Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] = (VOID *) EndpointTransferRing;
+          XhcPeiCreateTransferRing (Xhc, TR_RING_TRB_NUMBER, (TRANSFER_RING *) Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1]);
+        }
+
+        break;
+      case USB_ENDPOINT_ISO:
+        if (Direction == EfiUsbDataIn) {
+          InputContext->EP[Dci-1].CErr   = 0;
+          InputContext->EP[Dci-1].EPType = ED_ISOCH_IN;
+        } else {
+          InputContext->EP[Dci-1].CErr   = 0;
+          InputContext->EP[Dci-1].EPType = ED_ISOCH_OUT;
+        }
+        //
+        // Get the bInterval from descriptor and init the the interval field of endpoint context.
+        // Refer to XHCI 1.1 spec section 6.2.3.6.
+        //
+        if (DeviceSpeed == EFI_USB_SPEED_FULL) {
+          Interval = EpDesc->Interval;
+          ASSERT (Interval >= 1 && Interval <= 16);
+          InputContext->EP[Dci-1].Interval = Interval + 2;
+        } else if ((DeviceSpeed == EFI_USB_SPEED_HIGH) || (DeviceSpeed == EFI_USB_SPEED_SUPER)) {
+          Interval = EpDesc->Interval;
+          ASSERT (Interval >= 1 && Interval <= 16);
+          InputContext->EP[Dci-1].Interval = Interval - 1;
+        }
+
+        //
+        // Do not support isochronous transfer now.
+        //
+        DEBUG ((DEBUG_INFO, "XhcPeiInitializeEndpointContext: Unsupport ISO EP found, Transfer ring is not allocated.\n"));
+        EpDesc = (USB_ENDPOINT_DESCRIPTOR *)((UINTN)EpDesc + EpDesc->Length);
+        continue;
+      case USB_ENDPOINT_INTERRUPT:
+        if (Direction == EfiUsbDataIn) {
+          InputContext->EP[Dci-1].CErr   = 3;
+          InputContext->EP[Dci-1].EPType = ED_INTERRUPT_IN;
+        } else {
+          InputContext->EP[Dci-1].CErr   = 3;
+          InputContext->EP[Dci-1].EPType = ED_INTERRUPT_OUT;
+        }
+        InputContext->EP[Dci-1].AverageTRBLength = 0x1000;
+        InputContext->EP[Dci-1].MaxESITPayload   = EpDesc->MaxPacketSize;
+        //
+        // Get the bInterval from descriptor and init the interval field of endpoint context
+        //
+        if ((DeviceSpeed == EFI_USB_SPEED_FULL) || (DeviceSpeed == EFI_USB_SPEED_LOW)) {
+          Interval = EpDesc->Interval;
+          //
+          // Calculate through the bInterval field of Endpoint descriptor.
+          //
+          ASSERT (Interval != 0);
+          InputContext->EP[Dci-1].Interval = (UINT32) HighBitSet32 ((UINT32) Interval) + 3;
+        } else if ((DeviceSpeed == EFI_USB_SPEED_HIGH) || (DeviceSpeed == EFI_USB_SPEED_SUPER)) {
+          Interval = EpDesc->Interval;
+          ASSERT (Interval >= 1 && Interval <= 16);
+          //
+          // Refer to XHCI 1.0 spec section 6.2.3.6, table 61
+          //
+          InputContext->EP[Dci-1].Interval = Interval - 1;
+        }
+
+        if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] == NULL) {
+          EndpointTransferRing = AllocateZeroPool (sizeof (TRANSFER_RING));
+          Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] = (VOID *) EndpointTransferRing;
+          XhcPeiCreateTransferRing (Xhc, TR_RING_TRB_NUMBER, (TRANSFER_RING *) Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1]);
+        }
+        break;
+
+      case USB_ENDPOINT_CONTROL:
+        //
+        // Do not support control transfer now.
+        //
+        DEBUG ((DEBUG_INFO, "XhcPeiInitializeEndpointContext: Unsupport Control EP found, Transfer ring is not allocated.\n"));
+      default:
+        DEBUG ((DEBUG_INFO, "XhcPeiInitializeEndpointContext: Unknown EP found, Transfer ring is not allocated.\n"));
+        EpDesc = (USB_ENDPOINT_DESCRIPTOR *)((UINTN)EpDesc + EpDesc->Length);
+        continue;
+    }
+
+    if (InputContext->EP[Dci-1].MaxPStreams != 0) {
+      //
+      // The TR Dequeue Pointer of an endpoint with streams points to its Primary Stream Context Array
+      //
+      InputContext->EP[Dci-1].LSA = 1;
+      PhyAddr = UsbHcGetPciAddrForHostAddr (
+                  Xhc->MemPool,
+                  Xhc->UsbDevContext[SlotId].StreamContextArray[Dci-1],
+                  sizeof (STREAM_CONTEXT) * XHC_STREAM_ARRAY_SIZE
+                  );
+    } else {
+      PhyAddr = UsbHcGetPciAddrForHostAddr (
+                  Xhc->MemPool,
+                  ((TRANSFER_RING *) (UINTN) Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1])->RingSeg0,
+                  sizeof (TRB_TEMPLATE) * TR_RING_TRB_NUMBER
+                  );
+      PhyAddr &= ~((EFI_PHYSICAL_ADDRESS)0x0F);
+      PhyAddr |= (EFI_PHYSICAL_ADDRESS)((TRANSFER_RING *) (UINTN) Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1])->RingPCS;
+    }
+    InputContext->EP[Dci-1].PtrLo = XHC_LOW_32BIT (PhyAddr);
+    InputContext->EP[Dci-1].PtrHi = XHC_HIGH_32BIT (PhyAddr);
+
+    EpDesc = (USB_ENDPOINT_DESCRIPTOR *) ((UINTN) EpDesc + EpDesc->Length);
+  }
+
+  return MaxDci;
+}
+
+/**
+  Configure all the device endpoints through XHCI's Configure_Endpoint cmd.
+
+  @param  Xhc           The XHCI device.
+  @param  SlotId        The slot id to be configured.
+  @param  DeviceSpeed   The device's speed.
+  @param  ConfigDesc    The pointer to the usb device configuration descriptor.
+
+  @retval EFI_SUCCESS   Successfully configure all the device endpoints.
+
+**/
+EFI_STATUS
+XhcPeiSetConfigCmd (
+  IN PEI_XHC_DEV                *Xhc,
+  IN UINT8                      SlotId,
+  IN UINT8                      DeviceSpeed,
+  IN USB_CONFIG_DESCRIPTOR      *ConfigDesc
   )
 {
   EFI_STATUS                    Status;
   USB_INTERFACE_DESCRIPTOR      *IfDesc;
-  USB_ENDPOINT_DESCRIPTOR       *EpDesc;
   UINT8                         Index;
-  UINTN                         NumEp;
-  UINTN                         EpIndex;
-  UINT8                         EpAddr;
-  EFI_USB_DATA_DIRECTION        Direction;
   UINT8                         Dci;
   UINT8                         MaxDci;
   EFI_PHYSICAL_ADDRESS          PhyAddr;
-  UINT8                         Interval;
 
-  TRANSFER_RING                 *EndpointTransferRing;
   CMD_TRB_CONFIG_ENDPOINT       CmdTrbCfgEP;
-  INPUT_CONTEXT_64              *InputContext;
-  DEVICE_CONTEXT_64             *OutputContext;
+  INPUT_CONTEXT                 *InputContext;
+  DEVICE_CONTEXT                *OutputContext;
   EVT_TRB_COMMAND_COMPLETION    *EvtTrb;
   //
   // 4.6.6 Configure Endpoint
   //
   InputContext  = Xhc->UsbDevContext[SlotId].InputContext;
   OutputContext = Xhc->UsbDevContext[SlotId].OutputContext;
-  ZeroMem (InputContext, sizeof (INPUT_CONTEXT_64));
-  CopyMem (&InputContext->Slot, &OutputContext->Slot, sizeof (SLOT_CONTEXT_64));
+  ZeroMem (InputContext, sizeof (INPUT_CONTEXT));
+  CopyMem (&InputContext->Slot, &OutputContext->Slot, sizeof (SLOT_CONTEXT));
 
   ASSERT (ConfigDesc != NULL);
 
@@ -1932,143 +2242,436 @@ XhcPeiSetConfigCmd64 (
       IfDesc = (USB_INTERFACE_DESCRIPTOR *) ((UINTN) IfDesc + IfDesc->Length);
     }
 
-    NumEp = IfDesc->NumEndpoints;
+    Dci = XhcPeiInitializeEndpointContext (Xhc, SlotId, DeviceSpeed, InputContext, ConfigDesc, IfDesc);
+    if (Dci > MaxDci) {
+      MaxDci = Dci;
+    }
 
-    EpDesc = (USB_ENDPOINT_DESCRIPTOR *) (IfDesc + 1);
-    for (EpIndex = 0; EpIndex < NumEp; EpIndex++) {
-      while (EpDesc->DescriptorType != USB_DESC_TYPE_ENDPOINT) {
-        EpDesc = (USB_ENDPOINT_DESCRIPTOR *) ((UINTN) EpDesc + EpDesc->Length);
-      }
+    IfDesc = (USB_INTERFACE_DESCRIPTOR *) ((UINTN) IfDesc + IfDesc->Length);
+  }
 
-      EpAddr    = (UINT8) (EpDesc->EndpointAddress & 0x0F);
-      Direction = (UINT8) ((EpDesc->EndpointAddress & 0x80) ? EfiUsbDataIn : EfiUsbDataOut);
+  InputContext->InputControlContext.Dword2 |= BIT0;
+  InputContext->Slot.ContextEntries         = MaxDci;
+  //
+  // configure endpoint
+  //
+  ZeroMem (&CmdTrbCfgEP, sizeof (CmdTrbCfgEP));
+  PhyAddr = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, InputContext, sizeof (INPUT_CONTEXT));
+  CmdTrbCfgEP.PtrLo    = XHC_LOW_32BIT (PhyAddr);
+  CmdTrbCfgEP.PtrHi    = XHC_HIGH_32BIT (PhyAddr);
+  CmdTrbCfgEP.CycleBit = 1;
+  CmdTrbCfgEP.Type     = TRB_TYPE_CON_ENDPOINT;
+  CmdTrbCfgEP.SlotId   = Xhc->UsbDevContext[SlotId].SlotId;
+  DEBUG ((DEBUG_INFO, "XhcSetConfigCmd: Configure Endpoint\n"));
+  Status = XhcPeiCmdTransfer (
+             Xhc,
+             (TRB_TEMPLATE *) (UINTN) &CmdTrbCfgEP,
+             XHC_GENERIC_TIMEOUT,
+             (TRB_TEMPLATE **) (UINTN) &EvtTrb
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "XhcSetConfigCmd: Config Endpoint Failed, Status = %r\n", Status));
+  }
+  return Status;
+}
 
-      Dci = XhcPeiEndpointToDci (EpAddr, Direction);
-      ASSERT (Dci < 32);
-      if (Dci > MaxDci) {
-        MaxDci = Dci;
+/**
+  Set an alternate setting of an interface through XHCI's Configure_Endpoint cmd.
+
+  The endpoints of the active alternate setting are dropped and the endpoints
+  of the new alternate setting are added in a single command.
+
+  @param  Xhc           The XHCI device.
+  @param  SlotId        The slot id to be configured.
+  @param  DeviceSpeed   The device's speed.
+  @param  ConfigDesc    The pointer to the active usb device configuration descriptor.
+  @param  Request       The Set_Interface usb device request.
+
+  @retval EFI_SUCCESS   Successfully set the alternate setting.
+  @retval EFI_NOT_FOUND The interface or the alternate setting is not found.
+
+**/
+EFI_STATUS
+XhcPeiSetInterface (
+  IN PEI_XHC_DEV                *Xhc,
+  IN UINT8                      SlotId,
+  IN UINT8                      DeviceSpeed,
+  IN USB_CONFIG_DESCRIPTOR      *ConfigDesc,
+  IN EFI_USB_DEVICE_REQUEST     *Request
+  )
+{
+  EFI_STATUS                    Status;
+  USB_INTERFACE_DESCRIPTOR      *IfDesc;
+  USB_INTERFACE_DESCRIPTOR      *IfDescActive;
+  USB_INTERFACE_DESCRIPTOR      *IfDescSet;
+  USB_ENDPOINT_DESCRIPTOR       *EpDesc;
+  UINTN                         NumEp;
+  UINTN                         EpIndex;
+  UINT8                         EpAddr;
+  EFI_USB_DATA_DIRECTION        Direction;
+  UINT8                         Dci;
+  UINT8                         MaxDci;
+  UINT8                         InterfaceNumber;
+  EFI_PHYSICAL_ADDRESS          PhyAddr;
+
+  CMD_TRB_CONFIG_ENDPOINT       CmdTrbCfgEP;
+  INPUT_CONTEXT                 *InputContext;
+  DEVICE_CONTEXT                *OutputContext;
+  EVT_TRB_COMMAND_COMPLETION    *EvtTrb;
+
+  ASSERT (ConfigDesc != NULL);
+
+  InterfaceNumber = (UINT8) Request->Index;
+  if (InterfaceNumber >= XHC_MAX_INTERFACE) {
+    return EFI_NOT_FOUND;
+  }
+
+  //
+  // Find the interface descriptors of the active and the requested alternate setting
+  //
+  IfDescActive = NULL;
+  IfDescSet    = NULL;
+  IfDesc       = (USB_INTERFACE_DESCRIPTOR *) (ConfigDesc + 1);
+  while (((UINTN) IfDesc + sizeof (USB_INTERFACE_DESCRIPTOR) <= (UINTN) ConfigDesc + ConfigDesc->TotalLength) &&
+         (IfDesc->Length != 0)) {
+    if ((IfDesc->DescriptorType == USB_DESC_TYPE_INTERFACE) && (IfDesc->InterfaceNumber == InterfaceNumber)) {
+      if (IfDesc->AlternateSetting == Xhc->UsbDevContext[SlotId].ActiveAlternateSetting[InterfaceNumber]) {
+        IfDescActive = IfDesc;
       }
+      if (IfDesc->AlternateSetting == (UINT8) Request->Value) {
+        IfDescSet = IfDesc;
+      }
+    }
+    IfDesc = (USB_INTERFACE_DESCRIPTOR *) ((UINTN) IfDesc + IfDesc->Length);
+  }
 
-      InputContext->InputControlContext.Dword2 |= (BIT0 << Dci);
-      InputContext->EP[Dci-1].MaxPacketSize     = EpDesc->MaxPacketSize;
+  if ((IfDescActive == NULL) || (IfDescSet == NULL)) {
+    return EFI_NOT_FOUND;
+  }
 
-      if (DeviceSpeed == EFI_USB_SPEED_SUPER) {
-        //
-        // 6.2.3.4, shall be set to the value defined in the bMaxBurst field of the SuperSpeed Endpoint Companion Descriptor.
-        //
-        InputContext->EP[Dci-1].MaxBurstSize = 0x0;
-      } else {
-        InputContext->EP[Dci-1].MaxBurstSize = 0x0;
+  if (IfDescActive == IfDescSet) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // 4.6.6.1 Configure Endpoint for an alternate interface setting
+  //
+  InputContext  = Xhc->UsbDevContext[SlotId].InputContext;
+  OutputContext = Xhc->UsbDevContext[SlotId].OutputContext;
+  ZeroMem (InputContext, sizeof (INPUT_CONTEXT));
+  CopyMem (&InputContext->Slot, &OutputContext->Slot, sizeof (SLOT_CONTEXT));
+
+  NumEp  = IfDescActive->NumEndpoints;
+  EpDesc = (USB_ENDPOINT_DESCRIPTOR *) (IfDescActive + 1);
+  for (EpIndex = 0; EpIndex < NumEp; EpIndex++) {
+    while (EpDesc->DescriptorType != USB_DESC_TYPE_ENDPOINT) {
+      EpDesc = (USB_ENDPOINT_DESCRIPTOR *) ((UINTN) EpDesc + EpDesc->Length);
+    }
+
+    EpAddr    = (UINT8) (EpDesc->EndpointAddress & 0x0F);
+    Direction = (UINT8) ((EpDesc->EndpointAddress & 0x80) ? EfiUsbDataIn : EfiUsbDataOut);
+
+    Dci = XhcPeiEndpointToDci (EpAddr, Direction);
+    ASSERT (Dci < 32);
+
+    //
+    // Stop the running endpoint of the active setting before dropping it
+    //
+    if (OutputContext->EP[Dci-1].EPState == EP_STATE_RUNNING) {
+      Status = XhcPeiStopEndpoint (Xhc, SlotId, Dci);
+      if (EFI_ERROR (Status)) {
+        return Status;
       }
+    }
 
-      switch (EpDesc->Attributes & USB_ENDPOINT_TYPE_MASK) {
-        case USB_ENDPOINT_BULK:
-          if (Direction == EfiUsbDataIn) {
-            InputContext->EP[Dci-1].CErr   = 3;
-            InputContext->EP[Dci-1].EPType = ED_BULK_IN;
-          } else {
-            InputContext->EP[Dci-1].CErr   = 3;
-            InputContext->EP[Dci-1].EPType = ED_BULK_OUT;
-          }
-
-          InputContext->EP[Dci-1].AverageTRBLength = 0x1000;
-          if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] == NULL) {
-            EndpointTransferRing = AllocateZeroPool (sizeof (TRANSFER_RING));
-            Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] = (VOID *) EndpointTransferRing;
-            XhcPeiCreateTransferRing (Xhc, TR_RING_TRB_NUMBER, (TRANSFER_RING *) Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1]);
-          }
-
-          break;
-        case USB_ENDPOINT_ISO:
-          if (Direction == EfiUsbDataIn) {
-            InputContext->EP[Dci-1].CErr   = 0;
-            InputContext->EP[Dci-1].EPType = ED_ISOCH_IN;
-          } else {
-            InputContext->EP[Dci-1].CErr   = 0;
-            InputContext->EP[Dci-1].EPType = ED_ISOCH_OUT;
-          }
-          //
-          // Get the bInterval from descriptor and init the the interval field of endpoint context.
-          // Refer to XHCI 1.1 spec section 6.2.3.6.
-          //
-          if (DeviceSpeed == EFI_USB_SPEED_FULL) {
-            Interval = EpDesc->Interval;
-            ASSERT (Interval >= 1 && Interval <= 16);
-            InputContext->EP[Dci-1].Interval = Interval + 2;
-          } else if ((DeviceSpeed == EFI_USB_SPEED_HIGH) || (DeviceSpeed == EFI_USB_SPEED_SUPER)) {
-            Interval = EpDesc->Interval;
-            ASSERT (Interval >= 1 && Interval <= 16);
-            InputContext->EP[Dci-1].Interval = Interval - 1;
-          }
+    XhcPeiFreeEndpointRings (Xhc, SlotId, Dci);
+    InputContext->InputControlContext.Dword1 |= (BIT0 << Dci);
+
+    EpDesc = (USB_ENDPOINT_DESCRIPTOR *) ((UINTN) EpDesc + EpDesc->Length);
+  }
+
+  MaxDci = XhcPeiInitializeEndpointContext (Xhc, SlotId, DeviceSpeed, InputContext, ConfigDesc, IfDescSet);
 
+  InputContext->InputControlContext.Dword2 |= BIT0;
+  if (MaxDci > InputContext->Slot.ContextEntries) {
+    InputContext->Slot.ContextEntries = MaxDci;
+  }
+  //
+  // configure endpoint
+  //
+  ZeroMem (&CmdTrbCfgEP, sizeof (CmdTrbCfgEP));
+  PhyAddr = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, InputContext, sizeof (INPUT_CONTEXT));
+  CmdTrbCfgEP.PtrLo    = XHC_LOW_32BIT (PhyAddr);
+  CmdTrbCfgEP.PtrHi    = XHC_HIGH_32BIT (PhyAddr);
+  CmdTrbCfgEP.CycleBit = 1;
+  CmdTrbCfgEP.Type     = TRB_TYPE_CON_ENDPOINT;
+  CmdTrbCfgEP.SlotId   = Xhc->UsbDevContext[SlotId].SlotId;
+  DEBUG ((DEBUG_INFO, "XhcPeiSetInterface: Configure Endpoint\n"));
+  Status = XhcPeiCmdTransfer (
+             Xhc,
+             (TRB_TEMPLATE *) (UINTN) &CmdTrbCfgEP,
+             XHC_GENERIC_TIMEOUT,
+             (TRB_TEMPLATE **) (UINTN) &EvtTrb
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "XhcPeiSetInterface: Config Endpoint Failed, Status = %r\n", Status));
+  } else {
+    Xhc->UsbDevContext[SlotId].ActiveAlternateSetting[InterfaceNumber] = IfDescSet->AlternateSetting;
+  }
+  return Status;
+}
+
+/**
+  Initialize the endpoint contexts of an interface setting in the input context.
+
+  @param  Xhc           The XHCI device.
+  @param  SlotId        The slot id to be configured.
+  @param  DeviceSpeed   The device's speed.
+  @param  InputContext  The pointer to the input context.
+  @param  ConfigDesc    The pointer to the usb device configuration descriptor.
+  @param  IfDesc        The pointer to the usb device interface descriptor.
+
+  @return The maximum device context index of the endpoints of the interface.
+
+**/
+UINT8
+XhcPeiInitializeEndpointContext64 (
+  IN PEI_XHC_DEV                *Xhc,
+  IN UINT8                      SlotId,
+  IN UINT8                      DeviceSpeed,
+  IN INPUT_CONTEXT_64           *InputContext,
+  IN USB_CONFIG_DESCRIPTOR      *ConfigDesc,
+  IN USB_INTERFACE_DESCRIPTOR   *IfDesc
+  )
+{
+  USB_ENDPOINT_DESCRIPTOR               *EpDesc;
+  USB_SS_ENDPOINT_COMPANION_DESCRIPTOR  *EpCompDesc;
+  UINTN                                 NumEp;
+  UINTN                                 EpIndex;
+  UINT8                                 EpAddr;
+  EFI_USB_DATA_DIRECTION                Direction;
+  UINT8                                 Dci;
+  UINT8                                 MaxDci;
+  EFI_PHYSICAL_ADDRESS                  PhyAddr;
+  UINT8                                 Interval;
+  TRANSFER_RING                         *EndpointTransferRing;
+
+  MaxDci = 0;
+  NumEp  = IfDesc->NumEndpoints;
+
+  EpDesc = (USB_ENDPOINT_DESCRIPTOR *) (IfDesc + 1);
+  for (EpIndex = 0; EpIndex < NumEp; EpIndex++) {
+    while (EpDesc->DescriptorType != USB_DESC_TYPE_ENDPOINT) {
+      EpDesc = (USB_ENDPOINT_DESCRIPTOR *) ((UINTN) EpDesc + EpDesc->Length);
+    }
+
+    EpAddr    = (UINT8) (EpDesc->EndpointAddress & 0x0F);
+    Direction = (UINT8) ((EpDesc->EndpointAddress & 0x80) ? EfiUsbDataIn : EfiUsbDataOut);
+
+    Dci = XhcPeiEndpointToDci (EpAddr, Direction);
+    ASSERT (Dci < 32);
+    if (Dci > MaxDci) {
+      MaxDci = Dci;
+    }
+
+    InputContext->InputControlContext.Dword2 |= (BIT0 << Dci);
+    InputContext->EP[Dci-1].MaxPacketSize     = EpDesc->MaxPacketSize;
+
+    EpCompDesc = NULL;
+    if (DeviceSpeed == EFI_USB_SPEED_SUPER) {
+      EpCompDesc = XhcPeiGetEndpointCompanion (ConfigDesc, EpDesc);
+    }
+    InputContext->EP[Dci-1].MaxBurstSize = 0x0;
+
+    switch (EpDesc->Attributes & USB_ENDPOINT_TYPE_MASK) {
+      case USB_ENDPOINT_BULK:
+        if (Direction == EfiUsbDataIn) {
+          InputContext->EP[Dci-1].CErr   = 3;
+          InputContext->EP[Dci-1].EPType = ED_BULK_IN;
+        } else {
+          InputContext->EP[Dci-1].CErr   = 3;
+          InputContext->EP[Dci-1].EPType = ED_BULK_OUT;
+        }
+
+        InputContext->EP[Dci-1].AverageTRBLength = 0x1000;
+        if (EpCompDesc != NULL) {
           //
-          // Do not support isochronous transfer now.
+          // 6.2.3.4, shall be set to the value defined in the bMaxBurst field of the SuperSpeed Endpoint Companion Descriptor.
           //
-          DEBUG ((DEBUG_INFO, "XhcPeiSetConfigCmd64: Unsupport ISO EP found, Transfer ring is not allocated.\n"));
-          EpDesc = (USB_ENDPOINT_DESCRIPTOR *)((UINTN)EpDesc + EpDesc->Length);
-          continue;
-        case USB_ENDPOINT_INTERRUPT:
-          if (Direction == EfiUsbDataIn) {
-            InputContext->EP[Dci-1].CErr   = 3;
-            InputContext->EP[Dci-1].EPType = ED_INTERRUPT_IN;
-          } else {
-            InputContext->EP[Dci-1].CErr   = 3;
-            InputContext->EP[Dci-1].EPType = ED_INTERRUPT_OUT;
-          }
-          InputContext->EP[Dci-1].AverageTRBLength = 0x1000;
-          InputContext->EP[Dci-1].MaxESITPayload   = EpDesc->MaxPacketSize;
+          InputContext->EP[Dci-1].MaxBurstSize = EpCompDesc->MaxBurst;
+          InputContext->EP[Dci-1].MaxPStreams  = XhcPeiCreateStreamRings (
+                                                   Xhc,
+                                                   SlotId,
+                                                   Dci,
+                                                   EpCompDesc->Attributes & USB_SS_ENDPOINT_MAX_STREAMS_MASK
+                                                   );
+        }
+
+        if ((InputContext->EP[Dci-1].MaxPStreams == 0) &&
+            (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] == NULL)) {
+          EndpointTransferRing = AllocateZeroPool (sizeof (TRANSFER_RING));
+          Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] = (VOID *) EndpointTransferRing;
+          XhcPeiCreateTransferRing (Xhc, TR_RING_TRB_NUMBER, (TRANSFER_RING *) Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1]);
+        }
+
+        break;
+      case USB_ENDPOINT_ISO:
+        if (Direction == EfiUsbDataIn) {
+          InputContext->EP[Dci-1].CErr   = 0;
+          InputContext->EP[Dci-1].EPType = ED_ISOCH_IN;
+        } else {
+          InputContext->EP[Dci-1].CErr   = 0;
+          InputContext->EP[Dci-1].EPType = ED_ISOCH_OUT;
+        }
+        //
+        // Get the bInterval from descriptor and init the the interval field of endpoint context.
+        // Refer to XHCI 1.1 spec section 6.2.3.6.
+        //
+        if (DeviceSpeed == EFI_USB_SPEED_FULL) {
+          Interval = EpDesc->Interval;
+          ASSERT (Interval >= 1 && Interval <= 16);
+          InputContext->EP[Dci-1].Interval = Interval + 2;
+        } else if ((DeviceSpeed == EFI_USB_SPEED_HIGH) || (DeviceSpeed == EFI_USB_SPEED_SUPER)) {
+          Interval = EpDesc->Interval;
+          ASSERT (Interval >= 1 && Interval <= 16);
+          InputContext->EP[Dci-1].Interval = Interval - 1;
+        }
+
+        //
+        // Do not support isochronous transfer now.
+        //
+        DEBUG ((DEBUG_INFO, "XhcPeiInitializeEndpointContext64: Unsupport ISO EP found, Transfer ring is not allocated.\n"));
+        EpDesc = (USB_ENDPOINT_DESCRIPTOR *)((UINTN)EpDesc + EpDesc->Length);
+        continue;
+      case USB_ENDPOINT_INTERRUPT:
+        if (Direction == EfiUsbDataIn) {
+          InputContext->EP[Dci-1].CErr   = 3;
+          InputContext->EP[Dci-1].EPType = ED_INTERRUPT_IN;
+        } else {
+          InputContext->EP[Dci-1].CErr   = 3;
+          InputContext->EP[Dci-1].EPType = ED_INTERRUPT_OUT;
+        }
+        InputContext->EP[Dci-1].AverageTRBLength = 0x1000;
+        InputContext->EP[Dci-1].MaxESITPayload   = EpDesc->MaxPacketSize;
+        //
+        // Get the bInterval from descriptor and init the interval field of endpoint context
+        //
+        if ((DeviceSpeed == EFI_USB_SPEED_FULL) || (DeviceSpeed == EFI_USB_SPEED_LOW)) {
+          Interval = EpDesc->Interval;
           //
-          // Get the bInterval from descriptor and init the the interval field of endpoint context
+          // Calculate through the bInterval field of Endpoint descriptor.
           //
-          if ((DeviceSpeed == EFI_USB_SPEED_FULL) || (DeviceSpeed == EFI_USB_SPEED_LOW)) {
-            Interval = EpDesc->Interval;
-            //
-            // Calculate through the bInterval field of Endpoint descriptor.
-            //
-            ASSERT (Interval != 0);
-            InputContext->EP[Dci-1].Interval = (UINT32) HighBitSet32( (UINT32) Interval) + 3;
-          } else if ((DeviceSpeed == EFI_USB_SPEED_HIGH) || (DeviceSpeed == EFI_USB_SPEED_SUPER)) {
-            Interval = EpDesc->Interval;
-            ASSERT (Interval >= 1 && Interval <= 16);
-            //
-            // Refer to XHCI 1.0 spec section 6.2.3.6, table 61
-            //
-            InputContext->EP[Dci-1].Interval = Interval - 1;
-          }
-
-          if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] == NULL) {
-            EndpointTransferRing = AllocateZeroPool (sizeof (TRANSFER_RING));
-            Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] = (VOID *) EndpointTransferRing;
-            XhcPeiCreateTransferRing (Xhc, TR_RING_TRB_NUMBER, (TRANSFER_RING *) Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1]);
-          }
-          break;
-
-        case USB_ENDPOINT_CONTROL:
+          ASSERT (Interval != 0);
+          InputContext->EP[Dci-1].Interval = (UINT32) HighBitSet32 ((UINT32) Interval) + 3;
+        } else if ((DeviceSpeed == EFI_USB_SPEED_HIGH) || (DeviceSpeed == EFI_USB_SPEED_SUPER)) {
+          Interval = EpDesc->Interval;
+          ASSERT (Interval >= 1 && Interval <= 16);
           //
-          // Do not support control transfer now.
+          // Refer to XHCI 1.0 spec section 6.2.3.6, table 61
           //
-          DEBUG ((DEBUG_INFO, "XhcPeiSetConfigCmd64: Unsupport Control EP found, Transfer ring is not allocated.\n"));
-        default:
-          DEBUG ((DEBUG_INFO, "XhcPeiSetConfigCmd64: Unknown EP found, Transfer ring is not allocated.\n"));
-          EpDesc = (USB_ENDPOINT_DESCRIPTOR *)((UINTN)EpDesc + EpDesc->Length);
-          continue;
-      }
+          InputContext->EP[Dci-1].Interval = Interval - 1;
+        }
+
+        if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] == NULL) {
+          EndpointTransferRing = AllocateZeroPool (sizeof (TRANSFER_RING));
+          Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] = (VOID *) EndpointTransferRing;
+          XhcPeiCreateTransferRing (Xhc, TR_RING_TRB_NUMBER, (TRANSFER_RING *) Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1]);
+        }
+        break;
 
+      case USB_ENDPOINT_CONTROL:
+        //
+        // Do not support control transfer now.
+        //
+        DEBUG ((DEBUG_INFO, "XhcPeiInitializeEndpointContext64: Unsupport Control EP found, Transfer ring is not allocated.\n"));
+      default:
+        DEBUG ((DEBUG_INFO, "XhcPeiInitializeEndpointContext64: Unknown EP found, Transfer ring is not allocated.\n"));
+        EpDesc = (USB_ENDPOINT_DESCRIPTOR *)((UINTN)EpDesc + EpDesc->Length);
+        continue;
+    }
+
+    if (InputContext->EP[Dci-1].MaxPStreams != 0) {
+      //
+      // The TR Dequeue Pointer of an endpoint with streams points to its Primary Stream Context Array
+      //
+      InputContext->EP[Dci-1].LSA = 1;
+      PhyAddr = UsbHcGetPciAddrForHostAddr (
+                  Xhc->MemPool,
+                  Xhc->UsbDevContext[SlotId].StreamContextArray[Dci-1],
+                  sizeof (STREAM_CONTEXT) * XHC_STREAM_ARRAY_SIZE
+                  );
+    } else {
       PhyAddr = UsbHcGetPciAddrForHostAddr (
                   Xhc->MemPool,
                   ((TRANSFER_RING *) (UINTN) Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1])->RingSeg0,
                   sizeof (TRB_TEMPLATE) * TR_RING_TRB_NUMBER
                   );
-
       PhyAddr &= ~((EFI_PHYSICAL_ADDRESS)0x0F);
       PhyAddr |= (EFI_PHYSICAL_ADDRESS)((TRANSFER_RING *) (UINTN) Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1])->RingPCS;
+    }
+    InputContext->EP[Dci-1].PtrLo = XHC_LOW_32BIT (PhyAddr);
+    InputContext->EP[Dci-1].PtrHi = XHC_HIGH_32BIT (PhyAddr);
+
+    EpDesc = (USB_ENDPOINT_DESCRIPTOR *) ((UINTN) EpDesc + EpDesc->Length);
+  }
+
+  return MaxDci;
+}
+
+/**
+  Configure all the device endpoints through XHCI's Configure_Endpoint cmd.
+
+  @param  Xhc           The XHCI device.
+  @param  SlotId        The slot id to be configured.
+  @param  DeviceSpeed   The device's speed.
+  @param  ConfigDesc    The pointer to the usb device configuration descriptor.
+
+  @retval EFI_SUCCESS   Successfully configure all the device endpoints.
+
+**/
+EFI_STATUS
+XhcPeiSetConfigCmd64 (
+  IN PEI_XHC_DEV                *Xhc,
+  IN UINT8                      SlotId,
+  IN UINT8                      DeviceSpeed,
+  IN USB_CONFIG_DESCRIPTOR      *ConfigDesc
+  )
+{
+  EFI_STATUS                    Status;
+  USB_INTERFACE_DESCRIPTOR      *IfDesc;
+  UINT8                         Index;
+  UINT8                         Dci;
+  UINT8                         MaxDci;
+  EFI_PHYSICAL_ADDRESS          PhyAddr;
+
+  CMD_TRB_CONFIG_ENDPOINT       CmdTrbCfgEP;
+  INPUT_CONTEXT_64              *InputContext;
+  DEVICE_CONTEXT_64             *OutputContext;
+  EVT_TRB_COMMAND_COMPLETION    *EvtTrb;
+  //
+  // 4.6.6 Configure Endpoint
+  //
+  InputContext  = Xhc->UsbDevContext[SlotId].InputContext;
+  OutputContext = Xhc->UsbDevContext[SlotId].OutputContext;
+  ZeroMem (InputContext, sizeof (INPUT_CONTEXT_64));
+  CopyMem (&InputContext->Slot, &OutputContext->Slot, sizeof (SLOT_CONTEXT_64));
+
+  ASSERT (ConfigDesc != NULL);
 
-      InputContext->EP[Dci-1].PtrLo = XHC_LOW_32BIT (PhyAddr);
-      InputContext->EP[Dci-1].PtrHi = XHC_HIGH_32BIT (PhyAddr);
+  MaxDci = 0;
+
+  IfDesc = (USB_INTERFACE_DESCRIPTOR *) (ConfigDesc + 1);
+  for (Index = 0; Index < ConfigDesc->NumInterfaces; Index++) {
+    while ((IfDesc->DescriptorType != USB_DESC_TYPE_INTERFACE) || (IfDesc->AlternateSetting != 0)) {
+      IfDesc = (USB_INTERFACE_DESCRIPTOR *) ((UINTN) IfDesc + IfDesc->Length);
+    }
 
-      EpDesc = (USB_ENDPOINT_DESCRIPTOR *) ((UINTN)EpDesc + EpDesc->Length);
+    Dci = XhcPeiInitializeEndpointContext64 (Xhc, SlotId, DeviceSpeed, InputContext, ConfigDesc, IfDesc);
+    if (Dci > MaxDci) {
+      MaxDci = Dci;
     }
-    IfDesc = (USB_INTERFACE_DESCRIPTOR *) ((UINTN)IfDesc + IfDesc->Length);
+
+    IfDesc = (USB_INTERFACE_DESCRIPTOR *) ((UINTN) IfDesc + IfDesc->Length);
   }
 
   InputContext->InputControlContext.Dword2 |= BIT0;
@@ -2077,7 +2680,7 @@ XhcPeiSetConfigCmd64 (
   // configure endpoint
   //
   ZeroMem (&CmdTrbCfgEP, sizeof (CmdTrbCfgEP));
-  PhyAddr  = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, InputContext, sizeof (INPUT_CONTEXT_64));
+  PhyAddr = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, InputContext, sizeof (INPUT_CONTEXT_64));
   CmdTrbCfgEP.PtrLo    = XHC_LOW_32BIT (PhyAddr);
   CmdTrbCfgEP.PtrHi    = XHC_HIGH_32BIT (PhyAddr);
   CmdTrbCfgEP.CycleBit = 1;
@@ -2093,10 +2696,154 @@ XhcPeiSetConfigCmd64 (
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "XhcSetConfigCmd64: Config Endpoint Failed, Status = %r\n", Status));
   }
-
   return Status;
 }
 
+/**
+  Set an alternate setting of an interface through XHCI's Configure_Endpoint cmd.
+
+  The endpoints of the active alternate setting are dropped and the endpoints
+  of the new alternate setting are added in a single command.
+
+  @param  Xhc           The XHCI device.
+  @param  SlotId        The slot id to be configured.
+  @param  DeviceSpeed   The device's speed.
+  @param  ConfigDesc    The pointer to the active usb device configuration descriptor.
+  @param  Request       The Set_Interface usb device request.
+
+  @retval EFI_SUCCESS   Successfully set the alternate setting.
+  @retval EFI_NOT_FOUND The interface or the alternate setting is not found.
+
+**/
+EFI_STATUS
+XhcPeiSetInterface64 (
+  IN PEI_XHC_DEV                *Xhc,
+  IN UINT8                      SlotId,
+  IN UINT8                      DeviceSpeed,
+  IN USB_CONFIG_DESCRIPTOR      *ConfigDesc,
+  IN EFI_USB_DEVICE_REQUEST     *Request
+  )
+{
+  EFI_STATUS                    Status;
+  USB_INTERFACE_DESCRIPTOR      *IfDesc;
+  USB_INTERFACE_DESCRIPTOR      *IfDescActive;
+  USB_INTERFACE_DESCRIPTOR      *IfDescSet;
+  USB_ENDPOINT_DESCRIPTOR       *EpDesc;
+  UINTN                         NumEp;
+  UINTN                         EpIndex;
+  UINT8                         EpAddr;
+  EFI_USB_DATA_DIRECTION        Direction;
+  UINT8                         Dci;
+  UINT8                         MaxDci;
+  UINT8                         InterfaceNumber;
+  EFI_PHYSICAL_ADDRESS          PhyAddr;
+
+  CMD_TRB_CONFIG_ENDPOINT       CmdTrbCfgEP;
+  INPUT_CONTEXT_64              *InputContext;
+  DEVICE_CONTEXT_64             *OutputContext;
+  EVT_TRB_COMMAND_COMPLETION    *EvtTrb;
+
+  ASSERT (ConfigDesc != NULL);
+
+  InterfaceNumber = (UINT8) Request->Index;
+  if (InterfaceNumber >= XHC_MAX_INTERFACE) {
+    return EFI_NOT_FOUND;
+  }
+
+  //
+  // Find the interface descriptors of the active and the requested alternate setting
+  //
+  IfDescActive = NULL;
+  IfDescSet    = NULL;
+  IfDesc       = (USB_INTERFACE_DESCRIPTOR *) (ConfigDesc + 1);
+  while (((UINTN) IfDesc + sizeof (USB_INTERFACE_DESCRIPTOR) <= (UINTN) ConfigDesc + ConfigDesc->TotalLength) &&
+         (IfDesc->Length != 0)) {
+    if ((IfDesc->DescriptorType == USB_DESC_TYPE_INTERFACE) && (IfDesc->InterfaceNumber == InterfaceNumber)) {
+      if (IfDesc->AlternateSetting == Xhc->UsbDevContext[SlotId].ActiveAlternateSetting[InterfaceNumber]) {
+        IfDescActive = IfDesc;
+      }
+      if (IfDesc->AlternateSetting == (UINT8) Request->Value) {
+        IfDescSet = IfDesc;
+      }
+    }
+    IfDesc = (USB_INTERFACE_DESCRIPTOR *) ((UINTN) IfDesc + IfDesc->Length);
+  }
+
+  if ((IfDescActive == NULL) || (IfDescSet == NULL)) {
+    return EFI_NOT_FOUND;
+  }
+
+  if (IfDescActive == IfDescSet) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // 4.6.6.1 Configure Endpoint for an alternate interface setting
+  //
+  InputContext  = Xhc->UsbDevContext[SlotId].InputContext;
+  OutputContext = Xhc->UsbDevContext[SlotId].OutputContext;
+  ZeroMem (InputContext, sizeof (INPUT_CONTEXT_64));
+  CopyMem (&InputContext->Slot, &OutputContext->Slot, sizeof (SLOT_CONTEXT_64));
+
+  NumEp  = IfDescActive->NumEndpoints;
+  EpDesc = (USB_ENDPOINT_DESCRIPTOR *) (IfDescActive + 1);
+  for (EpIndex = 0; EpIndex < NumEp; EpIndex++) {
+    while (EpDesc->DescriptorType != USB_DESC_TYPE_ENDPOINT) {
+      EpDesc = (USB_ENDPOINT_DESCRIPTOR *) ((UINTN) EpDesc + EpDesc->Length);
+    }
+
+    EpAddr    = (UINT8) (EpDesc->EndpointAddress & 0x0F);
+    Direction = (UINT8) ((EpDesc->EndpointAddress & 0x80) ? EfiUsbDataIn : EfiUsbDataOut);
+
+    Dci = XhcPeiEndpointToDci (EpAddr, Direction);
+    ASSERT (Dci < 32);
+
+    //
+    // Stop the running endpoint of the active setting before dropping it
+    //
+    if (OutputContext->EP[Dci-1].EPState == EP_STATE_RUNNING) {
+      Status = XhcPeiStopEndpoint (Xhc, SlotId, Dci);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    }
+
+    XhcPeiFreeEndpointRings (Xhc, SlotId, Dci);
+    InputContext->InputControlContext.Dword1 |= (BIT0 << Dci);
+
+    EpDesc = (USB_ENDPOINT_DESCRIPTOR *) ((UINTN) EpDesc + EpDesc->Length);
+  }
+
+  MaxDci = XhcPeiInitializeEndpointContext64 (Xhc, SlotId, DeviceSpeed, InputContext, ConfigDesc, IfDescSet);
+
+  InputContext->InputControlContext.Dword2 |= BIT0;
+  if (MaxDci > InputContext->Slot.ContextEntries) {
+    InputContext->Slot.ContextEntries = MaxDci;
+  }
+  //
+  // configure endpoint
+  //
+  ZeroMem (&CmdTrbCfgEP, sizeof (CmdTrbCfgEP));
+  PhyAddr = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, InputContext, sizeof (INPUT_CONTEXT_64));
+  CmdTrbCfgEP.PtrLo    = XHC_LOW_32BIT (PhyAddr);
+  CmdTrbCfgEP.PtrHi    = XHC_HIGH_32BIT (PhyAddr);
+  CmdTrbCfgEP.CycleBit = 1;
+  CmdTrbCfgEP.Type     = TRB_TYPE_CON_ENDPOINT;
+  CmdTrbCfgEP.SlotId   = Xhc->UsbDevContext[SlotId].SlotId;
+  DEBUG ((DEBUG_INFO, "XhcPeiSetInterface64: Configure Endpoint\n"));
+  Status = XhcPeiCmdTransfer (
+             Xhc,
+             (TRB_TEMPLATE *) (UINTN) &CmdTrbCfgEP,
+             XHC_GENERIC_TIMEOUT,
+             (TRB_TEMPLATE **) (UINTN) &EvtTrb
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "XhcPeiSetInterface64: Config Endpoint Failed, Status = %r\n", Status));
+  } else {
+    Xhc->UsbDevContext[SlotId].ActiveAlternateSetting[InterfaceNumber] = IfDescSet->AlternateSetting;
+  }
+  return Status;
+}
 
 /**
   Evaluate the endpoint 0 context through XHCI's Evaluate_Context cmd.
@@ -2470,6 +3217,13 @@ XhcPeiSetTrDequeuePointer (
   PhyAddr = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, Urb->Ring->RingEnqueue, sizeof (CMD_SET_TR_DEQ_POINTER));
   CmdSetTRDeq.PtrLo    = XHC_LOW_32BIT (PhyAddr) | Urb->Ring->RingPCS;
   CmdSetTRDeq.PtrHi    = XHC_HIGH_32BIT (PhyAddr);
+  if (Urb->StreamId != 0) {
+    //
+    // The Stream Context Type field is only used when updating a stream
+    //
+    CmdSetTRDeq.PtrLo   |= SCT_PRIMARY_TRB_RING << 1;
+    CmdSetTRDeq.StreamID = Urb->StreamId;
+  }
   CmdSetTRDeq.CycleBit = 1;
   CmdSetTRDeq.Type     = TRB_TYPE_SET_TR_DEQUE;
   CmdSetTRDeq.Endpoint = Dci;
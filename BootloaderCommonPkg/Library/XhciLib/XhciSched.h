@@ -1,7 +1,7 @@
 /** @file
 Private Header file for Usb Host Controller PEIM
 
-Copyright (c) 2014 - 2015, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2014 - 2026, Intel Corporation. All rights reserved.<BR>
 
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -59,6 +59,20 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define ED_BULK_IN                              6
 #define ED_INTERRUPT_IN                         7
 
+//
+// 6.2.3 Endpoint Context, EP State
+//
+#define EP_STATE_DISABLED                       0
+#define EP_STATE_RUNNING                        1
+#define EP_STATE_HALTED                         2
+#define EP_STATE_STOPPED                        3
+#define EP_STATE_ERROR                          4
+
+//
+// 6.2.4.1 Stream Context Type
+//
+#define SCT_PRIMARY_TRB_RING                    1
+
 //
 // 6.4.5 TRB Completion Codes
 //
@@ -160,6 +174,7 @@ typedef struct _URB {
   // Usb Device URB related information
   //
   USB_ENDPOINT                      Ep;
+  UINT16                            StreamId;
   EFI_USB_DEVICE_REQUEST            *Request;
   VOID                              *Data;
   UINTN                             DataLen;
@@ -185,6 +200,10 @@ typedef struct _URB {
   BOOLEAN                           StartDone;
   BOOLEAN                           EndDone;
   BOOLEAN                           Finished;
+  //
+  // Whether the URB is not waited for when executed in a list
+  //
+  BOOLEAN                           Optional;
 
   TRB_TEMPLATE                      *EvtTrb;
 } URB;
@@ -690,6 +709,17 @@ typedef struct _ENDPOINT_CONTEXT_64 {
 
 } ENDPOINT_CONTEXT_64;
 
+//
+// 6.2.4 Stream Context
+//
+typedef struct _STREAM_CONTEXT {
+  UINT32                    PtrLo;
+  UINT32                    PtrHi;
+  UINT32                    StoppedEDTLA:24;
+  UINT32                    RsvdZ1:8;
+  UINT32                    RsvdZ2;
+} STREAM_CONTEXT;
+
 
 //
 // 6.2.5.1 Input Control Context
@@ -773,6 +803,27 @@ XhcPeiExecTransfer (
   IN UINTN                  Timeout
   );
 
+/**
+  Execute a list of transfers by polling the URBs. This is a synchronous operation.
+
+  @param  Xhc               The XHCI device.
+  @param  UrbList           The URBs to execute.
+  @param  UrbCount          The number of URBs in the list.
+  @param  Timeout           The time to wait before abort, in millisecond.
+
+  @return EFI_DEVICE_ERROR  A transfer failed due to transfer error.
+  @return EFI_TIMEOUT       A transfer failed due to time out.
+  @return EFI_SUCCESS       All the required transfers finished OK.
+
+**/
+EFI_STATUS
+XhcPeiExecTransferList (
+  IN PEI_XHC_DEV            *Xhc,
+  IN URB                    **UrbList,
+  IN UINTN                  UrbCount,
+  IN UINTN                  Timeout
+  );
+
 /**
   Find out the actual device address according to the requested device address from UsbBus.
 
@@ -833,6 +884,23 @@ XhcPeiRingDoorBell (
   IN UINT8              Dci
   );
 
+/**
+  Ring the door bell of a stream of an endpoint to notify XHCI there is a transaction to be executed.
+
+  @param  Xhc           The XHCI device.
+  @param  SlotId        The slot id of the target device.
+  @param  Dci           The device context index of the target endpoint.
+  @param  StreamId      The stream id of the target endpoint, 0 if the endpoint has no streams.
+
+**/
+VOID
+XhcPeiRingStreamDoorBell (
+  IN PEI_XHC_DEV        *Xhc,
+  IN UINT8              SlotId,
+  IN UINT8              Dci,
+  IN UINT16             StreamId
+  );
+
 /**
   Monitor the port status change. Enable/Disable device slot if there is a device attached/detached.
 
@@ -933,6 +1001,66 @@ XhcPeiSetConfigCmd64 (
   IN USB_CONFIG_DESCRIPTOR      *ConfigDesc
   );
 
+/**
+  Set an alternate setting of an interface through XHCI's Configure_Endpoint cmd.
+
+  @param  Xhc           The XHCI device.
+  @param  SlotId        The slot id to be configured.
+  @param  DeviceSpeed   The device's speed.
+  @param  ConfigDesc    The pointer to the active usb device configuration descriptor.
+  @param  Request       The Set_Interface usb device request.
+
+  @retval EFI_SUCCESS   Successfully set the alternate setting.
+  @retval EFI_NOT_FOUND The interface or the alternate setting is not found.
+
+**/
+EFI_STATUS
+XhcPeiSetInterface (
+  IN PEI_XHC_DEV                *Xhc,
+  IN UINT8                      SlotId,
+  IN UINT8                      DeviceSpeed,
+  IN USB_CONFIG_DESCRIPTOR      *ConfigDesc,
+  IN EFI_USB_DEVICE_REQUEST     *Request
+  );
+
+/**
+  Set an alternate setting of an interface through XHCI's Configure_Endpoint cmd.
+
+  @param  Xhc           The XHCI device.
+  @param  SlotId        The slot id to be configured.
+  @param  DeviceSpeed   The device's speed.
+  @param  ConfigDesc    The pointer to the active usb device configuration descriptor.
+  @param  Request       The Set_Interface usb device request.
+
+  @retval EFI_SUCCESS   Successfully set the alternate setting.
+  @retval EFI_NOT_FOUND The interface or the alternate setting is not found.
+
+**/
+EFI_STATUS
+XhcPeiSetInterface64 (
+  IN PEI_XHC_DEV                *Xhc,
+  IN UINT8                      SlotId,
+  IN UINT8                      DeviceSpeed,
+  IN USB_CONFIG_DESCRIPTOR      *ConfigDesc,
+  IN EFI_USB_DEVICE_REQUEST     *Request
+  );
+
+/**
+  Free the transfer rings of an endpoint, including the stream rings and the
+  stream context array of a bulk endpoint with streams.
+
+  @param  Xhc           The XHCI device.
+  @param  SlotId        The slot id of the device.
+  @param  Dci           The device context index of the endpoint.
+
+**/
+VOID
+XhcPeiFreeEndpointRings (
+  IN PEI_XHC_DEV                *Xhc,
+  IN UINT8                      SlotId,
+  IN UINT8                      Dci
+  );
+
 /**
   Stop endpoint through XHCI's Stop_Endpoint cmd.
 
@@ -1146,6 +1274,7 @@ XhcPeiDequeueTrbFromEndpoint (
   @param  Xhc       The XHCI device
   @param  DevAddr   The device address
   @param  EpAddr    Endpoint addrress
+  @param  StreamId  The stream id of a bulk endpoint with streams, 0 if none
   @param  DevSpeed  The device speed
   @param  MaxPacket The max packet length of the endpoint
   @param  Type      The transaction type
@@ -1163,6 +1292,7 @@ XhcPeiCreateUrb (
   IN PEI_XHC_DEV                        *Xhc,
   IN UINT8                              DevAddr,
   IN UINT8                              EpAddr,
+  IN UINT16                             StreamId,
   IN UINT8                              DevSpeed,
   IN UINTN                              MaxPacket,
   IN UINTN                              Type,
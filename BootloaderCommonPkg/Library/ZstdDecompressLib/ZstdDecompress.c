@@ -0,0 +1,878 @@
+/** @file
+  Zstandard decompression of a single frame into a flat buffer.
+
+  The decoder follows the Zstandard Compression Format, RFC 8878. As the whole
+  frame is decoded into the destination buffer, matches refer to the previous
+  output directly and no window buffer is needed. Dictionaries are not
+  supported and the optional content checksum is not verified, as components
+  are authenticated by the container.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "ZstdDecompressLibInternal.h"
+
+//
+// Baseline and number of extra bits of the literal length codes
+//
+STATIC CONST UINT32  mLitLengthBase[ZSTD_LL_SYMBOL_MAX + 1] = {
+  0,     1,     2,     3,     4,     5,     6,     7,
+  8,     9,     10,    11,    12,    13,    14,    15,
+  16,    18,    20,    22,    24,    28,    32,    40,
+  48,    64,    128,   256,   512,   1024,  2048,  4096,
+  8192,  16384, 32768, 65536
+};
+
+STATIC CONST UINT8   mLitLengthBits[ZSTD_LL_SYMBOL_MAX + 1] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 2, 2, 3, 3, 4, 6, 7, 8, 9, 10, 11, 12,
+  13, 14, 15, 16
+};
+
+//
+// Baseline and number of extra bits of the match length codes
+//
+STATIC CONST UINT32  mMatchLengthBase[ZSTD_ML_SYMBOL_MAX + 1] = {
+  3,     4,     5,     6,     7,     8,     9,     10,
+  11,    12,    13,    14,    15,    16,    17,    18,
+  19,    20,    21,    22,    23,    24,    25,    26,
+  27,    28,    29,    30,    31,    32,    33,    34,
+  35,    37,    39,    41,    43,    47,    51,    59,
+  67,    83,    99,    131,   259,   515,   1027,  2051,
+  4099,  8195,  16387, 32771, 65539
+};
+
+STATIC CONST UINT8   mMatchLengthBits[ZSTD_ML_SYMBOL_MAX + 1] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 2, 2, 3, 3, 4, 4, 5, 7, 8, 9, 10, 11,
+  12, 13, 14, 15, 16
+};
+
+//
+// Predefined distributions
+//
+STATIC CONST INT16   mLitLengthDefaultNorm[ZSTD_LL_SYMBOL_MAX + 1] = {
+  4, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 1, 1, 1, 1, 1,
+  -1, -1, -1, -1
+};
+
+STATIC CONST INT16   mMatchLengthDefaultNorm[ZSTD_ML_SYMBOL_MAX + 1] = {
+  1, 4, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1,
+  -1, -1, -1, -1, -1
+};
+
+STATIC CONST INT16   mOffsetDefaultNorm[29] = {
+  1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1
+};
+
+typedef struct {
+  UINT32          FrameHeaderSize;
+  UINT64          ContentSize;
+  BOOLEAN         HasChecksum;
+} ZSTD_FRAME_INFO;
+
+/**
+  Parse the header of a Zstandard frame.
+
+  @param[in]  Src         The frame.
+  @param[in]  SrcSize     The size of the source buffer.
+  @param[out] Info        The frame information.
+
+  @retval RETURN_SUCCESS            The header was parsed.
+  @retval RETURN_INVALID_PARAMETER  The header is corrupted.
+  @retval RETURN_UNSUPPORTED        The frame has no content size or needs
+                                    a dictionary.
+**/
+STATIC
+RETURN_STATUS
+ZstdParseFrameHeader (
+  IN  CONST UINT8       *Src,
+  IN  UINTN              SrcSize,
+  OUT ZSTD_FRAME_INFO   *Info
+  )
+{
+  UINT8    Descriptor;
+  UINT32   ContentSizeFlag;
+  UINT32   DictIdFlag;
+  BOOLEAN  SingleSegment;
+  UINT32   Offset;
+  UINT32   Index;
+  UINT32   FieldSize;
+  UINT64   Value;
+
+  if ((SrcSize < 5) || (ReadUnaligned32 ((CONST UINT32 *)Src) != ZSTD_MAGIC_NUMBER)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Descriptor      = Src[4];
+  ContentSizeFlag = Descriptor >> 6;
+  SingleSegment   = (BOOLEAN)((Descriptor & BIT5) != 0);
+  DictIdFlag      = Descriptor & 0x03;
+  if ((Descriptor & BIT3) != 0) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Offset = 5;
+  if (!SingleSegment) {
+    // Window_Descriptor, not needed when decoding into a flat buffer
+    Offset++;
+  }
+
+  FieldSize = (DictIdFlag == 3) ? 4 : DictIdFlag;
+  if (Offset + FieldSize > SrcSize) {
+    return RETURN_INVALID_PARAMETER;
+  }
+  for (Index = 0; Index < FieldSize; Index++) {
+    if (Src[Offset + Index] != 0) {
+      return RETURN_UNSUPPORTED;
+    }
+  }
+  Offset += FieldSize;
+
+  if (ContentSizeFlag == 0) {
+    if (!SingleSegment) {
+      return RETURN_UNSUPPORTED;
+    }
+    FieldSize = 1;
+  } else {
+    FieldSize = 1U << ContentSizeFlag;
+  }
+  if (Offset + FieldSize > SrcSize) {
+    return RETURN_INVALID_PARAMETER;
+  }
+  Value = 0;
+  for (Index = 0; Index < FieldSize; Index++) {
+    Value |= LShiftU64 (Src[Offset + Index], Index * 8);
+  }
+  if (FieldSize == 2) {
+    Value += 256;
+  }
+  Offset += FieldSize;
+
+  Info->FrameHeaderSize = Offset;
+  Info->ContentSize     = Value;
+  Info->HasChecksum     = (BOOLEAN)((Descriptor & BIT2) != 0);
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decode the literals section of a compressed block.
+
+  @param[in, out] Workspace   The decoder workspace.
+  @param[in]      Src         The compressed block.
+  @param[in]      SrcSize     The size of the compressed block.
+  @param[out]     Literals    The decoded literals, in the workspace.
+  @param[out]     LiteralSize The number of literals.
+  @param[out]     ReadSize    The size of the literals section.
+
+  @retval RETURN_SUCCESS            The literals were decoded.
+  @retval RETURN_INVALID_PARAMETER  The literals section is corrupted.
+**/
+STATIC
+RETURN_STATUS
+ZstdDecodeLiterals (
+  IN OUT ZSTD_WORKSPACE  *Workspace,
+  IN     CONST UINT8     *Src,
+  IN     UINTN            SrcSize,
+  OUT    CONST UINT8    **Literals,
+  OUT    UINTN           *LiteralSize,
+  OUT    UINTN           *ReadSize
+  )
+{
+  RETURN_STATUS   Status;
+  UINT32          Type;
+  UINT32          SizeFormat;
+  UINT32          HeaderSize;
+  UINT32          SizeBits;
+  UINT64          Header;
+  UINTN           RegenSize;
+  UINTN           CompSize;
+  UINTN           TreeSize;
+  UINTN           Index;
+
+  if (SrcSize == 0) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Type       = Src[0] & 0x03;
+  SizeFormat = (Src[0] >> 2) & 0x03;
+
+  if ((Type == ZSTD_LITERALS_TYPE_RAW) || (Type == ZSTD_LITERALS_TYPE_RLE)) {
+    if ((SizeFormat & 1) == 0) {
+      HeaderSize = 1;
+      RegenSize  = Src[0] >> 3;
+    } else if (SizeFormat == 1) {
+      HeaderSize = 2;
+      if (SrcSize < HeaderSize) {
+        return RETURN_INVALID_PARAMETER;
+      }
+      RegenSize  = (Src[0] >> 4) + ((UINTN)Src[1] << 4);
+    } else {
+      HeaderSize = 3;
+      if (SrcSize < HeaderSize) {
+        return RETURN_INVALID_PARAMETER;
+      }
+      RegenSize  = (Src[0] >> 4) + ((UINTN)Src[1] << 4) + ((UINTN)Src[2] << 12);
+    }
+    if (RegenSize > ZSTD_BLOCK_SIZE_MAX) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    //
+    // Raw literals are copied too, so that the literals can always be read in
+    // chunks past their end
+    //
+    if (Type == ZSTD_LITERALS_TYPE_RAW) {
+      if (HeaderSize + RegenSize > SrcSize) {
+        return RETURN_INVALID_PARAMETER;
+      }
+      CopyMem (Workspace->Literals, Src + HeaderSize, RegenSize);
+      *ReadSize = HeaderSize + RegenSize;
+    } else {
+      if (HeaderSize + 1 > SrcSize) {
+        return RETURN_INVALID_PARAMETER;
+      }
+      SetMem (Workspace->Literals, RegenSize, Src[HeaderSize]);
+      *ReadSize = HeaderSize + 1;
+    }
+    *Literals    = Workspace->Literals;
+    *LiteralSize = RegenSize;
+    return RETURN_SUCCESS;
+  }
+
+  //
+  // Huffman compressed literals: 3 to 5 header bytes hold both sizes
+  //
+  HeaderSize = (SizeFormat < 2) ? 3 : (SizeFormat + 2);
+  SizeBits   = (SizeFormat < 2) ? 10 : (SizeFormat * 4 + 6);
+  if (SrcSize < HeaderSize) {
+    return RETURN_INVALID_PARAMETER;
+  }
+  Header = 0;
+  for (Index = 0; Index < HeaderSize; Index++) {
+    Header |= LShiftU64 (Src[Index], Index * 8);
+  }
+  RegenSize = (UINTN)RShiftU64 (Header, 4) & ((1U << SizeBits) - 1);
+  CompSize  = (UINTN)RShiftU64 (Header, 4 + SizeBits) & ((1U << SizeBits) - 1);
+  if ((RegenSize > ZSTD_BLOCK_SIZE_MAX) || (HeaderSize + CompSize > SrcSize)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+  Src += HeaderSize;
+
+  TreeSize = 0;
+  if (Type == ZSTD_LITERALS_TYPE_COMPRESSED) {
+    Status = ZstdReadHufTable (Workspace, Src, CompSize, &TreeSize);
+    if (RETURN_ERROR (Status)) {
+      Workspace->Huf.TableLog = 0;
+      return Status;
+    }
+  } else if (Workspace->Huf.TableLog == 0) {
+    // Treeless literals need the table of a previous block
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Status = ZstdDecodeHufLiterals (&Workspace->Huf, Src + TreeSize, CompSize - TreeSize,
+                                  Workspace->Literals, RegenSize, (BOOLEAN)(SizeFormat != 0));
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  *Literals    = Workspace->Literals;
+  *LiteralSize = RegenSize;
+  *ReadSize    = HeaderSize + CompSize;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Set up the decoding table of one sequence field.
+
+  @param[in, out] Table         The decoding table.
+  @param[in]      Mode          The symbol compression mode.
+  @param[in]      Src           The table description.
+  @param[in]      SrcSize       The size of the source buffer.
+  @param[in]      DefaultNorm   The predefined distribution.
+  @param[in]      DefaultCount  The number of symbols of DefaultNorm.
+  @param[in]      DefaultLog    The accuracy log of DefaultNorm.
+  @param[in]      MaxSymbol     The largest symbol allowed.
+  @param[in]      MaxLog        The largest accuracy log allowed.
+  @param[out]     ReadSize      The size of the table description.
+
+  @retval RETURN_SUCCESS            The table is ready.
+  @retval RETURN_INVALID_PARAMETER  The description is corrupted.
+**/
+STATIC
+RETURN_STATUS
+ZstdSetupSequenceTable (
+  IN OUT ZSTD_FSE_TABLE   *Table,
+  IN     UINT32            Mode,
+  IN     CONST UINT8      *Src,
+  IN     UINTN             SrcSize,
+  IN     CONST INT16      *DefaultNorm,
+  IN     UINT32            DefaultCount,
+  IN     UINT32            DefaultLog,
+  IN     UINT32            MaxSymbol,
+  IN     UINT32            MaxLog,
+  OUT    UINTN            *ReadSize
+  )
+{
+  RETURN_STATUS   Status;
+
+  *ReadSize = 0;
+  switch (Mode) {
+  case ZSTD_SEQ_MODE_PREDEFINED:
+    return ZstdBuildFseTable (Table, DefaultNorm, DefaultCount, DefaultLog);
+
+  case ZSTD_SEQ_MODE_RLE:
+    if ((SrcSize == 0) || (Src[0] > MaxSymbol)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    ZstdBuildRleTable (Table, Src[0]);
+    *ReadSize = 1;
+    return RETURN_SUCCESS;
+
+  case ZSTD_SEQ_MODE_FSE:
+    Status = ZstdReadFseTable (Table, Src, SrcSize, MaxSymbol, MaxLog, ReadSize);
+    if (RETURN_ERROR (Status)) {
+      Table->Valid = FALSE;
+    }
+    return Status;
+
+  default:
+    return Table->Valid ? RETURN_SUCCESS : RETURN_INVALID_PARAMETER;
+  }
+}
+
+/**
+  Copy a buffer in 16-byte chunks, writing up to 15 bytes past its end.
+
+  The chunks are copied in order, so the source may overlap the destination
+  as long as it starts at least 16 bytes before it. IA32 and X64 allow the
+  unaligned accesses.
+
+  @param[out] Dst         The destination buffer.
+  @param[in]  Src         The source buffer.
+  @param[in]  Length      The number of bytes to copy.
+**/
+STATIC
+VOID
+ZstdWildCopy (
+  OUT UINT8         *Dst,
+  IN  CONST UINT8   *Src,
+  IN  UINTN          Length
+  )
+{
+  UINT8   *DstEnd;
+
+  DstEnd = Dst + Length;
+  while (Dst < DstEnd) {
+    ((UINT64 *)Dst)[0] = ((CONST UINT64 *)Src)[0];
+    ((UINT64 *)Dst)[1] = ((CONST UINT64 *)Src)[1];
+    Dst += ZSTD_WILDCOPY_CHUNK;
+    Src += ZSTD_WILDCOPY_CHUNK;
+  }
+}
+
+/**
+  Copy a match from the previous output. The source and the destination
+  overlap when the offset is smaller than the length.
+
+  @param[out] Dst         The output position.
+  @param[in]  Offset      The distance back to the match.
+  @param[in]  Length      The length of the match.
+**/
+STATIC
+VOID
+ZstdCopyMatch (
+  OUT UINT8     *Dst,
+  IN  UINTN      Offset,
+  IN  UINTN      Length
+  )
+{
+  CONST UINT8   *Src;
+
+  Src = Dst - Offset;
+  if (Offset >= Length) {
+    CopyMem (Dst, Src, Length);
+    return;
+  }
+
+  //
+  // Copy whole periods of the repeated pattern, growing it each time
+  //
+  if (Offset >= 8) {
+    while (Length > Offset) {
+      CopyMem (Dst, Src, Offset);
+      Dst    += Offset;
+      Length -= Offset;
+      Offset += Offset;
+    }
+    CopyMem (Dst, Dst - Offset, Length);
+    return;
+  }
+
+  while (Length-- > 0) {
+    *Dst++ = *Src++;
+  }
+}
+
+/**
+  Decode and execute the sequences section of a compressed block.
+
+  @param[in, out] Workspace   The decoder workspace.
+  @param[in]      Src         The sequences section.
+  @param[in]      SrcSize     The size of the sequences section.
+  @param[in]      Literals    The literals of the block.
+  @param[in]      LiteralSize The number of literals.
+  @param[in]      Base        The start of the frame output.
+  @param[in, out] Dst         The output position, updated on return.
+  @param[in]      DstEnd      The end of the output buffer.
+
+  @retval RETURN_SUCCESS            The sequences were executed.
+  @retval RETURN_INVALID_PARAMETER  The sequences section is corrupted.
+**/
+STATIC
+RETURN_STATUS
+ZstdExecuteSequences (
+  IN OUT ZSTD_WORKSPACE  *Workspace,
+  IN     CONST UINT8     *Src,
+  IN     UINTN            SrcSize,
+  IN     CONST UINT8     *Literals,
+  IN     UINTN            LiteralSize,
+  IN     UINT8           *Base,
+  IN OUT UINT8          **Dst,
+  IN     UINT8           *DstEnd
+  )
+{
+  RETURN_STATUS           Status;
+  ZSTD_BIT_READER         Reader;
+  CONST ZSTD_FSE_ENTRY   *LlEntry;
+  CONST ZSTD_FSE_ENTRY   *OfEntry;
+  CONST ZSTD_FSE_ENTRY   *MlEntry;
+  CONST UINT8            *LitEnd;
+  UINT8                  *Op;
+  UINT32                  SeqCount;
+  UINT32                  Modes;
+  UINTN                   Offset;
+  UINTN                   ReadSize;
+  UINT32                  LlState;
+  UINT32                  OfState;
+  UINT32                  MlState;
+  UINT32                  LlCode;
+  UINT32                  OfCode;
+  UINT32                  MlCode;
+  UINTN                   LitLength;
+  UINTN                   MatchLength;
+  UINTN                   OffsetValue;
+  UINTN                   MatchOffset;
+  UINT32                 *Rep;
+
+  Op     = *Dst;
+  LitEnd = Literals + LiteralSize;
+
+  //
+  // Number_of_Sequences
+  //
+  if (SrcSize == 0) {
+    return RETURN_INVALID_PARAMETER;
+  }
+  if (Src[0] < 128) {
+    SeqCount = Src[0];
+    Offset   = 1;
+  } else if (Src[0] < 255) {
+    if (SrcSize < 2) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    SeqCount = ((Src[0] - 128) << 8) + Src[1];
+    Offset   = 2;
+  } else {
+    if (SrcSize < 3) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    SeqCount = Src[1] + (Src[2] << 8) + 0x7F00;
+    Offset   = 3;
+  }
+
+  if (SeqCount > 0) {
+    if (Offset >= SrcSize) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    Modes = Src[Offset++];
+    if ((Modes & 0x03) != 0) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    Status = ZstdSetupSequenceTable (&Workspace->LitLength, Modes >> 6, Src + Offset, SrcSize - Offset,
+                                     mLitLengthDefaultNorm, ARRAY_SIZE (mLitLengthDefaultNorm), 6,
+                                     ZSTD_LL_SYMBOL_MAX, ZSTD_LL_TABLE_LOG_MAX, &ReadSize);
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+    Offset += ReadSize;
+    Status = ZstdSetupSequenceTable (&Workspace->Offset, (Modes >> 4) & 0x03, Src + Offset, SrcSize - Offset,
+                                     mOffsetDefaultNorm, ARRAY_SIZE (mOffsetDefaultNorm), 5,
+                                     ZSTD_OF_SYMBOL_MAX, ZSTD_OF_TABLE_LOG_MAX, &ReadSize);
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+    Offset += ReadSize;
+    Status = ZstdSetupSequenceTable (&Workspace->MatchLength, (Modes >> 2) & 0x03, Src + Offset, SrcSize - Offset,
+                                     mMatchLengthDefaultNorm, ARRAY_SIZE (mMatchLengthDefaultNorm), 6,
+                                     ZSTD_ML_SYMBOL_MAX, ZSTD_ML_TABLE_LOG_MAX, &ReadSize);
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+    Offset += ReadSize;
+    if (Offset > SrcSize) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    Status = ZstdBitInit (&Reader, Src + Offset, SrcSize - Offset);
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+
+    LlState = (UINT32)ZstdBitRead (&Reader, Workspace->LitLength.TableLog);
+    OfState = (UINT32)ZstdBitRead (&Reader, Workspace->Offset.TableLog);
+    MlState = (UINT32)ZstdBitRead (&Reader, Workspace->MatchLength.TableLog);
+    Rep     = Workspace->RepOffset;
+
+    while (SeqCount-- > 0) {
+      if (ZstdBitReload (&Reader) == ZstdBitOverflow) {
+        return RETURN_INVALID_PARAMETER;
+      }
+      LlEntry = &Workspace->LitLength.Entry[LlState];
+      OfEntry = &Workspace->Offset.Entry[OfState];
+      MlEntry = &Workspace->MatchLength.Entry[MlState];
+      LlCode  = LlEntry->Symbol;
+      OfCode  = OfEntry->Symbol;
+      MlCode  = MlEntry->Symbol;
+
+      //
+      // Extra bits are read in the order offset, match length, literal length
+      //
+      OffsetValue = ((UINTN)1 << OfCode) + (UINTN)ZSTD_BIT_PEEK (&Reader, OfCode);
+      ZSTD_BIT_SKIP (&Reader, OfCode);
+      if (Reader.BitsConsumed > 64 - 32) {
+        ZstdBitReload (&Reader);
+      }
+      MatchLength = mMatchLengthBase[MlCode] + (UINTN)ZSTD_BIT_PEEK (&Reader, mMatchLengthBits[MlCode]);
+      ZSTD_BIT_SKIP (&Reader, mMatchLengthBits[MlCode]);
+      LitLength   = mLitLengthBase[LlCode] + (UINTN)ZSTD_BIT_PEEK (&Reader, mLitLengthBits[LlCode]);
+      ZSTD_BIT_SKIP (&Reader, mLitLengthBits[LlCode]);
+
+      //
+      // Offset values 1 to 3 select a repeated offset, shifted by one when
+      // the sequence has no literals
+      //
+      if (OffsetValue > 3) {
+        Rep[2] = Rep[1];
+        Rep[1] = Rep[0];
+        Rep[0] = (UINT32)(OffsetValue - 3);
+      } else {
+        OffsetValue = OffsetValue - 1 + ((LitLength == 0) ? 1 : 0);
+        if (OffsetValue != 0) {
+          MatchOffset = (OffsetValue == 3) ? (Rep[0] - 1) : Rep[OffsetValue];
+          if (OffsetValue != 1) {
+            Rep[2] = Rep[1];
+          }
+          Rep[1] = Rep[0];
+          Rep[0] = (UINT32)MatchOffset;
+        }
+      }
+      MatchOffset = Rep[0];
+
+      //
+      // Update the states, except after the last sequence
+      //
+      if (SeqCount > 0) {
+        if (Reader.BitsConsumed > 64 - (ZSTD_LL_TABLE_LOG_MAX + ZSTD_ML_TABLE_LOG_MAX + ZSTD_OF_TABLE_LOG_MAX)) {
+          ZstdBitReload (&Reader);
+        }
+        LlState = LlEntry->NewState + (UINT32)ZSTD_BIT_PEEK (&Reader, LlEntry->NbBits);
+        ZSTD_BIT_SKIP (&Reader, LlEntry->NbBits);
+        MlState = MlEntry->NewState + (UINT32)ZSTD_BIT_PEEK (&Reader, MlEntry->NbBits);
+        ZSTD_BIT_SKIP (&Reader, MlEntry->NbBits);
+        OfState = OfEntry->NewState + (UINT32)ZSTD_BIT_PEEK (&Reader, OfEntry->NbBits);
+        ZSTD_BIT_SKIP (&Reader, OfEntry->NbBits);
+      }
+
+      //
+      // Execute the sequence
+      //
+      if ((LitLength > (UINTN)(LitEnd - Literals)) ||
+          (LitLength + MatchLength > (UINTN)(DstEnd - Op))) {
+        return RETURN_INVALID_PARAMETER;
+      }
+      if ((MatchOffset == 0) || (MatchOffset > (UINTN)(Op - Base) + LitLength)) {
+        return RETURN_INVALID_PARAMETER;
+      }
+
+      if (LitLength + MatchLength + ZSTD_WILDCOPY_OVERRUN <= (UINTN)(DstEnd - Op)) {
+        //
+        // Far enough from the end of the output to copy in whole chunks
+        //
+        ZstdWildCopy (Op, Literals, LitLength);
+        Op       += LitLength;
+        Literals += LitLength;
+        if (MatchOffset >= ZSTD_WILDCOPY_CHUNK) {
+          ZstdWildCopy (Op, Op - MatchOffset, MatchLength);
+        } else {
+          ZstdCopyMatch (Op, MatchOffset, MatchLength);
+        }
+      } else {
+        CopyMem (Op, Literals, LitLength);
+        Op       += LitLength;
+        Literals += LitLength;
+        ZstdCopyMatch (Op, MatchOffset, MatchLength);
+      }
+      Op += MatchLength;
+    }
+
+    if (ZstdBitReload (&Reader) != ZstdBitCompleted) {
+      return RETURN_INVALID_PARAMETER;
+    }
+  }
+
+  //
+  // The literals left over follow the last sequence
+  //
+  LitLength = (UINTN)(LitEnd - Literals);
+  if (LitLength > (UINTN)(DstEnd - Op)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+  CopyMem (Op, Literals, LitLength);
+  *Dst = Op + LitLength;
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decode a compressed block.
+
+  @param[in, out] Workspace   The decoder workspace.
+  @param[in]      Src         The block content.
+  @param[in]      SrcSize     The size of the block content.
+  @param[in]      Base        The start of the frame output.
+  @param[in, out] Dst         The output position, updated on return.
+  @param[in]      DstEnd      The end of the output buffer.
+
+  @retval RETURN_SUCCESS            The block was decoded.
+  @retval RETURN_INVALID_PARAMETER  The block is corrupted.
+**/
+STATIC
+RETURN_STATUS
+ZstdDecodeCompressedBlock (
+  IN OUT ZSTD_WORKSPACE  *Workspace,
+  IN     CONST UINT8     *Src,
+  IN     UINTN            SrcSize,
+  IN     UINT8           *Base,
+  IN OUT UINT8          **Dst,
+  IN     UINT8           *DstEnd
+  )
+{
+  RETURN_STATUS   Status;
+  CONST UINT8    *Literals;
+  UINTN           LiteralSize;
+  UINTN           ReadSize;
+
+  Status = ZstdDecodeLiterals (Workspace, Src, SrcSize, &Literals, &LiteralSize, &ReadSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  return ZstdExecuteSequences (Workspace, Src + ReadSize, SrcSize - ReadSize,
+                               Literals, LiteralSize, Base, Dst, DstEnd);
+}
+
+/**
+  Given a Zstandard compressed source buffer, this function retrieves the size
+  of the uncompressed buffer and the size of the scratch buffer required
+  to decompress the compressed source buffer.
+
+  The source buffer holds a single Zstandard frame (RFC 8878). The size of the
+  uncompressed buffer is the Frame_Content_Size field of the frame header, so
+  the frame must have been produced with this field present. Dictionaries are
+  not supported.
+
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  DestinationSize A pointer to the size, in bytes, of the uncompressed buffer
+                          that will be generated when the compressed buffer specified
+                          by Source and SourceSize is decompressed.
+  @param  ScratchSize     A pointer to the size, in bytes, of the scratch buffer that
+                          is required to decompress the compressed buffer specified
+                          by Source and SourceSize.
+
+  @retval  RETURN_SUCCESS The size of the uncompressed data was returned
+                          in DestinationSize and the size of the scratch
+                          buffer was returned in ScratchSize.
+  @retval  RETURN_INVALID_PARAMETER
+                          The frame header is corrupted.
+  @retval  RETURN_UNSUPPORTED
+                          The frame has no content size or needs a dictionary.
+
+**/
+RETURN_STATUS
+EFIAPI
+ZstdDecompressGetInfo (
+  IN  CONST VOID  *Source,
+  IN  UINT32       SourceSize,
+  OUT UINT32      *DestinationSize,
+  OUT UINT32      *ScratchSize
+  )
+{
+  RETURN_STATUS     Status;
+  ZSTD_FRAME_INFO   Info;
+
+  Status = ZstdParseFrameHeader (Source, SourceSize, &Info);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+  if (Info.ContentSize > MAX_UINT32) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  if (DestinationSize != NULL) {
+    *DestinationSize = (UINT32)Info.ContentSize;
+  }
+  if (ScratchSize != NULL) {
+    *ScratchSize = sizeof (ZSTD_WORKSPACE);
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decompresses a Zstandard compressed source buffer.
+
+  Extracts decompressed data to its original form.
+  If the compressed source data specified by Source is successfully decompressed
+  into Destination, then RETURN_SUCCESS is returned.  If the compressed source data
+  specified by Source is not in a valid compressed data format,
+  then RETURN_INVALID_PARAMETER is returned.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data. It
+                      must be at least the size returned by ZstdDecompressGetInfo().
+  @param  Scratch     A temporary scratch buffer of the size returned by
+                      ZstdDecompressGetInfo(), used for the entropy tables and
+                      the literals of a block.
+
+  @retval  RETURN_SUCCESS Decompression completed successfully, and
+                          the uncompressed buffer is returned in Destination.
+  @retval  RETURN_INVALID_PARAMETER
+                          The source buffer specified by Source is corrupted
+                          (not in a valid compressed format), or Scratch is NULL.
+  @retval  RETURN_UNSUPPORTED
+                          The frame has no content size or needs a dictionary.
+**/
+RETURN_STATUS
+EFIAPI
+ZstdDecompress (
+  IN CONST VOID  *Source,
+  IN UINTN        SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  )
+{
+  RETURN_STATUS     Status;
+  ZSTD_FRAME_INFO   Info;
+  ZSTD_WORKSPACE   *Workspace;
+  CONST UINT8      *Src;
+  CONST UINT8      *SrcEnd;
+  UINT8            *Base;
+  UINT8            *Dst;
+  UINT8            *DstEnd;
+  UINT32            BlockHeader;
+  UINT32            BlockSize;
+  BOOLEAN           LastBlock;
+
+  if ((Scratch == NULL) || (Destination == NULL)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Status = ZstdParseFrameHeader (Source, SourceSize, &Info);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+  if (Info.ContentSize > MAX_UINT32) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  Workspace = (ZSTD_WORKSPACE *)Scratch;
+  Workspace->Huf.TableLog        = 0;
+  Workspace->LitLength.Valid     = FALSE;
+  Workspace->Offset.Valid        = FALSE;
+  Workspace->MatchLength.Valid   = FALSE;
+  Workspace->RepOffset[0]        = 1;
+  Workspace->RepOffset[1]        = 4;
+  Workspace->RepOffset[2]        = 8;
+
+  Src    = (CONST UINT8 *)Source + Info.FrameHeaderSize;
+  SrcEnd = (CONST UINT8 *)Source + SourceSize;
+  Base   = (UINT8 *)Destination;
+  Dst    = Base;
+  DstEnd = Base + (UINTN)Info.ContentSize;
+
+  do {
+    if (SrcEnd - Src < ZSTD_BLOCK_HEADER_SIZE) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    BlockHeader = Src[0] | (Src[1] << 8) | (Src[2] << 16);
+    LastBlock   = (BOOLEAN)((BlockHeader & 1) != 0);
+    BlockSize   = BlockHeader >> 3;
+    Src += ZSTD_BLOCK_HEADER_SIZE;
+
+    switch ((BlockHeader >> 1) & 0x03) {
+    case ZSTD_BLOCK_TYPE_RAW:
+      if ((BlockSize > (UINTN)(SrcEnd - Src)) || (BlockSize > (UINTN)(DstEnd - Dst))) {
+        return RETURN_INVALID_PARAMETER;
+      }
+      CopyMem (Dst, Src, BlockSize);
+      Dst += BlockSize;
+      Src += BlockSize;
+      break;
+
+    case ZSTD_BLOCK_TYPE_RLE:
+      if ((Src >= SrcEnd) || (BlockSize > (UINTN)(DstEnd - Dst))) {
+        return RETURN_INVALID_PARAMETER;
+      }
+      SetMem (Dst, BlockSize, *Src);
+      Dst += BlockSize;
+      Src += 1;
+      break;
+
+    case ZSTD_BLOCK_TYPE_COMPRESSED:
+      if ((BlockSize > ZSTD_BLOCK_SIZE_MAX) || (BlockSize > (UINTN)(SrcEnd - Src))) {
+        return RETURN_INVALID_PARAMETER;
+      }
+      Status = ZstdDecodeCompressedBlock (Workspace, Src, BlockSize, Base, &Dst, DstEnd);
+      if (RETURN_ERROR (Status)) {
+        return Status;
+      }
+      Src += BlockSize;
+      break;
+
+    default:
+      return RETURN_INVALID_PARAMETER;
+    }
+  } while (!LastBlock);
+
+  if (Info.HasChecksum && (SrcEnd - Src < ZSTD_CHECKSUM_SIZE)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (Dst != DstEnd) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  return RETURN_SUCCESS;
+}
@@ -0,0 +1,264 @@
+/** @file
+  Internal definitions of the Zstandard decompress library.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __ZSTD_DECOMPRESS_LIB_INTERNAL_H__
+#define __ZSTD_DECOMPRESS_LIB_INTERNAL_H__
+
+#include <Library/ZstdDecompressLib.h>
+
+#define ZSTD_MAGIC_NUMBER               0xFD2FB528
+#define ZSTD_SKIPPABLE_MAGIC_NUMBER     0x184D2A50
+#define ZSTD_SKIPPABLE_MAGIC_MASK       0xFFFFFFF0
+
+#define ZSTD_BLOCK_HEADER_SIZE          3
+#define ZSTD_BLOCK_SIZE_MAX             (128 * 1024)
+#define ZSTD_CHECKSUM_SIZE              4
+
+#define ZSTD_BLOCK_TYPE_RAW             0
+#define ZSTD_BLOCK_TYPE_RLE             1
+#define ZSTD_BLOCK_TYPE_COMPRESSED      2
+
+#define ZSTD_LITERALS_TYPE_RAW          0
+#define ZSTD_LITERALS_TYPE_RLE          1
+#define ZSTD_LITERALS_TYPE_COMPRESSED   2
+#define ZSTD_LITERALS_TYPE_TREELESS     3
+
+#define ZSTD_SEQ_MODE_PREDEFINED        0
+#define ZSTD_SEQ_MODE_RLE               1
+#define ZSTD_SEQ_MODE_FSE               2
+#define ZSTD_SEQ_MODE_REPEAT            3
+
+#define ZSTD_HUF_TABLE_LOG_MAX          12
+#define ZSTD_HUF_SYMBOL_COUNT_MAX       256
+#define ZSTD_HUF_WEIGHT_TABLE_LOG_MAX   6
+
+#define ZSTD_LL_SYMBOL_MAX              35
+#define ZSTD_ML_SYMBOL_MAX              52
+#define ZSTD_OF_SYMBOL_MAX              31
+#define ZSTD_LL_TABLE_LOG_MAX           9
+#define ZSTD_ML_TABLE_LOG_MAX           9
+#define ZSTD_OF_TABLE_LOG_MAX           8
+#define ZSTD_FSE_TABLE_LOG_MAX          9
+#define ZSTD_FSE_SYMBOL_COUNT_MAX       64
+
+//
+// Sequences are copied in 16-byte chunks when the output has room for the
+// overrun. The literals buffer has the same room behind it.
+//
+#define ZSTD_WILDCOPY_CHUNK             16
+#define ZSTD_WILDCOPY_OVERRUN           32
+#define ZSTD_LITERALS_MARGIN            ZSTD_WILDCOPY_OVERRUN
+
+typedef enum {
+  ZstdBitUnfinished,
+  ZstdBitEndOfBuffer,
+  ZstdBitCompleted,
+  ZstdBitOverflow
+} ZSTD_BIT_STATUS;
+
+//
+// Reader of a bit stream written forward and read backward, starting with
+// the highest bit below the end marker of the last byte.
+//
+typedef struct {
+  UINT64          Container;
+  UINT32          BitsConsumed;
+  CONST UINT8    *Ptr;
+  CONST UINT8    *Start;
+} ZSTD_BIT_READER;
+
+typedef struct {
+  UINT8           Symbol;
+  UINT8           NbBits;
+  UINT16          NewState;
+} ZSTD_FSE_ENTRY;
+
+typedef struct {
+  BOOLEAN         Valid;
+  UINT32          TableLog;
+  ZSTD_FSE_ENTRY  Entry[1 << ZSTD_FSE_TABLE_LOG_MAX];
+} ZSTD_FSE_TABLE;
+
+typedef struct {
+  UINT8           Symbol;
+  UINT8           NbBits;
+} ZSTD_HUF_ENTRY;
+
+typedef struct {
+  UINT32          TableLog;
+  ZSTD_HUF_ENTRY  Entry[1 << ZSTD_HUF_TABLE_LOG_MAX];
+} ZSTD_HUF_TABLE;
+
+//
+// Decoder state kept in the scratch buffer. The tables persist from one
+// block to the next of a frame, as blocks may repeat them.
+//
+typedef struct {
+  ZSTD_HUF_TABLE  Huf;
+  ZSTD_FSE_TABLE  LitLength;
+  ZSTD_FSE_TABLE  Offset;
+  ZSTD_FSE_TABLE  MatchLength;
+  ZSTD_FSE_TABLE  Weight;
+  UINT32          RepOffset[3];
+  UINT8           Literals[ZSTD_BLOCK_SIZE_MAX + ZSTD_LITERALS_MARGIN];
+} ZSTD_WORKSPACE;
+
+/**
+  Initialize a backward bit reader on a bit stream.
+
+  @param[out] Reader      The bit reader.
+  @param[in]  Src         The bit stream.
+  @param[in]  SrcSize     The size of the bit stream in bytes.
+
+  @retval RETURN_SUCCESS            The reader is ready.
+  @retval RETURN_INVALID_PARAMETER  The stream is empty or has no end marker.
+**/
+RETURN_STATUS
+ZstdBitInit (
+  OUT ZSTD_BIT_READER  *Reader,
+  IN  CONST UINT8      *Src,
+  IN  UINTN             SrcSize
+  );
+
+/**
+  Refill the bit container after bits were consumed.
+
+  @param[in, out] Reader  The bit reader.
+
+  @retval  ZstdBitUnfinished    At least 57 bits can be read.
+  @retval  ZstdBitEndOfBuffer   Less bits are left, all in the container.
+  @retval  ZstdBitCompleted     All bits were consumed.
+  @retval  ZstdBitOverflow      More bits were consumed than the stream holds.
+**/
+ZSTD_BIT_STATUS
+ZstdBitReload (
+  IN OUT ZSTD_BIT_READER  *Reader
+  );
+
+//
+// Peek at the next NbBits bits of a bit reader, then skip them. At most 57
+// bits may be read after a reload that returned ZstdBitUnfinished.
+//
+#define ZSTD_BIT_PEEK(Reader, NbBits) \
+  ((((Reader)->Container << ((Reader)->BitsConsumed & 63)) >> 1) >> (63 - (NbBits)))
+
+#define ZSTD_BIT_SKIP(Reader, NbBits) \
+  ((Reader)->BitsConsumed += (UINT32)(NbBits))
+
+/**
+  Read the next bits of a bit reader.
+
+  @param[in, out] Reader      The bit reader.
+  @param[in]      NbBits      The number of bits, at most 57.
+
+  @retval  The bits.
+**/
+UINT64
+ZstdBitRead (
+  IN OUT ZSTD_BIT_READER  *Reader,
+  IN     UINT32            NbBits
+  );
+
+/**
+  Read a FSE table description and build the decoding table.
+
+  @param[out] Table       The decoding table.
+  @param[in]  Src         The table description.
+  @param[in]  SrcSize     The size of the source buffer.
+  @param[in]  MaxSymbol   The largest symbol allowed.
+  @param[in]  MaxLog      The largest accuracy log allowed.
+  @param[out] ReadSize    The size of the table description.
+
+  @retval RETURN_SUCCESS            The table was built.
+  @retval RETURN_INVALID_PARAMETER  The description is corrupted.
+**/
+RETURN_STATUS
+ZstdReadFseTable (
+  OUT ZSTD_FSE_TABLE   *Table,
+  IN  CONST UINT8      *Src,
+  IN  UINTN             SrcSize,
+  IN  UINT32            MaxSymbol,
+  IN  UINT32            MaxLog,
+  OUT UINTN            *ReadSize
+  );
+
+/**
+  Build a FSE decoding table from a normalized distribution.
+
+  @param[out] Table       The decoding table.
+  @param[in]  Norm        The normalized count of each symbol, -1 for
+                          "less than one".
+  @param[in]  SymbolCount The number of symbols in Norm.
+  @param[in]  TableLog    The accuracy log of the distribution.
+
+  @retval RETURN_SUCCESS            The table was built.
+  @retval RETURN_INVALID_PARAMETER  The distribution is corrupted.
+**/
+RETURN_STATUS
+ZstdBuildFseTable (
+  OUT ZSTD_FSE_TABLE   *Table,
+  IN  CONST INT16      *Norm,
+  IN  UINT32            SymbolCount,
+  IN  UINT32            TableLog
+  );
+
+/**
+  Build a FSE decoding table that always decodes the same symbol.
+
+  @param[out] Table       The decoding table.
+  @param[in]  Symbol      The symbol.
+**/
+VOID
+ZstdBuildRleTable (
+  OUT ZSTD_FSE_TABLE   *Table,
+  IN  UINT8             Symbol
+  );
+
+/**
+  Read a Huffman tree description and build the decoding table.
+
+  @param[in, out] Workspace   The decoder workspace, which holds the table.
+  @param[in]      Src         The tree description.
+  @param[in]      SrcSize     The size of the source buffer.
+  @param[out]     ReadSize    The size of the tree description.
+
+  @retval RETURN_SUCCESS            The table was built.
+  @retval RETURN_INVALID_PARAMETER  The description is corrupted.
+**/
+RETURN_STATUS
+ZstdReadHufTable (
+  IN OUT ZSTD_WORKSPACE  *Workspace,
+  IN     CONST UINT8     *Src,
+  IN     UINTN            SrcSize,
+  OUT    UINTN           *ReadSize
+  );
+
+/**
+  Decode Huffman compressed literals.
+
+  @param[in]  Table       The Huffman decoding table.
+  @param[in]  Src         The compressed streams, with the jump table if any.
+  @param[in]  SrcSize     The size of the compressed streams.
+  @param[out] Dst         The buffer for the literals.
+  @param[in]  DstSize     The number of literals.
+  @param[in]  FourStreams TRUE if the literals are split in four streams.
+
+  @retval RETURN_SUCCESS            The literals were decoded.
+  @retval RETURN_INVALID_PARAMETER  The streams are corrupted.
+**/
+RETURN_STATUS
+ZstdDecodeHufLiterals (
+  IN  CONST ZSTD_HUF_TABLE  *Table,
+  IN  CONST UINT8           *Src,
+  IN  UINTN                  SrcSize,
+  OUT UINT8                 *Dst,
+  IN  UINTN                  DstSize,
+  IN  BOOLEAN                FourStreams
+  );
+
+#endif
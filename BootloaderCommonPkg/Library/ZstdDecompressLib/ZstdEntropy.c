@@ -0,0 +1,689 @@
+/** @file
+  Bit stream, FSE and Huffman decoding of the Zstandard decompress library.
+
+  The entropy coding follows the Zstandard Compression Format, RFC 8878.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "ZstdDecompressLibInternal.h"
+
+/**
+  Initialize a backward bit reader on a bit stream.
+
+  @param[out] Reader      The bit reader.
+  @param[in]  Src         The bit stream.
+  @param[in]  SrcSize     The size of the bit stream in bytes.
+
+  @retval RETURN_SUCCESS            The reader is ready.
+  @retval RETURN_INVALID_PARAMETER  The stream is empty or has no end marker.
+**/
+RETURN_STATUS
+ZstdBitInit (
+  OUT ZSTD_BIT_READER  *Reader,
+  IN  CONST UINT8      *Src,
+  IN  UINTN             SrcSize
+  )
+{
+  UINT8   LastByte;
+  UINTN   Index;
+
+  if (SrcSize == 0) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  LastByte = Src[SrcSize - 1];
+  if (LastByte == 0) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Reader->Start = Src;
+  if (SrcSize >= sizeof (UINT64)) {
+    Reader->Ptr          = Src + SrcSize - sizeof (UINT64);
+    Reader->Container    = ReadUnaligned64 ((CONST UINT64 *)Reader->Ptr);
+    Reader->BitsConsumed = 8 - (UINT32)HighBitSet32 (LastByte);
+  } else {
+    Reader->Ptr       = Src;
+    Reader->Container = 0;
+    for (Index = 0; Index < SrcSize; Index++) {
+      Reader->Container |= LShiftU64 (Src[Index], (UINTN)(Index * 8));
+    }
+    Reader->BitsConsumed = 8 - (UINT32)HighBitSet32 (LastByte) + (UINT32)(sizeof (UINT64) - SrcSize) * 8;
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Refill the bit container after bits were consumed.
+
+  @param[in, out] Reader  The bit reader.
+
+  @retval  ZstdBitUnfinished    At least 57 bits can be read.
+  @retval  ZstdBitEndOfBuffer   Less bits are left, all in the container.
+  @retval  ZstdBitCompleted     All bits were consumed.
+  @retval  ZstdBitOverflow      More bits were consumed than the stream holds.
+**/
+ZSTD_BIT_STATUS
+ZstdBitReload (
+  IN OUT ZSTD_BIT_READER  *Reader
+  )
+{
+  UINTN            Bytes;
+  ZSTD_BIT_STATUS  Status;
+
+  if (Reader->BitsConsumed > 64) {
+    return ZstdBitOverflow;
+  }
+
+  if (Reader->Ptr >= Reader->Start + sizeof (UINT64)) {
+    Reader->Ptr          -= Reader->BitsConsumed >> 3;
+    Reader->BitsConsumed &= 7;
+    Reader->Container     = ReadUnaligned64 ((CONST UINT64 *)Reader->Ptr);
+    return ZstdBitUnfinished;
+  }
+
+  if (Reader->Ptr == Reader->Start) {
+    return (Reader->BitsConsumed < 64) ? ZstdBitEndOfBuffer : ZstdBitCompleted;
+  }
+
+  //
+  // Less than 8 bytes are left in front of the container
+  //
+  Bytes  = Reader->BitsConsumed >> 3;
+  Status = ZstdBitUnfinished;
+  if (Reader->Ptr - Bytes < Reader->Start) {
+    Bytes  = (UINTN)(Reader->Ptr - Reader->Start);
+    Status = ZstdBitEndOfBuffer;
+  }
+  Reader->Ptr          -= Bytes;
+  Reader->BitsConsumed -= (UINT32)Bytes * 8;
+  Reader->Container     = ReadUnaligned64 ((CONST UINT64 *)Reader->Ptr);
+  return Status;
+}
+
+/**
+  Read the next bits of a bit reader.
+
+  @param[in, out] Reader      The bit reader.
+  @param[in]      NbBits      The number of bits, at most 57.
+
+  @retval  The bits.
+**/
+UINT64
+ZstdBitRead (
+  IN OUT ZSTD_BIT_READER  *Reader,
+  IN     UINT32            NbBits
+  )
+{
+  UINT64  Value;
+
+  Value = ZSTD_BIT_PEEK (Reader, NbBits);
+  ZSTD_BIT_SKIP (Reader, NbBits);
+  return Value;
+}
+
+/**
+  Read bits of a little-endian bit stream read forward.
+
+  Bits past the end of the stream read as zero.
+
+  @param[in] Src          The bit stream.
+  @param[in] SrcSize      The size of the bit stream in bytes.
+  @param[in] BitPos       The position of the first bit.
+  @param[in] NbBits       The number of bits, at most 24.
+
+  @retval  The bits.
+**/
+STATIC
+UINT32
+ZstdPeekForward (
+  IN CONST UINT8  *Src,
+  IN UINTN         SrcSize,
+  IN UINTN         BitPos,
+  IN UINT32        NbBits
+  )
+{
+  UINT32  Value;
+  UINTN   Byte;
+  UINTN   Index;
+
+  Value = 0;
+  Byte  = BitPos >> 3;
+  for (Index = 0; (Index < 4) && (Byte + Index < SrcSize); Index++) {
+    Value |= (UINT32)Src[Byte + Index] << (Index * 8);
+  }
+
+  return (Value >> (BitPos & 7)) & ((1U << NbBits) - 1);
+}
+
+/**
+  Build a FSE decoding table from a normalized distribution.
+
+  @param[out] Table       The decoding table.
+  @param[in]  Norm        The normalized count of each symbol, -1 for
+                          "less than one".
+  @param[in]  SymbolCount The number of symbols in Norm.
+  @param[in]  TableLog    The accuracy log of the distribution.
+
+  @retval RETURN_SUCCESS            The table was built.
+  @retval RETURN_INVALID_PARAMETER  The distribution is corrupted.
+**/
+RETURN_STATUS
+ZstdBuildFseTable (
+  OUT ZSTD_FSE_TABLE   *Table,
+  IN  CONST INT16      *Norm,
+  IN  UINT32            SymbolCount,
+  IN  UINT32            TableLog
+  )
+{
+  UINT16   SymbolNext[ZSTD_FSE_SYMBOL_COUNT_MAX];
+  UINT32   TableSize;
+  UINT32   HighThreshold;
+  UINT32   Step;
+  UINT32   Position;
+  UINT32   Symbol;
+  UINT32   Index;
+  UINT32   Next;
+  UINT32   NbBits;
+
+  if ((TableLog > ZSTD_FSE_TABLE_LOG_MAX) || (SymbolCount > ZSTD_FSE_SYMBOL_COUNT_MAX)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Table->Valid    = FALSE;
+  Table->TableLog = TableLog;
+  TableSize       = 1U << TableLog;
+  HighThreshold   = TableSize - 1;
+
+  //
+  // "Less than one" symbols take the last cells, one each
+  //
+  for (Symbol = 0; Symbol < SymbolCount; Symbol++) {
+    if (Norm[Symbol] == -1) {
+      Table->Entry[HighThreshold--].Symbol = (UINT8)Symbol;
+      SymbolNext[Symbol] = 1;
+    } else {
+      SymbolNext[Symbol] = (UINT16)Norm[Symbol];
+    }
+  }
+
+  //
+  // Spread the other symbols over the remaining cells
+  //
+  Step     = (TableSize >> 1) + (TableSize >> 3) + 3;
+  Position = 0;
+  for (Symbol = 0; Symbol < SymbolCount; Symbol++) {
+    for (Index = 0; (INT32)Index < Norm[Symbol]; Index++) {
+      Table->Entry[Position].Symbol = (UINT8)Symbol;
+      do {
+        Position = (Position + Step) & (TableSize - 1);
+      } while (Position > HighThreshold);
+    }
+  }
+  if (Position != 0) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  for (Index = 0; Index < TableSize; Index++) {
+    Symbol = Table->Entry[Index].Symbol;
+    Next   = SymbolNext[Symbol]++;
+    NbBits = TableLog - (UINT32)HighBitSet32 (Next);
+    Table->Entry[Index].NbBits   = (UINT8)NbBits;
+    Table->Entry[Index].NewState = (UINT16)((Next << NbBits) - TableSize);
+  }
+
+  Table->Valid = TRUE;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Build a FSE decoding table that always decodes the same symbol.
+
+  @param[out] Table       The decoding table.
+  @param[in]  Symbol      The symbol.
+**/
+VOID
+ZstdBuildRleTable (
+  OUT ZSTD_FSE_TABLE   *Table,
+  IN  UINT8             Symbol
+  )
+{
+  Table->TableLog          = 0;
+  Table->Entry[0].Symbol   = Symbol;
+  Table->Entry[0].NbBits   = 0;
+  Table->Entry[0].NewState = 0;
+  Table->Valid             = TRUE;
+}
+
+/**
+  Read a FSE table description and build the decoding table.
+
+  @param[out] Table       The decoding table.
+  @param[in]  Src         The table description.
+  @param[in]  SrcSize     The size of the source buffer.
+  @param[in]  MaxSymbol   The largest symbol allowed.
+  @param[in]  MaxLog      The largest accuracy log allowed.
+  @param[out] ReadSize    The size of the table description.
+
+  @retval RETURN_SUCCESS            The table was built.
+  @retval RETURN_INVALID_PARAMETER  The description is corrupted.
+**/
+RETURN_STATUS
+ZstdReadFseTable (
+  OUT ZSTD_FSE_TABLE   *Table,
+  IN  CONST UINT8      *Src,
+  IN  UINTN             SrcSize,
+  IN  UINT32            MaxSymbol,
+  IN  UINT32            MaxLog,
+  OUT UINTN            *ReadSize
+  )
+{
+  INT16    Norm[ZSTD_FSE_SYMBOL_COUNT_MAX];
+  UINT32   TableLog;
+  INT32    Remaining;
+  INT32    Threshold;
+  INT32    Max;
+  INT32    Count;
+  UINT32   NbBits;
+  UINT32   Value;
+  UINT32   Repeat;
+  UINT32   Symbol;
+  UINT32   Index;
+  UINTN    BitPos;
+
+  if ((SrcSize == 0) || (MaxSymbol >= ZSTD_FSE_SYMBOL_COUNT_MAX)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  TableLog = (Src[0] & 0x0F) + 5;
+  if (TableLog > MaxLog) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  BitPos    = 4;
+  Remaining = (1 << TableLog) + 1;
+  Threshold = 1 << TableLog;
+  NbBits    = TableLog + 1;
+  Symbol    = 0;
+
+  while ((Remaining > 1) && (Symbol <= MaxSymbol)) {
+    //
+    // Small values are coded with one bit less
+    //
+    Max   = (2 * Threshold - 1) - Remaining;
+    Value = ZstdPeekForward (Src, SrcSize, BitPos, NbBits);
+    if ((INT32)(Value & (Threshold - 1)) < Max) {
+      Count   = Value & (Threshold - 1);
+      BitPos += NbBits - 1;
+    } else {
+      Count = Value & (2 * Threshold - 1);
+      if (Count >= Threshold) {
+        Count -= Max;
+      }
+      BitPos += NbBits;
+    }
+
+    Count--;
+    Remaining -= (Count < 0) ? -Count : Count;
+    Norm[Symbol++] = (INT16)Count;
+
+    if (Count == 0) {
+      //
+      // Zero probabilities are followed by 2-bit repeat flags
+      //
+      do {
+        Repeat  = ZstdPeekForward (Src, SrcSize, BitPos, 2);
+        BitPos += 2;
+        for (Index = 0; Index < Repeat; Index++) {
+          if (Symbol > MaxSymbol) {
+            return RETURN_INVALID_PARAMETER;
+          }
+          Norm[Symbol++] = 0;
+        }
+      } while (Repeat == 3);
+      if (Symbol > MaxSymbol) {
+        return RETURN_INVALID_PARAMETER;
+      }
+    }
+
+    if (Remaining < Threshold) {
+      if (Remaining <= 1) {
+        break;
+      }
+      NbBits    = (UINT32)HighBitSet32 ((UINT32)Remaining) + 1;
+      Threshold = 1 << (NbBits - 1);
+    }
+  }
+
+  if ((Remaining != 1) || (BitPos > SrcSize * 8)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  *ReadSize = (BitPos + 7) >> 3;
+  return ZstdBuildFseTable (Table, Norm, Symbol, TableLog);
+}
+
+/**
+  Decode the Huffman weights compressed with FSE.
+
+  @param[in, out] Table       Scratch table for the weight distribution.
+  @param[in]      Src         The compressed weights.
+  @param[in]      SrcSize     The size of the compressed weights.
+  @param[out]     Weights     The weights of the symbols.
+  @param[out]     Count       The number of weights.
+
+  @retval RETURN_SUCCESS            The weights were decoded.
+  @retval RETURN_INVALID_PARAMETER  The weights are corrupted.
+**/
+STATIC
+RETURN_STATUS
+ZstdDecodeFseWeights (
+  IN OUT ZSTD_FSE_TABLE   *Table,
+  IN     CONST UINT8      *Src,
+  IN     UINTN             SrcSize,
+  OUT    UINT8            *Weights,
+  OUT    UINT32           *Count
+  )
+{
+  RETURN_STATUS     Status;
+  ZSTD_BIT_READER   Reader;
+  CONST ZSTD_FSE_ENTRY  *Entry;
+  UINTN             HeaderSize;
+  UINT32            State[2];
+  UINT32            Index;
+  UINT32            Which;
+
+  Status = ZstdReadFseTable (Table, Src, SrcSize, ZSTD_HUF_TABLE_LOG_MAX,
+                             ZSTD_HUF_WEIGHT_TABLE_LOG_MAX, &HeaderSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+  if (HeaderSize >= SrcSize) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Status = ZstdBitInit (&Reader, Src + HeaderSize, SrcSize - HeaderSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Two interleaved states, decoded until the stream is exhausted. The state
+  // not updated last then yields the final weight.
+  //
+  State[0] = (UINT32)ZstdBitRead (&Reader, Table->TableLog);
+  State[1] = (UINT32)ZstdBitRead (&Reader, Table->TableLog);
+  Index    = 0;
+  Which    = 0;
+  for (;;) {
+    if (Index >= ZSTD_HUF_SYMBOL_COUNT_MAX - 2) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    Entry = &Table->Entry[State[Which]];
+    Weights[Index++] = Entry->Symbol;
+    State[Which] = Entry->NewState + (UINT32)ZstdBitRead (&Reader, Entry->NbBits);
+    if (ZstdBitReload (&Reader) == ZstdBitOverflow) {
+      Weights[Index++] = Table->Entry[State[Which ^ 1]].Symbol;
+      break;
+    }
+    Which ^= 1;
+  }
+
+  *Count = Index;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Read a Huffman tree description and build the decoding table.
+
+  @param[in, out] Workspace   The decoder workspace, which holds the table.
+  @param[in]      Src         The tree description.
+  @param[in]      SrcSize     The size of the source buffer.
+  @param[out]     ReadSize    The size of the tree description.
+
+  @retval RETURN_SUCCESS            The table was built.
+  @retval RETURN_INVALID_PARAMETER  The description is corrupted.
+**/
+RETURN_STATUS
+ZstdReadHufTable (
+  IN OUT ZSTD_WORKSPACE  *Workspace,
+  IN     CONST UINT8     *Src,
+  IN     UINTN            SrcSize,
+  OUT    UINTN           *ReadSize
+  )
+{
+  RETURN_STATUS     Status;
+  ZSTD_HUF_TABLE   *Table;
+  UINT8             Weights[ZSTD_HUF_SYMBOL_COUNT_MAX];
+  UINT32            Count;
+  UINT32            Index;
+  UINT32            Total;
+  UINT32            Rest;
+  UINT32            TableLog;
+  UINT32            Weight;
+  UINT32            Position;
+  UINT32            Length;
+  UINT32            Cell;
+  ZSTD_HUF_ENTRY    Entry;
+
+  if (SrcSize == 0) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (Src[0] >= 128) {
+    //
+    // Weights stored directly, two per byte
+    //
+    Count = Src[0] - 127;
+    if (1 + (Count + 1) / 2 > SrcSize) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    for (Index = 0; Index < Count; Index++) {
+      Weights[Index] = ((Index & 1) == 0) ? (Src[1 + Index / 2] >> 4) : (Src[1 + Index / 2] & 0x0F);
+    }
+    *ReadSize = 1 + (Count + 1) / 2;
+  } else {
+    if (1 + (UINTN)Src[0] > SrcSize) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    Status = ZstdDecodeFseWeights (&Workspace->Weight, Src + 1, Src[0], Weights, &Count);
+    Workspace->Weight.Valid = FALSE;
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+    *ReadSize = 1 + (UINTN)Src[0];
+  }
+
+  //
+  // The weight of the last symbol completes the total to a power of two
+  //
+  Total = 0;
+  for (Index = 0; Index < Count; Index++) {
+    if (Weights[Index] > ZSTD_HUF_TABLE_LOG_MAX) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    if (Weights[Index] != 0) {
+      Total += 1U << (Weights[Index] - 1);
+    }
+  }
+  if (Total == 0) {
+    return RETURN_INVALID_PARAMETER;
+  }
+  TableLog = (UINT32)HighBitSet32 (Total) + 1;
+  if (TableLog > ZSTD_HUF_TABLE_LOG_MAX) {
+    return RETURN_INVALID_PARAMETER;
+  }
+  Rest = (1U << TableLog) - Total;
+  if ((Rest & (Rest - 1)) != 0) {
+    return RETURN_INVALID_PARAMETER;
+  }
+  Weights[Count++] = (UINT8)(HighBitSet32 (Rest) + 1);
+
+  //
+  // Each symbol of weight W fills 2^(W-1) cells, the lowest weights first
+  //
+  Table    = &Workspace->Huf;
+  Position = 0;
+  for (Weight = 1; Weight <= TableLog; Weight++) {
+    Entry.NbBits = (UINT8)(TableLog + 1 - Weight);
+    Length       = 1U << (Weight - 1);
+    for (Index = 0; Index < Count; Index++) {
+      if (Weights[Index] != Weight) {
+        continue;
+      }
+      Entry.Symbol = (UINT8)Index;
+      for (Cell = 0; Cell < Length; Cell++) {
+        Table->Entry[Position + Cell] = Entry;
+      }
+      Position += Length;
+    }
+  }
+
+  Table->TableLog = TableLog;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decode one Huffman compressed stream of literals.
+
+  @param[in]  Table       The Huffman decoding table.
+  @param[in]  Src         The compressed stream.
+  @param[in]  SrcSize     The size of the compressed stream.
+  @param[out] Dst         The buffer for the literals.
+  @param[in]  DstSize     The number of literals.
+
+  @retval RETURN_SUCCESS            The literals were decoded.
+  @retval RETURN_INVALID_PARAMETER  The stream is corrupted.
+**/
+STATIC
+RETURN_STATUS
+ZstdDecodeHufStream (
+  IN  CONST ZSTD_HUF_TABLE  *Table,
+  IN  CONST UINT8           *Src,
+  IN  UINTN                  SrcSize,
+  OUT UINT8                 *Dst,
+  IN  UINTN                  DstSize
+  )
+{
+  RETURN_STATUS           Status;
+  ZSTD_BIT_READER         Reader;
+  CONST ZSTD_HUF_ENTRY   *Entry;
+  UINT8                  *DstEnd;
+  UINT32                  TableLog;
+
+  Status = ZstdBitInit (&Reader, Src, SrcSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  TableLog = Table->TableLog;
+  DstEnd   = Dst + DstSize;
+
+  //
+  // Four symbols of at most 12 bits fit in the 57 bits available after a
+  // full reload
+  //
+  while ((DstEnd - Dst >= 4) && (ZstdBitReload (&Reader) == ZstdBitUnfinished)) {
+    Entry = &Table->Entry[ZSTD_BIT_PEEK (&Reader, TableLog)];
+    ZSTD_BIT_SKIP (&Reader, Entry->NbBits);
+    Dst[0] = Entry->Symbol;
+    Entry = &Table->Entry[ZSTD_BIT_PEEK (&Reader, TableLog)];
+    ZSTD_BIT_SKIP (&Reader, Entry->NbBits);
+    Dst[1] = Entry->Symbol;
+    Entry = &Table->Entry[ZSTD_BIT_PEEK (&Reader, TableLog)];
+    ZSTD_BIT_SKIP (&Reader, Entry->NbBits);
+    Dst[2] = Entry->Symbol;
+    Entry = &Table->Entry[ZSTD_BIT_PEEK (&Reader, TableLog)];
+    ZSTD_BIT_SKIP (&Reader, Entry->NbBits);
+    Dst[3] = Entry->Symbol;
+    Dst += 4;
+  }
+
+  while (Dst < DstEnd) {
+    if (ZstdBitReload (&Reader) == ZstdBitOverflow) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    Entry = &Table->Entry[ZSTD_BIT_PEEK (&Reader, TableLog)];
+    ZSTD_BIT_SKIP (&Reader, Entry->NbBits);
+    *Dst++ = Entry->Symbol;
+  }
+
+  //
+  // The stream must be consumed exactly
+  //
+  if (ZstdBitReload (&Reader) != ZstdBitCompleted) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decode Huffman compressed literals.
+
+  @param[in]  Table       The Huffman decoding table.
+  @param[in]  Src         The compressed streams, with the jump table if any.
+  @param[in]  SrcSize     The size of the compressed streams.
+  @param[out] Dst         The buffer for the literals.
+  @param[in]  DstSize     The number of literals.
+  @param[in]  FourStreams TRUE if the literals are split in four streams.
+
+  @retval RETURN_SUCCESS            The literals were decoded.
+  @retval RETURN_INVALID_PARAMETER  The streams are corrupted.
+**/
+RETURN_STATUS
+ZstdDecodeHufLiterals (
+  IN  CONST ZSTD_HUF_TABLE  *Table,
+  IN  CONST UINT8           *Src,
+  IN  UINTN                  SrcSize,
+  OUT UINT8                 *Dst,
+  IN  UINTN                  DstSize,
+  IN  BOOLEAN                FourStreams
+  )
+{
+  RETURN_STATUS   Status;
+  UINTN           StreamSize[4];
+  UINTN           SegmentSize;
+  UINTN           Total;
+  UINTN           Index;
+
+  if (!FourStreams) {
+    return ZstdDecodeHufStream (Table, Src, SrcSize, Dst, DstSize);
+  }
+
+  //
+  // A jump table gives the size of the first three streams
+  //
+  if (SrcSize < 6) {
+    return RETURN_INVALID_PARAMETER;
+  }
+  StreamSize[0] = ReadUnaligned16 ((CONST UINT16 *)Src);
+  StreamSize[1] = ReadUnaligned16 ((CONST UINT16 *)(Src + 2));
+  StreamSize[2] = ReadUnaligned16 ((CONST UINT16 *)(Src + 4));
+  Total = StreamSize[0] + StreamSize[1] + StreamSize[2] + 6;
+  if (Total > SrcSize) {
+    return RETURN_INVALID_PARAMETER;
+  }
+  StreamSize[3] = SrcSize - Total;
+  Src += 6;
+
+  SegmentSize = (DstSize + 3) / 4;
+  if (SegmentSize * 3 > DstSize) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  for (Index = 0; Index < 4; Index++) {
+    Status = ZstdDecodeHufStream (Table, Src, StreamSize[Index], Dst,
+                                  (Index < 3) ? SegmentSize : (DstSize - SegmentSize * 3));
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+    Src += StreamSize[Index];
+    Dst += SegmentSize;
+  }
+
+  return RETURN_SUCCESS;
+}
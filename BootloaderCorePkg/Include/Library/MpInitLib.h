@@ -1,6 +1,6 @@
 /** @file
 
-  Copyright (c) 2016 - 2019, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2016 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -91,6 +91,30 @@ MpRunTask (
   );
 
 
+/**
+  Run a set of independent jobs on the BSP and the idle APs, and wait for
+  all of them to complete.
+
+  The APs only take jobs between the EnumMpInitRun and EnumMpInitDone phases.
+  Outside of it all jobs run on the BSP. Refer to ScheduleCpuJobs() for the
+  restrictions on job functions.
+
+  @param[in, out] Jobs        The jobs to run. The Result of each job is
+                              updated on return.
+  @param[in]      JobCount    The number of jobs.
+
+  @retval EFI_INVALID_PARAMETER   Jobs is NULL or a job has no function.
+  @retval EFI_SUCCESS             All jobs have completed.
+
+**/
+EFI_STATUS
+EFIAPI
+MpRunJobs (
+  IN OUT CPU_JOB    *Jobs,
+  IN     UINT32      JobCount
+  );
+
+
 /**
   Dump MP task state
 
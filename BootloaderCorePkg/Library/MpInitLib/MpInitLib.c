@@ -1,7 +1,7 @@
 /** @file
   MP init library implementation.
 
-  Copyright (c) 2015 - 2022, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2015 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -13,6 +13,7 @@ STATIC volatile ALL_CPU_TASK              mSysCpuTask;
 STATIC volatile MP_DATA_EXCHANGE_STRUCT   mMpDataStruct;
 STATIC UINT8                             *mBackupBuffer;
 STATIC UINT32                             mMpInitPhase = EnumMpInitNull;
+STATIC UINT32                             mExpectedCpuCount;
 STATIC SMMBASE_INFO                      *mSmmBaseInfo;
 STATIC MTRR_SETTINGS                      mMtrrTable;
 extern UINT8                             *mDefaultSmiHandlerStart;
@@ -247,6 +248,57 @@ CpuInit (
   return EFI_SUCCESS;
 }
 
+/**
+  Get the number of CPU threads expected to check in.
+
+  The count is read from the CPUID extended topology leaf of the package.
+  It reflects the package as shipped, so that it can be larger than the
+  number of threads enabled on the platform.
+
+  @retval  The expected number of CPU threads including the BSP, or 0 if the
+           topology leaf is not supported.
+
+**/
+STATIC
+UINT32
+GetExpectedCpuCount (
+  VOID
+  )
+{
+  UINT32                         MaxLeaf;
+  UINT32                         Leaf;
+  UINT32                         SubLeaf;
+  UINT32                         Count;
+  CPUID_EXTENDED_TOPOLOGY_EBX    Ebx;
+  CPUID_EXTENDED_TOPOLOGY_ECX    Ecx;
+
+  AsmCpuid (CPUID_SIGNATURE, &MaxLeaf, NULL, NULL, NULL);
+  if (MaxLeaf < CPUID_EXTENDED_TOPOLOGY) {
+    return 0;
+  }
+
+  // Prefer the V2 leaf, which also covers the die and module levels
+  Leaf = CPUID_EXTENDED_TOPOLOGY;
+  if (MaxLeaf >= CPUID_V2_EXTENDED_TOPOLOGY) {
+    AsmCpuidEx (CPUID_V2_EXTENDED_TOPOLOGY, 0, NULL, &Ebx.Uint32, NULL, NULL);
+    if (Ebx.Uint32 != 0) {
+      Leaf = CPUID_V2_EXTENDED_TOPOLOGY;
+    }
+  }
+
+  // The last valid level holds the thread count of the whole package
+  Count = 0;
+  for (SubLeaf = 0; SubLeaf < 8; SubLeaf++) {
+    AsmCpuidEx (Leaf, SubLeaf, NULL, &Ebx.Uint32, &Ecx.Uint32, NULL);
+    if (Ecx.Bits.LevelType == CPUID_EXTENDED_TOPOLOGY_LEVEL_TYPE_INVALID) {
+      break;
+    }
+    Count = Ebx.Bits.LogicalProcessors;
+  }
+
+  return MIN (Count, FixedPcdGet32 (PcdCpuMaxLogicalProcessorNumber));
+}
+
 
 /**
   AP initialization routine.
@@ -263,8 +315,10 @@ ApFunc (
   )
 {
   BOOLEAN            WaitTask;
+  BOOLEAN            UseMwait;
   CPU_TASK_FUNC      ApRunTask;
   volatile UINT8     *State;
+  CPUID_VERSION_INFO_ECX  VersionInfoEcx;
 
   // Enable more CPU featurs
   AsmEnableAvx ();
@@ -279,6 +333,13 @@ ApFunc (
   //
   InterlockedIncrement (&mMpDataStructPtr->ApDoneCounter);
 
+  //
+  // Park on the task state with MONITOR/MWAIT if supported. The CPUID bit is
+  // cleared when MWAIT is disabled through MSR_IA32_MISC_ENABLE.
+  //
+  AsmCpuid (CPUID_VERSION_INFO, NULL, NULL, &VersionInfoEcx.Uint32, NULL);
+  UseMwait = (BOOLEAN)(VersionInfoEcx.Bits.MONITOR == 1);
+
   //
   // Enter task loop
   //
@@ -287,7 +348,15 @@ ApFunc (
   *State = EnumCpuReady;
   while (WaitTask) {
     while (*State == EnumCpuReady) {
-      CpuPause ();
+      if (UseMwait) {
+        // Any write to the monitored line wakes the AP up, so check again
+        AsmMonitor ((UINTN)State, 0, 0);
+        if (*State == EnumCpuReady) {
+          AsmMwait (0, 0);
+        }
+      } else {
+        CpuPause ();
+      }
     }
     switch (*State) {
     case EnumCpuEnd:
@@ -478,11 +547,26 @@ MpInit (
       }
 
       //
-      // Send Init-SIPI-SIPI to all APs and wait for completion
-      // It includes a 200us delay for AP's check-in
-      // If it is not long enough, extra delay can be added after this call
+      // Send Init-SIPI-SIPI to all APs. The second SIPI is only needed by
+      // APs that missed the first one, so skip it and the 200us delay once
+      // the thread count from CPUID has checked in. The CPUID count reflects
+      // the package as shipped, so it can be larger than the number of
+      // enabled threads, in which case the full sequence is used.
       //
-      SendInitSipiSipiAllExcludingSelf ((UINT32)(UINTN)ApBuffer);
+      ApCounter = (volatile UINT32 *)&ApDataPtr->ApCounter;
+      mExpectedCpuCount = GetExpectedCpuCount ();
+      SendInitIpiAllExcludingSelf ();
+      MicroSecondDelay (PcdGet32 (PcdCpuInitIpiDelayInMicroSeconds));
+      SendStartupIpiAllExcludingSelf ((UINT32)(UINTN)ApBuffer);
+      for (TimeOutCounter = 0; TimeOutCounter < AP_SIPI_WAIT_CNT; TimeOutCounter++) {
+        if ((mExpectedCpuCount > 0) && (*ApCounter + 1 >= mExpectedCpuCount)) {
+          break;
+        }
+        MicroSecondDelay (AP_SIPI_WAIT_UNIT);
+      }
+      if (TimeOutCounter == AP_SIPI_WAIT_CNT) {
+        SendStartupIpiAllExcludingSelf ((UINT32)(UINTN)ApBuffer);
+      }
 
       CpuInit (0);
 
@@ -507,10 +591,11 @@ MpInit (
         MicroSecondDelay (AP_TASK_TIMEOUT_UNIT);
         TimeOutCounter++ ;
       }
+      AddMeasurePoint (0x3070);
 
 
       CpuCount = (*ApCounter) + 1;
-      DEBUG ((DEBUG_INFO, "Detected %d CPU threads\n", CpuCount));
+      DEBUG ((DEBUG_INFO, "Detected %d CPU threads (%d expected)\n", CpuCount, mExpectedCpuCount));
       if (TimeOutCounter == AP_TASK_TIMEOUT_CNT) {
         DEBUG ((DEBUG_INFO, "MPINIT timeout with %d APs completed.\n", mMpDataStruct.ApDoneCounter));
       }
@@ -540,6 +625,9 @@ MpInit (
       // Restore AP buffer (needed for S3)
       CopyMem (ApBuffer, mBackupBuffer, AP_BUFFER_SIZE);
       mMpInitPhase = EnumMpInitRun;
+
+      // Let library code such as decompression run its jobs on the APs
+      SetDefaultCpuJobTask (MpGetTask ());
     }
   }
 
@@ -559,8 +647,14 @@ MpInit (
             MpRunTask (Index, SetCpuMtrrsTask, (UINT64)(UINTN)&mMtrrTable);
           }
         }
-        // Allow MTRR sync to complete
-        MicroSecondDelay (100);
+        // Wait for MTRR sync to complete
+        TimeOutCounter = 0;
+        for (Index = 1; Index < mSysCpuTask.CpuCount; Index++) {
+          while ((mSysCpuTask.CpuTask[Index].State != EnumCpuReady) && (TimeOutCounter < AP_TASK_TIMEOUT_CNT)) {
+            MicroSecondDelay (AP_TASK_TIMEOUT_UNIT);
+            TimeOutCounter++;
+          }
+        }
       }
 
       for (Index = 1; Index < mSysCpuTask.CpuCount; Index++) {
@@ -571,8 +665,15 @@ MpInit (
       }
 
       // Send an Init IPI to all the APs to put them back in WFS state
+      SetDefaultCpuJobTask (NULL);
       SendInitIpiAllExcludingSelf();
 
+      // The APs do not run tasks anymore, so that the task table passed to
+      // the payload must not show them as ready
+      for (Index = 1; Index < mSysCpuTask.CpuCount; Index++) {
+        mSysCpuTask.CpuTask[Index].State = EnumCpuEnd;
+      }
+
       mMpInitPhase = EnumMpInitDone;
     }
   }
@@ -649,6 +750,41 @@ MpRunTask (
 }
 
 
+/**
+  Run a set of independent jobs on the BSP and the idle APs, and wait for
+  all of them to complete.
+
+  The APs only take jobs between the EnumMpInitRun and EnumMpInitDone phases.
+  Outside of it all jobs run on the BSP. Refer to ScheduleCpuJobs() for the
+  restrictions on job functions.
+
+  @param[in, out] Jobs        The jobs to run. The Result of each job is
+                              updated on return.
+  @param[in]      JobCount    The number of jobs.
+
+  @retval EFI_INVALID_PARAMETER   Jobs is NULL or a job has no function.
+  @retval EFI_SUCCESS             All jobs have completed.
+
+**/
+EFI_STATUS
+EFIAPI
+MpRunJobs (
+  IN OUT CPU_JOB    *Jobs,
+  IN     UINT32      JobCount
+  )
+{
+  SYS_CPU_TASK   *SysCpuTask;
+
+  // APs are only waiting for tasks after the Run phase and until the Done phase
+  SysCpuTask = NULL;
+  if (mMpInitPhase == EnumMpInitRun) {
+    SysCpuTask = MpGetTask ();
+  }
+
+  return ScheduleCpuJobs (SysCpuTask, Jobs, JobCount);
+}
+
+
 /**
   Dump MP task running state
 
@@ -1,6 +1,6 @@
 /** @file
 
-  Copyright (c) 2018 - 2021, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2018 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -24,7 +24,9 @@
 #include <Library/ExtraBaseLib.h>
 #include <Library/BootloaderCoreLib.h>
 #include <Library/S3SaveRestoreLib.h>
+#include <Library/LoaderPerformanceLib.h>
 #include <Register/Intel/ArchitecturalMsr.h>
+#include <Register/Intel/Cpuid.h>
 #include <Guid/SmmS3CommunicationInfoGuid.h>
 
 #define   AP_BUFFER_ADDRESS        0x38000
@@ -34,6 +36,9 @@
 #define   AP_STACK_SIZE            (1<<AP_STACK_SIZE_SHIFT_BITS)
 #define   AP_TASK_TIMEOUT_UNIT     15
 #define   AP_TASK_TIMEOUT_CNT      1000
+// Polls for AP check-in between the two Start-up IPIs, 200us in total
+#define   AP_SIPI_WAIT_UNIT        10
+#define   AP_SIPI_WAIT_CNT         20
 
 #define   RSM_SIG                  0x9090AA0F  /// Opcode for 'rsm'
 
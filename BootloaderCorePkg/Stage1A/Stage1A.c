@@ -1,6 +1,6 @@
 /** @file
 
-  Copyright (c) 2016 - 2019, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2016 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -24,7 +24,8 @@ CONST DEBUG_LOG_BUFFER_HEADER mLogBufHdrTmpl = {
   0,
   {0, 0},
   sizeof (DEBUG_LOG_BUFFER_HEADER),
-  FixedPcdGet32 (PcdEarlyLogBufferSize)
+  FixedPcdGet32 (PcdEarlyLogBufferSize),
+  0
 };
 
 //
@@ -372,6 +373,13 @@ SecStartup2 (
   BoardInit (PostTempRamInit);
   AddMeasurePoint (0x1040);
 
+  // Keep the serial debug output in the log buffer and drain it as the UART has room
+  if (FeaturePcdGet (PcdDeferredSerialOutput) &&
+      ((PcdGet32 (PcdDebugOutputDeviceMask) & DEBUG_OUTPUT_DEVICE_LOG_BUFFER) != 0) &&
+      ((PcdGet32 (PcdDebugOutputDeviceMask) & DEBUG_OUTPUT_DEVICE_SERIAL_PORT) != 0)) {
+    DebugLogBufferDefer (TRUE);
+  }
+
   // Set DebugPrintErrorLevel to default PCD.
   SetDebugPrintErrorLevel (PcdGet32 (PcdDebugPrintErrorLevel));
 
@@ -413,6 +421,7 @@ SecStartup2 (
     Status = PeCoffRelocateImage (StageHdr->Base);
     if (!EFI_ERROR (Status)) {
       EnableCodeExecution ();
+      DebugLogBufferTraceImageBase (Src, Dst);
       ContinueEntry = (STAGE_ENTRY)(UINTN)((UINT32)(Delta + (UINTN)ContinueFunc));
     } else {
       CpuHalt ("Relocation failed!\n");
@@ -566,6 +575,7 @@ ContinueFunc (
 
   // Jump into Stage 1B entry
   if (StageBase != 0) {
+    DebugLogBufferTraceImageBase (PcdGet32 (PcdStage1BFdBase), StageBase);
     PeCoffFindAndReportImageInfo ((UINT32)(UINTN)GET_STAGE_MODULE_BASE (StageBase));
     StageEntry = (STAGE_ENTRY) GET_STAGE_MODULE_ENTRY (StageBase);
     if (StageEntry != NULL) {
@@ -1,6 +1,6 @@
 /** @file
 
-  Copyright (c) 2016 - 2023, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2016 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -102,6 +102,7 @@ PrepareStage2 (
     AddMeasurePoint (0x20D0);
   }
 
+  DebugLogBufferTraceImageBase (PcdGet32 (PcdStage2FdBase), Dst);
   DEBUG ((DEBUG_INFO, "Loaded STAGE2 @ 0x%08X\n", Dst));
 
   return Dst;
@@ -395,6 +396,10 @@ SecStartup2 (
 
   CreateConfigDatabase (LdrGlobal, &Stage1bParam);
 
+  // Index the final config database for the lookups of all stages
+  Status = BuildConfigDataIndex ();
+  DEBUG ((DEBUG_INFO, "Build CFG Data index ... %r\n", Status));
+
   // Overwrite platform ID if CFGDATA contains it
   PidCfgData = (PLATFORMID_CFG_DATA *)FindConfigDataByTag (CDATA_PLATFORMID_TAG);
   if ((PidCfgData != NULL) && (PidCfgData->PlatformId < 32)) {
@@ -573,6 +578,9 @@ SecStartup2 (
   if (LdrGlobal->LogBufPtr != NULL) {
     if (PcdGet32 (PcdEarlyLogBufferSize) < PcdGet32 (PcdLogBufferSize)) {
       // If log buffer needs to be bigger post memory, increase it.
+      // Write the deferred serial output first, the copy below does not keep
+      // the part that wrapped around in the early log buffer.
+      DebugLogBufferDrain (TRUE);
       OldLogBuf = (DEBUG_LOG_BUFFER_HEADER *)LdrGlobal->LogBufPtr;
       NewLogBuf = (DEBUG_LOG_BUFFER_HEADER *)AllocatePool (PcdGet32 (PcdLogBufferSize));
       if (NewLogBuf != NULL) {
@@ -1,6 +1,6 @@
 /** @file
 
-  Copyright (c) 2016 - 2023, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2016 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -147,6 +147,8 @@ NormalBootPath (
   UINT32                          InitRdLen;
   UINT8                          *CmdLine;
   UINT32                          CmdLineLen;
+  COMPONENT_LOAD_REQUEST          LinuxComp[2];
+  SYS_CPU_TASK                   *SysCpuTask;
   UINT32                          UefiSig;
   UINT32                          HobSize;
   UINT16                          PldMachine;
@@ -219,9 +221,20 @@ NormalBootPath (
         InitRdLen  = 0;
         CmdLine    = NULL;
         CmdLineLen = 0;
-        Status = LoadComponent (FLASH_MAP_SIG_EPAYLOAD, SIGNATURE_32 ('C', 'M', 'D', 'L'),
-                                (VOID **)&CmdLine, &CmdLineLen);
+
+        // Load the command line and the InitRd together, so that the idle
+        // APs help with copying, hashing and decompressing them
+        ZeroMem (LinuxComp, sizeof (LinuxComp));
+        LinuxComp[0].ComponentName = SIGNATURE_32 ('C', 'M', 'D', 'L');
+        LinuxComp[1].ComponentName = SIGNATURE_32 ('I', 'N', 'R', 'D');
+        // The task table is only set while the APs are waiting for tasks
+        SysCpuTask = GetDefaultCpuJobTask ();
+        LoadComponentList (FLASH_MAP_SIG_EPAYLOAD, LinuxComp, ARRAY_SIZE (LinuxComp), NULL, SysCpuTask);
+
+        Status = LinuxComp[0].Status;
         if (!EFI_ERROR (Status)) {
+          CmdLine    = LinuxComp[0].Buffer;
+          CmdLineLen = LinuxComp[0].Length;
           // Limit max command line length
           if (CmdLineLen > CMDLINE_LENGTH_MAX - 1) {
             CmdLineLen = CMDLINE_LENGTH_MAX - 1;
@@ -230,14 +243,15 @@ NormalBootPath (
           DEBUG ((DEBUG_INFO, "Kernel command line: \n%a\n", CmdLine));
         }
 
-        // Try to load InitRd if it exists. If loading fails, continue booting
-        Status = LoadComponent (FLASH_MAP_SIG_EPAYLOAD, SIGNATURE_32 ('I', 'N', 'R', 'D'),
-                                (VOID **)&InitRd, &InitRdLen);
+        // InitRd is optional. If loading fails, continue booting
+        Status = LinuxComp[1].Status;
         if (!EFI_ERROR (Status)) {
+          InitRd    = LinuxComp[1].Buffer;
+          InitRdLen = LinuxComp[1].Length;
           DEBUG ((DEBUG_INFO, "InitRD is loaded at 0x%x:0x%x\n", InitRd, InitRdLen));
         }
         PldEntry = (PAYLOAD_ENTRY)(UINTN)LinuxBoot;
-        Status   = LoadBzImage (Dst, InitRd, InitRdLen, CmdLine, CmdLineLen);
+        Status   = LoadBzImage (Dst, Stage2Param->PayloadActualLength, InitRd, InitRdLen, CmdLine, CmdLineLen);
       }
     }
 
@@ -317,6 +331,8 @@ NormalBootPath (
       }
     }
     DEBUG ((DEBUG_INIT, "Jump to payload\n\n"));
+    // Write out the deferred serial output before the payload owns the UART
+    DebugLogBufferDefer (FALSE);
     if (PldMachine == IMAGE_FILE_MACHINE_X64) {
       // Need to call in x64 long mode
       Execute64BitCode ((UINT64)(UINTN)PldEntry, (UINT64)(UINTN)PldHobList,
@@ -2,7 +2,7 @@
 ## @ CommonUtility.py
 # Common utility script
 #
-# Copyright (c) 2016 - 2020, Intel Corporation. All rights reserved.<BR>
+# Copyright (c) 2016 - 2026, Intel Corporation. All rights reserved.<BR>
 # SPDX-License-Identifier: BSD-2-Clause-Patent
 #
 ##
@@ -71,6 +71,9 @@ HASH_DIGEST_SIZE = {
             "SM3_256"     : 32,
     }
 
+# Uncompressed size of each independently compressed block of the LZ4B format
+LZ4B_BLOCK_SIZE = 0x40000
+
 class PUB_KEY_HDR (Structure):
     _pack_ = 1
     _fields_ = [
@@ -110,8 +113,11 @@ class LZ_HEADER(Structure):
     _compress_alg = {
         b'LZDM' : 'Dummy',
         b'LZ4 ' : 'Lz4',
+        b'LZ4B' : 'Lz4B',
         b'LZMA' : 'Lzma',
+        b'LZST' : 'Zstd',
     }
+    _alg_names = dict((alg.lower(), alg) for alg in _compress_alg.values())
 
 def print_bytes (data, indent=0, offset=0, show_ascii = False):
     bytes_per_line = 16
@@ -324,6 +330,35 @@ def gen_pub_key (in_key, pub_key = None):
 
     return key
 
+def lz4_block_compress (data, block_size):
+    # Block-parallel LZ4 (LZ4B): a header with the original size, the block
+    # size and the block count, then the offsets of the compressed blocks,
+    # plus the end offset, relative to the start of the header.
+    import lz4.block
+    blocks = [lz4.block.compress(data[idx:idx + block_size], mode='high_compression', store_size=False)
+              for idx in range(0, len(data), block_size)]
+    offset = 4 * (3 + len(blocks) + 1)
+    table  = []
+    for block in blocks:
+        table.append (offset)
+        offset += len(block)
+    table.append (offset)
+    out = bytearray (struct.pack('<III', len(data), block_size, len(blocks)))
+    out.extend (struct.pack('<%dI' % len(table), *table))
+    for block in blocks:
+        out.extend (block)
+    return out
+
+def lz4_block_decompress (data):
+    import lz4.block
+    size, block_size, count = struct.unpack_from('<III', data)
+    table = struct.unpack_from('<%dI' % (count + 1), data, 12)
+    out = bytearray ()
+    for idx in range(count):
+        out.extend (lz4.block.decompress(bytes(data[table[idx]:table[idx + 1]]),
+                    uncompressed_size=min(block_size, size - idx * block_size)))
+    return out
+
 def decompress (in_file, out_file, tool_dir = ''):
     if not os.path.isfile(in_file):
         raise Exception ("Invalid input file '%s' !" % in_file)
@@ -346,6 +381,10 @@ def decompress (in_file, out_file, tool_dir = ''):
         alg = "Lzma"
     elif lz_hdr.signature == b"LZ4 ":
         alg = "Lz4"
+    elif lz_hdr.signature == b"LZ4B":
+        alg = "Lz4B"
+    elif lz_hdr.signature == b"LZST":
+        alg = "Zstd"
     else:
         raise Exception ("Unsupported compression '%s' !" % lz_hdr.signature)
 
@@ -354,13 +393,15 @@ def decompress (in_file, out_file, tool_dir = ''):
     fo.close()
 
     compress_tool = "%sCompress" % alg
-    if alg == "Lz4":
+    if alg in ["Lz4", "Lz4B"]:
         try:
             cmdline = [
-                os.path.join (tool_dir, compress_tool),
+                os.path.join (tool_dir, "Lz4Compress"),
                 "-d",
                 "-o", out_file,
                 temp]
+            if alg == "Lz4B":
+                cmdline[2:2] = ["-b", "0"]
             run_process (cmdline, False, True)
         except:
             print("Could not find/use CompressLz4 tool, trying with python lz4...")
@@ -371,7 +412,10 @@ def decompress (in_file, out_file, tool_dir = ''):
             except ImportError:
                 print("Could not import lz4, use 'python -m pip install lz4==3.1.1' to install it.")
                 exit(1)
-            decompress_data = lz4.block.decompress(get_file_data(temp))
+            if alg == "Lz4B":
+                decompress_data = lz4_block_decompress(get_file_data(temp))
+            else:
+                decompress_data = lz4.block.decompress(get_file_data(temp))
             with open(out_file, "wb") as lz4bin:
                 lz4bin.write(decompress_data)
     else:
@@ -402,6 +446,10 @@ def compress (in_file, alg, svn=0, out_path = '', tool_dir = ''):
         sig = "LZUF"
     elif alg == "Lz4":
         sig = "LZ4 "
+    elif alg == "Lz4B":
+        sig = "LZ4B"
+    elif alg == "Zstd":
+        sig = "LZST"
     elif alg == "Dummy":
         sig = "LZDM"
     else:
@@ -413,13 +461,15 @@ def compress (in_file, alg, svn=0, out_path = '', tool_dir = ''):
         if sig == "LZDM":
             shutil.copy(in_file, out_file)
             compress_data = get_file_data(out_file)
-        elif sig == "LZ4 ":
+        elif sig in ["LZ4 ", "LZ4B"]:
             try:
                 cmdline = [
-                    os.path.join (tool_dir, compress_tool),
+                    os.path.join (tool_dir, "Lz4Compress"),
                     "-e",
                     "-o", out_file,
                     in_file]
+                if sig == "LZ4B":
+                    cmdline[2:2] = ["-b", str(LZ4B_BLOCK_SIZE)]
                 run_process (cmdline, False, True)
                 compress_data = get_file_data(out_file)
             except:
@@ -431,8 +481,11 @@ def compress (in_file, alg, svn=0, out_path = '', tool_dir = ''):
                 except ImportError:
                     print("Could not import lz4, use 'python -m pip install lz4==3.1.1' to install it.")
                     exit(1)
-                compress_data = lz4.block.compress(get_file_data(in_file), mode='high_compression')
-        elif sig == "LZMA":
+                if sig == "LZ4B":
+                    compress_data = lz4_block_compress(get_file_data(in_file), LZ4B_BLOCK_SIZE)
+                else:
+                    compress_data = lz4.block.compress(get_file_data(in_file), mode='high_compression')
+        elif sig in ["LZMA", "LZST"]:
             cmdline = [
                 os.path.join (tool_dir, compress_tool),
                 "-e",
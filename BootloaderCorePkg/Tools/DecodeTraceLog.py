@@ -0,0 +1,406 @@
+#!/usr/bin/env python3
+## @ DecodeTraceLog.py
+# This script renders a Slim Bootloader debug log buffer that contains binary
+# trace records (ENABLE_BINARY_TRACE_LOG) into text
+#
+# Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+##
+
+import os
+import re
+import sys
+import struct
+import argparse
+
+DEBUG_LOG_BUFFER_SIGNATURE      = b'DLOG'
+DEBUG_LOG_BUFFER_ATTRIBUTE_FULL = 0x01
+DEBUG_LOG_TRACE_MARKER          = 0xFF
+DEBUG_LOG_TRACE_MAX_LENGTH      = 0x100
+
+DEBUG_LOG_TRACE_TYPE_MESSAGE    = 0
+DEBUG_LOG_TRACE_TYPE_IMAGE_BASE = 1
+
+# DEBUG_LOG_BUFFER_HEADER without the fields added later
+LOG_BUFFER_HEADER   = struct.Struct('<4sBBHII')
+# DEBUG_LOG_TRACE_RECORD: Marker, Type, Length, Format, TimeStamp
+TRACE_RECORD_HEADER = struct.Struct('<BBHIQ')
+# Image base record: the UINT32 link base follows the header
+IMAGE_BASE_RECORD_LENGTH = TRACE_RECORD_HEADER.size + 4
+
+STAGE_IMAGES = ['STAGE1A', 'STAGE1B', 'STAGE2']
+
+# RETURN_STATUS strings of MdePkg BasePrintLib
+WARNING_STRINGS = [
+    'Success', 'Warning Unknown Glyph', 'Warning Delete Failure', 'Warning Write Failure',
+    'Warning Buffer Too Small', 'Warning Stale Data', 'Warning File System', 'Warning Reset Required'
+]
+ERROR_STRINGS = [
+    'Load Error', 'Invalid Parameter', 'Unsupported', 'Bad Buffer Size', 'Buffer Too Small',
+    'Not Ready', 'Device Error', 'Write Protected', 'Out of Resources', 'Volume Corrupt',
+    'Volume Full', 'No Media', 'Media changed', 'Not Found', 'Access Denied', 'No Response',
+    'No mapping', 'Time out', 'Not started', 'Already started', 'Aborted', 'ICMP Error',
+    'TFTP Error', 'Protocol Error', 'Incompatible Version', 'Security Violation', 'CRC Error',
+    'End of Media', 'Reserved (29)', 'Reserved (30)', 'End of File', 'Invalid Language',
+    'Compromised Data'
+]
+
+
+class TraceImage:
+    def __init__(self, path, base):
+        self.path  = path
+        self.base  = base
+        # Addresses the image runs at, the link base last
+        self.bases = [base]
+        with open(path, 'rb') as fd:
+            self.data = fd.read()
+
+    def contains(self, address):
+        return 0 <= address - self.base < len(self.data)
+
+    def add_runtime_base(self, link_base, runtime_base):
+        base = runtime_base - (link_base - self.base)
+        if base not in self.bases:
+            self.bases.insert(0, base)
+
+    def get_string(self, address):
+        for base in self.bases:
+            offset = address - base
+            if offset < 0 or offset >= len(self.data):
+                continue
+            end = self.data.find(b'\0', offset)
+            if end < 0:
+                return None
+            return self.data[offset:end].decode('latin-1')
+        return None
+
+
+class TraceArgs:
+    def __init__(self, data):
+        self.data = data
+        self.pos  = 0
+
+    def take(self, size):
+        if self.pos + size > len(self.data):
+            raise ValueError('argument data is too short')
+        value = self.data[self.pos:self.pos + size]
+        self.pos += size
+        return value
+
+    def take_int(self, size):
+        return int.from_bytes(self.take(size), 'little')
+
+    def take_string(self):
+        return self.take(self.take_int(1)).decode('latin-1')
+
+
+def load_stage_images(fv_dir, plat_dsc):
+    # Stage images are linked to run at their FD base, which the build
+    # exports to Platform.dsc. A stage running elsewhere logs its runtime base.
+    defines = {}
+    with open(plat_dsc, 'r') as fd:
+        for line in fd:
+            match = re.match(r'^\s*DEFINE\s+(\w+)\s*=\s*(\S+)', line)
+            if match:
+                defines[match.group(1)] = match.group(2)
+
+    images = []
+    for stage in STAGE_IMAGES:
+        path = os.path.join(fv_dir, '%s.fd' % stage)
+        var  = '%s_FD_BASE' % stage
+        if os.path.exists(path) and var in defines:
+            images.append(TraceImage(path, int(defines[var], 0)))
+    return images
+
+
+def get_log_data(raw):
+    # Memory dump of the log buffer starting from its header
+    if raw[:4] == DEBUG_LOG_BUFFER_SIGNATURE and len(raw) >= LOG_BUFFER_HEADER.size:
+        _, hdr_len, attr, _, used_len, total_len = LOG_BUFFER_HEADER.unpack_from(raw)
+        if attr & DEBUG_LOG_BUFFER_ATTRIBUTE_FULL:
+            return raw[used_len:total_len] + raw[hdr_len:used_len], True
+        return raw[hdr_len:used_len], False
+
+    # Serial capture of the log buffer printed by OsLoader
+    idx = raw.rfind(b'LOGBUF:')
+    if idx >= 0:
+        return raw[idx + 7:], False
+
+    return raw, False
+
+
+def parse_record(data, pos):
+    # Type, length, format address and timestamp of the trace record at pos
+    if pos + TRACE_RECORD_HEADER.size > len(data):
+        return None
+    _, rec_type, length, addr, tsc = TRACE_RECORD_HEADER.unpack_from(data, pos)
+    if length < TRACE_RECORD_HEADER.size or length > DEBUG_LOG_TRACE_MAX_LENGTH or pos + length > len(data):
+        return None
+    return rec_type, length, addr, tsc
+
+
+def get_image_base_link(data, pos, length, images):
+    # The stage image that an image base record is about, and its link base
+    if length != IMAGE_BASE_RECORD_LENGTH:
+        return None, 0
+    link_base = int.from_bytes(data[pos + TRACE_RECORD_HEADER.size:pos + length], 'little')
+    for image in images:
+        if image.contains(link_base):
+            return image, link_base
+    return None, 0
+
+
+def add_image_bases(data, images):
+    # Stages that got relocated, e.g. Stage1A copied into temporary memory or
+    # Stage2 loaded high, write their runtime base to the log. Collect them
+    # all first so that the records of a wrapped ring can be found from its
+    # first valid one.
+    pos = 0
+    while pos < len(data):
+        if data[pos] == DEBUG_LOG_TRACE_MARKER:
+            record = parse_record(data, pos)
+            if record is not None:
+                rec_type, length, addr, _ = record
+                if rec_type == DEBUG_LOG_TRACE_TYPE_IMAGE_BASE:
+                    image, link_base = get_image_base_link(data, pos, length, images)
+                    if image is not None:
+                        image.add_runtime_base(link_base, addr)
+                pos += length
+                continue
+        pos += 1
+
+
+def is_text(data):
+    return all(byte in b'\r\n\t' or 0x20 <= byte < 0x7F for byte in data)
+
+
+def find_first_message(data, images):
+    # The oldest message of a wrapped ring is partly overwritten. Start from
+    # the first valid trace record, or from the first full text line if only
+    # text comes before that record.
+    rec_pos = len(data)
+    for pos in range(len(data)):
+        if data[pos] == DEBUG_LOG_TRACE_MARKER:
+            tsc, length, message = decode_record(data, pos, images, False)
+            if tsc is not None:
+                rec_pos = pos
+                break
+    line_pos = data.find(b'\n') + 1
+    if 0 < line_pos < rec_pos and is_text(data[line_pos:rec_pos]):
+        return line_pos
+    return rec_pos
+
+
+def get_status_string(status):
+    # The error bit is bit 31 for the IA32 stages and bit 63 for the X64 ones
+    if status & (1 << 63) or (status >> 32 == 0 and status & (1 << 31)):
+        index = status & 0x7FFFFFFF
+        if 0 < index <= len(ERROR_STRINGS):
+            return ERROR_STRINGS[index - 1]
+    elif status < len(WARNING_STRINGS):
+        return WARNING_STRINGS[status]
+    return '%08X' % status
+
+
+def format_message(fmt, args):
+    # Render the format string the same way as MdePkg BasePrintLib
+    out = []
+    idx = 0
+    while idx < len(fmt):
+        char = fmt[idx]
+        idx += 1
+        if char != '%':
+            out.append(char)
+            continue
+
+        left  = sign = blank = comma = zero = long = False
+        width = 0
+        precision = None
+        while idx < len(fmt):
+            char = fmt[idx]
+            if char == '.':
+                precision = 0
+            elif char == '-':
+                left = True
+            elif char == '+':
+                sign = True
+            elif char == ' ':
+                blank = True
+            elif char == ',':
+                comma = True
+            elif char in 'lL':
+                long = True
+            elif char == '*':
+                if precision is None:
+                    width = args.take_int(4)
+                else:
+                    precision = args.take_int(4)
+            elif char.isdigit():
+                if char == '0' and precision is None:
+                    zero = True
+                match = re.match(r'\d+', fmt[idx:])
+                idx  += len(match.group(0)) - 1
+                if precision is None:
+                    width = int(match.group(0))
+                else:
+                    precision = int(match.group(0))
+            else:
+                break
+            idx += 1
+
+        if idx >= len(fmt):
+            break
+        conv = fmt[idx]
+        idx += 1
+
+        if conv in 'dupxX':
+            if conv == 'p':
+                value = args.take_int(8)
+            else:
+                value = args.take_int(8 if long else 4)
+            if conv == 'd':
+                bits = 64 if long else 32
+                if value & (1 << (bits - 1)):
+                    value -= 1 << bits
+            if conv in 'pxX':
+                digits = '%X' % value
+            else:
+                digits = '%d' % abs(value)
+                if comma:
+                    digits = '{:,}'.format(abs(value))
+            prefix = ''
+            if value < 0:
+                prefix = '-'
+            elif sign and conv in 'd':
+                prefix = '+'
+            elif blank and conv in 'd':
+                prefix = ' '
+            if conv == 'X':
+                zero = True
+            if precision is not None:
+                digits = digits.rjust(precision, '0')
+            elif zero and not left and width:
+                digits = digits.rjust(width - len(prefix), '0')
+            text = prefix + digits
+        elif conv == 'r':
+            text = get_status_string(args.take_int(8))
+        elif conv == 'c':
+            text = chr(args.take_int(2))
+        elif conv in 'asS':
+            text = args.take_string()
+        elif conv == 'g':
+            data  = args.take(16)
+            guid  = struct.unpack('<IHH8B', data)
+            text  = '%08X-%04X-%04X-%02X%02X-%02X%02X%02X%02X%02X%02X' % guid
+        else:
+            # '%' and unknown types are printed as they are
+            text = conv
+
+        out.append(text.ljust(width) if left else text.rjust(width))
+
+    return ''.join(out)
+
+
+def decode_record(data, pos, images, unknown = True):
+    record = parse_record(data, pos)
+    if record is None:
+        return None, 0, None
+    rec_type, length, fmt_addr, tsc = record
+
+    if rec_type == DEBUG_LOG_TRACE_TYPE_IMAGE_BASE:
+        # Already applied to the images, nothing to print
+        image, _ = get_image_base_link(data, pos, length, images)
+        if image is None:
+            return None, 0, None
+        return tsc, length, ''
+    if rec_type != DEBUG_LOG_TRACE_TYPE_MESSAGE:
+        if not unknown:
+            return None, 0, None
+        return tsc, length, '<trace record of unknown type %d>\n' % rec_type
+
+    fmt = None
+    for image in images:
+        fmt = image.get_string(fmt_addr)
+        if fmt is not None:
+            break
+    if fmt is None:
+        if not unknown:
+            return None, 0, None
+        return tsc, length, '<trace record with unknown format string at 0x%08X>\n' % fmt_addr
+
+    args = TraceArgs(data[pos + TRACE_RECORD_HEADER.size:pos + length])
+    try:
+        message = format_message(fmt, args)
+    except ValueError:
+        message = '<trace record not matching format string "%s">\n' % fmt.rstrip()
+    return tsc, length, message
+
+
+def decode_log(data, wrapped, images, freq_khz, show_time):
+    out = []
+    pos = find_first_message(data, images) if wrapped else 0
+    while pos < len(data):
+        if data[pos] == DEBUG_LOG_TRACE_MARKER:
+            result = decode_record(data, pos, images)
+            if result[0] is not None:
+                tsc, length, message = result
+                if show_time and message:
+                    if freq_khz:
+                        out.append('[%10.3f ms] ' % (tsc / freq_khz))
+                    else:
+                        out.append('[%016X] ' % tsc)
+                out.append(message)
+                pos += length
+                continue
+        out.append(chr(data[pos]))
+        pos += 1
+
+    return ''.join(out).replace('\r', '')
+
+
+def decode_trace_log(args):
+    images = []
+    if args.fv_dir:
+        if not args.plat_dsc:
+            raise Exception('Platform.dsc path is required to locate the stage images !')
+        images.extend(load_stage_images(args.fv_dir, args.plat_dsc))
+    for image in args.images:
+        path, _, base = image.rpartition('@')
+        if not path:
+            raise Exception("Image '%s' needs to be given as <path>@<base> !" % image)
+        images.append(TraceImage(path, int(base, 0)))
+    if len(images) == 0:
+        raise Exception('No firmware image is given to look up the format strings !')
+
+    with open(args.log_file, 'rb') as fd:
+        raw = fd.read()
+    data, wrapped = get_log_data(raw)
+    add_image_bases(data, images)
+    text = decode_log(data, wrapped, images, args.freq_khz, args.show_time)
+
+    if args.out_file:
+        with open(args.out_file, 'w') as fd:
+            fd.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+def main():
+    parser     = argparse.ArgumentParser()
+    parser.add_argument('log_file', type=str, help='Log buffer memory dump, or serial capture of the LOGBUF output')
+    parser.add_argument('-f',  '--fvdir'  , dest='fv_dir',   type=str, help='Build FV directory containing STAGE1A/1B/2.fd')
+    parser.add_argument('-p',  '--pltdsc' , dest='plat_dsc', type=str, help='Platform.dsc generated by the build')
+    parser.add_argument('-i',  '--image'  , dest='images',   type=str, action='append', default=[],
+                        help='Additional firmware image as <path>@<base>, where base is the address the image is linked at')
+    parser.add_argument('-k',  '--freq'   , dest='freq_khz', type=int, help='Timestamp frequency in KHz to show time in ms', default=0)
+    parser.add_argument('-t',  '--time'   , dest='show_time', action='store_true', help='Prefix the trace messages with the timestamp')
+    parser.add_argument('-o',  '--out'    , dest='out_file', type=str, help='Output text file path')
+    parser.set_defaults(func=decode_trace_log)
+
+    args = parser.parse_args()
+    args.func(args)
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -1,6 +1,6 @@
 ## @ GenCapsuleFirmware.py
 #
-# Copyright (c) 2017-2021, Intel Corporation. All rights reserved.<BR>
+# Copyright (c) 2017 - 2026, Intel Corporation. All rights reserved.<BR>
 # SPDX-License-Identifier: BSD-2-Clause-Patent
 #
 ##
@@ -13,6 +13,8 @@ import re
 import struct
 import uuid
 import binascii
+import hashlib
+import tempfile
 from ctypes import *
 
 sys.dont_write_bytecode = True
@@ -422,6 +424,76 @@ class FirmwareUpdateHeader(Structure):
   ]
 
 
+#
+# Delta payload, see FW_DELTA_HEADER in PayloadPkg/FirmwareUpdate/FirmwareUpdateHelper.h
+#
+FW_DELTA_SIGNATURE     = b'FWDL'
+FW_DELTA_VERSION       = 1
+FW_DELTA_BLOCK_SIZE    = 0x1000
+FW_DELTA_DIGEST_SIZE   = 64
+FW_DELTA_HEADER_FORMAT = '<4sHBBIIIII%ds%ds' % (FW_DELTA_DIGEST_SIZE, FW_DELTA_DIGEST_SIZE)
+FW_DELTA_BLOCK_FORMAT  = '<IB3x'
+
+FW_DELTA_BLOCK_COPY    = 0
+FW_DELTA_BLOCK_DIFF    = 1
+FW_DELTA_BLOCK_LITERAL = 2
+
+def GenDeltaPayload(OldData, NewData, HashType, CompressAlg, ToolDir):
+    #
+    # Each block of the new image is copied from an identical block of the
+    # old image, stored as its byte-wise difference with the old block at the
+    # same offset, or stored as is. The difference of a block changed in a few
+    # places is mostly zeros and compresses far better than the block itself.
+    #
+    if HashType == 'SHA2_384':
+        HashAlg, HashFunc = 2, hashlib.sha384
+    else:
+        HashAlg, HashFunc = 1, hashlib.sha256
+
+    BlockSize  = FW_DELTA_BLOCK_SIZE
+    BlockCount = (len(NewData) + BlockSize - 1) // BlockSize
+    OldBlocks  = {}
+    for Index in range(len(OldData) // BlockSize):
+        OldBlocks.setdefault(OldData[Index * BlockSize:(Index + 1) * BlockSize], Index)
+
+    Table  = bytearray()
+    Stream = bytearray()
+    Counts = [0, 0, 0]
+    for Index in range(BlockCount):
+        Offset = Index * BlockSize
+        New    = NewData[Offset:Offset + BlockSize]
+        Old    = OldData[Offset:Offset + len(New)] if Offset + len(New) <= len(OldData) else None
+        if Old == New:
+            Type, Source = FW_DELTA_BLOCK_COPY, Index
+        elif New in OldBlocks:
+            Type, Source = FW_DELTA_BLOCK_COPY, OldBlocks[New]
+        else:
+            Diff = bytes((NewByte - OldByte) & 0xFF for NewByte, OldByte in zip(New, Old)) if Old else None
+            if Diff and Diff.count(0) * 2 >= len(New):
+                Type, Source = FW_DELTA_BLOCK_DIFF, Index
+                Stream.extend(Diff)
+            else:
+                Type, Source = FW_DELTA_BLOCK_LITERAL, 0
+                Stream.extend(New)
+        Counts[Type] += 1
+        Table.extend(struct.pack(FW_DELTA_BLOCK_FORMAT, Source, Type))
+
+    with tempfile.TemporaryDirectory() as TempDir:
+        StreamFile = os.path.join(TempDir, 'fwdelta_stream.bin')
+        LzFile     = os.path.join(TempDir, 'fwdelta_stream.lz')
+        open(StreamFile, 'wb').write(Stream)
+        compress(StreamFile, CompressAlg, 0, LzFile, ToolDir)
+        LzData = open(LzFile, 'rb').read()
+
+    Header = struct.pack(FW_DELTA_HEADER_FORMAT, FW_DELTA_SIGNATURE, struct.calcsize(FW_DELTA_HEADER_FORMAT),
+                         FW_DELTA_VERSION, HashAlg, BlockSize, len(OldData), len(NewData), BlockCount, len(LzData),
+                         HashFunc(OldData).digest(), HashFunc(NewData).digest())
+    Delta = Header + Table + LzData
+    print('Delta payload: 0x%X bytes for a 0x%X byte image (%d copy, %d diff, %d literal blocks)' %
+          (len(Delta), len(NewData), Counts[FW_DELTA_BLOCK_COPY], Counts[FW_DELTA_BLOCK_DIFF], Counts[FW_DELTA_BLOCK_LITERAL]))
+    return Delta
+
+
 def SignImage(RawData, OutFile, HashType, SignScheme, PrivKey, ForceBiosUpdate):
 
     #
@@ -503,6 +575,9 @@ def main():
     parser.add_argument('-o',  '--output', dest='NewImage', type=str, required=True, help='Output file for signed image')
     parser.add_argument("-v",  "--verbose", dest='Verbose', action="store_true", help= "Turn on verbose output with informational messages printed, including capsule headers and warning messages.")
     parser.add_argument("-f",  "--force_bios_update", dest='ForceBiosUpdate', action="store_true", help= "Force update whole BIOS region in a single shot.")
+    parser.add_argument('-d',  '--delta', nargs=2, action='append', type=str, default=[], help='Specify delta base including component signature, FileName of the image currently on flash')
+    parser.add_argument('-c',  '--delta_compress', dest='DeltaCompress', type=str, choices=['Lzma', 'Lz4', 'Zstd', 'Dummy'], default='Lzma', help='Compression algorithm for delta payloads')
+    parser.add_argument('-t',  '--tool_dir', dest='ToolDir', type=str, default='', help='Directory of the compression tools')
 
     #
     # Parse command line arguments
@@ -518,11 +593,23 @@ def main():
     if 'BIOS' in PldSigs and SblCompInPldSigs:
         raise Exception ('SBL/BIOS region given with SBL/BIOS region component')
 
+    DeltaBases = {DeltaSig: DeltaFile for DeltaSig, DeltaFile in args.delta}
+    if set(DeltaBases) - PldSigs:
+        raise Exception ('Delta base given for a component without payload')
+
     FmpCapsuleHeader = FmpCapsuleHeaderClass()
     for PldSig, PldFile in args.payload:
 
         FmpPayloadHeader = FmpPayloadHeaderClass()
         Buffer = open(PldFile, 'rb').read()
+        if PldSig == 'BIOS' and args.ForceBiosUpdate and len(Buffer) & 0xFFF:
+            raise Exception ("BIOS component size is not 4KB aligned !")
+        if PldSig in DeltaBases:
+            if ':' in PldSig or PldSig in ['CSME', 'CSMD', 'CMDI']:
+                raise Exception ('Delta is not supported for %s' % PldSig)
+            if PldSig == 'BIOS' and not args.ForceBiosUpdate:
+                raise Exception ("Delta for BIOS requires '-f' flag !")
+            Buffer = GenDeltaPayload(open(DeltaBases[PldSig], 'rb').read(), Buffer, args.HashType, args.DeltaCompress, args.ToolDir)
         Result = Buffer
         FmpPayloadHeader.Payload = Result
         Result = FmpPayloadHeader.Encode()
@@ -561,8 +648,6 @@ def main():
         Payload = FmpCapsuleHeader.GetPayload(0)
         if str(Payload[0]) != UpdateGuidDict['BIOS'].lower():
             raise Exception ("When '-f' flag is enabled, only BIOS component is supported in capsule !")
-        if len(Payload[1]) & 0xFFF:
-            raise Exception ("BIOS component size is not 4KB aligned !")
 
     Result = FmpCapsuleHeader.Encode()
 
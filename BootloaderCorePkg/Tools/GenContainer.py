@@ -2,7 +2,7 @@
 ## @ GenContainer.py
 # Tools to operate on a container image
 #
-# Copyright (c) 2019 - 2023, Intel Corporation. All rights reserved.<BR>
+# Copyright (c) 2019 - 2026, Intel Corporation. All rights reserved.<BR>
 # SPDX-License-Identifier: BSD-2-Clause-Patent
 #
 ##
@@ -555,7 +555,7 @@ class CONTAINER ():
             lz_header = LZ_HEADER.from_buffer(component.data)
             comp_alg  = LZ_HEADER._compress_alg[lz_header.signature]
         else:
-            comp_alg = comp_alg[0].upper() + comp_alg[1:]
+            comp_alg = LZ_HEADER._alg_names.get(comp_alg.lower(), comp_alg[0].upper() + comp_alg[1:])
 
         # verify the new component hash does match the hash stored in the container header
         auth_type_str = self.get_auth_type_str (component.auth_type)
@@ -655,7 +655,7 @@ class CONTAINER ():
                     offset = sizeof(lz_header)
                     data = component.data[offset : offset + lz_header.compressed_len]
                     gen_file_from_object (bin_file, data)
-                elif signature in [b'LZMA', b'LZ4 ']:
+                elif signature in [b'LZMA', b'LZ4 ', b'LZ4B', b'LZST']:
                     decompress (sig_file, bin_file, self.tool_dir)
                 else:
                     raise Exception ("Unknown LZ format!")
@@ -791,7 +791,7 @@ def replace_component (args):
 
 def sign_component (args):
     compress_alg = args.compress
-    compress_alg = compress_alg[0].upper() + compress_alg[1:]
+    compress_alg = LZ_HEADER._alg_names.get(compress_alg.lower(), compress_alg[0].upper() + compress_alg[1:])
 
     #extract out dir and file
     sign_file = os.path.abspath(args.out_file)
@@ -851,7 +851,7 @@ def main():
     cmd_display.add_argument('-o',  dest='out_image',  type=str, default='', help='Container new output image path')
     cmd_display.add_argument('-n',  dest='comp_name',  type=str, required=True, help='Component name to replace')
     cmd_display.add_argument('-f',  dest='comp_file',  type=str, required=True, help='Component input file path')
-    cmd_display.add_argument('-c',  dest='compress', choices=['lz4', 'lzma', 'dummy'], default='dummy', help='compression algorithm')
+    cmd_display.add_argument('-c',  dest='compress', choices=['lz4', 'lz4b', 'lzma', 'zstd', 'dummy'], default='dummy', help='compression algorithm')
     cmd_display.add_argument('-k',  dest='key_file',  type=str, default='', help='Key Id or Private key file path to sign component')
     cmd_display.add_argument('-td', dest='tool_dir', type=str, default='', help='Compression tool directory')
     cmd_display.add_argument('-s', dest='svn', type=int,  default=0, help='Security version number for Component')
@@ -861,7 +861,7 @@ def main():
     cmd_display = sub_parser.add_parser('sign', help='compress and sign a component image')
     cmd_display.add_argument('-f',  dest='comp_file',  type=str, required=True, help='Component input file path')
     cmd_display.add_argument('-o',  dest='out_file',  type=str, default='', help='Signed output image path')
-    cmd_display.add_argument('-c',  dest='compress', choices=['lz4', 'lzma', 'dummy'],  default='dummy', help='compression algorithm')
+    cmd_display.add_argument('-c',  dest='compress', choices=['lz4', 'lz4b', 'lzma', 'zstd', 'dummy'],  default='dummy', help='compression algorithm')
     cmd_display.add_argument('-a',  dest='auth', choices=['SHA2_256', 'SHA2_384', 'RSA2048_PKCS1_SHA2_256',
                 'RSA3072_PKCS1_SHA2_384', 'RSA2048_PSS_SHA2_256', 'RSA3072_PSS_SHA2_384', 'NONE'], default='NONE',  help='authentication algorithm')
     cmd_display.add_argument('-k',  dest='key_file',  type=str, default='', help='Key Id or Private key file path to sign component')
@@ -2,7 +2,7 @@
 ## @ BuildLoader.py
 # Build bootloader main script
 #
-# Copyright (c) 2016 - 2023, Intel Corporation. All rights reserved.<BR>
+# Copyright (c) 2016 - 2026, Intel Corporation. All rights reserved.<BR>
 #  SPDX-License-Identifier: BSD-2-Clause-Patent
 
 ##
@@ -28,7 +28,7 @@ from   BuildUtility import *
 import glob
 
 def rebuild_basetools ():
-    exe_list = 'GenFfs  GenFv  GenFw  GenSec  Lz4Compress  LzmaCompress'.split()
+    exe_list = 'GenFfs  GenFv  GenFw  GenSec  Lz4Compress  LzmaCompress  ZstdCompress'.split()
     ret = 0
     sblsource = os.environ['SBL_SOURCE']
 
@@ -170,9 +170,14 @@ class BaseBoard(object):
         self.ENABLE_SMBIOS         = 0
         self.ENABLE_LINUX_PAYLOAD  = 0
         self.ENABLE_CSME_UPDATE    = 0
+        # Program flash sectors over old data when only bits are cleared.
+        # Keep it disabled for SPI NOR parts with ECC, which forbid that.
+        self.ENABLE_FLASH_PROGRAM_WITHOUT_ERASE = 0
         self.ENABLE_EMMC_HS400     = 1
         self.ENABLE_DMA_PROTECTION = 0
         self.ENABLE_MULTI_USB_BOOT_DEV = 1
+        self.ENABLE_DEFERRED_SERIAL_OUTPUT = 0
+        self.ENABLE_BINARY_TRACE_LOG = 0
         self.ENABLE_SBL_SETUP      = 0
         self.ENABLE_PAYLOD_MODULE  = 0
         self.ENABLE_FAST_BOOT      = 0
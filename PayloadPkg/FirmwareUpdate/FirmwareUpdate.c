@@ -1,7 +1,7 @@
 /** @file
 This driver is to update firmware in boot media.
 
-Copyright (c) 2017 - 2023, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2017 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -1252,6 +1252,7 @@ FindImage (
   @param[in] ImageHdr       Pointer to fw mgmt capsule Image header
   @param[in] FwPolicy       Fw update policy
   @param[out] ResetRequired Pointer to boolean reset required
+  @param[out] DeltaInfo     Delta size and apply time, zeroed for full images
 
   @retval  EFI_SUCCESS      Update successful.
   @retval  other            error status from the update routine
@@ -1262,7 +1263,8 @@ ApplyFwImage (
   IN    UINT32                         CapImageSize,
   IN    EFI_FW_MGMT_CAP_IMAGE_HEADER  *ImageHdr,
   IN    FIRMWARE_UPDATE_POLICY        FwPolicy,
-  OUT   BOOLEAN                       *ResetRequired
+  OUT   BOOLEAN                       *ResetRequired,
+  OUT   FW_DELTA_INFO                 *DeltaInfo
   )
 {
   EFI_STATUS              Status;
@@ -1270,11 +1272,14 @@ ApplyFwImage (
   BOOT_PARTITION          Partition;
   VOID                    *CsmeUpdateInData;
   FIRMWARE_UPDATE_HEADER  *CapHdr;
+  EFI_FW_MGMT_CAP_IMAGE_HEADER  *TargetHdr;
 
   CapHdr = (FIRMWARE_UPDATE_HEADER *)CapImage;
 
   Status = EFI_SUCCESS;
   *ResetRequired = FALSE;
+  TargetHdr = NULL;
+  ZeroMem (DeltaInfo, sizeof (FW_DELTA_INFO));
 
   if (ImageHdr == NULL) {
     return EFI_NOT_FOUND;
@@ -1284,6 +1289,19 @@ ApplyFwImage (
   DEBUG((DEBUG_INFO, "ApplyFwImage: %04X:%04X\n",
         (UINT32)ImageHdr->UpdateHardwareInstance, (UINT32)RShiftU64 (ImageHdr->UpdateHardwareInstance, 32)));
 
+  //
+  // Rebuild the full image of a delta payload, then update it as usual
+  //
+  if (IsDeltaImage (ImageHdr)) {
+    Status = ApplyDeltaImage (ImageHdr, FwPolicy, (BOOLEAN)((CapHdr->CapsuleFlags & CAPSULE_FLAG_FORCE_BIOS_UPDATE) != 0),
+                              &TargetHdr, DeltaInfo);
+    if (EFI_ERROR (Status)) {
+      DEBUG((DEBUG_ERROR, "ApplyDeltaImage failed with Status = %r\n", Status));
+      return Status;
+    }
+    ImageHdr = TargetHdr;
+  }
+
   switch (Signature) {
   case FW_UPDATE_COMP_BIOS_REGION:
     if ((CapHdr->CapsuleFlags & CAPSULE_FLAG_FORCE_BIOS_UPDATE) != 0) {
@@ -1332,6 +1350,10 @@ ApplyFwImage (
     Status = UpdateSblComponent (ImageHdr, FwPolicy);
   }
 
+  if (TargetHdr != NULL) {
+    FreePool (TargetHdr);
+  }
+
   return Status;
 }
 
@@ -1384,6 +1406,7 @@ InitFirmwareUpdate (
   UINT32                        FwUpdStatusOffset;
   UINT32                        ByteOffset;
   BOOLEAN                       ResetRequired;
+  FW_DELTA_INFO                 DeltaInfo;
   FW_UPDATE_COMP_STATUS         FwUpdCompStatus[MAX_FW_COMPONENTS];
   FIRMWARE_UPDATE_HEADER        *FwUpdHdr;
   EFI_FW_MGMT_CAP_IMAGE_HEADER  *ImgHdr;
@@ -1470,7 +1493,8 @@ InitFirmwareUpdate (
     // Only expect a single BIOS component update.
     Status = FindImage (FwUpdCompStatus[0].HardwareInstance, CapsuleImage, CapsuleSize, &ImgHdr);
     if (!EFI_ERROR (Status)) {
-      Status = ApplyFwImage(CapsuleImage, CapsuleSize, ImgHdr, FwPolicy, &ResetRequired);
+      Status = ApplyFwImage(CapsuleImage, CapsuleSize, ImgHdr, FwPolicy, &ResetRequired, &DeltaInfo);
+      ReportDeltaStatus (ImgHdr->UpdateHardwareInstance, &DeltaInfo, Status);
     }
     DEBUG ((DEBUG_INFO, "Full BIOS region update status: %r\n", Status));
     if (EFI_ERROR (Status)) {
@@ -1521,6 +1545,7 @@ InitFirmwareUpdate (
       //
       // Find payload associated with component in the capsule image
       //
+      ZeroMem (&DeltaInfo, sizeof (DeltaInfo));
       StatusPayloadUpdate = FindImage(FwUpdCompStatus[Count].HardwareInstance, CapsuleImage, CapsuleSize, &ImgHdr);
       if (!EFI_ERROR (StatusPayloadUpdate)) {
         //
@@ -1532,7 +1557,7 @@ InitFirmwareUpdate (
             continue;
           }
 
-          StatusPayloadUpdate = ApplyFwImage(CapsuleImage, CapsuleSize, ImgHdr, FwPolicy, &ResetRequired);
+          StatusPayloadUpdate = ApplyFwImage(CapsuleImage, CapsuleSize, ImgHdr, FwPolicy, &ResetRequired, &DeltaInfo);
           if (EFI_ERROR (StatusPayloadUpdate)) {
             DEBUG((DEBUG_ERROR, "ApplyFwImage (%04X:%04X) failed with Status = %r\n",
                   (UINT32)FwUpdCompStatus[Count].HardwareInstance, (UINT32)RShiftU64 (FwUpdCompStatus[Count].HardwareInstance, 32),
@@ -1564,6 +1589,7 @@ InitFirmwareUpdate (
         if (EFI_ERROR (Status)) {
           DEBUG ((DEBUG_ERROR, "UpdateStatus failed! Status = %r\n", Status));
         }
+        ReportDeltaStatus (ImgHdr->UpdateHardwareInstance, &DeltaInfo, StatusPayloadUpdate);
       }
 
       // Safety check: critical update must be successful, or the remaining update will be skipped
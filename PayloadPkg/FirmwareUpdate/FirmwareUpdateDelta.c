@@ -0,0 +1,458 @@
+/** @file
+  Delta payloads for firmware update.
+
+  A delta payload rebuilds a component image from the current content of the
+  flash region the update writes to. The image is split in blocks; each one is
+  either copied from a block on flash, added byte by byte to a block on flash,
+  or stored in the payload. The diff and literal bytes are compressed together
+  with one of the bootloader compression algorithms.
+
+  The rebuilt image goes through the same write path as a full image, and the
+  capsule signature covers the delta like any other payload.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Base.h>
+#include <Uefi/UefiBaseType.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/CryptoLib.h>
+#include <Library/SecureBootLib.h>
+#include <Library/DecompressLib.h>
+#include <Library/TimerLib.h>
+#include <Library/PayloadMemoryAllocationLib.h>
+#include <Library/BootloaderCommonLib.h>
+#include <Library/FirmwareUpdateLib.h>
+#include <Library/ConsoleOutLib.h>
+#include "FirmwareUpdateHelper.h"
+
+/**
+  Get the digest size of a delta hash algorithm.
+
+  @param[in] HashAlg        The hash algorithm.
+
+  @retval  The digest size, or 0 if the algorithm is not supported.
+**/
+STATIC
+UINT32
+GetDeltaDigestSize (
+  IN  UINT8    HashAlg
+  )
+{
+  if (HashAlg == HASH_TYPE_SHA256) {
+    return SHA256_DIGEST_SIZE;
+  } else if (HashAlg == HASH_TYPE_SHA384) {
+    return SHA384_DIGEST_SIZE;
+  }
+  return 0;
+}
+
+/**
+  Check the layout of a delta payload.
+
+  @param[in] Delta          The delta header.
+  @param[in] DeltaSize      The size of the delta payload.
+
+  @retval  EFI_SUCCESS            The header, block table and stream fit in the payload.
+  @retval  EFI_UNSUPPORTED        The version or hash algorithm is not supported.
+  @retval  EFI_COMPROMISED_DATA   The payload is corrupted.
+**/
+STATIC
+EFI_STATUS
+CheckDeltaHeader (
+  IN  CONST FW_DELTA_HEADER  *Delta,
+  IN  UINT32                  DeltaSize
+  )
+{
+  UINT64   TableEnd;
+
+  if ((Delta->Version != FW_DELTA_VERSION) || (GetDeltaDigestSize (Delta->HashAlg) == 0)) {
+    DEBUG ((DEBUG_ERROR, "Delta version %d with hash %d is not supported\n", Delta->Version, Delta->HashAlg));
+    return EFI_UNSUPPORTED;
+  }
+
+  if ((Delta->HeaderSize < sizeof (FW_DELTA_HEADER)) || (Delta->BlockSize == 0) ||
+      (ALIGN_DOWN (Delta->BlockSize, SIZE_4KB) != Delta->BlockSize) ||
+      (Delta->SourceSize == 0) || (Delta->TargetSize == 0) ||
+      (Delta->BlockCount != (Delta->TargetSize + Delta->BlockSize - 1) / Delta->BlockSize)) {
+    return EFI_COMPROMISED_DATA;
+  }
+
+  TableEnd = (UINT64)Delta->HeaderSize + MultU64x32 (Delta->BlockCount, sizeof (FW_DELTA_BLOCK));
+  if ((TableEnd + Delta->StreamSize > DeltaSize) || (Delta->StreamSize < sizeof (LOADER_COMPRESSED_HEADER))) {
+    return EFI_COMPROMISED_DATA;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Locate the flash region a delta payload applies to.
+
+  This is the region the update of the component writes to, so that the
+  source is still untouched when each phase of a redundant update runs.
+
+  @param[in]  ImageHdr        Pointer to fw mgmt capsule Image header
+  @param[in]  FwPolicy        Fw update policy
+  @param[in]  FullBiosRegion  TRUE if the full BIOS region is updated.
+  @param[in]  SourceSize      The size of the delta source.
+  @param[out] Address         The boot media address of the delta source.
+
+  @retval  EFI_SUCCESS        The source was located.
+  @retval  EFI_UNSUPPORTED    The component can not be updated by a delta.
+  @retval  others             The component was not found.
+**/
+STATIC
+EFI_STATUS
+GetDeltaSourceAddress (
+  IN  EFI_FW_MGMT_CAP_IMAGE_HEADER  *ImageHdr,
+  IN  FIRMWARE_UPDATE_POLICY         FwPolicy,
+  IN  BOOLEAN                        FullBiosRegion,
+  IN  UINT32                         SourceSize,
+  OUT UINT64                        *Address
+  )
+{
+  EFI_STATUS   Status;
+  UINT32       Signature;
+  UINT32       RegionBase;
+  UINT32       RegionSize;
+  BOOLEAN      IsBackup;
+  FLASH_MAP   *FlashMap;
+
+  Signature = (UINT32)ImageHdr->UpdateHardwareInstance;
+
+  //
+  // Container components are re-packed and CSME updates go through the CSME
+  // driver, neither has a flash region holding the image as it is.
+  //
+  if (((UINT32)RShiftU64 (ImageHdr->UpdateHardwareInstance, 32) != 0) ||
+      (Signature == FW_UPDATE_COMP_CSME_REGION) || (Signature == FW_UPDATE_COMP_CSME_DRIVER) ||
+      (Signature == FW_UPDATE_COMP_CMD_REQUEST)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (Signature == FW_UPDATE_COMP_BIOS_REGION) {
+    //
+    // A redundant BIOS update writes the partitions in two boots, so the
+    // second one would not find the source anymore. Only the full region
+    // update writes it at once.
+    //
+    if (!FullBiosRegion) {
+      DEBUG ((DEBUG_ERROR, "BIOS delta requires a full BIOS region update\n"));
+      return EFI_UNSUPPORTED;
+    }
+    Status = BootMediaGetRegion (FlashRegionBios, &RegionBase, &RegionSize);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+    if (SourceSize > RegionSize) {
+      return EFI_UNSUPPORTED;
+    }
+    *Address = RegionSize - SourceSize;
+    return EFI_SUCCESS;
+  }
+
+  IsBackup = FALSE;
+  if (IsRedundantComponent (ImageHdr->UpdateHardwareInstance)) {
+    IsBackup = (FwPolicy.Fields.UpdatePartitionB == 1) ? TRUE : FALSE;
+  }
+  Status = GetComponentInfoByPartition (Signature, IsBackup, &RegionBase, &RegionSize);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_INFO, "No component with signature 0x%x found ! \n", Signature));
+    return Status;
+  }
+  if (SourceSize > RegionSize) {
+    return EFI_UNSUPPORTED;
+  }
+
+  FlashMap = GetFlashMapPtr ();
+  if (FlashMap == NULL) {
+    return EFI_NOT_FOUND;
+  }
+  *Address = FlashMap->RomSize + RegionBase;
+  return EFI_SUCCESS;
+}
+
+/**
+  Build the target blocks of a delta payload.
+
+  @param[in]  Delta         The delta header.
+  @param[in]  Source        The delta source.
+  @param[in]  Stream        The decompressed diff and literal bytes.
+  @param[in]  StreamSize    The size of the decompressed stream.
+  @param[out] Target        The buffer of TargetSize bytes for the new image.
+  @param[out] DeltaInfo     Counts of each block type.
+
+  @retval  EFI_SUCCESS            The target was built.
+  @retval  EFI_COMPROMISED_DATA   A block is out of the source or the stream.
+**/
+STATIC
+EFI_STATUS
+BuildDeltaTarget (
+  IN  CONST FW_DELTA_HEADER  *Delta,
+  IN  CONST UINT8            *Source,
+  IN  CONST UINT8            *Stream,
+  IN  UINT32                  StreamSize,
+  OUT UINT8                  *Target,
+  OUT FW_DELTA_INFO          *DeltaInfo
+  )
+{
+  CONST FW_DELTA_BLOCK  *Block;
+  CONST UINT8           *SourceBlock;
+  UINT32                 Index;
+  UINT32                 Offset;
+  UINT32                 Length;
+  UINT32                 StreamOffset;
+  UINT32                 Byte;
+
+  Block        = (CONST FW_DELTA_BLOCK *)((CONST UINT8 *)Delta + Delta->HeaderSize);
+  StreamOffset = 0;
+
+  for (Index = 0; Index < Delta->BlockCount; Index++, Block++) {
+    Offset = Index * Delta->BlockSize;
+    Length = MIN (Delta->BlockSize, Delta->TargetSize - Offset);
+
+    SourceBlock = NULL;
+    if (Block->Type != FW_DELTA_BLOCK_LITERAL) {
+      if (MultU64x32 (Block->SourceBlock, Delta->BlockSize) + Length > Delta->SourceSize) {
+        return EFI_COMPROMISED_DATA;
+      }
+      SourceBlock = Source + Block->SourceBlock * Delta->BlockSize;
+    }
+    if ((Block->Type != FW_DELTA_BLOCK_COPY) && (StreamOffset + Length > StreamSize)) {
+      return EFI_COMPROMISED_DATA;
+    }
+
+    switch (Block->Type) {
+    case FW_DELTA_BLOCK_COPY:
+      CopyMem (Target + Offset, SourceBlock, Length);
+      DeltaInfo->CopyCount++;
+      break;
+    case FW_DELTA_BLOCK_DIFF:
+      for (Byte = 0; Byte < Length; Byte++) {
+        Target[Offset + Byte] = (UINT8)(SourceBlock[Byte] + Stream[StreamOffset + Byte]);
+      }
+      StreamOffset += Length;
+      DeltaInfo->DiffCount++;
+      break;
+    case FW_DELTA_BLOCK_LITERAL:
+      CopyMem (Target + Offset, Stream + StreamOffset, Length);
+      StreamOffset += Length;
+      DeltaInfo->LiteralCount++;
+      break;
+    default:
+      return EFI_COMPROMISED_DATA;
+    }
+  }
+
+  if (StreamOffset != StreamSize) {
+    return EFI_COMPROMISED_DATA;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Check if a capsule payload holds a delta instead of a full image.
+
+  @param[in] ImageHdr       Pointer to fw mgmt capsule Image header
+
+  @retval  TRUE             The payload is a delta.
+  @retval  FALSE            The payload is a full image.
+**/
+BOOLEAN
+IsDeltaImage (
+  IN  EFI_FW_MGMT_CAP_IMAGE_HEADER  *ImageHdr
+  )
+{
+  FW_DELTA_HEADER  *Delta;
+
+  if (ImageHdr->UpdateImageSize < sizeof (FW_DELTA_HEADER)) {
+    return FALSE;
+  }
+
+  Delta = (FW_DELTA_HEADER *)((UINT8 *)ImageHdr + sizeof (EFI_FW_MGMT_CAP_IMAGE_HEADER));
+  return (BOOLEAN)(Delta->Signature == FW_DELTA_SIGNATURE);
+}
+
+/**
+  Rebuild the full image of a delta payload.
+
+  The delta is applied against the current flash content of the region the
+  update writes to. That content is verified against the source digest of
+  the delta, and the rebuilt image against its target digest.
+
+  @param[in]  ImageHdr        Pointer to fw mgmt capsule Image header
+  @param[in]  FwPolicy        Fw update policy
+  @param[in]  FullBiosRegion  TRUE if the full BIOS region is updated.
+  @param[out] TargetHdr       Image header followed by the rebuilt image,
+                              to be freed by the caller.
+  @param[out] DeltaInfo       Delta size and apply time.
+
+  @retval  EFI_SUCCESS              The image was rebuilt.
+  @retval  EFI_UNSUPPORTED          The component can not be updated by a delta.
+  @retval  EFI_INCOMPATIBLE_VERSION The flash content is not the delta source.
+  @retval  EFI_COMPROMISED_DATA     The delta or the rebuilt image is corrupted.
+  @retval  EFI_OUT_OF_RESOURCES     The buffers could not be allocated.
+**/
+EFI_STATUS
+ApplyDeltaImage (
+  IN  EFI_FW_MGMT_CAP_IMAGE_HEADER   *ImageHdr,
+  IN  FIRMWARE_UPDATE_POLICY          FwPolicy,
+  IN  BOOLEAN                         FullBiosRegion,
+  OUT EFI_FW_MGMT_CAP_IMAGE_HEADER  **TargetHdr,
+  OUT FW_DELTA_INFO                  *DeltaInfo
+  )
+{
+  EFI_STATUS                     Status;
+  FW_DELTA_HEADER               *Delta;
+  LOADER_COMPRESSED_HEADER      *LzHdr;
+  EFI_FW_MGMT_CAP_IMAGE_HEADER  *NewHdr;
+  UINT8                         *Source;
+  UINT8                         *Target;
+  UINT8                         *Stream;
+  UINT64                         Address;
+  UINT64                         StartTime;
+  UINT32                         DigestSize;
+  UINT32                         StreamSize;
+  UINT32                         ScratchSize;
+  UINT8                          Digest[HASH_DIGEST_MAX];
+
+  *TargetHdr = NULL;
+  ZeroMem (DeltaInfo, sizeof (FW_DELTA_INFO));
+  StartTime = GetTimeInNanoSecond (GetPerformanceCounter ());
+
+  Delta  = (FW_DELTA_HEADER *)((UINT8 *)ImageHdr + sizeof (EFI_FW_MGMT_CAP_IMAGE_HEADER));
+  Status = CheckDeltaHeader (Delta, ImageHdr->UpdateImageSize);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+  DigestSize = GetDeltaDigestSize (Delta->HashAlg);
+  DeltaInfo->DeltaSize  = ImageHdr->UpdateImageSize;
+  DeltaInfo->TargetSize = Delta->TargetSize;
+
+  Status = GetDeltaSourceAddress (ImageHdr, FwPolicy, FullBiosRegion, Delta->SourceSize, &Address);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  LzHdr = (LOADER_COMPRESSED_HEADER *)((UINT8 *)Delta + Delta->HeaderSize + Delta->BlockCount * sizeof (FW_DELTA_BLOCK));
+  if (!IS_COMPRESSED (LzHdr) || (sizeof (LOADER_COMPRESSED_HEADER) + (UINT64)LzHdr->CompressedSize > Delta->StreamSize)) {
+    return EFI_COMPROMISED_DATA;
+  }
+  StreamSize  = 0;
+  ScratchSize = 0;
+  if (LzHdr->Size != 0) {
+    Status = DecompressGetInfo (LzHdr->Signature, LzHdr->Data, LzHdr->CompressedSize, &StreamSize, &ScratchSize);
+    if (EFI_ERROR (Status) || (StreamSize != LzHdr->Size)) {
+      return EFI_COMPROMISED_DATA;
+    }
+  }
+
+  Source = AllocatePool (Delta->SourceSize);
+  NewHdr = AllocatePool (sizeof (EFI_FW_MGMT_CAP_IMAGE_HEADER) + Delta->TargetSize);
+  Stream = AllocatePool (StreamSize + ScratchSize + 1);
+  if ((Source == NULL) || (NewHdr == NULL) || (Stream == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Done;
+  }
+
+  //
+  // Verify the flash content before anything is built from it
+  //
+  Status = BootMediaRead (Address, Delta->SourceSize, Source);
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+  Status = CalculateHash (Source, Delta->SourceSize, Delta->HashAlg, Digest);
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+  if (CompareMem (Digest, Delta->SourceHash, DigestSize) != 0) {
+    DEBUG ((DEBUG_ERROR, "Flash content at 0x%llx does not match the delta source\n", Address));
+    Status = EFI_INCOMPATIBLE_VERSION;
+    goto Done;
+  }
+
+  if (StreamSize != 0) {
+    Status = Decompress (LzHdr->Signature, LzHdr->Data, LzHdr->CompressedSize, Stream, Stream + StreamSize);
+    if (EFI_ERROR (Status)) {
+      Status = EFI_COMPROMISED_DATA;
+      goto Done;
+    }
+  }
+
+  Target = (UINT8 *)NewHdr + sizeof (EFI_FW_MGMT_CAP_IMAGE_HEADER);
+  Status = BuildDeltaTarget (Delta, Source, Stream, StreamSize, Target, DeltaInfo);
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+
+  Status = CalculateHash (Target, Delta->TargetSize, Delta->HashAlg, Digest);
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+  if (CompareMem (Digest, Delta->TargetHash, DigestSize) != 0) {
+    DEBUG ((DEBUG_ERROR, "Image rebuilt from the delta is corrupted\n"));
+    Status = EFI_COMPROMISED_DATA;
+    goto Done;
+  }
+
+  CopyMem (NewHdr, ImageHdr, sizeof (EFI_FW_MGMT_CAP_IMAGE_HEADER));
+  NewHdr->UpdateImageSize      = Delta->TargetSize;
+  NewHdr->UpdateVendorCodeSize = 0;
+  *TargetHdr = NewHdr;
+  NewHdr     = NULL;
+
+  DeltaInfo->ApplyTimeMs = (UINT32)DivU64x32 (GetTimeInNanoSecond (GetPerformanceCounter ()) - StartTime, 1000000);
+  DEBUG ((DEBUG_INFO, "Delta applied: %d copy, %d diff, %d literal blocks\n",
+          DeltaInfo->CopyCount, DeltaInfo->DiffCount, DeltaInfo->LiteralCount));
+
+Done:
+  if (Source != NULL) {
+    FreePool (Source);
+  }
+  if (NewHdr != NULL) {
+    FreePool (NewHdr);
+  }
+  if (Stream != NULL) {
+    FreePool (Stream);
+  }
+  return Status;
+}
+
+/**
+  Report the delta size and apply time of a component update.
+
+  @param[in] Signature      Signature of the updated component.
+  @param[in] DeltaInfo      Delta size and apply time.
+  @param[in] UpdateStatus   Status of the component update.
+**/
+VOID
+ReportDeltaStatus (
+  IN  UINT64                Signature,
+  IN  CONST FW_DELTA_INFO  *DeltaInfo,
+  IN  EFI_STATUS            UpdateStatus
+  )
+{
+  UINT32   Percent;
+
+  if (DeltaInfo->DeltaSize == 0) {
+    return;
+  }
+
+  Percent = 0;
+  if (DeltaInfo->TargetSize != 0) {
+    Percent = (UINT32)DivU64x32 (MultU64x32 (DeltaInfo->DeltaSize, 100), DeltaInfo->TargetSize);
+  }
+
+  DEBUG ((DEBUG_INIT, "Delta update %04X:%04X: 0x%x bytes for a 0x%x byte image (%d%%), applied in %d ms, %r\n",
+          (UINT32)Signature, (UINT32)RShiftU64 (Signature, 32), DeltaInfo->DeltaSize, DeltaInfo->TargetSize,
+          Percent, DeltaInfo->ApplyTimeMs, UpdateStatus));
+  ConsolePrint ("Delta update: 0x%x bytes (%d%% of image), applied in %d ms\n",
+                DeltaInfo->DeltaSize, Percent, DeltaInfo->ApplyTimeMs);
+}
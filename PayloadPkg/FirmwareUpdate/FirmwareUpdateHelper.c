@@ -1,7 +1,7 @@
 /** @file
   Internal functions to update firmware in boot media.
 
-  Copyright (c) 2020 - 2023, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2020 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -287,8 +287,8 @@ GetVersionfromFv (
 /**
   Update a region block.
 
-  This is the acture function to update boot meia. It will erase boot device,
-  write new data to boot device, and verify the written data.
+  This is the acture function to update boot meia. It will erase boot device
+  where needed, write new data to boot device, and verify the written data.
 
   @param[in] Address          The boot media address to be update.
   @param[in] Buffer           The source buffer to write to the boot media.
@@ -305,83 +305,16 @@ UpdateRegionBlock (
   IN  UINT32    Length
   )
 {
-  EFI_STATUS    Status;
-  UINT8         *ReadBuffer;
-  UINT32        Count;
-  UINT32        BlockLen;
-  UINT8         *Src;
+  EFI_STATUS          Status;
+  FLASH_UPDATE_PLAN   Plan;
 
-  ReadBuffer = NULL;
-
-  if (Length == 0) {
-    return EFI_SUCCESS;
-  }
-
-  ReadBuffer = AllocatePages (EFI_SIZE_TO_PAGES (SIZE_4KB));
-  if (ReadBuffer == NULL) {
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  BlockLen   = SIZE_4KB;
-  Src = (UINT8 *)Buffer;
-
-  //
-  // Read, compare, erase, write, read, compare
-  //
-  for (Count = 0; Count < Length; Count += BlockLen) {
-    //
-    // If updating region less than 4K bytes,
-    // adjust the block length to size remaining, i.e less than 4k
-    //
-    if (Count + BlockLen > Length) {
-      BlockLen = Length - Count;
-    }
-    Status = BootMediaRead(Address + Count, BlockLen, ReadBuffer);
-    if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_ERROR, "BootMediaRead.  readaddr: 0x%llx, Status = 0x%x\n", Address + Count, Status));
-      goto End;
-    }
-
-    if (CompareMem (Src + Count, ReadBuffer, BlockLen) == 0) {
-      DEBUG ((DEBUG_INIT, "."));
-      continue;
-    }
-
-    //
-    // Erase the boot media
-    // Block length for erase is always 4K bytes
-    //
-    DEBUG ((DEBUG_INIT, "x"));
-    Status = BootMediaErase ((UINT32) (Address + Count),  SIZE_4KB);
-    if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_ERROR, "ERROR: in BootMediaErase. Status = 0x%x\n", Status));
-      goto End;
-    }
-
-    //
-    // Write to the boot media
-    //
-    Status = BootMediaWrite ((UINT32) (Address + Count),  BlockLen, Src + Count);
-    if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_ERROR, "ERROR: in BootDeviceWrite. Status = 0x%x\n", Status));
-      goto End;
-    }
-
-    //
-    // Verify the written data
-    //
-    Status = BootMediaRead (Address + Count, BlockLen, ReadBuffer);
-    if (CompareMem (Src + Count, ReadBuffer, BlockLen) != 0) {
-      DEBUG ((DEBUG_ERROR, "Verify Error !\n"));
-      Status = EFI_DEVICE_ERROR;
-      goto End;
-    }
+  Status = PlanFlashUpdate (Address, Buffer, Length, &Plan);
+  if (EFI_ERROR (Status)) {
+    return Status;
   }
 
-End:
-  if (ReadBuffer != NULL) {
-    FreePages (ReadBuffer, EFI_SIZE_TO_PAGES (SIZE_4KB));
-  }
+  Status = ExecuteFlashUpdate (&Plan, 0, Length);
+  FreeFlashUpdatePlan (&Plan);
 
   return Status;
 }
@@ -389,7 +322,9 @@ End:
 /**
   Update a boot region.
 
-  This function also output the update process info.
+  The whole region is compared with the boot media first, so that only the
+  changed sectors are erased and written. This function also output the
+  update process info, and the projected and actual update time.
 
   @param[in] UpdateRegion     The detail information for this region to update.
   @param[in] WrittenSize      The data size has been written before this region.
@@ -405,18 +340,27 @@ UpdateBootRegion (
   IN  UINT32                     TotalSize
   )
 {
-  EFI_STATUS    Status;
-  UINT32        UpdateBlockSize;
-  UINT32        UpdatedSize;
-  UINT64        UpdateAddress;
-  UINT8         *Buffer;
+  EFI_STATUS          Status;
+  UINT32              UpdateBlockSize;
+  UINT32              UpdatedSize;
+  UINT64              UpdateAddress;
+  UINT64              StartTime;
+  FLASH_UPDATE_PLAN   Plan;
+
+  UpdateAddress = UpdateRegion->ToUpdateAddress;
+  StartTime     = GetTimeInNanoSecond (GetPerformanceCounter ());
+
+  ConsolePrint ("Comparing 0x%08llx, Size:0x%06x\n", UpdateAddress, UpdateRegion->UpdateSize);
+  Status = PlanFlashUpdate (UpdateAddress, UpdateRegion->SourceAddress, UpdateRegion->UpdateSize, &Plan);
+  if (EFI_ERROR (Status)) {
+    ConsolePrint ("\nFailed at address 0x%08llx, status: %r\n", UpdateAddress, Status);
+    return Status;
+  }
+  PrintFlashUpdatePlan (&Plan);
 
   //
   // Here write 64KB every time in order to show update process.
   //
-  UpdateAddress   = UpdateRegion->ToUpdateAddress;
-  Buffer          = UpdateRegion->SourceAddress;
-
   UpdatedSize = 0;
   while (UpdatedSize < UpdateRegion->UpdateSize) {
     if (UpdateRegion->UpdateSize < SIZE_4KB) {
@@ -429,17 +373,22 @@ UpdateBootRegion (
       }
     }
     ConsolePrint ("Updating 0x%08llx, Size:0x%06x\n", UpdateAddress, UpdateBlockSize);
-    Status = UpdateRegionBlock (UpdateAddress, Buffer, UpdateBlockSize);
+    Status = ExecuteFlashUpdate (&Plan, UpdatedSize, UpdateBlockSize);
     if (EFI_ERROR (Status)) {
       ConsolePrint ("\nFailed at address 0x%08llx, status: %r\n", UpdateAddress, Status);
+      FreeFlashUpdatePlan (&Plan);
       return Status;
     }
     UpdateAddress += UpdateBlockSize;
-    Buffer        += UpdateBlockSize;
     UpdatedSize   += UpdateBlockSize;
     ConsolePrint ("\nFinished   %3d%%\n", (WrittenSize + UpdatedSize) * 100 / TotalSize);
   }
 
+  ConsolePrint ("Update time: %d ms, projected %d ms\n",
+                (UINT32)DivU64x32 (GetTimeInNanoSecond (GetPerformanceCounter ()) - StartTime, 1000000),
+                (UINT32)DivU64x32 (Plan.ProjectedUs, 1000));
+  FreeFlashUpdatePlan (&Plan);
+
   return EFI_SUCCESS;
 }
 
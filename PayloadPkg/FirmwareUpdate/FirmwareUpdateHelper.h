@@ -1,7 +1,7 @@
 /** @file
   The header file for internal firmware update definitions.
 
-  Copyright (c) 2020 - 2021, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2020 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -30,11 +30,157 @@ typedef struct {
 
 #define PAD_BYTE  0xFF
 
+#define FLASH_SECTOR_SIZE          SIZE_4KB
+#define FLASH_BLOCK_SIZE           SIZE_64KB
+#define FLASH_SECTORS_PER_BLOCK    (FLASH_BLOCK_SIZE / FLASH_SECTOR_SIZE)
+
+///
+/// How a 4KB flash sector is updated
+///
+typedef enum {
+  FlashSectorUnchanged,   ///< Same data, not touched.
+  FlashSectorProgram,     ///< New data only clears bits, written without erase.
+  FlashSectorErase,       ///< Erased alone, then written.
+  FlashSectorBlockErase   ///< Erased with its 64KB block, then written.
+} FLASH_SECTOR_ACTION;
+
+///
+/// Update plan of a boot media range
+///
+typedef struct {
+  UINT64   Address;          ///< Boot media address of the range.
+  UINT8   *Buffer;           ///< New content of the range.
+  UINT32   Length;           ///< Length of the range.
+  UINT32   SectorCount;      ///< Number of sectors in the range.
+  UINT8   *Action;           ///< FLASH_SECTOR_ACTION of each sector.
+  UINT8   *ReadBuffer;       ///< 64KB buffer to read the boot media.
+  UINT32   ChangedCount;     ///< Number of sectors to update.
+  UINT32   ProgramCount;     ///< Number of sectors written without erase.
+  UINT32   SectorEraseCount; ///< Number of 4KB erases.
+  UINT32   BlockEraseCount;  ///< Number of 64KB erases.
+  UINT64   ProjectedUs;      ///< Projected update time in microseconds.
+} FLASH_UPDATE_PLAN;
+
+#define FW_DELTA_SIGNATURE         SIGNATURE_32 ('F', 'W', 'D', 'L')
+#define FW_DELTA_VERSION           1
+#define FW_DELTA_DIGEST_SIZE       64
+
+#define FW_DELTA_BLOCK_COPY        0
+#define FW_DELTA_BLOCK_DIFF        1
+#define FW_DELTA_BLOCK_LITERAL     2
+
+///
+/// Header of a delta payload. It replaces the image of a capsule payload and
+/// is followed by BlockCount FW_DELTA_BLOCK entries, then by a compressed
+/// stream holding the diff and literal bytes of the target blocks in order.
+///
+typedef struct {
+  UINT32   Signature;                          ///< FW_DELTA_SIGNATURE.
+  UINT16   HeaderSize;                         ///< Size of this header.
+  UINT8    Version;                            ///< FW_DELTA_VERSION.
+  UINT8    HashAlg;                            ///< HASH_TYPE_SHA256 or HASH_TYPE_SHA384.
+  UINT32   BlockSize;                          ///< Size of a delta block.
+  UINT32   SourceSize;                         ///< Size of the image on flash.
+  UINT32   TargetSize;                         ///< Size of the new image.
+  UINT32   BlockCount;                         ///< Number of target blocks.
+  UINT32   StreamSize;                         ///< Size of the compressed stream.
+  UINT8    SourceHash[FW_DELTA_DIGEST_SIZE];   ///< Digest of the image on flash.
+  UINT8    TargetHash[FW_DELTA_DIGEST_SIZE];   ///< Digest of the new image.
+} FW_DELTA_HEADER;
+
+///
+/// How a target block is built from the image on flash
+///
+typedef struct {
+  UINT32   SourceBlock;      ///< Source block for COPY and DIFF blocks.
+  UINT8    Type;             ///< FW_DELTA_BLOCK_COPY, _DIFF or _LITERAL.
+  UINT8    Reserved[3];
+} FW_DELTA_BLOCK;
+
+///
+/// Result of a delta payload application
+///
+typedef struct {
+  UINT32   DeltaSize;        ///< Size of the delta payload, 0 for full images.
+  UINT32   TargetSize;       ///< Size of the rebuilt image.
+  UINT32   CopyCount;        ///< Number of blocks copied from flash.
+  UINT32   DiffCount;        ///< Number of blocks patched from flash.
+  UINT32   LiteralCount;     ///< Number of blocks stored in the payload.
+  UINT32   ApplyTimeMs;      ///< Time to verify and rebuild the image.
+} FW_DELTA_INFO;
+
+/**
+  Plan the update of a boot media range.
+
+  The range is read and compared with the new image once. The resulting plan
+  is applied with ExecuteFlashUpdate() and released with FreeFlashUpdatePlan().
+
+  @param[in]  Address         The boot media address to update.
+  @param[in]  Buffer          The new content of the range.
+  @param[in]  Length          The length of the range.
+  @param[out] Plan            The update plan.
+
+  @retval  EFI_SUCCESS           The plan is ready.
+  @retval  EFI_OUT_OF_RESOURCES  The plan could not be allocated.
+  @retval  others                Reading the boot media failed.
+**/
+EFI_STATUS
+EFIAPI
+PlanFlashUpdate (
+  IN  UINT64              Address,
+  IN  VOID               *Buffer,
+  IN  UINT32              Length,
+  OUT FLASH_UPDATE_PLAN  *Plan
+  );
+
+/**
+  Apply an update plan to part of its range.
+
+  The parts of a range have to be applied in order, since a 64KB block is
+  erased when its first sector is reached.
+
+  @param[in] Plan         The update plan.
+  @param[in] Offset       Offset of the part in the range, 4KB aligned.
+  @param[in] Length       Length of the part.
+
+  @retval  EFI_SUCCESS        The part holds the new data.
+  @retval  others             Error happening when updating.
+**/
+EFI_STATUS
+EFIAPI
+ExecuteFlashUpdate (
+  IN  FLASH_UPDATE_PLAN  *Plan,
+  IN  UINT32              Offset,
+  IN  UINT32              Length
+  );
+
+/**
+  Print the projected cost of an update plan.
+
+  @param[in] Plan         The update plan.
+**/
+VOID
+EFIAPI
+PrintFlashUpdatePlan (
+  IN  FLASH_UPDATE_PLAN  *Plan
+  );
+
+/**
+  Release the buffers of an update plan.
+
+  @param[in, out] Plan    The update plan.
+**/
+VOID
+EFIAPI
+FreeFlashUpdatePlan (
+  IN OUT FLASH_UPDATE_PLAN  *Plan
+  );
+
 /**
   Update a region block.
 
-  This is the acture function to update boot meia. It will erase boot device,
-  write new data to boot device, and verify the written data.
+  This is the acture function to update boot meia. It will erase boot device
+  where needed, write new data to boot device, and verify the written data.
 
   @param[in] Address          The boot media address to be update.
   @param[in] Buffer           The source buffer to write to the boot media.
@@ -351,4 +497,60 @@ IsRedundantComponent (
   IN  UINT64    Signature
   );
 
+/**
+  Check if a capsule payload holds a delta instead of a full image.
+
+  @param[in] ImageHdr       Pointer to fw mgmt capsule Image header
+
+  @retval  TRUE             The payload is a delta.
+  @retval  FALSE            The payload is a full image.
+**/
+BOOLEAN
+IsDeltaImage (
+  IN  EFI_FW_MGMT_CAP_IMAGE_HEADER  *ImageHdr
+  );
+
+/**
+  Rebuild the full image of a delta payload.
+
+  The delta is applied against the current flash content of the region the
+  update writes to. That content is verified against the source digest of
+  the delta, and the rebuilt image against its target digest.
+
+  @param[in]  ImageHdr        Pointer to fw mgmt capsule Image header
+  @param[in]  FwPolicy        Fw update policy
+  @param[in]  FullBiosRegion  TRUE if the full BIOS region is updated.
+  @param[out] TargetHdr       Image header followed by the rebuilt image,
+                              to be freed by the caller.
+  @param[out] DeltaInfo       Delta size and apply time.
+
+  @retval  EFI_SUCCESS              The image was rebuilt.
+  @retval  EFI_UNSUPPORTED          The component can not be updated by a delta.
+  @retval  EFI_INCOMPATIBLE_VERSION The flash content is not the delta source.
+  @retval  EFI_COMPROMISED_DATA     The delta or the rebuilt image is corrupted.
+  @retval  EFI_OUT_OF_RESOURCES     The buffers could not be allocated.
+**/
+EFI_STATUS
+ApplyDeltaImage (
+  IN  EFI_FW_MGMT_CAP_IMAGE_HEADER   *ImageHdr,
+  IN  FIRMWARE_UPDATE_POLICY          FwPolicy,
+  IN  BOOLEAN                         FullBiosRegion,
+  OUT EFI_FW_MGMT_CAP_IMAGE_HEADER  **TargetHdr,
+  OUT FW_DELTA_INFO                  *DeltaInfo
+  );
+
+/**
+  Report the delta size and apply time of a component update.
+
+  @param[in] Signature      Signature of the updated component.
+  @param[in] DeltaInfo      Delta size and apply time.
+  @param[in] UpdateStatus   Status of the component update.
+**/
+VOID
+ReportDeltaStatus (
+  IN  UINT64                Signature,
+  IN  CONST FW_DELTA_INFO  *DeltaInfo,
+  IN  EFI_STATUS            UpdateStatus
+  );
+
 #endif
@@ -0,0 +1,414 @@
+/** @file
+  Erase minimizing planner for boot media updates.
+
+  The new image is compared with the flash contents once, before anything is
+  erased. Each 4KB sector is then either skipped, programmed without erase
+  when the new data only clears bits and the part allows it, or erased. Sectors to erase are merged
+  into 64KB block erases whenever that is projected to be faster.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Base.h>
+#include <Uefi/UefiBaseType.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/PcdLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/PayloadMemoryAllocationLib.h>
+#include <Library/FirmwareUpdateLib.h>
+#include <Library/ConsoleOutLib.h>
+#include "FirmwareUpdateHelper.h"
+
+//
+// Typical SPI NOR flash timings. They only weigh 4KB erases against 64KB
+// erases and project the update time, so they do not need to be exact.
+//
+#define FLASH_ERASE_SECTOR_US      45000
+#define FLASH_ERASE_BLOCK_US       150000
+#define FLASH_PROGRAM_SECTOR_US    8000
+
+/**
+  Check if a buffer is erased flash content.
+
+  @param[in] Buffer     The buffer to check.
+  @param[in] Length     The length of the buffer.
+
+  @retval  TRUE         All bytes are PAD_BYTE.
+  @retval  FALSE        At least one byte is not PAD_BYTE.
+**/
+STATIC
+BOOLEAN
+IsBlankSector (
+  IN  UINT8     *Buffer,
+  IN  UINT32     Length
+  )
+{
+  UINT32        Index;
+
+  for (Index = 0; Index < Length; Index++) {
+    if (Buffer[Index] != PAD_BYTE) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Find out how a sector has to be updated.
+
+  NOR flash programming can only clear bits, so a sector whose new data
+  does not set any bit cleared in the current data is programmed directly.
+  Parts with ECC do not allow programming a sector twice without erasing it,
+  so this is only done when PcdFlashProgramWithoutEraseEnabled is set.
+
+  @param[in] Current    The current flash content of the sector.
+  @param[in] New        The new content of the sector.
+  @param[in] Length     The length of the sector.
+
+  @retval  The action for the sector.
+**/
+STATIC
+FLASH_SECTOR_ACTION
+GetSectorAction (
+  IN  UINT8     *Current,
+  IN  UINT8     *New,
+  IN  UINT32     Length
+  )
+{
+  UINT32        Index;
+
+  if (CompareMem (Current, New, Length) == 0) {
+    return FlashSectorUnchanged;
+  }
+
+  if (!FeaturePcdGet (PcdFlashProgramWithoutEraseEnabled)) {
+    return FlashSectorErase;
+  }
+
+  for (Index = 0; Index < Length; Index++) {
+    if ((Current[Index] & New[Index]) != New[Index]) {
+      return FlashSectorErase;
+    }
+  }
+
+  return FlashSectorProgram;
+}
+
+/**
+  Merge the sectors to erase of each 64KB block into one block erase when it
+  is projected to be faster than erasing them one by one.
+
+  Only blocks aligned on 64KB and completely inside the updated range are
+  merged, since a block erase also erases the sectors that do not change,
+  which are then written again from the new image.
+
+  @param[in, out] Plan  The update plan with the action of every sector.
+**/
+STATIC
+VOID
+MergeBlockErases (
+  IN OUT FLASH_UPDATE_PLAN  *Plan
+  )
+{
+  UINT32        First;
+  UINT32        Index;
+  UINT32        SectorCost;
+  UINT32        BlockCost;
+  UINT32        EraseCount;
+  UINT8        *Src;
+
+  First = (UINT32)(ALIGN_VALUE (Plan->Address, FLASH_BLOCK_SIZE) - Plan->Address) / FLASH_SECTOR_SIZE;
+  for (; (First + FLASH_SECTORS_PER_BLOCK) * FLASH_SECTOR_SIZE <= Plan->Length; First += FLASH_SECTORS_PER_BLOCK) {
+    SectorCost = 0;
+    BlockCost  = FLASH_ERASE_BLOCK_US;
+    EraseCount = 0;
+    for (Index = First; Index < First + FLASH_SECTORS_PER_BLOCK; Index++) {
+      if (Plan->Action[Index] == FlashSectorErase) {
+        SectorCost += FLASH_ERASE_SECTOR_US + FLASH_PROGRAM_SECTOR_US;
+        EraseCount++;
+      } else if (Plan->Action[Index] == FlashSectorProgram) {
+        SectorCost += FLASH_PROGRAM_SECTOR_US;
+      }
+      Src = Plan->Buffer + Index * FLASH_SECTOR_SIZE;
+      if (!IsBlankSector (Src, FLASH_SECTOR_SIZE)) {
+        BlockCost += FLASH_PROGRAM_SECTOR_US;
+      }
+    }
+
+    if ((EraseCount > 0) && (BlockCost < SectorCost)) {
+      SetMem (&Plan->Action[First], FLASH_SECTORS_PER_BLOCK, FlashSectorBlockErase);
+    }
+  }
+}
+
+/**
+  Plan the update of a boot media range.
+
+  The range is read and compared with the new image once. The resulting plan
+  is applied with ExecuteFlashUpdate() and released with FreeFlashUpdatePlan().
+
+  @param[in]  Address         The boot media address to update.
+  @param[in]  Buffer          The new content of the range.
+  @param[in]  Length          The length of the range.
+  @param[out] Plan            The update plan.
+
+  @retval  EFI_SUCCESS           The plan is ready.
+  @retval  EFI_OUT_OF_RESOURCES  The plan could not be allocated.
+  @retval  others                Reading the boot media failed.
+**/
+EFI_STATUS
+EFIAPI
+PlanFlashUpdate (
+  IN  UINT64              Address,
+  IN  VOID               *Buffer,
+  IN  UINT32              Length,
+  OUT FLASH_UPDATE_PLAN  *Plan
+  )
+{
+  EFI_STATUS    Status;
+  UINT8        *ReadBuffer;
+  UINT32        Offset;
+  UINT32        ReadLen;
+  UINT32        SectorLen;
+  UINT32        Index;
+  UINT32        Sector;
+
+  ZeroMem (Plan, sizeof (FLASH_UPDATE_PLAN));
+  Plan->Address     = Address;
+  Plan->Buffer      = (UINT8 *)Buffer;
+  Plan->Length      = Length;
+  Plan->SectorCount = (Length + FLASH_SECTOR_SIZE - 1) / FLASH_SECTOR_SIZE;
+  if (Length == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Plan->Action     = AllocateZeroPool (Plan->SectorCount);
+  Plan->ReadBuffer = AllocatePages (EFI_SIZE_TO_PAGES (FLASH_BLOCK_SIZE));
+  if ((Plan->Action == NULL) || (Plan->ReadBuffer == NULL)) {
+    FreeFlashUpdatePlan (Plan);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Read the range in 64KB chunks and classify each sector
+  //
+  ReadBuffer = Plan->ReadBuffer;
+  for (Offset = 0; Offset < Length; Offset += ReadLen) {
+    ReadLen = MIN (FLASH_BLOCK_SIZE, Length - Offset);
+    Status  = BootMediaRead (Address + Offset, ReadLen, ReadBuffer);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "BootMediaRead.  readaddr: 0x%llx, Status = 0x%x\n", Address + Offset, Status));
+      FreeFlashUpdatePlan (Plan);
+      return Status;
+    }
+
+    for (Index = 0; Index < ReadLen; Index += SectorLen) {
+      SectorLen = MIN (FLASH_SECTOR_SIZE, ReadLen - Index);
+      Sector    = (Offset + Index) / FLASH_SECTOR_SIZE;
+      Plan->Action[Sector] = (UINT8)GetSectorAction (ReadBuffer + Index, Plan->Buffer + Offset + Index, SectorLen);
+    }
+  }
+
+  MergeBlockErases (Plan);
+
+  for (Sector = 0; Sector < Plan->SectorCount; Sector++) {
+    switch (Plan->Action[Sector]) {
+    case FlashSectorProgram:
+      Plan->ProgramCount++;
+      Plan->ProjectedUs += FLASH_PROGRAM_SECTOR_US;
+      break;
+    case FlashSectorErase:
+      Plan->SectorEraseCount++;
+      Plan->ProjectedUs += FLASH_ERASE_SECTOR_US + FLASH_PROGRAM_SECTOR_US;
+      break;
+    case FlashSectorBlockErase:
+      if ((Sector % FLASH_SECTORS_PER_BLOCK) == 0) {
+        Plan->BlockEraseCount++;
+        Plan->ProjectedUs += FLASH_ERASE_BLOCK_US;
+      }
+      if (!IsBlankSector (Plan->Buffer + Sector * FLASH_SECTOR_SIZE, FLASH_SECTOR_SIZE)) {
+        Plan->ProjectedUs += FLASH_PROGRAM_SECTOR_US;
+      }
+      break;
+    default:
+      break;
+    }
+    if (Plan->Action[Sector] != FlashSectorUnchanged) {
+      Plan->ChangedCount++;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Write a sector and read it back to verify it.
+
+  @param[in] Plan         The update plan.
+  @param[in] Sector       The sector index in the plan.
+
+  @retval  EFI_SUCCESS        The sector holds the new data.
+  @retval  EFI_DEVICE_ERROR   The verification failed.
+  @retval  others             Writing or reading the boot media failed.
+**/
+STATIC
+EFI_STATUS
+WriteSector (
+  IN  FLASH_UPDATE_PLAN  *Plan,
+  IN  UINT32              Sector
+  )
+{
+  EFI_STATUS    Status;
+  UINT32        Offset;
+  UINT32        SectorLen;
+
+  Offset    = Sector * FLASH_SECTOR_SIZE;
+  SectorLen = MIN (FLASH_SECTOR_SIZE, Plan->Length - Offset);
+
+  // Erased sectors with blank new data are only verified
+  if ((Plan->Action[Sector] != FlashSectorBlockErase) || !IsBlankSector (Plan->Buffer + Offset, SectorLen)) {
+    Status = BootMediaWrite (Plan->Address + Offset, SectorLen, Plan->Buffer + Offset);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "ERROR: in BootDeviceWrite. Status = 0x%x\n", Status));
+      return Status;
+    }
+  }
+
+  Status = BootMediaRead (Plan->Address + Offset, SectorLen, Plan->ReadBuffer);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+  if (CompareMem (Plan->Buffer + Offset, Plan->ReadBuffer, SectorLen) != 0) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Apply an update plan to part of its range.
+
+  The parts of a range have to be applied in order, since a 64KB block is
+  erased when its first sector is reached.
+
+  @param[in] Plan         The update plan.
+  @param[in] Offset       Offset of the part in the range, 4KB aligned.
+  @param[in] Length       Length of the part.
+
+  @retval  EFI_SUCCESS        The part holds the new data.
+  @retval  others             Error happening when updating.
+**/
+EFI_STATUS
+EFIAPI
+ExecuteFlashUpdate (
+  IN  FLASH_UPDATE_PLAN  *Plan,
+  IN  UINT32              Offset,
+  IN  UINT32              Length
+  )
+{
+  EFI_STATUS    Status;
+  UINT32        Sector;
+  UINT32        LastSector;
+  UINT64        SectorAddr;
+
+  if ((Offset % FLASH_SECTOR_SIZE) != 0) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status     = EFI_SUCCESS;
+  LastSector = MIN ((Offset + Length + FLASH_SECTOR_SIZE - 1) / FLASH_SECTOR_SIZE, Plan->SectorCount);
+  for (Sector = Offset / FLASH_SECTOR_SIZE; Sector < LastSector; Sector++) {
+    SectorAddr = Plan->Address + Sector * FLASH_SECTOR_SIZE;
+    switch (Plan->Action[Sector]) {
+    case FlashSectorUnchanged:
+      DEBUG ((DEBUG_INIT, "."));
+      continue;
+
+    case FlashSectorProgram:
+      DEBUG ((DEBUG_INIT, "p"));
+      Status = WriteSector (Plan, Sector);
+      if (Status != EFI_DEVICE_ERROR) {
+        break;
+      }
+      // The part did not accept programming over its data, erase it first
+      Plan->Action[Sector] = FlashSectorErase;
+      Status = BootMediaErase (SectorAddr, FLASH_SECTOR_SIZE);
+      if (!EFI_ERROR (Status)) {
+        Status = WriteSector (Plan, Sector);
+      }
+      break;
+
+    case FlashSectorErase:
+      DEBUG ((DEBUG_INIT, "x"));
+      Status = BootMediaErase (SectorAddr, FLASH_SECTOR_SIZE);
+      if (!EFI_ERROR (Status)) {
+        Status = WriteSector (Plan, Sector);
+      }
+      break;
+
+    case FlashSectorBlockErase:
+      DEBUG ((DEBUG_INIT, "X"));
+      Status = EFI_SUCCESS;
+      if ((SectorAddr % FLASH_BLOCK_SIZE) == 0) {
+        Status = BootMediaErase (SectorAddr, FLASH_BLOCK_SIZE);
+      }
+      if (!EFI_ERROR (Status)) {
+        Status = WriteSector (Plan, Sector);
+      }
+      break;
+
+    default:
+      Status = EFI_UNSUPPORTED;
+      break;
+    }
+
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "Updating 0x%llx failed: %r\n", SectorAddr, Status));
+      return Status;
+    }
+  }
+
+  return Status;
+}
+
+/**
+  Print the projected cost of an update plan.
+
+  @param[in] Plan         The update plan.
+**/
+VOID
+EFIAPI
+PrintFlashUpdatePlan (
+  IN  FLASH_UPDATE_PLAN  *Plan
+  )
+{
+  ConsolePrint ("Flash update plan: %d of %d sectors changed, %d 64KB and %d 4KB erases, %d program only\n",
+                Plan->ChangedCount, Plan->SectorCount, Plan->BlockEraseCount,
+                Plan->SectorEraseCount, Plan->ProgramCount);
+  ConsolePrint ("Projected update time: %d ms\n", (UINT32)DivU64x32 (Plan->ProjectedUs, 1000));
+}
+
+/**
+  Release the buffers of an update plan.
+
+  @param[in, out] Plan    The update plan.
+**/
+VOID
+EFIAPI
+FreeFlashUpdatePlan (
+  IN OUT FLASH_UPDATE_PLAN  *Plan
+  )
+{
+  if (Plan->Action != NULL) {
+    FreePool (Plan->Action);
+    Plan->Action = NULL;
+  }
+  if (Plan->ReadBuffer != NULL) {
+    FreePages (Plan->ReadBuffer, EFI_SIZE_TO_PAGES (FLASH_BLOCK_SIZE));
+    Plan->ReadBuffer = NULL;
+  }
+}
@@ -1,6 +1,6 @@
 /** @file
 
-  Copyright (c) 2022, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2022 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -68,4 +68,26 @@ RunCpuTask (
   IN  UINT64         Argument
   );
 
+/**
+  Run a set of independent jobs on the BSP and the idle APs, and wait for
+  all of them to complete.
+
+  All jobs run on the BSP when the CPU task hob does not exist. Refer to
+  ScheduleCpuJobs() for the restrictions on job functions.
+
+  @param[in, out] Jobs        The jobs to run. The Result of each job is
+                              updated on return.
+  @param[in]      JobCount    The number of jobs.
+
+  @retval EFI_INVALID_PARAMETER   Jobs is NULL or a job has no function.
+  @retval EFI_SUCCESS             All jobs have completed.
+
+**/
+EFI_STATUS
+EFIAPI
+RunCpuJobs (
+  IN OUT CPU_JOB    *Jobs,
+  IN     UINT32      JobCount
+  );
+
 #endif
@@ -1,6 +1,6 @@
 /** @file
 
-  Copyright (c) 2018 - 2023, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2018 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -59,6 +59,7 @@ EmmcSerialNumCheck (
     }
 
     // Reset platform
+    CommitVariableBatch ();
     PlatformService = (PLATFORM_SERVICE *) GetServiceBySignature (PLATFORM_SERVICE_SIGNATURE);
     if ((PlatformService != NULL) && (PlatformService->ResetSystem != NULL)) {
       DEBUG ((DEBUG_ERROR, "Initializing Platform Warm Reset due to inconsistent serial number\n"));
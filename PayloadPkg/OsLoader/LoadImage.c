@@ -1,6 +1,6 @@
 /** @file
 
-  Copyright (c) 2017 - 2023, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2017 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -9,11 +9,22 @@
 
 #define LOADED_IMAGES_INFO_SIGNATURE   SIGNATURE_32 ('L', 'I', 'I', 'S')
 
+//
+// A boot image is read in chunks of this size, so that the chunk read last
+// can be hashed on an AP while the next one is read.
+//
+#define IMAGE_READ_CHUNK_SIZE          SIZE_1MB
+
 typedef struct {
   UINTN                   Signature;
   LOADED_IMAGE           *LoadedImageList[LoadImageTypeMax];
 } LOADED_IMAGES_INFO;
 
+typedef struct {
+  VOID                   *Stream;
+  UINT32                  Available;
+} CONTAINER_DIGEST_JOB_ARG;
+
 STATIC CONST CHAR16  *mConfigFileName[3] = {
   L"config.cfg",
   L"boot/grub/grub.cfg",
@@ -73,6 +84,60 @@ GetBootImageFromIfwiContainer (
   return EFI_SUCCESS;
 }
 
+/**
+  CPU job to hash the part of a container read so far.
+
+  @param[in] Arg     Pointer to the CONTAINER_DIGEST_JOB_ARG of the container.
+
+  @retval  Always 0.
+
+**/
+STATIC
+UINT64
+EFIAPI
+ContainerDigestJob (
+  IN  UINT64   Arg
+  )
+{
+  CONTAINER_DIGEST_JOB_ARG  *DigestArg;
+
+  DigestArg = (CONTAINER_DIGEST_JOB_ARG *)(UINTN)Arg;
+  ContainerDigestUpdate (DigestArg->Stream, DigestArg->Available);
+
+  return 0;
+}
+
+/**
+  Hash the part of a container read so far on an AP.
+
+  The previous part is waited for first, so that a single AP hashes the
+  container in order while the BSP reads the next part.
+
+  @param[in]      Stream      The digest stream of the container.
+  @param[in]      Available   Number of bytes of the container read so far.
+  @param[in, out] DigestJob   The CPU job hashing the container.
+  @param[in, out] DigestArg   The argument of the CPU job.
+
+**/
+STATIC
+VOID
+QueueContainerDigest (
+  IN     VOID                       *Stream,
+  IN     UINT32                      Available,
+  IN OUT CPU_JOB                    *DigestJob,
+  IN OUT CONTAINER_DIGEST_JOB_ARG   *DigestArg
+  )
+{
+  if (DigestJob->Func != NULL) {
+    WaitForCpuJob (DigestJob);
+  }
+  DigestArg->Stream    = Stream;
+  DigestArg->Available = Available;
+  DigestJob->Func      = ContainerDigestJob;
+  DigestJob->Argument  = (UINT64)(UINTN)DigestArg;
+  StartCpuJob (GetCpuTask (), DigestJob);
+}
+
 /**
   Get Boot image from raw partition
 
@@ -108,6 +173,12 @@ GetBootImageFromRawPartition (
   UINT8                      SwPart;
   UINT64                     Address;
   CONTAINER_HDR             *ContainerHdr;
+  UINTN                      ChunkSize;
+  UINTN                      ReadSize;
+  UINTN                      Offset;
+  VOID                      *DigestStream;
+  CPU_JOB                    DigestJob;
+  CONTAINER_DIGEST_JOB_ARG   DigestArg;
 
   SwPart   = BootOption->Image[LoadedImage->LoadImageType].LbaImage.SwPart;
   LbaAddr  = BootOption->Image[LoadedImage->LoadImageType].LbaImage.LbaAddr;
@@ -214,16 +285,44 @@ GetBootImageFromRawPartition (
   FreePages (BlockData, EFI_SIZE_TO_PAGES (AlignedHeaderSize));
 
   //
-  // Read the rest of the IAS image into the buffer
+  // A container is hashed while it is read, so that RegisterContainer() and
+  // LoadComponent() only need to check the digests.
   //
-  Address =  LogicBlkDev.StartBlock + LbaAddr + AlignedHeaderBlkCnt;
+  DigestStream = NULL;
+  if (*((UINT32 *) Buffer) == CONTAINER_BOOT_SIGNATURE) {
+    if (EFI_ERROR (ContainerDigestStart (Buffer, (UINT32)ImageSize, &DigestStream))) {
+      DigestStream = NULL;
+    }
+  }
 
-  Status = MediaReadBlocks (
-             BootOption->HwPart,
-             Address,
-             (AlignedImageSize - AlignedHeaderSize),
-             (VOID *)((UINTN)Buffer + AlignedHeaderSize)
-             );
+  //
+  // Read the rest of the image into the buffer chunk by chunk
+  //
+  ChunkSize = MAX (IMAGE_READ_CHUNK_SIZE - (IMAGE_READ_CHUNK_SIZE % BlockSize), BlockSize);
+  ZeroMem (&DigestJob, sizeof (DigestJob));
+  for (Offset = AlignedHeaderSize; Offset < AlignedImageSize; Offset += ReadSize) {
+    ReadSize = MIN (ChunkSize, AlignedImageSize - Offset);
+    Status = MediaReadBlocks (
+               BootOption->HwPart,
+               Address + Offset / BlockSize,
+               ReadSize,
+               (VOID *)((UINTN)Buffer + Offset)
+               );
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    if (DigestStream != NULL) {
+      QueueContainerDigest (DigestStream, (UINT32)(Offset + ReadSize), &DigestJob, &DigestArg);
+    }
+  }
+
+  if (DigestStream != NULL) {
+    if (DigestJob.Func != NULL) {
+      WaitForCpuJob (&DigestJob);
+    }
+    ContainerDigestFinish (DigestStream, !EFI_ERROR (Status));
+  }
 
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_INFO, "Read rest of image error - %r\n", Status));
@@ -242,6 +341,79 @@ GetBootImageFromRawPartition (
   return EFI_SUCCESS;
 }
 
+/**
+  Read a boot image file into memory.
+
+  A container is read in chunks and hashed while the next chunk is read, the
+  same way as from a raw partition. Other images, and file systems that only
+  support reading a whole file, are read at once.
+
+  @param[in]  FileHandle      Handle of the opened image file.
+  @param[out] Image           Buffer to receive the image.
+  @param[in]  ImageSize       Size of the image file.
+
+  @retval  EFI_SUCCESS        The image was read successfully.
+  @retval  Others             The image was not read.
+**/
+STATIC
+EFI_STATUS
+ReadBootImageFile (
+  IN  EFI_HANDLE             FileHandle,
+  OUT UINT8                  *Image,
+  IN  UINTN                  ImageSize
+  )
+{
+  EFI_STATUS                 Status;
+  UINTN                      ReadSize;
+  UINTN                      Offset;
+  VOID                      *DigestStream;
+  CPU_JOB                    DigestJob;
+  CONTAINER_DIGEST_JOB_ARG   DigestArg;
+
+  ReadSize = MIN (IMAGE_READ_CHUNK_SIZE, ImageSize);
+  Status   = ReadFileChunk (FileHandle, Image, &ReadSize);
+  if (Status == EFI_UNSUPPORTED) {
+    return ReadFile (FileHandle, Image, &ImageSize);
+  }
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  DigestStream = NULL;
+  if ((ReadSize >= sizeof (UINT32)) && (*((UINT32 *) Image) == CONTAINER_BOOT_SIGNATURE) &&
+      (ImageSize <= MAX_UINT32)) {
+    if (EFI_ERROR (ContainerDigestStart (Image, (UINT32)ImageSize, &DigestStream))) {
+      DigestStream = NULL;
+    }
+  }
+
+  ZeroMem (&DigestJob, sizeof (DigestJob));
+  for (Offset = ReadSize; ; Offset += ReadSize) {
+    if (DigestStream != NULL) {
+      QueueContainerDigest (DigestStream, (UINT32)Offset, &DigestJob, &DigestArg);
+    }
+    if (Offset >= ImageSize) {
+      break;
+    }
+
+    ReadSize = MIN (IMAGE_READ_CHUNK_SIZE, ImageSize - Offset);
+    Status   = ReadFileChunk (FileHandle, Image + Offset, &ReadSize);
+    if (!EFI_ERROR (Status) && (ReadSize == 0)) {
+      Status = EFI_END_OF_FILE;
+    }
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+  }
+
+  if (DigestStream != NULL) {
+    WaitForCpuJob (&DigestJob);
+    ContainerDigestFinish (DigestStream, !EFI_ERROR (Status));
+  }
+
+  return Status;
+}
+
 /**
   Get Boot image from File System
 
@@ -336,7 +508,7 @@ GetBootImageFromFs (
     goto Done;
   }
 
-  Status = ReadFile (FileHandle, Image, &ImageSize);
+  Status = ReadBootImageFile (FileHandle, Image, ImageSize);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_INFO, "Read file '%a' failed, Status = %r\n", FileName, Status));
     if (Image != NULL) {
@@ -669,7 +841,12 @@ FreeImageData (
 
   if (ImageData->AllocType >= ImageAllocateTypeMax) {
     return;
-  } else if (ImageData->AllocType == ImageAllocateTypePool) {
+  }
+
+  // Digests calculated while the image was read must not outlive its memory
+  ContainerDigestDiscard (ImageData->Addr);
+
+  if (ImageData->AllocType == ImageAllocateTypePool) {
     FreePool (ImageData->Addr);
   } else if (ImageData->AllocType == ImageAllocateTypePage) {
     FreePages (ImageData->Addr, EFI_SIZE_TO_PAGES (ImageData->Size));
@@ -854,6 +1031,12 @@ LoadBootImages (
   }
   LoadedImagesInfo->Signature = LOADED_IMAGES_INFO_SIGNATURE;
 
+  //
+  // Digests left from an earlier boot attempt may describe memory that has
+  // been reused since, so only the images loaded below can use a digest.
+  //
+  ContainerDigestDiscard (NULL);
+
   for (Index = 0; Index < LoadImageTypeMax; Index++) {
     if ((Index == LoadImageTypePreOs) && ((BootFlags & BOOT_FLAGS_PREOS) == 0)) {
       continue;
@@ -1,6 +1,6 @@
 /** @file
 
-  Copyright (c) 2017 - 2020, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2017 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -166,6 +166,7 @@ PlatformReset (
   PLATFORM_SERVICE   *PlatformService;
 
   // Reset platform
+  CommitVariableBatch ();
   PlatformService = (PLATFORM_SERVICE *) GetServiceBySignature (PLATFORM_SERVICE_SIGNATURE);
   if ((PlatformService != NULL) && (PlatformService->ResetSystem != NULL)) {
     DEBUG ((DEBUG_INFO, "Reboot system\n"));
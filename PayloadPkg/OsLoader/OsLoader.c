@@ -1,6 +1,6 @@
 /** @file
 
-  Copyright (c) 2017 - 2023, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2017 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -330,7 +330,9 @@ ParseContainerImage (
   UINT64                      ComponentName;
   LOADER_COMPRESSED_HEADER   *LzHdr;
   IMAGE_DATA                  File[MAX_CONTAINER_SUB_IMAGE];
+  COMPONENT_LOAD_REQUEST      Request[MAX_CONTAINER_SUB_IMAGE];
   UINT8                       Index;
+  UINT8                       Count;
 
   ContainerHdr = (CONTAINER_HDR  *)LoadedImage->ImageData.Addr;
   if (ContainerHdr->Signature != CONTAINER_BOOT_SIGNATURE) {
@@ -373,12 +375,12 @@ ParseContainerImage (
       File[Index].AllocType = ImageAllocateTypePointer;
     } else {
       //
-      // Use Load to decompress to a new aligned page
+      // Load is deferred so that all components are decompressed to new
+      // aligned pages together, using the idle APs as well
       //
-      Status = LoadComponent (ContainerHdr->Signature, (UINT32) ComponentName, (VOID **)&File[Index].Addr, &File[Index].Size);
-      if (!EFI_ERROR (Status)) {
-        File[Index].AllocType = ImageAllocateTypePage;
-      }
+      Request[Index].ComponentName = (UINT32) ComponentName;
+      Request[Index].Buffer        = NULL;
+      Request[Index].Length        = 0;
     }
 
     // Save the name of the component
@@ -387,6 +389,30 @@ ParseContainerImage (
     Index++;
   } while ((Status == EFI_SUCCESS) && (Index < ARRAY_SIZE (File)));
 
+  if (((ContainerHdr->Flags & CONTAINER_HDR_FLAG_MONO_SIGNING) == 0) && (Index > 0)) {
+    LoadComponentList (ContainerHdr->Signature, Request, Index, LoadComponentCallback, GetCpuTask ());
+
+    // Keep the components up to the first one that failed to load
+    Count = Index;
+    for (Index = 0; Index < Count; Index++) {
+      if (EFI_ERROR (Request[Index].Status)) {
+        DEBUG ((DEBUG_INFO, "Load COMP:%4a %r\n", &File[Index].Name, Request[Index].Status));
+        break;
+      }
+      File[Index].Addr      = Request[Index].Buffer;
+      File[Index].Size      = Request[Index].Length;
+      File[Index].AllocType = ImageAllocateTypePage;
+    }
+    if (Index < Count) {
+      for (Count--; Count > Index; Count--) {
+        if (!EFI_ERROR (Request[Count].Status)) {
+          FreePages (Request[Count].Buffer, EFI_SIZE_TO_PAGES (Request[Count].Length));
+        }
+      }
+      Index++;
+    }
+  }
+
   Status = UnregisterContainer (ContainerHdr->Signature);
   DEBUG ((DEBUG_INFO, "Unregister done - %r!\n", Status));
 
@@ -457,6 +483,7 @@ SetupBootImage (
   LINUX_IMAGE               *LinuxImage;
   LOADED_PAYLOAD_INFO        PayloadInfo;
   UINT32                     Size;
+  UINT32                     BootFileBufLen;
   UINT16                     Machine;
 
   //
@@ -530,7 +557,12 @@ SetupBootImage (
   } else {
     DEBUG ((DEBUG_INFO, "Assume BzImage...\n"));
     LinuxImage = &LoadedImage->Image.Linux;
-    Status = LoadBzImage (LinuxImage->BootFile.Addr,
+    // A relocatable kernel may use the slack of the last page while it runs in place
+    BootFileBufLen = LinuxImage->BootFile.Size;
+    if (LinuxImage->BootFile.AllocType == ImageAllocateTypePage) {
+      BootFileBufLen = EFI_PAGES_TO_SIZE (EFI_SIZE_TO_PAGES (BootFileBufLen));
+    }
+    Status = LoadBzImage (LinuxImage->BootFile.Addr, BootFileBufLen,
                           LinuxImage->InitrdFile.Addr, LinuxImage->InitrdFile.Size,
                           LinuxImage->CmdFile.Addr,    LinuxImage->CmdFile.Size);
     if (!EFI_ERROR (Status)) {
@@ -681,6 +713,9 @@ BeforeOSJump (
     AddMeasurePoint (0x40F0);
   }
 
+  // Write the variable updates queued during boot before flash gets locked
+  CommitVariableBatch ();
+
   PlatformService = (PLATFORM_SERVICE *) GetServiceBySignature (PLATFORM_SERVICE_SIGNATURE);
   if ((PlatformService != NULL) && (PlatformService->NotifyPhase != NULL)) {
     PlatformService->NotifyPhase (ReadyToBoot);
@@ -809,6 +844,7 @@ StartBooting (
   }
 
   if (Status == EFI_DEVICE_ERROR) {
+    CommitVariableBatch ();
     CpuHalt ("Boot image returned");
   }
 
@@ -1412,9 +1448,14 @@ RunShell (
   IN  UINTN    Timeout
   )
 {
+  // Shell commands may reset the platform, commit queued variable updates first
+  CommitVariableBatch ();
+
   LocalConsoleInit (FALSE);
 
   Shell (Timeout);
+
+  BeginVariableBatch ();
 }
 
 /**
@@ -1445,6 +1486,12 @@ PayloadMain (
   DEBUG ((DEBUG_INFO, "\n\n====================Os Loader====================\n\n"));
   AddMeasurePoint (0x4010);
 
+  // The APs wait for tasks until ReadyToBoot, let decompression use them
+  SetDefaultCpuJobTask (GetCpuTask ());
+
+  // Coalesce the variable updates done by boot option handling into one commit
+  BeginVariableBatch ();
+
   //
   // Get Boot Image Info
   //
@@ -1521,5 +1568,6 @@ PayloadMain (
     }
   }
 
+  CommitVariableBatch ();
   CpuHalt (NULL);
 }
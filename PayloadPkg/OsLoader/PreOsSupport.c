@@ -1,6 +1,6 @@
 /** @file
 
-  Copyright (c) 2019 - 2021, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2019 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -117,6 +117,7 @@ StartPreOsBooting (
   //
   // Should not reach here
   //
+  CommitVariableBatch ();
   CpuHalt ("Failed to launch Pre-OS image!");
 
   return EFI_DEVICE_ERROR;
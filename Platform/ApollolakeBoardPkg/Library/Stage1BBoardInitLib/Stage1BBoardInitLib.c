@@ -1,6 +1,6 @@
 /** @file
 
-  Copyright (c) 2017 - 2018, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2017 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -1470,6 +1470,7 @@ ProcessMbpData (
         if (EFI_ERROR (Status)) {
           DEBUG ((DEBUG_INFO, "Append User CFG Data ... %r\n", Status));
         } else {
+          BuildConfigDataIndex ();
           if (FindConfigDataByTag(CDATA_CAPSULE_TAG) != NULL) {
             SetBootMode(BOOT_ON_FLASH_UPDATE);
           }
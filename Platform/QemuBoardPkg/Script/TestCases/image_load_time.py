@@ -0,0 +1,111 @@
+#!/usr/bin/env python
+## @ image_load_time.py
+#
+# Compare the time the OS loader spends on loading and verifying the boot
+# image on QEMU between two Slim Bootloader images
+#
+# Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+##
+
+import os
+import re
+import sys
+from   test_base import *
+
+# OS loader measure points, in the order they are taken
+MEASURE_POINTS = [
+                   (0x4070, 'load boot images'),
+                   (0x4080, 'verify boot image'),
+                 ]
+
+def get_check_lines ():
+    lines = [
+              "===== Intel Slim Bootloader STAGE1A =====",
+              "===== Intel Slim Bootloader STAGE1B =====",
+              "===== Intel Slim Bootloader STAGE2 ======",
+              "Jump to payload",
+              "Starting Kernel ...",
+              "Linux version",
+            ]
+    return lines
+
+def get_measure_time (output, measure_id):
+    # The second column of the OS loader performance data is the time spent
+    # since the measure point before.
+    for line in output:
+        match = re.search (r'^\s*%04X \|\s*\d+ ms \|\s*(\d+) ms \|' % measure_id, line)
+        if match:
+            return int(match.group(1))
+    return None
+
+def usage():
+    print("usage:\n  python %s bios_image_before bios_image_after os_image_dir\n" % sys.argv[0])
+    print("  bios_image_before :  QEMU Slim Bootloader firmware image to compare against.")
+    print("  bios_image_after  :  QEMU Slim Bootloader firmware image to measure.")
+    print("                       Both images can be generated through the normal Slim Bootloader build process.")
+    print("  os_image_dir      :  Directory containing bootable OS image.")
+    print("                       This image can be generated using GenContainer.py tool.")
+    print("")
+
+
+def main():
+    if sys.version_info.major < 3:
+        print ("This script needs Python3 !")
+        return -1
+
+    if len(sys.argv) != 4:
+        usage()
+        return -2
+
+    bios_imgs = [('before', sys.argv[1]), ('after', sys.argv[2])]
+    os_dir    = sys.argv[3]
+
+    print("Boot image load time test for Slim BootLoader")
+
+    # download and unzip OS image
+    tmp_dir = os.path.dirname(os_dir) + '/temp'
+    create_dirs ([tmp_dir, os_dir])
+    local_file = tmp_dir + '/QemuLinux.zip'
+    download_url (
+        'https://github.com/slimbootloader/slimbootloader/files/4463548/QemuLinux.zip',
+        local_file
+    )
+    unzip_file (local_file, os_dir)
+
+    # run QEMU boot with each image and collect the OS loader measure points
+    ret = 0
+    times = {}
+    for name, bios_img in bios_imgs:
+        output = []
+        lines = run_qemu(bios_img, os_dir, timeout = 10)
+        output.extend(lines)
+
+        # check test result
+        result = check_result (output, get_check_lines())
+        if result != 0:
+            ret = result
+            continue
+
+        times[name] = {}
+        for measure_id, desc in MEASURE_POINTS:
+            time = get_measure_time (output, measure_id)
+            if time is None:
+                print ("Measure point %04X (%s) not found !" % (measure_id, desc))
+                ret = -3
+                break
+            times[name][measure_id] = time
+
+    if ret == 0:
+        for measure_id, desc in MEASURE_POINTS:
+            print ('Time to %-18s: %4d ms before, %4d ms after, %4d ms saved' % (desc,
+                   times['before'][measure_id], times['after'][measure_id],
+                   times['before'][measure_id] - times['after'][measure_id]))
+
+    print ('\nBoot image load time test %s !\n' % ('PASSED' if ret == 0 else 'FAILED'))
+
+    return ret
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,99 @@
+#!/usr/bin/env python
+## @ serial_boot_time.py
+#
+# Compare the boot time of linux on QEMU with and without deferred serial
+# debug output
+#
+# Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+##
+
+import os
+import re
+import sys
+from   test_base import *
+
+def get_check_lines ():
+    lines = [
+              "===== Intel Slim Bootloader STAGE1A =====",
+              "===== Intel Slim Bootloader STAGE1B =====",
+              "===== Intel Slim Bootloader STAGE2 ======",
+              "Jump to payload",
+              "Starting Kernel ...",
+              "Linux version",
+            ]
+    return lines
+
+def get_boot_time (output):
+    # The last measure point of the OS loader performance data is taken
+    # right before handing off to the kernel, and its time counts from reset.
+    # It includes the time spent on draining the deferred serial output.
+    time = 0
+    for line in output:
+        match = re.search (r'^\s*[0-9A-F]{4} \|\s*(\d+) ms \|', line)
+        if match:
+            time = max(time, int(match.group(1)))
+    return time
+
+def usage():
+    print("usage:\n  python %s bios_image bios_image_deferred os_image_dir\n" % sys.argv[0])
+    print("  bios_image          :  QEMU Slim Bootloader firmware image.")
+    print("                         This image can be generated through the normal Slim Bootloader build process.")
+    print("  bios_image_deferred :  QEMU Slim Bootloader firmware image with deferred serial output.")
+    print("                         This image can be generated with ENABLE_DEFERRED_SERIAL_OUTPUT set in BoardConfig.py.")
+    print("  os_image_dir        :  Directory containing bootable OS image.")
+    print("                         This image can be generated using GenContainer.py tool.")
+    print("")
+
+
+def main():
+    if sys.version_info.major < 3:
+        print ("This script needs Python3 !")
+        return -1
+
+    if len(sys.argv) != 4:
+        usage()
+        return -2
+
+    bios_imgs = [('direct', sys.argv[1]), ('deferred', sys.argv[2])]
+    os_dir    = sys.argv[3]
+
+    print("Serial output boot time test for Slim BootLoader")
+
+    # download and unzip OS image
+    tmp_dir = os.path.dirname(os_dir) + '/temp'
+    create_dirs ([tmp_dir, os_dir])
+    local_file = tmp_dir + '/QemuLinux.zip'
+    download_url (
+        'https://github.com/slimbootloader/slimbootloader/files/4463548/QemuLinux.zip',
+        local_file
+    )
+    unzip_file (local_file, os_dir)
+
+    # run QEMU boot with each image and compare the time to kernel handoff
+    ret = 0
+    boot_time = {}
+    for name, bios_img in bios_imgs:
+        output = []
+        lines = run_qemu(bios_img, os_dir, timeout = 10)
+        output.extend(lines)
+
+        # check test result
+        result = check_result (output, get_check_lines())
+        if result != 0:
+            ret = result
+            continue
+        boot_time[name] = get_boot_time (output)
+
+    if ret == 0:
+        for name, bios_img in bios_imgs:
+            print ('Boot time with %-8s serial output: %d ms' % (name, boot_time[name]))
+        print ('Boot time saved: %d ms' % (boot_time['direct'] - boot_time['deferred']))
+
+    print ('\nSerial boot time test %s !\n' % ('PASSED' if ret == 0 else 'FAILED'))
+
+    return ret
+
+if __name__ == '__main__':
+    sys.exit(main())
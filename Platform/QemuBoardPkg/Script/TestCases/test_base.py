@@ -3,7 +3,7 @@
 #
 # Provide common functions for test script
 #
-# Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+# Copyright (c) 2020 - 2026, Intel Corporation. All rights reserved.<BR>
 # SPDX-License-Identifier: BSD-2-Clause-Patent
 #
 
@@ -47,17 +47,30 @@ def create_dirs (dirs):
             os.mkdir (dir_name)
 
 
-def run_qemu (bios_img, fwu_path, fwu_mode=False, boot_order='', timeout=0):
+def run_qemu (bios_img, fwu_path, fwu_mode=False, boot_order='', timeout=0, usb=False, uas=False, nvme=False):
     if os.name == 'nt':
         path = r"C:\Program Files\qemu\qemu-system-x86_64"
     else:
         path = r"qemu-system-x86_64"
+    if uas:
+        # attach the drive as a USB attached SCSI device behind a XHCI controller at 00:04.0
+        # where the board looks for it
+        drive_dev = ["-device", "qemu-xhci,id=xhci,addr=0x4", "-device", "usb-uas,bus=xhci.0,id=uas",
+                     "-device", "scsi-hd,bus=uas.0,scsi-id=0,lun=0,drive=mydrive"]
+    elif usb:
+        # attach the drive as a USB mass storage device behind a XHCI controller at 00:04.0
+        drive_dev = ["-device", "qemu-xhci,id=xhci,addr=0x4", "-device", "usb-storage,bus=xhci.0,drive=mydrive"]
+    elif nvme:
+        # attach the drive as a NVMe namespace at 00:03.0 where the board looks for it
+        drive_dev = ["-device", "nvme,serial=SBL0001,addr=0x3,drive=mydrive"]
+    else:
+        drive_dev = ["-device", "ide-hd,drive=mydrive"]
     cmd_list = [
         path, "-nographic",  "-machine", "q35,accel=tcg",
         "-cpu", "max", "-serial", "mon:stdio",
         "-m", "256M", "-drive",
-        "id=mydrive,if=none,format=raw,file=fat:rw:%s" % fwu_path, "-device",
-        "ide-hd,drive=mydrive", "-boot", "order=d%s" % ('an' if fwu_mode else boot_order),
+        "id=mydrive,if=none,format=raw,file=fat:rw:%s" % fwu_path] + drive_dev + [
+        "-boot", "order=d%s" % ('an' if fwu_mode else boot_order),
         "-no-reboot", "-drive", "file=%s,if=pflash,format=raw" % bios_img
     ]
 
@@ -0,0 +1,110 @@
+#!/usr/bin/env python
+## @ usb_boot.py
+#
+# Test boot linux from USB mass storage (BOT and UAS) on QEMU and check the
+# read throughput
+#
+# Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+##
+
+import os
+import re
+import sys
+from   test_base import *
+
+# Lowest acceptable USB read throughput in KB/s under QEMU TCG emulation
+MIN_READ_KBPS = 2048
+
+def get_check_lines (uas):
+    lines = [
+              "===== Intel Slim Bootloader STAGE1A =====",
+              "===== Intel Slim Bootloader STAGE1B =====",
+              "===== Intel Slim Bootloader STAGE2 ======",
+              "Jump to payload",
+              "Getting boot image from USB",
+            ]
+    if uas:
+        # make sure the device did not fall back to BOT
+        lines.append ("USB mass storage uses UAS")
+    lines.extend ([
+              "Load file container.bin",
+              "Starting Kernel ...",
+              "Linux version",
+            ])
+    return lines
+
+def get_read_throughput (output):
+    # Use the size of the loaded container and the time spent in loading
+    # boot images from the OS loader performance data
+    size = 0
+    time = 0
+    for line in output:
+        match = re.search (r'Load file container\.bin \[size (\d+) bytes\]', line)
+        if match:
+            size = int(match.group(1))
+        match = re.search (r'^\s*4070 \|\s*\d+ ms \|\s*(\d+) ms \|', line)
+        if match:
+            time = int(match.group(1))
+    if size == 0:
+        return 0
+    return size * 1000 // 1024 // max(time, 1)
+
+def usage():
+    print("usage:\n  python %s bios_image os_image_dir\n" % sys.argv[0])
+    print("  bios_image  :  QEMU Slim Bootloader firmware image.")
+    print("                 This image can be generated through the normal Slim Bootloader build process.")
+    print("  os_image_dir:  Directory containing bootable OS image.")
+    print("                 This image can be generated using GenContainer.py tool.")
+    print("")
+
+
+def main():
+    if sys.version_info.major < 3:
+        print ("This script needs Python3 !")
+        return -1
+
+    if len(sys.argv) != 3:
+        usage()
+        return -2
+
+    bios_img = sys.argv[1]
+    os_dir   = sys.argv[2]
+
+    print("USB boot test for Slim BootLoader")
+
+    # download and unzip OS image
+    tmp_dir = os.path.dirname(os_dir) + '/temp'
+    create_dirs ([tmp_dir, os_dir])
+    local_file = tmp_dir + '/QemuLinux.zip'
+    download_url (
+        'https://github.com/slimbootloader/slimbootloader/files/4463548/QemuLinux.zip',
+        local_file
+    )
+    unzip_file (local_file, os_dir)
+
+    # run QEMU boot from usb-storage (BOT) and usb-uas (UAS) with timeout
+    ret = 0
+    for name, uas in [('BOT', False), ('UAS', True)]:
+        output = []
+        lines = run_qemu(bios_img, os_dir, timeout = 20, usb = True, uas = uas)
+        output.extend(lines)
+
+        # check test result
+        result = check_result (output, get_check_lines(uas))
+        if result == 0:
+            kbps = get_read_throughput (output)
+            print ('USB %s read throughput: %d KB/s' % (name, kbps))
+            if kbps < MIN_READ_KBPS:
+                print ('USB %s read throughput is below %d KB/s !' % (name, MIN_READ_KBPS))
+                result = -1
+        if result != 0:
+            ret = result
+
+    print ('\nUSB Boot test %s !\n' % ('PASSED' if ret == 0 else 'FAILED'))
+
+    return ret
+
+if __name__ == '__main__':
+    sys.exit(main())
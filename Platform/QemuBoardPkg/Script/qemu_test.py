@@ -3,7 +3,7 @@
 #
 # QEMU test script
 #
-# Copyright (c) 2020 - 2021, Intel Corporation. All rights reserved.<BR>
+# Copyright (c) 2020 - 2026, Intel Corporation. All rights reserved.<BR>
 # SPDX-License-Identifier: BSD-2-Clause-Patent
 #
 ##
@@ -37,6 +37,8 @@ def main():
     test_cases = [
       ('firmware_update.py',  [tst_img, fwu_dir]),
       ('linux_boot.py'     ,  [tst_img, img_dir]),
+      ('usb_boot.py'       ,  [tst_img, img_dir]),
+      ('nvme_boot.py'      ,  [tst_img, img_dir]),
       ('uefi_upld_boot.py' ,  [tst_img, tmp_dir]),
       ('cfgdata_update.py' ,  [tst_img, tmp_dir]),
     ]
@@ -1,6 +1,6 @@
 /** @file
 
-  Copyright (c) 2017 - 2019, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2017 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -9,6 +9,7 @@
 #include <Library/BaseLib.h>
 #include <Library/IoLib.h>
 #include <Library/PlatformHookLib.h>
+#include <Library/SerialPortLib.h>
 
 //---------------------------------------------
 // UART Register Offsets
@@ -279,3 +280,33 @@ SerialPortPoll (
   return FALSE;
 }
 
+/**
+  Retrieve the status of the control bits on a serial device.
+
+  Only EFI_SERIAL_INPUT_BUFFER_EMPTY and EFI_SERIAL_OUTPUT_BUFFER_EMPTY are
+  reported.
+
+  @param Control                A pointer to return the current control signals from the serial device.
+
+  @retval RETURN_SUCCESS        The control bits were read from the serial device.
+
+**/
+RETURN_STATUS
+EFIAPI
+SerialPortGetControl (
+  OUT UINT32 *Control
+  )
+{
+  UINT8  Lsr;
+
+  Lsr      = SerialPortReadRegister (LSR_OFFSET);
+  *Control = 0;
+  if ((Lsr & LSR_RXDA) == 0) {
+    *Control |= EFI_SERIAL_INPUT_BUFFER_EMPTY;
+  }
+  if ((Lsr & LSR_TXRDY) != 0) {
+    *Control |= EFI_SERIAL_OUTPUT_BUFFER_EMPTY;
+  }
+
+  return RETURN_SUCCESS;
+}